@@ -0,0 +1,679 @@
+/**
+ * @file calibration.hpp
+ * @author Leo (zhsleo@outlook.com)
+ *
+ * @brief Post-training calibration of float models to int8 qnn models
+ * @version 1.0.0
+ * @date 2026-10-18
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstdint>
+#include <fstream>
+#include <functional>
+#include <limits>
+#include <nlohmann/json.hpp>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace qnn::calib {
+
+using json = nlohmann::json;
+
+/**
+ * @brief How an activation scale is chosen from the observed values
+ */
+enum class Method {
+  kMinMax,     /**< Largest absolute value */
+  kPercentile, /**< Percentile of absolute values, clipping outliers */
+  kKL          /**< Threshold minimizing KL divergence to the int8 histogram */
+};
+
+/**
+ * @brief Histogram of absolute values over [0, range]
+ */
+struct Histogram {
+  static constexpr size_t kBins = 2048;
+
+  float range = 0.0f;
+  std::vector<uint64_t> bins = std::vector<uint64_t>(kBins, 0);
+
+  /** @brief Add values; those beyond range go to the last bin */
+  void Add(const std::vector<float>& values) {
+    if (range <= 0.0f) {
+      return;
+    }
+    const float scale = kBins / range;
+    for (float v : values) {
+      size_t bin = static_cast<size_t>(std::fabs(v) * scale);
+      bins[std::min(bin, kBins - 1)]++;
+    }
+  }
+
+  /** @brief Add the counts of a histogram over the same range */
+  void Merge(const Histogram& other) {
+    for (size_t i = 0; i < kBins; ++i) {
+      bins[i] += other.bins[i];
+    }
+  }
+
+  /** @return Width of one bin */
+  float bin_width() const { return range / kBins; }
+};
+
+/**
+ * @brief Statistics of one observed tensor
+ */
+struct TensorStats {
+  bool observed = false;
+  float max_abs = 0.0f;
+  Histogram histogram;
+};
+
+/**
+ * @brief Calibration settings
+ */
+struct Options {
+  Method method = Method::kMinMax;
+
+  /** @brief Percentile of absolute values kept by Method::kPercentile */
+  double percentile = 99.99;
+
+  /** @brief Worker threads, 0 for one per core */
+  size_t threads = 0;
+};
+
+/**
+ * @brief Scales chosen by calibration
+ */
+struct Result {
+  /** @brief Scale of the model input (QuantStub) */
+  float input_scale = 0.0f;
+
+  /** @brief Output scale of each layer, 0 for layers without one */
+  std::vector<float> output_scales;
+
+  /** @brief Samples run */
+  size_t samples = 0;
+};
+
+/**
+ * @brief One layer of a float model
+ */
+struct FloatLayer {
+  json attributes; /**< Layer JSON without weight and bias */
+  std::string name;
+  std::string type;
+  std::vector<size_t> weight_shape;
+  std::vector<float> weight;
+  std::vector<float> bias;
+};
+
+/**
+ * @brief Reference float executor for models exported before quantization
+ *
+ * Reads the exporter's JSON with float32 weights and runs it with plain float
+ * kernels, reporting every layer output to an observer.
+ */
+class FloatModel {
+ public:
+  /**
+   * @brief Load a float model
+   *
+   * @param filename Path to the model JSON
+   * @return Float model
+   * @throws std::runtime_error If the file cannot be opened or a layer is
+   * unsupported
+   */
+  static FloatModel Load(const std::string& filename) {
+    std::ifstream file(filename);
+    if (!file.is_open()) {
+      throw std::runtime_error("Failed to open model file: " + filename);
+    }
+    json j;
+    file >> j;
+
+    FloatModel model;
+    for (const auto& layer_json : j["layers"]) {
+      FloatLayer layer;
+      layer.name = layer_json["name"].get<std::string>();
+      layer.type = layer_json["type"].get<std::string>();
+      layer.attributes = layer_json;
+      layer.attributes.erase("weight");
+      layer.attributes.erase("bias");
+      layer.attributes.erase("scale");
+
+      if (layer.type == "Conv2d" || layer.type == "Linear") {
+        if (!layer_json.contains("weight")) {
+          throw std::runtime_error("Missing weight in layer " + layer.name);
+        }
+        const auto& weight = layer_json["weight"];
+        if (weight.value("dtype", "torch.float32") != "torch.float32") {
+          throw std::runtime_error("Layer " + layer.name +
+                                   " is already quantized");
+        }
+        layer.weight_shape = weight["shape"].get<std::vector<size_t>>();
+        Flatten(weight["values"], layer.weight);
+        if (layer_json.contains("bias")) {
+          Flatten(layer_json["bias"]["values"], layer.bias);
+        }
+      } else if (layer.type != "QuantStub" && layer.type != "DeQuantStub" &&
+                 layer.type != "ReLU" && layer.type != "MaxPool2d") {
+        throw std::runtime_error("Unknown operator type: " + layer.type);
+      }
+      model.layers_.push_back(std::move(layer));
+    }
+    return model;
+  }
+
+  /** @return Layers in execution order */
+  const std::vector<FloatLayer>& layers() const { return layers_; }
+
+  /**
+   * @brief Run one sample
+   *
+   * @param input Input values in NCHW order
+   * @param shape Input shape [N, C, H, W]
+   * @param observe Called with (layer index, output) after every layer
+   * @return Model output
+   * @throws std::runtime_error If shapes do not match the layers
+   */
+  std::vector<float> Forward(
+      std::vector<float> input, std::vector<size_t> shape,
+      const std::function<void(size_t, const std::vector<float>&)>& observe)
+      const {
+    std::vector<float> output;
+    for (size_t i = 0; i < layers_.size(); ++i) {
+      const FloatLayer& layer = layers_[i];
+      if (layer.type == "Conv2d") {
+        Conv2d(layer, input, shape, output);
+      } else if (layer.type == "Linear") {
+        Linear(layer, input, shape, output);
+      } else if (layer.type == "MaxPool2d") {
+        MaxPool2d(layer, input, shape, output);
+      } else if (layer.type == "ReLU") {
+        output.resize(input.size());
+        std::transform(input.begin(), input.end(), output.begin(),
+                       [](float x) { return std::max(x, 0.0f); });
+      } else {
+        output = input;
+      }
+      if (observe) {
+        observe(i, output);
+      }
+      input.swap(output);
+    }
+    return input;
+  }
+
+ private:
+  static void Flatten(const json& values, std::vector<float>& out) {
+    if (values.is_array()) {
+      for (const auto& v : values) {
+        Flatten(v, out);
+      }
+    } else {
+      out.push_back(values.get<float>());
+    }
+  }
+
+  static void Conv2d(const FloatLayer& layer, const std::vector<float>& input,
+                     std::vector<size_t>& shape, std::vector<float>& output) {
+    const size_t in_c = layer.attributes["in_channels"].get<size_t>();
+    const size_t out_c = layer.attributes["out_channels"].get<size_t>();
+    const size_t kernel = layer.attributes["kernel_size"].get<size_t>();
+    const size_t stride = layer.attributes["stride"].get<size_t>();
+    const size_t pad = layer.attributes["padding"].get<size_t>();
+    if (shape.size() != 4 || shape[1] != in_c ||
+        layer.weight.size() != out_c * in_c * kernel * kernel) {
+      throw std::runtime_error("Shape mismatch at layer " + layer.name);
+    }
+
+    const size_t batch = shape[0], in_h = shape[2], in_w = shape[3];
+    const size_t out_h = (in_h + 2 * pad - kernel) / stride + 1;
+    const size_t out_w = (in_w + 2 * pad - kernel) / stride + 1;
+    output.assign(batch * out_c * out_h * out_w, 0.0f);
+
+    for (size_t n = 0; n < batch; ++n) {
+      for (size_t oc = 0; oc < out_c; ++oc) {
+        for (size_t oh = 0; oh < out_h; ++oh) {
+          for (size_t ow = 0; ow < out_w; ++ow) {
+            float acc = layer.bias.empty() ? 0.0f : layer.bias[oc];
+            for (size_t ic = 0; ic < in_c; ++ic) {
+              for (size_t kh = 0; kh < kernel; ++kh) {
+                const size_t ih = oh * stride + kh;
+                if (ih < pad || ih - pad >= in_h) {
+                  continue;
+                }
+                for (size_t kw = 0; kw < kernel; ++kw) {
+                  const size_t iw = ow * stride + kw;
+                  if (iw < pad || iw - pad >= in_w) {
+                    continue;
+                  }
+                  acc += input[((n * in_c + ic) * in_h + ih - pad) * in_w +
+                               iw - pad] *
+                         layer.weight[((oc * in_c + ic) * kernel + kh) *
+                                          kernel +
+                                      kw];
+                }
+              }
+            }
+            output[((n * out_c + oc) * out_h + oh) * out_w + ow] = acc;
+          }
+        }
+      }
+    }
+    shape = {batch, out_c, out_h, out_w};
+  }
+
+  static void Linear(const FloatLayer& layer, const std::vector<float>& input,
+                     std::vector<size_t>& shape, std::vector<float>& output) {
+    const size_t in_f = layer.attributes["in_features"].get<size_t>();
+    const size_t out_f = layer.attributes["out_features"].get<size_t>();
+    const size_t batch = shape[0];
+    if (input.size() != batch * in_f || layer.weight.size() != out_f * in_f) {
+      throw std::runtime_error("Shape mismatch at layer " + layer.name);
+    }
+
+    output.assign(batch * out_f, 0.0f);
+    for (size_t b = 0; b < batch; ++b) {
+      for (size_t o = 0; o < out_f; ++o) {
+        float acc = layer.bias.empty() ? 0.0f : layer.bias[o];
+        for (size_t i = 0; i < in_f; ++i) {
+          acc += input[b * in_f + i] * layer.weight[o * in_f + i];
+        }
+        output[b * out_f + o] = acc;
+      }
+    }
+    shape = {batch, out_f};
+  }
+
+  static void MaxPool2d(const FloatLayer& layer,
+                        const std::vector<float>& input,
+                        std::vector<size_t>& shape,
+                        std::vector<float>& output) {
+    const size_t kernel = layer.attributes["kernel_size"].get<size_t>();
+    const size_t stride = layer.attributes["stride"].get<size_t>();
+    const size_t pad = layer.attributes.value("padding", size_t{0});
+    if (shape.size() != 4) {
+      throw std::runtime_error("Shape mismatch at layer " + layer.name);
+    }
+    // As the int8 operator, which never pools a window of padding only
+    if (2 * pad > kernel) {
+      throw std::runtime_error("Pool padding must be at most half the kernel");
+    }
+
+    const size_t batch = shape[0], c = shape[1], in_h = shape[2],
+                 in_w = shape[3];
+    const size_t out_h =
+        in_h + 2 * pad < kernel ? 0 : (in_h + 2 * pad - kernel) / stride + 1;
+    const size_t out_w =
+        in_w + 2 * pad < kernel ? 0 : (in_w + 2 * pad - kernel) / stride + 1;
+    output.assign(batch * c * out_h * out_w, 0.0f);
+
+    for (size_t nc = 0; nc < batch * c; ++nc) {
+      for (size_t oh = 0; oh < out_h; ++oh) {
+        for (size_t ow = 0; ow < out_w; ++ow) {
+          float best = -std::numeric_limits<float>::infinity();
+          for (size_t kh = 0; kh < kernel; ++kh) {
+            const size_t ih = oh * stride + kh;
+            for (size_t kw = 0; kw < kernel; ++kw) {
+              const size_t iw = ow * stride + kw;
+              if (ih >= pad && ih - pad < in_h && iw >= pad &&
+                  iw - pad < in_w) {
+                best = std::max(
+                    best, input[(nc * in_h + ih - pad) * in_w + iw - pad]);
+              }
+            }
+          }
+          output[(nc * out_h + oh) * out_w + ow] = best;
+        }
+      }
+    }
+    shape = {batch, c, out_h, out_w};
+  }
+
+  std::vector<FloatLayer> layers_;
+};
+
+/**
+ * @brief Scale from the largest absolute value
+ */
+inline float MinMaxScale(const TensorStats& stats) {
+  return stats.max_abs / 127.0f;
+}
+
+/**
+ * @brief Scale keeping a percentile of the absolute values in range
+ */
+inline float PercentileScale(const TensorStats& stats, double percentile) {
+  const Histogram& h = stats.histogram;
+  uint64_t total = 0;
+  for (uint64_t count : h.bins) {
+    total += count;
+  }
+  const double target = total * percentile / 100.0;
+  uint64_t seen = 0;
+  for (size_t i = 0; i < Histogram::kBins; ++i) {
+    seen += h.bins[i];
+    if (seen >= target) {
+      return (i + 1) * h.bin_width() / 127.0f;
+    }
+  }
+  return MinMaxScale(stats);
+}
+
+/**
+ * @brief Scale whose clipping threshold minimizes the KL divergence between
+ * the observed distribution and its 128-level quantized version
+ *
+ * Each candidate threshold folds the clipped tail into its last bin, merges
+ * the kept bins into 128 levels and spreads every level back over its
+ * non-empty bins before comparing.
+ */
+inline float KLScale(const TensorStats& stats) {
+  constexpr size_t kLevels = 128;
+  const Histogram& h = stats.histogram;
+  std::vector<double> tail(Histogram::kBins + 1, 0.0);
+  for (size_t i = Histogram::kBins; i-- > 0;) {
+    tail[i] = tail[i + 1] + h.bins[i];
+  }
+  if (tail[0] == 0) {
+    return MinMaxScale(stats);
+  }
+
+  double best_kl = std::numeric_limits<double>::infinity();
+  size_t best_bins = Histogram::kBins;
+  std::vector<double> p, q;
+  for (size_t bins = kLevels; bins <= Histogram::kBins; ++bins) {
+    p.assign(h.bins.begin(), h.bins.begin() + bins);
+    p[bins - 1] += tail[bins];
+
+    q.assign(bins, 0.0);
+    for (size_t level = 0; level < kLevels; ++level) {
+      const size_t start = level * bins / kLevels;
+      const size_t stop = (level + 1) * bins / kLevels;
+      double sum = 0.0;
+      size_t nonzero = 0;
+      for (size_t i = start; i < stop; ++i) {
+        sum += h.bins[i];
+        nonzero += h.bins[i] != 0;
+      }
+      for (size_t i = start; i < stop && nonzero; ++i) {
+        q[i] = h.bins[i] ? sum / nonzero : 0.0;
+      }
+    }
+
+    double p_sum = 0.0, q_sum = 0.0;
+    for (size_t i = 0; i < bins; ++i) {
+      p_sum += p[i];
+      q_sum += q[i];
+    }
+    if (q_sum == 0.0) {
+      continue;
+    }
+    double kl = 0.0;
+    for (size_t i = 0; i < bins; ++i) {
+      if (p[i] == 0.0) {
+        continue;
+      }
+      const double pi = p[i] / p_sum;
+      // Smooth empty quantized bins, as the tail bin may be empty in q
+      const double qi = std::max(q[i] / q_sum, 1e-10);
+      kl += pi * std::log(pi / qi);
+    }
+    if (kl < best_kl) {
+      best_kl = kl;
+      best_bins = bins;
+    }
+  }
+  return (best_bins + 0.5f) * h.bin_width() / 127.0f;
+}
+
+/**
+ * @brief Index of the tensor whose range sets each layer's output scale
+ *
+ * Conv2d and Linear outputs followed by ReLU are observed after the ReLU, as
+ * the int8 kernels clamp before the activation and negative values are
+ * discarded anyway.
+ *
+ * @return Per layer, the layer whose output to observe, or SIZE_MAX
+ */
+inline std::vector<size_t> ObservationPoints(const FloatModel& model) {
+  const auto& layers = model.layers();
+  std::vector<size_t> points(layers.size(), SIZE_MAX);
+  for (size_t i = 0; i < layers.size(); ++i) {
+    if (layers[i].type == "Conv2d" || layers[i].type == "Linear") {
+      const bool relu = i + 1 < layers.size() && layers[i + 1].type == "ReLU";
+      points[i] = relu ? i + 1 : i;
+    }
+  }
+  return points;
+}
+
+/**
+ * @brief Run a calibration set through the float model on several threads
+ *
+ * Min-max needs one pass; the histogram methods take a second pass once the
+ * range of every tensor is known.
+ *
+ * @param model Float model
+ * @param samples Number of samples
+ * @param load Loads sample i as NCHW float values of input_shape
+ * @param input_shape Input shape [N, C, H, W]
+ * @param options Method and threading
+ * @return Input and per-layer output scales
+ * @throws std::runtime_error If there are no samples or a sample fails
+ */
+inline Result Calibrate(const FloatModel& model, size_t samples,
+                        const std::function<std::vector<float>(size_t)>& load,
+                        const std::vector<size_t>& input_shape,
+                        const Options& options) {
+  if (samples == 0) {
+    throw std::runtime_error("Calibration set is empty");
+  }
+  const size_t num_layers = model.layers().size();
+  const std::vector<size_t> points = ObservationPoints(model);
+  std::vector<bool> observed(num_layers, false);
+  for (size_t p : points) {
+    if (p != SIZE_MAX) {
+      observed[p] = true;
+    }
+  }
+
+  size_t threads = options.threads;
+  if (threads == 0) {
+    threads = std::max(1u, std::thread::hardware_concurrency());
+  }
+  threads = std::min(threads, samples);
+
+  // Tensor 0 is the model input, tensor i + 1 the output of layer i
+  std::vector<TensorStats> stats(num_layers + 1);
+  auto run_pass = [&](bool histogram) {
+    std::vector<std::vector<TensorStats>> local(threads, stats);
+    std::atomic<size_t> next{0};
+    std::vector<std::string> errors(threads);
+
+    auto worker = [&](size_t t) {
+      std::vector<TensorStats>& mine = local[t];
+      auto record = [&](size_t tensor, const std::vector<float>& values) {
+        TensorStats& s = mine[tensor];
+        s.observed = true;
+        if (histogram) {
+          s.histogram.Add(values);
+        } else {
+          for (float v : values) {
+            s.max_abs = std::max(s.max_abs, std::fabs(v));
+          }
+        }
+      };
+      try {
+        for (size_t i = next++; i < samples; i = next++) {
+          std::vector<float> input = load(i);
+          record(0, input);
+          model.Forward(std::move(input), input_shape,
+                        [&](size_t layer, const std::vector<float>& out) {
+                          if (observed[layer]) {
+                            record(layer + 1, out);
+                          }
+                        });
+        }
+      } catch (const std::exception& e) {
+        errors[t] = e.what();
+        next = samples;
+      }
+    };
+
+    std::vector<std::thread> pool;
+    for (size_t t = 1; t < threads; ++t) {
+      pool.emplace_back(worker, t);
+    }
+    worker(0);
+    for (auto& t : pool) {
+      t.join();
+    }
+    for (const auto& error : errors) {
+      if (!error.empty()) {
+        throw std::runtime_error("Calibration failed: " + error);
+      }
+    }
+
+    for (const auto& mine : local) {
+      for (size_t i = 0; i < stats.size(); ++i) {
+        stats[i].observed = stats[i].observed || mine[i].observed;
+        if (histogram) {
+          stats[i].histogram.Merge(mine[i].histogram);
+        } else {
+          stats[i].max_abs = std::max(stats[i].max_abs, mine[i].max_abs);
+        }
+      }
+    }
+  };
+
+  run_pass(false);
+  if (options.method != Method::kMinMax) {
+    for (auto& s : stats) {
+      s.histogram.range = s.max_abs;
+    }
+    run_pass(true);
+  }
+
+  auto scale_of = [&](const TensorStats& s) {
+    float scale = 0.0f;
+    switch (options.method) {
+      case Method::kMinMax:
+        scale = MinMaxScale(s);
+        break;
+      case Method::kPercentile:
+        scale = PercentileScale(s, options.percentile);
+        break;
+      case Method::kKL:
+        scale = KLScale(s);
+        break;
+    }
+    // An all-zero tensor still needs a usable scale
+    return scale > 0.0f ? scale : 1.0f / 127.0f;
+  };
+
+  Result result;
+  result.samples = samples;
+  result.input_scale = scale_of(stats[0]);
+  result.output_scales.assign(num_layers, 0.0f);
+  for (size_t i = 0; i < num_layers; ++i) {
+    if (points[i] != SIZE_MAX) {
+      result.output_scales[i] = scale_of(stats[points[i] + 1]);
+    }
+  }
+  return result;
+}
+
+/**
+ * @brief Quantize weights per output channel (symmetric, axis 0)
+ *
+ * @param layer Conv2d or Linear layer
+ * @return Weight JSON in the exporter's qint8 format
+ */
+inline json QuantizeWeight(const FloatLayer& layer) {
+  const size_t channels = layer.weight_shape.at(0);
+  const size_t per_channel = layer.weight.size() / channels;
+  std::vector<float> scales(channels);
+  std::vector<int8_t> values(layer.weight.size());
+
+  for (size_t c = 0; c < channels; ++c) {
+    const float* w = layer.weight.data() + c * per_channel;
+    float max_abs = 0.0f;
+    for (size_t i = 0; i < per_channel; ++i) {
+      max_abs = std::max(max_abs, std::fabs(w[i]));
+    }
+    scales[c] = max_abs > 0.0f ? max_abs / 127.0f : 1.0f;
+    for (size_t i = 0; i < per_channel; ++i) {
+      float q = std::round(w[i] / scales[c]);
+      values[c * per_channel + i] =
+          static_cast<int8_t>(std::clamp(q, -127.0f, 127.0f));
+    }
+  }
+
+  json weight;
+  weight["shape"] = layer.weight_shape;
+  weight["dtype"] = "torch.qint8";
+  weight["quantization"] = "per_channel";
+  weight["scales"] = scales;
+  weight["axis"] = 0;
+  weight["values"] = values;
+  return weight;
+}
+
+/**
+ * @brief Build a quantized qnn model from a float model and its scales
+ *
+ * QuantStub and DeQuantStub are added when the float model has none.
+ *
+ * @param model Float model
+ * @param result Calibrated scales
+ * @return Model JSON loadable by Model::loadModel
+ */
+inline json QuantizeModel(const FloatModel& model, const Result& result) {
+  const auto& layers = model.layers();
+  json out_layers = json::array();
+
+  if (layers.empty() || layers.front().type != "QuantStub") {
+    out_layers.push_back(
+        {{"name", "quant"}, {"type", "QuantStub"}, {"scale", 0.0f}});
+  }
+
+  float last_scale = result.input_scale;
+  for (size_t i = 0; i < layers.size(); ++i) {
+    const FloatLayer& layer = layers[i];
+    json j = layer.attributes;
+    if (layer.type == "Conv2d" || layer.type == "Linear") {
+      j["weight"] = QuantizeWeight(layer);
+      if (!layer.bias.empty()) {
+        j["bias"] = {{"shape", {layer.bias.size()}},
+                     {"dtype", "torch.float32"},
+                     {"quantization", "none"},
+                     {"values", layer.bias}};
+      }
+      j["scale"] = result.output_scales[i];
+      last_scale = result.output_scales[i];
+    } else if (layer.type == "DeQuantStub") {
+      j["scale"] = last_scale;
+    }
+    out_layers.push_back(std::move(j));
+  }
+
+  if (layers.empty() || layers.back().type != "DeQuantStub") {
+    out_layers.push_back(
+        {{"name", "dequant"}, {"type", "DeQuantStub"}, {"scale", last_scale}});
+  }
+  out_layers.front()["scale"] = result.input_scale;
+
+  return {{"layers", out_layers}};
+}
+
+}  // namespace qnn::calib
@@ -0,0 +1,265 @@
+/**
+ * @file cascade.hpp
+ * @author Leo (zhsleo@outlook.com)
+ *
+ * @brief Cascade of models escalating uncertain inputs to larger ones
+ * @version 1.0.0
+ * @date 2026-10-18
+ */
+
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "model.hpp"
+
+namespace qnn {
+
+/**
+ * @brief How sure a classifier is of its top class
+ */
+enum class ConfidenceMeasure {
+  /** @brief Gap between the two largest logits, in logit units */
+  kMargin,
+  /** @brief Softmax probability of the top class */
+  kMaxProbability,
+};
+
+/**
+ * @brief Confidence of one row of int8 logits
+ *
+ * The softmax is evaluated from integer differences to the largest logit,
+ * which take at most 256 values, so exp() is a table lookup.
+ */
+class ConfidenceScorer {
+ public:
+  explicit ConfidenceScorer(ConfidenceMeasure measure) : measure_(measure) {}
+
+  /**
+   * @brief Score one row of logits
+   *
+   * @param logits int8 logits
+   * @param classes Number of logits
+   * @param scale Quantization scale of the logits
+   * @param prediction Receives the index of the largest logit
+   * @return Margin or top-class probability
+   */
+  float Score(const int8_t* logits, size_t classes, float scale,
+              size_t& prediction) {
+    prediction = 0;
+    int top = logits[0];
+    int second = -256;
+    for (size_t c = 1; c < classes; ++c) {
+      if (logits[c] > top) {
+        second = top;
+        top = logits[c];
+        prediction = c;
+      } else if (logits[c] > second) {
+        second = logits[c];
+      }
+    }
+
+    if (measure_ == ConfidenceMeasure::kMargin) {
+      return classes > 1 ? (top - second) * scale : INFINITY;
+    }
+    if (scale != table_scale_) {
+      for (size_t d = 0; d < exp_.size(); ++d) {
+        exp_[d] = std::exp(-scale * static_cast<float>(d));
+      }
+      table_scale_ = scale;
+    }
+    float sum = 0.0f;
+    for (size_t c = 0; c < classes; ++c) {
+      sum += exp_[top - logits[c]];
+    }
+    return 1.0f / sum;
+  }
+
+ private:
+  ConfidenceMeasure measure_;
+  float table_scale_ = 0.0f;
+  /** @brief exp(-scale * d) for logit differences d */
+  std::array<float, 256> exp_{};
+};
+
+/**
+ * @brief Outcome of one input
+ */
+struct CascadeDecision {
+  /** @brief Stage that answered */
+  size_t stage = 0;
+  size_t prediction = 0;
+  float confidence = 0.0f;
+};
+
+/**
+ * @brief Totals of one cascade stage
+ */
+struct StageMetrics {
+  std::string name;
+  uint64_t batches = 0;
+  uint64_t samples = 0;
+  uint64_t escalated = 0;
+  double total_us = 0.0;
+
+  /** @return Fraction of the stage's inputs passed on */
+  double escalation_rate() const {
+    return samples ? static_cast<double>(escalated) / samples : 0.0;
+  }
+
+  /** @return Stage time per input it saw */
+  double mean_us() const { return samples ? total_us / samples : 0.0; }
+};
+
+/**
+ * @brief Runs inputs through models of growing cost until one is confident
+ *
+ * Each stage classifies the inputs left in the batch, scores the int8
+ * logits and keeps the answers at or above its threshold. The rest are
+ * gathered into a smaller batch for the next stage; the last stage answers
+ * everything it gets.
+ */
+class Cascade {
+ public:
+  /** @param measure Confidence measure shared by all stages */
+  explicit Cascade(ConfidenceMeasure measure = ConfidenceMeasure::kMargin)
+      : scorer_(measure) {}
+
+  /**
+   * @brief Append a stage
+   *
+   * @param model Classifier with [N, classes] output; must outlive the
+   * cascade
+   * @param threshold Confidence below which an input moves on; ignored for
+   * the last stage
+   * @param name Name in the metrics
+   */
+  void AddStage(Model& model, float threshold, std::string name = "") {
+    stages_.push_back({&model, threshold});
+    metrics_.push_back({});
+    metrics_.back().name =
+        name.empty() ? "stage" + std::to_string(stages_.size() - 1) : name;
+  }
+
+  /**
+   * @brief Classify a batch
+   *
+   * @param batch Inputs [N, ...]
+   * @return One decision per input, in input order
+   * @throws std::runtime_error If there are no stages or a model fails
+   */
+  std::vector<CascadeDecision> Run(const Tensor<float>& batch) {
+    if (stages_.empty()) {
+      throw std::runtime_error("Cascade has no stages");
+    }
+    const size_t n = batch.shape().at(0);
+    const size_t sample = n ? batch.size() / n : 0;
+    std::vector<CascadeDecision> decisions(n);
+
+    // Inputs still undecided, as indices into the batch
+    std::vector<size_t> pending(n);
+    for (size_t i = 0; i < n; ++i) {
+      pending[i] = i;
+    }
+    Tensor<float> gathered;
+    double elapsed_us = 0.0;
+
+    for (size_t s = 0; s < stages_.size() && !pending.empty(); ++s) {
+      const bool last = s + 1 == stages_.size();
+      const Tensor<float>* input = &batch;
+      if (pending.size() != n) {
+        std::vector<size_t> shape = batch.shape();
+        shape[0] = pending.size();
+        gathered.resize(shape);
+        for (size_t k = 0; k < pending.size(); ++k) {
+          std::copy(batch.data() + pending[k] * sample,
+                    batch.data() + (pending[k] + 1) * sample,
+                    gathered.data() + k * sample);
+        }
+        input = &gathered;
+      }
+
+      const auto start = std::chrono::steady_clock::now();
+      stages_[s].model->forward(*input);
+      const std::chrono::duration<double, std::micro> stage_time =
+          std::chrono::steady_clock::now() - start;
+      elapsed_us += stage_time.count();
+
+      const Tensor<int8_t>& logits = stages_[s].model->QuantizedOutput();
+      const size_t classes = logits.size() / pending.size();
+      std::vector<size_t> escalate;
+      for (size_t k = 0; k < pending.size(); ++k) {
+        CascadeDecision& d = decisions[pending[k]];
+        d.stage = s;
+        d.confidence = scorer_.Score(logits.data() + k * classes, classes,
+                                     logits.scale(), d.prediction);
+        if (!last && d.confidence < stages_[s].threshold) {
+          escalate.push_back(pending[k]);
+        } else {
+          latency_us_ += elapsed_us;
+        }
+      }
+
+      StageMetrics& m = metrics_[s];
+      m.batches++;
+      m.samples += pending.size();
+      m.escalated += escalate.size();
+      m.total_us += stage_time.count();
+      pending = std::move(escalate);
+    }
+    requests_ += n;
+    return decisions;
+  }
+
+  /** @return Totals per stage */
+  const std::vector<StageMetrics>& Metrics() const { return metrics_; }
+
+  /** @return Inputs classified */
+  uint64_t requests() const { return requests_; }
+
+  /** @return Model time spent per input over all stages */
+  double mean_cost_us() const {
+    double total = 0.0;
+    for (const auto& m : metrics_) {
+      total += m.total_us;
+    }
+    return requests_ ? total / requests_ : 0.0;
+  }
+
+  /**
+   * @return Mean time from the start of a batch to the stage that answered
+   * each input
+   */
+  double mean_latency_us() const {
+    return requests_ ? latency_us_ / requests_ : 0.0;
+  }
+
+  /** @brief Clear the metrics */
+  void ResetMetrics() {
+    for (auto& m : metrics_) {
+      m = StageMetrics{m.name};
+    }
+    requests_ = 0;
+    latency_us_ = 0.0;
+  }
+
+ private:
+  struct Stage {
+    Model* model;
+    float threshold;
+  };
+
+  ConfidenceScorer scorer_;
+  std::vector<Stage> stages_;
+  std::vector<StageMetrics> metrics_;
+  uint64_t requests_ = 0;
+  double latency_us_ = 0.0;
+};
+
+}  // namespace qnn
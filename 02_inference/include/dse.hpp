@@ -0,0 +1,380 @@
+/**
+ * @file dse.hpp
+ * @author Leo (zhsleo@outlook.com)
+ *
+ * @brief Analytical accelerator cost model and design-space sweep
+ * @version 1.0.0
+ * @date 2026-10-18
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstdint>
+#include <thread>
+#include <vector>
+
+#include "workload.hpp"
+
+namespace qnn::dse {
+
+/** @brief Device memory window of the HAL (HAL_ACCEL_MEM_SIZE) */
+constexpr uint64_t kDeviceMemoryBytes = 256ULL * 1024 * 1024;
+
+/** @brief Bytes of one 36Kb block RAM */
+constexpr uint64_t kBram36Bytes = 4608;
+
+/** @brief Bytes of one accumulator (DATA_WIDTH*2+ARRAY_SIZE bits, padded) */
+constexpr uint64_t kAccumulatorBytes = 4;
+
+// Coarse 7-series LUT estimates: PE pipeline/valid logic outside the DSP48,
+// AXI DMA core per channel and its datamover per stream bit
+constexpr uint64_t kLutPerPe = 60;
+constexpr uint64_t kLutPerDmaChannel = 1800;
+constexpr uint64_t kLutPerDmaBit = 12;
+
+/**
+ * @brief One accelerator configuration
+ *
+ * The array computes output-stationary N x N tiles as in systolic_array.sv;
+ * the on-chip buffer holds the A and B panels of a tile plus its
+ * accumulators.
+ */
+struct AcceleratorConfig {
+  /** @brief Systolic array dimension (ARRAY_SIZE) */
+  uint32_t array_size = 8;
+
+  /** @brief On-chip buffer bytes */
+  uint64_t buffer_bytes = 64 * 1024;
+
+  /** @brief DMA stream width in bytes per cycle, per channel */
+  uint32_t dma_bytes_per_cycle = 4;
+
+  /** @brief Independent DMA channels */
+  uint32_t dma_channels = 1;
+
+  /** @brief Accelerator clock */
+  uint32_t clock_mhz = 100;
+
+  /**
+   * @brief Control cycles of one DMA transfer
+   *
+   * Register programming and interrupt handling with the HAL DMA model's
+   * default timing.
+   */
+  uint32_t dma_setup_cycles = 59;
+};
+
+/**
+ * @brief Resources available on the target device (default: XC7Z020)
+ */
+struct DeviceBudget {
+  uint64_t dsp = 220;
+  uint64_t bram36 = 140;
+  uint64_t lut = 53200;
+};
+
+/**
+ * @brief FPGA resources of a configuration
+ */
+struct Resources {
+  uint64_t dsp = 0;    /**< One DSP48 per processing element */
+  uint64_t bram36 = 0; /**< Block RAMs of the on-chip buffer */
+  uint64_t lut = 0;    /**< Array control and DMA engines */
+
+  /**
+   * @brief Share of a device taken by the most constrained resource
+   * @return Fraction, above 1 when the configuration does not fit
+   */
+  double Share(const DeviceBudget& budget) const {
+    return std::max({static_cast<double>(dsp) / budget.dsp,
+                     static_cast<double>(bram36) / budget.bram36,
+                     static_cast<double>(lut) / budget.lut});
+  }
+};
+
+/**
+ * @brief Estimated cost of one layer
+ */
+struct LayerEstimate {
+  uint64_t compute_cycles = 0; /**< Array busy cycles, fill/drain included */
+  uint64_t dma_cycles = 0;     /**< DMA cycles across all channels */
+  uint64_t cycles = 0;         /**< Layer cycles, compute and DMA overlapped */
+  uint64_t traffic_bytes = 0;  /**< Bytes moved between host and buffer */
+  uint64_t transfers = 0;      /**< DMA transfers */
+  bool fits = true;            /**< Whether a tile fits in the buffer */
+};
+
+/**
+ * @brief Estimated cost of one model
+ *
+ * Only GEMM layers are accounted for; pooling and activations run on the host
+ * and do not depend on the accelerator configuration.
+ */
+struct ModelEstimate {
+  uint64_t cycles = 0;    /**< Accelerator cycles per inference */
+  uint64_t macs = 0;      /**< GEMM multiply-accumulates */
+  double latency_us = 0;  /**< Accelerator time per inference */
+  double throughput = 0;  /**< Inferences per second */
+  double utilization = 0; /**< Achieved share of peak MACs */
+  bool fits = true;       /**< Whether the model fits this configuration */
+};
+
+/**
+ * @brief One evaluated point of the design space
+ */
+struct DesignPoint {
+  AcceleratorConfig config;
+  Resources resources;
+  std::vector<ModelEstimate> models; /**< In model zoo order */
+  double throughput = 0; /**< Geometric mean over models, inferences/s */
+  double share = 0;      /**< Device share, see Resources::Share */
+  bool feasible = true;  /**< Fits the device and every model fits */
+  bool pareto = false;   /**< Not dominated by another feasible point */
+};
+
+/**
+ * @brief Values swept for each configuration parameter
+ */
+struct SweepSpace {
+  std::vector<uint32_t> array_sizes = {4, 8, 16, 32};
+  std::vector<uint64_t> buffer_bytes = {16 * 1024, 64 * 1024, 256 * 1024};
+  std::vector<uint32_t> dma_bytes_per_cycle = {4, 8, 16};
+  std::vector<uint32_t> dma_channels = {1, 2};
+  uint32_t clock_mhz = 100;
+};
+
+inline uint64_t CeilDiv(uint64_t a, uint64_t b) { return (a + b - 1) / b; }
+
+/**
+ * @brief Estimate the FPGA resources of a configuration
+ */
+inline Resources EstimateResources(const AcceleratorConfig& config) {
+  Resources r;
+  r.dsp = uint64_t{config.array_size} * config.array_size;
+  r.bram36 = CeilDiv(config.buffer_bytes, kBram36Bytes);
+  const uint64_t dma_bits = uint64_t{config.dma_bytes_per_cycle} * 8;
+  r.lut = r.dsp * kLutPerPe +
+          config.dma_channels * (kLutPerDmaChannel + dma_bits * kLutPerDmaBit);
+  return r;
+}
+
+/**
+ * @brief Estimate one GEMM layer on a configuration
+ *
+ * The reduction is split into chunks that fit the buffer next to the tile's
+ * accumulators; every chunk pays the array fill/drain. Traffic depends on how
+ * much of the operands the buffer keeps resident:
+ * - all weights and one A panel: every operand is loaded once
+ * - one A and one B panel: A panels are reused across output columns
+ * - neither: both operands are reloaded for every tile
+ */
+inline LayerEstimate EstimateLayer(const LayerWorkload& layer,
+                                   const AcceleratorConfig& config) {
+  LayerEstimate e;
+  if (!layer.gemm) {
+    return e;
+  }
+
+  const uint64_t n = config.array_size;
+  const uint64_t acc_bytes = n * n * kAccumulatorBytes;
+  if (config.buffer_bytes <= acc_bytes + 2 * n) {
+    e.fits = false;
+    return e;
+  }
+  const uint64_t avail = config.buffer_bytes - acc_bytes;
+  const uint64_t row_blocks = CeilDiv(layer.m, n);
+  const uint64_t col_blocks = CeilDiv(layer.n, n);
+  const uint64_t tiles = row_blocks * col_blocks;
+  const uint64_t k_chunk = std::min<uint64_t>(layer.k, avail / (2 * n));
+  const uint64_t k_chunks = CeilDiv(layer.k, k_chunk);
+
+  e.compute_cycles = tiles * (layer.k + k_chunks * (2 * n - 1));
+
+  const uint64_t a_bytes = layer.m * layer.k;
+  const uint64_t b_bytes = layer.k * layer.n;
+  const uint64_t c_bytes = layer.m * layer.n;
+  if (b_bytes + n * layer.k <= avail) {
+    e.traffic_bytes = a_bytes + b_bytes;
+    e.transfers = row_blocks + 1;
+  } else if (k_chunks == 1) {
+    e.traffic_bytes = a_bytes + row_blocks * b_bytes;
+    e.transfers = row_blocks + tiles;
+  } else {
+    e.traffic_bytes = col_blocks * a_bytes + row_blocks * b_bytes;
+    e.transfers = 2 * tiles * k_chunks;
+  }
+  e.traffic_bytes += c_bytes;
+  e.transfers += tiles;
+
+  const uint64_t bandwidth =
+      uint64_t{config.dma_bytes_per_cycle} * config.dma_channels;
+  e.dma_cycles = CeilDiv(e.traffic_bytes, bandwidth) +
+                 CeilDiv(e.transfers * config.dma_setup_cycles,
+                         config.dma_channels);
+
+  // Double-buffered: the first transfer is exposed, the rest overlap
+  e.cycles =
+      std::max(e.compute_cycles, e.dma_cycles) + config.dma_setup_cycles;
+  return e;
+}
+
+/**
+ * @brief Estimate a whole model on a configuration
+ *
+ * A model does not fit if a tile does not fit the buffer or its weights plus
+ * the largest layer's activations exceed the device memory window.
+ */
+inline ModelEstimate EstimateModel(const std::vector<LayerWorkload>& layers,
+                                   const AcceleratorConfig& config) {
+  ModelEstimate m;
+  uint64_t weights = 0;
+  uint64_t activations = 0;
+  for (const auto& layer : layers) {
+    if (!layer.gemm) {
+      continue;
+    }
+    LayerEstimate e = EstimateLayer(layer, config);
+    m.fits = m.fits && e.fits;
+    m.cycles += e.cycles;
+    m.macs += layer.macs;
+    weights += layer.weight_bytes;
+    activations =
+        std::max(activations, layer.input_bytes + layer.output_bytes);
+  }
+  if (weights + activations > kDeviceMemoryBytes) {
+    m.fits = false;
+  }
+  if (!m.fits || m.cycles == 0) {
+    return m;
+  }
+
+  const uint64_t pes = uint64_t{config.array_size} * config.array_size;
+  m.latency_us = static_cast<double>(m.cycles) / config.clock_mhz;
+  m.throughput = 1e6 / m.latency_us;
+  m.utilization = static_cast<double>(m.macs) / (m.cycles * pes);
+  return m;
+}
+
+/**
+ * @brief Enumerate every configuration of a sweep space
+ */
+inline std::vector<AcceleratorConfig> Enumerate(const SweepSpace& space) {
+  std::vector<AcceleratorConfig> configs;
+  for (uint32_t array : space.array_sizes) {
+    for (uint64_t buffer : space.buffer_bytes) {
+      for (uint32_t width : space.dma_bytes_per_cycle) {
+        for (uint32_t channels : space.dma_channels) {
+          AcceleratorConfig c;
+          c.array_size = array;
+          c.buffer_bytes = buffer;
+          c.dma_bytes_per_cycle = width;
+          c.dma_channels = channels;
+          c.clock_mhz = space.clock_mhz;
+          configs.push_back(c);
+        }
+      }
+    }
+  }
+  return configs;
+}
+
+/**
+ * @brief Evaluate one configuration over a model zoo
+ */
+inline DesignPoint Evaluate(
+    const std::vector<std::vector<LayerWorkload>>& zoo,
+    const AcceleratorConfig& config, const DeviceBudget& budget) {
+  DesignPoint p;
+  p.config = config;
+  p.resources = EstimateResources(config);
+  p.share = p.resources.Share(budget);
+  p.feasible = p.share <= 1.0;
+  double log_sum = 0;
+  for (const auto& model : zoo) {
+    p.models.push_back(EstimateModel(model, config));
+    const ModelEstimate& m = p.models.back();
+    p.feasible = p.feasible && m.fits && m.throughput > 0;
+    log_sum += p.feasible ? std::log(m.throughput) : 0;
+  }
+  p.throughput =
+      p.feasible && !zoo.empty() ? std::exp(log_sum / zoo.size()) : 0;
+  return p;
+}
+
+/**
+ * @brief Whether a is at least as fast and as small as b, and better in one
+ *
+ * Size is the device share, so a point is judged by the resource that limits
+ * how much else fits next to it.
+ */
+inline bool Dominates(const DesignPoint& a, const DesignPoint& b) {
+  if (a.throughput < b.throughput || a.share > b.share) {
+    return false;
+  }
+  if (a.throughput > b.throughput || a.share < b.share) {
+    return true;
+  }
+  // Same speed and share: prefer the point using less of the other resources
+  const Resources& x = a.resources;
+  const Resources& y = b.resources;
+  return x.dsp <= y.dsp && x.bram36 <= y.bram36 && x.lut <= y.lut &&
+         (x.dsp < y.dsp || x.bram36 < y.bram36 || x.lut < y.lut);
+}
+
+/**
+ * @brief Mark the feasible points no other feasible point dominates
+ */
+inline void MarkPareto(std::vector<DesignPoint>& points) {
+  for (auto& p : points) {
+    p.pareto = p.feasible;
+    for (const auto& q : points) {
+      if (p.pareto && q.feasible && Dominates(q, p)) {
+        p.pareto = false;
+      }
+    }
+  }
+}
+
+/**
+ * @brief Evaluate configurations over a model zoo on several threads
+ *
+ * @param zoo Workloads of each model
+ * @param configs Configurations to evaluate
+ * @param budget Target device resources
+ * @param threads Worker threads, 0 for one per core
+ * @return One point per configuration, in order, with the Pareto front marked
+ */
+inline std::vector<DesignPoint> Sweep(
+    const std::vector<std::vector<LayerWorkload>>& zoo,
+    const std::vector<AcceleratorConfig>& configs,
+    const DeviceBudget& budget = {}, size_t threads = 0) {
+  if (threads == 0) {
+    threads = std::max(1u, std::thread::hardware_concurrency());
+  }
+  threads = std::min(threads, std::max<size_t>(configs.size(), 1));
+
+  std::vector<DesignPoint> points(configs.size());
+  std::atomic<size_t> next{0};
+  auto worker = [&]() {
+    for (size_t i = next++; i < configs.size(); i = next++) {
+      points[i] = Evaluate(zoo, configs[i], budget);
+    }
+  };
+
+  std::vector<std::thread> pool;
+  for (size_t t = 1; t < threads; ++t) {
+    pool.emplace_back(worker);
+  }
+  worker();
+  for (auto& t : pool) {
+    t.join();
+  }
+
+  MarkPareto(points);
+  return points;
+}
+
+}  // namespace qnn::dse
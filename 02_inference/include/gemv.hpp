@@ -0,0 +1,170 @@
+/**
+ * @file gemv.hpp
+ * @author Leo (zhsleo@outlook.com)
+ *
+ * @brief int8 matrix-vector kernel over prepacked weights
+ * @version 1.0.0
+ * @date 2026-10-18
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "thread_pool.hpp"
+
+namespace qnn {
+
+/**
+ * @brief Weight matrix packed into panels for Gemv
+ *
+ * Rows are grouped in blocks of kRows and each block is stored as a sequence
+ * of kRows x kCols tiles, so a block is one contiguous stream that fills
+ * exactly one cache line per tile. Missing rows and columns are zero.
+ */
+struct PackedGemv {
+  static constexpr size_t kRows = 4;
+  static constexpr size_t kCols = 16;
+  /** @brief Below this many weight bytes a product runs on one thread */
+  static constexpr size_t kParallelBytes = 256 << 10;
+
+  size_t rows = 0;
+  size_t cols = 0;
+  size_t padded_cols = 0;
+  std::vector<int8_t> panels;
+
+  /** @return Number of row blocks */
+  size_t blocks() const { return (rows + kRows - 1) / kRows; }
+
+  /** @return Bytes streamed per product */
+  size_t bytes() const { return panels.size(); }
+};
+
+/**
+ * @brief Pack a row-major [rows, cols] int8 matrix
+ */
+inline PackedGemv PackGemv(const int8_t* weight, size_t rows, size_t cols) {
+  constexpr size_t kRows = PackedGemv::kRows, kCols = PackedGemv::kCols;
+  PackedGemv packed;
+  packed.rows = rows;
+  packed.cols = cols;
+  packed.padded_cols = (cols + kCols - 1) / kCols * kCols;
+  packed.panels.assign(packed.blocks() * kRows * packed.padded_cols, 0);
+
+  int8_t* out = packed.panels.data();
+  for (size_t block = 0; block < packed.blocks(); ++block) {
+    for (size_t c = 0; c < packed.padded_cols; c += kCols) {
+      for (size_t r = 0; r < kRows; ++r) {
+        const size_t row = block * kRows + r;
+        for (size_t j = 0; j < kCols; ++j) {
+          if (row < rows && c + j < cols) {
+            out[r * kCols + j] = weight[row * cols + c + j];
+          }
+        }
+      }
+      out += kRows * kCols;
+    }
+  }
+  return packed;
+}
+
+/**
+ * @brief Exact int32 dot products of row blocks [begin, end) with x
+ *
+ * @param w Packed weights
+ * @param x Input padded to w.padded_cols with zeros
+ * @param y Output, w.rows elements
+ */
+inline void GemvBlocks(const PackedGemv& w, const int8_t* x, int32_t* y,
+                       size_t begin, size_t end) {
+  constexpr size_t kRows = PackedGemv::kRows, kCols = PackedGemv::kCols;
+  // Tiles fetched ahead of use; eight cache lines cover DRAM latency
+  constexpr size_t kPrefetchBytes = 8 * kRows * kCols;
+  const size_t block_bytes = kRows * w.padded_cols;
+
+  for (size_t block = begin; block < end; ++block) {
+    const int8_t* p = w.panels.data() + block * block_bytes;
+    const int8_t* stop = p + block_bytes;
+    int32_t acc[kRows][kCols] = {};
+
+    for (const int8_t* xc = x; p < stop; p += kRows * kCols, xc += kCols) {
+      __builtin_prefetch(p + kPrefetchBytes, 0, 0);
+      for (size_t r = 0; r < kRows; ++r) {
+        for (size_t j = 0; j < kCols; ++j) {
+          acc[r][j] += int32_t{xc[j]} * p[r * kCols + j];
+        }
+      }
+    }
+
+    for (size_t r = 0; r < kRows; ++r) {
+      const size_t row = block * kRows + r;
+      if (row < w.rows) {
+        int32_t sum = 0;
+        for (size_t j = 0; j < kCols; ++j) {
+          sum += acc[r][j];
+        }
+        y[row] = sum;
+      }
+    }
+  }
+}
+
+/**
+ * @brief Rows [begin, end) of y = W x, split across the pool by row blocks
+ *
+ * Small products run on the calling thread, as waking the workers costs more
+ * than streaming a few hundred kilobytes.
+ *
+ * @param w Packed weights
+ * @param x Input, w.cols elements
+ * @param y Output, w.rows elements; the row blocks covering [begin, end) get
+ * their exact int32 sums
+ * @param begin First row
+ * @param end One past the last row
+ * @param pool Pool to split over, nullptr for the calling thread only
+ */
+inline void GemvRows(const PackedGemv& w, const int8_t* x, int32_t* y,
+                     size_t begin, size_t end,
+                     ThreadPool* pool = &ThreadPool::Current()) {
+  // Pad the input once; it stays in L1 while the weights stream past it
+  thread_local std::vector<int8_t> padded;
+  padded.assign(w.padded_cols, 0);
+  std::copy(x, x + w.cols, padded.begin());
+  const int8_t* xp = padded.data();
+
+  const size_t first = begin / PackedGemv::kRows;
+  const size_t last = (end + PackedGemv::kRows - 1) / PackedGemv::kRows;
+  const size_t bytes = (last - first) * PackedGemv::kRows * w.padded_cols;
+  if (!pool || pool->size() == 1 || bytes < PackedGemv::kParallelBytes) {
+    GemvBlocks(w, xp, y, first, last);
+    return;
+  }
+
+  // A few chunks per thread balance uneven progress
+  const size_t grain =
+      std::max<size_t>(1, (last - first) / (4 * pool->size()));
+  pool->ParallelFor(
+      last - first,
+      [&](size_t from, size_t to) {
+        GemvBlocks(w, xp, y, first + from, first + to);
+      },
+      grain);
+}
+
+/**
+ * @brief y = W x for one int8 vector, split across the pool by row blocks
+ *
+ * @param w Packed weights
+ * @param x Input, w.cols elements
+ * @param y Output, w.rows exact int32 sums
+ * @param pool Pool to split over, nullptr for the calling thread only
+ */
+inline void Gemv(const PackedGemv& w, const int8_t* x, int32_t* y,
+                 ThreadPool* pool = &ThreadPool::Current()) {
+  GemvRows(w, x, y, 0, w.rows, pool);
+}
+
+}  // namespace qnn
@@ -0,0 +1,469 @@
+/**
+ * @file indirect_conv.hpp
+ * @author Leo (zhsleo@outlook.com)
+ *
+ * @brief int8 convolution through an indirection buffer, without im2col
+ * @version 1.0.0
+ * @date 2026-10-18
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <list>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+#include "thread_pool.hpp"
+
+namespace qnn {
+
+/**
+ * @brief Indirect GEMM convolution
+ *
+ * The input is viewed as NHWC rows, one row of in_channels values per pixel.
+ * A plan built once per region stores, for every output pixel and kernel
+ * position, the input row it reads; positions in the padding read a shared
+ * row of zeros. The microkernel reads through the table, so neither an
+ * im2col matrix nor a padded copy is ever built.
+ *
+ * Plans are cached by the region's geometry relative to its input tile, so
+ * the interior tiles of a tiled run share one plan, and the NHWC rows of a
+ * run live in a per-thread workspace, so one convolution may run on several
+ * threads at once.
+ *
+ * Weights are packed once into blocks of kChannels output channels laid out
+ * [kernel position][in channel][kChannels], and each microkernel call
+ * produces a kPixels x kChannels tile of exact int32 sums.
+ */
+class IndirectConv {
+ public:
+  static constexpr size_t kPixels = 4;
+  static constexpr size_t kChannels = 8;
+
+  /**
+   * @brief Part of a convolution computed by one call
+   *
+   * The input holds rows [in_y0, in_y0 + in_height) and columns
+   * [in_x0, in_x0 + in_width) of an image_height x image_width map, and the
+   * call computes the out_height x out_width outputs from (out_y0, out_x0).
+   * Positions outside the image read zeros.
+   */
+  struct Region {
+    size_t batch = 0;
+    size_t in_y0 = 0, in_x0 = 0, in_height = 0, in_width = 0;
+    size_t image_height = 0, image_width = 0;
+    size_t out_y0 = 0, out_x0 = 0, out_height = 0, out_width = 0;
+  };
+
+  IndirectConv() = default;
+
+  /**
+   * @brief Pack OIHW int8 weights
+   *
+   * @param weight Weights [out_channels, in_channels, kernel, kernel]
+   */
+  IndirectConv(const int8_t* weight, size_t out_channels, size_t in_channels,
+               size_t kernel, size_t stride, size_t padding)
+      : out_channels_(out_channels),
+        in_channels_(in_channels),
+        kernel_(kernel),
+        stride_(stride),
+        padding_(padding),
+        zero_(in_channels, 0) {
+    const size_t positions = kernel * kernel;
+    packed_.assign(blocks() * positions * in_channels * kChannels, 0);
+    for (size_t oc = 0; oc < out_channels; ++oc) {
+      int8_t* block = packed_.data() +
+                      oc / kChannels * positions * in_channels * kChannels;
+      for (size_t ic = 0; ic < in_channels; ++ic) {
+        for (size_t pos = 0; pos < positions; ++pos) {
+          block[(pos * in_channels + ic) * kChannels + oc % kChannels] =
+              weight[(oc * in_channels + ic) * positions + pos];
+        }
+      }
+    }
+  }
+
+  /** @return Output height for an input height */
+  size_t out_size(size_t in_size) const {
+    return (in_size + 2 * padding_ - kernel_) / stride_ + 1;
+  }
+
+  /**
+   * @brief Convolve an NCHW input
+   *
+   * @param input Input [batch, in_channels, height, width]
+   * @param store Called as store(n, oc, pixel, acc) for every output, where
+   * pixel is oh * out_width + ow
+   * @param pool Pool to split output tiles over, nullptr for the caller only
+   */
+  template <typename Store>
+  void Run(const int8_t* input, size_t batch, size_t height, size_t width,
+           Store&& store, ThreadPool* pool = &ThreadPool::Current()) const {
+    Region region;
+    region.batch = batch;
+    region.in_height = region.image_height = height;
+    region.in_width = region.image_width = width;
+    region.out_height = out_size(height);
+    region.out_width = out_size(width);
+    Run(input, region, std::forward<Store>(store), pool);
+  }
+
+  /**
+   * @brief Convolve a region of an NCHW input
+   *
+   * @param input Input [batch, in_channels, in_height, in_width]
+   * @param region Input tile and output region
+   * @param store Called as store(n, oc, pixel, acc) for every output, where
+   * pixel is the row-major index within the output region
+   * @param pool Pool to split output tiles over, nullptr for the caller only
+   * @throws std::runtime_error If the input tile misses part of the footprint
+   */
+  template <typename Store>
+  void Run(const int8_t* input, const Region& region, Store&& store,
+           ThreadPool* pool = &ThreadPool::Current()) const {
+    RunChannels(input, region, 0, out_channels_, std::forward<Store>(store),
+                pool);
+  }
+
+  /**
+   * @brief Convolve a region of an NCHW input for some output channels
+   *
+   * Only the weight blocks holding channels [begin, end) are multiplied.
+   *
+   * @param input Input [batch, in_channels, in_height, in_width]
+   * @param region Input tile and output region
+   * @param begin First output channel
+   * @param end One past the last output channel
+   * @param store Called as store(n, oc, pixel, acc) for every output of the
+   * channels, where pixel is the row-major index within the output region
+   * @param pool Pool to split output tiles over, nullptr for the caller only
+   * @throws std::runtime_error If the input tile misses part of the footprint
+   */
+  template <typename Store>
+  void RunChannels(const int8_t* input, const Region& region, size_t begin,
+                   size_t end, Store&& store,
+                   ThreadPool* pool = &ThreadPool::Current()) const {
+    const size_t pixels = region.out_height * region.out_width;
+    const size_t first = begin / kChannels;
+    const size_t last = (end + kChannels - 1) / kChannels;
+    ForEachTile(
+        input, region,
+        [&](size_t n, size_t pixel, const int8_t* const* rows) {
+          for (size_t block = first; block < last; ++block) {
+            int32_t acc[kPixels][kChannels] = {};
+            Tile(rows, block, acc);
+            for (size_t m = 0; m < kPixels && pixel + m < pixels; ++m) {
+              for (size_t c = 0; c < kChannels; ++c) {
+                const size_t oc = block * kChannels + c;
+                if (oc >= begin && oc < end) {
+                  store(n, oc, pixel + m, acc[m][c]);
+                }
+              }
+            }
+          }
+        },
+        pool);
+  }
+
+  /**
+   * @brief Visit the output tiles of a region, for another microkernel
+   *
+   * @param input Input [batch, in_channels, in_height, in_width]
+   * @param region Input tile and output region
+   * @param tile Called as tile(n, pixel, rows) for every kPixels outputs
+   * from pixel, with their table entries [position][kPixels]
+   * @param pool Pool to split output tiles over, nullptr for the caller only
+   * @throws std::runtime_error If the input tile misses part of the footprint
+   */
+  template <typename TileFn>
+  void ForEachTile(const int8_t* input, const Region& region, TileFn&& tile,
+                   ThreadPool* pool = &ThreadPool::Current()) const {
+    const size_t batch = region.batch;
+    const std::shared_ptr<const Plan> plan = GetPlan(region);
+
+    // Taken out of the thread's workspace, so a nested run gets its own
+    std::vector<int8_t> rows = std::move(SpareRows());
+    ToRows(input, batch, region.in_height, region.in_width, rows);
+    const int8_t* base = rows.data();
+
+    const size_t pixels = region.out_height * region.out_width;
+    const size_t tiles = (pixels + kPixels - 1) / kPixels;
+    const size_t entries = positions() * kPixels;
+    const size_t macs = batch * pixels * out_channels_ * positions() *
+                        in_channels_;
+
+    auto run_tiles = [&](size_t begin, size_t end) {
+      std::vector<const int8_t*> table(entries);
+      for (size_t t = begin; t < end; ++t) {
+        const uint32_t* entry = plan->rows.data() + t * entries;
+        for (size_t i = 0; i < entries; ++i) {
+          table[i] = entry[i] == kZeroRow
+                         ? zero_.data()
+                         : base + size_t{entry[i]} * in_channels_;
+        }
+        tile(t / tiles, t % tiles * kPixels, table.data());
+      }
+    };
+
+    // Below about a million MACs the workers would mostly wait on wake-up
+    constexpr size_t kParallelMacs = 1 << 20;
+    if (!pool || pool->size() == 1 || macs < kParallelMacs) {
+      run_tiles(0, batch * tiles);
+    } else {
+      pool->ParallelFor(batch * tiles, run_tiles);
+    }
+    SpareRows() = std::move(rows);
+  }
+
+  /** @return Blocks of kChannels output channels */
+  size_t blocks() const { return (out_channels_ + kChannels - 1) / kChannels; }
+
+  /** @return Kernel positions, kernel * kernel */
+  size_t positions() const { return kernel_ * kernel_; }
+
+  size_t in_channels() const { return in_channels_; }
+
+  /** @return Packed weights of an output channel block */
+  const int8_t* weights(size_t block) const {
+    return packed_.data() + block * positions() * in_channels_ * kChannels;
+  }
+
+  /** @return Plans currently cached */
+  size_t cached_plans() const {
+    std::lock_guard<std::mutex> lock(plans_->mutex);
+    return plans_->plans.size();
+  }
+
+  /** @brief Plans kept per convolution; the least recently used goes first */
+  static constexpr size_t kMaxPlans = 256;
+
+ private:
+  /** @brief Table entry of positions in the padding */
+  static constexpr uint32_t kZeroRow = UINT32_MAX;
+
+  /**
+   * @brief Region geometry in input tile coordinates, all a plan depends on
+   *
+   * Along each axis, first is where the first output's window starts, and
+   * image rows or columns [begin, end) hold data, clamped to the footprint
+   * of the outputs. Tiles away from the border thus share one geometry
+   * whatever their position in the image.
+   */
+  struct Geometry {
+    size_t batch = 0, in_height = 0, in_width = 0;
+    size_t out_height = 0, out_width = 0;
+    int64_t y_first = 0, y_begin = 0, y_end = 0;
+    int64_t x_first = 0, x_begin = 0, x_end = 0;
+
+    std::array<int64_t, 11> key() const {
+      return {int64_t(batch),      int64_t(in_height), int64_t(in_width),
+              int64_t(out_height), int64_t(out_width), y_first,
+              y_begin,             y_end,              x_first,
+              x_begin,             x_end};
+    }
+  };
+
+  /**
+   * @brief Indirection table of one region
+   *
+   * Entries are input pixels, the NHWC row index within the region's input,
+   * so the table does not depend on where a run keeps its rows.
+   */
+  struct Plan {
+    /** @brief Input pixel or kZeroRow, [batch * tile][position][kPixels] */
+    std::vector<uint32_t> rows;
+  };
+
+  using PlanKey = std::array<int64_t, 11>;
+
+  /** @brief Plans by geometry, shared by copies of the convolution */
+  struct PlanCache {
+    std::mutex mutex;
+
+    /** @brief Keys, most recently used first */
+    std::list<PlanKey> order;
+
+    /** @brief Plan and place in order of each key */
+    std::map<PlanKey, std::pair<std::shared_ptr<const Plan>,
+                                std::list<PlanKey>::iterator>>
+        plans;
+
+    /** @return Cached plan marked as most recently used, or nullptr */
+    std::shared_ptr<const Plan> Find(const PlanKey& key) {
+      auto it = plans.find(key);
+      if (it == plans.end()) {
+        return nullptr;
+      }
+      order.splice(order.begin(), order, it->second.second);
+      return it->second.first;
+    }
+  };
+
+  /** @return NHWC row buffer reused by runs on the calling thread */
+  static std::vector<int8_t>& SpareRows() {
+    thread_local std::vector<int8_t> rows;
+    return rows;
+  }
+
+  /** @return Geometry of a region relative to its input tile */
+  Geometry Place(const Region& region) const {
+    // First window start and the image span, clamped to the footprint
+    auto axis = [&](size_t out0, size_t out_size, size_t in0, size_t image,
+                    int64_t& first, int64_t& begin, int64_t& end) {
+      first = int64_t(out0 * stride_) - int64_t(padding_) - int64_t(in0);
+      const int64_t last =
+          first + int64_t(out_size ? (out_size - 1) * stride_ + kernel_ : 0);
+      begin = std::clamp(-int64_t(in0), first, last);
+      end = std::clamp(int64_t(image) - int64_t(in0), first, last);
+    };
+    Geometry g;
+    g.batch = region.batch;
+    g.in_height = region.in_height;
+    g.in_width = region.in_width;
+    g.out_height = region.out_height;
+    g.out_width = region.out_width;
+    axis(region.out_y0, region.out_height, region.in_y0, region.image_height,
+         g.y_first, g.y_begin, g.y_end);
+    axis(region.out_x0, region.out_width, region.in_x0, region.image_width,
+         g.x_first, g.x_begin, g.x_end);
+    return g;
+  }
+
+  /** @brief Cached plan of a region, built on first use */
+  std::shared_ptr<const Plan> GetPlan(const Region& region) const {
+    const Geometry geometry = Place(region);
+    const PlanKey key = geometry.key();
+    {
+      std::lock_guard<std::mutex> lock(plans_->mutex);
+      if (auto plan = plans_->Find(key)) {
+        return plan;
+      }
+    }
+    std::shared_ptr<const Plan> plan = BuildPlan(geometry);
+    std::lock_guard<std::mutex> lock(plans_->mutex);
+    // Another thread may have built it meanwhile
+    if (auto built = plans_->Find(key)) {
+      return built;
+    }
+    if (plans_->plans.size() >= kMaxPlans) {
+      plans_->plans.erase(plans_->order.back());
+      plans_->order.pop_back();
+    }
+    plans_->order.push_front(key);
+    plans_->plans.emplace(key, std::make_pair(plan, plans_->order.begin()));
+    return plan;
+  }
+
+  /**
+   * @brief Build the indirection table for a region's geometry
+   * @throws std::runtime_error If the input tile misses part of the footprint
+   */
+  std::shared_ptr<const Plan> BuildPlan(const Geometry& g) const {
+    const size_t batch = g.batch;
+    const size_t height = g.in_height, width = g.in_width;
+    if (batch * height * width >= kZeroRow) {
+      throw std::runtime_error("Convolution input too large to plan");
+    }
+
+    const size_t out_w = g.out_width;
+    const size_t pixels = g.out_height * out_w;
+    const size_t tiles = (pixels + kPixels - 1) / kPixels;
+    const size_t positions = kernel_ * kernel_;
+    auto plan = std::make_shared<Plan>();
+    plan->rows.assign(batch * tiles * positions * kPixels, kZeroRow);
+
+    for (size_t n = 0; n < batch; ++n) {
+      for (size_t pixel = 0; pixel < pixels; ++pixel) {
+        const size_t tile = n * tiles + pixel / kPixels;
+        const int64_t y0 = g.y_first + int64_t(pixel / out_w * stride_);
+        const int64_t x0 = g.x_first + int64_t(pixel % out_w * stride_);
+        for (size_t kh = 0; kh < kernel_; ++kh) {
+          for (size_t kw = 0; kw < kernel_; ++kw) {
+            // Input tile coordinates; outside the image is padding
+            const int64_t y = y0 + int64_t(kh);
+            const int64_t x = x0 + int64_t(kw);
+            if (y < g.y_begin || y >= g.y_end || x < g.x_begin ||
+                x >= g.x_end) {
+              continue;
+            }
+            if (y < 0 || y >= int64_t(height) || x < 0 ||
+                x >= int64_t(width)) {
+              throw std::runtime_error(
+                  "Input tile does not cover the convolution footprint");
+            }
+            plan->rows[(tile * positions + kh * kernel_ + kw) * kPixels +
+                       pixel % kPixels] =
+                static_cast<uint32_t>((n * height + size_t(y)) * width +
+                                      size_t(x));
+          }
+        }
+      }
+    }
+    return plan;
+  }
+
+  /** @brief Transpose NCHW planes into the NHWC rows the table indexes */
+  void ToRows(const int8_t* input, size_t batch, size_t height, size_t width,
+              std::vector<int8_t>& rows) const {
+    const size_t plane = height * width;
+    rows.resize(batch * plane * in_channels_);
+    for (size_t n = 0; n < batch; ++n) {
+      const int8_t* src = input + n * in_channels_ * plane;
+      int8_t* dst = rows.data() + n * plane * in_channels_;
+      for (size_t ic = 0; ic < in_channels_; ++ic) {
+        for (size_t p = 0; p < plane; ++p) {
+          dst[p * in_channels_ + ic] = src[ic * plane + p];
+        }
+      }
+    }
+  }
+
+  /**
+   * @brief Microkernel: kPixels x kChannels sums over all kernel positions
+   *
+   * @param rows Table entries of the tile, [position][kPixels]
+   * @param block Output channel block
+   */
+  void Tile(const int8_t* const* rows, size_t block,
+            int32_t (&acc)[kPixels][kChannels]) const {
+    const size_t positions = kernel_ * kernel_;
+    const int8_t* w =
+        packed_.data() + block * positions * in_channels_ * kChannels;
+    for (size_t pos = 0; pos < positions; ++pos, rows += kPixels) {
+      for (size_t ic = 0; ic < in_channels_; ++ic, w += kChannels) {
+        for (size_t m = 0; m < kPixels; ++m) {
+          const int32_t a = rows[m][ic];
+          for (size_t c = 0; c < kChannels; ++c) {
+            acc[m][c] += a * w[c];
+          }
+        }
+      }
+    }
+  }
+
+  size_t out_channels_ = 0;
+  size_t in_channels_ = 0;
+  size_t kernel_ = 0;
+  size_t stride_ = 1;
+  size_t padding_ = 0;
+
+  /** @brief Weights [block][position][in channel][kChannels] */
+  std::vector<int8_t> packed_;
+
+  /** @brief Row read for positions in the padding */
+  std::vector<int8_t> zero_;
+
+  /** @brief Indirection tables of the geometries run so far */
+  std::shared_ptr<PlanCache> plans_ = std::make_shared<PlanCache>();
+};
+
+}  // namespace qnn
@@ -0,0 +1,734 @@
+/**
+ * @file jit.hpp
+ * @author Leo (zhsleo@outlook.com)
+ *
+ * @brief x86-64 code generation of shape-specialized int8 microkernels
+ * @version 1.0.0
+ * @date 2026-10-18
+ */
+
+#pragma once
+
+#include <sys/mman.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "gemv.hpp"
+#include "indirect_conv.hpp"
+#include "thread_pool.hpp"
+
+namespace qnn {
+namespace jit {
+
+/** @return True if this build and CPU can run generated kernels */
+inline bool Supported() {
+#if defined(__x86_64__) && !defined(QNN_DISABLE_JIT)
+  return __builtin_cpu_supports("avx2");
+#else
+  return false;
+#endif
+}
+
+inline std::atomic<bool>& EnabledFlag() {
+  static std::atomic<bool> enabled([] {
+    const char* env = std::getenv("QNN_JIT");
+    return Supported() && !(env && std::string(env) == "0");
+  }());
+  return enabled;
+}
+
+/**
+ * @brief Whether operators use generated kernels
+ *
+ * On by default where supported; QNN_JIT=0 in the environment turns it off
+ * and the operators fall back to the precompiled kernels.
+ */
+inline bool Enabled() { return EnabledFlag(); }
+
+/** @brief Turn generated kernels on or off; stays off where unsupported */
+inline void SetEnabled(bool enabled) { EnabledFlag() = enabled && Supported(); }
+
+/**
+ * @brief Executable copy of generated code
+ */
+class CodeBuffer {
+ public:
+  /** @throws std::runtime_error If the memory cannot be mapped */
+  explicit CodeBuffer(const std::vector<uint8_t>& code) : size_(code.size()) {
+    void* memory = mmap(nullptr, size_, PROT_READ | PROT_WRITE,
+                        MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (memory == MAP_FAILED) {
+      throw std::runtime_error("Failed to map JIT code buffer");
+    }
+    std::memcpy(memory, code.data(), size_);
+    if (mprotect(memory, size_, PROT_READ | PROT_EXEC) != 0) {
+      munmap(memory, size_);
+      throw std::runtime_error("Failed to make JIT code executable");
+    }
+    memory_ = memory;
+  }
+
+  ~CodeBuffer() { munmap(memory_, size_); }
+
+  CodeBuffer(const CodeBuffer&) = delete;
+  CodeBuffer& operator=(const CodeBuffer&) = delete;
+
+  template <typename Fn>
+  Fn entry() const {
+    return reinterpret_cast<Fn>(memory_);
+  }
+
+ private:
+  void* memory_ = nullptr;
+  size_t size_ = 0;
+};
+
+/** @brief General-purpose registers, in encoding order */
+enum Reg { rax, rcx, rdx, rbx, rsp, rbp, rsi, rdi, r8, r9, r10, r11 };
+
+/** @brief Memory operand [base + disp] */
+struct Mem {
+  int base;
+  int32_t disp = 0;
+};
+
+/**
+ * @brief Emits the x86-64 and AVX2 instructions the kernels need
+ *
+ * Vector registers are numbered 0-15 and every VEX instruction uses the
+ * three-byte prefix. Memory operands always carry a 32-bit displacement.
+ */
+class Assembler {
+ public:
+  /** @brief Jump target, bound once */
+  struct Label {
+    size_t position = SIZE_MAX;
+    std::vector<size_t> fixups;
+  };
+
+  const std::vector<uint8_t>& code() const { return code_; }
+
+  void Bind(Label& label) {
+    label.position = code_.size();
+    for (size_t at : label.fixups) {
+      Patch(at, label.position);
+    }
+  }
+
+  // General-purpose instructions, 64-bit operands
+
+  void push(Reg r) {
+    if (r & 8) Byte(0x41);
+    Byte(0x50 + (r & 7));
+  }
+  void pop(Reg r) {
+    if (r & 8) Byte(0x41);
+    Byte(0x58 + (r & 7));
+  }
+  void ret() { Byte(0xC3); }
+
+  void mov(Reg dst, uint64_t imm) {
+    Rex(0, dst);
+    Byte(0xB8 + (dst & 7));
+    for (int i = 0; i < 8; ++i) Byte(static_cast<uint8_t>(imm >> (8 * i)));
+  }
+  void mov(Reg dst, Mem src) {
+    Rex(dst, src.base);
+    Byte(0x8B);
+    ModRM(dst, src);
+  }
+  void mov(Reg dst, Reg src) { RegReg(0x89, src, dst); }
+  void add(Reg dst, Reg src) { RegReg(0x01, src, dst); }
+  void add(Reg dst, int32_t imm) {
+    Rex(0, dst);
+    Byte(0x81);
+    Byte(0xC0 | (dst & 7));
+    Dword(imm);
+  }
+  void imul(Reg dst, Reg src, int32_t imm) {
+    Rex(dst, src);
+    Byte(0x69);
+    Byte(0xC0 | (dst & 7) << 3 | (src & 7));
+    Dword(imm);
+  }
+  void inc(Reg r) {
+    Rex(0, r);
+    Byte(0xFF);
+    Byte(0xC0 | (r & 7));
+  }
+  void dec(Reg r) {
+    Rex(0, r);
+    Byte(0xFF);
+    Byte(0xC8 | (r & 7));
+  }
+  /** @brief Compare a with b */
+  void cmp(Reg a, Reg b) { RegReg(0x39, b, a); }
+
+  void jnz(Label& l) { Jcc(0x85, l); }
+  void jb(Label& l) { Jcc(0x82, l); }
+  void jae(Label& l) { Jcc(0x83, l); }
+
+  void prefetchnta(Mem m) {
+    if (m.base & 8) Byte(0x41);
+    Byte(0x0F);
+    Byte(0x18);
+    ModRM(0, m);
+  }
+
+  // AVX2; y selects 256-bit registers, otherwise 128-bit
+
+  void vzeroupper() {
+    Byte(0xC5);
+    Byte(0xF8);
+    Byte(0x77);
+  }
+  void vpxor(int d, int a, int b, bool y = true) { V(1, 1, y, 0xEF, d, a, b); }
+  void vpaddd(int d, int a, int b, bool y = true) { V(1, 1, y, 0xFE, d, a, b); }
+  void vpmulld(int d, int a, int b) { V(2, 1, true, 0x40, d, a, b); }
+  void vpmaddwd(int d, int a, int b) { V(1, 1, true, 0xF5, d, a, b); }
+  void vphaddd(int d, int a, int b) { V(2, 1, true, 0x02, d, a, b); }
+  void vpackssdw(int d, int a, int b, bool y) { V(1, 1, y, 0x6B, d, a, b); }
+  void vpacksswb(int d, int a, int b, bool y) { V(1, 1, y, 0x63, d, a, b); }
+  /** @brief d = a permuted by the dword indices in idx */
+  void vpermd(int d, int idx, int a) { V(2, 1, true, 0x36, d, idx, a); }
+  void vpmovsxbd(int d, Mem m) { V(2, 1, true, 0x21, d, 0, m); }
+  void vpmovsxbd(int d, int a) { V(2, 1, true, 0x21, d, 0, a); }
+  void vpmovsxbw(int d, Mem m) { V(2, 1, true, 0x20, d, 0, m); }
+  void vpbroadcastb(int d, Mem m) { V(2, 1, false, 0x78, d, 0, m); }
+  void vextracti128(int d, int a, uint8_t imm) {
+    V(3, 1, true, 0x39, a, 0, d);
+    Byte(imm);
+  }
+  void vmovdqu(int d, Mem m) { V(1, 2, true, 0x6F, d, 0, m); }
+  void vmovdqu(Mem m, int s) { V(1, 2, true, 0x7F, s, 0, m); }
+  void vmovd(Mem m, int s) { V(1, 1, false, 0x7E, s, 0, m); }
+
+  void vcvtdq2ps(int d, int a, bool y) { V(1, 0, y, 0x5B, d, 0, a); }
+  void vcvttps2dq(int d, int a, bool y) { V(1, 2, y, 0x5B, d, 0, a); }
+  void vaddps(int d, int a, int b, bool y) { V(1, 0, y, 0x58, d, a, b); }
+  void vaddps(int d, int a, Mem m, bool y) { V(1, 0, y, 0x58, d, a, m); }
+  void vsubps(int d, int a, int b, bool y) { V(1, 0, y, 0x5C, d, a, b); }
+  void vmulps(int d, int a, Mem m, bool y) { V(1, 0, y, 0x59, d, a, m); }
+  void vdivps(int d, int a, Mem m, bool y) { V(1, 0, y, 0x5E, d, a, m); }
+  void vminps(int d, int a, Mem m, bool y) { V(1, 0, y, 0x5D, d, a, m); }
+  void vmaxps(int d, int a, Mem m, bool y) { V(1, 0, y, 0x5F, d, a, m); }
+  void vandps(int d, int a, int b, bool y) { V(1, 0, y, 0x54, d, a, b); }
+  void vandps(int d, int a, Mem m, bool y) { V(1, 0, y, 0x54, d, a, m); }
+  void vorps(int d, int a, Mem m, bool y) { V(1, 0, y, 0x56, d, a, m); }
+  void vcmpps(int d, int a, Mem m, uint8_t predicate, bool y) {
+    V(1, 0, y, 0xC2, d, a, m);
+    Byte(predicate);
+  }
+  void vroundps(int d, int a, uint8_t mode, bool y) {
+    V(3, 1, y, 0x08, d, 0, a);
+    Byte(mode);
+  }
+
+ private:
+  void Byte(uint8_t b) { code_.push_back(b); }
+  void Dword(int32_t v) {
+    for (int i = 0; i < 4; ++i) Byte(static_cast<uint8_t>(v >> (8 * i)));
+  }
+
+  /** @brief REX.W with the high bits of the reg and rm/base fields */
+  void Rex(int reg, int rm) {
+    Byte(0x48 | (reg & 8) >> 1 | (rm & 8) >> 3);
+  }
+
+  void ModRM(int reg, Mem m) {
+    Byte(0x80 | (reg & 7) << 3 | (m.base & 7));
+    if ((m.base & 7) == rsp) {
+      Byte(0x24);
+    }
+    Dword(m.disp);
+  }
+
+  /** @brief op r/m64, r64 with both operands registers */
+  void RegReg(uint8_t op, int reg, int rm) {
+    Rex(reg, rm);
+    Byte(op);
+    Byte(0xC0 | (reg & 7) << 3 | (rm & 7));
+  }
+
+  /** @brief Three-byte VEX prefix; map 1-3 is 0F, 0F38, 0F3A */
+  void Vex(int map, int pp, bool l, int reg, int vvvv, int rm) {
+    Byte(0xC4);
+    Byte((reg & 8 ? 0 : 0x80) | 0x40 | (rm & 8 ? 0 : 0x20) | map);
+    Byte((~vvvv & 15) << 3 | (l ? 4 : 0) | pp);
+  }
+
+  void V(int map, int pp, bool l, uint8_t op, int reg, int vvvv, int rm) {
+    Vex(map, pp, l, reg, vvvv, rm);
+    Byte(op);
+    Byte(0xC0 | (reg & 7) << 3 | (rm & 7));
+  }
+
+  void V(int map, int pp, bool l, uint8_t op, int reg, int vvvv, Mem m) {
+    Vex(map, pp, l, reg, vvvv, m.base);
+    Byte(op);
+    ModRM(reg, m);
+  }
+
+  void Jcc(uint8_t op, Label& l) {
+    Byte(0x0F);
+    Byte(op);
+    const size_t at = code_.size();
+    Dword(0);
+    if (l.position != SIZE_MAX) {
+      Patch(at, l.position);
+    } else {
+      l.fixups.push_back(at);
+    }
+  }
+
+  void Patch(size_t at, size_t target) {
+    const auto rel = static_cast<int32_t>(target - (at + 4));
+    std::memcpy(code_.data() + at, &rel, sizeof(rel));
+  }
+
+  std::vector<uint8_t> code_;
+};
+
+/**
+ * @brief Per-channel requantization constants
+ *
+ * The same float steps as Requantize(), split so that a kernel applies them
+ * as vector operations: (acc + bias_term) * multiplier / output_scale.
+ */
+struct RequantTable {
+  std::vector<float> bias_term;
+  std::vector<float> multiplier;
+  std::vector<float> output_scale;
+
+  /**
+   * @param bias Bias terms, empty if none
+   * @param weight_scales Weight scale of each channel
+   * @param channels Channels, padded to a whole number of groups of group
+   */
+  RequantTable(const std::vector<float>& bias,
+               const std::vector<float>& weight_scales, float input_scale,
+               float out_scale, size_t channels, size_t group) {
+    const size_t padded = (channels + group - 1) / group * group;
+    bias_term.assign(padded, 0.0f);
+    multiplier.assign(padded, 0.0f);
+    output_scale.assign(padded, 1.0f);
+    for (size_t c = 0; c < channels; ++c) {
+      const float scale = weight_scales[c] * input_scale;
+      if (!bias.empty()) {
+        bias_term[c] = bias[c] / scale;
+      }
+      multiplier[c] = scale;
+      output_scale[c] = out_scale;
+    }
+  }
+};
+
+/**
+ * @brief Generated kernel and the constants its code refers to
+ */
+class Kernel {
+ public:
+  virtual ~Kernel() = default;
+
+ protected:
+  // Shared constants, each broadcast over 32 bytes, ahead of the tables
+  static constexpr int32_t kMin = 0, kMax = 32, kHalf = 64, kOne = 96,
+                           kAbs = 128, kSign = 160, kInterleave = 192,
+                           kTables = 224;
+
+  /** @brief Fill the shared constants and reserve table space */
+  void InitConstants(size_t table_bytes) {
+    constants_.assign((kTables + table_bytes) / 4, 0);
+    const float values[] = {-128.0f, 127.0f, 0.5f, 1.0f};
+    for (int k = 0; k < 4; ++k) {
+      for (int i = 0; i < 8; ++i) {
+        std::memcpy(&constants_[k * 8 + i], &values[k], 4);
+      }
+    }
+    const uint32_t interleave[] = {0, 4, 1, 5, 2, 6, 3, 7};
+    for (int i = 0; i < 8; ++i) {
+      constants_[kAbs / 4 + i] = 0x7FFFFFFF;
+      constants_[kSign / 4 + i] = 0x80000000;
+      constants_[kInterleave / 4 + i] = interleave[i];
+    }
+  }
+
+  void SetTable(size_t offset, const float* values, size_t count) {
+    std::memcpy(&constants_[(kTables + offset) / 4], values, count * 4);
+  }
+
+  uint64_t ConstantsAddress() const {
+    return reinterpret_cast<uint64_t>(constants_.data());
+  }
+
+  /**
+   * @brief Requantize the int32 lanes of v in place
+   *
+   * Rounds half away from zero like std::round: truncate, then step away
+   * from zero where the dropped fraction is at least one half.
+   *
+   * @param shared Register holding the constants address
+   * @param table Register holding the lane's table entries
+   * @param stride Bytes between the bias, multiplier and scale entries
+   * @param t1 t2 t3 Scratch vector registers
+   */
+  static void EmitRequantize(Assembler& a, int v, int shared, int table,
+                             int32_t stride, int t1, int t2, int t3, bool y) {
+    a.vcvtdq2ps(v, v, y);
+    a.vaddps(v, v, Mem{table, 0}, y);
+    a.vmulps(v, v, Mem{table, stride}, y);
+    a.vdivps(v, v, Mem{table, 2 * stride}, y);
+    a.vmaxps(v, v, Mem{shared, kMin}, y);
+    a.vminps(v, v, Mem{shared, kMax}, y);
+    a.vroundps(t1, v, 0x0B, y);
+    a.vsubps(t2, v, t1, y);
+    a.vandps(t2, t2, Mem{shared, kAbs}, y);
+    a.vcmpps(t2, t2, Mem{shared, kHalf}, 0x0D, y);
+    a.vandps(t3, v, Mem{shared, kSign}, y);
+    a.vorps(t3, t3, Mem{shared, kOne}, y);
+    a.vandps(t3, t3, t2, y);
+    a.vaddps(t1, t1, t3, y);
+    a.vcvttps2dq(v, t1, y);
+  }
+
+  std::vector<uint32_t> constants_;
+  std::unique_ptr<CodeBuffer> code_;
+};
+
+/**
+ * @brief IndirectConv tile kernel with the requantization fused
+ *
+ * Computes one kPixels x kChannels tile over all kernel positions and input
+ * channels, both baked in as trip counts, and stores it as requantized int8
+ * [kPixels][kChannels].
+ */
+class ConvKernel : public Kernel {
+ public:
+  using Fn = void (*)(const int8_t* const* rows, const int8_t* weights,
+                      size_t block, int8_t* out);
+
+  ConvKernel(size_t positions, size_t in_channels, const RequantTable& table) {
+    constexpr int32_t kPixels = IndirectConv::kPixels;
+    constexpr int32_t kChannels = IndirectConv::kChannels;
+    const size_t blocks = table.multiplier.size() / kChannels;
+    // Per block: bias, multiplier and scale rows of kChannels floats
+    constexpr int32_t kStride = kChannels * 4;
+    InitConstants(blocks * 3 * kStride);
+    for (size_t b = 0; b < blocks; ++b) {
+      SetTable(b * 3 * kStride, &table.bias_term[b * kChannels], kChannels);
+      SetTable(b * 3 * kStride + kStride, &table.multiplier[b * kChannels],
+               kChannels);
+      SetTable(b * 3 * kStride + 2 * kStride,
+               &table.output_scale[b * kChannels], kChannels);
+    }
+
+    // Input channels per inner iteration: all of them when few, else the
+    // largest of 8, 4, 2 dividing the count
+    int32_t unroll = static_cast<int32_t>(in_channels);
+    if (in_channels > 8) {
+      unroll = in_channels % 8 == 0 ? 8 : in_channels % 4 == 0 ? 4
+               : in_channels % 2 == 0 ? 2 : 1;
+    }
+    const Reg rows[kPixels] = {r8, r9, r10, rax};
+
+    // rdi: rows, rsi: weights, rdx: block, rcx: out
+    Assembler a;
+    Assembler::Label position, channel;
+    a.push(rbx);
+    for (int m = 0; m < kPixels; ++m) {
+      a.vpxor(m, m, m);
+    }
+    a.mov(r11, static_cast<uint64_t>(positions));
+    a.Bind(position);
+    for (int m = 0; m < kPixels; ++m) {
+      a.mov(rows[m], Mem{rdi, 8 * m});
+    }
+    a.mov(rbx, static_cast<uint64_t>(in_channels / unroll));
+    a.Bind(channel);
+    for (int32_t u = 0; u < unroll; ++u) {
+      a.vpmovsxbd(4, Mem{rsi, u * kChannels});
+      for (int m = 0; m < kPixels; ++m) {
+        a.vpbroadcastb(5, Mem{rows[m], u});
+        a.vpmovsxbd(5, 5);
+        a.vpmulld(5, 5, 4);
+        a.vpaddd(m, m, 5);
+      }
+    }
+    a.add(rsi, unroll * kChannels);
+    for (int m = 0; m < kPixels; ++m) {
+      a.add(rows[m], unroll);
+    }
+    a.dec(rbx);
+    a.jnz(channel);
+    a.add(rdi, 8 * kPixels);
+    a.dec(r11);
+    a.jnz(position);
+
+    a.mov(r8, ConstantsAddress());
+    a.mov(r9, ConstantsAddress() + kTables);
+    a.imul(rax, rdx, 3 * kStride);
+    a.add(r9, rax);
+    for (int m = 0; m < kPixels; ++m) {
+      EmitRequantize(a, m, r8, r9, kStride, 5, 6, 7, true);
+    }
+    // Pack to bytes, then restore pixel-major order from the 128-bit lanes
+    a.vpackssdw(0, 0, 1, true);
+    a.vpackssdw(2, 2, 3, true);
+    a.vpacksswb(0, 0, 2, true);
+    a.vmovdqu(4, Mem{r8, kInterleave});
+    a.vpermd(0, 4, 0);
+    a.vmovdqu(Mem{rcx, 0}, 0);
+    a.vzeroupper();
+    a.pop(rbx);
+    a.ret();
+
+    code_ = std::make_unique<CodeBuffer>(a.code());
+    fn_ = code_->entry<Fn>();
+  }
+
+  /**
+   * @param rows Table entries of the tile, [position][kPixels]
+   * @param weights Packed weights of the block
+   * @param block Output channel block
+   * @param out Requantized tile [kPixels][kChannels]
+   */
+  void operator()(const int8_t* const* rows, const int8_t* weights,
+                  size_t block, int8_t* out) const {
+    fn_(rows, weights, block, out);
+  }
+
+ private:
+  Fn fn_ = nullptr;
+};
+
+/**
+ * @brief Gemv kernel over row blocks with the requantization fused
+ *
+ * The tile count of a row is baked in, and each block of kRows outputs is
+ * requantized to int8 as it completes.
+ */
+class GemvKernel : public Kernel {
+ public:
+  using Fn = void (*)(const int8_t* x, const int8_t* panels, int8_t* out,
+                      size_t begin, size_t end);
+
+  GemvKernel(size_t padded_cols, const RequantTable& table) {
+    constexpr int32_t kRows = PackedGemv::kRows;
+    constexpr int32_t kCols = PackedGemv::kCols;
+    constexpr int32_t kStride = kRows * 4;
+    constexpr int32_t kPrefetchBytes = 8 * kRows * kCols;
+    const size_t blocks = table.multiplier.size() / kRows;
+    InitConstants(blocks * 3 * kStride);
+    for (size_t b = 0; b < blocks; ++b) {
+      SetTable(b * 3 * kStride, &table.bias_term[b * kRows], kRows);
+      SetTable(b * 3 * kStride + kStride, &table.multiplier[b * kRows], kRows);
+      SetTable(b * 3 * kStride + 2 * kStride, &table.output_scale[b * kRows],
+               kRows);
+    }
+    const auto block_bytes = static_cast<int32_t>(kRows * padded_cols);
+
+    // rdi: x, rsi: panels, rdx: out, rcx: begin, r8: end
+    Assembler a;
+    Assembler::Label block, tile, done;
+    a.cmp(rcx, r8);
+    a.jae(done);
+    a.imul(rax, rcx, block_bytes);
+    a.add(rsi, rax);
+    a.imul(rax, rcx, kRows);
+    a.add(rdx, rax);
+    a.mov(r9, ConstantsAddress() + kTables);
+    a.imul(rax, rcx, 3 * kStride);
+    a.add(r9, rax);
+
+    a.Bind(block);
+    for (int r = 0; r < kRows; ++r) {
+      a.vpxor(r, r, r);
+    }
+    a.mov(r10, rdi);
+    a.mov(r11, static_cast<uint64_t>(padded_cols / kCols));
+    a.Bind(tile);
+    a.prefetchnta(Mem{rsi, kPrefetchBytes});
+    a.vpmovsxbw(4, Mem{r10, 0});
+    for (int r = 0; r < kRows; ++r) {
+      // Pairs of int8 products summed in int32 are exact
+      a.vpmovsxbw(5, Mem{rsi, r * kCols});
+      a.vpmaddwd(5, 5, 4);
+      a.vpaddd(r, r, 5);
+    }
+    a.add(rsi, kRows * kCols);
+    a.add(r10, kCols);
+    a.dec(r11);
+    a.jnz(tile);
+
+    // Row sums into the four lanes of xmm0
+    a.vphaddd(0, 0, 1);
+    a.vphaddd(2, 2, 3);
+    a.vphaddd(0, 0, 2);
+    a.vextracti128(1, 0, 1);
+    a.vpaddd(0, 0, 1, false);
+    a.mov(rax, ConstantsAddress());
+    EmitRequantize(a, 0, rax, r9, kStride, 5, 6, 7, false);
+    a.vpackssdw(0, 0, 0, false);
+    a.vpacksswb(0, 0, 0, false);
+    a.vmovd(Mem{rdx, 0}, 0);
+
+    a.add(rdx, kRows);
+    a.add(r9, 3 * kStride);
+    a.inc(rcx);
+    a.cmp(rcx, r8);
+    a.jb(block);
+    a.Bind(done);
+    a.vzeroupper();
+    a.ret();
+
+    code_ = std::make_unique<CodeBuffer>(a.code());
+    fn_ = code_->entry<Fn>();
+  }
+
+  /**
+   * @brief y = requantize(W x) for one int8 vector, split across the pool
+   * like Gemv()
+   *
+   * @param w Packed weights the kernel was generated for
+   * @param x Input, w.cols elements
+   * @param y Output, w.rows elements
+   */
+  void Run(const PackedGemv& w, const int8_t* x, int8_t* y,
+           ThreadPool* pool = &ThreadPool::Current()) const {
+    thread_local std::vector<int8_t> padded;
+    padded.assign(w.padded_cols, 0);
+    std::copy(x, x + w.cols, padded.begin());
+    // Whole blocks are stored, so the last one may spill past w.rows
+    thread_local std::vector<int8_t> out;
+    out.resize(w.blocks() * PackedGemv::kRows);
+
+    const int8_t* xp = padded.data();
+    const int8_t* panels = w.panels.data();
+    int8_t* op = out.data();
+    if (!pool || pool->size() == 1 || w.bytes() < PackedGemv::kParallelBytes) {
+      fn_(xp, panels, op, 0, w.blocks());
+    } else {
+      const size_t grain =
+          std::max<size_t>(1, w.blocks() / (4 * pool->size()));
+      pool->ParallelFor(
+          w.blocks(),
+          [&](size_t begin, size_t end) { fn_(xp, panels, op, begin, end); },
+          grain);
+    }
+    std::copy(out.begin(), out.begin() + w.rows, y);
+  }
+
+ private:
+  Fn fn_ = nullptr;
+};
+
+/**
+ * @brief Generated kernels by signature
+ *
+ * The signature is everything baked into the code: the kernel kind, its
+ * shape constants and the bytes of its requantization table. Layers with
+ * the same signature, such as the copies of a model loaded per NUMA node,
+ * share one kernel. Entries are weak, so a kernel is freed with the last
+ * layer using it.
+ */
+class Cache {
+ public:
+  static Cache& Global() {
+    static Cache cache;
+    return cache;
+  }
+
+  /**
+   * @return Kernel for the signature, generated on first use, or nullptr if
+   * generation failed
+   */
+  template <typename K, typename... Args>
+  std::shared_ptr<const K> Get(const std::string& signature, Args&&... args) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto& entry = kernels_[signature];
+    if (auto kernel = entry.lock()) {
+      hits_++;
+      return std::static_pointer_cast<const K>(kernel);
+    }
+    try {
+      auto kernel = std::make_shared<const K>(std::forward<Args>(args)...);
+      entry = kernel;
+      generated_++;
+      return kernel;
+    } catch (const std::exception&) {
+      kernels_.erase(signature);
+      return nullptr;
+    }
+  }
+
+  /** @return Kernels generated so far */
+  size_t generated() const { return generated_; }
+
+  /** @return Lookups served by an existing kernel */
+  size_t hits() const { return hits_; }
+
+ private:
+  std::mutex mutex_;
+  std::map<std::string, std::weak_ptr<const Kernel>> kernels_;
+  std::atomic<size_t> generated_{0};
+  std::atomic<size_t> hits_{0};
+};
+
+/** @brief Signature of a kernel: its kind, shape constants and table */
+inline std::string Signature(const char* kind,
+                             const std::vector<size_t>& shape,
+                             const RequantTable& table) {
+  std::string key = kind;
+  auto append = [&](const void* data, size_t bytes) {
+    key.append(static_cast<const char*>(data), bytes);
+  };
+  for (size_t v : shape) {
+    append(&v, sizeof(v));
+  }
+  for (const auto* values :
+       {&table.bias_term, &table.multiplier, &table.output_scale}) {
+    append(values->data(), values->size() * sizeof(float));
+  }
+  return key;
+}
+
+/**
+ * @return Conv tile kernel for a packed IndirectConv layer, nullptr when
+ * generated kernels are off or unavailable
+ */
+inline std::shared_ptr<const ConvKernel> GetConvKernel(
+    size_t positions, size_t in_channels, const RequantTable& table) {
+  if (!Enabled()) {
+    return nullptr;
+  }
+  return Cache::Global().Get<ConvKernel>(
+      Signature("conv", {positions, in_channels}, table), positions,
+      in_channels, table);
+}
+
+/**
+ * @return Gemv kernel for a packed Linear layer, nullptr when generated
+ * kernels are off or unavailable
+ */
+inline std::shared_ptr<const GemvKernel> GetGemvKernel(
+    size_t padded_cols, const RequantTable& table) {
+  if (!Enabled()) {
+    return nullptr;
+  }
+  return Cache::Global().Get<GemvKernel>(
+      Signature("gemv", {padded_cols}, table), padded_cols, table);
+}
+
+}  // namespace jit
+}  // namespace qnn
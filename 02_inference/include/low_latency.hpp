@@ -0,0 +1,287 @@
+/**
+ * @file low_latency.hpp
+ * @author Leo (zhsleo@outlook.com)
+ *
+ * @brief Pinned, polling inference session for latency-critical requests
+ * @version 1.0.0
+ * @date 2026-10-18
+ */
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <exception>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "model.hpp"
+#include "numa.hpp"
+#include "thread_pool.hpp"
+
+namespace qnn {
+
+/**
+ * @return CPUs the kernel keeps other tasks off (isolcpus), empty if none
+ */
+inline std::vector<int> IsolatedCpus() {
+  std::ifstream file("/sys/devices/system/cpu/isolated");
+  std::string list;
+  std::getline(file, list);
+  return numa::ParseCpuList(list);
+}
+
+/**
+ * @brief Bounded lock-free queue for many producers and consumers
+ *
+ * Each cell carries a sequence number telling whether it is free for the
+ * producer or full for the consumer at a given position, so push and pop
+ * are one compare-exchange each.
+ */
+template <typename T>
+class SpinQueue {
+ public:
+  /** @param capacity Cells, rounded up to a power of two */
+  explicit SpinQueue(size_t capacity) {
+    size_t size = 1;
+    while (size < capacity) {
+      size <<= 1;
+    }
+    cells_ = std::make_unique<Cell[]>(size);
+    mask_ = size - 1;
+    for (size_t i = 0; i < size; ++i) {
+      cells_[i].sequence.store(i, std::memory_order_relaxed);
+    }
+  }
+
+  /** @return False if the queue is full */
+  bool TryPush(T value) {
+    size_t pos = tail_.load(std::memory_order_relaxed);
+    for (;;) {
+      Cell& cell = cells_[pos & mask_];
+      const size_t seq = cell.sequence.load(std::memory_order_acquire);
+      const auto diff =
+          static_cast<std::ptrdiff_t>(seq) - static_cast<std::ptrdiff_t>(pos);
+      if (diff == 0) {
+        if (tail_.compare_exchange_weak(pos, pos + 1,
+                                        std::memory_order_relaxed)) {
+          cell.value = std::move(value);
+          cell.sequence.store(pos + 1, std::memory_order_release);
+          return true;
+        }
+      } else if (diff < 0) {
+        return false;
+      } else {
+        pos = tail_.load(std::memory_order_relaxed);
+      }
+    }
+  }
+
+  /** @return False if the queue is empty */
+  bool TryPop(T& value) {
+    size_t pos = head_.load(std::memory_order_relaxed);
+    for (;;) {
+      Cell& cell = cells_[pos & mask_];
+      const size_t seq = cell.sequence.load(std::memory_order_acquire);
+      const auto diff = static_cast<std::ptrdiff_t>(seq) -
+                        static_cast<std::ptrdiff_t>(pos + 1);
+      if (diff == 0) {
+        if (head_.compare_exchange_weak(pos, pos + 1,
+                                        std::memory_order_relaxed)) {
+          value = std::move(cell.value);
+          cell.sequence.store(pos + mask_ + 1, std::memory_order_release);
+          return true;
+        }
+      } else if (diff < 0) {
+        return false;
+      } else {
+        pos = head_.load(std::memory_order_relaxed);
+      }
+    }
+  }
+
+ private:
+  struct Cell {
+    std::atomic<size_t> sequence{0};
+    T value{};
+  };
+
+  std::unique_ptr<Cell[]> cells_;
+  size_t mask_ = 0;
+  // Producers and the consumer write different lines
+  alignas(64) std::atomic<size_t> tail_{0};
+  alignas(64) std::atomic<size_t> head_{0};
+};
+
+/**
+ * @brief Low-latency session options
+ */
+struct LowLatencyOptions {
+  /**
+   * @brief CPUs to run on: the dispatcher takes the first and each pool
+   * worker one of the others. Empty for the isolated CPUs, unpinned if
+   * there are none
+   */
+  std::vector<int> cpus;
+  /** @brief Threads running the model, including the dispatcher */
+  size_t threads = 1;
+  /** @brief How long idle threads poll before sleeping; 0 never polls */
+  double idle_us = 1000.0;
+  /** @brief Requests queued at most; Run() polls while it is full */
+  size_t capacity = 64;
+};
+
+/**
+ * @brief Runs one model on pinned threads that poll for work
+ *
+ * Callers hand requests to a dispatcher thread through a lock-free queue
+ * and poll for the result, and the dispatcher's pool workers poll for
+ * loops to run, so a request on a warm session makes no system calls.
+ * Threads that stay idle for idle_us sleep on a condition variable and are
+ * woken the usual way, so an idle session costs no CPU. Polling only pays
+ * when every thread has a core of its own; on shared cores it takes time
+ * from the thread being waited for.
+ */
+class LowLatencySession {
+ public:
+  /**
+   * @param model Model to serve; must outlive the session and not be used
+   * elsewhere meanwhile
+   * @param options Session options
+   */
+  explicit LowLatencySession(Model& model, LowLatencyOptions options = {})
+      : model_(model),
+        cpus_(options.cpus.empty() ? IsolatedCpus() : options.cpus),
+        idle_(std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+            std::chrono::duration<double, std::micro>(options.idle_us))),
+        queue_(options.capacity),
+        pool_(ThreadPool::Options{options.threads, cpus_, true,
+                                  options.idle_us}),
+        dispatcher_([this] { Dispatch(); }) {}
+
+  ~LowLatencySession() {
+    stop_ = true;
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      wake_.notify_all();
+    }
+    dispatcher_.join();
+  }
+
+  LowLatencySession(const LowLatencySession&) = delete;
+  LowLatencySession& operator=(const LowLatencySession&) = delete;
+
+  /**
+   * @brief Run one request and wait for it
+   *
+   * @param input Model input
+   * @return Model output
+   * @throws Rethrows what the model threw
+   */
+  numa::ModelOutput Run(const Tensor<float>& input) {
+    Request request;
+    request.input = &input;
+    while (!queue_.TryPush(&request)) {
+      CpuRelax();
+    }
+    // Pairs with the fence in Dispatch(): either the dispatcher sees the
+    // request before sleeping or this sees it asleep
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (dispatcher_parked_.load(std::memory_order_relaxed)) {
+      std::lock_guard<std::mutex> lock(mutex_);
+      wake_.notify_one();
+    }
+
+    auto done = [&] { return request.done.load(); };
+    if (!SpinWait(idle_, done)) {
+      std::unique_lock<std::mutex> lock(mutex_);
+      waiters_++;
+      done_.wait(lock, done);
+      waiters_--;
+    }
+    if (request.error) {
+      std::rethrow_exception(request.error);
+    }
+    return std::move(request.output);
+  }
+
+  /** @return CPUs the session is pinned to */
+  const std::vector<int>& cpus() const { return cpus_; }
+
+  /** @return Requests completed */
+  uint64_t Served() const { return served_; }
+
+  /** @return Times the dispatcher went to sleep */
+  uint64_t Parks() const { return parks_; }
+
+ private:
+  struct Request {
+    const Tensor<float>* input = nullptr;
+    numa::ModelOutput output;
+    std::exception_ptr error;
+    std::atomic<bool> done{false};
+  };
+
+  void Dispatch() {
+    if (!cpus_.empty()) {
+      ThreadPool::PinThread({cpus_[0]});
+    }
+    ThreadPool::Scope scope(pool_);
+
+    Request* request = nullptr;
+    auto ready = [&] { return queue_.TryPop(request) || stop_; };
+    for (;;) {
+      if (!SpinWait(idle_, ready)) {
+        std::unique_lock<std::mutex> lock(mutex_);
+        dispatcher_parked_ = true;
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        parks_++;
+        wake_.wait(lock, ready);
+        dispatcher_parked_ = false;
+      }
+      if (!request) {
+        return;
+      }
+
+      try {
+        request->output = model_.forward(*request->input);
+      } catch (...) {
+        request->error = std::current_exception();
+      }
+      served_++;
+      // The caller may return as soon as done is set; the request is not
+      // touched afterwards
+      request->done = true;
+      if (waiters_ > 0) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        done_.notify_all();
+      }
+      request = nullptr;
+    }
+  }
+
+  Model& model_;
+  std::vector<int> cpus_;
+  std::chrono::steady_clock::duration idle_;
+  SpinQueue<Request*> queue_;
+  ThreadPool pool_;
+
+  std::mutex mutex_;
+  std::condition_variable wake_;
+  std::condition_variable done_;
+  std::atomic<bool> dispatcher_parked_{false};
+  std::atomic<size_t> waiters_{0};
+  std::atomic<bool> stop_{false};
+  std::atomic<uint64_t> served_{0};
+  std::atomic<uint64_t> parks_{0};
+
+  std::thread dispatcher_;
+};
+
+}  // namespace qnn
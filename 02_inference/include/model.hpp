@@ -12,15 +12,36 @@
 #include <fmt/format.h>
 #include <spdlog/spdlog.h>
 
+#include <algorithm>
+#include <chrono>
 #include <fstream>
 #include <iostream>
+#include <memory>
+#include <optional>
+#include <stdexcept>
 #include <variant>
 
 #include "operator.hpp"
 #include "operator_factory.hpp"
+#include "scheduler.hpp"
+#include "systolic.hpp"
+#include "tiling.hpp"
 
 namespace qnn {
 
+/**
+ * @brief Accumulated forward time of one layer
+ */
+struct LayerProfile {
+  std::string name;
+  std::string type;
+  uint64_t calls = 0;
+  double total_us = 0.0;
+
+  /** @return Mean time per call in microseconds */
+  double mean_us() const { return calls ? total_us / calls : 0.0; }
+};
+
 /**
  * @brief Neural network model container
  *
@@ -68,6 +89,7 @@ class Model {
     }
 
     auto createOp = [&]<typename T>() {
+      if (type == "Concat") return Concat<T, T>::LoadFromJson(layer_json);
       if (type == "Conv2d") return Conv2d<T, T>::LoadFromJson(layer_json);
       if (type == "Linear") return Linear<T, T>::LoadFromJson(layer_json);
       if (type == "MaxPool2d") return MaxPool2d<T, T>::LoadFromJson(layer_json);
@@ -93,6 +115,10 @@ class Model {
    * - List of operators with their configurations
    * - Operator connections/graph structure
    * - Model metadata (optional)
+   *
+   * A layer reads the output of the previous layer unless it lists the
+   * names of its producers in "inputs", which lets branches fan out from one
+   * tensor and merge again in a Concat layer.
    */
   static Model loadModel(const std::string& filename) {
     Model model;
@@ -114,6 +140,7 @@ class Model {
 
     // Resize intermediate tensors based on number of layers
     model.intermediate_tensors_.resize(layers.size());
+    model.chains_.resize(layers.size());
 
     for (const auto& layer : layers) {
       try {
@@ -123,6 +150,7 @@ class Model {
                                  std::string(e.what()));
       }
     }
+    model.BuildGraph(layers);
 
     return model;
   }
@@ -136,7 +164,8 @@ class Model {
    *
    * This method:
    * 1. Validates input dimensions
-   * 2. Executes each operator in sequence
+   * 2. Executes each operator once its inputs are ready, independent
+   *    branches in parallel
    * 3. Stores final result in output tensor
    *
    * The input and output tensors must have compatible dimensions with
@@ -151,41 +180,424 @@ class Model {
     // Initialize input tensor
     input_tensor_ = std::move(input);
 
-    // Process each operator
+    const bool verify = SampleRequest();
+
+    // Group layers into tasks: a tileable chain runs depth-first as one
+    // task; verified requests need every intermediate tensor and run layer
+    // by layer
+    std::vector<std::pair<size_t, size_t>> tasks;
     for (size_t i = 0; i < operators_.size(); ++i) {
-      const auto& op_variant = operators_[i];
-      std::visit(
-          [&](const auto& op) {
-            using Op = std::remove_reference_t<decltype(*op)>;
-            using OpInputT = typename Op::input_type;
-            using OpOutputT = typename Op::output_type;
-
-            spdlog::debug("Layer: {} ({})", op->name, op->type);
-
-            if constexpr (std::is_same_v<OpInputT, float> &&
-                          std::is_same_v<OpOutputT, int8_t>) {
-              op->Forward(input_tensor_, intermediate_tensors_[i]);
-            } else if constexpr (std::is_same_v<OpInputT, int8_t> &&
-                                 std::is_same_v<OpOutputT, int8_t>) {
-              op->Forward(intermediate_tensors_[i - 1],
+      const size_t last = tiling_ && !verify ? ChainEnd(i) : i;
+      tasks.emplace_back(i, last);
+      i = last;
+    }
+    TaskGraph graph = BuildTasks(tasks);
+
+    auto run = [&](size_t task) {
+      const auto [first, last] = tasks[task];
+      if (last > first) {
+        RunChain(first, last);
+      } else {
+        RunLayer(first, verify);
+      }
+    };
+
+    // Branching graphs dispatch ready operators on the pool's workers; the
+    // golden model is shared, so verified requests stay on this thread
+    ThreadPool* pool =
+        branching_ && !verify ? &ThreadPool::Current() : nullptr;
+    if (!profiling_) {
+      scheduler_.Run(graph, run, pool);
+    } else {
+      std::vector<TaskSpan> timeline;
+      const auto start = std::chrono::steady_clock::now();
+      scheduler_.Run(graph, run, pool, &timeline);
+      const std::chrono::duration<double, std::micro> wall =
+          std::chrono::steady_clock::now() - start;
+      parallelism_.Merge(AnalyzeRun(graph, timeline, wall.count()));
+    }
+
+    // Return the output of the last layer
+    const size_t last = operators_.size() - 1;
+    if (std::holds_alternative<OperatorPtr<int8_t, float>>(operators_[last])) {
+      return std::variant<Tensor<float>, Tensor<int8_t>>(float_outputs_[last]);
+    }
+    return std::variant<Tensor<float>, Tensor<int8_t>>(
+        intermediate_tensors_[last]);
+  }
+
+  /**
+   * @brief Output of a layer from the last forward pass
+   *
+   * Gives access to every head of a multi-output model. Layers inside a
+   * depth-first tiled chain, other than its last, are not materialized.
+   *
+   * @param name Layer name
+   * @return Float output of a DeQuantStub, int8 output of any other layer
+   * @throws std::out_of_range If no layer has that name
+   */
+  std::variant<Tensor<float>, Tensor<int8_t>> Output(
+      const std::string& name) const {
+    const size_t i = LayerIndex(name);
+    if (std::holds_alternative<OperatorPtr<int8_t, float>>(operators_[i])) {
+      return float_outputs_[i];
+    }
+    return intermediate_tensors_[i];
+  }
+
+  /**
+   * @brief int8 result of the last forward pass
+   *
+   * The input of a final DeQuantStub, otherwise the output of the last
+   * layer. Scores can be ranked from it without dequantizing.
+   *
+   * @return Tensor whose scale() maps it back to float
+   */
+  const Tensor<int8_t>& QuantizedOutput() const {
+    const size_t last = operators_.size() - 1;
+    if (std::holds_alternative<OperatorPtr<int8_t, float>>(operators_[last])) {
+      return intermediate_tensors_[inputs_[last][0]];
+    }
+    return intermediate_tensors_[last];
+  }
+
+  /**
+   * @brief Shadow sampled requests on the systolic array golden model
+   *
+   * A sampled forward pass recomputes every Conv2d and Linear layer with the
+   * array's arithmetic and compares accumulators and int8 outputs with the
+   * CPU kernels bit for bit. Requests are sampled at a fixed stride, so the
+   * overhead is bounded by the rate.
+   *
+   * @param sample_rate Fraction of requests to verify, in [0, 1]
+   * @param spec Numeric parameters of the array
+   * @throws std::invalid_argument If the rate is out of range
+   */
+  void EnableVerification(double sample_rate, const SystolicSpec& spec = {}) {
+    if (!(sample_rate >= 0.0 && sample_rate <= 1.0)) {
+      throw std::invalid_argument("Sample rate must be in [0, 1]");
+    }
+    golden_.emplace(spec);
+    sample_rate_ = sample_rate;
+    sample_credit_ = 0.0;
+    requests_ = 0;
+    sampled_requests_ = 0;
+    verification_.assign(operators_.size(), LayerVerification{});
+  }
+
+  /** @brief Stop verifying requests; the report is kept */
+  void DisableVerification() { golden_.reset(); }
+
+  /** @return Requests run since verification was enabled */
+  uint64_t requests() const { return requests_; }
+
+  /** @return Requests that were verified */
+  uint64_t sampled_requests() const { return sampled_requests_; }
+
+  /**
+   * @brief Per-layer verification totals
+   * @return One entry per verified layer, in execution order
+   */
+  std::vector<LayerVerification> VerificationReport() const {
+    std::vector<LayerVerification> report;
+    for (const auto& layer : verification_) {
+      if (layer.samples > 0) {
+        report.push_back(layer);
+      }
+    }
+    return report;
+  }
+
+  /**
+   * @brief Time every layer of subsequent forward passes
+   *
+   * Golden-model verification is not included in the layer times.
+   *
+   * @param enable Whether to record layer times
+   */
+  void EnableProfiling(bool enable = true) {
+    profiling_ = enable;
+    if (profile_.size() != operators_.size()) {
+      profile_.assign(operators_.size(), LayerProfile{});
+    }
+  }
+
+  /**
+   * @brief Run chains of Conv2d, ReLU and MaxPool2d layers depth-first
+   *
+   * Each chain of two or more consecutive tileable layers is computed in
+   * square output tiles sized so that the tiles of all its layers fit the
+   * budget, with halos recomputed. The intermediate tensors inside a chain
+   * are not materialized, and while profiling, a chain's time is recorded
+   * on its last layer.
+   *
+   * @param cache_bytes Working-set budget per tile, 0 for half the L2 cache
+   */
+  void EnableTiling(size_t cache_bytes = 0) {
+    tiling_ = true;
+    tiling_budget_ = cache_bytes ? cache_bytes : L2CacheBytes() / 2;
+    for (auto& chain : chains_) {
+      chain.reset();
+    }
+  }
+
+  /** @brief Run every layer over the whole feature map again */
+  void DisableTiling() { tiling_ = false; }
+
+  /** @brief Clear the recorded layer times and parallelism */
+  void ResetProfile() {
+    profile_.assign(operators_.size(), LayerProfile{});
+    parallelism_ = {};
+  }
+
+  /**
+   * @brief Recorded layer times
+   * @return One entry per layer, in execution order
+   */
+  const std::vector<LayerProfile>& Profile() const { return profile_; }
+
+  /**
+   * @brief Parallelism of the profiled forward passes
+   *
+   * Compares the work of all operators with the longest dependency chain
+   * and the wall time, and records how long k operators ran at once.
+   *
+   * @return Totals over the passes run while profiling
+   */
+  const ParallelismProfile& Parallelism() const { return parallelism_; }
+
+ private:
+  /** Input index of layers that read the model input */
+  static constexpr size_t kModelInput = SIZE_MAX;
+
+  /** @return Index of the named layer */
+  size_t LayerIndex(const std::string& name) const {
+    for (size_t i = 0; i < names_.size(); ++i) {
+      if (names_[i] == name) {
+        return i;
+      }
+    }
+    throw std::out_of_range("No layer named " + name);
+  }
+
+  /**
+   * @brief Resolve the producers of every layer
+   * @throws std::runtime_error If a layer reads itself or a later layer
+   */
+  void BuildGraph(const json& layers) {
+    const size_t n = operators_.size();
+    names_.clear();
+    inputs_.assign(n, {});
+    consumers_.assign(n, 0);
+    float_outputs_.resize(n);
+    branching_ = false;
+
+    for (size_t i = 0; i < n; ++i) {
+      names_.push_back(layers[i]["name"].get<std::string>());
+      if (std::holds_alternative<OperatorPtr<float, int8_t>>(operators_[i])) {
+        inputs_[i] = {kModelInput};
+      } else if (layers[i].contains("inputs")) {
+        for (const auto& producer : layers[i]["inputs"]) {
+          const std::string name = producer.get<std::string>();
+          const auto it = std::find(names_.begin(), names_.end() - 1, name);
+          if (it == names_.end() - 1) {
+            throw std::runtime_error("Layer " + names_[i] +
+                                     " reads unknown or later layer " + name);
+          }
+          inputs_[i].push_back(it - names_.begin());
+        }
+      } else if (i > 0) {
+        inputs_[i] = {i - 1};
+      } else {
+        throw std::runtime_error("First layer must read the model input");
+      }
+    }
+
+    for (size_t i = 0; i < n; ++i) {
+      branching_ = branching_ || inputs_[i].size() > 1;
+      for (size_t producer : inputs_[i]) {
+        if (producer != kModelInput && ++consumers_[producer] > 1) {
+          branching_ = true;
+        }
+      }
+    }
+  }
+
+  /** @brief Dependencies between tasks of layer ranges [first, last] */
+  TaskGraph BuildTasks(
+      const std::vector<std::pair<size_t, size_t>>& tasks) const {
+    std::vector<size_t> task_of(operators_.size());
+    for (size_t t = 0; t < tasks.size(); ++t) {
+      for (size_t i = tasks[t].first; i <= tasks[t].second; ++i) {
+        task_of[i] = t;
+      }
+    }
+    TaskGraph graph;
+    graph.Resize(tasks.size());
+    for (size_t t = 0; t < tasks.size(); ++t) {
+      for (size_t producer : inputs_[tasks[t].first]) {
+        if (producer != kModelInput) {
+          graph.AddEdge(task_of[producer], t);
+        }
+      }
+    }
+    return graph;
+  }
+
+  /** @brief Run one layer on the outputs of its producers */
+  void RunLayer(size_t i, bool verify) {
+    std::visit(
+        [&](const auto& op) {
+          using Op = std::remove_reference_t<decltype(*op)>;
+          using OpInputT = typename Op::input_type;
+          using OpOutputT = typename Op::output_type;
+
+          spdlog::debug("Layer: {} ({})", op->name, op->type);
+
+          const auto start = profiling_
+                                 ? std::chrono::steady_clock::now()
+                                 : std::chrono::steady_clock::time_point{};
+
+          if constexpr (std::is_same_v<OpInputT, float> &&
+                        std::is_same_v<OpOutputT, int8_t>) {
+            op->Forward(input_tensor_, intermediate_tensors_[i]);
+          } else if constexpr (std::is_same_v<OpInputT, int8_t> &&
+                               std::is_same_v<OpOutputT, int8_t>) {
+            if (inputs_[i].size() == 1) {
+              op->Forward(intermediate_tensors_[inputs_[i][0]],
                           intermediate_tensors_[i]);
-            } else if constexpr (std::is_same_v<OpInputT, int8_t> &&
-                                 std::is_same_v<OpOutputT, float>) {
-              op->Forward(intermediate_tensors_[i - 1], output_tensor_);
             } else {
-              throw std::runtime_error("Unsupported operator type: " +
-                                       op->type);
+              std::vector<const Tensor<int8_t>*> inputs;
+              for (size_t producer : inputs_[i]) {
+                inputs.push_back(&intermediate_tensors_[producer]);
+              }
+              op->ForwardMulti(inputs, intermediate_tensors_[i]);
             }
-          },
-          op_variant);
+          } else if constexpr (std::is_same_v<OpInputT, int8_t> &&
+                               std::is_same_v<OpOutputT, float>) {
+            op->Forward(intermediate_tensors_[inputs_[i][0]],
+                        float_outputs_[i]);
+          } else {
+            throw std::runtime_error("Unsupported operator type: " +
+                                     op->type);
+          }
+
+          if (profiling_) {
+            RecordProfile(i, *op, start);
+          }
+          if constexpr (std::is_same_v<OpInputT, int8_t> &&
+                        std::is_same_v<OpOutputT, int8_t>) {
+            if (verify && inputs_[i].size() == 1) {
+              VerifyLayer(i, *op, intermediate_tensors_[inputs_[i][0]],
+                          intermediate_tensors_[i]);
+            }
+          }
+        },
+        operators_[i]);
+  }
+
+  /** @return Tileable int8 layer at index, or nullptr */
+  Operator<int8_t, int8_t>* Tileable(size_t index) const {
+    const auto* op =
+        std::get_if<OperatorPtr<int8_t, int8_t>>(&operators_[index]);
+    return op && (*op)->Window() ? op->get() : nullptr;
+  }
+
+  /**
+   * @brief Last layer of the tileable chain starting at first
+   * @return Index of the last layer, or first if no chain of two starts there
+   */
+  size_t ChainEnd(size_t first) const {
+    if (!Tileable(first) || inputs_[first].size() != 1 ||
+        inputs_[first][0] == kModelInput) {
+      return first;
     }
+    // Later layers must read only their predecessor, which feeds nothing else
+    size_t last = first + 1;
+    while (last < operators_.size() && Tileable(last) &&
+           inputs_[last].size() == 1 && inputs_[last][0] == last - 1 &&
+           consumers_[last - 1] == 1) {
+      last++;
+    }
+    return last >= first + 2 ? last - 1 : first;
+  }
 
-    // Return the final output
-    return std::variant<Tensor<float>, Tensor<int8_t>>(
-        std::move(output_tensor_));
+  /** @brief Run layers [first, last] depth-first, planning on shape changes */
+  void RunChain(size_t first, size_t last) {
+    const Tensor<int8_t>& input = intermediate_tensors_[inputs_[first][0]];
+    auto& chain = chains_[first];
+    if (!chain || chain->input_shape() != input.shape()) {
+      std::vector<Operator<int8_t, int8_t>*> ops;
+      for (size_t i = first; i <= last; ++i) {
+        ops.push_back(Tileable(i));
+      }
+      chain = std::make_unique<TiledChain>(std::move(ops), input.shape(),
+                                           tiling_budget_);
+      spdlog::debug("Tiled layers {}-{} with {}x{} output tiles", first, last,
+                    chain->tile(), chain->tile());
+    }
+
+    const auto start = profiling_ ? std::chrono::steady_clock::now()
+                                  : std::chrono::steady_clock::time_point{};
+    chain->Forward(input, intermediate_tensors_[last]);
+    if (profiling_) {
+      RecordProfile(last, *Tileable(last), start);
+    }
+  }
+
+  /** @brief Add the time since start to a layer's profile */
+  template <typename Op>
+  void RecordProfile(size_t index, const Op& op,
+                     std::chrono::steady_clock::time_point start) {
+    const std::chrono::duration<double, std::micro> elapsed =
+        std::chrono::steady_clock::now() - start;
+    LayerProfile& layer = profile_[index];
+    layer.name = op.name;
+    layer.type = op.type;
+    layer.calls++;
+    layer.total_us += elapsed.count();
+  }
+
+  /** @brief Decide whether the current request is verified */
+  bool SampleRequest() {
+    if (!golden_) {
+      return false;
+    }
+    requests_++;
+    sample_credit_ += sample_rate_;
+    if (sample_credit_ < 1.0) {
+      return false;
+    }
+    sample_credit_ -= 1.0;
+    sampled_requests_++;
+    return true;
+  }
+
+  /** @brief Verify one layer and add the result to its totals */
+  template <typename Op>
+  void VerifyLayer(size_t index, const Op& op, const Tensor<int8_t>& input,
+                   const Tensor<int8_t>& output) {
+    auto check = op.Verify(input, output, *golden_);
+    if (!check) {
+      return;
+    }
+
+    LayerVerification& layer = verification_[index];
+    const bool clean = layer.totals.accumulator_mismatches == 0 &&
+                       layer.totals.output_mismatches == 0;
+    layer.name = op.name;
+    layer.type = op.type;
+    layer.samples++;
+    layer.totals.Merge(*check);
+
+    if (clean && (check->accumulator_mismatches || check->output_mismatches)) {
+      spdlog::warn(
+          "Golden-model mismatch in {} ({}): {}/{} accumulators, {}/{} outputs",
+          op.name, op.type, check->accumulator_mismatches, check->elements,
+          check->output_mismatches, check->elements);
+    }
   }
 
- private:
   /** @brief Vector of operators that form the model's computation graph */
   std::vector<
       std::variant<OperatorPtr<float, int8_t>, OperatorPtr<int8_t, int8_t>,
@@ -194,8 +606,34 @@ class Model {
 
   // Tensors for input, output and intermediate results
   Tensor<float> input_tensor_;
-  Tensor<float> output_tensor_;
+  std::vector<Tensor<float>> float_outputs_;
   std::vector<Tensor<int8_t>> intermediate_tensors_;
+
+  // Graph: layer names, producers of each layer and how many layers read
+  // each output
+  std::vector<std::string> names_;
+  std::vector<std::vector<size_t>> inputs_;
+  std::vector<size_t> consumers_;
+  bool branching_ = false;
+  WorkStealingScheduler scheduler_;
+  ParallelismProfile parallelism_;
+
+  // Golden-model verification, enabled while golden_ is set
+  std::optional<SystolicModel> golden_;
+  double sample_rate_ = 0.0;
+  double sample_credit_ = 0.0;
+  uint64_t requests_ = 0;
+  uint64_t sampled_requests_ = 0;
+  std::vector<LayerVerification> verification_;
+
+  // Per-layer timing, recorded while profiling_ is set
+  bool profiling_ = false;
+  std::vector<LayerProfile> profile_;
+
+  // Depth-first execution, planned per chain start while tiling_ is set
+  bool tiling_ = false;
+  size_t tiling_budget_ = 0;
+  std::vector<std::unique_ptr<TiledChain>> chains_;
 };
 
 }  // namespace qnn
\ No newline at end of file
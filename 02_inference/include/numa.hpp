@@ -0,0 +1,340 @@
+/**
+ * @file numa.hpp
+ * @author Leo (zhsleo@outlook.com)
+ *
+ * @brief NUMA topology, memory placement and a node-local request router
+ * @version 1.0.0
+ * @date 2026-10-18
+ */
+
+#pragma once
+
+#include <linux/mempolicy.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <filesystem>
+#include <fstream>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <variant>
+#include <vector>
+
+#include "model.hpp"
+#include "thread_pool.hpp"
+
+namespace qnn::numa {
+
+/**
+ * @brief One NUMA node and the CPUs attached to it
+ */
+struct Node {
+  int id = 0;
+  std::vector<int> cpus;
+};
+
+/**
+ * @brief Parse a kernel CPU list such as "0-3,8-11"
+ */
+inline std::vector<int> ParseCpuList(const std::string& text) {
+  std::vector<int> cpus;
+  std::stringstream ss(text);
+  std::string range;
+  while (std::getline(ss, range, ',')) {
+    if (range.empty() || range == "\n") {
+      continue;
+    }
+    const size_t dash = range.find('-');
+    const int first = std::stoi(range.substr(0, dash));
+    const int last =
+        dash == std::string::npos ? first : std::stoi(range.substr(dash + 1));
+    for (int cpu = first; cpu <= last; ++cpu) {
+      cpus.push_back(cpu);
+    }
+  }
+  return cpus;
+}
+
+/**
+ * @brief Nodes that have CPUs, from sysfs
+ * @return One node holding every CPU if the system reports no topology
+ */
+inline std::vector<Node> Nodes() {
+  namespace fs = std::filesystem;
+  std::vector<Node> nodes;
+  const fs::path root = "/sys/devices/system/node";
+  std::error_code ec;
+  for (const auto& entry : fs::directory_iterator(root, ec)) {
+    const std::string name = entry.path().filename().string();
+    if (name.rfind("node", 0) != 0 ||
+        name.find_first_not_of("0123456789", 4) != std::string::npos) {
+      continue;
+    }
+    std::ifstream file(entry.path() / "cpulist");
+    std::string list;
+    std::getline(file, list);
+    Node node;
+    node.id = std::stoi(name.substr(4));
+    node.cpus = ParseCpuList(list);
+    if (!node.cpus.empty()) {
+      nodes.push_back(std::move(node));
+    }
+  }
+  std::sort(nodes.begin(), nodes.end(),
+            [](const Node& a, const Node& b) { return a.id < b.id; });
+
+  if (nodes.empty()) {
+    Node node;
+    const unsigned cpus = std::max(1u, std::thread::hardware_concurrency());
+    for (unsigned cpu = 0; cpu < cpus; ++cpu) {
+      node.cpus.push_back(static_cast<int>(cpu));
+    }
+    nodes.push_back(std::move(node));
+  }
+  return nodes;
+}
+
+/**
+ * @brief Set the calling thread's page placement policy
+ *
+ * Interleaving spreads new pages round-robin over the nodes; otherwise
+ * pages land on the node of the thread that first touches them.
+ *
+ * @param nodes Nodes to interleave over, empty for first touch
+ * @return False if the kernel rejected the policy
+ */
+inline bool SetInterleave(const std::vector<Node>& nodes) {
+  if (nodes.empty()) {
+    return syscall(SYS_set_mempolicy, MPOL_DEFAULT, nullptr, 0) == 0;
+  }
+  constexpr size_t kBits = 8 * sizeof(unsigned long);
+  std::vector<unsigned long> mask;
+  for (const auto& node : nodes) {
+    const size_t word = static_cast<size_t>(node.id) / kBits;
+    if (mask.size() <= word) {
+      mask.resize(word + 1, 0);
+    }
+    mask[word] |= 1ul << (node.id % kBits);
+  }
+  return syscall(SYS_set_mempolicy, MPOL_INTERLEAVE, mask.data(),
+                 mask.size() * kBits + 1) == 0;
+}
+
+/**
+ * @brief Where the router puts threads and memory
+ */
+enum class Placement {
+  /** @brief Threads float, pages interleaved over all nodes */
+  kInterleaved,
+  /** @brief Threads pinned to their node, pages placed by first touch */
+  kNodeLocal,
+};
+
+/**
+ * @brief Router configuration
+ */
+struct RouterOptions {
+  Placement placement = Placement::kNodeLocal;
+
+  /** @brief Load each node's weights on that node, else all on the first */
+  bool replicate_weights = true;
+
+  /** @brief Threads per node including the dispatcher, 0 for its CPUs */
+  size_t threads_per_node = 0;
+};
+
+using ModelOutput = std::variant<Tensor<float>, Tensor<int8_t>>;
+
+/**
+ * @brief Serves requests on per-node sessions so each stays on one node
+ *
+ * Every node gets a session: a model, a thread pool and a dispatcher thread
+ * that runs whole requests with that pool installed. A request goes to the
+ * node with the fewest outstanding requests, and every kernel, weight read
+ * and activation of it then stays on that node.
+ *
+ * A session's activations are its model's intermediate tensors. They are
+ * allocated by its first request on the dispatcher, so first touch places
+ * them on the node. Weights are placed by the thread that loads the model.
+ */
+class NodeRouter {
+ public:
+  /**
+   * @brief Load the sessions and start the dispatchers
+   *
+   * @param model_path Model JSON
+   * @param options Placement options
+   * @param nodes Nodes to serve on, all nodes if empty
+   * @throws std::runtime_error If a model fails to load
+   */
+  explicit NodeRouter(const std::string& model_path, RouterOptions options = {},
+                      std::vector<Node> nodes = {})
+      : options_(options), nodes_(nodes.empty() ? Nodes() : std::move(nodes)) {
+    const bool local = options_.placement == Placement::kNodeLocal;
+    for (size_t i = 0; i < nodes_.size(); ++i) {
+      auto site = std::make_unique<Site>();
+      const Node& home = options_.replicate_weights ? nodes_[i] : nodes_[0];
+      site->model = std::make_unique<Model>(LoadOn(model_path, home));
+      const size_t threads = options_.threads_per_node
+                                 ? options_.threads_per_node
+                                 : nodes_[i].cpus.size();
+      site->pool = std::make_unique<ThreadPool>(
+          threads, local ? nodes_[i].cpus : std::vector<int>{});
+      sites_.push_back(std::move(site));
+    }
+    for (size_t i = 0; i < sites_.size(); ++i) {
+      sites_[i]->dispatcher = std::thread([this, i] { Dispatch(i); });
+    }
+  }
+
+  ~NodeRouter() {
+    for (auto& site : sites_) {
+      {
+        std::lock_guard<std::mutex> lock(site->mutex);
+        site->stop = true;
+      }
+      site->wake.notify_all();
+      site->dispatcher.join();
+    }
+  }
+
+  NodeRouter(const NodeRouter&) = delete;
+  NodeRouter& operator=(const NodeRouter&) = delete;
+
+  /** @return Nodes served */
+  const std::vector<Node>& nodes() const { return nodes_; }
+
+  /**
+   * @brief Queue a request on the least loaded node
+   * @return Output of the model, or the exception it threw
+   */
+  std::future<ModelOutput> Submit(Tensor<float> input) {
+    const size_t start = next_.fetch_add(1) % sites_.size();
+    size_t best = start;
+    for (size_t k = 1; k < sites_.size(); ++k) {
+      const size_t i = (start + k) % sites_.size();
+      if (sites_[i]->outstanding < sites_[best]->outstanding) {
+        best = i;
+      }
+    }
+
+    Site& site = *sites_[best];
+    Request request{std::move(input), {}};
+    auto result = request.result.get_future();
+    site.outstanding++;
+    {
+      std::lock_guard<std::mutex> lock(site.mutex);
+      site.queue.push_back(std::move(request));
+    }
+    site.wake.notify_one();
+    return result;
+  }
+
+  /** @return Requests completed by each node */
+  std::vector<uint64_t> Served() const {
+    std::vector<uint64_t> served;
+    for (const auto& site : sites_) {
+      served.push_back(site->served);
+    }
+    return served;
+  }
+
+ private:
+  struct Request {
+    Tensor<float> input;
+    std::promise<ModelOutput> result;
+  };
+
+  struct Site {
+    std::unique_ptr<Model> model;
+    std::unique_ptr<ThreadPool> pool;
+    std::thread dispatcher;
+    std::mutex mutex;
+    std::condition_variable wake;
+    std::deque<Request> queue;
+    std::atomic<size_t> outstanding{0};
+    std::atomic<uint64_t> served{0};
+    bool stop = false;
+  };
+
+  /** @brief Apply the placement to the calling thread */
+  void Place(const Node& node) const {
+    if (options_.placement == Placement::kNodeLocal) {
+      ThreadPool::PinThread(node.cpus);
+    } else {
+      SetInterleave(nodes_);
+    }
+  }
+
+  /** @brief Load a model on a thread placed on a node */
+  Model LoadOn(const std::string& model_path, const Node& node) const {
+    std::optional<Model> model;
+    std::exception_ptr error;
+    std::thread loader([&] {
+      Place(node);
+      try {
+        model.emplace(Model::loadModel(model_path));
+      } catch (...) {
+        error = std::current_exception();
+      }
+    });
+    loader.join();
+    if (error) {
+      std::rethrow_exception(error);
+    }
+    return std::move(*model);
+  }
+
+  /** @brief Run the requests of one node until the router stops */
+  void Dispatch(size_t index) {
+    Site& site = *sites_[index];
+    Place(nodes_[index]);
+    ThreadPool::Scope scope(*site.pool);
+
+    for (;;) {
+      Request request;
+      {
+        std::unique_lock<std::mutex> lock(site.mutex);
+        site.wake.wait(lock, [&] { return site.stop || !site.queue.empty(); });
+        if (site.queue.empty()) {
+          return;
+        }
+        request = std::move(site.queue.front());
+        site.queue.pop_front();
+      }
+
+      std::optional<ModelOutput> output;
+      std::exception_ptr error;
+      try {
+        output = site.model->forward(request.input);
+      } catch (...) {
+        error = std::current_exception();
+      }
+      // Count the request before its client can see the result
+      site.served++;
+      site.outstanding--;
+      if (error) {
+        request.result.set_exception(error);
+      } else {
+        request.result.set_value(std::move(*output));
+      }
+    }
+  }
+
+  RouterOptions options_;
+  std::vector<Node> nodes_;
+  std::vector<std::unique_ptr<Site>> sites_;
+  std::atomic<size_t> next_{0};
+};
+
+}  // namespace qnn::numa
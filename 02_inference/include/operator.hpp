@@ -9,12 +9,17 @@
 
 #pragma once
 
+#include <algorithm>
+#include <cmath>
 #include <functional>
 #include <memory>
 #include <nlohmann/json.hpp>
+#include <optional>
+#include <stdexcept>
 #include <string>
 #include <vector>
 
+#include "systolic.hpp"
 #include "tensor.hpp"
 
 namespace qnn {
@@ -140,6 +145,57 @@ class WeightInfo {
   int axis_{0};
 };
 
+/**
+ * @brief Requantize an int8 GEMM accumulator to an int8 output
+ *
+ * Shared by the CPU kernels and the golden-model check so both apply the
+ * same floating-point steps to an accumulator.
+ *
+ * @param acc Accumulator (sum of int8 products)
+ * @param bias Bias terms, empty if none
+ * @param channel Output channel of the element
+ * @param weight_scale Weight scale of the channel
+ * @param input_scale Input tensor scale
+ * @param output_scale Output tensor scale
+ * @return Rounded and clamped output
+ */
+inline int8_t Requantize(float acc, const std::vector<float>& bias,
+                         size_t channel, float weight_scale, float input_scale,
+                         float output_scale) {
+  if (!bias.empty()) {
+    acc += bias[channel] / (weight_scale * input_scale);
+  }
+
+  // Apply output scale
+  acc = acc * (weight_scale * input_scale) / output_scale;
+
+  // Clamp the result to the int8 range
+  acc = std::min(std::max(acc, -128.0f), 127.0f);
+  return static_cast<int8_t>(std::round(acc));
+}
+
+/**
+ * @brief Spatial footprint of an operator that can run on output tiles
+ */
+struct SpatialWindow {
+  size_t kernel = 1;
+  size_t stride = 1;
+  size_t padding = 0;
+
+  /** @brief Output channels, 0 to keep the input's */
+  size_t channels = 0;
+};
+
+/**
+ * @brief Rectangle of a feature map, in full-map coordinates
+ */
+struct TileRegion {
+  size_t y0 = 0;
+  size_t x0 = 0;
+  size_t height = 0;
+  size_t width = 0;
+};
+
 /**
  * @brief Base class for all neural network operators
  *
@@ -161,6 +217,94 @@ class Operator {
   virtual void Forward(const Tensor<InputT>& input,
                        Tensor<OutputT>& output) = 0;
 
+  /**
+   * @brief Forward computation over the outputs of several layers
+   *
+   * Operators that merge branches override this; the default accepts one
+   * input and calls Forward.
+   *
+   * @param inputs Input tensors, in the order the layer lists them
+   * @param output Output tensor where results will be stored
+   * @throws std::runtime_error If the operator takes one input and gets more
+   */
+  virtual void ForwardMulti(const std::vector<const Tensor<InputT>*>& inputs,
+                            Tensor<OutputT>& output) {
+    if (inputs.size() != 1) {
+      throw std::runtime_error(type + " takes exactly one input");
+    }
+    Forward(*inputs[0], output);
+  }
+
+  /**
+   * @brief Recompute an output on the systolic array golden model
+   *
+   * @param input Input the operator was run on
+   * @param output Output the CPU kernel produced
+   * @param model Golden model of the array
+   * @return Comparison, or std::nullopt if the operator does not map to the
+   * array
+   */
+  virtual std::optional<LayerCheck> Verify(const Tensor<InputT>& input,
+                                           const Tensor<OutputT>& output,
+                                           const SystolicModel& model) const {
+    (void)input;
+    (void)output;
+    (void)model;
+    return std::nullopt;
+  }
+
+  /**
+   * @brief Footprint for depth-first tiled execution
+   * @return Window, or std::nullopt if the operator cannot run on tiles
+   */
+  virtual std::optional<SpatialWindow> Window() const { return std::nullopt; }
+
+  /**
+   * @brief Compute one output tile from the input tile it depends on
+   *
+   * The default runs Forward on the tile, which is exact for operators
+   * without padding when the input tile is precisely the footprint of out.
+   *
+   * @param input Input rows and columns of in, [N, C, in.height, in.width]
+   * @param in Region of the input map held by input
+   * @param image_height Height of the full input map
+   * @param image_width Width of the full input map
+   * @param out Region of the output map to compute
+   * @param output Output tile, [N, C_out, out.height, out.width]
+   */
+  virtual void ForwardTile(const Tensor<InputT>& input, const TileRegion& in,
+                           size_t image_height, size_t image_width,
+                           const TileRegion& out, Tensor<OutputT>& output) {
+    (void)in;
+    (void)image_height;
+    (void)image_width;
+    (void)out;
+    Forward(input, output);
+  }
+
+  /**
+   * @brief Compute output channels [begin, end) into a whole-layer output
+   *
+   * Lets another device compute the other channels of the same output
+   * meanwhile: only the selected channels are written, at their place in
+   * the channel-major output [N, C_out, ...] that Forward would produce,
+   * scaled by the layer's output scale.
+   *
+   * @param input Input tensor
+   * @param output Output buffer sized for the whole layer
+   * @param begin First output channel
+   * @param end One past the last output channel
+   * @throws std::runtime_error If the operator cannot split its channels
+   */
+  virtual void ForwardChannels(const Tensor<InputT>& input, OutputT* output,
+                               size_t begin, size_t end) {
+    (void)input;
+    (void)output;
+    (void)begin;
+    (void)end;
+    throw std::runtime_error(type + " cannot compute a channel range");
+  }
+
   /** @brief Name identifier of the operator */
   std::string name;
 
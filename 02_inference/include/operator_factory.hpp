@@ -9,6 +9,7 @@
 
 #pragma once
 
+#include "operators/concat.hpp"
 #include "operators/conv2d.hpp"
 #include "operators/dequant_stub.hpp"
 #include "operators/linear.hpp"
@@ -0,0 +1,114 @@
+/**
+ * @file concat.hpp
+ * @author Leo (zhsleo@outlook.com)
+ *
+ * @brief Concatenation operator
+ * @version 1.0.0
+ * @date 2026-10-18
+ */
+
+#pragma once
+#include "operator.hpp"
+
+namespace qnn {
+
+/**
+ * @brief Concatenation of the outputs of several branches along channels
+ *
+ * Inputs must agree on every dimension except dim 1. An input whose scale
+ * differs from the output scale is requantized while it is copied.
+ *
+ * @tparam InputT Data type of the input tensor elements (e.g., int8_t)
+ * @tparam OutputT Data type of the output tensor elements (e.g., int8_t)
+ */
+template <typename InputT, typename OutputT>
+class Concat : public Operator<InputT, OutputT> {
+ public:
+  /**
+   * @brief Creates Concat operator from JSON configuration
+   *
+   * @param j JSON object containing operator parameters
+   * @return Unique pointer to created operator
+   * @throws std::runtime_error If dim is not 1
+   */
+  static OperatorPtr<InputT, OutputT> LoadFromJson(const json& j) {
+    auto op = std::make_unique<Concat<InputT, OutputT>>();
+    op->name = j["name"].get<std::string>();
+    op->type = "Concat";
+    if (j.value("dim", 1) != 1) {
+      throw std::runtime_error("Concat supports dim 1 only");
+    }
+
+    // Without a scale the output takes the first input's
+    if (j.contains("scale")) {
+      op->scale_ = j["scale"].get<float>();
+    }
+    return op;
+  }
+
+  /**
+   * @brief Concatenation of a single input, which is a copy
+   */
+  void Forward(const Tensor<InputT>& input, Tensor<OutputT>& output) override {
+    ForwardMulti({&input}, output);
+  }
+
+  /**
+   * @brief Concatenates the inputs along dim 1
+   *
+   * @param inputs Input tensors [N, C_i, ...]
+   * @param output Output tensor [N, sum of C_i, ...]
+   * @throws std::runtime_error If the other dimensions differ
+   */
+  void ForwardMulti(const std::vector<const Tensor<InputT>*>& inputs,
+                    Tensor<OutputT>& output) override {
+    if (inputs.empty()) {
+      throw std::runtime_error("Concat needs at least one input");
+    }
+    std::vector<size_t> out_shape = inputs[0]->shape();
+    if (out_shape.size() < 2) {
+      throw std::runtime_error("Concat input must have a channel dimension");
+    }
+    out_shape[1] = 0;
+    for (const auto* input : inputs) {
+      const auto& shape = input->shape();
+      for (size_t d = 0; d < shape.size(); ++d) {
+        if (d != 1 && (shape.size() != out_shape.size() ||
+                       shape[d] != out_shape[d])) {
+          throw std::runtime_error("Concat inputs differ outside dim 1");
+        }
+      }
+      out_shape[1] += shape[1];
+    }
+
+    output.resize(out_shape);
+    output.set_scale(scale_ > 0.0f ? scale_ : inputs[0]->scale());
+
+    // Copy every input's slab of each batch element in turn
+    const size_t batch = out_shape[0];
+    const size_t out_slab = output.size() / batch;
+    size_t offset = 0;
+    for (const auto* input : inputs) {
+      const size_t slab = input->size() / batch;
+      const float ratio = input->scale() / output.scale();
+      for (size_t n = 0; n < batch; ++n) {
+        const InputT* src = input->data() + n * slab;
+        OutputT* dst = output.data() + n * out_slab + offset;
+        if (ratio == 1.0f) {
+          std::copy(src, src + slab, dst);
+          continue;
+        }
+        for (size_t i = 0; i < slab; ++i) {
+          float q = std::round(src[i] * ratio);
+          dst[i] = static_cast<OutputT>(std::min(std::max(q, -128.0f), 127.0f));
+        }
+      }
+      offset += slab;
+    }
+  }
+
+ private:
+  /** @brief Output scale, 0 to take the first input's */
+  float scale_ = 0.0f;
+};
+}  // namespace qnn
@@ -8,6 +8,8 @@
  */
 
 #pragma once
+#include "indirect_conv.hpp"
+#include "jit.hpp"
 #include "operator.hpp"
 #include "operators/padding.hpp"
 
@@ -47,6 +49,9 @@ class Conv2d : public Operator<InputT, OutputT> {
     // Parse weights and bias
     if (j.contains("weight")) {
       op->weight_ = WeightInfo::LoadFromJson(j["weight"]);
+      op->conv_ = IndirectConv(op->weight_.values().data(), op->out_channels_,
+                               op->in_channels_, op->kernel_size_,
+                               op->stride_, op->padding_);
     }
 
     // Parse bias
@@ -77,27 +82,10 @@ class Conv2d : public Operator<InputT, OutputT> {
       throw std::runtime_error("Input tensor must be 4D [N,C,H,W]");
     }
 
-    // Create and setup padding operator if padding is needed
-    Tensor<InputT> padded_input;
-    padded_input.set_scale(input.scale());
-
-    if (padding_ > 0) {
-      auto padding_op = std::make_unique<Padding<InputT, InputT>>();
-      padding_op->set_pad_height(padding_);
-      padding_op->set_pad_width(padding_);
-      padding_op->set_pad_value(0);
-      padding_op->Forward(input, padded_input);
-    } else {
-      padded_input = input;
-    }
-
-    // Get dimensions after padding
-    const auto& padded_shape = padded_input.shape();
-    size_t batch = padded_shape[0];
-    size_t in_height = padded_shape[2];
-    size_t in_width = padded_shape[3];
-    size_t out_height = (in_height - kernel_size_) / stride_ + 1;
-    size_t out_width = (in_width - kernel_size_) / stride_ + 1;
+    // Output size as if the input were padded
+    size_t batch = in_shape[0];
+    size_t out_height = conv_.out_size(in_shape[2]);
+    size_t out_width = conv_.out_size(in_shape[3]);
 
     // Convert to vector for resize
     std::vector<size_t> out_shape = {batch, static_cast<size_t>(out_channels_),
@@ -120,55 +108,252 @@ class Conv2d : public Operator<InputT, OutputT> {
     spdlog::debug("--------------------------------");
 #endif
 
-    // Perform convolution on padded input
+    // Convolve the whole map as one tile; padding reads a zero row
+    const TileRegion in{0, 0, in_shape[2], in_shape[3]};
+    const TileRegion out{0, 0, out_height, out_width};
+    ForwardTile(input, in, in_shape[2], in_shape[3], out, output);
+  }
+
+  /** @return Convolution window for tiled execution */
+  std::optional<SpatialWindow> Window() const override {
+    SpatialWindow window;
+    window.kernel = kernel_size_;
+    window.stride = stride_;
+    window.padding = padding_;
+    window.channels = out_channels_;
+    return window;
+  }
+
+  /**
+   * @brief Convolve one output tile; borders of the image read zeros
+   *
+   * @param input Input rows and columns of in
+   * @param in Region of the input map held by input
+   * @param image_height Height of the full input map
+   * @param image_width Width of the full input map
+   * @param out Region of the output map to compute
+   * @param output Output tile [N, out_channels_, out.height, out.width]
+   */
+  void ForwardTile(const Tensor<InputT>& input, const TileRegion& in,
+                   size_t image_height, size_t image_width,
+                   const TileRegion& out, Tensor<OutputT>& output) override {
+    const size_t batch = input.shape()[0];
+    output.resize(std::vector<size_t>{
+        batch, static_cast<size_t>(out_channels_), out.height, out.width});
+    output.set_scale(scale_);
+
+    IndirectConv::Region region;
+    region.batch = batch;
+    region.in_y0 = in.y0;
+    region.in_x0 = in.x0;
+    region.in_height = in.height;
+    region.in_width = in.width;
+    region.image_height = image_height;
+    region.image_width = image_width;
+    region.out_y0 = out.y0;
+    region.out_x0 = out.x0;
+    region.out_height = out.height;
+    region.out_width = out.width;
+    Convolve(input, region, 0, out_channels_, output.data());
+  }
+
+  /**
+   * @brief Compute output channels [begin, end) of the whole map
+   *
+   * Runs the same kernels as Forward on the weight blocks of the range only.
+   *
+   * @param input Input tensor of shape [N, C, H, W]
+   * @param output Output [N, out_channels_, H_out, W_out]
+   * @param begin First output channel
+   * @param end One past the last output channel
+   * @throws std::runtime_error If the input is not 4D or the range is invalid
+   */
+  void ForwardChannels(const Tensor<InputT>& input, OutputT* output,
+                       size_t begin, size_t end) override {
+    const auto& in_shape = input.shape();
+    if (in_shape.size() != 4) {
+      throw std::runtime_error("Input tensor must be 4D [N,C,H,W]");
+    }
+    if (begin > end || end > static_cast<size_t>(out_channels_)) {
+      throw std::runtime_error("Output channel range out of bounds");
+    }
+
+    IndirectConv::Region region;
+    region.batch = in_shape[0];
+    region.in_height = region.image_height = in_shape[2];
+    region.in_width = region.image_width = in_shape[3];
+    region.out_height = conv_.out_size(in_shape[2]);
+    region.out_width = conv_.out_size(in_shape[3]);
+    Convolve(input, region, begin, end, output);
+  }
+
+  /**
+   * @brief Recompute the output with the dot products on the golden model
+   *
+   * Each output pixel is the dot product of an im2col patch with one filter,
+   * as the convolution is lowered onto the array.
+   *
+   * @param input Input tensor the layer was run on
+   * @param output Output tensor of Forward
+   * @param model Golden model of the systolic array
+   * @return Accumulator and output comparison
+   */
+  std::optional<LayerCheck> Verify(const Tensor<InputT>& input,
+                                   const Tensor<OutputT>& output,
+                                   const SystolicModel& model) const override {
+    Tensor<InputT> padded_input = Pad(input);
+    const auto& padded_shape = padded_input.shape();
+    const size_t batch = padded_shape[0];
+    const size_t in_height = padded_shape[2];
+    const size_t in_width = padded_shape[3];
+    const size_t out_height = output.shape()[2];
+    const size_t out_width = output.shape()[3];
+    const size_t patch_size = in_channels_ * kernel_size_ * kernel_size_;
+
+    LayerCheck check;
+    std::vector<int8_t> patch(patch_size);
     for (size_t n = 0; n < batch; n++) {
-      for (size_t oc = 0; oc < static_cast<size_t>(out_channels_); oc++) {
-        for (size_t oh = 0; oh < out_height; oh++) {
-          for (size_t ow = 0; ow < out_width; ow++) {
-            float acc = 0.0f;
-
-            for (size_t ic = 0; ic < static_cast<size_t>(in_channels_); ic++) {
-              for (size_t kh = 0; kh < kernel_size_; kh++) {
-                for (size_t kw = 0; kw < kernel_size_; kw++) {
-                  size_t ih = oh * stride_ + kh;
-                  size_t iw = ow * stride_ + kw;
-
-                  size_t in_idx =
-                      ((n * in_channels_ + ic) * in_height + ih) * in_width +
-                      iw;
-                  size_t weight_idx =
-                      ((oc * in_channels_ + ic) * kernel_size_ + kh) *
-                          kernel_size_ +
-                      kw;
-
-                  acc += static_cast<float>(padded_input.data()[in_idx]) *
-                         static_cast<float>(weight_.values()[weight_idx]);
-                }
+      for (size_t oh = 0; oh < out_height; oh++) {
+        for (size_t ow = 0; ow < out_width; ow++) {
+          // Gather the patch in weight order
+          size_t p = 0;
+          for (size_t ic = 0; ic < static_cast<size_t>(in_channels_); ic++) {
+            for (size_t kh = 0; kh < static_cast<size_t>(kernel_size_); kh++) {
+              for (size_t kw = 0; kw < static_cast<size_t>(kernel_size_);
+                   kw++) {
+                size_t ih = oh * stride_ + kh;
+                size_t iw = ow * stride_ + kw;
+                patch[p++] = padded_input.data()
+                    [((n * in_channels_ + ic) * in_height + ih) * in_width +
+                     iw];
               }
             }
+          }
 
-            if (!bias_.empty()) {
-              acc += bias_[oc] / (weight_.scales()[oc] * padded_input.scale());
+          for (size_t oc = 0; oc < static_cast<size_t>(out_channels_); oc++) {
+            const int8_t* w = weight_.values().data() + oc * patch_size;
+            int64_t exact = 0;
+            for (size_t i = 0; i < patch_size; i++) {
+              exact += int64_t{patch[i]} * w[i];
             }
-
-            // Apply output scale
-            acc = acc * (weight_.scales()[oc] * padded_input.scale()) /
-                  output.scale();
-
-            // Clamp the result to the int8 range
-            acc = std::min(std::max(acc, -128.0f), 127.0f);
-
-            // Store the result
+            const int64_t golden = model.Dot(patch.data(), w, patch_size);
+            const int8_t golden_output = Requantize(
+                static_cast<float>(golden), bias_, oc, weight_.scales()[oc],
+                padded_input.scale(), output.scale());
             size_t out_idx =
                 ((n * out_channels_ + oc) * out_height + oh) * out_width + ow;
-            output.data()[out_idx] = static_cast<int8_t>(std::round(acc));
+            check.Add(exact, golden, output.data()[out_idx], golden_output);
           }
         }
       }
     }
+    return check;
   }
 
  private:
+  /**
+   * @brief Convolve a region for output channels [begin, end)
+   *
+   * @param input Input rows and columns of the region
+   * @param region Input tile and output region
+   * @param begin First output channel
+   * @param end One past the last output channel
+   * @param output Output [N, out_channels_, out_height, out_width]
+   */
+  void Convolve(const Tensor<InputT>& input,
+                const IndirectConv::Region& region, size_t begin, size_t end,
+                OutputT* output) {
+    const size_t pixels = region.out_height * region.out_width;
+    if (const auto kernel = JitKernel(input.scale(), scale_)) {
+      // Generated tiles arrive requantized; only the scatter is left
+      constexpr size_t kPixels = IndirectConv::kPixels;
+      constexpr size_t kChannels = IndirectConv::kChannels;
+      const size_t first = begin / kChannels;
+      const size_t last = (end + kChannels - 1) / kChannels;
+      conv_.ForEachTile(
+          input.data(), region,
+          [&](size_t n, size_t pixel, const int8_t* const* rows) {
+            for (size_t block = first; block < last; ++block) {
+              int8_t tile[kPixels][kChannels];
+              (*kernel)(rows, conv_.weights(block), block, &tile[0][0]);
+              for (size_t m = 0; m < kPixels && pixel + m < pixels; ++m) {
+                for (size_t c = 0; c < kChannels; ++c) {
+                  const size_t oc = block * kChannels + c;
+                  if (oc >= begin && oc < end) {
+                    output[(n * out_channels_ + oc) * pixels + pixel + m] =
+                        tile[m][c];
+                  }
+                }
+              }
+            }
+          });
+      return;
+    }
+    conv_.RunChannels(input.data(), region, begin, end,
+                      [&](size_t n, size_t oc, size_t pixel, int32_t acc) {
+                        output[(n * out_channels_ + oc) * pixels + pixel] =
+                            Requantize(static_cast<float>(acc), bias_, oc,
+                                       weight_.scales()[oc], input.scale(),
+                                       scale_);
+                      });
+  }
+
+  /**
+   * @brief Generated kernel for the scales of this run
+   *
+   * Generated on the first int8 run, once the input scale is known, and
+   * again only if a scale changes. The caller holds a reference, so a run
+   * with other scales on another thread cannot free it meanwhile.
+   *
+   * @return nullptr to use the precompiled kernel
+   */
+  std::shared_ptr<const jit::ConvKernel> JitKernel(float input_scale,
+                                                   float output_scale) {
+    if constexpr (std::is_same_v<InputT, int8_t> &&
+                  std::is_same_v<OutputT, int8_t>) {
+      if (!jit::Enabled()) {
+        return nullptr;
+      }
+      std::lock_guard<std::mutex> lock(jit_mutex_);
+      if (!jit_ || jit_scales_[0] != input_scale ||
+          jit_scales_[1] != output_scale) {
+        jit::RequantTable table(bias_, weight_.scales(), input_scale,
+                                output_scale, out_channels_,
+                                IndirectConv::kChannels);
+        jit_ = jit::GetConvKernel(conv_.positions(), conv_.in_channels(),
+                                  table);
+        jit_scales_[0] = input_scale;
+        jit_scales_[1] = output_scale;
+      }
+      return jit_;
+    } else {
+      (void)input_scale;
+      (void)output_scale;
+      return nullptr;
+    }
+  }
+
+  /**
+   * @brief Zero-pad the input by padding_ on each spatial border
+   * @param input Input tensor
+   * @return Padded copy of the input, or the input if padding_ is zero
+   */
+  Tensor<InputT> Pad(const Tensor<InputT>& input) const {
+    Tensor<InputT> padded_input;
+    padded_input.set_scale(input.scale());
+
+    if (padding_ > 0) {
+      auto padding_op = std::make_unique<Padding<InputT, InputT>>();
+      padding_op->set_pad_height(padding_);
+      padding_op->set_pad_width(padding_);
+      padding_op->set_pad_value(0);
+      padding_op->Forward(input, padded_input);
+    } else {
+      padded_input = input;
+    }
+    return padded_input;
+  }
+
   /** @brief Number of input channels */
   int in_channels_;
 
@@ -187,6 +372,14 @@ class Conv2d : public Operator<InputT, OutputT> {
   /** @brief Convolution weights */
   WeightInfo weight_;
 
+  /** @brief Packed weights and indirection table */
+  IndirectConv conv_;
+
+  /** @brief Generated tile kernel and the input/output scales it bakes in */
+  std::shared_ptr<const jit::ConvKernel> jit_;
+  float jit_scales_[2] = {0.0f, 0.0f};
+  std::mutex jit_mutex_;
+
   /** @brief Optional bias terms */
   std::vector<float> bias_;
 
@@ -8,6 +8,8 @@
  */
 
 #pragma once
+#include "gemv.hpp"
+#include "jit.hpp"
 #include "operator.hpp"
 
 namespace qnn {
@@ -39,6 +41,8 @@ class Linear : public Operator<InputT, OutputT> {
     // Parse weights and bias
     if (j.contains("weight")) {
       op->weight_ = WeightInfo::LoadFromJson(j["weight"]);
+      op->packed_ = PackGemv(op->weight_.values().data(),
+                             op->weight_.shape()[0], op->weight_.shape()[1]);
     }
 
     // Parse bias
@@ -66,19 +70,7 @@ class Linear : public Operator<InputT, OutputT> {
   void Forward(const Tensor<int8_t>& input, Tensor<int8_t>& output) override {
     // First dimension is always batch size
     const size_t batch_size = input.shape()[0];
-
-    // Calculate flattened features (multiply all dimensions except batch)
-    size_t in_features = 1;
-    for (size_t i = 1; i < input.shape().size(); ++i) {
-      in_features *= input.shape()[i];
-    }
-
-    // Validate input dimensions
-    if (in_features != weight_.shape()[1]) {
-      throw std::runtime_error(
-          "Input features dimension doesn't match weight matrix");
-    }
-
+    const size_t in_features = InFeatures(input);
     const size_t out_features = weight_.shape()[0];
 
     // Resize output tensor to [batch_size, out_features]
@@ -97,36 +89,139 @@ class Linear : public Operator<InputT, OutputT> {
     spdlog::debug("--------------------------------");
 #endif
 
-    // Perform matrix multiplication: y = xW^T + b
+    // Perform matrix multiplication: y = xW^T + b, one row at a time as a
+    // matrix-vector product over the packed weights
+    if (const auto kernel = JitKernel(input.scale(), scale_)) {
+      for (size_t b = 0; b < batch_size; ++b) {
+        kernel->Run(packed_, input.data() + b * in_features,
+                    output.data() + b * out_features);
+      }
+      return;
+    }
+    std::vector<int32_t> acc(out_features);
     for (size_t b = 0; b < batch_size; ++b) {
-      for (size_t o = 0; o < out_features; ++o) {
-        float acc = 0.0f;
+      Gemv(packed_, input.data() + b * in_features, acc.data());
 
-        // Compute dot product
-        for (size_t i = 0; i < in_features; ++i) {
-          acc += static_cast<float>(input.data()[b * in_features + i]) *
-                 static_cast<float>(weight_.values()[o * in_features + i]);
-        }
+      // Add the scaled bias, requantize and store the result
+      for (size_t o = 0; o < out_features; ++o) {
+        output.data()[b * out_features + o] =
+            Requantize(static_cast<float>(acc[o]), bias_, o,
+                       weight_.scales()[o], input.scale(), output.scale());
+      }
+    }
+  }
 
-        if (!bias_.empty()) {
-          // Bias is adjusted by its scale
-          acc += bias_[o] / (weight_.scales()[o] * input.scale());
-        }
+  /**
+   * @brief Compute output features [begin, end) of every batch row
+   *
+   * Runs the precompiled kernel on the weight blocks of the range only.
+   *
+   * @param input Input tensor of shape [batch_size, in_features_]
+   * @param output Output [batch_size, out_features_]
+   * @param begin First output feature
+   * @param end One past the last output feature
+   * @throws std::runtime_error If input dimensions or the range are invalid
+   */
+  void ForwardChannels(const Tensor<int8_t>& input, int8_t* output,
+                       size_t begin, size_t end) override {
+    const size_t batch_size = input.shape()[0];
+    const size_t in_features = InFeatures(input);
+    const size_t out_features = weight_.shape()[0];
+    if (begin > end || end > out_features) {
+      throw std::runtime_error("Output feature range out of bounds");
+    }
 
-        // Apply output scale
-        acc = acc * (weight_.scales()[o] * input.scale()) / output.scale();
+    std::vector<int32_t> acc(out_features);
+    for (size_t b = 0; b < batch_size; ++b) {
+      GemvRows(packed_, input.data() + b * in_features, acc.data(), begin,
+               end);
+      for (size_t o = begin; o < end; ++o) {
+        output[b * out_features + o] =
+            Requantize(static_cast<float>(acc[o]), bias_, o,
+                       weight_.scales()[o], input.scale(), scale_);
+      }
+    }
+  }
 
-        // Clamp the result to the int8 range
-        acc = std::min(std::max(acc, -128.0f), 127.0f);
+  /**
+   * @brief Recompute the output with the dot products on the golden model
+   *
+   * @param input Input tensor the layer was run on
+   * @param output Output tensor of Forward
+   * @param model Golden model of the systolic array
+   * @return Accumulator and output comparison
+   */
+  std::optional<LayerCheck> Verify(const Tensor<int8_t>& input,
+                                   const Tensor<int8_t>& output,
+                                   const SystolicModel& model) const override {
+    const size_t batch_size = input.shape()[0];
+    const size_t in_features = weight_.shape()[1];
+    const size_t out_features = weight_.shape()[0];
 
-        // Store the result
-        output.data()[b * out_features + o] =
-            static_cast<int8_t>(std::round(acc));
+    LayerCheck check;
+    for (size_t b = 0; b < batch_size; ++b) {
+      const int8_t* x = input.data() + b * in_features;
+      for (size_t o = 0; o < out_features; ++o) {
+        const int8_t* w = weight_.values().data() + o * in_features;
+        int64_t exact = 0;
+        for (size_t i = 0; i < in_features; ++i) {
+          exact += int64_t{x[i]} * w[i];
+        }
+        const int64_t golden = model.Dot(x, w, in_features);
+        const int8_t golden_output =
+            Requantize(static_cast<float>(golden), bias_, o,
+                       weight_.scales()[o], input.scale(), output.scale());
+        check.Add(exact, golden, output.data()[b * out_features + o],
+                  golden_output);
       }
     }
+    return check;
   }
 
  private:
+  /**
+   * @brief Flattened features of an input, all dimensions but the batch
+   * @throws std::runtime_error If they do not match the weight matrix
+   */
+  size_t InFeatures(const Tensor<int8_t>& input) const {
+    size_t in_features = 1;
+    for (size_t i = 1; i < input.shape().size(); ++i) {
+      in_features *= input.shape()[i];
+    }
+    if (in_features != static_cast<size_t>(weight_.shape()[1])) {
+      throw std::runtime_error(
+          "Input features dimension doesn't match weight matrix");
+    }
+    return in_features;
+  }
+
+  /**
+   * @brief Generated kernel for the scales of this run
+   *
+   * Generated on the first run, once the input scale is known, and again
+   * only if a scale changes. The caller holds a reference, so a run with
+   * other scales on another thread cannot free it meanwhile.
+   *
+   * @return nullptr to use the precompiled kernel
+   */
+  std::shared_ptr<const jit::GemvKernel> JitKernel(float input_scale,
+                                                   float output_scale) {
+    if (!jit::Enabled()) {
+      return nullptr;
+    }
+    std::lock_guard<std::mutex> lock(jit_mutex_);
+    if (!jit_ || jit_scales_[0] != input_scale ||
+        jit_scales_[1] != output_scale) {
+      jit::RequantTable table(bias_, weight_.scales(), input_scale,
+                              output_scale, weight_.shape()[0],
+                              PackedGemv::kRows);
+      jit_ = jit::GetGemvKernel(packed_.padded_cols, table);
+      jit_scales_[0] = input_scale;
+      jit_scales_[1] = output_scale;
+    }
+    return jit_;
+  }
+
   /** @brief Number of input features */
   int in_features_;
 
@@ -136,6 +231,14 @@ class Linear : public Operator<InputT, OutputT> {
   /** @brief Weight matrix */
   WeightInfo weight_;
 
+  /** @brief Weight matrix packed for Gemv */
+  PackedGemv packed_;
+
+  /** @brief Generated Gemv kernel and the input/output scales it bakes in */
+  std::shared_ptr<const jit::GemvKernel> jit_;
+  float jit_scales_[2] = {0.0f, 0.0f};
+  std::mutex jit_mutex_;
+
   /** @brief Optional bias terms */
   std::vector<float> bias_;
 
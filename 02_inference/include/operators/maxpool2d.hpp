@@ -37,6 +37,9 @@ class MaxPool2d : public Operator<InputT, OutputT> {
     op->kernel_size_ = j["kernel_size"].get<int>();
     op->stride_ = j["stride"].get<int>();
     op->padding_ = j.value("padding", 0);
+    if (op->padding_ < 0 || 2 * op->padding_ > op->kernel_size_) {
+      throw std::runtime_error("Pool padding must be at most half the kernel");
+    }
     return op;
   }
 
@@ -54,19 +57,13 @@ class MaxPool2d : public Operator<InputT, OutputT> {
     }
 
     // Get input dimensions
-    size_t batch = in_shape[0];
-    size_t channels = in_shape[1];
     size_t in_height = in_shape[2];
     size_t in_width = in_shape[3];
 
-    // Calculate output dimensions
-    size_t out_height = (in_height - kernel_size_) / stride_ + 1;
-    size_t out_width = (in_width - kernel_size_) / stride_ + 1;
-
-    // Resize output tensor
-    std::vector<size_t> out_shape = {batch, channels, out_height, out_width};
-    output.resize(out_shape);
-    output.set_scale(input.scale());
+    // Pool the whole map as one tile
+    const TileRegion in{0, 0, in_height, in_width};
+    const TileRegion out{0, 0, OutSize(in_height), OutSize(in_width)};
+    ForwardTile(input, in, in_height, in_width, out, output);
 
 #ifdef BUILD_DEBUG
     spdlog::debug("--------------------------------");
@@ -78,38 +75,77 @@ class MaxPool2d : public Operator<InputT, OutputT> {
     spdlog::debug("Padding: {}", padding_);
     spdlog::debug("--------------------------------");
 #endif
+  }
 
-    // Perform max pooling
-    for (size_t n = 0; n < batch; n++) {
-      for (size_t c = 0; c < channels; c++) {
-        for (size_t oh = 0; oh < out_height; oh++) {
-          for (size_t ow = 0; ow < out_width; ow++) {
-            // Initialize with minimum value for the type
-            InputT max_val = std::numeric_limits<InputT>::lowest();
-
-            // Find maximum in the pooling window
-            for (size_t kh = 0; kh < kernel_size_; kh++) {
-              for (size_t kw = 0; kw < kernel_size_; kw++) {
-                size_t ih = oh * stride_ + kh;
-                size_t iw = ow * stride_ + kw;
+  /**
+   * @brief Pool one output tile; padding never wins the maximum
+   *
+   * @param input Input rows and columns of in
+   * @param in Region of the input map held by input
+   * @param image_height Height of the full input map
+   * @param image_width Width of the full input map
+   * @param out Region of the output map to compute
+   * @param output Output tile [N, C, out.height, out.width]
+   */
+  void ForwardTile(const Tensor<InputT>& input, const TileRegion& in,
+                   size_t image_height, size_t image_width,
+                   const TileRegion& out, Tensor<OutputT>& output) override {
+    const size_t batch = input.shape()[0];
+    const size_t channels = input.shape()[1];
+    output.resize(
+        std::vector<size_t>{batch, channels, out.height, out.width});
+    output.set_scale(input.scale());
 
-                size_t in_idx =
-                    ((n * channels + c) * in_height + ih) * in_width + iw;
-                max_val = std::max(max_val, input.data()[in_idx]);
+    const size_t kernel = kernel_size_;
+    const size_t stride = stride_;
+    const size_t pad = padding_;
+    for (size_t plane = 0; plane < batch * channels; plane++) {
+      const InputT* src = input.data() + plane * in.height * in.width;
+      OutputT* dst = output.data() + plane * out.height * out.width;
+      for (size_t oh = 0; oh < out.height; oh++) {
+        for (size_t ow = 0; ow < out.width; ow++) {
+          // Window corner in padded image coordinates
+          const size_t y = (out.y0 + oh) * stride;
+          const size_t x = (out.x0 + ow) * stride;
+          InputT max_val = std::numeric_limits<InputT>::lowest();
+          for (size_t kh = 0; kh < kernel; kh++) {
+            if (y + kh < pad || y + kh - pad >= image_height) {
+              continue;
+            }
+            const InputT* row = src + (y + kh - pad - in.y0) * in.width;
+            for (size_t kw = 0; kw < kernel; kw++) {
+              if (x + kw < pad || x + kw - pad >= image_width) {
+                continue;
               }
+              max_val = std::max(max_val, row[x + kw - pad - in.x0]);
             }
-
-            // Store the maximum value
-            size_t out_idx =
-                ((n * channels + c) * out_height + oh) * out_width + ow;
-            output.data()[out_idx] = static_cast<OutputT>(max_val);
           }
+          dst[oh * out.width + ow] = static_cast<OutputT>(max_val);
         }
       }
     }
   }
 
+  /** @return Pooling window for tiled execution */
+  std::optional<SpatialWindow> Window() const override {
+    SpatialWindow window;
+    window.kernel = kernel_size_;
+    window.stride = stride_;
+    window.padding = padding_;
+    return window;
+  }
+
  private:
+  /**
+   * @brief Output size along one dimension; an input smaller than the
+   * padded window, such as an empty tile, has no output
+   */
+  size_t OutSize(size_t size) const {
+    const size_t padded = size + 2 * padding_;
+    const size_t kernel = kernel_size_;
+    return padded < kernel ? 0 : (padded - kernel) / stride_ + 1;
+  }
+
   /** @brief Size of the pooling window */
   int kernel_size_;
 
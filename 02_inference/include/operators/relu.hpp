@@ -54,5 +54,10 @@ class ReLU : public Operator<InputT, OutputT> {
           static_cast<OutputT>(input.data()[i] > 0 ? input.data()[i] : 0);
     }
   }
+
+  /** @return Pointwise window, so ReLU fuses into tiled chains */
+  std::optional<SpatialWindow> Window() const override {
+    return SpatialWindow{};
+  }
 };
 }  // namespace qnn
\ No newline at end of file
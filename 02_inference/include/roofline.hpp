@@ -0,0 +1,343 @@
+/**
+ * @file roofline.hpp
+ * @author Leo (zhsleo@outlook.com)
+ *
+ * @brief Roofline model: host microbenchmarks, layer points and charts
+ * @version 1.0.0
+ * @date 2026-10-18
+ */
+
+#pragma once
+
+#include <fmt/format.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <ostream>
+#include <string>
+#include <vector>
+
+#include "dse.hpp"
+#include "workload.hpp"
+
+namespace qnn::roofline {
+
+/**
+ * @brief Compute and memory ceilings of one execution target
+ */
+struct Machine {
+  std::string name;
+  double peak_gops = 0.0;     /**< Peak int8 operations, GOP/s */
+  double bandwidth_gbs = 0.0; /**< Memory bandwidth, GB/s */
+
+  /** @return Intensity (ops/byte) where the two ceilings meet */
+  double ridge() const { return peak_gops / bandwidth_gbs; }
+
+  /** @return Attainable GOP/s at an operational intensity */
+  double Attainable(double intensity) const {
+    return std::min(peak_gops, bandwidth_gbs * intensity);
+  }
+};
+
+/**
+ * @brief One layer measured or estimated on one target
+ */
+struct Point {
+  std::string target;
+  std::string layer;
+  std::string type;
+  double ops = 0.0;     /**< Operations per call */
+  double bytes = 0.0;   /**< Memory traffic per call */
+  double time_us = 0.0; /**< Time per call */
+
+  /** @return Operations per byte */
+  double intensity() const { return bytes > 0 ? ops / bytes : 0.0; }
+
+  /** @return Achieved GOP/s */
+  double gops() const { return time_us > 0 ? ops / time_us * 1e-3 : 0.0; }
+};
+
+/**
+ * @brief Operations of a layer: a multiply and an add per MAC for GEMMs, one
+ * per element or comparison otherwise
+ */
+inline double Ops(const LayerWorkload& layer) {
+  return static_cast<double>(layer.gemm ? 2 * layer.macs : layer.macs);
+}
+
+/**
+ * @brief Measure the host's int8 multiply-accumulate throughput
+ *
+ * Runs an L1-resident int8 dot product, the inner loop of the CPU kernels,
+ * on one core for about the given duration.
+ *
+ * @param duration Measurement time
+ * @return Peak GOP/s, two operations per MAC
+ */
+inline double MeasurePeakGops(
+    std::chrono::milliseconds duration = std::chrono::milliseconds(200)) {
+  constexpr size_t kLength = 4096;
+  std::vector<int8_t> a(kLength), b(kLength);
+  for (size_t i = 0; i < kLength; ++i) {
+    a[i] = static_cast<int8_t>(i * 7);
+    b[i] = static_cast<int8_t>(i * 13);
+  }
+
+  using Clock = std::chrono::steady_clock;
+  const auto start = Clock::now();
+  const auto end = start + duration;
+  uint64_t rounds = 0;
+  int32_t sink = 0;
+  while (Clock::now() < end) {
+    for (int r = 0; r < 64; ++r, ++rounds) {
+      int32_t acc = 0;
+      for (size_t i = 0; i < kLength; ++i) {
+        acc += int32_t{a[i]} * b[i];
+      }
+      sink += acc;
+      // Keep the dot product from being hoisted out of the loop
+      a[rounds % kLength] ^= static_cast<int8_t>(sink);
+    }
+  }
+  const std::chrono::duration<double> elapsed = Clock::now() - start;
+  volatile int32_t keep = sink;
+  (void)keep;
+  return 2.0 * kLength * rounds / elapsed.count() * 1e-9;
+}
+
+/**
+ * @brief Measure the host's copy bandwidth
+ *
+ * Copies a buffer much larger than the last-level cache and counts both the
+ * read and the write stream; the best of several runs is returned.
+ *
+ * @param size Buffer bytes
+ * @param runs Number of copies
+ * @return Bandwidth, GB/s
+ */
+inline double MeasureBandwidth(size_t size = 64 << 20, int runs = 5) {
+  std::vector<char> src(size, 1), dst(size, 0);
+  double best = 0.0;
+  for (int r = 0; r < runs; ++r) {
+    const auto start = std::chrono::steady_clock::now();
+    std::memcpy(dst.data(), src.data(), size);
+    const std::chrono::duration<double> elapsed =
+        std::chrono::steady_clock::now() - start;
+    best = std::max(best, 2.0 * size / elapsed.count() * 1e-9);
+    src[r] = dst[size - 1 - r];
+  }
+  return best;
+}
+
+/**
+ * @brief Ceilings of the simulated accelerator
+ *
+ * Peak is one MAC per processing element per cycle; bandwidth is the DMA
+ * stream width of all channels.
+ */
+inline Machine AcceleratorMachine(const dse::AcceleratorConfig& config) {
+  Machine m;
+  m.name = fmt::format("accel {}x{}", config.array_size, config.array_size);
+  m.peak_gops = 2.0 * config.array_size * config.array_size *
+                config.clock_mhz * 1e-3;
+  m.bandwidth_gbs = static_cast<double>(config.dma_bytes_per_cycle) *
+                    config.dma_channels * config.clock_mhz * 1e-3;
+  return m;
+}
+
+/**
+ * @brief Points of the GEMM layers on the simulated accelerator
+ *
+ * Times come from the DSE cost model; bytes are the DMA traffic of the tiling.
+ */
+inline std::vector<Point> AcceleratorPoints(
+    const std::vector<LayerWorkload>& layers,
+    const dse::AcceleratorConfig& config, const std::string& target) {
+  std::vector<Point> points;
+  for (const auto& layer : layers) {
+    if (!layer.gemm) {
+      continue;
+    }
+    dse::LayerEstimate e = dse::EstimateLayer(layer, config);
+    if (!e.fits) {
+      continue;
+    }
+    Point p;
+    p.target = target;
+    p.layer = layer.name;
+    p.type = layer.type;
+    p.ops = Ops(layer);
+    p.bytes = static_cast<double>(e.traffic_bytes);
+    p.time_us = static_cast<double>(e.cycles) / config.clock_mhz;
+    points.push_back(p);
+  }
+  return points;
+}
+
+/**
+ * @brief Find the machine a point was measured on
+ */
+inline const Machine* FindMachine(const std::vector<Machine>& machines,
+                                  const std::string& name) {
+  for (const auto& m : machines) {
+    if (m.name == name) {
+      return &m;
+    }
+  }
+  return nullptr;
+}
+
+/**
+ * @brief Time a point loses against its roofline
+ * @return Microseconds above the attainable time, 0 if at the roof
+ */
+inline double LostTime(const Point& p, const Machine& m) {
+  const double attainable = m.Attainable(p.intensity());
+  if (attainable <= 0) {
+    return 0.0;
+  }
+  const double ideal_us = p.ops / attainable * 1e-3;
+  return std::max(0.0, p.time_us - ideal_us);
+}
+
+/**
+ * @brief Write machines and points as CSV
+ *
+ * One row per point with its roof, efficiency and the bound (compute or
+ * memory) at its intensity.
+ */
+inline void WriteCsv(std::ostream& out, const std::vector<Machine>& machines,
+                     const std::vector<Point>& points) {
+  out << "target,layer,type,ops,bytes,intensity,time_us,gops,roof_gops,"
+         "efficiency,bound,lost_us\n";
+  for (const auto& p : points) {
+    const Machine* m = FindMachine(machines, p.target);
+    if (!m) {
+      continue;
+    }
+    const double roof = m->Attainable(p.intensity());
+    out << fmt::format("{},{},{},{:.0f},{:.0f},{:.4f},{:.3f},{:.4f},{:.4f},"
+                       "{:.4f},{},{:.3f}\n",
+                       p.target, p.layer, p.type, p.ops, p.bytes,
+                       p.intensity(), p.time_us, p.gops(), roof,
+                       roof > 0 ? p.gops() / roof : 0.0,
+                       p.intensity() < m->ridge() ? "memory" : "compute",
+                       LostTime(p, *m));
+  }
+}
+
+/**
+ * @brief Write a log-log roofline chart as SVG
+ *
+ * Each machine is drawn as its two ceilings with its points in the same
+ * colour; hovering a point shows the layer.
+ */
+inline void WriteSvg(std::ostream& out, const std::vector<Machine>& machines,
+                     const std::vector<Point>& points) {
+  constexpr double kWidth = 800, kHeight = 500;
+  constexpr double kLeft = 70, kRight = 160, kTop = 20, kBottom = 50;
+  static const char* kColors[] = {"#1f77b4", "#d62728", "#2ca02c", "#9467bd"};
+
+  // Axis ranges in whole decades around every roof and point
+  double x_min = 1e9, x_max = 0, y_min = 1e9, y_max = 0;
+  for (const auto& m : machines) {
+    x_min = std::min(x_min, m.ridge());
+    x_max = std::max(x_max, m.ridge());
+    y_max = std::max(y_max, m.peak_gops);
+    y_min = std::min(y_min, m.peak_gops);
+  }
+  for (const auto& p : points) {
+    if (p.intensity() > 0 && p.gops() > 0) {
+      x_min = std::min(x_min, p.intensity());
+      x_max = std::max(x_max, p.intensity());
+      y_min = std::min(y_min, p.gops());
+      y_max = std::max(y_max, p.gops());
+    }
+  }
+  const int x_lo = static_cast<int>(std::floor(std::log10(x_min))) - 1;
+  const int x_hi = static_cast<int>(std::ceil(std::log10(x_max))) + 1;
+  const int y_lo = static_cast<int>(std::floor(std::log10(y_min))) - 1;
+  const int y_hi = static_cast<int>(std::ceil(std::log10(y_max))) + 1;
+
+  const double plot_w = kWidth - kLeft - kRight;
+  const double plot_h = kHeight - kTop - kBottom;
+  auto sx = [&](double x) {
+    return kLeft + (std::log10(x) - x_lo) / (x_hi - x_lo) * plot_w;
+  };
+  auto sy = [&](double y) {
+    return kTop + (y_hi - std::log10(y)) / (y_hi - y_lo) * plot_h;
+  };
+
+  out << fmt::format(
+      "<svg xmlns=\"http://www.w3.org/2000/svg\" width=\"{}\" height=\"{}\" "
+      "font-family=\"sans-serif\" font-size=\"11\">\n",
+      kWidth, kHeight);
+  out << fmt::format(
+      "<rect x=\"{}\" y=\"{}\" width=\"{}\" height=\"{}\" fill=\"none\" "
+      "stroke=\"#444\"/>\n",
+      kLeft, kTop, plot_w, plot_h);
+
+  // Decade grid and labels
+  for (int d = x_lo; d <= x_hi; ++d) {
+    const double x = sx(std::pow(10.0, d));
+    out << fmt::format(
+        "<line x1=\"{0:.1f}\" y1=\"{1}\" x2=\"{0:.1f}\" y2=\"{2}\" "
+        "stroke=\"#ddd\"/>\n<text x=\"{0:.1f}\" y=\"{3}\" "
+        "text-anchor=\"middle\">1e{4}</text>\n",
+        x, kTop, kTop + plot_h, kTop + plot_h + 15, d);
+  }
+  for (int d = y_lo; d <= y_hi; ++d) {
+    const double y = sy(std::pow(10.0, d));
+    out << fmt::format(
+        "<line x1=\"{0}\" y1=\"{1:.1f}\" x2=\"{2}\" y2=\"{1:.1f}\" "
+        "stroke=\"#ddd\"/>\n<text x=\"{3}\" y=\"{1:.1f}\" "
+        "text-anchor=\"end\" dominant-baseline=\"middle\">1e{4}</text>\n",
+        kLeft, y, kLeft + plot_w, kLeft - 5, d);
+  }
+  out << fmt::format(
+      "<text x=\"{}\" y=\"{}\" text-anchor=\"middle\">Operational intensity "
+      "(ops/byte)</text>\n",
+      kLeft + plot_w / 2, kHeight - 10);
+  out << fmt::format(
+      "<text x=\"15\" y=\"{0}\" text-anchor=\"middle\" "
+      "transform=\"rotate(-90 15 {0})\">GOP/s</text>\n",
+      kTop + plot_h / 2);
+
+  for (size_t i = 0; i < machines.size(); ++i) {
+    const Machine& m = machines[i];
+    const char* color = kColors[i % 4];
+    const double x0 = std::pow(10.0, x_lo);
+    const double x1 = std::pow(10.0, x_hi);
+    out << fmt::format(
+        "<polyline fill=\"none\" stroke=\"{}\" stroke-width=\"2\" "
+        "points=\"{:.1f},{:.1f} {:.1f},{:.1f} {:.1f},{:.1f}\"/>\n",
+        color, sx(x0), sy(m.Attainable(x0)), sx(m.ridge()), sy(m.peak_gops),
+        sx(x1), sy(m.peak_gops));
+
+    for (const auto& p : points) {
+      if (p.target != m.name || p.intensity() <= 0 || p.gops() <= 0) {
+        continue;
+      }
+      out << fmt::format(
+          "<circle cx=\"{:.1f}\" cy=\"{:.1f}\" r=\"4\" fill=\"{}\">"
+          "<title>{} ({}): {:.2f} ops/B, {:.3f} GOP/s</title></circle>\n",
+          sx(p.intensity()), sy(p.gops()), color, p.layer, p.type,
+          p.intensity(), p.gops());
+    }
+
+    // Legend
+    const double ly = kTop + 15 + 30 * i;
+    out << fmt::format(
+        "<rect x=\"{0}\" y=\"{1:.1f}\" width=\"12\" height=\"12\" "
+        "fill=\"{2}\"/>\n<text x=\"{3}\" y=\"{4:.1f}\">{5}</text>\n"
+        "<text x=\"{3}\" y=\"{6:.1f}\">{7:.1f} GOP/s, {8:.1f} GB/s</text>\n",
+        kLeft + plot_w + 10, ly - 10, color, kLeft + plot_w + 26, ly, m.name,
+        ly + 13, m.peak_gops, m.bandwidth_gbs);
+  }
+  out << "</svg>\n";
+}
+
+}  // namespace qnn::roofline
@@ -0,0 +1,325 @@
+/**
+ * @file scheduler.hpp
+ * @author Leo (zhsleo@outlook.com)
+ *
+ * @brief Work-stealing inter-op scheduler for operator graphs
+ * @version 1.0.0
+ * @date 2026-10-18
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <optional>
+#include <vector>
+
+#include "thread_pool.hpp"
+
+namespace qnn {
+
+/**
+ * @brief Dependency graph of tasks, numbered in a topological order
+ */
+struct TaskGraph {
+  /** @brief Tasks that consume each task's result */
+  std::vector<std::vector<size_t>> successors;
+
+  /** @brief Number of tasks each task waits for */
+  std::vector<size_t> predecessors;
+
+  /** @return Number of tasks */
+  size_t size() const { return predecessors.size(); }
+
+  /** @brief Make task `to` wait for task `from` */
+  void AddEdge(size_t from, size_t to) {
+    successors[from].push_back(to);
+    predecessors[to]++;
+  }
+
+  /** @brief Reset to tasks without edges */
+  void Resize(size_t tasks) {
+    successors.assign(tasks, {});
+    predecessors.assign(tasks, 0);
+  }
+};
+
+/**
+ * @brief When one task ran, relative to the start of the graph
+ */
+struct TaskSpan {
+  double start_us = 0.0;
+  double end_us = 0.0;
+  size_t worker = 0;
+};
+
+/**
+ * @brief How much parallelism a graph offered and how much was used
+ *
+ * Work is the sum of task times and span the longest dependency chain
+ * weighted by the same times, so work / span bounds the speedup any number
+ * of cores could give; work / wall is what the run achieved.
+ */
+struct ParallelismProfile {
+  uint64_t runs = 0;
+  double work_us = 0.0;
+  double span_us = 0.0;
+  double wall_us = 0.0;
+
+  /** @brief Time spent with k tasks running, index k */
+  std::vector<double> concurrency_us;
+
+  /** @return Parallelism available in the graph */
+  double available() const { return span_us > 0 ? work_us / span_us : 0.0; }
+
+  /** @return Parallelism achieved by the runs */
+  double achieved() const { return wall_us > 0 ? work_us / wall_us : 0.0; }
+
+  /** @brief Add the totals of another profile */
+  void Merge(const ParallelismProfile& other) {
+    runs += other.runs;
+    work_us += other.work_us;
+    span_us += other.span_us;
+    wall_us += other.wall_us;
+    if (concurrency_us.size() < other.concurrency_us.size()) {
+      concurrency_us.resize(other.concurrency_us.size(), 0.0);
+    }
+    for (size_t k = 0; k < other.concurrency_us.size(); ++k) {
+      concurrency_us[k] += other.concurrency_us[k];
+    }
+  }
+};
+
+/**
+ * @brief Profile one run from its task timeline
+ *
+ * @param graph Graph that was run
+ * @param timeline Span of every task
+ * @param wall_us Time from the first start to the last completion
+ */
+inline ParallelismProfile AnalyzeRun(const TaskGraph& graph,
+                                     const std::vector<TaskSpan>& timeline,
+                                     double wall_us) {
+  ParallelismProfile profile;
+  profile.runs = 1;
+  profile.wall_us = wall_us;
+
+  // Longest weighted path; successors always have higher numbers
+  std::vector<double> finish(graph.size(), 0.0);
+  std::vector<double> ready(graph.size(), 0.0);
+  for (size_t t = 0; t < graph.size(); ++t) {
+    const double duration = timeline[t].end_us - timeline[t].start_us;
+    profile.work_us += duration;
+    finish[t] = ready[t] + duration;
+    profile.span_us = std::max(profile.span_us, finish[t]);
+    for (size_t s : graph.successors[t]) {
+      ready[s] = std::max(ready[s], finish[t]);
+    }
+  }
+
+  // Sweep start and end events to find how many tasks ran at once
+  std::vector<std::pair<double, int>> events;
+  for (const auto& span : timeline) {
+    events.emplace_back(span.start_us, 1);
+    events.emplace_back(span.end_us, -1);
+  }
+  std::sort(events.begin(), events.end());
+  profile.concurrency_us.assign(2, 0.0);
+  size_t running = 0;
+  double last = 0.0;
+  for (const auto& [time, delta] : events) {
+    if (profile.concurrency_us.size() <= running) {
+      profile.concurrency_us.resize(running + 1, 0.0);
+    }
+    profile.concurrency_us[running] += time - last;
+    last = time;
+    running += delta;
+  }
+  return profile;
+}
+
+/**
+ * @brief Runs a task graph on the workers of a thread pool
+ *
+ * Every worker owns a deque. It pops the task it made ready most recently
+ * from the back, which keeps a producer's output hot in its cache, and when
+ * its deque is empty it steals the oldest task from the front of another's.
+ *
+ * Only stretches of the graph with two or more tasks to run start a parallel
+ * loop over the pool's workers; kernels that call the pool from inside such
+ * a task run serially on that task's worker, so the process never runs more
+ * threads than the pool has. A task that is alone, with nothing running
+ * beside it and nothing else ready, runs on the calling thread outside the
+ * loop, where its kernels get the whole pool. Workers without a task sleep
+ * until a task completes.
+ */
+class WorkStealingScheduler {
+ public:
+  /**
+   * @brief Run every task once its predecessors have finished
+   *
+   * @param graph Task graph
+   * @param run Called with a task index, from any worker
+   * @param pool Pool providing the workers, nullptr to run in order on the
+   * calling thread
+   * @param timeline If set, receives the span of every task
+   * @throws Rethrows the first exception thrown by a task; tasks not yet
+   * started are skipped
+   */
+  void Run(const TaskGraph& graph, const std::function<void(size_t)>& run,
+           ThreadPool* pool, std::vector<TaskSpan>* timeline = nullptr) {
+    const size_t tasks = graph.size();
+    if (timeline) {
+      timeline->assign(tasks, TaskSpan{});
+    }
+    const auto origin = std::chrono::steady_clock::now();
+    auto since = [&origin] {
+      const std::chrono::duration<double, std::micro> elapsed =
+          std::chrono::steady_clock::now() - origin;
+      return elapsed.count();
+    };
+    auto execute = [&](size_t task, size_t worker) {
+      const double start = timeline ? since() : 0.0;
+      run(task);
+      if (timeline) {
+        (*timeline)[task] = {start, since(), worker};
+      }
+    };
+
+    const size_t workers = pool ? pool->size() : 1;
+    if (workers == 1 || tasks < 2) {
+      for (size_t task = 0; task < tasks; ++task) {
+        execute(task, 0);
+      }
+      return;
+    }
+
+    State state(graph, workers);
+
+    // Run a task taken from the deques and queue the successors it readies
+    // on the worker's own deque (lock held, released while the task runs)
+    auto complete = [&](std::unique_lock<std::mutex>& lock, size_t task,
+                        size_t id) {
+      state.running++;
+      lock.unlock();
+      std::exception_ptr error;
+      try {
+        execute(task, id);
+      } catch (...) {
+        error = std::current_exception();
+      }
+      lock.lock();
+      state.running--;
+      state.completed++;
+      if (error) {
+        if (!state.error) {
+          state.error = error;
+        }
+      } else {
+        for (size_t s : graph.successors[task]) {
+          if (--state.pending[s] == 0) {
+            state.deques[id].push_back(s);
+            state.queued++;
+          }
+        }
+      }
+      state.wake.notify_all();
+    };
+
+    auto worker_loop = [&](size_t id) {
+      std::unique_lock<std::mutex> lock(state.mutex);
+      while (!state.Finished() && !state.Alone()) {
+        std::optional<size_t> task = state.Take(id);
+        if (task) {
+          complete(lock, *task, id);
+        } else {
+          state.wake.wait(lock);
+        }
+      }
+      // Others may be waiting for the loop to end
+      state.wake.notify_all();
+    };
+
+    std::unique_lock<std::mutex> lock(state.mutex);
+    while (!state.Finished()) {
+      if (state.Alone()) {
+        complete(lock, *state.Take(0), 0);
+        continue;
+      }
+      lock.unlock();
+      // One chunk per worker; the pool hands each chunk to one thread
+      pool->ParallelFor(
+          workers,
+          [&](size_t begin, size_t end) {
+            for (size_t id = begin; id < end; ++id) {
+              worker_loop(id);
+            }
+          },
+          1);
+      lock.lock();
+    }
+    if (state.error) {
+      std::rethrow_exception(state.error);
+    }
+  }
+
+ private:
+  /** @brief Progress of one run, guarded by mutex */
+  struct State {
+    State(const TaskGraph& graph, size_t workers)
+        : pending(graph.predecessors), deques(workers), tasks(graph.size()) {
+      size_t next_root = 0;
+      for (size_t t = 0; t < tasks; ++t) {
+        if (pending[t] == 0) {
+          deques[next_root++ % workers].push_back(t);
+          queued++;
+        }
+      }
+    }
+
+    /** @return All tasks ran, or one failed */
+    bool Finished() const { return completed == tasks || error; }
+
+    /** @return At most one task can run now; it belongs outside the loop */
+    bool Alone() const { return running == 0 && queued <= 1; }
+
+    /** @brief Pop the own deque's newest task or steal another's oldest */
+    std::optional<size_t> Take(size_t id) {
+      for (size_t k = 0; k < deques.size(); ++k) {
+        auto& deque = deques[(id + k) % deques.size()];
+        if (!deque.empty()) {
+          size_t task;
+          if (k == 0) {
+            task = deque.back();
+            deque.pop_back();
+          } else {
+            task = deque.front();
+            deque.pop_front();
+          }
+          queued--;
+          return task;
+        }
+      }
+      return std::nullopt;
+    }
+
+    std::mutex mutex;
+    std::condition_variable wake;
+    /** @brief Unfinished predecessors of each task */
+    std::vector<size_t> pending;
+    std::vector<std::deque<size_t>> deques;
+    size_t tasks;
+    size_t queued = 0;
+    size_t running = 0;
+    size_t completed = 0;
+    std::exception_ptr error;
+  };
+};
+
+}  // namespace qnn
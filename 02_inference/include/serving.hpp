@@ -0,0 +1,495 @@
+/**
+ * @file serving.hpp
+ * @author Leo (zhsleo@outlook.com)
+ *
+ * @brief Deadline-aware batching server with admission control
+ * @version 1.0.0
+ * @date 2026-10-18
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <condition_variable>
+#include <cstdint>
+#include <future>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+#include <variant>
+#include <vector>
+
+#include "model.hpp"
+
+namespace qnn {
+
+/**
+ * @brief Running estimate of batch latency for each batch size
+ *
+ * Sizes that have run keep an exponential average of their latency. Other
+ * sizes are predicted from a least-squares line through those averages, or
+ * in proportion to the only one seen. A running mean of the relative
+ * prediction error gives a conservative bound for deadline decisions.
+ */
+class BatchLatencyModel {
+ public:
+  /**
+   * @param max_batch Largest batch size tracked
+   * @param smoothing Weight of the newest observation
+   */
+  explicit BatchLatencyModel(size_t max_batch, double smoothing = 0.2)
+      : mean_us_(max_batch + 1, 0.0), smoothing_(smoothing) {}
+
+  /** @brief Record the latency of one batch */
+  void Observe(size_t batch, double us) {
+    if (batch == 0 || batch >= mean_us_.size()) {
+      return;
+    }
+    const double predicted = Predict(batch);
+    if (predicted > 0) {
+      const double error = std::abs(us - predicted) / predicted;
+      error_ = (1 - smoothing_) * error_ + smoothing_ * error;
+    }
+    double& mean = mean_us_[batch];
+    mean = mean > 0 ? (1 - smoothing_) * mean + smoothing_ * us : us;
+  }
+
+  /**
+   * @brief Predicted latency of a batch
+   * @return Microseconds, 0 before any observation
+   */
+  double Predict(size_t batch) const {
+    if (batch < mean_us_.size() && mean_us_[batch] > 0) {
+      return mean_us_[batch];
+    }
+    double n = 0, sx = 0, sy = 0, sxx = 0, sxy = 0;
+    for (size_t b = 1; b < mean_us_.size(); ++b) {
+      if (mean_us_[b] > 0) {
+        n++;
+        sx += b;
+        sy += mean_us_[b];
+        sxx += double(b) * b;
+        sxy += b * mean_us_[b];
+      }
+    }
+    if (n == 0) {
+      return 0.0;
+    }
+    const double det = n * sxx - sx * sx;
+    if (n == 1 || det <= 0) {
+      return sy / sx * batch;
+    }
+    const double slope = (n * sxy - sx * sy) / det;
+    const double intercept = (sy - slope * sx) / n;
+    return std::max(0.0, intercept + slope * batch);
+  }
+
+  /**
+   * @brief Latency a batch should stay under: the prediction plus twice the
+   * mean relative error
+   */
+  double Bound(size_t batch) const {
+    return Predict(batch) * (1 + 2 * error_);
+  }
+
+ private:
+  std::vector<double> mean_us_;
+  double smoothing_;
+  double error_ = 0.0;
+};
+
+/**
+ * @brief How a request ended
+ */
+enum class ServeStatus {
+  kOk,
+  /** @brief Refused at submission: predicted to miss its deadline */
+  kRejected,
+  /** @brief Dropped from the queue once it could no longer make it */
+  kShed,
+};
+
+/**
+ * @brief Result of one request
+ */
+struct ServeResult {
+  ServeStatus status = ServeStatus::kOk;
+  /** @brief Output row [1, ...] of the request */
+  std::variant<Tensor<float>, Tensor<int8_t>> output;
+  /** @brief Time from submission to completion */
+  double latency_us = 0.0;
+  /** @brief Completed after its deadline */
+  bool missed = false;
+};
+
+/**
+ * @brief Server configuration
+ */
+struct ServerOptions {
+  /** @brief Upper bound of the adaptive batch size */
+  size_t max_batch = 32;
+  /** @brief Longest wait for a batch to fill */
+  double batch_timeout_us = 1000.0;
+  /** @brief p99 latency the batch size controller aims for */
+  double p99_target_us = 10000.0;
+  /** @brief Completions per controller step */
+  size_t window = 200;
+  /** @brief Adapt the batch size; otherwise always use max_batch */
+  bool adaptive = true;
+};
+
+/**
+ * @brief Totals of a server
+ */
+struct ServerStats {
+  uint64_t submitted = 0;
+  uint64_t rejected = 0;
+  uint64_t shed = 0;
+  uint64_t completed = 0;
+  uint64_t missed = 0;
+  uint64_t batches = 0;
+  /** @brief Batch size limit currently in force */
+  size_t batch_limit = 0;
+  /** @brief p99 latency of the last controller window */
+  double window_p99_us = 0.0;
+};
+
+/**
+ * @brief Batch size limit that follows a p99 latency target
+ *
+ * Each window of completions, the limit grows by one while p99 latency is
+ * well under target. Over target, it shrinks by a quarter when batch time
+ * is the cause, but keeps growing while most batches leave full and a full
+ * batch takes under half the target, as then the latency is queueing that
+ * larger batches drain.
+ */
+class BatchLimiter {
+ public:
+  /** @param options Server options */
+  explicit BatchLimiter(const ServerOptions& options)
+      : options_(options), limit_(options.adaptive ? 1 : options.max_batch) {}
+
+  /** @return Batch size limit in force */
+  size_t limit() const { return limit_; }
+
+  /** @brief Count one batch of the current window */
+  void Record(size_t batch) {
+    window_batches_++;
+    full_batches_ += batch == limit_;
+  }
+
+  /**
+   * @brief Close a window and move the limit toward the target
+   *
+   * @param window Latencies of the window's completions; reordered
+   * @param latency Batch latency model
+   * @return p99 latency of the window
+   */
+  double Adapt(std::vector<double>& window, const BatchLatencyModel& latency) {
+    const size_t rank = std::min(window.size() - 1, window.size() * 99 / 100);
+    std::nth_element(window.begin(), window.begin() + rank, window.end());
+    const double p99 = window[rank];
+    const bool backlogged = 2 * full_batches_ >= window_batches_;
+    full_batches_ = window_batches_ = 0;
+    if (!options_.adaptive) {
+      return p99;
+    }
+    const double target = options_.p99_target_us;
+    bool grow = p99 < 0.7 * target;
+    if (p99 > target) {
+      grow = backlogged && latency.Predict(limit_ + 1) < 0.5 * target;
+      if (!grow) {
+        limit_ = std::max<size_t>(1, limit_ * 3 / 4);
+      }
+    }
+    if (grow && limit_ < options_.max_batch) {
+      limit_++;
+    }
+    return p99;
+  }
+
+ private:
+  ServerOptions options_;
+  size_t limit_;
+  /** @brief Batches in the window, and those that left full */
+  size_t window_batches_ = 0;
+  size_t full_batches_ = 0;
+};
+
+/**
+ * @brief Batches requests for one model, earliest deadline first
+ *
+ * Requests carry deadlines. Submission predicts completion from the work
+ * already queued and the latency model, and rejects a request that cannot
+ * make it. The dispatcher orders the queue by deadline, sheds requests that
+ * would miss even if run in the next batch, and records each batch's
+ * latency in the model. Every window of completions, a BatchLimiter moves
+ * the batch limit toward the p99 target.
+ */
+class BatchServer {
+ public:
+  using Clock = std::chrono::steady_clock;
+
+  /**
+   * @param model Model to serve; must outlive the server and not be used
+   * elsewhere meanwhile
+   * @param options Server options
+   */
+  explicit BatchServer(Model& model, ServerOptions options = {})
+      : model_(model),
+        options_(options),
+        latency_(options.max_batch),
+        limiter_(options),
+        dispatcher_([this] { Dispatch(); }) {}
+
+  ~BatchServer() {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      stop_ = true;
+    }
+    wake_.notify_all();
+    dispatcher_.join();
+  }
+
+  BatchServer(const BatchServer&) = delete;
+  BatchServer& operator=(const BatchServer&) = delete;
+
+  /**
+   * @brief Queue one request
+   *
+   * @param input Input [1, ...]; every request must have the same shape
+   * @param deadline Time by which the result is needed
+   * @return Result, ready at once if the request is rejected
+   * @throws std::invalid_argument If the shape differs from earlier requests
+   */
+  std::future<ServeResult> Submit(Tensor<float> input,
+                                  Clock::time_point deadline) {
+    Request request{std::move(input), deadline, Clock::now(), {}};
+    auto result = request.result.get_future();
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (request.input.shape().empty() || request.input.shape()[0] != 1) {
+      throw std::invalid_argument("Requests must have batch size 1");
+    }
+    if (shape_.empty()) {
+      shape_ = request.input.shape();
+    } else if (request.input.shape() != shape_) {
+      throw std::invalid_argument("Request shape differs from the server's");
+    }
+    stats_.submitted++;
+
+    if (request.arrival + Us(PredictWait()) > deadline) {
+      stats_.rejected++;
+      request.result.set_value({ServeStatus::kRejected, {}, 0.0, false});
+      return result;
+    }
+
+    // Keep the queue in deadline order
+    auto at = std::upper_bound(queue_.begin(), queue_.end(), deadline,
+                               [](Clock::time_point d, const Request& r) {
+                                 return d < r.deadline;
+                               });
+    queue_.insert(at, std::move(request));
+    wake_.notify_one();
+    return result;
+  }
+
+  /**
+   * @brief Queue one request with a latency budget
+   * @param budget Time from now by which the result is needed
+   */
+  std::future<ServeResult> Submit(Tensor<float> input,
+                                  std::chrono::microseconds budget) {
+    return Submit(std::move(input), Clock::now() + budget);
+  }
+
+  /** @return Totals so far */
+  ServerStats Stats() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    ServerStats stats = stats_;
+    stats.batch_limit = limiter_.limit();
+    return stats;
+  }
+
+  /** @return Predicted latency of a batch size */
+  double PredictBatch(size_t batch) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return latency_.Predict(batch);
+  }
+
+ private:
+  struct Request {
+    Tensor<float> input;
+    Clock::time_point deadline;
+    Clock::time_point arrival;
+    std::promise<ServeResult> result;
+  };
+
+  static Clock::duration Us(double us) {
+    return std::chrono::duration_cast<Clock::duration>(
+        std::chrono::duration<double, std::micro>(us));
+  }
+
+  /**
+   * @brief Predicted time until a request submitted now completes (lock
+   * held)
+   *
+   * The running batch, the full batches ahead of it and its own batch.
+   */
+  double PredictWait() const {
+    const auto now = Clock::now();
+    double wait = busy_until_ > now
+                      ? std::chrono::duration<double, std::micro>(
+                            busy_until_ - now)
+                            .count()
+                      : 0.0;
+    const size_t ahead = queue_.size();
+    const size_t limit = limiter_.limit();
+    wait += static_cast<double>(ahead / limit) * latency_.Predict(limit);
+    wait += latency_.Bound(ahead % limit + 1);
+    return wait;
+  }
+
+  void Dispatch() {
+    std::vector<size_t> shape;
+    std::vector<double> window;
+    for (;;) {
+      std::vector<Request> batch;
+      {
+        std::unique_lock<std::mutex> lock(mutex_);
+        wake_.wait(lock, [&] { return stop_ || !queue_.empty(); });
+        if (queue_.empty()) {
+          return;
+        }
+        const size_t limit = limiter_.limit();
+        // Give the batch a moment to fill, unless that costs a deadline
+        const auto fill_until =
+            std::min(queue_.front().arrival + Us(options_.batch_timeout_us),
+                     queue_.front().deadline - Us(latency_.Bound(limit)));
+        wake_.wait_until(lock, fill_until, [&] {
+          return stop_ || queue_.size() >= limit;
+        });
+
+        // Shed what cannot finish in time, then take the most urgent
+        const auto now = Clock::now();
+        const size_t n = std::min(limit, queue_.size());
+        const auto finish = now + Us(latency_.Bound(n));
+        while (!queue_.empty() && batch.size() < n) {
+          Request r = std::move(queue_.front());
+          queue_.erase(queue_.begin());
+          if (r.deadline < finish) {
+            stats_.shed++;
+            const double waited =
+                std::chrono::duration<double, std::micro>(now - r.arrival)
+                    .count();
+            r.result.set_value({ServeStatus::kShed, {}, waited, true});
+          } else {
+            batch.push_back(std::move(r));
+          }
+        }
+        if (batch.empty()) {
+          continue;
+        }
+        busy_until_ = now + Us(latency_.Predict(batch.size()));
+        shape = shape_;
+      }
+
+      RunBatch(batch, shape, window);
+    }
+  }
+
+  /** @brief Run one batch and complete its requests */
+  void RunBatch(std::vector<Request>& batch, std::vector<size_t> shape,
+                std::vector<double>& window) {
+    const size_t n = batch.size();
+    const size_t sample = batch[0].input.size();
+    shape[0] = n;
+    Tensor<float> input;
+    input.resize(shape);
+    for (size_t i = 0; i < n; ++i) {
+      std::copy(batch[i].input.data(), batch[i].input.data() + sample,
+                input.data() + i * sample);
+    }
+
+    const auto start = Clock::now();
+    std::variant<Tensor<float>, Tensor<int8_t>> output;
+    try {
+      output = model_.forward(input);
+    } catch (...) {
+      for (auto& r : batch) {
+        r.result.set_exception(std::current_exception());
+      }
+      return;
+    }
+    const auto end = Clock::now();
+
+    uint64_t missed = 0;
+    std::vector<ServeResult> results(n);
+    for (size_t i = 0; i < n; ++i) {
+      ServeResult& result = results[i];
+      result.output = std::visit(
+          [&](const auto& tensor) -> std::variant<Tensor<float>,
+                                                  Tensor<int8_t>> {
+            return Row(tensor, i, n);
+          },
+          output);
+      result.latency_us =
+          std::chrono::duration<double, std::micro>(end - batch[i].arrival)
+              .count();
+      result.missed = end > batch[i].deadline;
+      missed += result.missed;
+      window.push_back(result.latency_us);
+    }
+
+    // Count the batch before its callers can observe it
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      latency_.Observe(
+          n, std::chrono::duration<double, std::micro>(end - start).count());
+      stats_.batches++;
+      limiter_.Record(n);
+      stats_.completed += n;
+      stats_.missed += missed;
+      if (window.size() >= options_.window) {
+        stats_.window_p99_us = limiter_.Adapt(window, latency_);
+        window.clear();
+      }
+    }
+    for (size_t i = 0; i < n; ++i) {
+      batch[i].result.set_value(std::move(results[i]));
+    }
+  }
+
+  /** @brief Row i of an [n, ...] tensor as a [1, ...] tensor */
+  template <typename T>
+  static Tensor<T> Row(const Tensor<T>& tensor, size_t i, size_t n) {
+    std::vector<size_t> shape = tensor.shape();
+    shape[0] = 1;
+    Tensor<T> row;
+    row.resize(shape);
+    row.set_scale(tensor.scale());
+    const size_t size = tensor.size() / n;
+    std::copy(tensor.data() + i * size, tensor.data() + (i + 1) * size,
+              row.data());
+    return row;
+  }
+
+  Model& model_;
+  ServerOptions options_;
+
+  mutable std::mutex mutex_;
+  std::condition_variable wake_;
+  std::vector<Request> queue_;
+  std::vector<size_t> shape_;
+  BatchLatencyModel latency_;
+  BatchLimiter limiter_;
+  Clock::time_point busy_until_{};
+  ServerStats stats_;
+  bool stop_ = false;
+
+  std::thread dispatcher_;
+};
+
+}  // namespace qnn
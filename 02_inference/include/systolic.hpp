@@ -0,0 +1,155 @@
+/**
+ * @file systolic.hpp
+ * @author Leo (zhsleo@outlook.com)
+ *
+ * @brief Bit-exact golden model of the systolic array datapath
+ * @version 1.0.0
+ * @date 2026-10-18
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace qnn {
+
+/**
+ * @brief Numeric parameters of systolic_array.sv
+ *
+ * Operands are DATA_WIDTH-bit vectors and every PE computes
+ * c_out = c_in + a_in * b_in on a DATA_WIDTH*2+ARRAY_SIZE-bit accumulator.
+ * Operands are signed by default, as int8 models need, which is a DSP48
+ * configured for signed operands. The RTL declares the ports as plain logic
+ * vectors, so clear signed_operands to model its unsigned product.
+ */
+struct SystolicSpec {
+  /** @brief ARRAY_SIZE parameter */
+  uint32_t array_size = 8;
+
+  /** @brief DATA_WIDTH parameter */
+  uint32_t data_width = 8;
+
+  /** @brief Treat operands and accumulator as two's complement */
+  bool signed_operands = true;
+
+  /** @brief Accumulator width in bits (24 for the default array) */
+  uint32_t accumulator_bits() const { return data_width * 2 + array_size; }
+};
+
+/**
+ * @brief Outcome of recomputing one layer on the golden model
+ */
+struct LayerCheck {
+  /** @brief Output elements compared */
+  uint64_t elements = 0;
+
+  /** @brief Accumulators differing from the exact CPU sum */
+  uint64_t accumulator_mismatches = 0;
+
+  /** @brief int8 outputs differing from the CPU kernel */
+  uint64_t output_mismatches = 0;
+
+  /** @brief Largest absolute accumulator difference */
+  int64_t max_accumulator_error = 0;
+
+  /**
+   * @brief Record one output element
+   *
+   * @param exact Exact integer sum of the CPU kernel
+   * @param golden Accumulator of the golden model
+   * @param cpu_output Output of the CPU kernel
+   * @param golden_output Output requantized from the golden accumulator
+   */
+  void Add(int64_t exact, int64_t golden, int8_t cpu_output,
+           int8_t golden_output) {
+    const int64_t error = golden > exact ? golden - exact : exact - golden;
+    elements++;
+    accumulator_mismatches += error != 0;
+    output_mismatches += cpu_output != golden_output;
+    max_accumulator_error = std::max(max_accumulator_error, error);
+  }
+
+  /** @brief Add the counts of another check */
+  void Merge(const LayerCheck& other) {
+    elements += other.elements;
+    accumulator_mismatches += other.accumulator_mismatches;
+    output_mismatches += other.output_mismatches;
+    max_accumulator_error =
+        std::max(max_accumulator_error, other.max_accumulator_error);
+  }
+};
+
+/**
+ * @brief Per-layer verification totals over all sampled requests
+ */
+struct LayerVerification {
+  std::string name;
+  std::string type;
+  uint64_t samples = 0;
+  LayerCheck totals;
+};
+
+/**
+ * @brief Golden model of the systolic array arithmetic
+ *
+ * Accumulation wraps modulo 2^accumulator_bits, which is associative, so the
+ * result of a dot product does not depend on how it is tiled across the
+ * array or on the order of the partial sums.
+ */
+class SystolicModel {
+ public:
+  explicit SystolicModel(const SystolicSpec& spec = {})
+      : spec_(spec),
+        operand_mask_(Mask(spec.data_width)),
+        accumulator_mask_(Mask(spec.accumulator_bits())) {}
+
+  /** @return Numeric parameters of the model */
+  const SystolicSpec& spec() const { return spec_; }
+
+  /**
+   * @brief Dot product of two int8 vectors as the array computes it
+   *
+   * @param a First operand, k contiguous elements
+   * @param b Second operand, k contiguous elements
+   * @param k Reduction length
+   * @return Accumulator value, sign-extended when operands are signed
+   */
+  int64_t Dot(const int8_t* a, const int8_t* b, size_t k) const {
+    uint64_t acc = 0;
+    for (size_t i = 0; i < k; ++i) {
+      acc = (acc + Operand(a[i]) * Operand(b[i])) & accumulator_mask_;
+    }
+    return spec_.signed_operands ? SignExtend(acc, spec_.accumulator_bits())
+                                 : static_cast<int64_t>(acc);
+  }
+
+ private:
+  static uint64_t Mask(uint32_t bits) {
+    return bits >= 64 ? ~uint64_t{0} : (uint64_t{1} << bits) - 1;
+  }
+
+  static int64_t SignExtend(uint64_t value, uint32_t bits) {
+    if (bits >= 64) {
+      return static_cast<int64_t>(value);
+    }
+    const uint64_t sign = uint64_t{1} << (bits - 1);
+    return static_cast<int64_t>((value ^ sign) - sign);
+  }
+
+  /** @brief Bit pattern the driver places on a DATA_WIDTH-bit lane */
+  uint64_t Operand(int8_t x) const {
+    const uint64_t bits = static_cast<uint64_t>(int64_t{x}) & operand_mask_;
+    return spec_.signed_operands
+               ? static_cast<uint64_t>(SignExtend(bits, spec_.data_width))
+               : bits;
+  }
+
+  SystolicSpec spec_;
+  uint64_t operand_mask_;
+  uint64_t accumulator_mask_;
+};
+
+}  // namespace qnn
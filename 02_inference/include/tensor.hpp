@@ -34,14 +34,17 @@ class Tensor {
    * @brief Copy constructor
    * @param other Tensor to copy from
    */
-  Tensor(const Tensor& other) : data_(other.data_), shape_(other.shape_) {}
+  Tensor(const Tensor& other)
+      : data_(other.data_), shape_(other.shape_), scale_(other.scale_) {}
 
   /**
    * @brief Move constructor
    * @param other Tensor to move from
    */
   Tensor(Tensor&& other) noexcept
-      : data_(std::move(other.data_)), shape_(std::move(other.shape_)) {}
+      : data_(std::move(other.data_)),
+        shape_(std::move(other.shape_)),
+        scale_(other.scale_) {}
 
   /**
    * @brief Assignment operator
@@ -52,6 +55,7 @@ class Tensor {
     if (this != &other) {
       data_ = other.data_;
       shape_ = other.shape_;
+      scale_ = other.scale_;
     }
     return *this;
   }
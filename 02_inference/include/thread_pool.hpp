@@ -0,0 +1,307 @@
+/**
+ * @file thread_pool.hpp
+ * @author Leo (zhsleo@outlook.com)
+ *
+ * @brief Persistent worker threads for data-parallel kernels
+ * @version 1.0.0
+ * @date 2026-10-18
+ */
+
+#pragma once
+
+#include <pthread.h>
+#include <sched.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <cstdlib>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace qnn {
+
+/** @brief Tell the core the thread is spinning */
+inline void CpuRelax() {
+#if defined(__x86_64__) || defined(__i386__)
+  __builtin_ia32_pause();
+#elif defined(__aarch64__)
+  asm volatile("yield");
+#endif
+}
+
+/**
+ * @brief Poll until ready() holds or the spin time runs out
+ * @return Final value of ready()
+ */
+template <typename Ready>
+bool SpinWait(std::chrono::steady_clock::duration spin, Ready ready) {
+  if (spin.count() <= 0) {
+    return ready();
+  }
+  const auto until = std::chrono::steady_clock::now() + spin;
+  for (unsigned i = 1;; ++i) {
+    if (ready()) {
+      return true;
+    }
+    CpuRelax();
+    // steady_clock is read through the vDSO, without a system call
+    if (i % 64 == 0 && std::chrono::steady_clock::now() >= until) {
+      return ready();
+    }
+  }
+}
+
+/**
+ * @brief Fixed set of worker threads running one parallel loop at a time
+ *
+ * The calling thread takes part in every loop, so a pool of size 1 has no
+ * workers and runs everything inline. Loops started from inside a loop body
+ * run serially on the calling thread.
+ *
+ * Kernels use the Current() pool, which is Global() unless the calling
+ * thread has installed another one with a Scope.
+ *
+ * Idle workers, and a caller waiting for a loop to finish, sleep on a
+ * condition variable. With spin_us set they first poll for that long, so
+ * back-to-back loops start and finish without system calls.
+ */
+class ThreadPool {
+ public:
+  struct Options {
+    /** @brief Total threads including the caller, 0 for one per core */
+    size_t threads = 0;
+    /** @brief If not empty, workers may run on these CPUs only */
+    std::vector<int> cpus;
+    /**
+     * @brief Pin worker i to cpus[i % cpus.size()] alone, leaving cpus[0]
+     * to the caller; needed on isolated cores, which the kernel does not
+     * balance
+     */
+    bool pin_each = false;
+    /** @brief How long idle threads poll before sleeping */
+    double spin_us = 0.0;
+  };
+
+  /**
+   * @brief Start the workers
+   *
+   * @param threads Total threads including the caller, 0 for one per core
+   * @param cpus If not empty, workers may run on these CPUs only
+   */
+  explicit ThreadPool(size_t threads = 0, std::vector<int> cpus = {})
+      : ThreadPool(Options{threads, std::move(cpus)}) {}
+
+  /** @brief Start the workers */
+  explicit ThreadPool(const Options& options)
+      : spin_(std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+            std::chrono::duration<double, std::micro>(options.spin_us))) {
+    size_t threads = options.threads;
+    if (threads == 0) {
+      threads = std::max(1u, std::thread::hardware_concurrency());
+    }
+    for (size_t i = 1; i < threads; ++i) {
+      std::vector<int> cpus = options.cpus;
+      if (options.pin_each && !cpus.empty()) {
+        cpus = {cpus[i % cpus.size()]};
+      }
+      workers_.emplace_back([this, cpus] {
+        if (!cpus.empty()) {
+          PinThread(cpus);
+        }
+        WorkerLoop();
+      });
+    }
+  }
+
+  ~ThreadPool() {
+    stop_ = true;
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      wake_.notify_all();
+    }
+    for (auto& worker : workers_) {
+      worker.join();
+    }
+  }
+
+  ThreadPool(const ThreadPool&) = delete;
+  ThreadPool& operator=(const ThreadPool&) = delete;
+
+  /**
+   * @brief Process-wide pool shared by the kernels
+   *
+   * Sized by the QNN_NUM_THREADS environment variable, one thread per core
+   * by default.
+   */
+  static ThreadPool& Global() {
+    static ThreadPool pool([] {
+      const char* env = std::getenv("QNN_NUM_THREADS");
+      return env ? static_cast<size_t>(std::strtoul(env, nullptr, 10)) : 0;
+    }());
+    return pool;
+  }
+
+  /** @return Pool the calling thread's kernels run on */
+  static ThreadPool& Current() {
+    ThreadPool* pool = Installed();
+    return pool ? *pool : Global();
+  }
+
+  /**
+   * @brief Makes a pool Current() for the calling thread while alive
+   */
+  class Scope {
+   public:
+    explicit Scope(ThreadPool& pool) : previous_(Installed()) {
+      Installed() = &pool;
+    }
+    ~Scope() { Installed() = previous_; }
+
+    Scope(const Scope&) = delete;
+    Scope& operator=(const Scope&) = delete;
+
+   private:
+    ThreadPool* previous_;
+  };
+
+  /**
+   * @brief Restrict the calling thread to a set of CPUs
+   * @return False if the system refused the mask
+   */
+  static bool PinThread(const std::vector<int>& cpus) {
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    for (int cpu : cpus) {
+      if (cpu >= 0 && cpu < CPU_SETSIZE) {
+        CPU_SET(cpu, &set);
+      }
+    }
+    return pthread_setaffinity_np(pthread_self(), sizeof(set), &set) == 0;
+  }
+
+  /** @return Threads taking part in a loop, including the caller */
+  size_t size() const { return workers_.size() + 1; }
+
+  /**
+   * @brief Run fn over [0, n) in chunks of grain indices
+   *
+   * @param n Number of indices
+   * @param fn Called with [begin, end) of each chunk, from any thread
+   * @param grain Indices per chunk
+   * @throws Rethrows the first exception thrown by fn
+   */
+  void ParallelFor(size_t n, const std::function<void(size_t, size_t)>& fn,
+                   size_t grain = 1) {
+    grain = std::max<size_t>(grain, 1);
+    if (workers_.empty() || n <= grain || InsideLoop()) {
+      if (n > 0) {
+        fn(0, n);
+      }
+      return;
+    }
+
+    std::lock_guard<std::mutex> serial(run_mutex_);
+    job_ = &fn;
+    n_ = n;
+    grain_ = grain;
+    next_ = 0;
+    error_ = nullptr;
+    active_ = workers_.size();
+    // Publishes the job; sleeping workers need a notify, spinning ones not
+    generation_++;
+    if (parked_ > 0) {
+      std::lock_guard<std::mutex> lock(mutex_);
+      wake_.notify_all();
+    }
+
+    RunChunks();
+
+    if (!SpinWait(spin_, [this] { return active_ == 0; })) {
+      std::unique_lock<std::mutex> lock(mutex_);
+      caller_parked_ = true;
+      done_.wait(lock, [this] { return active_ == 0; });
+      caller_parked_ = false;
+    }
+    job_ = nullptr;
+    if (error_) {
+      std::rethrow_exception(error_);
+    }
+  }
+
+ private:
+  static ThreadPool*& Installed() {
+    thread_local ThreadPool* pool = nullptr;
+    return pool;
+  }
+
+  static bool& InsideLoop() {
+    thread_local bool inside = false;
+    return inside;
+  }
+
+  void RunChunks() {
+    InsideLoop() = true;
+    try {
+      for (size_t begin = next_.fetch_add(grain_); begin < n_;
+           begin = next_.fetch_add(grain_)) {
+        (*job_)(begin, std::min(begin + grain_, n_));
+      }
+    } catch (...) {
+      std::lock_guard<std::mutex> lock(mutex_);
+      if (!error_) {
+        error_ = std::current_exception();
+      }
+      next_ = n_;
+    }
+    InsideLoop() = false;
+  }
+
+  void WorkerLoop() {
+    uint64_t seen = 0;
+    auto ready = [&] { return stop_ || generation_ != seen; };
+    for (;;) {
+      if (!SpinWait(spin_, ready)) {
+        // Count the sleep before the last check, so that a loop started
+        // meanwhile either is seen here or sees parked_ and notifies
+        std::unique_lock<std::mutex> lock(mutex_);
+        parked_++;
+        wake_.wait(lock, ready);
+        parked_--;
+      }
+      if (stop_) {
+        return;
+      }
+      seen = generation_;
+      RunChunks();
+      if (--active_ == 0 && caller_parked_) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        done_.notify_one();
+      }
+    }
+  }
+
+  std::vector<std::thread> workers_;
+  const std::chrono::steady_clock::duration spin_;
+  std::mutex run_mutex_;
+  std::mutex mutex_;
+  std::condition_variable wake_;
+  std::condition_variable done_;
+  const std::function<void(size_t, size_t)>* job_ = nullptr;
+  size_t n_ = 0;
+  size_t grain_ = 1;
+  std::atomic<size_t> next_{0};
+  std::atomic<size_t> active_{0};
+  std::atomic<uint64_t> generation_{0};
+  std::atomic<size_t> parked_{0};
+  std::atomic<bool> caller_parked_{false};
+  std::atomic<bool> stop_{false};
+  std::exception_ptr error_;
+};
+
+}  // namespace qnn
@@ -0,0 +1,218 @@
+/**
+ * @file tiling.hpp
+ * @author Leo (zhsleo@outlook.com)
+ *
+ * @brief Depth-first tiled execution of Conv/ReLU/Pool chains
+ * @version 1.0.0
+ * @date 2026-10-18
+ */
+
+#pragma once
+
+#include <unistd.h>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+#include "operator.hpp"
+
+namespace qnn {
+
+/**
+ * @brief Size of the per-core L2 cache
+ * @return Bytes, 1 MiB if the system does not report it
+ */
+inline size_t L2CacheBytes() {
+#ifdef _SC_LEVEL2_CACHE_SIZE
+  const long size = sysconf(_SC_LEVEL2_CACHE_SIZE);
+  if (size > 0) {
+    return static_cast<size_t>(size);
+  }
+#endif
+  return size_t{1} << 20;
+}
+
+/**
+ * @brief Depth-first schedule of a chain of tileable operators
+ *
+ * The output of the last operator is cut into square tiles. For each tile,
+ * the region every earlier layer must produce is derived backwards through
+ * the windows; neighbouring tiles overlap by the halo of the kernels, which
+ * is recomputed instead of stored. Every layer then runs on its region only,
+ * so the intermediates of one tile, not whole feature maps, are live at once.
+ */
+class TiledChain {
+ public:
+  /**
+   * @brief Plan the chain for an input shape
+   *
+   * @param ops Operators in execution order; all must have a Window
+   * @param input_shape Input [N, C, H, W]
+   * @param cache_bytes Working-set budget of one tile
+   * @throws std::runtime_error If an operator cannot run on tiles
+   */
+  TiledChain(std::vector<Operator<int8_t, int8_t>*> ops,
+             const std::vector<size_t>& input_shape, size_t cache_bytes)
+      : ops_(std::move(ops)),
+        input_shape_(input_shape),
+        tiles_(ops_.size() + 1) {
+    if (input_shape.size() != 4) {
+      throw std::runtime_error("Input tensor must be 4D [N,C,H,W]");
+    }
+    batch_ = input_shape[0];
+    channels_.push_back(input_shape[1]);
+    heights_.push_back(input_shape[2]);
+    widths_.push_back(input_shape[3]);
+
+    for (const auto* op : ops_) {
+      auto window = op->Window();
+      if (!window) {
+        throw std::runtime_error("Operator cannot run on tiles: " + op->name);
+      }
+      const size_t h = heights_.back() + 2 * window->padding;
+      const size_t w = widths_.back() + 2 * window->padding;
+      if (h < window->kernel || w < window->kernel) {
+        throw std::runtime_error("Input smaller than kernel at " + op->name);
+      }
+      windows_.push_back(*window);
+      channels_.push_back(window->channels ? window->channels
+                                           : channels_.back());
+      heights_.push_back((h - window->kernel) / window->stride + 1);
+      widths_.push_back((w - window->kernel) / window->stride + 1);
+    }
+
+    // Largest square tile whose intermediates fit the budget
+    tile_ = std::max(heights_.back(), widths_.back());
+    while (tile_ > 1 && WorkingSet(tile_) > cache_bytes) {
+      tile_--;
+    }
+  }
+
+  /** @return Input shape the chain was planned for */
+  const std::vector<size_t>& input_shape() const { return input_shape_; }
+
+  /** @return Side of the output tiles */
+  size_t tile() const { return tile_; }
+
+  /** @return Output shape [N, C, H, W] */
+  std::vector<size_t> output_shape() const {
+    return {batch_, channels_.back(), heights_.back(), widths_.back()};
+  }
+
+  /**
+   * @brief Bytes of all layer tiles live for one output tile
+   * @param tile Side of the output tile
+   */
+  size_t WorkingSet(size_t tile) const {
+    TileRegion out{0, 0, std::min(tile, heights_.back()),
+                   std::min(tile, widths_.back())};
+    size_t bytes = batch_ * channels_.back() * out.height * out.width;
+    for (size_t l = ops_.size(); l-- > 0;) {
+      out = InputRegion(l, out);
+      bytes += batch_ * channels_[l] * out.height * out.width;
+    }
+    return bytes;
+  }
+
+  /**
+   * @brief Run the chain tile by tile
+   *
+   * @param input Chain input
+   * @param output Output of the last operator
+   */
+  void Forward(const Tensor<int8_t>& input, Tensor<int8_t>& output) {
+    const size_t layers = ops_.size();
+    const size_t out_h = heights_.back(), out_w = widths_.back();
+    output.resize(output_shape());
+    std::vector<TileRegion> regions(layers + 1);
+
+    for (size_t ty = 0; ty < out_h; ty += tile_) {
+      for (size_t tx = 0; tx < out_w; tx += tile_) {
+        regions[layers] = {ty, tx, std::min(tile_, out_h - ty),
+                           std::min(tile_, out_w - tx)};
+        for (size_t l = layers; l-- > 0;) {
+          regions[l] = InputRegion(l, regions[l + 1]);
+        }
+
+        // Layers feeding an empty region run on empty tiles, which only
+        // carries the scales through to the padded convolution
+        Crop(input, regions[0], tiles_[0]);
+        for (size_t l = 0; l < layers; ++l) {
+          ops_[l]->ForwardTile(tiles_[l], regions[l], heights_[l], widths_[l],
+                               regions[l + 1], tiles_[l + 1]);
+        }
+        Paste(tiles_[layers], regions[layers], output);
+      }
+    }
+    output.set_scale(tiles_[layers].scale());
+  }
+
+ private:
+  /** @brief Input region of layer l needed for its output region out */
+  TileRegion InputRegion(size_t l, const TileRegion& out) const {
+    const SpatialWindow& w = windows_[l];
+    auto span = [&](size_t o0, size_t count, size_t size, size_t& begin,
+                    size_t& length) {
+      // Padded coordinates of the footprint, clipped to the image. Border
+      // outputs of a convolution padded by at least its kernel read only
+      // padding, so the clipped footprint can be empty
+      const size_t first = o0 * w.stride;
+      const size_t last =
+          count > 0 ? (o0 + count - 1) * w.stride + w.kernel : first;
+      begin = std::min(first > w.padding ? first - w.padding : 0, size);
+      const size_t end = std::min(last > w.padding ? last - w.padding : 0, size);
+      length = end > begin ? end - begin : 0;
+    };
+    TileRegion in;
+    span(out.y0, out.height, heights_[l], in.y0, in.height);
+    span(out.x0, out.width, widths_[l], in.x0, in.width);
+    return in;
+  }
+
+  /** @brief Copy a region of a full map into a tile */
+  void Crop(const Tensor<int8_t>& map, const TileRegion& r,
+            Tensor<int8_t>& tile) const {
+    const size_t c = map.shape()[1], h = map.shape()[2], w = map.shape()[3];
+    tile.resize(std::vector<size_t>{batch_, c, r.height, r.width});
+    tile.set_scale(map.scale());
+    for (size_t plane = 0; plane < batch_ * c; ++plane) {
+      for (size_t y = 0; y < r.height; ++y) {
+        const int8_t* src = map.data() + (plane * h + r.y0 + y) * w + r.x0;
+        std::copy(src, src + r.width,
+                  tile.data() + (plane * r.height + y) * r.width);
+      }
+    }
+  }
+
+  /** @brief Copy a tile into its region of a full map */
+  void Paste(const Tensor<int8_t>& tile, const TileRegion& r,
+             Tensor<int8_t>& map) const {
+    const size_t c = map.shape()[1], h = map.shape()[2], w = map.shape()[3];
+    for (size_t plane = 0; plane < batch_ * c; ++plane) {
+      for (size_t y = 0; y < r.height; ++y) {
+        const int8_t* src = tile.data() + (plane * r.height + y) * r.width;
+        std::copy(src, src + r.width,
+                  map.data() + (plane * h + r.y0 + y) * w + r.x0);
+      }
+    }
+  }
+
+  std::vector<Operator<int8_t, int8_t>*> ops_;
+  std::vector<size_t> input_shape_;
+  std::vector<SpatialWindow> windows_;
+  size_t batch_ = 0;
+
+  /** @brief Shape of each layer's input, and of the output last */
+  std::vector<size_t> channels_, heights_, widths_;
+
+  size_t tile_ = 1;
+
+  /** @brief Tile buffers reused across tiles, one per layer boundary */
+  std::vector<Tensor<int8_t>> tiles_;
+};
+
+}  // namespace qnn
@@ -0,0 +1,187 @@
+/**
+ * @file workload.hpp
+ * @author Leo (zhsleo@outlook.com)
+ *
+ * @brief Shape inference and per-layer workload of an exported model
+ * @version 1.0.0
+ * @date 2026-10-18
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <fstream>
+#include <nlohmann/json.hpp>
+#include <numeric>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace qnn {
+
+using json = nlohmann::json;
+
+/**
+ * @brief Shape, compute and traffic of one layer
+ *
+ * Conv2d and Linear layers are also described as a GEMM C[M,N] = A[M,K] *
+ * B[K,N], which is how they are mapped to the systolic array: for Conv2d M is
+ * the number of output pixels, K the receptive field and N the output
+ * channels.
+ */
+struct LayerWorkload {
+  /** @brief Layer name */
+  std::string name;
+
+  /** @brief Layer type */
+  std::string type;
+
+  /** @brief Input shape [N, C, H, W] or [N, F] */
+  std::vector<size_t> input_shape;
+
+  /** @brief Output shape [N, C, H, W] or [N, F] */
+  std::vector<size_t> output_shape;
+
+  /** @brief Multiply-accumulates (comparisons for pooling) */
+  uint64_t macs = 0;
+
+  /** @brief Weight and bias bytes */
+  uint64_t weight_bytes = 0;
+
+  /** @brief Input activation bytes */
+  uint64_t input_bytes = 0;
+
+  /** @brief Output activation bytes */
+  uint64_t output_bytes = 0;
+
+  /** @brief Whether the layer is a GEMM the accelerator can run */
+  bool gemm = false;
+
+  /** @brief GEMM rows, reduction depth and columns */
+  uint64_t m = 0, k = 0, n = 0;
+
+  /** @brief Bytes moved by the layer, each tensor touched once */
+  uint64_t bytes() const { return weight_bytes + input_bytes + output_bytes; }
+};
+
+/**
+ * @brief Number of elements of a shape
+ */
+inline uint64_t NumElements(const std::vector<size_t>& shape) {
+  return std::accumulate(shape.begin(), shape.end(), uint64_t{1},
+                         std::multiplies<uint64_t>());
+}
+
+/**
+ * @brief Infer shapes and workloads of every layer of a model
+ *
+ * Only the layer attributes are read; weight values are not needed.
+ *
+ * @param model Model JSON as written by the exporter
+ * @param input_shape Input shape [N, C, H, W]
+ * @return One workload per layer, in execution order
+ * @throws std::runtime_error If a layer is unsupported or shapes mismatch
+ */
+inline std::vector<LayerWorkload> InferWorkloads(
+    const json& model, const std::vector<size_t>& input_shape) {
+  if (input_shape.size() != 4) {
+    throw std::runtime_error("Input shape must be 4D [N,C,H,W]");
+  }
+
+  std::vector<LayerWorkload> workloads;
+  std::vector<size_t> shape = input_shape;
+  size_t elem_size = sizeof(float);
+
+  for (const auto& layer : model["layers"]) {
+    LayerWorkload w;
+    w.name = layer["name"].get<std::string>();
+    w.type = layer["type"].get<std::string>();
+    w.input_shape = shape;
+    w.input_bytes = NumElements(shape) * elem_size;
+    const size_t batch = shape[0];
+
+    if (w.type == "QuantStub" || w.type == "DeQuantStub") {
+      w.output_shape = shape;
+      elem_size = w.type == "QuantStub" ? sizeof(int8_t) : sizeof(float);
+    } else if (w.type == "Conv2d") {
+      const size_t in_c = layer["in_channels"].get<size_t>();
+      const size_t out_c = layer["out_channels"].get<size_t>();
+      const size_t kernel = layer["kernel_size"].get<size_t>();
+      const size_t stride = layer["stride"].get<size_t>();
+      const size_t pad = layer["padding"].get<size_t>();
+      if (shape.size() != 4 || shape[1] != in_c) {
+        throw std::runtime_error("Channel mismatch at layer " + w.name);
+      }
+      if (shape[2] + 2 * pad < kernel || shape[3] + 2 * pad < kernel) {
+        throw std::runtime_error("Kernel larger than input at " + w.name);
+      }
+      const size_t out_h = (shape[2] + 2 * pad - kernel) / stride + 1;
+      const size_t out_w = (shape[3] + 2 * pad - kernel) / stride + 1;
+      w.output_shape = {batch, out_c, out_h, out_w};
+      w.gemm = true;
+      w.m = batch * out_h * out_w;
+      w.k = in_c * kernel * kernel;
+      w.n = out_c;
+      w.weight_bytes = w.k * w.n + out_c * sizeof(float);
+    } else if (w.type == "Linear") {
+      const size_t in_f = layer["in_features"].get<size_t>();
+      const size_t out_f = layer["out_features"].get<size_t>();
+      if (NumElements(shape) != batch * in_f) {
+        throw std::runtime_error("Feature mismatch at layer " + w.name);
+      }
+      w.output_shape = {batch, out_f};
+      w.gemm = true;
+      w.m = batch;
+      w.k = in_f;
+      w.n = out_f;
+      w.weight_bytes = w.k * w.n + out_f * sizeof(float);
+    } else if (w.type == "MaxPool2d") {
+      const size_t kernel = layer["kernel_size"].get<size_t>();
+      const size_t stride = layer["stride"].get<size_t>();
+      const size_t pad = layer["padding"].get<size_t>();
+      if (shape.size() != 4 || shape[2] + 2 * pad < kernel ||
+          shape[3] + 2 * pad < kernel) {
+        throw std::runtime_error("Invalid pooling input at " + w.name);
+      }
+      const size_t out_h = (shape[2] + 2 * pad - kernel) / stride + 1;
+      const size_t out_w = (shape[3] + 2 * pad - kernel) / stride + 1;
+      w.output_shape = {batch, shape[1], out_h, out_w};
+      w.macs = NumElements(w.output_shape) * kernel * kernel;
+    } else if (w.type == "ReLU") {
+      w.output_shape = shape;
+      w.macs = NumElements(shape);
+    } else {
+      throw std::runtime_error("Unknown operator type: " + w.type);
+    }
+
+    if (w.gemm) {
+      w.macs = w.m * w.k * w.n;
+    }
+    w.output_bytes = NumElements(w.output_shape) * elem_size;
+    shape = w.output_shape;
+    workloads.push_back(std::move(w));
+  }
+
+  return workloads;
+}
+
+/**
+ * @brief Load a model file and infer its workloads
+ *
+ * @param filename Path to the model JSON
+ * @param input_shape Input shape [N, C, H, W]
+ * @return One workload per layer
+ * @throws std::runtime_error If the file cannot be opened or parsed
+ */
+inline std::vector<LayerWorkload> LoadWorkloads(
+    const std::string& filename, const std::vector<size_t>& input_shape) {
+  std::ifstream file(filename);
+  if (!file.is_open()) {
+    throw std::runtime_error("Failed to open model file: " + filename);
+  }
+  json j;
+  file >> j;
+  return InferWorkloads(j, input_shape);
+}
+
+}  // namespace qnn
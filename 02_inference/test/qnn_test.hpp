@@ -0,0 +1,268 @@
+/**
+ * @file qnn_test.hpp
+ * @author Leo (zhsleo@outlook.com)
+ *
+ * @brief Test framework and layer builders for inference unit tests
+ * @version 1.0.0
+ * @date 2026-10-18
+ */
+
+#pragma once
+
+#include <unistd.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "model.hpp"
+#include "operator.hpp"
+#include "tensor.hpp"
+
+// Test statistics
+static int total_tests = 0;
+static int passed_tests = 0;
+static int failed_tests = 0;
+
+// Basic assertions
+#define QNN_TEST_ASSERT(condition)                      \
+  do {                                                  \
+    total_tests++;                                      \
+    if (condition) {                                    \
+      passed_tests++;                                   \
+      std::printf("PASS: %s:%d\n", __FILE__, __LINE__); \
+    } else {                                            \
+      failed_tests++;                                   \
+      std::printf("FAIL: %s:%d\n", __FILE__, __LINE__); \
+    }                                                   \
+  } while (0)
+
+// Equality assertions
+#define QNN_TEST_ASSERT_EQUAL(expected, actual) \
+  QNN_TEST_ASSERT((expected) == (actual))
+
+// Test control
+#define QNN_TEST_BEGIN()                  \
+  do {                                    \
+    total_tests = 0;                      \
+    passed_tests = 0;                     \
+    failed_tests = 0;                     \
+    std::printf("\nStarting tests...\n"); \
+  } while (0)
+
+#define QNN_TEST_END()                         \
+  do {                                         \
+    std::printf("\nTest Summary:\n");          \
+    std::printf("Total:  %d\n", total_tests);  \
+    std::printf("Passed: %d\n", passed_tests); \
+    std::printf("Failed: %d\n", failed_tests); \
+    return failed_tests;                       \
+  } while (0)
+
+#define QNN_TEST_RUN(test_func)                   \
+  do {                                            \
+    std::printf("\nRunning %s...\n", #test_func); \
+    test_func();                                  \
+  } while (0)
+
+namespace qnn_test {
+
+/**
+ * @brief Deterministic int8 values covering the whole range
+ * @param count Number of values
+ * @param seed Sequence offset
+ */
+inline std::vector<int8_t> Values(size_t count, uint32_t seed) {
+  std::vector<int8_t> values(count);
+  uint32_t state = seed * 2654435761u + 1;
+  for (auto& value : values) {
+    state = state * 1664525u + 1013904223u;
+    value = static_cast<int8_t>(state >> 24);
+  }
+  return values;
+}
+
+/**
+ * @brief Fill an int8 tensor of a shape with Values()
+ */
+inline void FillInput(const std::vector<size_t>& shape, float scale,
+                      uint32_t seed, qnn::Tensor<int8_t>& tensor) {
+  tensor.resize(shape);
+  tensor.set_scale(scale);
+  const auto values = Values(tensor.size(), seed);
+  std::copy(values.begin(), values.end(), tensor.data());
+}
+
+/**
+ * @brief Write a layer list to a temporary model file and load it
+ * @param layers JSON array of layers as in a model file
+ * @param load Loads the model from a file name
+ */
+template <typename Load>
+auto LoadModelFile(const qnn::json& layers, Load load) {
+  char path[] = "/tmp/qnn_test_XXXXXX";
+  const int fd = mkstemp(path);
+  if (fd < 0) {
+    throw std::runtime_error("Cannot create a temporary model file");
+  }
+  close(fd);
+  {
+    std::ofstream file(path);
+    file << qnn::json{{"layers", layers}}.dump();
+  }
+  auto model = load(path);
+  unlink(path);
+  return model;
+}
+
+/**
+ * @brief Load a model from its layer list through a temporary file
+ * @param layers JSON array of layers as in a model file
+ */
+inline qnn::Model LoadModel(const qnn::json& layers) {
+  return LoadModelFile(layers, qnn::Model::loadModel);
+}
+
+/**
+ * @brief Per-channel weight JSON as exported by the model converter
+ */
+inline qnn::json WeightJson(const std::vector<size_t>& shape,
+                            const std::vector<int8_t>& values,
+                            const std::vector<float>& scales) {
+  qnn::json weight;
+  weight["shape"] = shape;
+  weight["dtype"] = "torch.qint8";
+  weight["quantization"] = "per_channel";
+  weight["scales"] = scales;
+  weight["axis"] = 0;
+  weight["values"] = std::vector<int>(values.begin(), values.end());
+  return weight;
+}
+
+/**
+ * @brief Output channel scales around 0.01
+ */
+inline std::vector<float> Scales(size_t channels) {
+  std::vector<float> scales(channels);
+  for (size_t c = 0; c < channels; ++c) {
+    scales[c] = 0.004f + 0.001f * static_cast<float>(c % 7);
+  }
+  return scales;
+}
+
+/**
+ * @brief Bias terms, or none
+ */
+inline std::vector<float> Bias(size_t channels, bool with_bias) {
+  std::vector<float> bias;
+  for (size_t c = 0; with_bias && c < channels; ++c) {
+    bias.push_back(0.05f * static_cast<float>(static_cast<int>(c % 9) - 4));
+  }
+  return bias;
+}
+
+/**
+ * @brief JSON of an int8 Conv2d layer with deterministic weights
+ */
+inline qnn::json ConvJson(const std::string& name, size_t in_channels,
+                          size_t out_channels, size_t kernel, size_t stride,
+                          size_t padding, bool with_bias, float scale,
+                          uint32_t seed) {
+  qnn::json j;
+  j["name"] = name;
+  j["type"] = "Conv2d";
+  j["in_channels"] = in_channels;
+  j["out_channels"] = out_channels;
+  j["kernel_size"] = kernel;
+  j["stride"] = stride;
+  j["padding"] = padding;
+  j["weight"] = WeightJson(
+      {out_channels, in_channels, kernel, kernel},
+      Values(out_channels * in_channels * kernel * kernel, seed),
+      Scales(out_channels));
+  if (with_bias) {
+    j["bias"]["values"] = Bias(out_channels, true);
+  }
+  j["scale"] = scale;
+  return j;
+}
+
+/**
+ * @brief Requantized convolution through a padded copy and im2col patches,
+ * as Conv2d computed it before the indirect kernels
+ */
+inline std::vector<int8_t> ReferenceConv(const qnn::Tensor<int8_t>& input,
+                                         const qnn::json& conv) {
+  const size_t in_channels = conv["in_channels"];
+  const size_t out_channels = conv["out_channels"];
+  const size_t kernel = conv["kernel_size"];
+  const size_t stride = conv["stride"];
+  const size_t padding = conv["padding"];
+  const std::vector<int> weight = conv["weight"]["values"];
+  const std::vector<float> scales = conv["weight"]["scales"];
+  const std::vector<float> bias =
+      conv.contains("bias") ? conv["bias"]["values"].get<std::vector<float>>()
+                            : std::vector<float>{};
+  const float out_scale = conv["scale"];
+
+  const size_t batch = input.shape()[0];
+  const size_t height = input.shape()[2], width = input.shape()[3];
+  const size_t padded_h = height + 2 * padding, padded_w = width + 2 * padding;
+  std::vector<int8_t> padded(batch * in_channels * padded_h * padded_w, 0);
+  for (size_t plane = 0; plane < batch * in_channels; ++plane) {
+    for (size_t y = 0; y < height; ++y) {
+      for (size_t x = 0; x < width; ++x) {
+        padded[(plane * padded_h + y + padding) * padded_w + x + padding] =
+            input.data()[(plane * height + y) * width + x];
+      }
+    }
+  }
+
+  const size_t out_h = (padded_h - kernel) / stride + 1;
+  const size_t out_w = (padded_w - kernel) / stride + 1;
+  const size_t patch_size = in_channels * kernel * kernel;
+  std::vector<int8_t> output(batch * out_channels * out_h * out_w);
+  std::vector<int8_t> patch(patch_size);
+  for (size_t n = 0; n < batch; ++n) {
+    for (size_t oh = 0; oh < out_h; ++oh) {
+      for (size_t ow = 0; ow < out_w; ++ow) {
+        size_t p = 0;
+        for (size_t ic = 0; ic < in_channels; ++ic) {
+          for (size_t kh = 0; kh < kernel; ++kh) {
+            for (size_t kw = 0; kw < kernel; ++kw) {
+              patch[p++] = padded[((n * in_channels + ic) * padded_h +
+                                   oh * stride + kh) *
+                                      padded_w +
+                                  ow * stride + kw];
+            }
+          }
+        }
+        for (size_t oc = 0; oc < out_channels; ++oc) {
+          int32_t acc = 0;
+          for (size_t i = 0; i < patch_size; ++i) {
+            acc += int32_t{patch[i]} * weight[oc * patch_size + i];
+          }
+          output[((n * out_channels + oc) * out_h + oh) * out_w + ow] =
+              qnn::Requantize(static_cast<float>(acc), bias, oc, scales[oc],
+                              input.scale(), out_scale);
+        }
+      }
+    }
+  }
+  return output;
+}
+
+/**
+ * @return Whether a tensor holds exactly the expected values
+ */
+inline bool Equal(const qnn::Tensor<int8_t>& tensor,
+                  const std::vector<int8_t>& expected) {
+  return tensor.size() == expected.size() &&
+         std::equal(expected.begin(), expected.end(), tensor.data());
+}
+
+}  // namespace qnn_test
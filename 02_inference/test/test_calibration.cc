@@ -0,0 +1,174 @@
+/**
+ * @file test_calibration.cc
+ * @author Leo (zhsleo@outlook.com)
+ *
+ * @brief Float reference against the int8 operators and activation scales
+ * @version 1.0.0
+ * @date 2026-10-18
+ */
+
+#include <cmath>
+#include <cstdint>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+#include "calibration.hpp"
+#include "operators/maxpool2d.hpp"
+#include "qnn_test.hpp"
+
+namespace {
+
+using Pool = qnn::MaxPool2d<int8_t, int8_t>;
+
+qnn::json PoolJson(size_t kernel, size_t stride, size_t padding) {
+  return {{"name", "pool"},
+          {"type", "MaxPool2d"},
+          {"kernel_size", kernel},
+          {"stride", stride},
+          {"padding", padding}};
+}
+
+qnn::calib::FloatModel FloatPool(size_t kernel, size_t stride,
+                                 size_t padding) {
+  qnn::json layers = qnn::json::array();
+  layers.push_back(PoolJson(kernel, stride, padding));
+  return qnn_test::LoadModelFile(layers, qnn::calib::FloatModel::Load);
+}
+
+/** @brief Stats whose histogram spans [0, range] with the given bins set */
+qnn::calib::TensorStats Stats(float range,
+                              const std::vector<std::pair<size_t, uint64_t>>&
+                                  counts) {
+  qnn::calib::TensorStats stats;
+  stats.observed = true;
+  stats.max_abs = range;
+  stats.histogram.range = range;
+  for (const auto& [bin, count] : counts) {
+    stats.histogram.bins[bin] = count;
+  }
+  return stats;
+}
+
+bool Near(float a, float b) { return std::fabs(a - b) <= 1e-6f * b; }
+
+}  // namespace
+
+static void test_maxpool_matches_reference(void) {
+  // Inputs on the int8 grid with many negative values, so a padding value
+  // of zero would win the border windows
+  const float scale = 0.05f;
+  for (size_t padding : {0, 1}) {
+    for (const std::vector<size_t>& shape :
+         {std::vector<size_t>{2, 3, 7, 6}, std::vector<size_t>{1, 2, 2, 5}}) {
+      qnn::Tensor<int8_t> input, output;
+      qnn_test::FillInput(shape, scale, 13 + padding, input);
+      for (size_t i = 0; i < input.size(); i += 3) {
+        input.data()[i] = static_cast<int8_t>(-1 - i % 100);
+      }
+      auto pool = Pool::LoadFromJson(PoolJson(3, 2, padding));
+      pool->Forward(input, output);
+
+      std::vector<float> values(input.size());
+      for (size_t i = 0; i < input.size(); ++i) {
+        values[i] = input.data()[i] * scale;
+      }
+      const auto expected =
+          FloatPool(3, 2, padding).Forward(values, shape, nullptr);
+      // A 2-row map without padding is smaller than the window
+      std::vector<size_t> out_shape = shape;
+      for (size_t d : {2, 3}) {
+        const size_t padded = shape[d] + 2 * padding;
+        out_shape[d] = padded < 3 ? 0 : (padded - 3) / 2 + 1;
+      }
+
+      QNN_TEST_ASSERT(output.shape() == out_shape);
+      QNN_TEST_ASSERT_EQUAL(expected.size(), output.size());
+      QNN_TEST_ASSERT_EQUAL(scale, output.scale());
+      bool equal = expected.size() == output.size();
+      for (size_t i = 0; equal && i < expected.size(); ++i) {
+        equal = output.data()[i] * scale == expected[i];
+      }
+      QNN_TEST_ASSERT(equal);
+    }
+  }
+
+  // Both reject padding past half the kernel
+  bool threw = false;
+  try {
+    Pool::LoadFromJson(PoolJson(3, 1, 2));
+  } catch (const std::runtime_error&) {
+    threw = true;
+  }
+  QNN_TEST_ASSERT(threw);
+  threw = false;
+  try {
+    FloatPool(3, 1, 2).Forward(std::vector<float>(16, 1.0f), {1, 1, 4, 4},
+                               nullptr);
+  } catch (const std::runtime_error&) {
+    threw = true;
+  }
+  QNN_TEST_ASSERT(threw);
+}
+
+static void test_percentile_scale(void) {
+  // Bins 0.1 wide: 990 values below 1.0 and 10 outliers just below 200.0
+  const auto stats = Stats(204.8f, {{9, 990}, {1999, 10}});
+  QNN_TEST_ASSERT(Near(qnn::calib::PercentileScale(stats, 99.0),
+                       1.0f / 127.0f));
+  QNN_TEST_ASSERT(Near(qnn::calib::PercentileScale(stats, 98.0),
+                       1.0f / 127.0f));
+  QNN_TEST_ASSERT(Near(qnn::calib::PercentileScale(stats, 99.9),
+                       200.0f / 127.0f));
+  QNN_TEST_ASSERT(Near(qnn::calib::PercentileScale(stats, 100.0),
+                       200.0f / 127.0f));
+
+  // Values land in the bin of their magnitude, the range end in the last
+  qnn::calib::TensorStats added = Stats(204.8f, {});
+  added.histogram.Add({0.05f, -0.95f, 0.5f, 204.8f, -300.0f});
+  QNN_TEST_ASSERT_EQUAL(1u, added.histogram.bins[0]);
+  QNN_TEST_ASSERT_EQUAL(1u, added.histogram.bins[5]);
+  QNN_TEST_ASSERT_EQUAL(1u, added.histogram.bins[9]);
+  QNN_TEST_ASSERT_EQUAL(2u, added.histogram.bins[2047]);
+  QNN_TEST_ASSERT(Near(qnn::calib::PercentileScale(added, 60.0),
+                       1.0f / 127.0f));
+}
+
+static void test_kl_scale(void) {
+  // Nothing observed falls back to min-max
+  const auto empty = Stats(2.0f, {});
+  QNN_TEST_ASSERT(Near(qnn::calib::KLScale(empty), 2.0f / 127.0f));
+
+  // Uniform over the first 128 bins: 128 levels represent it exactly, so
+  // the threshold is the end of the data, not the end of the range
+  std::vector<std::pair<size_t, uint64_t>> low;
+  for (size_t bin = 0; bin < 128; ++bin) {
+    low.push_back({bin, 1000});
+  }
+  const auto narrow = Stats(204.8f, low);
+  QNN_TEST_ASSERT(Near(qnn::calib::KLScale(narrow), 12.85f / 127.0f));
+
+  // Uniform over 256 bins: clipping at 128 folds half the mass into one bin
+  std::vector<std::pair<size_t, uint64_t>> wide = low;
+  for (size_t bin = 128; bin < 256; ++bin) {
+    wide.push_back({bin, 1000});
+  }
+  QNN_TEST_ASSERT(Near(qnn::calib::KLScale(Stats(204.8f, wide)),
+                       25.65f / 127.0f));
+
+  // One value at the top of the range: clipping it anywhere moves it into
+  // a bin the quantized distribution leaves empty
+  low.push_back({2047, 1});
+  QNN_TEST_ASSERT(Near(qnn::calib::KLScale(Stats(204.8f, low)),
+                       204.85f / 127.0f));
+}
+
+int main() {
+  QNN_TEST_BEGIN();
+
+  QNN_TEST_RUN(test_maxpool_matches_reference);
+  QNN_TEST_RUN(test_percentile_scale);
+  QNN_TEST_RUN(test_kl_scale);
+
+  QNN_TEST_END();
+}
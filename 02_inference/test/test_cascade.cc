@@ -0,0 +1,223 @@
+/**
+ * @file test_cascade.cc
+ * @author Leo (zhsleo@outlook.com)
+ *
+ * @brief Confidence scores and cascade escalation
+ * @version 1.0.0
+ * @date 2026-10-18
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <stdexcept>
+#include <vector>
+
+#include "cascade.hpp"
+#include "qnn_test.hpp"
+
+namespace {
+
+constexpr size_t kClasses = 3;
+
+/**
+ * @brief Classifier whose int8 logits are its inputs divided by 0.1
+ *
+ * QuantStub at scale 0.1, then a Linear with unit weights at the same
+ * output scale. With reverse set, the classes come out in reverse order, so
+ * the answering stage can be told from the prediction.
+ */
+qnn::Model Classifier(bool reverse) {
+  std::vector<int8_t> weight(kClasses * kClasses, 0);
+  for (size_t c = 0; c < kClasses; ++c) {
+    weight[c * kClasses + (reverse ? kClasses - 1 - c : c)] = 1;
+  }
+  qnn::json layers = qnn::json::array();
+  layers.push_back({{"type", "QuantStub"}, {"name", "quant"}, {"scale", 0.1f}});
+  layers.push_back(
+      {{"type", "Linear"},
+       {"name", "fc"},
+       {"weight", qnn_test::WeightJson({kClasses, kClasses}, weight,
+                                       std::vector<float>(kClasses, 1.0f))},
+       {"scale", 0.1f}});
+  return qnn_test::LoadModel(layers);
+}
+
+/** @brief Batch of logit rows, in units of 0.1 */
+qnn::Tensor<float> Batch(const std::vector<std::vector<int>>& rows) {
+  qnn::Tensor<float> batch;
+  batch.resize(std::vector<size_t>{rows.size(), kClasses});
+  for (size_t i = 0; i < rows.size(); ++i) {
+    for (size_t c = 0; c < kClasses; ++c) {
+      batch.data()[i * kClasses + c] = rows[i][c] * 0.1f;
+    }
+  }
+  return batch;
+}
+
+/** @brief Top-class softmax probability in double precision */
+double ExactMaxProbability(const std::vector<int8_t>& logits, float scale) {
+  int top = logits[0];
+  for (int8_t logit : logits) {
+    top = std::max<int>(top, logit);
+  }
+  double sum = 0.0;
+  for (int8_t logit : logits) {
+    sum += std::exp(static_cast<double>(scale) * (logit - top));
+  }
+  return 1.0 / sum;
+}
+
+}  // namespace
+
+static void test_margin_score(void) {
+  qnn::ConfidenceScorer scorer(qnn::ConfidenceMeasure::kMargin);
+  size_t prediction = 99;
+
+  const int8_t logits[] = {3, 10, -5, 7};
+  QNN_TEST_ASSERT(scorer.Score(logits, 4, 0.5f, prediction) == 1.5f);
+  QNN_TEST_ASSERT_EQUAL(1u, prediction);
+
+  // Top class first: the runner-up is found among the later logits
+  const int8_t first[] = {100, -128, 90, 95};
+  QNN_TEST_ASSERT(scorer.Score(first, 4, 0.25f, prediction) == 1.25f);
+  QNN_TEST_ASSERT_EQUAL(0u, prediction);
+
+  // A tie has no margin and keeps the first index
+  const int8_t tie[] = {-3, 8, 8};
+  QNN_TEST_ASSERT(scorer.Score(tie, 3, 1.0f, prediction) == 0.0f);
+  QNN_TEST_ASSERT_EQUAL(1u, prediction);
+
+  // The full int8 range
+  const int8_t wide[] = {-128, 127};
+  QNN_TEST_ASSERT(scorer.Score(wide, 2, 1.0f, prediction) == 255.0f);
+  QNN_TEST_ASSERT_EQUAL(1u, prediction);
+
+  // A single class is certain
+  const int8_t one[] = {-20};
+  QNN_TEST_ASSERT(std::isinf(scorer.Score(one, 1, 1.0f, prediction)));
+  QNN_TEST_ASSERT_EQUAL(0u, prediction);
+}
+
+static void test_max_probability_score(void) {
+  qnn::ConfidenceScorer scorer(qnn::ConfidenceMeasure::kMaxProbability);
+  size_t prediction = 0;
+
+  // Equal logits split the probability evenly
+  const std::vector<int8_t> flat(10, 42);
+  QNN_TEST_ASSERT(std::abs(scorer.Score(flat.data(), 10, 0.1f, prediction) -
+                           0.1f) < 1e-6f);
+
+  // Rows across the int8 range against the exact softmax, with the scale
+  // changing between rows so the table is rebuilt
+  const float scales[] = {0.02f, 0.1f, 0.5f, 0.02f};
+  double max_error = 0.0;
+  for (size_t row = 0; row < 400; ++row) {
+    const size_t classes = 2 + row % 30;
+    const float scale = scales[row % 4];
+    const std::vector<int8_t> logits =
+        qnn_test::Values(classes, static_cast<uint32_t>(row));
+    const float score =
+        scorer.Score(logits.data(), classes, scale, prediction);
+    QNN_TEST_ASSERT(logits[prediction] ==
+                    *std::max_element(logits.begin(), logits.end()));
+    max_error = std::max(
+        max_error, std::abs(score - ExactMaxProbability(logits, scale)));
+  }
+  QNN_TEST_ASSERT(max_error < 1e-6);
+
+  // Differences of 255 stay inside the table
+  const int8_t wide[] = {127, -128};
+  const float score = scorer.Score(wide, 2, 0.05f, prediction);
+  QNN_TEST_ASSERT_EQUAL(0u, prediction);
+  QNN_TEST_ASSERT(std::abs(score - ExactMaxProbability({127, -128}, 0.05f)) <
+                  1e-6);
+}
+
+static void test_cascade_gather(void) {
+  qnn::Model small = Classifier(false);
+  qnn::Model large = Classifier(true);
+  qnn::Cascade cascade;
+  cascade.AddStage(small, 1.0f, "small");
+  cascade.AddStage(large, 1.0f);
+
+  // Margins 2.0, 0.5, 1.0, 0.0 and 3.0: rows 1 and 3 move on
+  const std::vector<std::vector<int>> rows = {
+      {30, 10, 0}, {5, 10, 0}, {0, -10, 10}, {7, 7, 1}, {-40, 0, -30}};
+  const auto decisions = cascade.Run(Batch(rows));
+  QNN_TEST_ASSERT_EQUAL(5u, decisions.size());
+
+  const size_t stages[] = {0, 1, 0, 1, 0};
+  const size_t predictions[] = {0, 1, 2, 1, 1};
+  for (size_t i = 0; i < rows.size(); ++i) {
+    QNN_TEST_ASSERT_EQUAL(stages[i], decisions[i].stage);
+    QNN_TEST_ASSERT_EQUAL(predictions[i], decisions[i].prediction);
+  }
+  QNN_TEST_ASSERT(std::abs(decisions[0].confidence - 2.0f) < 1e-5f);
+  QNN_TEST_ASSERT(std::abs(decisions[1].confidence - 0.5f) < 1e-5f);
+  // The last stage answers even when unsure
+  QNN_TEST_ASSERT(decisions[3].confidence == 0.0f);
+
+  // The large model saw only the escalated rows, in batch order
+  const qnn::Tensor<int8_t>& logits = large.QuantizedOutput();
+  QNN_TEST_ASSERT(logits.shape() == std::vector<size_t>({2, kClasses}));
+  const std::vector<int8_t> expected = {0, 10, 5, 1, 7, 7};
+  QNN_TEST_ASSERT(qnn_test::Equal(logits, expected));
+}
+
+static void test_cascade_metrics(void) {
+  qnn::Model small = Classifier(false);
+  qnn::Model large = Classifier(true);
+  qnn::Cascade cascade;
+  cascade.AddStage(small, 1.0f, "small");
+  cascade.AddStage(large, 1.0f);
+
+  cascade.Run(Batch({{30, 10, 0}, {5, 10, 0}, {7, 7, 1}, {0, 0, 20}}));
+  // Everything confident: the large model does not run
+  cascade.Run(Batch({{20, 0, 0}, {0, 20, 0}}));
+
+  const auto& metrics = cascade.Metrics();
+  QNN_TEST_ASSERT_EQUAL(2u, metrics.size());
+  QNN_TEST_ASSERT(metrics[0].name == "small");
+  QNN_TEST_ASSERT(metrics[1].name == "stage1");
+  QNN_TEST_ASSERT_EQUAL(2u, metrics[0].batches);
+  QNN_TEST_ASSERT_EQUAL(6u, metrics[0].samples);
+  QNN_TEST_ASSERT_EQUAL(2u, metrics[0].escalated);
+  QNN_TEST_ASSERT(std::abs(metrics[0].escalation_rate() - 2.0 / 6) < 1e-12);
+  QNN_TEST_ASSERT_EQUAL(1u, metrics[1].batches);
+  QNN_TEST_ASSERT_EQUAL(2u, metrics[1].samples);
+  QNN_TEST_ASSERT_EQUAL(0u, metrics[1].escalated);
+  QNN_TEST_ASSERT_EQUAL(6u, cascade.requests());
+
+  // Cost is all stage time per input; latency at least the first stage
+  const double total = metrics[0].total_us + metrics[1].total_us;
+  QNN_TEST_ASSERT(metrics[0].total_us > 0 && metrics[1].total_us > 0);
+  QNN_TEST_ASSERT(std::abs(cascade.mean_cost_us() - total / 6) < 1e-9);
+  QNN_TEST_ASSERT(cascade.mean_latency_us() >= metrics[0].total_us / 6);
+
+  cascade.ResetMetrics();
+  QNN_TEST_ASSERT(cascade.Metrics()[0].name == "small");
+  QNN_TEST_ASSERT_EQUAL(0u, cascade.Metrics()[0].samples);
+  QNN_TEST_ASSERT_EQUAL(0u, cascade.requests());
+  QNN_TEST_ASSERT(cascade.mean_cost_us() == 0.0);
+
+  qnn::Cascade empty;
+  bool threw = false;
+  try {
+    empty.Run(Batch({{1, 2, 3}}));
+  } catch (const std::runtime_error&) {
+    threw = true;
+  }
+  QNN_TEST_ASSERT(threw);
+}
+
+int main() {
+  QNN_TEST_BEGIN();
+
+  QNN_TEST_RUN(test_margin_score);
+  QNN_TEST_RUN(test_max_probability_score);
+  QNN_TEST_RUN(test_cascade_gather);
+  QNN_TEST_RUN(test_cascade_metrics);
+
+  QNN_TEST_END();
+}
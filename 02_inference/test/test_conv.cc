@@ -0,0 +1,258 @@
+/**
+ * @file test_conv.cc
+ * @author Leo (zhsleo@outlook.com)
+ *
+ * @brief Indirect and generated convolution against requantized im2col
+ * @version 1.0.0
+ * @date 2026-10-18
+ */
+
+#include <algorithm>
+#include <cstdint>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include "jit.hpp"
+#include "operators/conv2d.hpp"
+#include "qnn_test.hpp"
+
+namespace {
+
+using Conv = qnn::Conv2d<int8_t, int8_t>;
+
+/** @brief Shape and options of one convolution case */
+struct Case {
+  size_t in_channels, out_channels, kernel, stride, padding;
+  bool bias;
+};
+
+const Case kCases[] = {
+    {3, 8, 3, 1, 1, true},   {3, 10, 3, 2, 1, true},
+    {5, 16, 3, 1, 0, false}, {4, 7, 3, 2, 0, true},
+    {6, 9, 1, 1, 0, true},   {7, 4, 1, 1, 1, true},
+    {4, 12, 1, 2, 2, false}, {3, 5, 3, 1, 3, true},
+    {8, 17, 3, 2, 4, true},  {16, 24, 5, 1, 2, true},
+};
+
+/** @brief Run every case on batch-2 inputs and compare to the reference */
+void CheckCases(bool jit) {
+  qnn::jit::SetEnabled(jit);
+  uint32_t seed = 1;
+  for (const Case& c : kCases) {
+    const qnn::json j =
+        qnn_test::ConvJson("conv", c.in_channels, c.out_channels, c.kernel,
+                           c.stride, c.padding, c.bias, 0.05f, seed++);
+    auto conv = Conv::LoadFromJson(j);
+    for (const auto& hw : {std::vector<size_t>{9, 11},
+                           std::vector<size_t>{16, 7}}) {
+      qnn::Tensor<int8_t> input;
+      qnn_test::FillInput({2, c.in_channels, hw[0], hw[1]}, 0.02f, seed++,
+                          input);
+      const std::vector<int8_t> expected = qnn_test::ReferenceConv(input, j);
+      // The second run reuses the plan of the first
+      for (int run = 0; run < 2; ++run) {
+        qnn::Tensor<int8_t> output;
+        conv->Forward(input, output);
+        QNN_TEST_ASSERT(qnn_test::Equal(output, expected));
+      }
+    }
+  }
+  qnn::jit::SetEnabled(true);
+}
+
+}  // namespace
+
+static void test_conv_precompiled(void) { CheckCases(false); }
+
+static void test_conv_generated(void) { CheckCases(true); }
+
+static void test_conv_concurrent(void) {
+  // One layer shared by threads running different inputs and scales
+  const qnn::json j = qnn_test::ConvJson("conv", 8, 16, 3, 1, 1, true, 0.05f,
+                                         42);
+  auto conv = Conv::LoadFromJson(j);
+  constexpr int kThreads = 4;
+  std::vector<qnn::Tensor<int8_t>> inputs(kThreads);
+  std::vector<std::vector<int8_t>> expected(kThreads);
+  for (int t = 0; t < kThreads; ++t) {
+    const std::vector<size_t> shape = {1, 8, 12 + size_t(t), 10};
+    qnn_test::FillInput(shape, 0.01f * (t + 1), 100 + t, inputs[t]);
+    expected[t] = qnn_test::ReferenceConv(inputs[t], j);
+  }
+
+  for (bool jit : {false, true}) {
+    qnn::jit::SetEnabled(jit);
+    std::vector<int> mismatches(kThreads, 0);
+    std::vector<std::thread> threads;
+    for (int t = 0; t < kThreads; ++t) {
+      threads.emplace_back([&, t] {
+        for (int run = 0; run < 50; ++run) {
+          qnn::Tensor<int8_t> output;
+          conv->Forward(inputs[t], output);
+          mismatches[t] += !qnn_test::Equal(output, expected[t]);
+        }
+      });
+    }
+    for (auto& thread : threads) {
+      thread.join();
+    }
+    for (int t = 0; t < kThreads; ++t) {
+      QNN_TEST_ASSERT_EQUAL(0, mismatches[t]);
+    }
+  }
+  qnn::jit::SetEnabled(true);
+}
+
+static void test_conv_tiles(void) {
+  // Alternating regions must each find their own cached plan
+  const qnn::json j = qnn_test::ConvJson("conv", 4, 8, 3, 2, 1, true, 0.05f,
+                                         7);
+  auto conv = Conv::LoadFromJson(j);
+  qnn::Tensor<int8_t> input;
+  qnn_test::FillInput({1, 4, 14, 14}, 0.02f, 8, input);
+  const std::vector<int8_t> expected = qnn_test::ReferenceConv(input, j);
+  const size_t out = 7;
+
+  for (bool jit : {false, true}) {
+    qnn::jit::SetEnabled(jit);
+    for (int run = 0; run < 3; ++run) {
+      bool equal = true;
+      for (size_t y0 = 0; y0 < out; y0 += 4) {
+        const qnn::TileRegion region{y0, 0, std::min<size_t>(4, out - y0),
+                                     out};
+        qnn::Tensor<int8_t> tile;
+        conv->ForwardTile(input, {0, 0, 14, 14}, 14, 14, region, tile);
+        for (size_t oc = 0; oc < 8; ++oc) {
+          for (size_t y = 0; y < region.height; ++y) {
+            for (size_t x = 0; x < out; ++x) {
+              equal &= tile.data()[(oc * region.height + y) * out + x] ==
+                       expected[(oc * out + y0 + y) * out + x];
+            }
+          }
+        }
+      }
+      QNN_TEST_ASSERT(equal);
+    }
+  }
+  qnn::jit::SetEnabled(true);
+}
+
+static void test_conv_plan_sharing(void) {
+  // 3x3 convolution with padding 1 on a 20x20 map, cut into 4x4 tiles
+  const size_t size = 20, side = 4, channels = 3, filters = 8;
+  const auto weight = qnn_test::Values(filters * channels * 9, 21);
+  const qnn::IndirectConv conv(weight.data(), filters, channels, 3, 1, 1);
+  qnn::Tensor<int8_t> input;
+  qnn_test::FillInput({1, channels, size, size}, 0.02f, 22, input);
+
+  std::vector<int32_t> full(filters * size * size);
+  conv.Run(input.data(), 1, size, size,
+           [&](size_t, size_t oc, size_t pixel, int32_t acc) {
+             full[oc * size * size + pixel] = acc;
+           },
+           nullptr);
+  QNN_TEST_ASSERT_EQUAL(1u, conv.cached_plans());
+
+  for (int run = 0; run < 2; ++run) {
+    bool equal = true;
+    for (size_t y0 = 0; y0 < size; y0 += side) {
+      for (size_t x0 = 0; x0 < size; x0 += side) {
+        // Input tile: the footprint of the outputs, clipped to the image
+        qnn::IndirectConv::Region region;
+        region.batch = 1;
+        region.image_height = region.image_width = size;
+        region.in_y0 = y0 ? y0 - 1 : 0;
+        region.in_x0 = x0 ? x0 - 1 : 0;
+        region.in_height = std::min(size, y0 + side + 1) - region.in_y0;
+        region.in_width = std::min(size, x0 + side + 1) - region.in_x0;
+        region.out_y0 = y0;
+        region.out_x0 = x0;
+        region.out_height = region.out_width = side;
+        std::vector<int8_t> tile;
+        for (size_t c = 0; c < channels; ++c) {
+          for (size_t y = 0; y < region.in_height; ++y) {
+            const int8_t* row = input.data() +
+                                (c * size + region.in_y0 + y) * size +
+                                region.in_x0;
+            tile.insert(tile.end(), row, row + region.in_width);
+          }
+        }
+        conv.Run(tile.data(), region,
+                 [&](size_t, size_t oc, size_t pixel, int32_t acc) {
+                   const size_t y = y0 + pixel / side;
+                   const size_t x = x0 + pixel % side;
+                   equal &= acc == full[(oc * size + y) * size + x];
+                 },
+                 nullptr);
+      }
+    }
+    QNN_TEST_ASSERT(equal);
+    // Top, interior and bottom rows by left, interior and right columns:
+    // the nine interior tiles share one plan
+    QNN_TEST_ASSERT_EQUAL(1u + 9, conv.cached_plans());
+  }
+}
+
+static void test_conv_plan_eviction(void) {
+  // More geometries than the cache holds: old plans go one at a time
+  const std::vector<int8_t> weight = {1};
+  const qnn::IndirectConv conv(weight.data(), 1, 1, 1, 1, 0);
+  const size_t count = qnn::IndirectConv::kMaxPlans + 44;
+  const std::vector<int8_t> input(count, 3);
+  bool equal = true;
+  for (size_t height = 1; height <= count; ++height) {
+    conv.Run(input.data(), 1, height, 1,
+             [&](size_t, size_t, size_t, int32_t acc) { equal &= acc == 3; },
+             nullptr);
+  }
+  QNN_TEST_ASSERT(equal);
+  QNN_TEST_ASSERT_EQUAL(qnn::IndirectConv::kMaxPlans, conv.cached_plans());
+}
+
+static void test_conv_channels(void) {
+  // Two ranges fill one output; channels outside a range stay untouched
+  uint32_t seed = 300;
+  for (const Case& c : {kCases[1], kCases[8], kCases[9]}) {
+    const qnn::json j =
+        qnn_test::ConvJson("conv", c.in_channels, c.out_channels, c.kernel,
+                           c.stride, c.padding, c.bias, 0.05f, seed++);
+    auto conv = Conv::LoadFromJson(j);
+    qnn::Tensor<int8_t> input;
+    qnn_test::FillInput({2, c.in_channels, 9, 11}, 0.02f, seed++, input);
+    const std::vector<int8_t> expected = qnn_test::ReferenceConv(input, j);
+    const size_t plane = expected.size() / (2 * c.out_channels);
+
+    for (bool jit : {false, true}) {
+      qnn::jit::SetEnabled(jit);
+      for (size_t split : {size_t{0}, size_t{3}, size_t{8}, c.out_channels}) {
+        std::vector<int8_t> output(expected.size(), 99);
+        conv->ForwardChannels(input, output.data(), 0, split);
+        bool untouched = true;
+        for (size_t i = 0; i < output.size(); ++i) {
+          const size_t oc = i / plane % c.out_channels;
+          untouched &= oc < split ? output[i] == expected[i]
+                                  : output[i] == 99;
+        }
+        QNN_TEST_ASSERT(untouched);
+        conv->ForwardChannels(input, output.data(), split, c.out_channels);
+        QNN_TEST_ASSERT(output == expected);
+      }
+    }
+  }
+  qnn::jit::SetEnabled(true);
+}
+
+int main() {
+  QNN_TEST_BEGIN();
+
+  QNN_TEST_RUN(test_conv_precompiled);
+  QNN_TEST_RUN(test_conv_generated);
+  QNN_TEST_RUN(test_conv_concurrent);
+  QNN_TEST_RUN(test_conv_tiles);
+  QNN_TEST_RUN(test_conv_plan_sharing);
+  QNN_TEST_RUN(test_conv_plan_eviction);
+  QNN_TEST_RUN(test_conv_channels);
+
+  QNN_TEST_END();
+}
@@ -0,0 +1,174 @@
+/**
+ * @file test_linear.cc
+ * @author Leo (zhsleo@outlook.com)
+ *
+ * @brief Packed and generated GEMV against the plain requantized product
+ * @version 1.0.0
+ * @date 2026-10-18
+ */
+
+#include <thread>
+#include <vector>
+
+#include "jit.hpp"
+#include "operators/linear.hpp"
+#include "qnn_test.hpp"
+
+namespace {
+
+using Linear = qnn::Linear<int8_t, int8_t>;
+
+/** @brief JSON of an int8 Linear layer with deterministic weights */
+qnn::json LinearJson(size_t in_features, size_t out_features, bool with_bias,
+                     uint32_t seed) {
+  qnn::json j;
+  j["name"] = "fc";
+  j["type"] = "Linear";
+  j["weight"] = qnn_test::WeightJson(
+      {out_features, in_features},
+      qnn_test::Values(out_features * in_features, seed),
+      qnn_test::Scales(out_features));
+  if (with_bias) {
+    j["bias"]["values"] = qnn_test::Bias(out_features, true);
+  }
+  j["scale"] = 0.1f;
+  return j;
+}
+
+/** @brief y = W x + b one dot product at a time, then requantized */
+std::vector<int8_t> ReferenceLinear(const qnn::Tensor<int8_t>& input,
+                                    const qnn::json& j) {
+  const std::vector<size_t> shape = j["weight"]["shape"];
+  const std::vector<int> weight = j["weight"]["values"];
+  const std::vector<float> scales = j["weight"]["scales"];
+  const std::vector<float> bias =
+      j.contains("bias") ? j["bias"]["values"].get<std::vector<float>>()
+                         : std::vector<float>{};
+  const size_t out_features = shape[0], in_features = shape[1];
+  const size_t batch = input.shape()[0];
+
+  std::vector<int8_t> output(batch * out_features);
+  for (size_t b = 0; b < batch; ++b) {
+    for (size_t o = 0; o < out_features; ++o) {
+      int32_t acc = 0;
+      for (size_t i = 0; i < in_features; ++i) {
+        acc += int32_t{input.data()[b * in_features + i]} *
+               weight[o * in_features + i];
+      }
+      output[b * out_features + o] =
+          qnn::Requantize(static_cast<float>(acc), bias, o, scales[o],
+                          input.scale(), j["scale"].get<float>());
+    }
+  }
+  return output;
+}
+
+/** @brief Run layers of awkward and large shapes against the reference */
+void CheckShapes(bool jit) {
+  qnn::jit::SetEnabled(jit);
+  const size_t shapes[][2] = {{3, 1},    {16, 4},   {17, 5},    {100, 10},
+                              {300, 64}, {64, 130}, {1024, 512}};
+  uint32_t seed = 1;
+  for (const auto& shape : shapes) {
+    for (bool bias : {false, true}) {
+      const qnn::json j = LinearJson(shape[0], shape[1], bias, seed++);
+      auto linear = Linear::LoadFromJson(j);
+      for (size_t batch : {1, 3}) {
+        qnn::Tensor<int8_t> input;
+        qnn_test::FillInput({batch, shape[0]}, 0.02f, seed++, input);
+        const std::vector<int8_t> expected = ReferenceLinear(input, j);
+        qnn::Tensor<int8_t> output;
+        linear->Forward(input, output);
+        QNN_TEST_ASSERT(qnn_test::Equal(output, expected));
+      }
+    }
+  }
+  qnn::jit::SetEnabled(true);
+}
+
+}  // namespace
+
+static void test_linear_precompiled(void) { CheckShapes(false); }
+
+static void test_linear_generated(void) { CheckShapes(true); }
+
+static void test_linear_feature_maps(void) {
+  // A [N, C, H, W] input is flattened per batch element
+  const qnn::json j = LinearJson(2 * 3 * 5, 12, true, 77);
+  auto linear = Linear::LoadFromJson(j);
+  qnn::Tensor<int8_t> input;
+  qnn_test::FillInput({2, 2, 3, 5}, 0.03f, 78, input);
+  qnn::Tensor<int8_t> flat;
+  qnn_test::FillInput({2, 30}, 0.03f, 78, flat);
+  qnn::Tensor<int8_t> output;
+  linear->Forward(input, output);
+  QNN_TEST_ASSERT(output.shape() == std::vector<size_t>({2, 12}));
+  QNN_TEST_ASSERT(qnn_test::Equal(output, ReferenceLinear(flat, j)));
+}
+
+static void test_linear_concurrent(void) {
+  // Threads with different input scales regenerate the kernel under each
+  // other's runs
+  const qnn::json j = LinearJson(200, 40, true, 99);
+  auto linear = Linear::LoadFromJson(j);
+  constexpr int kThreads = 4;
+  std::vector<qnn::Tensor<int8_t>> inputs(kThreads);
+  std::vector<std::vector<int8_t>> expected(kThreads);
+  for (int t = 0; t < kThreads; ++t) {
+    qnn_test::FillInput({1, 200}, 0.01f * (t + 1), 200 + t, inputs[t]);
+    expected[t] = ReferenceLinear(inputs[t], j);
+  }
+
+  std::vector<int> mismatches(kThreads, 0);
+  std::vector<std::thread> threads;
+  for (int t = 0; t < kThreads; ++t) {
+    threads.emplace_back([&, t] {
+      for (int run = 0; run < 200; ++run) {
+        qnn::Tensor<int8_t> output;
+        linear->Forward(inputs[t], output);
+        mismatches[t] += !qnn_test::Equal(output, expected[t]);
+      }
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  for (int t = 0; t < kThreads; ++t) {
+    QNN_TEST_ASSERT_EQUAL(0, mismatches[t]);
+  }
+}
+
+static void test_linear_channels(void) {
+  // Two ranges fill one output; features outside a range stay untouched
+  const size_t out_features = 37;
+  const qnn::json j = LinearJson(100, out_features, true, 55);
+  auto linear = Linear::LoadFromJson(j);
+  qnn::Tensor<int8_t> input;
+  qnn_test::FillInput({2, 100}, 0.02f, 56, input);
+  const std::vector<int8_t> expected = ReferenceLinear(input, j);
+
+  for (size_t split : {size_t{0}, size_t{5}, size_t{8}, out_features}) {
+    std::vector<int8_t> output(expected.size(), 99);
+    linear->ForwardChannels(input, output.data(), 0, split);
+    bool untouched = true;
+    for (size_t i = 0; i < output.size(); ++i) {
+      untouched &= i % out_features < split ? output[i] == expected[i]
+                                            : output[i] == 99;
+    }
+    QNN_TEST_ASSERT(untouched);
+    linear->ForwardChannels(input, output.data(), split, out_features);
+    QNN_TEST_ASSERT(output == expected);
+  }
+}
+
+int main() {
+  QNN_TEST_BEGIN();
+
+  QNN_TEST_RUN(test_linear_precompiled);
+  QNN_TEST_RUN(test_linear_generated);
+  QNN_TEST_RUN(test_linear_feature_maps);
+  QNN_TEST_RUN(test_linear_concurrent);
+  QNN_TEST_RUN(test_linear_channels);
+
+  QNN_TEST_END();
+}
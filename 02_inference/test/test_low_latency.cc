@@ -0,0 +1,148 @@
+/**
+ * @file test_low_latency.cc
+ * @author Leo (zhsleo@outlook.com)
+ *
+ * @brief Lock-free request queue of the low-latency session
+ * @version 1.0.0
+ * @date 2026-10-18
+ */
+
+#include <atomic>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include "low_latency.hpp"
+#include "qnn_test.hpp"
+
+static void test_queue_full_and_empty(void) {
+  // Capacity rounds up to a power of two
+  qnn::SpinQueue<int> queue(5);
+  int value = -1;
+  QNN_TEST_ASSERT(!queue.TryPop(value));
+  QNN_TEST_ASSERT_EQUAL(-1, value);
+
+  size_t pushed = 0;
+  while (pushed < 100 && queue.TryPush(static_cast<int>(pushed))) {
+    pushed++;
+  }
+  QNN_TEST_ASSERT_EQUAL(8u, pushed);
+  QNN_TEST_ASSERT(!queue.TryPush(100));
+
+  // One pop makes room for exactly one push
+  QNN_TEST_ASSERT(queue.TryPop(value));
+  QNN_TEST_ASSERT_EQUAL(0, value);
+  QNN_TEST_ASSERT(queue.TryPush(8));
+  QNN_TEST_ASSERT(!queue.TryPush(9));
+
+  // Drains in order, then reports empty again
+  bool ordered = true;
+  for (int expected = 1; expected <= 8; ++expected) {
+    ordered = ordered && queue.TryPop(value) && value == expected;
+  }
+  QNN_TEST_ASSERT(ordered);
+  QNN_TEST_ASSERT(!queue.TryPop(value));
+}
+
+static void test_queue_wraps(void) {
+  // Many laps around a small ring, with the fill level varying
+  qnn::SpinQueue<size_t> queue(4);
+  size_t next_push = 0, next_pop = 0;
+  bool ordered = true;
+  for (size_t round = 0; round < 1000; ++round) {
+    const size_t burst = 1 + round % 4;
+    for (size_t i = 0; i < burst; ++i) {
+      ordered = ordered && queue.TryPush(next_push++);
+    }
+    size_t value = 0;
+    for (size_t i = 0; i < burst; ++i) {
+      ordered = ordered && queue.TryPop(value) && value == next_pop++;
+    }
+  }
+  QNN_TEST_ASSERT(ordered);
+  size_t value = 0;
+  QNN_TEST_ASSERT(!queue.TryPop(value));
+}
+
+static void test_queue_move_only(void) {
+  qnn::SpinQueue<std::unique_ptr<int>> queue(2);
+  QNN_TEST_ASSERT(queue.TryPush(std::make_unique<int>(7)));
+  QNN_TEST_ASSERT(queue.TryPush(std::make_unique<int>(8)));
+  QNN_TEST_ASSERT(!queue.TryPush(std::make_unique<int>(9)));
+  std::unique_ptr<int> value;
+  QNN_TEST_ASSERT(queue.TryPop(value) && *value == 7);
+  QNN_TEST_ASSERT(queue.TryPop(value) && *value == 8);
+  QNN_TEST_ASSERT(!queue.TryPop(value));
+}
+
+static void test_queue_mpmc_stress(void) {
+  constexpr size_t kProducers = 4;
+  constexpr size_t kConsumers = 4;
+  constexpr size_t kPerProducer = 50000;
+  constexpr size_t kTotal = kProducers * kPerProducer;
+
+  // Items are producer * kPerProducer + sequence
+  qnn::SpinQueue<size_t> queue(64);
+  std::vector<std::atomic<uint32_t>> seen(kTotal);
+  std::atomic<size_t> consumed{0};
+  std::atomic<size_t> out_of_order{0};
+
+  std::vector<std::thread> threads;
+  for (size_t p = 0; p < kProducers; ++p) {
+    threads.emplace_back([&, p] {
+      for (size_t i = 0; i < kPerProducer; ++i) {
+        while (!queue.TryPush(p * kPerProducer + i)) {
+          std::this_thread::yield();
+        }
+      }
+    });
+  }
+  for (size_t c = 0; c < kConsumers; ++c) {
+    threads.emplace_back([&] {
+      // One consumer sees each producer's items in the order pushed
+      std::vector<size_t> last(kProducers, 0);
+      std::vector<bool> any(kProducers, false);
+      while (consumed.load() < kTotal) {
+        size_t item = 0;
+        if (!queue.TryPop(item)) {
+          std::this_thread::yield();
+          continue;
+        }
+        const size_t p = item / kPerProducer;
+        if (any[p] && item <= last[p]) {
+          out_of_order++;
+        }
+        any[p] = true;
+        last[p] = item;
+        seen[item]++;
+        consumed++;
+      }
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+
+  size_t missing = 0, duplicated = 0;
+  for (const auto& count : seen) {
+    missing += count.load() == 0;
+    duplicated += count.load() > 1;
+  }
+  QNN_TEST_ASSERT_EQUAL(kTotal, consumed.load());
+  QNN_TEST_ASSERT_EQUAL(0u, missing);
+  QNN_TEST_ASSERT_EQUAL(0u, duplicated);
+  QNN_TEST_ASSERT_EQUAL(0u, out_of_order.load());
+  size_t value = 0;
+  QNN_TEST_ASSERT(!queue.TryPop(value));
+}
+
+int main() {
+  QNN_TEST_BEGIN();
+
+  QNN_TEST_RUN(test_queue_full_and_empty);
+  QNN_TEST_RUN(test_queue_wraps);
+  QNN_TEST_RUN(test_queue_move_only);
+  QNN_TEST_RUN(test_queue_mpmc_stress);
+
+  QNN_TEST_END();
+}
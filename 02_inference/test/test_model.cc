@@ -0,0 +1,112 @@
+/**
+ * @file test_model.cc
+ * @author Leo (zhsleo@outlook.com)
+ *
+ * @brief Tensor scales through copies and model outputs
+ * @version 1.0.0
+ * @date 2026-10-18
+ */
+
+#include <utility>
+#include <variant>
+#include <vector>
+
+#include "model.hpp"
+#include "qnn_test.hpp"
+
+namespace {
+
+/** @brief QuantStub, Conv2d, ReLU, then optionally a DeQuantStub */
+qnn::json Layers(bool dequantize) {
+  qnn::json layers = qnn::json::array();
+  layers.push_back(
+      {{"type", "QuantStub"}, {"name", "quant"}, {"scale", 0.05f}});
+  layers.push_back(
+      qnn_test::ConvJson("conv", 3, 8, 3, 1, 1, true, 0.125f, 11));
+  layers.push_back({{"type", "ReLU"}, {"name", "relu"}});
+  if (dequantize) {
+    layers.push_back(
+        {{"type", "DeQuantStub"}, {"name", "dequant"}, {"scale", 0.125f}});
+  }
+  return layers;
+}
+
+/** @brief Float image [1, 3, 8, 8] */
+qnn::Tensor<float> Image() {
+  qnn::Tensor<float> image;
+  image.resize(std::vector<size_t>{1, 3, 8, 8});
+  for (size_t i = 0; i < image.size(); ++i) {
+    image.data()[i] = static_cast<float>(i % 17) * 0.1f - 0.8f;
+  }
+  return image;
+}
+
+}  // namespace
+
+static void test_tensor_copies_keep_scale(void) {
+  qnn::Tensor<int8_t> tensor;
+  qnn_test::FillInput({2, 3}, 0.25f, 1, tensor);
+
+  qnn::Tensor<int8_t> copy(tensor);
+  QNN_TEST_ASSERT(copy.scale() == 0.25f);
+  QNN_TEST_ASSERT(copy.shape() == tensor.shape());
+
+  qnn::Tensor<int8_t> assigned;
+  assigned = tensor;
+  QNN_TEST_ASSERT(assigned.scale() == 0.25f);
+
+  qnn::Tensor<int8_t> moved(std::move(copy));
+  QNN_TEST_ASSERT(moved.scale() == 0.25f);
+  QNN_TEST_ASSERT_EQUAL(6u, moved.size());
+
+  qnn::Tensor<int8_t> move_assigned;
+  move_assigned = std::move(assigned);
+  QNN_TEST_ASSERT(move_assigned.scale() == 0.25f);
+
+  // Through a variant, as Model returns its outputs
+  std::variant<qnn::Tensor<float>, qnn::Tensor<int8_t>> result(tensor);
+  QNN_TEST_ASSERT(std::get<qnn::Tensor<int8_t>>(result).scale() == 0.25f);
+}
+
+static void test_model_int8_output_scale(void) {
+  qnn::Model model = qnn_test::LoadModel(Layers(false));
+  const auto result = model.forward(Image());
+  QNN_TEST_ASSERT(std::holds_alternative<qnn::Tensor<int8_t>>(result));
+  const auto& output = std::get<qnn::Tensor<int8_t>>(result);
+  QNN_TEST_ASSERT(output.scale() == 0.125f);
+  QNN_TEST_ASSERT(output.shape() == std::vector<size_t>({1, 8, 8, 8}));
+  QNN_TEST_ASSERT(model.QuantizedOutput().scale() == 0.125f);
+
+  // Intermediate layers keep their own scales
+  const auto quant = model.Output("quant");
+  QNN_TEST_ASSERT(std::get<qnn::Tensor<int8_t>>(quant).scale() == 0.05f);
+  const auto conv = model.Output("conv");
+  QNN_TEST_ASSERT(std::get<qnn::Tensor<int8_t>>(conv).scale() == 0.125f);
+}
+
+static void test_model_float_output(void) {
+  qnn::Model model = qnn_test::LoadModel(Layers(true));
+  const auto result = model.forward(Image());
+  QNN_TEST_ASSERT(std::holds_alternative<qnn::Tensor<float>>(result));
+
+  // Dequantized values are the int8 ReLU output times its scale
+  const auto relu = model.Output("relu");
+  const auto& quantized = std::get<qnn::Tensor<int8_t>>(relu);
+  const auto& output = std::get<qnn::Tensor<float>>(result);
+  QNN_TEST_ASSERT(quantized.scale() == 0.125f);
+  bool equal = output.size() == quantized.size();
+  for (size_t i = 0; equal && i < output.size(); ++i) {
+    equal = output.data()[i] == quantized.data()[i] * quantized.scale();
+  }
+  QNN_TEST_ASSERT(equal);
+}
+
+int main() {
+  QNN_TEST_BEGIN();
+
+  QNN_TEST_RUN(test_tensor_copies_keep_scale);
+  QNN_TEST_RUN(test_model_int8_output_scale);
+  QNN_TEST_RUN(test_model_float_output);
+
+  QNN_TEST_END();
+}
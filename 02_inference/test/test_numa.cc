@@ -0,0 +1,175 @@
+/**
+ * @file test_numa.cc
+ * @author Leo (zhsleo@outlook.com)
+ *
+ * @brief Node router routing and load balance on a fake topology
+ * @version 1.0.0
+ * @date 2026-10-18
+ */
+
+#include <chrono>
+#include <cstdint>
+#include <future>
+#include <memory>
+#include <numeric>
+#include <stdexcept>
+#include <vector>
+
+#include "numa.hpp"
+#include "qnn_test.hpp"
+
+namespace {
+
+using qnn::numa::NodeRouter;
+
+/** @brief QuantStub, a 3x3 Conv2d and a DeQuantStub */
+qnn::json Layers() {
+  qnn::json layers = qnn::json::array();
+  layers.push_back({{"type", "QuantStub"}, {"name", "quant"}, {"scale", 0.02f}});
+  layers.push_back(qnn_test::ConvJson("conv", 3, 16, 3, 1, 1, true, 0.05f, 5));
+  layers.push_back(
+      {{"type", "DeQuantStub"}, {"name", "dequant"}, {"scale", 0.05f}});
+  return layers;
+}
+
+/**
+ * @brief Router over nodes that all hold CPU 0, which every host has
+ *
+ * Each node gets a session of its own, with one thread: the dispatcher.
+ */
+std::unique_ptr<NodeRouter> FakeRouter(size_t nodes) {
+  std::vector<qnn::numa::Node> topology(nodes);
+  for (size_t i = 0; i < nodes; ++i) {
+    topology[i].id = static_cast<int>(i);
+    topology[i].cpus = {0};
+  }
+  qnn::numa::RouterOptions options;
+  options.threads_per_node = 1;
+  return qnn_test::LoadModelFile(Layers(), [&](const char* path) {
+    return std::make_unique<NodeRouter>(path, options, topology);
+  });
+}
+
+qnn::Tensor<float> Image(size_t side, float offset) {
+  qnn::Tensor<float> image;
+  image.resize(std::vector<size_t>{1, 3, side, side});
+  for (size_t i = 0; i < image.size(); ++i) {
+    image.data()[i] = static_cast<float>(i % 19) * 0.1f - offset;
+  }
+  return image;
+}
+
+bool Same(const qnn::numa::ModelOutput& a, const qnn::numa::ModelOutput& b) {
+  const auto& x = std::get<qnn::Tensor<float>>(a);
+  const auto& y = std::get<qnn::Tensor<float>>(b);
+  if (x.shape() != y.shape()) {
+    return false;
+  }
+  for (size_t i = 0; i < x.size(); ++i) {
+    if (x.data()[i] != y.data()[i]) {
+      return false;
+    }
+  }
+  return true;
+}
+
+uint64_t Total(const std::vector<uint64_t>& served) {
+  return std::accumulate(served.begin(), served.end(), uint64_t{0});
+}
+
+}  // namespace
+
+static void test_parse_cpu_list(void) {
+  QNN_TEST_ASSERT(qnn::numa::ParseCpuList("0-3,8-11") ==
+                  std::vector<int>({0, 1, 2, 3, 8, 9, 10, 11}));
+  QNN_TEST_ASSERT(qnn::numa::ParseCpuList("5\n") == std::vector<int>({5}));
+  QNN_TEST_ASSERT(qnn::numa::ParseCpuList("0,2,4-5") ==
+                  std::vector<int>({0, 2, 4, 5}));
+  QNN_TEST_ASSERT(qnn::numa::ParseCpuList("").empty());
+
+  // The host reports at least one node, each with CPUs
+  const auto nodes = qnn::numa::Nodes();
+  QNN_TEST_ASSERT(!nodes.empty());
+  for (const auto& node : nodes) {
+    QNN_TEST_ASSERT(!node.cpus.empty());
+  }
+}
+
+static void test_single_node(void) {
+  auto router = FakeRouter(1);
+  QNN_TEST_ASSERT_EQUAL(1u, router->nodes().size());
+  qnn::Model model = qnn_test::LoadModel(Layers());
+
+  // Every request lands on the only node and matches a plain run
+  std::vector<std::future<qnn::numa::ModelOutput>> results;
+  std::vector<qnn::numa::ModelOutput> expected;
+  for (size_t i = 0; i < 12; ++i) {
+    const auto image = Image(6 + i % 3, 0.2f * i);
+    expected.push_back(model.forward(image));
+    results.push_back(router->Submit(image));
+  }
+  bool same = true;
+  for (size_t i = 0; i < results.size(); ++i) {
+    same = same && Same(expected[i], results[i].get());
+  }
+  QNN_TEST_ASSERT(same);
+  QNN_TEST_ASSERT(router->Served() == std::vector<uint64_t>({12}));
+
+  // A failing request reaches its client and the node keeps serving
+  qnn::Tensor<float> flat;
+  flat.resize(std::vector<size_t>{1, 12});
+  auto failed = router->Submit(flat);
+  bool threw = false;
+  try {
+    failed.get();
+  } catch (const std::runtime_error&) {
+    threw = true;
+  }
+  QNN_TEST_ASSERT(threw);
+  QNN_TEST_ASSERT(Same(expected[0], router->Submit(Image(6, 0.0f)).get()));
+  QNN_TEST_ASSERT(router->Served() == std::vector<uint64_t>({14}));
+}
+
+static void test_round_robin(void) {
+  // One request at a time: no node is ever busier, so they take turns
+  auto router = FakeRouter(3);
+  for (size_t i = 0; i < 9; ++i) {
+    router->Submit(Image(5, 0.1f)).get();
+    QNN_TEST_ASSERT_EQUAL(i + 1, Total(router->Served()));
+  }
+  QNN_TEST_ASSERT(router->Served() == std::vector<uint64_t>({3, 3, 3}));
+}
+
+static void test_least_loaded(void) {
+  auto router = FakeRouter(3);
+
+  // A long request occupies the first node; the short ones that follow go
+  // around it, each to the first idle node after its turn
+  auto slow = router->Submit(Image(768, 0.5f));
+  for (size_t i = 0; i < 8; ++i) {
+    router->Submit(Image(5, 0.1f)).get();
+  }
+  QNN_TEST_ASSERT(slow.wait_for(std::chrono::seconds(0)) !=
+                  std::future_status::ready);
+  const auto served = router->Served();
+  QNN_TEST_ASSERT_EQUAL(0u, served[0]);
+  QNN_TEST_ASSERT_EQUAL(8u, served[1] + served[2]);
+
+  // Turns 3 and 6 would be the busy node's and go to node 1 instead
+  QNN_TEST_ASSERT_EQUAL(5u, served[1]);
+  QNN_TEST_ASSERT_EQUAL(3u, served[2]);
+
+  slow.get();
+  QNN_TEST_ASSERT(router->Served() == std::vector<uint64_t>({1, 5, 3}));
+}
+
+int main() {
+  QNN_TEST_BEGIN();
+
+  QNN_TEST_RUN(test_parse_cpu_list);
+  QNN_TEST_RUN(test_single_node);
+  QNN_TEST_RUN(test_round_robin);
+  QNN_TEST_RUN(test_least_loaded);
+
+  QNN_TEST_END();
+}
@@ -0,0 +1,153 @@
+/**
+ * @file test_scheduler.cc
+ * @author Leo (zhsleo@outlook.com)
+ *
+ * @brief Work-stealing scheduler ordering, parallelism and errors
+ * @version 1.0.0
+ * @date 2026-10-18
+ */
+
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <set>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+#include "qnn_test.hpp"
+#include "scheduler.hpp"
+
+namespace {
+
+/** @brief Threads that ran chunks of a pool loop started from a task */
+size_t LoopThreads(qnn::ThreadPool& pool) {
+  std::mutex mutex;
+  std::set<std::thread::id> threads;
+  pool.ParallelFor(32, [&](size_t, size_t) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    std::lock_guard<std::mutex> lock(mutex);
+    threads.insert(std::this_thread::get_id());
+  });
+  return threads.size();
+}
+
+/** @brief Diamond 0 -> {1, 2} -> 3 */
+qnn::TaskGraph Diamond() {
+  qnn::TaskGraph graph;
+  graph.Resize(4);
+  graph.AddEdge(0, 1);
+  graph.AddEdge(0, 2);
+  graph.AddEdge(1, 3);
+  graph.AddEdge(2, 3);
+  return graph;
+}
+
+}  // namespace
+
+static void test_scheduler_order(void) {
+  qnn::ThreadPool pool(4);
+  qnn::WorkStealingScheduler scheduler;
+  // Wide layered graph; every task checks its predecessors finished
+  qnn::TaskGraph graph;
+  const size_t width = 6, depth = 5;
+  graph.Resize(width * depth);
+  for (size_t d = 1; d < depth; ++d) {
+    for (size_t i = 0; i < width; ++i) {
+      graph.AddEdge((d - 1) * width + i, d * width + i);
+      graph.AddEdge((d - 1) * width + (i + 1) % width, d * width + i);
+    }
+  }
+  std::vector<std::atomic<bool>> done(graph.size());
+  std::atomic<int> violations{0};
+  for (int run = 0; run < 20; ++run) {
+    for (auto& flag : done) {
+      flag = false;
+    }
+    scheduler.Run(
+        graph,
+        [&](size_t task) {
+          if (task >= width) {
+            const size_t d = task / width, i = task % width;
+            violations += !done[(d - 1) * width + i] ||
+                          !done[(d - 1) * width + (i + 1) % width];
+          }
+          done[task] = true;
+        },
+        &pool);
+    for (auto& flag : done) {
+      QNN_TEST_ASSERT(flag);
+    }
+  }
+  QNN_TEST_ASSERT_EQUAL(0, violations.load());
+}
+
+static void test_scheduler_lone_tasks_use_pool(void) {
+  qnn::ThreadPool pool(4);
+  qnn::WorkStealingScheduler scheduler;
+  std::vector<size_t> threads(4, 0);
+  std::atomic<bool> started[2] = {false, false};
+  std::atomic<bool> overlapped{false};
+  scheduler.Run(
+      Diamond(),
+      [&](size_t task) {
+        if (task == 1 || task == 2) {
+          // The branches run side by side on different workers
+          started[task - 1] = true;
+          const auto until =
+              std::chrono::steady_clock::now() + std::chrono::seconds(5);
+          while (!started[2 - task] && std::chrono::steady_clock::now() < until) {
+            std::this_thread::yield();
+          }
+          overlapped = overlapped || started[2 - task];
+        }
+        threads[task] = LoopThreads(pool);
+      },
+      &pool);
+  QNN_TEST_ASSERT(overlapped);
+  // The entry and the join run alone, so their loops use the workers;
+  // the branches run theirs serially
+  QNN_TEST_ASSERT(threads[0] > 1);
+  QNN_TEST_ASSERT(threads[3] > 1);
+  QNN_TEST_ASSERT_EQUAL(1, threads[1]);
+  QNN_TEST_ASSERT_EQUAL(1, threads[2]);
+}
+
+static void test_scheduler_error(void) {
+  qnn::ThreadPool pool(4);
+  qnn::WorkStealingScheduler scheduler;
+  std::atomic<bool> ran_join{false};
+  bool thrown = false;
+  try {
+    scheduler.Run(
+        Diamond(),
+        [&](size_t task) {
+          if (task == 2) {
+            throw std::runtime_error("task failed");
+          }
+          if (task == 3) {
+            ran_join = true;
+          }
+        },
+        &pool);
+  } catch (const std::runtime_error&) {
+    thrown = true;
+  }
+  QNN_TEST_ASSERT(thrown);
+  QNN_TEST_ASSERT(!ran_join);
+
+  // The scheduler and the pool are usable afterwards
+  std::atomic<int> count{0};
+  scheduler.Run(Diamond(), [&](size_t) { count++; }, &pool);
+  QNN_TEST_ASSERT_EQUAL(4, count.load());
+}
+
+int main() {
+  QNN_TEST_BEGIN();
+
+  QNN_TEST_RUN(test_scheduler_order);
+  QNN_TEST_RUN(test_scheduler_lone_tasks_use_pool);
+  QNN_TEST_RUN(test_scheduler_error);
+
+  QNN_TEST_END();
+}
@@ -0,0 +1,354 @@
+/**
+ * @file test_serving.cc
+ * @author Leo (zhsleo@outlook.com)
+ *
+ * @brief Batch latency model, batch limit controller and deadline batching
+ * @version 1.0.0
+ * @date 2026-10-18
+ */
+
+#include <chrono>
+#include <cmath>
+#include <future>
+#include <thread>
+#include <variant>
+#include <vector>
+
+#include "qnn_test.hpp"
+#include "serving.hpp"
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+using std::chrono::milliseconds;
+using std::chrono::seconds;
+
+bool Near(double a, double b) { return std::abs(a - b) < 1e-9 * (1 + b); }
+
+/** @brief QuantStub and one Conv2d, fast enough to serve in microseconds */
+qnn::json FastLayers() {
+  qnn::json layers = qnn::json::array();
+  layers.push_back(
+      {{"type", "QuantStub"}, {"name", "quant"}, {"scale", 0.05f}});
+  layers.push_back(
+      qnn_test::ConvJson("conv", 3, 4, 3, 1, 1, true, 0.125f, 5));
+  return layers;
+}
+
+/** @brief Three 32-channel Conv2d layers, tens of milliseconds on 96x96 */
+qnn::json SlowLayers() {
+  qnn::json layers = qnn::json::array();
+  layers.push_back(
+      {{"type", "QuantStub"}, {"name", "quant"}, {"scale", 0.05f}});
+  layers.push_back(
+      qnn_test::ConvJson("conv1", 3, 32, 3, 1, 1, true, 0.125f, 1));
+  layers.push_back(
+      qnn_test::ConvJson("conv2", 32, 32, 3, 1, 1, true, 0.125f, 2));
+  layers.push_back(
+      qnn_test::ConvJson("conv3", 32, 32, 3, 1, 1, true, 0.125f, 3));
+  return layers;
+}
+
+/** @brief Float input [1, 3, size, size] */
+qnn::Tensor<float> Input(size_t size, size_t seed) {
+  qnn::Tensor<float> input;
+  input.resize(std::vector<size_t>{1, 3, size, size});
+  for (size_t i = 0; i < input.size(); ++i) {
+    input.data()[i] = static_cast<float>((i * 7 + seed) % 19) * 0.1f - 0.9f;
+  }
+  return input;
+}
+
+/** @brief Completion time of a request submitted at submitted */
+Clock::time_point Finished(Clock::time_point submitted,
+                           const qnn::ServeResult& result) {
+  return submitted + std::chrono::duration_cast<Clock::duration>(
+                         std::chrono::duration<double, std::micro>(
+                             result.latency_us));
+}
+
+/** @brief Latency window of scale, 2 * scale, ..., count * scale, reversed */
+std::vector<double> Window(size_t count, double scale) {
+  std::vector<double> window(count);
+  for (size_t i = 0; i < count; ++i) {
+    window[count - 1 - i] = (i + 1) * scale;
+  }
+  return window;
+}
+
+}  // namespace
+
+static void test_latency_model_ewma(void) {
+  qnn::BatchLatencyModel model(8, 0.2);
+  QNN_TEST_ASSERT(model.Predict(2) == 0.0);
+
+  model.Observe(2, 100.0);
+  QNN_TEST_ASSERT(Near(model.Predict(2), 100.0));
+  model.Observe(2, 200.0);
+  QNN_TEST_ASSERT(Near(model.Predict(2), 0.8 * 100.0 + 0.2 * 200.0));
+
+  // Sizes out of range are ignored
+  model.Observe(0, 1e6);
+  model.Observe(9, 1e6);
+  QNN_TEST_ASSERT(Near(model.Predict(2), 120.0));
+}
+
+static void test_latency_model_line_fit(void) {
+  // One size seen: other sizes in proportion
+  qnn::BatchLatencyModel single(8);
+  single.Observe(4, 400.0);
+  QNN_TEST_ASSERT(Near(single.Predict(2), 200.0));
+  QNN_TEST_ASSERT(Near(single.Predict(8), 800.0));
+
+  // Two sizes seen: the line through them, intercept included
+  qnn::BatchLatencyModel line(8);
+  line.Observe(1, 150.0);
+  line.Observe(3, 250.0);
+  QNN_TEST_ASSERT(Near(line.Predict(2), 200.0));
+  QNN_TEST_ASSERT(Near(line.Predict(6), 400.0));
+
+  // Least squares through three points; seen sizes keep their own mean
+  qnn::BatchLatencyModel fit(8);
+  fit.Observe(1, 100.0);
+  fit.Observe(2, 220.0);
+  fit.Observe(3, 300.0);
+  QNN_TEST_ASSERT(Near(fit.Predict(2), 220.0));
+  // slope 100, intercept 6.67
+  QNN_TEST_ASSERT(Near(fit.Predict(5), 20.0 / 3 + 500.0));
+
+  // A line below zero is clamped
+  qnn::BatchLatencyModel falling(8);
+  falling.Observe(1, 300.0);
+  falling.Observe(2, 100.0);
+  QNN_TEST_ASSERT(falling.Predict(8) == 0.0);
+}
+
+static void test_latency_model_bound(void) {
+  qnn::BatchLatencyModel model(8, 0.2);
+  model.Observe(2, 100.0);
+  // No prediction to compare the first observation with
+  QNN_TEST_ASSERT(Near(model.Bound(2), 100.0));
+
+  // Predicted 100, took 150: 50% error, averaged in with weight 0.2
+  model.Observe(2, 150.0);
+  const double mean = 0.8 * 100.0 + 0.2 * 150.0;
+  QNN_TEST_ASSERT(Near(model.Bound(2), mean * (1 + 2 * 0.1)));
+
+  // The bound scales the prediction of unseen sizes too
+  QNN_TEST_ASSERT(Near(model.Bound(4), 2 * mean * 1.2));
+}
+
+static void test_limiter_grows_under_target(void) {
+  qnn::ServerOptions options;
+  options.max_batch = 3;
+  options.p99_target_us = 1000.0;
+  qnn::BatchLimiter limiter(options);
+  qnn::BatchLatencyModel latency(options.max_batch);
+  QNN_TEST_ASSERT_EQUAL(1u, limiter.limit());
+
+  // p99 of 1..200 us is the 199th value
+  for (size_t step = 0; step < 4; ++step) {
+    std::vector<double> window = Window(200, 1.0);
+    QNN_TEST_ASSERT(limiter.Adapt(window, latency) == 199.0);
+  }
+  QNN_TEST_ASSERT_EQUAL(3u, limiter.limit());
+
+  // Between 70% and 100% of the target the limit holds
+  qnn::BatchLimiter hold(options);
+  std::vector<double> window = Window(100, 8.0);
+  QNN_TEST_ASSERT(hold.Adapt(window, latency) == 800.0);
+  QNN_TEST_ASSERT_EQUAL(1u, hold.limit());
+}
+
+static void test_limiter_over_target(void) {
+  qnn::ServerOptions options;
+  options.max_batch = 16;
+  options.p99_target_us = 1000.0;
+  qnn::BatchLimiter limiter(options);
+  qnn::BatchLatencyModel latency(options.max_batch);
+  latency.Observe(1, 50.0);
+  for (size_t step = 0; step < 7; ++step) {
+    std::vector<double> window = Window(10, 1.0);
+    limiter.Adapt(window, latency);
+  }
+  QNN_TEST_ASSERT_EQUAL(8u, limiter.limit());
+
+  // Over target with batches leaving part full: cut by a quarter
+  limiter.Record(3);
+  limiter.Record(8);
+  limiter.Record(5);
+  std::vector<double> window = Window(10, 200.0);
+  QNN_TEST_ASSERT(limiter.Adapt(window, latency) == 2000.0);
+  QNN_TEST_ASSERT_EQUAL(6u, limiter.limit());
+
+  // Over target, most batches full and a larger batch is quick: queueing,
+  // so keep growing
+  limiter.Record(6);
+  limiter.Record(6);
+  limiter.Record(2);
+  window = Window(10, 200.0);
+  limiter.Adapt(window, latency);
+  QNN_TEST_ASSERT_EQUAL(7u, limiter.limit());
+
+  // Full batches, but a larger batch alone takes half the target: cut
+  latency.Observe(8, 500.0);
+  limiter.Record(7);
+  limiter.Record(7);
+  window = Window(10, 200.0);
+  limiter.Adapt(window, latency);
+  QNN_TEST_ASSERT_EQUAL(5u, limiter.limit());
+
+  // Never below one
+  qnn::BatchLatencyModel slow(options.max_batch);
+  slow.Observe(1, 1000.0);
+  for (size_t step = 0; step < 8; ++step) {
+    window = Window(10, 200.0);
+    limiter.Adapt(window, slow);
+  }
+  QNN_TEST_ASSERT_EQUAL(1u, limiter.limit());
+}
+
+static void test_limiter_fixed(void) {
+  qnn::ServerOptions options;
+  options.max_batch = 4;
+  options.adaptive = false;
+  qnn::BatchLimiter limiter(options);
+  qnn::BatchLatencyModel latency(options.max_batch);
+  QNN_TEST_ASSERT_EQUAL(4u, limiter.limit());
+  std::vector<double> window = Window(10, 1e6);
+  QNN_TEST_ASSERT(limiter.Adapt(window, latency) == 1e7);
+  QNN_TEST_ASSERT_EQUAL(4u, limiter.limit());
+}
+
+static void test_server_int8_scale(void) {
+  qnn::Model model = qnn_test::LoadModel(FastLayers());
+  qnn::ServerOptions options;
+  options.max_batch = 4;
+  options.window = 4;
+  qnn::BatchServer server(model, options);
+
+  std::vector<std::future<qnn::ServeResult>> futures;
+  for (size_t i = 0; i < 6; ++i) {
+    futures.push_back(server.Submit(Input(8, i), seconds(10)));
+  }
+  std::vector<qnn::ServeResult> results;
+  for (auto& future : futures) {
+    results.push_back(future.get());
+  }
+  const qnn::ServerStats stats = server.Stats();
+
+  for (size_t i = 0; i < results.size(); ++i) {
+    QNN_TEST_ASSERT(results[i].status == qnn::ServeStatus::kOk);
+    const auto& output = std::get<qnn::Tensor<int8_t>>(results[i].output);
+    QNN_TEST_ASSERT(output.scale() == 0.125f);
+    QNN_TEST_ASSERT(output.shape() == std::vector<size_t>({1, 4, 8, 8}));
+
+    // Each request gets its own row
+    model.forward(Input(8, i));
+    const qnn::Tensor<int8_t>& expected = model.QuantizedOutput();
+    QNN_TEST_ASSERT(qnn_test::Equal(
+        output, std::vector<int8_t>(expected.data(),
+                                    expected.data() + expected.size())));
+  }
+
+  QNN_TEST_ASSERT_EQUAL(6u, stats.submitted);
+  QNN_TEST_ASSERT_EQUAL(6u, stats.completed);
+  QNN_TEST_ASSERT(stats.window_p99_us > 0);
+}
+
+static void test_server_earliest_deadline_first(void) {
+  qnn::Model model = qnn_test::LoadModel(SlowLayers());
+  qnn::ServerOptions options;
+  options.max_batch = 1;
+  options.adaptive = false;
+  qnn::BatchServer server(model, options);
+
+  // The first request occupies the dispatcher while the rest queue in
+  // reverse deadline order
+  auto first = server.Submit(Input(96, 0), seconds(20));
+  std::this_thread::sleep_for(milliseconds(10));
+  std::vector<Clock::time_point> submitted;
+  std::vector<std::future<qnn::ServeResult>> futures;
+  for (size_t i = 0; i < 3; ++i) {
+    submitted.push_back(Clock::now());
+    futures.push_back(
+        server.Submit(Input(96, i + 1), seconds(10) - seconds(i)));
+  }
+
+  QNN_TEST_ASSERT(first.get().status == qnn::ServeStatus::kOk);
+  std::vector<Clock::time_point> finished;
+  for (size_t i = 0; i < futures.size(); ++i) {
+    const qnn::ServeResult result = futures[i].get();
+    QNN_TEST_ASSERT(result.status == qnn::ServeStatus::kOk);
+    finished.push_back(Finished(submitted[i], result));
+  }
+  QNN_TEST_ASSERT(finished[2] < finished[1]);
+  QNN_TEST_ASSERT(finished[1] < finished[0]);
+  QNN_TEST_ASSERT_EQUAL(4u, server.Stats().batches);
+}
+
+static void test_server_reject_at_submit(void) {
+  qnn::Model model = qnn_test::LoadModel(SlowLayers());
+  qnn::ServerOptions options;
+  options.max_batch = 1;
+  options.adaptive = false;
+  qnn::BatchServer server(model, options);
+  for (size_t i = 0; i < 2; ++i) {
+    server.Submit(Input(96, i), seconds(20)).get();
+  }
+  QNN_TEST_ASSERT(server.PredictBatch(1) > 1000.0);
+
+  // A budget well under one batch is refused without queueing
+  auto future = server.Submit(Input(96, 0), std::chrono::microseconds(100));
+  QNN_TEST_ASSERT(future.wait_for(std::chrono::seconds(0)) ==
+                  std::future_status::ready);
+  const qnn::ServeResult result = future.get();
+  QNN_TEST_ASSERT(result.status == qnn::ServeStatus::kRejected);
+  QNN_TEST_ASSERT(std::holds_alternative<qnn::Tensor<float>>(result.output));
+
+  const qnn::ServerStats stats = server.Stats();
+  QNN_TEST_ASSERT_EQUAL(3u, stats.submitted);
+  QNN_TEST_ASSERT_EQUAL(1u, stats.rejected);
+  QNN_TEST_ASSERT_EQUAL(2u, stats.batches);
+}
+
+static void test_server_shed_at_dispatch(void) {
+  qnn::Model model = qnn_test::LoadModel(SlowLayers());
+  qnn::ServerOptions options;
+  options.max_batch = 1;
+  options.adaptive = false;
+  qnn::BatchServer server(model, options);
+
+  // Nothing observed yet, so a short budget is admitted, then runs out
+  // behind the first batch
+  auto first = server.Submit(Input(96, 0), seconds(20));
+  std::this_thread::sleep_for(milliseconds(10));
+  auto late = server.Submit(Input(96, 1), milliseconds(2));
+  QNN_TEST_ASSERT(first.get().status == qnn::ServeStatus::kOk);
+  const qnn::ServeResult result = late.get();
+  QNN_TEST_ASSERT(result.status == qnn::ServeStatus::kShed);
+  QNN_TEST_ASSERT(result.missed);
+  QNN_TEST_ASSERT(result.latency_us > 2000.0);
+
+  const qnn::ServerStats stats = server.Stats();
+  QNN_TEST_ASSERT_EQUAL(0u, stats.rejected);
+  QNN_TEST_ASSERT_EQUAL(1u, stats.shed);
+  QNN_TEST_ASSERT_EQUAL(1u, stats.completed);
+}
+
+int main() {
+  QNN_TEST_BEGIN();
+
+  QNN_TEST_RUN(test_latency_model_ewma);
+  QNN_TEST_RUN(test_latency_model_line_fit);
+  QNN_TEST_RUN(test_latency_model_bound);
+  QNN_TEST_RUN(test_limiter_grows_under_target);
+  QNN_TEST_RUN(test_limiter_over_target);
+  QNN_TEST_RUN(test_limiter_fixed);
+  QNN_TEST_RUN(test_server_int8_scale);
+  QNN_TEST_RUN(test_server_earliest_deadline_first);
+  QNN_TEST_RUN(test_server_reject_at_submit);
+  QNN_TEST_RUN(test_server_shed_at_dispatch);
+
+  QNN_TEST_END();
+}
@@ -0,0 +1,238 @@
+/**
+ * @file test_systolic.cc
+ * @author Leo (zhsleo@outlook.com)
+ *
+ * @brief Systolic array golden model and the layer checks built on it
+ * @version 1.0.0
+ * @date 2026-10-18
+ */
+
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+#include "model.hpp"
+#include "operators/conv2d.hpp"
+#include "operators/linear.hpp"
+#include "qnn_test.hpp"
+#include "systolic.hpp"
+
+namespace {
+
+using Conv = qnn::Conv2d<int8_t, int8_t>;
+using Linear = qnn::Linear<int8_t, int8_t>;
+
+/** @brief Exact integer dot product */
+int64_t Exact(const std::vector<int8_t>& a, const std::vector<int8_t>& b) {
+  int64_t sum = 0;
+  for (size_t i = 0; i < a.size(); ++i) {
+    sum += int64_t{a[i]} * b[i];
+  }
+  return sum;
+}
+
+/** @brief Array with a 17-bit accumulator */
+qnn::SystolicSpec Narrow() {
+  qnn::SystolicSpec spec;
+  spec.array_size = 1;
+  return spec;
+}
+
+/** @brief Linear layer [out_features, in_features] with every weight 127 */
+qnn::json SaturatingLinear(size_t in_features, size_t out_features) {
+  qnn::json j;
+  j["name"] = "fc";
+  j["type"] = "Linear";
+  j["weight"] = qnn_test::WeightJson(
+      {out_features, in_features},
+      std::vector<int8_t>(out_features * in_features, 127),
+      qnn_test::Scales(out_features));
+  j["scale"] = 0.5f;
+  return j;
+}
+
+}  // namespace
+
+static void test_dot_signed(void) {
+  const qnn::SystolicModel model;
+  QNN_TEST_ASSERT(model.spec().signed_operands);
+  QNN_TEST_ASSERT_EQUAL(24u, model.spec().accumulator_bits());
+
+  // Sums inside 24 bits are exact
+  bool exact = true;
+  for (uint32_t k = 1; k <= 64; ++k) {
+    const auto a = qnn_test::Values(k, k);
+    const auto b = qnn_test::Values(k, 1000 + k);
+    exact = exact && model.Dot(a.data(), b.data(), k) == Exact(a, b);
+  }
+  QNN_TEST_ASSERT(exact);
+
+  const std::vector<int8_t> minus_one = {-1, -1};
+  const std::vector<int8_t> mixed = {-128, 2};
+  QNN_TEST_ASSERT_EQUAL(2, model.Dot(minus_one.data(), minus_one.data(), 2));
+  QNN_TEST_ASSERT_EQUAL(126, model.Dot(mixed.data(), minus_one.data(), 2));
+}
+
+static void test_dot_wrap_around(void) {
+  const qnn::SystolicModel model;
+  const std::vector<int8_t> low(512, -128);
+
+  // 511 * 16384 fits in 24 signed bits; 512 * 16384 = 2^23 wraps to -2^23
+  QNN_TEST_ASSERT_EQUAL(511 * 16384, model.Dot(low.data(), low.data(), 511));
+  QNN_TEST_ASSERT_EQUAL(-8388608, model.Dot(low.data(), low.data(), 512));
+
+  // 17-bit accumulator: 16 * 127 * 127 = 258064 wraps to 258064 - 2 * 2^17
+  const qnn::SystolicModel narrow(Narrow());
+  QNN_TEST_ASSERT_EQUAL(17u, narrow.spec().accumulator_bits());
+  const std::vector<int8_t> high(16, 127);
+  QNN_TEST_ASSERT_EQUAL(-4080, narrow.Dot(high.data(), high.data(), 16));
+
+  // Wrapping is associative, so the order of the terms does not matter
+  auto a = qnn_test::Values(200, 5);
+  auto b = qnn_test::Values(200, 6);
+  const int64_t forward = narrow.Dot(a.data(), b.data(), a.size());
+  std::reverse(a.begin(), a.end());
+  std::reverse(b.begin(), b.end());
+  QNN_TEST_ASSERT_EQUAL(forward, narrow.Dot(a.data(), b.data(), a.size()));
+  const int64_t exact = Exact(a, b);
+  QNN_TEST_ASSERT_EQUAL(0, (exact - forward) % (int64_t{1} << 17));
+  QNN_TEST_ASSERT(forward >= -65536 && forward < 65536);
+}
+
+static void test_dot_unsigned(void) {
+  qnn::SystolicSpec spec;
+  spec.signed_operands = false;
+  const qnn::SystolicModel model(spec);
+
+  // Lanes carry the bit patterns: -1 is 255 and -128 is 128
+  const std::vector<int8_t> minus_one(9, -1);
+  const std::vector<int8_t> mixed = {-128, 2};
+  QNN_TEST_ASSERT_EQUAL(65025,
+                        model.Dot(minus_one.data(), minus_one.data(), 1));
+  QNN_TEST_ASSERT_EQUAL(128 * 255 + 2 * 255,
+                        model.Dot(mixed.data(), minus_one.data(), 2));
+
+  // On a 3x3 array, 9 * 65025 = 585225 wraps modulo 2^19 and stays
+  // non-negative
+  spec.array_size = 3;
+  const qnn::SystolicModel narrow(spec);
+  QNN_TEST_ASSERT_EQUAL(585225 - 524288,
+                        narrow.Dot(minus_one.data(), minus_one.data(), 9));
+}
+
+static void test_layer_check(void) {
+  qnn::LayerCheck check;
+  check.Add(100, 100, 5, 5);
+  check.Add(-7, 9, 3, 3);
+  check.Add(50, 40, 1, 2);
+  QNN_TEST_ASSERT_EQUAL(3u, check.elements);
+  QNN_TEST_ASSERT_EQUAL(2u, check.accumulator_mismatches);
+  QNN_TEST_ASSERT_EQUAL(1u, check.output_mismatches);
+  QNN_TEST_ASSERT_EQUAL(16, check.max_accumulator_error);
+
+  qnn::LayerCheck other;
+  other.Add(0, 1000, -4, 4);
+  check.Merge(other);
+  QNN_TEST_ASSERT_EQUAL(4u, check.elements);
+  QNN_TEST_ASSERT_EQUAL(3u, check.accumulator_mismatches);
+  QNN_TEST_ASSERT_EQUAL(2u, check.output_mismatches);
+  QNN_TEST_ASSERT_EQUAL(1000, check.max_accumulator_error);
+}
+
+static void test_conv_verify(void) {
+  const qnn::json j =
+      qnn_test::ConvJson("conv", 3, 8, 3, 1, 1, true, 0.05f, 3);
+  auto conv = Conv::LoadFromJson(j);
+  qnn::Tensor<int8_t> input, output;
+  qnn_test::FillInput({2, 3, 10, 10}, 0.02f, 4, input);
+  conv->Forward(input, output);
+
+  // Signed operands reproduce the CPU kernel exactly, padding included
+  const auto check = conv->Verify(input, output, qnn::SystolicModel());
+  QNN_TEST_ASSERT(check.has_value());
+  QNN_TEST_ASSERT_EQUAL(2u * 8 * 10 * 10, check->elements);
+  QNN_TEST_ASSERT_EQUAL(0u, check->accumulator_mismatches);
+  QNN_TEST_ASSERT_EQUAL(0u, check->output_mismatches);
+
+  // The RTL's unsigned product does not
+  qnn::SystolicSpec unsigned_spec;
+  unsigned_spec.signed_operands = false;
+  const auto raw =
+      conv->Verify(input, output, qnn::SystolicModel(unsigned_spec));
+  QNN_TEST_ASSERT(raw->accumulator_mismatches > 0);
+  QNN_TEST_ASSERT(raw->output_mismatches > 0);
+
+  // Through a model with every request sampled
+  qnn::json layers = qnn::json::array();
+  layers.push_back(
+      {{"type", "QuantStub"}, {"name", "quant"}, {"scale", 0.02f}});
+  layers.push_back(j);
+  qnn::Model model = qnn_test::LoadModel(layers);
+  model.EnableVerification(1.0);
+  qnn::Tensor<float> image;
+  image.resize(std::vector<size_t>{1, 3, 10, 10});
+  for (size_t i = 0; i < image.size(); ++i) {
+    image.data()[i] = static_cast<float>(i % 23) * 0.2f - 2.2f;
+  }
+  model.forward(image);
+  model.forward(image);
+  const auto report = model.VerificationReport();
+  QNN_TEST_ASSERT_EQUAL(1u, report.size());
+  QNN_TEST_ASSERT(report[0].name == "conv");
+  QNN_TEST_ASSERT_EQUAL(2u, report[0].samples);
+  QNN_TEST_ASSERT_EQUAL(2u * 8 * 10 * 10, report[0].totals.elements);
+  QNN_TEST_ASSERT_EQUAL(0u, report[0].totals.accumulator_mismatches);
+  QNN_TEST_ASSERT_EQUAL(0u, report[0].totals.output_mismatches);
+}
+
+static void test_linear_verify(void) {
+  const qnn::json j = qnn::json{
+      {"name", "fc"},
+      {"type", "Linear"},
+      {"weight",
+       qnn_test::WeightJson({24, 64}, qnn_test::Values(24 * 64, 8),
+                            qnn_test::Scales(24))},
+      {"scale", 0.1f}};
+  auto linear = Linear::LoadFromJson(j);
+  qnn::Tensor<int8_t> input, output;
+  qnn_test::FillInput({3, 64}, 0.05f, 9, input);
+  linear->Forward(input, output);
+
+  const auto check = linear->Verify(input, output, qnn::SystolicModel());
+  QNN_TEST_ASSERT(check.has_value());
+  QNN_TEST_ASSERT_EQUAL(3u * 24, check->elements);
+  QNN_TEST_ASSERT_EQUAL(0u, check->accumulator_mismatches);
+  QNN_TEST_ASSERT_EQUAL(0u, check->output_mismatches);
+
+  // Every accumulator is 16 * 127 * 127: exact on 24 bits, wrapped on 17
+  auto saturating = Linear::LoadFromJson(SaturatingLinear(16, 4));
+  qnn::Tensor<int8_t> high;
+  high.resize(std::vector<size_t>{2, 16});
+  high.set_scale(0.01f);
+  std::fill(high.data(), high.data() + high.size(), int8_t{127});
+  saturating->Forward(high, output);
+
+  const auto wide = saturating->Verify(high, output, qnn::SystolicModel());
+  QNN_TEST_ASSERT_EQUAL(0u, wide->accumulator_mismatches);
+  QNN_TEST_ASSERT_EQUAL(0u, wide->output_mismatches);
+
+  const auto narrow =
+      saturating->Verify(high, output, qnn::SystolicModel(Narrow()));
+  QNN_TEST_ASSERT_EQUAL(8u, narrow->elements);
+  QNN_TEST_ASSERT_EQUAL(8u, narrow->accumulator_mismatches);
+  QNN_TEST_ASSERT_EQUAL(8u, narrow->output_mismatches);
+  QNN_TEST_ASSERT_EQUAL(258064 + 4080, narrow->max_accumulator_error);
+}
+
+int main() {
+  QNN_TEST_BEGIN();
+
+  QNN_TEST_RUN(test_dot_signed);
+  QNN_TEST_RUN(test_dot_wrap_around);
+  QNN_TEST_RUN(test_dot_unsigned);
+  QNN_TEST_RUN(test_layer_check);
+  QNN_TEST_RUN(test_conv_verify);
+  QNN_TEST_RUN(test_linear_verify);
+
+  QNN_TEST_END();
+}
@@ -0,0 +1,151 @@
+/**
+ * @file test_tiling.cc
+ * @author Leo (zhsleo@outlook.com)
+ *
+ * @brief Depth-first tiled chains against layer-by-layer execution
+ * @version 1.0.0
+ * @date 2026-10-18
+ */
+
+#include <memory>
+#include <vector>
+
+#include "jit.hpp"
+#include "operators/conv2d.hpp"
+#include "operators/maxpool2d.hpp"
+#include "operators/relu.hpp"
+#include "qnn_test.hpp"
+#include "tiling.hpp"
+
+namespace {
+
+using Op = qnn::Operator<int8_t, int8_t>;
+using Layers = std::vector<std::unique_ptr<Op>>;
+
+std::unique_ptr<Op> Conv(size_t in_channels, size_t out_channels,
+                         size_t kernel, size_t stride, size_t padding,
+                         uint32_t seed) {
+  return qnn::Conv2d<int8_t, int8_t>::LoadFromJson(qnn_test::ConvJson(
+      "conv" + std::to_string(seed), in_channels, out_channels, kernel,
+      stride, padding, true, 0.05f, seed));
+}
+
+std::unique_ptr<Op> MaxPool(size_t kernel, size_t stride,
+                            size_t padding = 0) {
+  qnn::json j;
+  j["name"] = "pool";
+  j["kernel_size"] = kernel;
+  j["stride"] = stride;
+  j["padding"] = padding;
+  return qnn::MaxPool2d<int8_t, int8_t>::LoadFromJson(j);
+}
+
+std::unique_ptr<Op> ReLU() {
+  qnn::json j;
+  j["name"] = "relu";
+  return qnn::ReLU<int8_t, int8_t>::LoadFromJson(j);
+}
+
+/** @brief Run the layers one after another on whole feature maps */
+void Untiled(const Layers& layers, const qnn::Tensor<int8_t>& input,
+             qnn::Tensor<int8_t>& output) {
+  layers[0]->Forward(input, output);
+  for (size_t l = 1; l < layers.size(); ++l) {
+    qnn::Tensor<int8_t> next;
+    layers[l]->Forward(output, next);
+    output = std::move(next);
+  }
+}
+
+/**
+ * @brief Compare a tiled chain with layer-by-layer execution
+ *
+ * Every budget is run twice, so the second run reuses the cached plans,
+ * with generated kernels on and off.
+ */
+void CheckChain(const Layers& layers, const std::vector<size_t>& shape) {
+  qnn::Tensor<int8_t> input;
+  qnn_test::FillInput(shape, 0.02f, 7, input);
+  std::vector<Op*> ops;
+  for (const auto& layer : layers) {
+    ops.push_back(layer.get());
+  }
+
+  for (bool jit : {false, true}) {
+    qnn::jit::SetEnabled(jit);
+    qnn::Tensor<int8_t> expected;
+    Untiled(layers, input, expected);
+    const std::vector<int8_t> values(expected.data(),
+                                     expected.data() + expected.size());
+    for (size_t budget : {size_t{64}, size_t{512}, size_t{4096},
+                          size_t{1} << 20}) {
+      qnn::TiledChain chain(ops, shape, budget);
+      QNN_TEST_ASSERT(chain.output_shape() == expected.shape());
+      for (int run = 0; run < 2; ++run) {
+        qnn::Tensor<int8_t> output;
+        chain.Forward(input, output);
+        QNN_TEST_ASSERT(output.shape() == expected.shape());
+        QNN_TEST_ASSERT(qnn_test::Equal(output, values));
+        QNN_TEST_ASSERT_EQUAL(expected.scale(), output.scale());
+      }
+    }
+  }
+  qnn::jit::SetEnabled(true);
+}
+
+}  // namespace
+
+static void test_tiling_conv_chain(void) {
+  Layers layers;
+  layers.push_back(Conv(3, 8, 3, 1, 1, 1));
+  layers.push_back(ReLU());
+  layers.push_back(Conv(8, 5, 3, 2, 1, 2));
+  layers.push_back(Conv(5, 6, 3, 1, 0, 3));
+  CheckChain(layers, {2, 3, 17, 14});
+}
+
+static void test_tiling_pool_chain(void) {
+  Layers layers;
+  layers.push_back(Conv(4, 6, 3, 1, 1, 4));
+  layers.push_back(MaxPool(2, 2));
+  layers.push_back(ReLU());
+  layers.push_back(Conv(6, 9, 3, 1, 1, 5));
+  CheckChain(layers, {1, 4, 19, 23});
+}
+
+static void test_tiling_padded_pool(void) {
+  // Tiles on the border see the padding, interior ones do not
+  Layers layers;
+  layers.push_back(Conv(3, 6, 3, 1, 1, 10));
+  layers.push_back(MaxPool(3, 2, 1));
+  layers.push_back(Conv(6, 4, 3, 1, 1, 11));
+  layers.push_back(MaxPool(2, 1, 1));
+  CheckChain(layers, {2, 3, 21, 16});
+}
+
+static void test_tiling_padding_past_kernel(void) {
+  // Border outputs of the 1x1 convolution read only padding, so their
+  // input region, and those of the layers before it, are empty
+  Layers layers;
+  layers.push_back(Conv(4, 7, 3, 1, 1, 6));
+  layers.push_back(MaxPool(2, 2));
+  layers.push_back(Conv(7, 4, 1, 1, 1, 7));
+  CheckChain(layers, {1, 4, 30, 9});
+
+  Layers wide;
+  wide.push_back(ReLU());
+  wide.push_back(Conv(3, 5, 1, 1, 2, 8));
+  wide.push_back(Conv(5, 4, 3, 2, 3, 9));
+  CheckChain(wide, {2, 3, 11, 8});
+}
+
+int main() {
+  QNN_TEST_BEGIN();
+
+  QNN_TEST_RUN(test_tiling_conv_chain);
+  QNN_TEST_RUN(test_tiling_pool_chain);
+  QNN_TEST_RUN(test_tiling_padded_pool);
+  QNN_TEST_RUN(test_tiling_padding_past_kernel);
+
+  QNN_TEST_END();
+}
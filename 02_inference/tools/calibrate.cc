@@ -0,0 +1,236 @@
+/**
+ * @file calibrate.cc
+ * @author Leo (zhsleo@outlook.com)
+ *
+ * @brief Post-training calibration of a float model into an int8 qnn model
+ * @version 1.0.0
+ * @date 2026-10-18
+ */
+
+#define STB_IMAGE_IMPLEMENTATION
+#include <fmt/format.h>
+#include <spdlog/spdlog.h>
+#include <stb_image.h>
+
+#include <algorithm>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <variant>
+#include <vector>
+
+#include "calibration.hpp"
+#include "model.hpp"
+
+namespace {
+
+void usage(const char* prog) {
+  fmt::print(
+      "Usage: {} [options] <float_model.json> [image...]\n"
+      "  -o FILE            Quantized model output (default model_int8.json)\n"
+      "  --list FILE        Read image paths from FILE, one per line\n"
+      "  --input CxHxW      Input shape (default 1x28x28)\n"
+      "  --method NAME      minmax, percentile or kl (default minmax)\n"
+      "  --percentile P     Percentile for --method percentile "
+      "(default 99.99)\n"
+      "  --threads N        Worker threads (default: one per core)\n"
+      "  --check N          Images compared against the float model "
+      "(default 100)\n",
+      prog);
+}
+
+size_t parse_count(const std::string& text) {
+  size_t value = std::stoull(text);
+  if (value == 0) {
+    throw std::invalid_argument("expected a positive number: " + text);
+  }
+  return value;
+}
+
+std::vector<size_t> parse_shape(const std::string& text) {
+  std::vector<size_t> shape;
+  std::stringstream ss(text);
+  std::string item;
+  while (std::getline(ss, item, 'x')) {
+    shape.push_back(parse_count(item));
+  }
+  if (shape.size() != 3) {
+    throw std::invalid_argument("input shape must be CxHxW: " + text);
+  }
+  return shape;
+}
+
+qnn::calib::Method parse_method(const std::string& text) {
+  if (text == "minmax") {
+    return qnn::calib::Method::kMinMax;
+  } else if (text == "percentile") {
+    return qnn::calib::Method::kPercentile;
+  } else if (text == "kl") {
+    return qnn::calib::Method::kKL;
+  }
+  throw std::invalid_argument("unknown calibration method: " + text);
+}
+
+/**
+ * @brief Load an image as normalized NCHW floats of the given [C, H, W]
+ * @throws std::runtime_error If loading fails or the size does not match
+ */
+std::vector<float> load_image(const std::string& path,
+                              const std::vector<size_t>& chw) {
+  int height, width, channels;
+  const int c = static_cast<int>(chw[0]);
+  stbi_uc* img = stbi_load(path.c_str(), &width, &height, &channels, c);
+  if (!img) {
+    throw std::runtime_error("Failed to load image: " + path);
+  }
+  if (static_cast<size_t>(height) != chw[1] ||
+      static_cast<size_t>(width) != chw[2]) {
+    stbi_image_free(img);
+    throw std::runtime_error(fmt::format("Image {} is {}x{}, expected {}x{}",
+                                         path, height, width, chw[1], chw[2]));
+  }
+
+  // Interleaved HWC pixels to planar CHW in [0, 1]
+  std::vector<float> data(chw[0] * chw[1] * chw[2]);
+  const size_t plane = chw[1] * chw[2];
+  for (size_t i = 0; i < plane; ++i) {
+    for (size_t ch = 0; ch < chw[0]; ++ch) {
+      data[ch * plane + i] = img[i * chw[0] + ch] / 255.0f;
+    }
+  }
+  stbi_image_free(img);
+  return data;
+}
+
+template <typename T>
+size_t argmax(const T* data, size_t n) {
+  return std::max_element(data, data + n) - data;
+}
+
+}  // namespace
+
+int main(int argc, char* argv[]) {
+  std::vector<size_t> input_shape = {1, 28, 28};
+  qnn::calib::Options options;
+  size_t check = 100;
+  std::string output = "model_int8.json";
+  std::string model_path;
+  std::vector<std::string> images;
+
+  try {
+    for (int i = 1; i < argc; ++i) {
+      std::string arg = argv[i];
+      auto value = [&]() -> std::string {
+        if (i + 1 >= argc) {
+          throw std::invalid_argument("missing value for " + arg);
+        }
+        return argv[++i];
+      };
+
+      if (arg == "-o") {
+        output = value();
+      } else if (arg == "--list") {
+        std::ifstream list(value());
+        if (!list.is_open()) {
+          throw std::invalid_argument("cannot open image list");
+        }
+        for (std::string line; std::getline(list, line);) {
+          if (!line.empty()) {
+            images.push_back(line);
+          }
+        }
+      } else if (arg == "--input") {
+        input_shape = parse_shape(value());
+      } else if (arg == "--method") {
+        options.method = parse_method(value());
+      } else if (arg == "--percentile") {
+        options.percentile = std::stod(value());
+        if (options.percentile <= 0.0 || options.percentile > 100.0) {
+          throw std::invalid_argument("percentile must be in (0, 100]");
+        }
+      } else if (arg == "--threads") {
+        options.threads = parse_count(value());
+      } else if (arg == "--check") {
+        check = std::stoull(value());
+      } else if (arg == "-h" || arg == "--help") {
+        usage(argv[0]);
+        return 0;
+      } else if (!arg.empty() && arg[0] == '-') {
+        throw std::invalid_argument("unknown option " + arg);
+      } else if (model_path.empty()) {
+        model_path = arg;
+      } else {
+        images.push_back(arg);
+      }
+    }
+  } catch (const std::exception& e) {
+    spdlog::error("{}", e.what());
+    usage(argv[0]);
+    return 1;
+  }
+
+  if (model_path.empty() || images.empty()) {
+    usage(argv[0]);
+    return 1;
+  }
+
+  try {
+    const std::vector<size_t> shape = {1, input_shape[0], input_shape[1],
+                                       input_shape[2]};
+    auto float_model = qnn::calib::FloatModel::Load(model_path);
+    auto load = [&](size_t i) { return load_image(images[i], input_shape); };
+
+    spdlog::info("Calibrating {} on {} images", model_path, images.size());
+    auto result = qnn::calib::Calibrate(float_model, images.size(), load,
+                                        shape, options);
+
+    fmt::print("{:<16} {:<10} {:>12}\n", "layer", "type", "scale");
+    fmt::print("{:<16} {:<10} {:>12.6g}\n", "input", "QuantStub",
+               result.input_scale);
+    const auto& layers = float_model.layers();
+    for (size_t i = 0; i < layers.size(); ++i) {
+      if (result.output_scales[i] > 0.0f) {
+        fmt::print("{:<16} {:<10} {:>12.6g}\n", layers[i].name,
+                   layers[i].type, result.output_scales[i]);
+      }
+    }
+
+    std::ofstream out(output);
+    if (!out.is_open()) {
+      throw std::runtime_error("Failed to open output file: " + output);
+    }
+    out << qnn::calib::QuantizeModel(float_model, result).dump() << "\n";
+    out.close();
+    fmt::print("\nWrote {}\n", output);
+
+    // Top-1 agreement between the float and the quantized model
+    check = std::min(check, images.size());
+    if (check > 0) {
+      auto model = qnn::Model::loadModel(output);
+      size_t agree = 0;
+      for (size_t i = 0; i < check; ++i) {
+        std::vector<float> sample = load(i);
+        auto reference = float_model.Forward(sample, shape, nullptr);
+
+        qnn::Tensor<float> input;
+        input.resize(shape);
+        std::copy(sample.begin(), sample.end(), input.data());
+        auto quantized = model.forward(input);
+
+        const size_t expected = argmax(reference.data(), reference.size());
+        agree += std::visit(
+            [&](const auto& tensor) {
+              return argmax(tensor.data(), tensor.size()) == expected;
+            },
+            quantized);
+      }
+      fmt::print("Top-1 agreement with the float model: {}/{} ({:.1f}%)\n",
+                 agree, check, 100.0 * agree / check);
+    }
+  } catch (const std::exception& e) {
+    spdlog::error("{}", e.what());
+    return 1;
+  }
+
+  return 0;
+}
@@ -0,0 +1,230 @@
+/**
+ * @file cascade.cc
+ * @author Leo (zhsleo@outlook.com)
+ *
+ * @brief Escalation rate, cost and agreement of a model cascade
+ * @version 1.0.0
+ * @date 2026-10-18
+ */
+
+#define STB_IMAGE_IMPLEMENTATION
+#include <fmt/format.h>
+#include <spdlog/spdlog.h>
+#include <stb_image.h>
+
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "cascade.hpp"
+#include "model.hpp"
+
+namespace {
+
+void usage(const char* prog) {
+  fmt::print(
+      "Usage: {} [options] <small.json> ... <large.json>\n"
+      "  --list FILE        Read image paths from FILE, one per line\n"
+      "  --input CxHxW      Input shape (default 1x28x28)\n"
+      "  --batch N          Images per batch (default 16)\n"
+      "  --measure NAME     margin or prob (default margin)\n"
+      "  --threshold T      Confidence threshold of the next stage, once per\n"
+      "                     stage but the last (default 1.0 / 0.9)\n",
+      prog);
+}
+
+size_t parse_count(const std::string& text) {
+  size_t value = std::stoull(text);
+  if (value == 0) {
+    throw std::invalid_argument("expected a positive number: " + text);
+  }
+  return value;
+}
+
+std::vector<size_t> parse_shape(const std::string& text) {
+  std::vector<size_t> shape;
+  std::stringstream ss(text);
+  std::string item;
+  while (std::getline(ss, item, 'x')) {
+    shape.push_back(parse_count(item));
+  }
+  if (shape.size() != 3) {
+    throw std::invalid_argument("input shape must be CxHxW: " + text);
+  }
+  return shape;
+}
+
+qnn::ConfidenceMeasure parse_measure(const std::string& text) {
+  if (text == "margin") {
+    return qnn::ConfidenceMeasure::kMargin;
+  } else if (text == "prob") {
+    return qnn::ConfidenceMeasure::kMaxProbability;
+  }
+  throw std::invalid_argument("unknown confidence measure: " + text);
+}
+
+/**
+ * @brief Load an image as normalized NCHW floats of the given [C, H, W]
+ * @throws std::runtime_error If loading fails or the size does not match
+ */
+std::vector<float> load_image(const std::string& path,
+                              const std::vector<size_t>& chw) {
+  int height, width, channels;
+  const int c = static_cast<int>(chw[0]);
+  stbi_uc* img = stbi_load(path.c_str(), &width, &height, &channels, c);
+  if (!img) {
+    throw std::runtime_error("Failed to load image: " + path);
+  }
+  if (static_cast<size_t>(height) != chw[1] ||
+      static_cast<size_t>(width) != chw[2]) {
+    stbi_image_free(img);
+    throw std::runtime_error(fmt::format("Image {} is {}x{}, expected {}x{}",
+                                         path, height, width, chw[1], chw[2]));
+  }
+
+  // Interleaved HWC pixels to planar CHW in [0, 1]
+  std::vector<float> data(chw[0] * chw[1] * chw[2]);
+  const size_t plane = chw[1] * chw[2];
+  for (size_t i = 0; i < plane; ++i) {
+    for (size_t ch = 0; ch < chw[0]; ++ch) {
+      data[ch * plane + i] = img[i * chw[0] + ch] / 255.0f;
+    }
+  }
+  stbi_image_free(img);
+  return data;
+}
+
+}  // namespace
+
+int main(int argc, char* argv[]) {
+  std::vector<size_t> input_shape = {1, 28, 28};
+  size_t batch = 16;
+  qnn::ConfidenceMeasure measure = qnn::ConfidenceMeasure::kMargin;
+  std::vector<float> thresholds;
+  std::vector<std::string> model_paths;
+  std::vector<std::string> images;
+
+  try {
+    for (int i = 1; i < argc; ++i) {
+      std::string arg = argv[i];
+      auto value = [&]() -> std::string {
+        if (i + 1 >= argc) {
+          throw std::invalid_argument("missing value for " + arg);
+        }
+        return argv[++i];
+      };
+
+      if (arg == "--list") {
+        std::ifstream list(value());
+        if (!list.is_open()) {
+          throw std::invalid_argument("cannot open image list");
+        }
+        for (std::string line; std::getline(list, line);) {
+          if (!line.empty()) {
+            images.push_back(line);
+          }
+        }
+      } else if (arg == "--input") {
+        input_shape = parse_shape(value());
+      } else if (arg == "--batch") {
+        batch = parse_count(value());
+      } else if (arg == "--measure") {
+        measure = parse_measure(value());
+      } else if (arg == "--threshold") {
+        thresholds.push_back(std::stof(value()));
+      } else if (arg == "-h" || arg == "--help") {
+        usage(argv[0]);
+        return 0;
+      } else if (!arg.empty() && arg[0] == '-') {
+        throw std::invalid_argument("unknown option " + arg);
+      } else {
+        model_paths.push_back(arg);
+      }
+    }
+    if (!thresholds.empty() && thresholds.size() + 1 != model_paths.size()) {
+      throw std::invalid_argument("need one threshold per stage but the last");
+    }
+  } catch (const std::exception& e) {
+    spdlog::error("{}", e.what());
+    usage(argv[0]);
+    return 1;
+  }
+
+  if (model_paths.size() < 2 || images.empty()) {
+    usage(argv[0]);
+    return 1;
+  }
+
+  try {
+    const float fallback =
+        measure == qnn::ConfidenceMeasure::kMargin ? 1.0f : 0.9f;
+    thresholds.resize(model_paths.size() - 1, fallback);
+
+    std::vector<qnn::Model> models;
+    for (const auto& path : model_paths) {
+      models.push_back(qnn::Model::loadModel(path));
+    }
+    // The largest model is also run alone, on its own copy, as the baseline
+    qnn::Model reference = qnn::Model::loadModel(model_paths.back());
+
+    qnn::Cascade cascade(measure);
+    for (size_t s = 0; s < models.size(); ++s) {
+      cascade.AddStage(models[s], s < thresholds.size() ? thresholds[s] : 0.0f,
+                       model_paths[s]);
+    }
+
+    const size_t sample = input_shape[0] * input_shape[1] * input_shape[2];
+    size_t agree = 0;
+    double reference_us = 0.0;
+    for (size_t first = 0; first < images.size(); first += batch) {
+      const size_t n = std::min(batch, images.size() - first);
+      qnn::Tensor<float> input;
+      input.resize(std::vector<size_t>{n, input_shape[0], input_shape[1],
+                                       input_shape[2]});
+      for (size_t i = 0; i < n; ++i) {
+        const auto data = load_image(images[first + i], input_shape);
+        std::copy(data.begin(), data.end(), input.data() + i * sample);
+      }
+
+      const auto decisions = cascade.Run(input);
+
+      const auto start = std::chrono::steady_clock::now();
+      reference.forward(input);
+      const std::chrono::duration<double, std::micro> elapsed =
+          std::chrono::steady_clock::now() - start;
+      reference_us += elapsed.count();
+
+      const auto& logits = reference.QuantizedOutput();
+      const size_t classes = logits.size() / n;
+      for (size_t i = 0; i < n; ++i) {
+        const int8_t* row = logits.data() + i * classes;
+        const size_t expected = std::max_element(row, row + classes) - row;
+        agree += decisions[i].prediction == expected;
+      }
+    }
+
+    const size_t total = cascade.requests();
+    fmt::print("{:<24} {:>10} {:>10} {:>10} {:>12}\n", "stage", "inputs",
+               "escalated", "rate", "us/input");
+    for (const auto& m : cascade.Metrics()) {
+      fmt::print("{:<24} {:>10} {:>10} {:>9.1f}% {:>12.1f}\n", m.name,
+                 m.samples, m.escalated, 100.0 * m.escalation_rate(),
+                 m.mean_us());
+    }
+    fmt::print("\nCost per input: {:.1f} us cascade, {:.1f} us largest model "
+               "alone\n",
+               cascade.mean_cost_us(), reference_us / total);
+    fmt::print("Mean latency per input: {:.1f} us\n",
+               cascade.mean_latency_us());
+    fmt::print("Top-1 agreement with the largest model: {}/{} ({:.1f}%)\n",
+               agree, total, 100.0 * agree / total);
+  } catch (const std::exception& e) {
+    spdlog::error("{}", e.what());
+    return 1;
+  }
+
+  return 0;
+}
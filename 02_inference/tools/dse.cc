@@ -0,0 +1,244 @@
+/**
+ * @file dse.cc
+ * @author Leo (zhsleo@outlook.com)
+ *
+ * @brief Design-space exploration of accelerator configurations
+ * @version 1.0.0
+ * @date 2026-10-18
+ */
+
+#include <fmt/format.h>
+#include <spdlog/spdlog.h>
+
+#include <algorithm>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "dse.hpp"
+#include "workload.hpp"
+
+namespace {
+
+void usage(const char* prog) {
+  fmt::print(
+      "Usage: {} [options] <model.json[:CxHxW]>...\n"
+      "  --array LIST       Array sizes (default 4,8,16,32)\n"
+      "  --buffer-kb LIST   On-chip buffer KiB (default 16,64,256)\n"
+      "  --dma-bytes LIST   DMA bytes per cycle (default 4,8,16)\n"
+      "  --channels LIST    DMA channels (default 1,2)\n"
+      "  --clock-mhz N      Accelerator clock (default 100)\n"
+      "  --batch N          Batch size (default 1)\n"
+      "  --dsp N            Device DSP48 slices (default 220)\n"
+      "  --bram N           Device 36Kb block RAMs (default 140)\n"
+      "  --lut N            Device LUTs (default 53200)\n"
+      "  --threads N        Worker threads (default: one per core)\n"
+      "  --all              Also list dominated configurations\n"
+      "  --csv FILE         Write every configuration to FILE\n"
+      "The input shape defaults to 1x28x28.\n",
+      prog);
+}
+
+/**
+ * @brief Split a separated list of unsigned integers
+ * @throws std::invalid_argument If an element is not a positive number
+ */
+template <typename T>
+std::vector<T> parse_list(const std::string& text, char sep = ',') {
+  std::vector<T> values;
+  std::stringstream ss(text);
+  std::string item;
+  while (std::getline(ss, item, sep)) {
+    unsigned long long v = std::stoull(item);
+    if (v == 0) {
+      throw std::invalid_argument("zero in list: " + text);
+    }
+    values.push_back(static_cast<T>(v));
+  }
+  if (values.empty()) {
+    throw std::invalid_argument("empty list");
+  }
+  return values;
+}
+
+struct ModelSpec {
+  std::string path;
+  std::vector<size_t> shape;  // C, H, W
+};
+
+ModelSpec parse_model(const std::string& arg) {
+  ModelSpec spec{arg, {1, 28, 28}};
+  size_t colon = arg.rfind(':');
+  if (colon != std::string::npos) {
+    spec.path = arg.substr(0, colon);
+    spec.shape = parse_list<size_t>(arg.substr(colon + 1), 'x');
+    if (spec.shape.size() != 3) {
+      throw std::invalid_argument("input shape must be CxHxW: " + arg);
+    }
+  }
+  return spec;
+}
+
+std::string model_label(const std::string& path) {
+  size_t slash = path.find_last_of('/');
+  std::string name = slash == std::string::npos ? path : path.substr(slash + 1);
+  size_t dot = name.rfind('.');
+  return dot == std::string::npos ? name : name.substr(0, dot);
+}
+
+void write_csv(const std::string& filename,
+               const std::vector<std::string>& labels,
+               const std::vector<qnn::dse::DesignPoint>& points) {
+  std::ofstream out(filename);
+  if (!out.is_open()) {
+    throw std::runtime_error("Failed to open CSV file: " + filename);
+  }
+  out << "array,buffer_kb,dma_bytes,channels,dsp,bram36,lut,share,feasible,"
+         "pareto,throughput";
+  for (const auto& label : labels) {
+    out << "," << label << "_ips," << label << "_util";
+  }
+  out << "\n";
+  for (const auto& p : points) {
+    out << fmt::format("{},{},{},{},{},{},{},{:.3f},{},{},{:.1f}",
+                       p.config.array_size, p.config.buffer_bytes / 1024,
+                       p.config.dma_bytes_per_cycle, p.config.dma_channels,
+                       p.resources.dsp, p.resources.bram36, p.resources.lut,
+                       p.share, p.feasible, p.pareto, p.throughput);
+    for (const auto& m : p.models) {
+      out << fmt::format(",{:.1f},{:.3f}", m.throughput, m.utilization);
+    }
+    out << "\n";
+  }
+}
+
+}  // namespace
+
+int main(int argc, char* argv[]) {
+  qnn::dse::SweepSpace space;
+  qnn::dse::DeviceBudget budget;
+  size_t batch = 1;
+  size_t threads = 0;
+  bool all = false;
+  std::string csv;
+  std::vector<ModelSpec> specs;
+
+  try {
+    for (int i = 1; i < argc; ++i) {
+      std::string arg = argv[i];
+      auto value = [&]() -> std::string {
+        if (i + 1 >= argc) {
+          throw std::invalid_argument("missing value for " + arg);
+        }
+        return argv[++i];
+      };
+
+      if (arg == "--array") {
+        space.array_sizes = parse_list<uint32_t>(value());
+      } else if (arg == "--buffer-kb") {
+        space.buffer_bytes.clear();
+        for (uint64_t kb : parse_list<uint64_t>(value())) {
+          space.buffer_bytes.push_back(kb * 1024);
+        }
+      } else if (arg == "--dma-bytes") {
+        space.dma_bytes_per_cycle = parse_list<uint32_t>(value());
+      } else if (arg == "--channels") {
+        space.dma_channels = parse_list<uint32_t>(value());
+      } else if (arg == "--clock-mhz") {
+        space.clock_mhz = parse_list<uint32_t>(value()).front();
+      } else if (arg == "--batch") {
+        batch = parse_list<size_t>(value()).front();
+      } else if (arg == "--dsp") {
+        budget.dsp = parse_list<uint64_t>(value()).front();
+      } else if (arg == "--bram") {
+        budget.bram36 = parse_list<uint64_t>(value()).front();
+      } else if (arg == "--lut") {
+        budget.lut = parse_list<uint64_t>(value()).front();
+      } else if (arg == "--threads") {
+        threads = parse_list<size_t>(value()).front();
+      } else if (arg == "--all") {
+        all = true;
+      } else if (arg == "--csv") {
+        csv = value();
+      } else if (arg == "-h" || arg == "--help") {
+        usage(argv[0]);
+        return 0;
+      } else if (!arg.empty() && arg[0] == '-') {
+        throw std::invalid_argument("unknown option " + arg);
+      } else {
+        specs.push_back(parse_model(arg));
+      }
+    }
+  } catch (const std::exception& e) {
+    spdlog::error("{}", e.what());
+    usage(argv[0]);
+    return 1;
+  }
+
+  if (specs.empty()) {
+    usage(argv[0]);
+    return 1;
+  }
+
+  try {
+    std::vector<std::vector<qnn::LayerWorkload>> zoo;
+    std::vector<std::string> labels;
+    for (const auto& spec : specs) {
+      std::vector<size_t> shape = {batch, spec.shape[0], spec.shape[1],
+                                   spec.shape[2]};
+      zoo.push_back(qnn::LoadWorkloads(spec.path, shape));
+      labels.push_back(model_label(spec.path));
+    }
+
+    auto configs = qnn::dse::Enumerate(space);
+    auto points = qnn::dse::Sweep(zoo, configs, budget, threads);
+    if (!csv.empty()) {
+      write_csv(csv, labels, points);
+    }
+
+    std::vector<const qnn::dse::DesignPoint*> rows;
+    for (const auto& p : points) {
+      if (p.pareto || (all && p.feasible)) {
+        rows.push_back(&p);
+      }
+    }
+    std::sort(rows.begin(), rows.end(), [](const auto* a, const auto* b) {
+      return a->throughput > b->throughput;
+    });
+
+    size_t feasible = std::count_if(points.begin(), points.end(),
+                                    [](const auto& p) { return p.feasible; });
+    fmt::print("{} configurations, {} feasible, {} on the Pareto front\n\n",
+               points.size(), feasible,
+               std::count_if(points.begin(), points.end(),
+                             [](const auto& p) { return p.pareto; }));
+
+    fmt::print("{:>5} {:>9} {:>6} {:>4} {:>6} {:>6} {:>7} {:>6} {:>12}",
+               "array", "buffer", "dma", "ch", "DSP", "BRAM", "LUT", "device",
+               "geomean ips");
+    for (const auto& label : labels) {
+      fmt::print(" {:>14} {:>6}", label + " ips", "util");
+    }
+    fmt::print("{}\n", all ? "  pareto" : "");
+
+    for (const auto* p : rows) {
+      fmt::print(
+          "{:>5} {:>7}Ki {:>5}B {:>4} {:>6} {:>6} {:>7} {:>5.1f}% {:>12.1f}",
+          p->config.array_size, p->config.buffer_bytes / 1024,
+          p->config.dma_bytes_per_cycle, p->config.dma_channels,
+          p->resources.dsp, p->resources.bram36, p->resources.lut,
+          100.0 * p->share, p->throughput);
+      for (const auto& m : p->models) {
+        fmt::print(" {:>14.1f} {:>5.1f}%", m.throughput,
+                   100.0 * m.utilization);
+      }
+      fmt::print("{}\n", all ? (p->pareto ? "  *" : "") : "");
+    }
+  } catch (const std::exception& e) {
+    spdlog::error("{}", e.what());
+    return 1;
+  }
+
+  return 0;
+}
@@ -0,0 +1,154 @@
+/**
+ * @file gemv_bench.cc
+ * @author Leo (zhsleo@outlook.com)
+ *
+ * @brief Bandwidth of the batch-1 Linear kernel against the copy bandwidth
+ * @version 1.0.0
+ * @date 2026-10-18
+ */
+
+#include <fmt/format.h>
+#include <spdlog/spdlog.h>
+
+#include <chrono>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "gemv.hpp"
+#include "roofline.hpp"
+#include "thread_pool.hpp"
+
+namespace {
+
+void usage(const char* prog) {
+  fmt::print(
+      "Usage: {} [options]\n"
+      "  --rows N           Output features (default 4096)\n"
+      "  --cols N           Input features (default 4096)\n"
+      "  --runs N           Timed products per thread count (default 50)\n"
+      "  --threads N        Largest thread count (default: one per core)\n",
+      prog);
+}
+
+size_t parse_count(const std::string& text) {
+  size_t value = std::stoull(text);
+  if (value == 0) {
+    throw std::invalid_argument("expected a positive number: " + text);
+  }
+  return value;
+}
+
+/** @brief Row-major loop over the unpacked matrix */
+void reference(const std::vector<int8_t>& w, const std::vector<int8_t>& x,
+               std::vector<int32_t>& y, size_t rows, size_t cols) {
+  for (size_t o = 0; o < rows; ++o) {
+    int32_t acc = 0;
+    for (size_t i = 0; i < cols; ++i) {
+      acc += int32_t{x[i]} * w[o * cols + i];
+    }
+    y[o] = acc;
+  }
+}
+
+/** @return Best time of runs calls, seconds */
+template <typename Fn>
+double best_time(size_t runs, Fn&& fn) {
+  double best = 1e30;
+  for (size_t r = 0; r < runs; ++r) {
+    const auto start = std::chrono::steady_clock::now();
+    fn();
+    const std::chrono::duration<double> elapsed =
+        std::chrono::steady_clock::now() - start;
+    best = std::min(best, elapsed.count());
+  }
+  return best;
+}
+
+}  // namespace
+
+int main(int argc, char* argv[]) {
+  size_t rows = 4096;
+  size_t cols = 4096;
+  size_t runs = 50;
+  size_t max_threads = std::max(1u, std::thread::hardware_concurrency());
+
+  try {
+    for (int i = 1; i < argc; ++i) {
+      std::string arg = argv[i];
+      auto value = [&]() -> std::string {
+        if (i + 1 >= argc) {
+          throw std::invalid_argument("missing value for " + arg);
+        }
+        return argv[++i];
+      };
+
+      if (arg == "--rows") {
+        rows = parse_count(value());
+      } else if (arg == "--cols") {
+        cols = parse_count(value());
+      } else if (arg == "--runs") {
+        runs = parse_count(value());
+      } else if (arg == "--threads") {
+        max_threads = parse_count(value());
+      } else if (arg == "-h" || arg == "--help") {
+        usage(argv[0]);
+        return 0;
+      } else {
+        throw std::invalid_argument("unknown option " + arg);
+      }
+    }
+  } catch (const std::exception& e) {
+    spdlog::error("{}", e.what());
+    usage(argv[0]);
+    return 1;
+  }
+
+  std::mt19937 rng(42);
+  std::uniform_int_distribution<int> dist(-128, 127);
+  std::vector<int8_t> w(rows * cols), x(cols);
+  for (auto& v : w) {
+    v = static_cast<int8_t>(dist(rng));
+  }
+  for (auto& v : x) {
+    v = static_cast<int8_t>(dist(rng));
+  }
+
+  const qnn::PackedGemv packed = qnn::PackGemv(w.data(), rows, cols);
+  std::vector<int32_t> expected(rows), y(rows);
+  reference(w, x, expected, rows, cols);
+  qnn::Gemv(packed, x.data(), y.data(), nullptr);
+  if (y != expected) {
+    spdlog::error("Gemv result differs from the reference loop");
+    return 1;
+  }
+
+  const double stream = qnn::roofline::MeasureBandwidth();
+  const double bytes = static_cast<double>(w.size());
+  fmt::print("{}x{} int8 weights ({:.1f} MiB), copy bandwidth {:.2f} GB/s\n\n",
+             rows, cols, bytes / (1 << 20), stream);
+  fmt::print("{:<12} {:>8} {:>10} {:>10} {:>10}\n", "kernel", "threads",
+             "time us", "GB/s", "of copy");
+
+  auto report = [&](const char* kernel, size_t threads, double seconds) {
+    const double gbs = bytes / seconds * 1e-9;
+    fmt::print("{:<12} {:>8} {:>10.1f} {:>10.2f} {:>9.1f}%\n", kernel,
+               threads, seconds * 1e6, gbs, 100.0 * gbs / stream);
+  };
+
+  report("reference", 1, best_time(runs, [&] {
+           reference(w, x, y, rows, cols);
+         }));
+  for (size_t threads = 1; threads <= max_threads; threads *= 2) {
+    qnn::ThreadPool pool(threads);
+    report("gemv", threads, best_time(runs, [&] {
+             qnn::Gemv(packed, x.data(), y.data(), &pool);
+           }));
+    if (y != expected) {
+      spdlog::error("Gemv result differs with {} threads", threads);
+      return 1;
+    }
+  }
+
+  return 0;
+}
@@ -0,0 +1,163 @@
+/**
+ * @file jit_bench.cc
+ * @author Leo (zhsleo@outlook.com)
+ *
+ * @brief Forward latency with generated and precompiled kernels
+ * @version 1.0.0
+ * @date 2026-10-18
+ */
+
+#include <fmt/format.h>
+#include <spdlog/spdlog.h>
+
+#include <chrono>
+#include <random>
+#include <sstream>
+#include <string>
+#include <variant>
+#include <vector>
+
+#include "jit.hpp"
+#include "model.hpp"
+
+namespace {
+
+void usage(const char* prog) {
+  fmt::print(
+      "Usage: {} [options] <model.json>\n"
+      "  --input CxHxW      Input shape (default 1x28x28)\n"
+      "  --batch N          Batch size (default 1)\n"
+      "  --runs N           Timed runs per mode (default 200)\n",
+      prog);
+}
+
+size_t parse_count(const std::string& text) {
+  size_t value = std::stoull(text);
+  if (value == 0) {
+    throw std::invalid_argument("expected a positive number: " + text);
+  }
+  return value;
+}
+
+std::vector<size_t> parse_shape(const std::string& text) {
+  std::vector<size_t> shape;
+  std::stringstream ss(text);
+  std::string item;
+  while (std::getline(ss, item, 'x')) {
+    shape.push_back(parse_count(item));
+  }
+  if (shape.size() != 3) {
+    throw std::invalid_argument("input shape must be CxHxW: " + text);
+  }
+  return shape;
+}
+
+/** @brief Raw bytes of a model output, for an exact comparison */
+std::vector<char> Bytes(const std::variant<qnn::Tensor<float>,
+                                           qnn::Tensor<int8_t>>& output) {
+  return std::visit(
+      [](const auto& tensor) {
+        const char* data = reinterpret_cast<const char*>(tensor.data());
+        return std::vector<char>(
+            data, data + tensor.size() * sizeof(*tensor.data()));
+      },
+      output);
+}
+
+}  // namespace
+
+int main(int argc, char* argv[]) {
+  std::vector<size_t> input_shape = {1, 28, 28};
+  size_t batch = 1;
+  size_t runs = 200;
+  std::string model_path;
+
+  try {
+    for (int i = 1; i < argc; ++i) {
+      std::string arg = argv[i];
+      auto value = [&]() -> std::string {
+        if (i + 1 >= argc) {
+          throw std::invalid_argument("missing value for " + arg);
+        }
+        return argv[++i];
+      };
+
+      if (arg == "--input") {
+        input_shape = parse_shape(value());
+      } else if (arg == "--batch") {
+        batch = parse_count(value());
+      } else if (arg == "--runs") {
+        runs = parse_count(value());
+      } else if (arg == "-h" || arg == "--help") {
+        usage(argv[0]);
+        return 0;
+      } else if (!arg.empty() && arg[0] == '-') {
+        throw std::invalid_argument("unknown option " + arg);
+      } else {
+        model_path = arg;
+      }
+    }
+  } catch (const std::exception& e) {
+    spdlog::error("{}", e.what());
+    usage(argv[0]);
+    return 1;
+  }
+
+  if (model_path.empty()) {
+    usage(argv[0]);
+    return 1;
+  }
+
+  if (!qnn::jit::Supported()) {
+    spdlog::warn("Generated kernels need x86-64 with AVX2; both modes run "
+                 "the precompiled kernels");
+  }
+
+  try {
+    qnn::Model model = qnn::Model::loadModel(model_path);
+
+    qnn::Tensor<float> input;
+    input.resize(std::vector<size_t>{batch, input_shape[0], input_shape[1],
+                                     input_shape[2]});
+    std::mt19937 rng(42);
+    std::uniform_real_distribution<float> pixel(0.0f, 1.0f);
+    for (size_t i = 0; i < input.size(); ++i) {
+      input.data()[i] = pixel(rng);
+    }
+
+    fmt::print("{:<14} {:>12} {:>10}\n", "kernels", "us/forward", "speedup");
+    std::vector<char> reference;
+    double precompiled_us = 0.0;
+    bool identical = true;
+    for (bool jit : {false, true}) {
+      qnn::jit::SetEnabled(jit);
+      // The first run generates the kernels
+      const auto output = Bytes(model.forward(input));
+      const auto start = std::chrono::steady_clock::now();
+      for (size_t r = 0; r < runs; ++r) {
+        model.forward(input);
+      }
+      const std::chrono::duration<double, std::micro> elapsed =
+          std::chrono::steady_clock::now() - start;
+      const double us = elapsed.count() / runs;
+
+      if (!jit) {
+        reference = output;
+        precompiled_us = us;
+      } else {
+        identical = output == reference;
+      }
+      fmt::print("{:<14} {:>12.1f} {:>9.2f}x\n",
+                 jit ? "generated" : "precompiled", us, precompiled_us / us);
+    }
+
+    const auto& cache = qnn::jit::Cache::Global();
+    fmt::print("\nKernels generated: {}, reused: {}\n", cache.generated(),
+               cache.hits());
+    fmt::print("Outputs {}\n", identical ? "identical" : "DIFFER");
+    return identical ? 0 : 1;
+  } catch (const std::exception& e) {
+    spdlog::error("{}", e.what());
+    return 1;
+  }
+}
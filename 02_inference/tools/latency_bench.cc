@@ -0,0 +1,204 @@
+/**
+ * @file latency_bench.cc
+ * @author Leo (zhsleo@outlook.com)
+ *
+ * @brief Tail latency of the default and low-latency request paths
+ * @version 1.0.0
+ * @date 2026-10-18
+ */
+
+#include <fmt/format.h>
+#include <spdlog/spdlog.h>
+
+#include <algorithm>
+#include <chrono>
+#include <functional>
+#include <random>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "low_latency.hpp"
+#include "numa.hpp"
+
+namespace {
+
+void usage(const char* prog) {
+  fmt::print(
+      "Usage: {} [options] <model.json>\n"
+      "  --input CxHxW      Input shape (default 1x28x28)\n"
+      "  --requests N       Timed requests per mode (default 2000)\n"
+      "  --gap-us N         Pause between requests (default 100)\n"
+      "  --threads N        Threads running the model (default 1)\n"
+      "  --idle-us N        Polling time before sleeping (default 10000)\n"
+      "  --cpus LIST        CPUs to run on, e.g. 2-5 (default: isolated)\n",
+      prog);
+}
+
+size_t parse_count(const std::string& text) {
+  size_t value = std::stoull(text);
+  if (value == 0) {
+    throw std::invalid_argument("expected a positive number: " + text);
+  }
+  return value;
+}
+
+std::vector<size_t> parse_shape(const std::string& text) {
+  std::vector<size_t> shape;
+  std::stringstream ss(text);
+  std::string item;
+  while (std::getline(ss, item, 'x')) {
+    shape.push_back(parse_count(item));
+  }
+  if (shape.size() != 3) {
+    throw std::invalid_argument("input shape must be CxHxW: " + text);
+  }
+  return shape;
+}
+
+/**
+ * @brief Time requests issued one at a time
+ * @return Latency of each request in microseconds, sorted
+ */
+std::vector<double> Measure(size_t requests, size_t gap_us,
+                            const std::function<void()>& request) {
+  using Clock = std::chrono::steady_clock;
+  for (size_t i = 0; i < requests / 10 + 1; ++i) {
+    request();
+  }
+  std::vector<double> latencies;
+  latencies.reserve(requests);
+  for (size_t i = 0; i < requests; ++i) {
+    std::this_thread::sleep_for(std::chrono::microseconds(gap_us));
+    const auto start = Clock::now();
+    request();
+    latencies.push_back(
+        std::chrono::duration<double, std::micro>(Clock::now() - start)
+            .count());
+  }
+  std::sort(latencies.begin(), latencies.end());
+  return latencies;
+}
+
+void PrintRow(const char* mode, const std::vector<double>& latencies,
+              uint64_t parks) {
+  auto at = [&](double q) {
+    return latencies[std::min(latencies.size() - 1,
+                              static_cast<size_t>(q * latencies.size()))];
+  };
+  fmt::print("{:<22} {:>9.1f} {:>9.1f} {:>9.1f} {:>9.1f} {:>8}\n", mode,
+             at(0.5), at(0.99), at(0.999), latencies.back(), parks);
+}
+
+}  // namespace
+
+int main(int argc, char* argv[]) {
+  std::vector<size_t> input_shape = {1, 28, 28};
+  size_t requests = 2000;
+  size_t gap_us = 100;
+  size_t threads = 1;
+  size_t idle_us = 10000;
+  std::vector<int> cpus;
+  std::string model_path;
+
+  try {
+    for (int i = 1; i < argc; ++i) {
+      std::string arg = argv[i];
+      auto value = [&]() -> std::string {
+        if (i + 1 >= argc) {
+          throw std::invalid_argument("missing value for " + arg);
+        }
+        return argv[++i];
+      };
+
+      if (arg == "--input") {
+        input_shape = parse_shape(value());
+      } else if (arg == "--requests") {
+        requests = parse_count(value());
+      } else if (arg == "--gap-us") {
+        gap_us = std::stoull(value());
+      } else if (arg == "--threads") {
+        threads = parse_count(value());
+      } else if (arg == "--idle-us") {
+        idle_us = std::stoull(value());
+      } else if (arg == "--cpus") {
+        cpus = qnn::numa::ParseCpuList(value());
+      } else if (arg == "-h" || arg == "--help") {
+        usage(argv[0]);
+        return 0;
+      } else if (!arg.empty() && arg[0] == '-') {
+        throw std::invalid_argument("unknown option " + arg);
+      } else {
+        model_path = arg;
+      }
+    }
+  } catch (const std::exception& e) {
+    spdlog::error("{}", e.what());
+    usage(argv[0]);
+    return 1;
+  }
+
+  if (model_path.empty()) {
+    usage(argv[0]);
+    return 1;
+  }
+
+  try {
+    if (cpus.empty()) {
+      cpus = qnn::IsolatedCpus();
+    }
+    if (cpus.size() < threads + 1) {
+      spdlog::warn("{} CPUs for {} model threads and the client; polling "
+                   "threads will compete for cores",
+                   cpus.size(), threads);
+    }
+
+    qnn::Tensor<float> input;
+    input.resize(std::vector<size_t>{1, input_shape[0], input_shape[1],
+                                     input_shape[2]});
+    std::mt19937 rng(42);
+    std::uniform_real_distribution<float> pixel(0.0f, 1.0f);
+    for (size_t i = 0; i < input.size(); ++i) {
+      input.data()[i] = pixel(rng);
+    }
+
+    fmt::print("{} requests, {} us apart, {} model threads, CPUs [{}]\n\n",
+               requests, gap_us, threads, fmt::join(cpus, ","));
+    fmt::print("{:<22} {:>9} {:>9} {:>9} {:>9} {:>8}\n", "mode", "p50 us",
+               "p99 us", "p99.9 us", "max us", "parks");
+
+    // The default path: a dispatcher woken per request, answering through
+    // a future
+    {
+      std::vector<qnn::numa::Node> nodes = {qnn::numa::Node{0, cpus}};
+      if (cpus.empty()) {
+        nodes = {qnn::numa::Nodes()[0]};
+      }
+      qnn::numa::RouterOptions options;
+      options.threads_per_node = threads;
+      qnn::numa::NodeRouter router(model_path, options, nodes);
+      PrintRow("default",
+               Measure(requests, gap_us, [&] { router.Submit(input).get(); }),
+               0);
+    }
+
+    qnn::Model model = qnn::Model::loadModel(model_path);
+    for (size_t idle : {idle_us, size_t{0}}) {
+      qnn::LowLatencyOptions options;
+      options.cpus = cpus;
+      options.threads = threads;
+      options.idle_us = static_cast<double>(idle);
+      qnn::LowLatencySession session(model, options);
+      const auto latencies =
+          Measure(requests, gap_us, [&] { session.Run(input); });
+      PrintRow(idle ? "low-latency" : "low-latency, no poll", latencies,
+               session.Parks());
+    }
+  } catch (const std::exception& e) {
+    spdlog::error("{}", e.what());
+    return 1;
+  }
+
+  return 0;
+}
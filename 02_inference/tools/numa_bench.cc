@@ -0,0 +1,193 @@
+/**
+ * @file numa_bench.cc
+ * @author Leo (zhsleo@outlook.com)
+ *
+ * @brief Throughput and latency of interleaved and node-local placement
+ * @version 1.0.0
+ * @date 2026-10-18
+ */
+
+#include <fmt/format.h>
+#include <spdlog/spdlog.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "numa.hpp"
+
+namespace {
+
+void usage(const char* prog) {
+  fmt::print(
+      "Usage: {} [options] <model.json>\n"
+      "  --input CxHxW      Input shape (default 1x28x28)\n"
+      "  --batch N          Batch size (default 1)\n"
+      "  --requests N       Timed requests per configuration (default 200)\n"
+      "  --clients N        Concurrent clients (default 2 per node)\n"
+      "  --threads N        Threads per node (default: its CPUs)\n",
+      prog);
+}
+
+size_t parse_count(const std::string& text) {
+  size_t value = std::stoull(text);
+  if (value == 0) {
+    throw std::invalid_argument("expected a positive number: " + text);
+  }
+  return value;
+}
+
+std::vector<size_t> parse_shape(const std::string& text) {
+  std::vector<size_t> shape;
+  std::stringstream ss(text);
+  std::string item;
+  while (std::getline(ss, item, 'x')) {
+    shape.push_back(parse_count(item));
+  }
+  if (shape.size() != 3) {
+    throw std::invalid_argument("input shape must be CxHxW: " + text);
+  }
+  return shape;
+}
+
+struct Configuration {
+  const char* name;
+  qnn::numa::Placement placement;
+  bool replicate_weights;
+};
+
+}  // namespace
+
+int main(int argc, char* argv[]) {
+  std::vector<size_t> input_shape = {1, 28, 28};
+  size_t batch = 1;
+  size_t requests = 200;
+  size_t clients = 0;
+  size_t threads = 0;
+  std::string model_path;
+
+  try {
+    for (int i = 1; i < argc; ++i) {
+      std::string arg = argv[i];
+      auto value = [&]() -> std::string {
+        if (i + 1 >= argc) {
+          throw std::invalid_argument("missing value for " + arg);
+        }
+        return argv[++i];
+      };
+
+      if (arg == "--input") {
+        input_shape = parse_shape(value());
+      } else if (arg == "--batch") {
+        batch = parse_count(value());
+      } else if (arg == "--requests") {
+        requests = parse_count(value());
+      } else if (arg == "--clients") {
+        clients = parse_count(value());
+      } else if (arg == "--threads") {
+        threads = parse_count(value());
+      } else if (arg == "-h" || arg == "--help") {
+        usage(argv[0]);
+        return 0;
+      } else if (!arg.empty() && arg[0] == '-') {
+        throw std::invalid_argument("unknown option " + arg);
+      } else {
+        model_path = arg;
+      }
+    }
+  } catch (const std::exception& e) {
+    spdlog::error("{}", e.what());
+    usage(argv[0]);
+    return 1;
+  }
+
+  if (model_path.empty()) {
+    usage(argv[0]);
+    return 1;
+  }
+
+  const auto nodes = qnn::numa::Nodes();
+  if (clients == 0) {
+    clients = 2 * nodes.size();
+  }
+  fmt::print("{} node(s):", nodes.size());
+  for (const auto& node : nodes) {
+    fmt::print(" node{} {} CPUs", node.id, node.cpus.size());
+  }
+  fmt::print(", {} clients\n\n", clients);
+
+  // Any input in [0, 1) exercises the same work
+  qnn::Tensor<float> input;
+  input.resize(std::vector<size_t>{batch, input_shape[0], input_shape[1],
+                                   input_shape[2]});
+  for (size_t i = 0; i < input.size(); ++i) {
+    input.data()[i] = static_cast<float>((i * 37) % 256) / 256.0f;
+  }
+
+  const Configuration configurations[] = {
+      {"interleaved", qnn::numa::Placement::kInterleaved, false},
+      {"local, shared home", qnn::numa::Placement::kNodeLocal, false},
+      {"local, replicas", qnn::numa::Placement::kNodeLocal, true},
+  };
+  fmt::print("{:<20} {:>10} {:>10} {:>10} {:>10}\n", "placement", "req/s",
+             "p50 us", "p99 us", "max us");
+
+  try {
+    for (const auto& config : configurations) {
+      qnn::numa::RouterOptions options;
+      options.placement = config.placement;
+      options.replicate_weights = config.replicate_weights;
+      options.threads_per_node = threads;
+      qnn::numa::NodeRouter router(model_path, options, nodes);
+
+      // Warm up every session so its activations are allocated
+      for (size_t i = 0; i < 2 * nodes.size(); ++i) {
+        router.Submit(input).get();
+      }
+
+      // Closed loop: each client waits for its request before the next
+      std::vector<std::vector<double>> latencies(clients);
+      std::atomic<size_t> issued{0};
+      const auto start = std::chrono::steady_clock::now();
+      std::vector<std::thread> workers;
+      for (size_t c = 0; c < clients; ++c) {
+        workers.emplace_back([&, c] {
+          while (issued.fetch_add(1) < requests) {
+            const auto begin = std::chrono::steady_clock::now();
+            router.Submit(input).get();
+            const std::chrono::duration<double, std::micro> elapsed =
+                std::chrono::steady_clock::now() - begin;
+            latencies[c].push_back(elapsed.count());
+          }
+        });
+      }
+      for (auto& thread : workers) {
+        thread.join();
+      }
+      const std::chrono::duration<double> wall =
+          std::chrono::steady_clock::now() - start;
+
+      std::vector<double> all;
+      for (const auto& l : latencies) {
+        all.insert(all.end(), l.begin(), l.end());
+      }
+      std::sort(all.begin(), all.end());
+      auto quantile = [&](double q) {
+        return all[std::min(all.size() - 1,
+                            static_cast<size_t>(q * all.size()))];
+      };
+      fmt::print("{:<20} {:>10.1f} {:>10.1f} {:>10.1f} {:>10.1f}\n",
+                 config.name, all.size() / wall.count(), quantile(0.5),
+                 quantile(0.99), all.back());
+    }
+  } catch (const std::exception& e) {
+    spdlog::error("{}", e.what());
+    return 1;
+  }
+
+  return 0;
+}
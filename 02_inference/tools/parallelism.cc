@@ -0,0 +1,143 @@
+/**
+ * @file parallelism.cc
+ * @author Leo (zhsleo@outlook.com)
+ *
+ * @brief Inter-op parallelism a model offers and the share the scheduler uses
+ * @version 1.0.0
+ * @date 2026-10-18
+ */
+
+#include <fmt/format.h>
+#include <spdlog/spdlog.h>
+
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "model.hpp"
+#include "thread_pool.hpp"
+
+namespace {
+
+void usage(const char* prog) {
+  fmt::print(
+      "Usage: {} [options] <model.json>\n"
+      "  --input CxHxW      Input shape (default 1x28x28)\n"
+      "  --batch N          Batch size (default 1)\n"
+      "  --runs N           Profiled forward passes (default 20)\n"
+      "  --tiling           Run Conv/ReLU/Pool chains depth-first\n"
+      "Set QNN_NUM_THREADS to change the number of workers.\n",
+      prog);
+}
+
+size_t parse_count(const std::string& text) {
+  size_t value = std::stoull(text);
+  if (value == 0) {
+    throw std::invalid_argument("expected a positive number: " + text);
+  }
+  return value;
+}
+
+std::vector<size_t> parse_shape(const std::string& text) {
+  std::vector<size_t> shape;
+  std::stringstream ss(text);
+  std::string item;
+  while (std::getline(ss, item, 'x')) {
+    shape.push_back(parse_count(item));
+  }
+  if (shape.size() != 3) {
+    throw std::invalid_argument("input shape must be CxHxW: " + text);
+  }
+  return shape;
+}
+
+}  // namespace
+
+int main(int argc, char* argv[]) {
+  std::vector<size_t> input_shape = {1, 28, 28};
+  size_t batch = 1;
+  size_t runs = 20;
+  bool tiling = false;
+  std::string model_path;
+
+  try {
+    for (int i = 1; i < argc; ++i) {
+      std::string arg = argv[i];
+      auto value = [&]() -> std::string {
+        if (i + 1 >= argc) {
+          throw std::invalid_argument("missing value for " + arg);
+        }
+        return argv[++i];
+      };
+
+      if (arg == "--input") {
+        input_shape = parse_shape(value());
+      } else if (arg == "--batch") {
+        batch = parse_count(value());
+      } else if (arg == "--runs") {
+        runs = parse_count(value());
+      } else if (arg == "--tiling") {
+        tiling = true;
+      } else if (arg == "-h" || arg == "--help") {
+        usage(argv[0]);
+        return 0;
+      } else if (!arg.empty() && arg[0] == '-') {
+        throw std::invalid_argument("unknown option " + arg);
+      } else {
+        model_path = arg;
+      }
+    }
+  } catch (const std::exception& e) {
+    spdlog::error("{}", e.what());
+    usage(argv[0]);
+    return 1;
+  }
+
+  if (model_path.empty()) {
+    usage(argv[0]);
+    return 1;
+  }
+
+  try {
+    auto model = qnn::Model::loadModel(model_path);
+    if (tiling) {
+      model.EnableTiling();
+    }
+
+    // Any input in [0, 1) exercises the same work
+    qnn::Tensor<float> input;
+    input.resize(std::vector<size_t>{batch, input_shape[0], input_shape[1],
+                                     input_shape[2]});
+    for (size_t i = 0; i < input.size(); ++i) {
+      input.data()[i] = static_cast<float>((i * 37) % 256) / 256.0f;
+    }
+
+    // Warm up, then profile
+    model.forward(input);
+    model.EnableProfiling();
+    for (size_t r = 0; r < runs; ++r) {
+      model.forward(input);
+    }
+
+    const auto& p = model.Parallelism();
+    fmt::print("{} on {} workers, {} runs\n\n", model_path,
+               qnn::ThreadPool::Global().size(), p.runs);
+    fmt::print("{:<24} {:>10.1f}\n", "work us / run", p.work_us / p.runs);
+    fmt::print("{:<24} {:>10.1f}\n", "span us / run", p.span_us / p.runs);
+    fmt::print("{:<24} {:>10.1f}\n", "wall us / run", p.wall_us / p.runs);
+    fmt::print("{:<24} {:>10.2f}\n", "available parallelism", p.available());
+    fmt::print("{:<24} {:>10.2f}\n", "achieved parallelism", p.achieved());
+
+    fmt::print("\n{:>8} {:>10} {:>8}\n", "running", "time us", "share");
+    for (size_t k = 0; k < p.concurrency_us.size(); ++k) {
+      fmt::print("{:>8} {:>10.1f} {:>7.1f}%\n", k,
+                 p.concurrency_us[k] / p.runs,
+                 p.wall_us > 0 ? 100.0 * p.concurrency_us[k] / p.wall_us : 0);
+    }
+  } catch (const std::exception& e) {
+    spdlog::error("{}", e.what());
+    return 1;
+  }
+
+  return 0;
+}
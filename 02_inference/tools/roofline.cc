@@ -0,0 +1,224 @@
+/**
+ * @file roofline.cc
+ * @author Leo (zhsleo@outlook.com)
+ *
+ * @brief Roofline report for CPU execution and the simulated accelerator
+ * @version 1.0.0
+ * @date 2026-10-18
+ */
+
+#include <fmt/format.h>
+#include <spdlog/spdlog.h>
+
+#include <algorithm>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "dse.hpp"
+#include "model.hpp"
+#include "roofline.hpp"
+#include "workload.hpp"
+
+namespace {
+
+void usage(const char* prog) {
+  fmt::print(
+      "Usage: {} [options] <model.json>\n"
+      "  --input CxHxW      Input shape (default 1x28x28)\n"
+      "  --batch N          Batch size (default 1)\n"
+      "  --runs N           Profiled forward passes (default 20)\n"
+      "  --array N          Accelerator array size (default 8)\n"
+      "  --buffer-kb N      On-chip buffer KiB (default 64)\n"
+      "  --dma-bytes N      DMA bytes per cycle (default 4)\n"
+      "  --channels N       DMA channels (default 1)\n"
+      "  --clock-mhz N      Accelerator clock (default 100)\n"
+      "  --csv FILE         CSV output (default roofline.csv)\n"
+      "  --svg FILE         SVG output (default roofline.svg)\n"
+      "  --top N            Layers listed per target (default 5)\n",
+      prog);
+}
+
+size_t parse_count(const std::string& text) {
+  size_t value = std::stoull(text);
+  if (value == 0) {
+    throw std::invalid_argument("expected a positive number: " + text);
+  }
+  return value;
+}
+
+std::vector<size_t> parse_shape(const std::string& text) {
+  std::vector<size_t> shape;
+  std::stringstream ss(text);
+  std::string item;
+  while (std::getline(ss, item, 'x')) {
+    shape.push_back(parse_count(item));
+  }
+  if (shape.size() != 3) {
+    throw std::invalid_argument("input shape must be CxHxW: " + text);
+  }
+  return shape;
+}
+
+void print_top(const qnn::roofline::Machine& machine,
+               std::vector<qnn::roofline::Point> points, size_t top) {
+  points.erase(std::remove_if(points.begin(), points.end(),
+                              [&](const auto& p) {
+                                return p.target != machine.name;
+                              }),
+               points.end());
+  std::sort(points.begin(), points.end(), [&](const auto& a, const auto& b) {
+    return LostTime(a, machine) > LostTime(b, machine);
+  });
+
+  fmt::print("\n{}: peak {:.2f} GOP/s, {:.2f} GB/s, ridge {:.2f} ops/B\n",
+             machine.name, machine.peak_gops, machine.bandwidth_gbs,
+             machine.ridge());
+  fmt::print("{:<16} {:<10} {:>10} {:>10} {:>10} {:>8} {:>8} {:>10}\n",
+             "layer", "type", "ops/B", "time us", "GOP/s", "of roof",
+             "bound", "lost us");
+  for (size_t i = 0; i < points.size() && i < top; ++i) {
+    const auto& p = points[i];
+    const double roof = machine.Attainable(p.intensity());
+    fmt::print(
+        "{:<16} {:<10} {:>10.2f} {:>10.2f} {:>10.3f} {:>7.1f}% {:>8} "
+        "{:>10.2f}\n",
+        p.layer, p.type, p.intensity(), p.time_us, p.gops(),
+        roof > 0 ? 100.0 * p.gops() / roof : 0.0,
+        p.intensity() < machine.ridge() ? "memory" : "compute",
+        LostTime(p, machine));
+  }
+}
+
+}  // namespace
+
+int main(int argc, char* argv[]) {
+  std::vector<size_t> input_shape = {1, 28, 28};
+  size_t batch = 1;
+  size_t runs = 20;
+  size_t top = 5;
+  qnn::dse::AcceleratorConfig config;
+  std::string csv = "roofline.csv";
+  std::string svg = "roofline.svg";
+  std::string model_path;
+
+  try {
+    for (int i = 1; i < argc; ++i) {
+      std::string arg = argv[i];
+      auto value = [&]() -> std::string {
+        if (i + 1 >= argc) {
+          throw std::invalid_argument("missing value for " + arg);
+        }
+        return argv[++i];
+      };
+
+      if (arg == "--input") {
+        input_shape = parse_shape(value());
+      } else if (arg == "--batch") {
+        batch = parse_count(value());
+      } else if (arg == "--runs") {
+        runs = parse_count(value());
+      } else if (arg == "--array") {
+        config.array_size = parse_count(value());
+      } else if (arg == "--buffer-kb") {
+        config.buffer_bytes = parse_count(value()) * 1024;
+      } else if (arg == "--dma-bytes") {
+        config.dma_bytes_per_cycle = parse_count(value());
+      } else if (arg == "--channels") {
+        config.dma_channels = parse_count(value());
+      } else if (arg == "--clock-mhz") {
+        config.clock_mhz = parse_count(value());
+      } else if (arg == "--csv") {
+        csv = value();
+      } else if (arg == "--svg") {
+        svg = value();
+      } else if (arg == "--top") {
+        top = parse_count(value());
+      } else if (arg == "-h" || arg == "--help") {
+        usage(argv[0]);
+        return 0;
+      } else if (!arg.empty() && arg[0] == '-') {
+        throw std::invalid_argument("unknown option " + arg);
+      } else {
+        model_path = arg;
+      }
+    }
+  } catch (const std::exception& e) {
+    spdlog::error("{}", e.what());
+    usage(argv[0]);
+    return 1;
+  }
+
+  if (model_path.empty()) {
+    usage(argv[0]);
+    return 1;
+  }
+
+  try {
+    const std::vector<size_t> shape = {batch, input_shape[0], input_shape[1],
+                                       input_shape[2]};
+    auto workloads = qnn::LoadWorkloads(model_path, shape);
+    auto model = qnn::Model::loadModel(model_path);
+
+    // Any input in [0, 1) exercises the same work
+    qnn::Tensor<float> input;
+    input.resize(shape);
+    for (size_t i = 0; i < input.size(); ++i) {
+      input.data()[i] = static_cast<float>((i * 37) % 256) / 256.0f;
+    }
+
+    // Warm up, then profile
+    model.forward(input);
+    model.EnableProfiling();
+    for (size_t r = 0; r < runs; ++r) {
+      model.forward(input);
+    }
+
+    spdlog::info("Measuring host peak int8 throughput and bandwidth");
+    qnn::roofline::Machine cpu;
+    cpu.name = "cpu";
+    cpu.peak_gops = qnn::roofline::MeasurePeakGops();
+    cpu.bandwidth_gbs = qnn::roofline::MeasureBandwidth();
+    qnn::roofline::Machine accel = qnn::roofline::AcceleratorMachine(config);
+
+    std::vector<qnn::roofline::Point> points;
+    const auto& profile = model.Profile();
+    for (size_t i = 0; i < workloads.size() && i < profile.size(); ++i) {
+      const auto& w = workloads[i];
+      if (qnn::roofline::Ops(w) == 0 || profile[i].calls == 0) {
+        continue;
+      }
+      qnn::roofline::Point p;
+      p.target = cpu.name;
+      p.layer = w.name;
+      p.type = w.type;
+      p.ops = qnn::roofline::Ops(w);
+      p.bytes = static_cast<double>(w.bytes());
+      p.time_us = profile[i].mean_us();
+      points.push_back(p);
+    }
+    auto accel_points =
+        qnn::roofline::AcceleratorPoints(workloads, config, accel.name);
+    points.insert(points.end(), accel_points.begin(), accel_points.end());
+
+    const std::vector<qnn::roofline::Machine> machines = {cpu, accel};
+    std::ofstream csv_out(csv);
+    std::ofstream svg_out(svg);
+    if (!csv_out.is_open() || !svg_out.is_open()) {
+      throw std::runtime_error("Failed to open output files");
+    }
+    qnn::roofline::WriteCsv(csv_out, machines, points);
+    qnn::roofline::WriteSvg(svg_out, machines, points);
+
+    for (const auto& m : machines) {
+      print_top(m, points, top);
+    }
+    fmt::print("\nWrote {} and {}\n", csv, svg);
+  } catch (const std::exception& e) {
+    spdlog::error("{}", e.what());
+    return 1;
+  }
+
+  return 0;
+}
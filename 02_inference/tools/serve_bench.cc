@@ -0,0 +1,218 @@
+/**
+ * @file serve_bench.cc
+ * @author Leo (zhsleo@outlook.com)
+ *
+ * @brief Deadline misses, shedding and batch size of the batching server
+ * under changing load
+ * @version 1.0.0
+ * @date 2026-10-18
+ */
+
+#include <fmt/format.h>
+#include <spdlog/spdlog.h>
+
+#include <algorithm>
+#include <chrono>
+#include <future>
+#include <random>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "serving.hpp"
+
+namespace {
+
+void usage(const char* prog) {
+  fmt::print(
+      "Usage: {} [options] <model.json>\n"
+      "  --input CxHxW      Input shape (default 1x28x28)\n"
+      "  --rates R,R,...    Offered load of each phase in requests/s\n"
+      "                     (default 0.5,2,6,0.5 times the batch-1 rate)\n"
+      "  --phase-ms N       Length of each phase (default 2000)\n"
+      "  --deadline-us N    Deadline of each request (default 20000)\n"
+      "  --p99-us N         p99 latency target (default 10000)\n"
+      "  --max-batch N      Batch size limit (default 32)\n"
+      "  --fixed            Always batch up to the limit\n",
+      prog);
+}
+
+size_t parse_count(const std::string& text) {
+  size_t value = std::stoull(text);
+  if (value == 0) {
+    throw std::invalid_argument("expected a positive number: " + text);
+  }
+  return value;
+}
+
+std::vector<size_t> parse_shape(const std::string& text) {
+  std::vector<size_t> shape;
+  std::stringstream ss(text);
+  std::string item;
+  while (std::getline(ss, item, 'x')) {
+    shape.push_back(parse_count(item));
+  }
+  if (shape.size() != 3) {
+    throw std::invalid_argument("input shape must be CxHxW: " + text);
+  }
+  return shape;
+}
+
+std::vector<double> parse_rates(const std::string& text) {
+  std::vector<double> rates;
+  std::stringstream ss(text);
+  std::string item;
+  while (std::getline(ss, item, ',')) {
+    rates.push_back(std::stod(item));
+    if (rates.back() <= 0) {
+      throw std::invalid_argument("rates must be positive: " + text);
+    }
+  }
+  return rates;
+}
+
+}  // namespace
+
+int main(int argc, char* argv[]) {
+  using Clock = std::chrono::steady_clock;
+
+  std::vector<size_t> input_shape = {1, 28, 28};
+  std::vector<double> rates;
+  size_t phase_ms = 2000;
+  size_t deadline_us = 20000;
+  qnn::ServerOptions options;
+  std::string model_path;
+
+  try {
+    for (int i = 1; i < argc; ++i) {
+      std::string arg = argv[i];
+      auto value = [&]() -> std::string {
+        if (i + 1 >= argc) {
+          throw std::invalid_argument("missing value for " + arg);
+        }
+        return argv[++i];
+      };
+
+      if (arg == "--input") {
+        input_shape = parse_shape(value());
+      } else if (arg == "--rates") {
+        rates = parse_rates(value());
+      } else if (arg == "--phase-ms") {
+        phase_ms = parse_count(value());
+      } else if (arg == "--deadline-us") {
+        deadline_us = parse_count(value());
+      } else if (arg == "--p99-us") {
+        options.p99_target_us = static_cast<double>(parse_count(value()));
+      } else if (arg == "--max-batch") {
+        options.max_batch = parse_count(value());
+      } else if (arg == "--fixed") {
+        options.adaptive = false;
+      } else if (arg == "-h" || arg == "--help") {
+        usage(argv[0]);
+        return 0;
+      } else if (!arg.empty() && arg[0] == '-') {
+        throw std::invalid_argument("unknown option " + arg);
+      } else {
+        model_path = arg;
+      }
+    }
+  } catch (const std::exception& e) {
+    spdlog::error("{}", e.what());
+    usage(argv[0]);
+    return 1;
+  }
+
+  if (model_path.empty()) {
+    usage(argv[0]);
+    return 1;
+  }
+
+  try {
+    qnn::Model model = qnn::Model::loadModel(model_path);
+
+    qnn::Tensor<float> input;
+    input.resize(std::vector<size_t>{1, input_shape[0], input_shape[1],
+                                     input_shape[2]});
+    std::mt19937 rng(42);
+    std::uniform_real_distribution<float> pixel(0.0f, 1.0f);
+    for (size_t i = 0; i < input.size(); ++i) {
+      input.data()[i] = pixel(rng);
+    }
+
+    if (rates.empty()) {
+      // Scale the default phases to what batch 1 sustains on this machine
+      model.forward(input);
+      const auto start = Clock::now();
+      const int runs = 20;
+      for (int i = 0; i < runs; ++i) {
+        model.forward(input);
+      }
+      const std::chrono::duration<double> elapsed = Clock::now() - start;
+      const double base = runs / elapsed.count();
+      rates = {0.5 * base, 2 * base, 6 * base, 0.5 * base};
+    }
+
+    qnn::BatchServer server(model, options);
+    fmt::print("Deadline {} us, p99 target {:.0f} us, {} batching up to {}\n\n",
+               deadline_us, options.p99_target_us,
+               options.adaptive ? "adaptive" : "fixed", options.max_batch);
+    fmt::print("{:>10} {:>9} {:>9} {:>9} {:>9} {:>9} {:>10} {:>8}\n",
+               "offered/s", "served/s", "rejected", "shed", "missed",
+               "p50 us", "p99 us", "limit");
+
+    for (double rate : rates) {
+      const qnn::ServerStats before = server.Stats();
+      std::exponential_distribution<double> gap(rate);
+      std::vector<std::future<qnn::ServeResult>> results;
+
+      // Open-loop Poisson arrivals
+      const auto start = Clock::now();
+      const auto end = start + std::chrono::milliseconds(phase_ms);
+      auto next = start;
+      while (next < end) {
+        std::this_thread::sleep_until(next);
+        results.push_back(
+            server.Submit(input, std::chrono::microseconds(deadline_us)));
+        next += std::chrono::duration_cast<Clock::duration>(
+            std::chrono::duration<double>(gap(rng)));
+      }
+
+      std::vector<double> latencies;
+      for (auto& r : results) {
+        const qnn::ServeResult result = r.get();
+        if (result.status == qnn::ServeStatus::kOk) {
+          latencies.push_back(result.latency_us);
+        }
+      }
+      const std::chrono::duration<double> elapsed = Clock::now() - start;
+      const qnn::ServerStats after = server.Stats();
+
+      double p50 = 0.0, p99 = 0.0;
+      if (!latencies.empty()) {
+        std::sort(latencies.begin(), latencies.end());
+        p50 = latencies[latencies.size() / 2];
+        p99 = latencies[std::min(latencies.size() - 1,
+                                 latencies.size() * 99 / 100)];
+      }
+      fmt::print("{:>10.0f} {:>9.0f} {:>9} {:>9} {:>9} {:>9.0f} {:>10.0f} "
+                 "{:>8}\n",
+                 rate, (after.completed - after.missed - before.completed +
+                        before.missed) /
+                           elapsed.count(),
+                 after.rejected - before.rejected, after.shed - before.shed,
+                 after.missed - before.missed, p50, p99, after.batch_limit);
+    }
+
+    fmt::print("\nPredicted batch latency:");
+    for (size_t b = 1; b <= options.max_batch; b *= 2) {
+      fmt::print(" {}:{:.0f}us", b, server.PredictBatch(b));
+    }
+    fmt::print("\n");
+  } catch (const std::exception& e) {
+    spdlog::error("{}", e.what());
+    return 1;
+  }
+
+  return 0;
+}
@@ -52,8 +52,9 @@ qnn::Tensor<T> load_image(const std::string& img_path) {
 }
 
 int main(int argc, char* argv[]) {
-  if (argc != 3) {
-    spdlog::error("Usage: {} <path_to_model> <path_to_image>", argv[0]);
+  if (argc != 3 && argc != 4) {
+    spdlog::error("Usage: {} <path_to_model> <path_to_image> [verify_rate]",
+                  argv[0]);
     return 1;
   }
 
@@ -63,6 +64,11 @@ int main(int argc, char* argv[]) {
 
     spdlog::info("Model loaded: {}", argv[1]);
 
+    // Optionally check the layers against the systolic array golden model
+    if (argc == 4) {
+      model.EnableVerification(std::stod(argv[3]));
+    }
+
     // Load image and create input tensor
     std::string image_path = argv[2];
     auto input = load_image<float>(image_path);
@@ -84,6 +90,13 @@ int main(int argc, char* argv[]) {
           spdlog::info("Prediction: {}", max_index);
         },
         output);
+
+    for (const auto& layer : model.VerificationReport()) {
+      spdlog::info("Verify {} ({}): {}/{} accumulator, {}/{} output mismatches",
+                   layer.name, layer.type, layer.totals.accumulator_mismatches,
+                   layer.totals.elements, layer.totals.output_mismatches,
+                   layer.totals.elements);
+    }
   } catch (const std::exception& e) {
     spdlog::error("Error: {}", e.what());
     return 1;
@@ -14,8 +14,21 @@
 extern "C" {
 #endif
 
+#include "accel_arena.h"
+#include "accel_broker.h"
 #include "accel_config.h"
+#include "accel_dma.h"
+#include "accel_mem.h"
+#include "accel_queue.h"
+#include "accel_tenant.h"
 #include "accel_types.h"
+
+// Initialization flags
+#define ACCEL_INIT_CACHED (1 << 0)   /**< Cached mapping, explicit buffer sync */
+#define ACCEL_INIT_PREFAULT (1 << 1) /**< Populate page tables at init */
+#define ACCEL_INIT_HUGE_2M (1 << 2)  /**< Back mappings with 2MB pages */
+#define ACCEL_INIT_HUGE_1G (1 << 3)  /**< Back mappings with 1GB pages */
+
 /**
  * @brief Initialize the accelerator
  * @param device_path Path to device file
@@ -23,6 +36,28 @@ extern "C" {
  */
 accel_status_t accel_init(const char* device_path);
 
+/**
+ * @brief Initialize the accelerator with initialization flags
+ *
+ * With ACCEL_INIT_CACHED device memory is mapped cacheable, so host-side
+ * pre- and post-processing runs at full cache speed. Host writes must then
+ * be published with accel_buffer_sync_for_device() before an op reads them,
+ * and device results made visible with accel_buffer_sync_for_cpu() before
+ * the host reads them.
+ *
+ * ACCEL_INIT_PREFAULT maps device memory with its page tables populated,
+ * moving page faults from the first inference to startup.
+ * ACCEL_INIT_HUGE_2M and ACCEL_INIT_HUGE_1G back it with huge pages to cut
+ * TLB misses; without reserved huge pages the mapping is aligned and marked
+ * for transparent huge pages instead. accel_get_mem_stats() reports the page
+ * size in use.
+ *
+ * @param device_path Path to device file
+ * @param flags Initialization flags (ACCEL_INIT_*)
+ * @return Status code
+ */
+accel_status_t accel_init_flags(const char* device_path, uint32_t flags);
+
 /**
  * @brief Clean up accelerator resources
  */
@@ -41,15 +76,60 @@ accel_buffer_t* accel_alloc_buffer(uint32_t size);
  */
 void accel_free_buffer(accel_buffer_t* buffer);
 
+/**
+ * @brief Describe existing device memory as a buffer without allocating
+ *
+ * Used to alias memory that already lives in the mapped device region, e.g.
+ * a sub-range of another buffer. Release with accel_release_buffer(). When
+ * the buffer it lies in is freed, the import is invalidated: its address
+ * and size become 0.
+ *
+ * @param host_addr Host virtual address inside device memory
+ * @param size Range size in bytes
+ * @return Buffer descriptor, NULL if the range is not in device memory
+ */
+accel_buffer_t* accel_import_buffer(void* host_addr, uint32_t size);
+
+/**
+ * @brief Free a descriptor from accel_import_buffer(), keeping the memory
+ * @param buffer Buffer descriptor to release
+ */
+void accel_release_buffer(accel_buffer_t* buffer);
+
+/**
+ * @brief Make host writes to a buffer range visible to the device
+ * @param buffer Buffer descriptor
+ * @param offset Start of range in bytes
+ * @param size Size of range in bytes (0 for the rest of the buffer)
+ * @return Status code
+ */
+accel_status_t accel_buffer_sync_for_device(const accel_buffer_t* buffer,
+                                            uint32_t offset, uint32_t size);
+
+/**
+ * @brief Make device writes to a buffer range visible to the host
+ * @param buffer Buffer descriptor
+ * @param offset Start of range in bytes
+ * @param size Size of range in bytes (0 for the rest of the buffer)
+ * @return Status code
+ */
+accel_status_t accel_buffer_sync_for_cpu(const accel_buffer_t* buffer,
+                                         uint32_t offset, uint32_t size);
+
 /**
  * @brief Submit operation to accelerator
+ *
+ * The operation is placed on the priority submission queue; use
+ * accel_wait_complete() or accel_submit_op_async()/accel_wait_op() to
+ * observe completion.
+ *
  * @param params Operation parameters
  * @return Status code
  */
 accel_status_t accel_submit_op(const accel_op_params_t* params);
 
 /**
- * @brief Wait for operation completion
+ * @brief Wait for completion of every submitted operation
  * @param timeout_ms Timeout in milliseconds (0 for infinite)
  * @return Status code
  */
@@ -0,0 +1,82 @@
+/**
+ * @file accel_arena.h
+ * @author Leo (zhsleo@outlook.com)
+ *
+ * @brief Host memory arenas for activations and scratch buffers
+ * @version 1.0.0
+ * @date 2026-10-18
+ */
+
+#ifndef ACCEL_ARENA_H
+#define ACCEL_ARENA_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "accel_types.h"
+
+/**
+ * @brief Opaque host memory arena
+ *
+ * A bump allocator over one mapping. Allocations are released together by
+ * accel_arena_reset(), typically once per inference, so the same pages are
+ * reused and stay mapped.
+ */
+typedef struct accel_arena accel_arena_t;
+
+/**
+ * @brief Create a host memory arena
+ *
+ * Takes the page flags of accel_init_flags(): ACCEL_INIT_PREFAULT touches
+ * all pages up front, ACCEL_INIT_HUGE_2M / ACCEL_INIT_HUGE_1G request huge
+ * pages. Does not require an initialized driver.
+ *
+ * @param size Arena capacity in bytes
+ * @param flags ACCEL_INIT_* page flags
+ * @return Arena, NULL on failure
+ */
+accel_arena_t* accel_arena_create(size_t size, uint32_t flags);
+
+/**
+ * @brief Destroy an arena and unmap its memory
+ * @param arena Arena (may be NULL)
+ */
+void accel_arena_destroy(accel_arena_t* arena);
+
+/**
+ * @brief Allocate from an arena
+ * @param arena Arena
+ * @param size Number of bytes
+ * @param align Alignment, a power of two (0 for 64 bytes)
+ * @return Pointer into the arena, NULL if it is exhausted
+ */
+void* accel_arena_alloc(accel_arena_t* arena, size_t size, size_t align);
+
+/**
+ * @brief Release all allocations of an arena
+ * @param arena Arena
+ */
+void accel_arena_reset(accel_arena_t* arena);
+
+/**
+ * @brief Get arena capacity
+ * @param arena Arena
+ * @return Capacity in bytes
+ */
+size_t accel_arena_capacity(const accel_arena_t* arena);
+
+/**
+ * @brief Get bytes allocated since the last reset
+ * @param arena Arena
+ * @return Used bytes, including alignment padding
+ */
+size_t accel_arena_used(const accel_arena_t* arena);
+
+/**
+ * @brief Get the page size backing an arena
+ * @param arena Arena
+ * @return Page size in bytes
+ */
+size_t accel_arena_page_size(const accel_arena_t* arena);
+
+#endif /* ACCEL_ARENA_H */
@@ -0,0 +1,208 @@
+/**
+ * @file accel_broker.h
+ * @author Leo (zhsleo@outlook.com)
+ *
+ * @brief Accelerator broker: share one device between local processes
+ * @version 1.0.0
+ * @date 2026-10-18
+ */
+
+#ifndef ACCEL_BROKER_H
+#define ACCEL_BROKER_H
+
+#include "accel_queue.h"
+#include "accel_tenant.h"
+#include "accel_types.h"
+
+/**
+ * @brief Maximum number of connected clients
+ *
+ * Every client gets a tenant of its own, the default tenant stays with the
+ * broker process.
+ */
+#define ACCEL_BROKER_MAX_CLIENTS (ACCEL_MAX_TENANTS - 1)
+
+/**
+ * @brief Opaque broker instance
+ *
+ * The broker runs in a process that owns the device through accel_init().
+ * It listens on a Unix socket and serves each connected process from one
+ * thread. Buffers are allocated from device memory, and each is shadowed by
+ * a memfd of its own that the client maps, so a client only ever sees its
+ * own buffers. The broker copies an op's inputs into device memory when it
+ * queues the op and the output back when it completes. The ops of a
+ * submission message go to the driver queue in one submission, and
+ * completions are returned in batches.
+ */
+typedef struct accel_broker accel_broker_t;
+
+/**
+ * @brief Opaque client connection to a broker
+ *
+ * A connection is not thread safe; use one connection per thread.
+ */
+typedef struct accel_client accel_client_t;
+
+/**
+ * @brief Broker settings
+ */
+typedef struct {
+  accel_tenant_config_t tenant; /**< Partition given to every client */
+} accel_broker_config_t;
+
+/**
+ * @brief Broker statistics
+ *
+ * Each received message may carry several submissions and each completion
+ * message several completions, so the ratios of ops to messages and to
+ * queue submissions show how well the broker batches.
+ */
+typedef struct {
+  uint32_t clients;             /**< Clients currently connected */
+  uint64_t connections;         /**< Clients accepted */
+  uint64_t rejected;            /**< Connections refused (no tenant slot) */
+  uint64_t ops_submitted;       /**< Ops submitted to the driver */
+  uint64_t queue_submissions;   /**< Driver queue submissions carrying them */
+  uint64_t ops_completed;       /**< Completions returned to clients */
+  uint64_t messages_received;   /**< Client messages handled */
+  uint64_t completion_messages; /**< Completion batches sent */
+  uint64_t stalls;              /**< Times a client waited for queue space */
+  uint64_t bytes_copied;        /**< Bytes copied to and from device memory */
+} accel_broker_stats_t;
+
+/**
+ * @brief Start serving the device on a Unix socket
+ *
+ * The driver must be initialized and stay initialized until the broker is
+ * stopped. An existing socket file at @p socket_path is replaced.
+ *
+ * @param socket_path Filesystem path of the listening socket
+ * @param config Broker settings (NULL for weight 1 and no limits)
+ * @return Broker, NULL on failure
+ */
+accel_broker_t* accel_broker_start(const char* socket_path,
+                                   const accel_broker_config_t* config);
+
+/**
+ * @brief Stop a broker
+ *
+ * Waits for in-flight ops, disconnects all clients and frees their buffers
+ * and tenants.
+ *
+ * @param broker Broker (may be NULL)
+ */
+void accel_broker_stop(accel_broker_t* broker);
+
+/**
+ * @brief Get broker statistics
+ * @param broker Broker
+ * @param stats Pointer to store statistics
+ * @return Status code
+ */
+accel_status_t accel_get_broker_stats(accel_broker_t* broker,
+                                      accel_broker_stats_t* stats);
+
+/**
+ * @brief Connect to a broker
+ *
+ * Does not require an initialized driver. Errors are reported through
+ * accel_get_error().
+ *
+ * @param socket_path Socket the broker listens on
+ * @return Connection, NULL on failure
+ */
+accel_client_t* accel_client_connect(const char* socket_path);
+
+/**
+ * @brief Close a connection
+ *
+ * The broker frees all buffers of the connection once its ops completed.
+ *
+ * @param client Connection (may be NULL)
+ */
+void accel_client_disconnect(accel_client_t* client);
+
+/**
+ * @brief Get the tenant the broker assigned to a connection
+ * @param client Connection
+ * @return Tenant identifier
+ */
+accel_tenant_t accel_client_tenant(const accel_client_t* client);
+
+/**
+ * @brief Allocate a device buffer through the broker
+ *
+ * The buffer is charged to the connection's tenant. host_addr points at
+ * memory shared with the broker only for this buffer; the broker copies it
+ * to the device when an op reading it is queued and copies an op's output
+ * back before reporting the op complete. Only the first size bytes of the
+ * descriptors passed with an op are copied, so a descriptor may be shrunk
+ * to the part an op uses. A buffer must not be modified while ops using it
+ * are in flight.
+ *
+ * @param client Connection
+ * @param size Buffer size in bytes
+ * @return Buffer descriptor, NULL on failure
+ */
+accel_buffer_t* accel_client_alloc_buffer(accel_client_t* client,
+                                          uint32_t size);
+
+/**
+ * @brief Free a buffer allocated with accel_client_alloc_buffer()
+ * @param client Connection
+ * @param buffer Buffer descriptor (may be NULL)
+ */
+void accel_client_free_buffer(accel_client_t* client, accel_buffer_t* buffer);
+
+/**
+ * @brief Submit operations without waiting for them
+ *
+ * All operations go to the broker in one message. Buffers must come from
+ * accel_client_alloc_buffer() on the same connection; params->tenant is
+ * ignored. Errors found by the broker are reported as the completion
+ * status of the op.
+ *
+ * @param client Connection
+ * @param params Array of @p count operations
+ * @param count Number of operations
+ * @param handles Receives @p count handles (may be NULL)
+ * @return Status code
+ */
+accel_status_t accel_client_submit_batch(accel_client_t* client,
+                                         const accel_op_params_t* params,
+                                         uint32_t count,
+                                         accel_op_handle_t* handles);
+
+/**
+ * @brief Submit one operation without waiting for it
+ * @param client Connection
+ * @param params Operation parameters
+ * @param handle Receives handle of the submitted op (may be NULL)
+ * @return Status code
+ */
+accel_status_t accel_client_submit_op_async(accel_client_t* client,
+                                            const accel_op_params_t* params,
+                                            accel_op_handle_t* handle);
+
+/**
+ * @brief Wait for a specific operation of the connection to complete
+ * @param client Connection
+ * @param handle Handle returned at submission
+ * @param timeout_ms Timeout in milliseconds (0 for infinite)
+ * @return Completion status of the op, or ACCEL_STATUS_TIMEOUT
+ */
+accel_status_t accel_client_wait_op(accel_client_t* client,
+                                    accel_op_handle_t handle,
+                                    uint32_t timeout_ms);
+
+/**
+ * @brief Wait for all operations of the connection to complete
+ * @param client Connection
+ * @param timeout_ms Timeout in milliseconds (0 for infinite)
+ * @return First failing completion status, ACCEL_STATUS_OK, or
+ *         ACCEL_STATUS_TIMEOUT
+ */
+accel_status_t accel_client_wait_complete(accel_client_t* client,
+                                          uint32_t timeout_ms);
+
+#endif /* ACCEL_BROKER_H */
@@ -0,0 +1,94 @@
+/**
+ * @file accel_dma.h
+ * @author Leo (zhsleo@outlook.com)
+ *
+ * @brief DMA transfer cost accounting from the HAL controller model
+ * @version 1.0.0
+ * @date 2026-10-18
+ */
+
+#ifndef ACCEL_DMA_H
+#define ACCEL_DMA_H
+
+#include "accel_types.h"
+
+/**
+ * @brief Largest single DMA transfer (26-bit length register)
+ *
+ * Tiles longer than this are issued as several transfers.
+ */
+#define ACCEL_DMA_MAX_TRANSFER ((1u << 26) - 1)
+
+/**
+ * @brief DMA channels
+ */
+typedef enum {
+  ACCEL_DMA_READ = 0, /**< Memory to accelerator (MM2S) */
+  ACCEL_DMA_WRITE,    /**< Accelerator to memory (S2MM) */
+  ACCEL_DMA_CHANNELS
+} accel_dma_channel_t;
+
+/**
+ * @brief Cycle costs of the DMA controller model, in AXI clock cycles
+ */
+typedef struct {
+  uint32_t clock_mhz;         /**< AXI clock frequency */
+  uint32_t lite_read_cycles;  /**< AXI-Lite read, excluding slave latency */
+  uint32_t lite_write_cycles; /**< AXI-Lite write, excluding slave latency */
+  uint32_t slave_latency;     /**< Added to every AXI-Lite access */
+  uint32_t state_cycles;      /**< Per controller state transition */
+  uint32_t startup_cycles;    /**< Length write to first data beat */
+  uint32_t irq_cycles;        /**< Last data beat to IRQ seen */
+  uint32_t bytes_per_cycle;   /**< Stream data width in bytes */
+} accel_dma_timing_t;
+
+/**
+ * @brief DMA statistics of one channel
+ *
+ * Every tile the driver executes is one DMA request per channel. Setup time
+ * is the register programming and interrupt handling each transfer pays
+ * regardless of its size; efficiency is the share of data time, which
+ * larger tiles (accel_config_t::max_transfer) improve.
+ */
+typedef struct {
+  uint64_t requests;       /**< Tiles transferred */
+  uint64_t transfers;      /**< Controller transfers, after length splits */
+  uint64_t bytes;          /**< Payload bytes */
+  uint64_t lite_accesses;  /**< AXI-Lite register accesses */
+  uint64_t setup_cycles;   /**< Control overhead cycles */
+  uint64_t data_cycles;    /**< Payload cycles */
+  uint64_t setup_ns;       /**< Control overhead at the model clock */
+  uint64_t data_ns;        /**< Payload time at the model clock */
+  uint32_t efficiency_pct; /**< Data time share of the total */
+} accel_dma_stats_t;
+
+/**
+ * @brief Get DMA statistics of a channel
+ * @param channel Channel
+ * @param stats Pointer to store statistics
+ * @return Status code
+ */
+accel_status_t accel_get_dma_stats(accel_dma_channel_t channel,
+                                   accel_dma_stats_t* stats);
+
+/**
+ * @brief Reset DMA statistics of both channels
+ * @return Status code
+ */
+accel_status_t accel_reset_dma_stats(void);
+
+/**
+ * @brief Set the cycle costs of the DMA controller model
+ * @param timing Timing; clock_mhz and bytes_per_cycle must be non-zero
+ * @return Status code
+ */
+accel_status_t accel_set_dma_timing(const accel_dma_timing_t* timing);
+
+/**
+ * @brief Get the cycle costs of the DMA controller model
+ * @param timing Pointer to store the timing
+ * @return Status code
+ */
+accel_status_t accel_get_dma_timing(accel_dma_timing_t* timing);
+
+#endif /* ACCEL_DMA_H */
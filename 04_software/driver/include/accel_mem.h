@@ -0,0 +1,91 @@
+/**
+ * @file accel_mem.h
+ * @author Leo (zhsleo@outlook.com)
+ *
+ * @brief Device memory statistics, pinning and compaction
+ * @version 1.0.0
+ * @date 2026-10-18
+ */
+
+#ifndef ACCEL_MEM_H
+#define ACCEL_MEM_H
+
+#include "accel_types.h"
+
+/**
+ * @brief Device memory usage and fragmentation statistics
+ *
+ * Fragmentation is the share of free memory that lies outside the largest
+ * free block: an allocation of up to largest_free bytes succeeds, even if
+ * total_free is much larger.
+ */
+typedef struct {
+  uint64_t total_size;        /**< Size of the device memory region */
+  uint64_t total_free;        /**< Sum of all free blocks */
+  uint64_t largest_free;      /**< Largest single free block */
+  uint32_t free_blocks;       /**< Number of free blocks */
+  uint32_t live_buffers;      /**< Buffers allocated through the driver */
+  uint32_t pinned_buffers;    /**< Buffers that compaction must not move */
+  uint32_t fragmentation_pct; /**< 100 * (1 - largest_free / total_free) */
+  uint64_t compactions;       /**< Compaction passes run */
+  uint64_t bytes_moved;       /**< Bytes relocated by all passes */
+  uint64_t page_size;         /**< Page size backing device memory */
+} accel_mem_stats_t;
+
+/**
+ * @brief Get device memory statistics
+ * @param stats Pointer to store statistics
+ * @return Status code
+ */
+accel_status_t accel_get_mem_stats(accel_mem_stats_t* stats);
+
+/**
+ * @brief Compact device memory
+ *
+ * Moves unpinned buffers towards the start of device memory so that their
+ * free space merges into one block. Moved buffers keep their descriptor
+ * (the stable handle); its host_addr and dev_addr are patched, and so are
+ * descriptors from accel_import_buffer() inside a moved buffer. Queued
+ * operations pick up the new addresses at their next tile. Waits for the
+ * tile currently executing on the device.
+ *
+ * Host pointers obtained from a descriptor are only stable while the buffer
+ * is pinned.
+ *
+ * @param bytes_moved Receives number of bytes relocated (may be NULL)
+ * @return Status code
+ */
+accel_status_t accel_compact_memory(uint64_t* bytes_moved);
+
+/**
+ * @brief Keep a buffer at its current address
+ *
+ * Pins nest. Pinning an imported buffer pins the buffer it aliases.
+ *
+ * @param buffer Buffer descriptor
+ * @return Status code
+ */
+accel_status_t accel_buffer_pin(accel_buffer_t* buffer);
+
+/**
+ * @brief Release one pin of a buffer
+ * @param buffer Buffer descriptor
+ * @return Status code
+ */
+accel_status_t accel_buffer_unpin(accel_buffer_t* buffer);
+
+/**
+ * @brief Enable or disable background compaction
+ *
+ * A driver thread checks fragmentation every @p interval_ms and runs a
+ * compaction pass when it reaches @p threshold_pct. Only enable this when
+ * host code accesses buffer memory under accel_buffer_pin().
+ *
+ * @param threshold_pct Fragmentation threshold in percent (0 disables)
+ * @param interval_ms Check interval in milliseconds
+ * @return Status code
+ */
+accel_status_t accel_set_auto_compaction(uint32_t threshold_pct,
+                                         uint32_t interval_ms);
+
+#endif /* ACCEL_MEM_H */
@@ -0,0 +1,149 @@
+/**
+ * @file accel_queue.h
+ * @author Leo (zhsleo@outlook.com)
+ *
+ * @brief Multi-level asynchronous submission queue for accelerator driver
+ * @version 1.0.0
+ * @date 2026-10-18
+ */
+
+#ifndef ACCEL_QUEUE_H
+#define ACCEL_QUEUE_H
+
+#include "accel_types.h"
+
+/**
+ * @brief Handle identifying a submitted operation
+ */
+typedef uint64_t accel_op_handle_t;
+
+/**
+ * @brief Completion notification callback
+ *
+ * Invoked on the driver dispatcher thread once the op has completed. The
+ * callback must not block; it may submit further operations.
+ *
+ * @param handle Handle of the completed op
+ * @param status Completion status of the op
+ * @param user_data Pointer passed at submission
+ */
+typedef void (*accel_completion_fn)(accel_op_handle_t handle,
+                                    accel_status_t status, void* user_data);
+
+/**
+ * @brief Per-priority queue statistics
+ *
+ * Queueing delay is measured from submission to the first tile being
+ * dispatched; latency is measured from submission to completion.
+ */
+typedef struct {
+  uint64_t submitted;          /**< Operations submitted */
+  uint64_t completed;          /**< Operations completed */
+  uint64_t preempted;          /**< Times an op was preempted at a tile */
+  uint64_t total_queue_us;     /**< Sum of queueing delays */
+  uint64_t max_queue_us;       /**< Worst queueing delay */
+  uint64_t total_latency_us;   /**< Sum of end-to-end latencies */
+  uint64_t max_latency_us;     /**< Worst end-to-end latency */
+} accel_queue_stats_t;
+
+/**
+ * @brief Submit operation without waiting for it
+ *
+ * The effective priority is ACCEL_PRIORITY_HIGH if either params->priority
+ * requests it or ACCEL_CONFIG_HIGH_PRIORITY is set in the device
+ * configuration. Operations are split into tiles of at most
+ * accel_config_t::max_transfer input bytes.
+ *
+ * @param params Operation parameters
+ * @param handle Receives handle of the submitted op (may be NULL)
+ * @return Status code, ACCEL_STATUS_BUSY if the queue is full
+ */
+accel_status_t accel_submit_op_async(const accel_op_params_t* params,
+                                     accel_op_handle_t* handle);
+
+/**
+ * @brief Submit operation and get notified on completion
+ *
+ * Same as accel_submit_op_async(), additionally invoking @p callback once
+ * the op has completed.
+ *
+ * @param params Operation parameters
+ * @param callback Completion callback (may be NULL)
+ * @param user_data Pointer handed back to the callback
+ * @param handle Receives handle of the submitted op (may be NULL)
+ * @return Status code, ACCEL_STATUS_BUSY if the queue is full
+ */
+accel_status_t accel_submit_op_notify(const accel_op_params_t* params,
+                                      accel_completion_fn callback,
+                                      void* user_data,
+                                      accel_op_handle_t* handle);
+
+/**
+ * @brief Submit operation, waiting for room in the queue
+ *
+ * Same as accel_submit_op_async(), except that while the queue or the
+ * tenant's share of it is full, the caller sleeps until an op completes and
+ * tries again instead of getting ACCEL_STATUS_BUSY.
+ *
+ * @param params Operation parameters
+ * @param handle Receives handle of the submitted op (may be NULL)
+ * @param timeout_ms Longest wait for room in milliseconds (0 for infinite)
+ * @return Status code, ACCEL_STATUS_TIMEOUT if no room freed up in time
+ */
+accel_status_t accel_submit_op_wait(const accel_op_params_t* params,
+                                    accel_op_handle_t* handle,
+                                    uint32_t timeout_ms);
+
+/**
+ * @brief Submit several operations in one queue submission
+ *
+ * Ops are queued in order under a single acquisition of the queue lock and
+ * the dispatcher is woken once, so a batch costs about as much to submit as
+ * one op. Queueing stops at the first op that is invalid or does not fit;
+ * the ops before it stay queued.
+ *
+ * @param params Array of @p count operations
+ * @param count Number of operations
+ * @param callback Completion callback of every op (may be NULL)
+ * @param user_data Array of @p count callback arguments
+ * @param handles Receives @p count handles (may be NULL)
+ * @param queued Receives the number of ops queued (may be NULL)
+ * @return Status code of the first op not queued, ACCEL_STATUS_OK if all
+ *         were
+ */
+accel_status_t accel_submit_ops_notify(const accel_op_params_t* params,
+                                       uint32_t count,
+                                       accel_completion_fn callback,
+                                       void* const* user_data,
+                                       accel_op_handle_t* handles,
+                                       uint32_t* queued);
+
+/**
+ * @brief Wait for a specific operation to complete
+ *
+ * The status of the last few hundred completed ops is kept, so an op may
+ * be waited on some time after it finished; beyond that its status is gone.
+ *
+ * @param handle Handle returned by accel_submit_op_async
+ * @param timeout_ms Timeout in milliseconds (0 for infinite)
+ * @return Completion status of the op, ACCEL_STATUS_TIMEOUT, or
+ *         ACCEL_STATUS_EXPIRED if its status is no longer kept
+ */
+accel_status_t accel_wait_op(accel_op_handle_t handle, uint32_t timeout_ms);
+
+/**
+ * @brief Get queue statistics for one priority level
+ * @param priority Priority level
+ * @param stats Pointer to store statistics
+ * @return Status code
+ */
+accel_status_t accel_get_queue_stats(accel_priority_t priority,
+                                     accel_queue_stats_t* stats);
+
+/**
+ * @brief Reset queue statistics of all priority levels
+ * @return Status code
+ */
+accel_status_t accel_reset_queue_stats(void);
+
+#endif /* ACCEL_QUEUE_H */
@@ -0,0 +1,110 @@
+/**
+ * @file accel_tenant.h
+ * @author Leo (zhsleo@outlook.com)
+ *
+ * @brief Tenant partitioning: memory quotas and fair-share scheduling
+ * @version 1.0.0
+ * @date 2026-10-18
+ */
+
+#ifndef ACCEL_TENANT_H
+#define ACCEL_TENANT_H
+
+#include "accel_types.h"
+
+/**
+ * @brief Tenant identifier
+ *
+ * Tenant 0 always exists; buffers from accel_alloc_buffer() and ops with a
+ * zero accel_op_params_t::tenant belong to it.
+ */
+typedef uint32_t accel_tenant_t;
+
+#define ACCEL_TENANT_DEFAULT 0     /**< Tenant of untagged work */
+#define ACCEL_MAX_TENANTS 16       /**< Tenant slots, including the default */
+#define ACCEL_TENANT_MAX_WEIGHT 1000 /**< Largest fair-share weight */
+
+/**
+ * @brief Tenant partition settings
+ */
+typedef struct {
+  uint64_t mem_quota;  /**< Device memory limit in bytes, 0 for unlimited */
+  uint32_t weight;     /**< Fair-share weight, 1..ACCEL_TENANT_MAX_WEIGHT */
+  uint32_t max_queued; /**< Ops queued at once, 0 for no limit */
+} accel_tenant_config_t;
+
+/**
+ * @brief Per-tenant usage and throttling statistics
+ *
+ * Fair share divides processed bytes between the tenants with queued work
+ * in proportion to their weights. Device time is the time spent executing
+ * the tenant's tiles. A throttled tile is a dispatch decision in which the
+ * tenant had an op waiting at the winning priority level but another tenant
+ * was further behind its fair share.
+ */
+typedef struct {
+  uint64_t mem_quota;        /**< Configured memory limit (0 = unlimited) */
+  uint64_t mem_used;         /**< Device memory allocated */
+  uint64_t mem_peak;         /**< Highest mem_used */
+  uint64_t alloc_denied;     /**< Allocations refused by the quota */
+  uint32_t weight;           /**< Configured fair-share weight */
+  uint32_t queued;           /**< Ops currently queued or running */
+  uint64_t submitted;        /**< Operations submitted */
+  uint64_t completed;        /**< Operations completed */
+  uint64_t submit_rejected;  /**< Submissions refused by max_queued */
+  uint64_t throttled_tiles;  /**< Tiles deferred for other tenants */
+  uint64_t bytes_processed;  /**< Input bytes of executed tiles */
+  uint64_t device_time_us;   /**< Device time consumed */
+  uint64_t total_latency_us; /**< Sum of end-to-end latencies */
+  uint64_t max_latency_us;   /**< Worst end-to-end latency */
+} accel_tenant_stats_t;
+
+/**
+ * @brief Create a tenant
+ * @param config Tenant settings
+ * @param tenant Receives the tenant identifier
+ * @return Status code, ACCEL_STATUS_BUSY if all slots are taken
+ */
+accel_status_t accel_tenant_create(const accel_tenant_config_t* config,
+                                   accel_tenant_t* tenant);
+
+/**
+ * @brief Change the settings of a tenant
+ *
+ * Lowering the quota below current usage does not free anything; further
+ * allocations fail until usage drops under the new limit.
+ *
+ * @param tenant Tenant identifier (may be ACCEL_TENANT_DEFAULT)
+ * @param config New settings
+ * @return Status code
+ */
+accel_status_t accel_tenant_configure(accel_tenant_t tenant,
+                                      const accel_tenant_config_t* config);
+
+/**
+ * @brief Destroy a tenant
+ * @param tenant Tenant identifier, not ACCEL_TENANT_DEFAULT
+ * @return Status code, ACCEL_STATUS_BUSY while the tenant still owns
+ *         buffers or queued ops
+ */
+accel_status_t accel_tenant_destroy(accel_tenant_t tenant);
+
+/**
+ * @brief Allocate a buffer charged to a tenant's memory quota
+ * @param tenant Tenant identifier
+ * @param size Buffer size in bytes
+ * @return Buffer descriptor, NULL on failure or if the quota is exhausted
+ */
+accel_buffer_t* accel_tenant_alloc_buffer(accel_tenant_t tenant,
+                                          uint32_t size);
+
+/**
+ * @brief Get usage statistics of a tenant
+ * @param tenant Tenant identifier
+ * @param stats Pointer to store statistics
+ * @return Status code
+ */
+accel_status_t accel_get_tenant_stats(accel_tenant_t tenant,
+                                      accel_tenant_stats_t* stats);
+
+#endif /* ACCEL_TENANT_H */
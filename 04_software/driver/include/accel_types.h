@@ -31,9 +31,22 @@ typedef enum {
   ACCEL_STATUS_NO_MEMORY,
   ACCEL_STATUS_TIMEOUT,
   ACCEL_STATUS_BUSY,
-  ACCEL_STATUS_NOT_INITIALIZED
+  ACCEL_STATUS_NOT_INITIALIZED,
+  ACCEL_STATUS_EXPIRED
 } accel_status_t;
 
+/**
+ * @brief Submission priority levels
+ *
+ * High-priority operations preempt queued normal-priority work at tile
+ * boundaries.
+ */
+typedef enum {
+  ACCEL_PRIORITY_NORMAL = 0, /**< Bulk / batch work */
+  ACCEL_PRIORITY_HIGH,       /**< Latency-critical work */
+  ACCEL_PRIORITY_LEVELS      /**< Number of priority levels */
+} accel_priority_t;
+
 /**
  * @brief Memory buffer descriptor
  */
@@ -41,17 +54,20 @@ typedef struct {
   void* host_addr;   /**< Host virtual address */
   uint64_t dev_addr; /**< Device physical address */
   uint32_t size;     /**< Buffer size in bytes */
+  uint32_t handle;   /**< Stable handle, 0 for unmanaged descriptors */
 } accel_buffer_t;
 
 /**
  * @brief Operation parameters
  */
 typedef struct {
-  accel_op_type_t op_type; /**< Operation type */
-  accel_buffer_t input;    /**< Input buffer */
-  accel_buffer_t output;   /**< Output buffer */
-  accel_buffer_t weights;  /**< Weights buffer   */
-  uint32_t flags;          /**< Operation flags */
+  accel_op_type_t op_type;   /**< Operation type */
+  accel_buffer_t input;      /**< Input buffer */
+  accel_buffer_t output;     /**< Output buffer */
+  accel_buffer_t weights;    /**< Weights buffer   */
+  uint32_t flags;            /**< Operation flags */
+  accel_priority_t priority; /**< Submission priority */
+  uint32_t tenant;           /**< Submitting tenant (0 = default) */
 } accel_op_params_t;
 
 #endif /* ACCEL_TYPES_H */
\ No newline at end of file
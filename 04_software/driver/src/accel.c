@@ -13,18 +13,14 @@
 #include <stdlib.h>
 #include <string.h>
 
+#include "accel_internal.h"
 #include "hal.h"
 #include "hal_config.h"
 #include "hal_io.h"
 #include "hal_mem.h"
 
 // Driver context
-struct {
-  hal_context_t* hal;
-  accel_config_t config;
-  char last_error[256];
-  bool initialized;
-} g_ctx = {0};
+struct accel_driver_context g_ctx = {0};
 
 // HAL operation codes mapping
 #define HAL_OP_MATMUL 0x01
@@ -41,7 +37,28 @@ static accel_status_t convert_hal_status(uint32_t hal_status) {
   return ACCEL_STATUS_OK;
 }
 
+uint32_t accel_hal_init_flags(uint32_t flags) {
+  uint32_t hal_flags = 0;
+  if (flags & ACCEL_INIT_CACHED) {
+    hal_flags |= HAL_INIT_CACHED;
+  }
+  if (flags & ACCEL_INIT_PREFAULT) {
+    hal_flags |= HAL_INIT_PREFAULT;
+  }
+  if (flags & ACCEL_INIT_HUGE_2M) {
+    hal_flags |= HAL_INIT_HUGE_2M;
+  }
+  if (flags & ACCEL_INIT_HUGE_1G) {
+    hal_flags |= HAL_INIT_HUGE_1G;
+  }
+  return hal_flags;
+}
+
 accel_status_t accel_init(const char* device_path) {
+  return accel_init_flags(device_path, 0);
+}
+
+accel_status_t accel_init_flags(const char* device_path, uint32_t flags) {
   if (!device_path) {
     return ACCEL_STATUS_INVALID_PARAM;
   }
@@ -51,26 +68,64 @@ accel_status_t accel_init(const char* device_path) {
   }
 
   // Initialize HAL
-  g_ctx.hal = hal_init(device_path);
+  g_ctx.hal = hal_init_flags(device_path, accel_hal_init_flags(flags));
   if (!g_ctx.hal) {
     snprintf(g_ctx.last_error, sizeof(g_ctx.last_error),
              "Failed to initialize HAL");
     return ACCEL_STATUS_ERROR;
   }
 
+  accel_mem_start();
+  accel_tenant_init();
+  pthread_mutex_init(&g_ctx.dma_lock, NULL);
+
+  // Start the submission queue dispatcher
+  if (accel_queue_start() != ACCEL_STATUS_OK) {
+    pthread_mutex_destroy(&g_ctx.dma_lock);
+    accel_mem_stop();
+    hal_cleanup(g_ctx.hal);
+    g_ctx.hal = NULL;
+    snprintf(g_ctx.last_error, sizeof(g_ctx.last_error),
+             "Failed to start submission queue");
+    return ACCEL_STATUS_ERROR;
+  }
+
   g_ctx.initialized = true;
   return ACCEL_STATUS_OK;
 }
 
 void accel_cleanup(void) {
   if (g_ctx.initialized) {
+    accel_queue_stop();
+    accel_mem_stop();
+    pthread_mutex_destroy(&g_ctx.dma_lock);
     hal_cleanup(g_ctx.hal);
     memset(&g_ctx, 0, sizeof(g_ctx));
   }
 }
 
 accel_buffer_t* accel_alloc_buffer(uint32_t size) {
-  if (!g_ctx.initialized) {
+  return accel_tenant_alloc_buffer(ACCEL_TENANT_DEFAULT, size);
+}
+
+void accel_free_buffer(accel_buffer_t* buffer) {
+  if (buffer && g_ctx.initialized) {
+    accel_mem_release(buffer);
+    free(buffer);
+  }
+}
+
+accel_buffer_t* accel_import_buffer(void* host_addr, uint32_t size) {
+  if (!g_ctx.initialized || !host_addr || size == 0) {
+    return NULL;
+  }
+
+  // Both ends of the range must lie inside mapped device memory
+  uint64_t first = hal_virt_to_phys(g_ctx.hal, host_addr);
+  uint64_t last = hal_virt_to_phys(g_ctx.hal, (uint8_t*)host_addr + size - 1);
+  if (first == 0 || last == 0) {
+    snprintf(g_ctx.last_error, sizeof(g_ctx.last_error),
+             "Address range is not in device memory");
     return NULL;
   }
 
@@ -81,79 +136,124 @@ accel_buffer_t* accel_alloc_buffer(uint32_t size) {
     return NULL;
   }
 
-  buffer->host_addr = hal_mem_alloc(g_ctx.hal, size);
-  if (!buffer->host_addr) {
+  buffer->host_addr = host_addr;
+  buffer->dev_addr = first;
+  buffer->size = size;
+  if (accel_mem_import(buffer) != ACCEL_STATUS_OK) {
     free(buffer);
     snprintf(g_ctx.last_error, sizeof(g_ctx.last_error),
-             "Failed to allocate device memory");
+             "Failed to register buffer descriptor");
     return NULL;
   }
-
-  buffer->dev_addr = hal_virt_to_phys(g_ctx.hal, buffer->host_addr);
-  buffer->size = size;
-
   return buffer;
 }
 
-void accel_free_buffer(accel_buffer_t* buffer) {
+void accel_release_buffer(accel_buffer_t* buffer) {
   if (buffer && g_ctx.initialized) {
-    if (buffer->host_addr) {
-      hal_mem_free(g_ctx.hal, buffer->host_addr);
-    }
-    free(buffer);
+    accel_mem_release(buffer);
   }
+  free(buffer);
 }
 
-accel_status_t accel_submit_op(const accel_op_params_t* params) {
+// Cache maintenance on a buffer range, at the buffer's current address
+static accel_status_t sync_buffer(const accel_buffer_t* buffer,
+                                  uint32_t offset, uint32_t size,
+                                  bool for_device) {
   if (!g_ctx.initialized) {
     return ACCEL_STATUS_NOT_INITIALIZED;
   }
+  if (!buffer || !buffer->host_addr || offset >= buffer->size) {
+    return ACCEL_STATUS_INVALID_PARAM;
+  }
+  if (size == 0) {
+    size = buffer->size - offset;
+  }
+  if (size > buffer->size - offset) {
+    snprintf(g_ctx.last_error, sizeof(g_ctx.last_error),
+             "Sync range exceeds buffer size");
+    return ACCEL_STATUS_INVALID_PARAM;
+  }
+
+  // Descriptor copies may predate a compaction pass
+  accel_buffer_t current = *buffer;
+  accel_mem_begin_access();
+  accel_mem_resolve(&current);
+  if (!current.host_addr) {
+    // An import whose buffer has been freed since the copy was taken
+    accel_mem_end_access();
+    return ACCEL_STATUS_INVALID_PARAM;
+  }
+  void* start = (uint8_t*)current.host_addr + offset;
+  bool ok = for_device ? hal_mem_sync_for_device(g_ctx.hal, start, size)
+                       : hal_mem_sync_for_cpu(g_ctx.hal, start, size);
+  accel_mem_end_access();
 
-  if (!params) {
+  if (!ok) {
+    snprintf(g_ctx.last_error, sizeof(g_ctx.last_error),
+             "Buffer is not in device memory");
     return ACCEL_STATUS_INVALID_PARAM;
   }
+  return ACCEL_STATUS_OK;
+}
+
+accel_status_t accel_buffer_sync_for_device(const accel_buffer_t* buffer,
+                                            uint32_t offset, uint32_t size) {
+  return sync_buffer(buffer, offset, size, true);
+}
+
+accel_status_t accel_buffer_sync_for_cpu(const accel_buffer_t* buffer,
+                                         uint32_t offset, uint32_t size) {
+  return sync_buffer(buffer, offset, size, false);
+}
 
+accel_status_t accel_execute_tile(const accel_op_params_t* params,
+                                  uint32_t offset, uint32_t length) {
   hal_systolic_config_t systolic_cfg = {0};
   hal_lsu_config_t lsu_cfg = {0};
 
   switch (params->op_type) {
     case ACCEL_OP_MATMUL:
       systolic_cfg.opcode = HAL_OP_MATMUL;
-      systolic_cfg.control = params->flags;
-      if (!hal_configure_systolic(g_ctx.hal, &systolic_cfg)) {
-        return ACCEL_STATUS_ERROR;
-      }
       break;
 
     case ACCEL_OP_CONV2D:
       systolic_cfg.opcode = HAL_OP_CONV;
-      systolic_cfg.control = params->flags;
-      if (!hal_configure_systolic(g_ctx.hal, &systolic_cfg)) {
-        return ACCEL_STATUS_ERROR;
-      }
       break;
 
     default:
       return ACCEL_STATUS_INVALID_PARAM;
   }
 
+  systolic_cfg.control = params->flags;
+  if (!hal_configure_systolic(g_ctx.hal, &systolic_cfg)) {
+    return ACCEL_STATUS_ERROR;
+  }
+
   // Configure LSU for data transfer
-  lsu_cfg.src_addr = params->input.dev_addr;
-  lsu_cfg.dst_addr = params->output.dev_addr;
-  lsu_cfg.length = params->input.size;
-  if (!hal_configure_lsu(g_ctx.hal, &lsu_cfg)) {
+  lsu_cfg.src_addr = params->input.dev_addr + offset;
+  lsu_cfg.dst_addr = params->output.dev_addr + offset;
+  lsu_cfg.length = length;
+  pthread_mutex_lock(&g_ctx.dma_lock);
+  bool ok = hal_configure_lsu(g_ctx.hal, &lsu_cfg);
+  pthread_mutex_unlock(&g_ctx.dma_lock);
+  if (!ok) {
     return ACCEL_STATUS_ERROR;
   }
 
   return ACCEL_STATUS_OK;
 }
 
+accel_status_t accel_submit_op(const accel_op_params_t* params) {
+  return accel_submit_op_async(params, NULL);
+}
+
 accel_status_t accel_wait_complete(uint32_t timeout_ms) {
   if (!g_ctx.initialized) {
     return ACCEL_STATUS_NOT_INITIALIZED;
   }
 
-  if (!hal_wait_for_ready(g_ctx.hal)) {
+  if (accel_queue_drain(timeout_ms) != ACCEL_STATUS_OK ||
+      !hal_wait_for_ready(g_ctx.hal)) {
     snprintf(g_ctx.last_error, sizeof(g_ctx.last_error), "Operation timed out");
     return ACCEL_STATUS_TIMEOUT;
   }
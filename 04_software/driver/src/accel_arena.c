@@ -0,0 +1,102 @@
+/**
+ * @file accel_arena.c
+ * @author Leo (zhsleo@outlook.com)
+ *
+ * @brief Host memory arenas backed by huge and prefaulted pages
+ * @version 1.0.0
+ * @date 2026-10-18
+ */
+
+#include "accel_arena.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "accel_internal.h"
+#include "hal_page.h"
+
+// Default allocation alignment, one cache line
+#define ACCEL_ARENA_ALIGN 64
+
+struct accel_arena {
+  char* base;       /**< Start of the mapping */
+  size_t capacity;  /**< Usable bytes */
+  size_t used;      /**< Bump offset */
+  size_t page_size; /**< Page size backing the mapping */
+};
+
+accel_arena_t* accel_arena_create(size_t size, uint32_t flags) {
+  if (size == 0) {
+    snprintf(g_ctx.last_error, sizeof(g_ctx.last_error),
+             "Arena size must be non-zero");
+    return NULL;
+  }
+
+  accel_arena_t* arena = calloc(1, sizeof(*arena));
+  if (!arena) {
+    snprintf(g_ctx.last_error, sizeof(g_ctx.last_error),
+             "Failed to allocate arena descriptor");
+    return NULL;
+  }
+
+  // The mapping never shares a file, so caching does not apply
+  uint32_t hal_flags = accel_hal_init_flags(flags) & ~HAL_INIT_CACHED;
+  arena->base = hal_page_map(-1, 0, size, hal_flags, &arena->page_size);
+  if (!arena->base) {
+    free(arena);
+    snprintf(g_ctx.last_error, sizeof(g_ctx.last_error),
+             "Failed to map %zu byte arena", size);
+    return NULL;
+  }
+  arena->capacity = size;
+  return arena;
+}
+
+void accel_arena_destroy(accel_arena_t* arena) {
+  if (arena) {
+    hal_page_unmap(arena->base, arena->capacity, arena->page_size);
+    free(arena);
+  }
+}
+
+void* accel_arena_alloc(accel_arena_t* arena, size_t size, size_t align) {
+  if (!arena) {
+    return NULL;
+  }
+  if (align == 0) {
+    align = ACCEL_ARENA_ALIGN;
+  }
+  if (align & (align - 1)) {
+    snprintf(g_ctx.last_error, sizeof(g_ctx.last_error),
+             "Arena alignment must be a power of two");
+    return NULL;
+  }
+
+  size_t offset = (arena->used + align - 1) & ~(align - 1);
+  if (offset > arena->capacity || size > arena->capacity - offset) {
+    snprintf(g_ctx.last_error, sizeof(g_ctx.last_error),
+             "Arena exhausted: %zu of %zu bytes used, %zu requested",
+             arena->used, arena->capacity, size);
+    return NULL;
+  }
+  arena->used = offset + size;
+  return arena->base + offset;
+}
+
+void accel_arena_reset(accel_arena_t* arena) {
+  if (arena) {
+    arena->used = 0;
+  }
+}
+
+size_t accel_arena_capacity(const accel_arena_t* arena) {
+  return arena ? arena->capacity : 0;
+}
+
+size_t accel_arena_used(const accel_arena_t* arena) {
+  return arena ? arena->used : 0;
+}
+
+size_t accel_arena_page_size(const accel_arena_t* arena) {
+  return arena ? arena->page_size : 0;
+}
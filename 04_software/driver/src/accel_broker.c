@@ -0,0 +1,881 @@
+/**
+ * @file accel_broker.c
+ * @author Leo (zhsleo@outlook.com)
+ *
+ * @brief Broker serving the device to client processes over a Unix socket
+ * @version 1.0.0
+ * @date 2026-10-18
+ */
+
+#define _GNU_SOURCE  // memfd_create
+
+#include "accel_broker.h"
+
+#include <errno.h>
+#include <poll.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/eventfd.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include "accel.h"
+#include "accel_broker_proto.h"
+#include "accel_internal.h"
+
+// Messages read from one client per wakeup, so a busy client cannot
+// starve the others
+#define BROKER_READ_BURST 8
+
+struct accel_broker;
+
+/**
+ * @brief Op owned by the driver, passed as completion callback argument
+ */
+struct broker_op {
+  struct accel_broker* broker;
+  struct broker_client* client;
+  uint64_t id;              /**< Client-chosen op handle */
+  uint32_t input;           /**< Input buffer handle */
+  uint32_t weights;         /**< Weights buffer handle */
+  uint32_t output;          /**< Output buffer handle, copied back when done */
+  uint32_t output_size;     /**< Bytes of the output copied back */
+  accel_status_t status;    /**< Completion status */
+  struct broker_op* next;   /**< Free or done list link */
+};
+
+/**
+ * @brief Device buffer of a client and the memory the client sees
+ *
+ * Clients never map device memory. Each buffer is shadowed by a memfd of
+ * its own that the client maps; the broker copies the bytes an op reads
+ * into device memory before it is queued and the bytes it writes back once
+ * it completed.
+ *
+ * Clients do not modify buffers that queued ops use, so while ops read a
+ * buffer, the bytes staged for them are still current and later ops only
+ * stage what lies beyond.
+ */
+struct broker_buffer {
+  accel_buffer_t* buffer; /**< Device buffer */
+  void* shadow;           /**< Broker mapping of the client's memfd */
+  uint32_t writers;       /**< Queued ops writing the buffer */
+  uint32_t readers;       /**< Queued ops reading the buffer */
+  uint32_t staged;        /**< Leading bytes current on the device */
+};
+
+/**
+ * @brief Connection state, only touched by the broker thread
+ *
+ * A client may have at most ACCEL_BROKER_BATCH ops that are in flight or
+ * whose completions are not sent yet, so one completion message always has
+ * room for them and the messages queued towards a client stay bounded.
+ */
+struct broker_client {
+  bool active;               /**< Slot in use */
+  bool closing;              /**< Peer hung up, waiting for in-flight ops */
+  int fd;                    /**< Connection socket */
+  accel_tenant_t tenant;     /**< Tenant of the connection */
+  struct broker_buffer* buffers; /**< Buffers owned by the connection */
+  uint32_t num_buffers;
+  uint32_t buffer_capacity;
+  uint32_t inflight;         /**< Ops owned by the driver */
+  struct accel_msg submit;   /**< Last SUBMIT message */
+  uint32_t submit_next;      /**< Next op of submit to hand to the driver */
+  struct accel_msg done;     /**< Completions not sent yet */
+};
+
+struct accel_broker {
+  int listen_fd;
+  int wake_fd;  /**< eventfd signalled on completions and stop */
+  char path[sizeof(((struct sockaddr_un*)0)->sun_path)];
+  accel_broker_config_t config;
+  pthread_t thread;
+
+  pthread_mutex_t lock;     /**< Protects the fields below */
+  pthread_cond_t idle_cond; /**< Signalled when outstanding drops */
+  bool stop;                /**< Broker thread shutdown request */
+  struct broker_op ops[ACCEL_QUEUE_DEPTH];
+  struct broker_op* free_ops;
+  struct broker_op* done_ops; /**< Completed, newest first */
+  uint32_t outstanding;       /**< Ops owned by the driver */
+  accel_broker_stats_t stats;
+
+  struct broker_client clients[ACCEL_BROKER_MAX_CLIENTS];
+};
+
+/**
+ * @brief Driver completion callback: hand the op back to the broker thread
+ */
+static void on_complete(accel_op_handle_t handle, accel_status_t status,
+                        void* user_data) {
+  (void)handle;
+  struct broker_op* op = user_data;
+  struct accel_broker* b = op->broker;
+  uint64_t one = 1;
+
+  // The wakeup is written under the lock, so the broker is not torn down
+  // between the two
+  pthread_mutex_lock(&b->lock);
+  op->status = status;
+  op->next = b->done_ops;
+  b->done_ops = op;
+  b->outstanding--;
+  if (write(b->wake_fd, &one, sizeof(one)) < 0) {
+    // Counter saturation only, the broker is awake anyway
+  }
+  pthread_cond_broadcast(&b->idle_cond);
+  pthread_mutex_unlock(&b->lock);
+}
+
+/**
+ * @brief Send a message, not raising SIGPIPE on a dead peer
+ * @param fd Connection socket
+ * @param msg Message
+ * @param len Message length
+ * @param pass File descriptor to send along as SCM_RIGHTS (-1 for none)
+ * @return true if the whole message was sent
+ */
+static bool send_msg_fd(int fd, const struct accel_msg* msg, size_t len,
+                        int pass) {
+  union {
+    char buf[CMSG_SPACE(sizeof(int))];
+    struct cmsghdr align;
+  } control;
+  struct iovec iov = {.iov_base = (void*)msg, .iov_len = len};
+  struct msghdr hdr = {.msg_iov = &iov, .msg_iovlen = 1};
+  if (pass >= 0) {
+    hdr.msg_control = control.buf;
+    hdr.msg_controllen = sizeof(control.buf);
+    struct cmsghdr* cmsg = CMSG_FIRSTHDR(&hdr);
+    cmsg->cmsg_level = SOL_SOCKET;
+    cmsg->cmsg_type = SCM_RIGHTS;
+    cmsg->cmsg_len = CMSG_LEN(sizeof(int));
+    memcpy(CMSG_DATA(cmsg), &pass, sizeof(int));
+  }
+
+  ssize_t n;
+  do {
+    n = sendmsg(fd, &hdr, MSG_NOSIGNAL);
+  } while (n < 0 && errno == EINTR);
+  return n == (ssize_t)len;
+}
+
+static bool send_msg(int fd, const struct accel_msg* msg, size_t len) {
+  return send_msg_fd(fd, msg, len, -1);
+}
+
+/**
+ * @brief Send the pending completions of a client
+ */
+static void flush_done(struct accel_broker* b, struct broker_client* c) {
+  uint32_t count = c->done.u.complete.count;
+  if (count == 0) {
+    return;
+  }
+  if (!c->closing) {
+    send_msg(c->fd, &c->done, ACCEL_MSG_COMPLETE_LEN(count));
+  }
+  c->done.u.complete.count = 0;
+
+  pthread_mutex_lock(&b->lock);
+  b->stats.ops_completed += count;
+  b->stats.completion_messages++;
+  pthread_mutex_unlock(&b->lock);
+}
+
+/**
+ * @brief Queue a completion for a client
+ */
+static void push_done(struct broker_client* c, uint64_t id,
+                      accel_status_t status) {
+  uint32_t idx = c->done.u.complete.count++;
+  struct accel_msg_done* d = &c->done.u.complete.done[idx];
+  d->id = id;
+  d->status = status;
+  d->reserved = 0;
+}
+
+/**
+ * @brief Find a buffer of a client by broker handle
+ * @return Buffer, NULL if the client does not own it
+ */
+static struct broker_buffer* find_buffer(const struct broker_client* c,
+                                         uint32_t handle) {
+  for (uint32_t i = 0; i < c->num_buffers; i++) {
+    if (c->buffers[i].buffer->handle == handle) {
+      return &c->buffers[i];
+    }
+  }
+  return NULL;
+}
+
+/**
+ * @brief Copy the leading bytes of a client's view into device memory for a
+ * queued op reading them
+ *
+ * Skipped while a queued op writes the buffer: the device copy is then the
+ * newer one, or about to be. Bytes staged for ops still reading the buffer
+ * are not copied again.
+ *
+ * @return Bytes copied
+ */
+static uint32_t stage_in(struct broker_buffer* bb, uint32_t size) {
+  if (!bb) {
+    return 0;
+  }
+  bb->readers++;
+  if (bb->writers > 0 || size <= bb->staged) {
+    return 0;
+  }
+  uint32_t from = bb->staged;
+  accel_mem_begin_access();
+  memcpy((char*)bb->buffer->host_addr + from, (char*)bb->shadow + from,
+         size - from);
+  accel_mem_end_access();
+  accel_buffer_sync_for_device(bb->buffer, from, size - from);
+  bb->staged = size;
+  return size - from;
+}
+
+/**
+ * @brief Drop a finished or unqueued op's hold on a buffer it read
+ *
+ * Once no queued op reads it, the client may change the buffer again.
+ */
+static void release_read(struct broker_client* c, uint32_t handle) {
+  struct broker_buffer* bb = handle ? find_buffer(c, handle) : NULL;
+  if (bb && --bb->readers == 0) {
+    bb->staged = 0;
+  }
+}
+
+/**
+ * @brief Release the output of a finished op, copying what it wrote to the
+ * client
+ * @return Bytes copied
+ */
+static uint32_t copy_back(struct broker_client* c, uint32_t handle,
+                          uint32_t size, accel_status_t status) {
+  struct broker_buffer* bb = handle ? find_buffer(c, handle) : NULL;
+  if (!bb) {
+    return 0;
+  }
+  bb->writers--;
+  if (status != ACCEL_STATUS_OK || size == 0) {
+    return 0;
+  }
+  accel_buffer_sync_for_cpu(bb->buffer, 0, size);
+  accel_mem_begin_access();
+  memcpy(bb->shadow, bb->buffer->host_addr, size);
+  accel_mem_end_access();
+  return size;
+}
+
+/**
+ * @brief Translate a buffer handle into a descriptor of the bytes an op uses
+ * @return true if the handle is 0, or owned by the client and at least size
+ *         bytes long
+ */
+static bool resolve_buffer(const struct broker_client* c, uint32_t handle,
+                           uint32_t size, accel_buffer_t* out) {
+  memset(out, 0, sizeof(*out));
+  if (handle == 0) {
+    return true;
+  }
+  struct broker_buffer* bb = find_buffer(c, handle);
+  if (!bb || size > bb->buffer->size) {
+    return false;
+  }
+  *out = *bb->buffer;
+  out->size = size;
+  return true;
+}
+
+/**
+ * @brief Return completed ops to their clients, oldest first
+ */
+static void collect_done(struct accel_broker* b) {
+  pthread_mutex_lock(&b->lock);
+  struct broker_op* list = b->done_ops;
+  b->done_ops = NULL;
+  pthread_mutex_unlock(&b->lock);
+
+  struct broker_op* ordered = NULL;
+  while (list) {
+    struct broker_op* next = list->next;
+    list->next = ordered;
+    ordered = list;
+    list = next;
+  }
+
+  uint64_t copied = 0;
+  while (ordered) {
+    struct broker_op* op = ordered;
+    ordered = op->next;
+    op->client->inflight--;
+    release_read(op->client, op->input);
+    release_read(op->client, op->weights);
+    copied += copy_back(op->client, op->output, op->output_size, op->status);
+    push_done(op->client, op->id, op->status);
+
+    pthread_mutex_lock(&b->lock);
+    op->next = b->free_ops;
+    b->free_ops = op;
+    pthread_mutex_unlock(&b->lock);
+  }
+
+  pthread_mutex_lock(&b->lock);
+  b->stats.bytes_copied += copied;
+  pthread_mutex_unlock(&b->lock);
+}
+
+/**
+ * @brief Give an op record back to the pool
+ */
+static void put_op(struct accel_broker* b, struct broker_op* rec) {
+  pthread_mutex_lock(&b->lock);
+  rec->next = b->free_ops;
+  b->free_ops = rec;
+  b->outstanding--;
+  pthread_mutex_unlock(&b->lock);
+}
+
+/**
+ * @brief Hand the remaining ops of the client's SUBMIT message to the driver
+ *
+ * Consecutive valid ops go to the driver queue in one submission, after
+ * their inputs are copied to device memory. Stops early, leaving the client
+ * stalled, when the client has too many ops outstanding or the driver queue
+ * is full.
+ */
+static void submit_ops(struct accel_broker* b, struct broker_client* c) {
+  struct accel_msg* m = &c->submit;
+  uint32_t submitted = 0;
+  uint32_t submissions = 0;
+  uint64_t copied = 0;
+  bool full = false;
+
+  while (!full && c->submit_next < m->u.submit.count) {
+    accel_op_params_t params[ACCEL_BROKER_BATCH];
+    void* recs[ACCEL_BROKER_BATCH];
+    uint32_t n = 0;
+
+    while (c->submit_next + n < m->u.submit.count &&
+           c->inflight + n + c->done.u.complete.count < ACCEL_BROKER_BATCH) {
+      const struct accel_msg_op* op = &m->u.submit.ops[c->submit_next + n];
+      accel_op_params_t* p = &params[n];
+      memset(p, 0, sizeof(*p));
+      p->op_type = op->op_type;
+      p->flags = op->flags;
+      p->priority = op->priority;
+      p->tenant = c->tenant;
+      if (!resolve_buffer(c, op->input, op->input_size, &p->input) ||
+          !resolve_buffer(c, op->output, op->output_size, &p->output) ||
+          !resolve_buffer(c, op->weights, op->weights_size, &p->weights)) {
+        if (n == 0) {
+          push_done(c, op->id, ACCEL_STATUS_INVALID_PARAM);
+          c->submit_next++;
+          continue;
+        }
+        break;  // Submit the ops before it first
+      }
+
+      pthread_mutex_lock(&b->lock);
+      struct broker_op* rec = b->free_ops;
+      if (rec) {
+        b->free_ops = rec->next;
+        b->outstanding++;
+      }
+      pthread_mutex_unlock(&b->lock);
+      if (!rec) {
+        break;
+      }
+      rec->client = c;
+      rec->id = op->id;
+      rec->input = op->input;
+      rec->weights = op->weights;
+      rec->output = op->output;
+      rec->output_size = op->output_size;
+      recs[n++] = rec;
+
+      // The device reads what the client wrote; the output is marked only
+      // after, so an op reading its own output still gets it staged
+      copied += stage_in(find_buffer(c, op->input), op->input_size);
+      copied += stage_in(find_buffer(c, op->weights), op->weights_size);
+      struct broker_buffer* out = find_buffer(c, op->output);
+      if (out) {
+        out->writers++;
+      }
+    }
+    if (n == 0) {
+      full = c->submit_next < m->u.submit.count;
+      break;
+    }
+
+    uint32_t queued = 0;
+    c->inflight += n;
+    accel_status_t status = accel_submit_ops_notify(params, n, on_complete,
+                                                    recs, NULL, &queued);
+    submissions++;
+    submitted += queued;
+    c->submit_next += queued;
+
+    // Ops the driver did not take keep their place, except the one it
+    // rejected as invalid, which completes with the driver's status
+    for (uint32_t i = queued; i < n; i++) {
+      struct broker_op* rec = recs[i];
+      struct broker_buffer* out = find_buffer(c, rec->output);
+      if (out) {
+        out->writers--;
+      }
+      release_read(c, rec->input);
+      release_read(c, rec->weights);
+      c->inflight--;
+      put_op(b, rec);
+    }
+    if (status == ACCEL_STATUS_BUSY) {
+      full = true;
+    } else if (status != ACCEL_STATUS_OK) {
+      push_done(c, m->u.submit.ops[c->submit_next].id, status);
+      c->submit_next++;
+    }
+  }
+
+  bool stalled = c->submit_next < m->u.submit.count;
+  pthread_mutex_lock(&b->lock);
+  b->stats.ops_submitted += submitted;
+  b->stats.queue_submissions += submissions;
+  b->stats.bytes_copied += copied;
+  if (stalled && submitted == 0) {
+    b->stats.stalls++;
+  }
+  pthread_mutex_unlock(&b->lock);
+}
+
+/**
+ * @brief Check whether a client still has ops waiting for the driver
+ */
+static bool client_stalled(const struct broker_client* c) {
+  return c->submit.type == ACCEL_MSG_SUBMIT &&
+         c->submit_next < c->submit.u.submit.count;
+}
+
+/**
+ * @brief Allocate a buffer for a client and send it the buffer's memfd
+ */
+static void handle_alloc(struct broker_client* c, struct accel_msg* msg) {
+  struct accel_msg reply = {.type = ACCEL_MSG_ALLOC};
+
+  if (c->num_buffers == c->buffer_capacity) {
+    uint32_t capacity = c->buffer_capacity ? c->buffer_capacity * 2 : 16;
+    struct broker_buffer* grown =
+        realloc(c->buffers, capacity * sizeof(*c->buffers));
+    if (!grown) {
+      reply.status = ACCEL_STATUS_NO_MEMORY;
+      send_msg(c->fd, &reply, sizeof(reply));
+      return;
+    }
+    c->buffers = grown;
+    c->buffer_capacity = capacity;
+  }
+
+  accel_buffer_t* buffer =
+      accel_tenant_alloc_buffer(c->tenant, msg->u.alloc.size);
+  if (!buffer) {
+    reply.status = ACCEL_STATUS_NO_MEMORY;
+    send_msg(c->fd, &reply, sizeof(reply));
+    return;
+  }
+
+  int memfd = memfd_create("accel-buffer", MFD_CLOEXEC);
+  void* shadow = MAP_FAILED;
+  if (memfd >= 0 && ftruncate(memfd, buffer->size) == 0) {
+    shadow = mmap(NULL, buffer->size, PROT_READ | PROT_WRITE, MAP_SHARED,
+                  memfd, 0);
+  }
+  if (shadow == MAP_FAILED) {
+    if (memfd >= 0) {
+      close(memfd);
+    }
+    accel_free_buffer(buffer);
+    reply.status = ACCEL_STATUS_NO_MEMORY;
+    send_msg(c->fd, &reply, sizeof(reply));
+    return;
+  }
+
+  c->buffers[c->num_buffers++] =
+      (struct broker_buffer){.buffer = buffer, .shadow = shadow};
+  reply.status = ACCEL_STATUS_OK;
+  reply.u.alloc.size = buffer->size;
+  reply.u.alloc.handle = buffer->handle;
+  reply.u.alloc.dev_addr = buffer->dev_addr;
+  send_msg_fd(c->fd, &reply, sizeof(reply), memfd);
+  close(memfd);
+}
+
+/**
+ * @brief Release one buffer of a client's list
+ */
+static void release_buffer(struct broker_client* c, uint32_t idx) {
+  struct broker_buffer bb = c->buffers[idx];
+  c->buffers[idx] = c->buffers[--c->num_buffers];
+  munmap(bb.shadow, bb.buffer->size);
+  accel_free_buffer(bb.buffer);
+}
+
+/**
+ * @brief Free a buffer of a client
+ */
+static void handle_free(struct broker_client* c, struct accel_msg* msg) {
+  struct accel_msg reply = {.type = ACCEL_MSG_FREE};
+  struct broker_buffer* bb = find_buffer(c, msg->u.free.handle);
+  if (!bb) {
+    reply.status = ACCEL_STATUS_INVALID_PARAM;
+  } else {
+    release_buffer(c, (uint32_t)(bb - c->buffers));
+    reply.status = ACCEL_STATUS_OK;
+  }
+  send_msg(c->fd, &reply, sizeof(reply));
+}
+
+/**
+ * @brief Mark a client as gone; its slot is reaped once its ops completed
+ */
+static void hang_up(struct broker_client* c) {
+  if (!c->closing) {
+    close(c->fd);
+    c->fd = -1;
+    c->closing = true;
+    c->submit.type = 0;
+  }
+}
+
+/**
+ * @brief Free the resources of a closed client without ops in flight
+ */
+static void reap_client(struct accel_broker* b, struct broker_client* c) {
+  while (c->num_buffers > 0) {
+    release_buffer(c, c->num_buffers - 1);
+  }
+  free(c->buffers);
+  accel_tenant_destroy(c->tenant);
+  memset(c, 0, sizeof(*c));
+  c->fd = -1;
+
+  pthread_mutex_lock(&b->lock);
+  b->stats.clients--;
+  pthread_mutex_unlock(&b->lock);
+}
+
+/**
+ * @brief Read and handle a burst of messages from a client
+ */
+static void read_client(struct accel_broker* b, struct broker_client* c) {
+  for (int i = 0; i < BROKER_READ_BURST && !client_stalled(c); i++) {
+    struct accel_msg msg;
+    ssize_t n = recv(c->fd, &msg, sizeof(msg), MSG_DONTWAIT);
+    if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR)) {
+      return;
+    }
+    if (n < (ssize_t)offsetof(struct accel_msg, u)) {
+      hang_up(c);  // Orderly shutdown, error or malformed message
+      return;
+    }
+
+    pthread_mutex_lock(&b->lock);
+    b->stats.messages_received++;
+    pthread_mutex_unlock(&b->lock);
+
+    switch (msg.type) {
+      case ACCEL_MSG_ALLOC:
+        handle_alloc(c, &msg);
+        break;
+
+      case ACCEL_MSG_FREE:
+        handle_free(c, &msg);
+        break;
+
+      case ACCEL_MSG_SUBMIT:
+        if (msg.u.submit.count > ACCEL_BROKER_BATCH ||
+            (size_t)n < ACCEL_MSG_SUBMIT_LEN(msg.u.submit.count)) {
+          hang_up(c);
+          return;
+        }
+        memcpy(&c->submit, &msg, n);
+        c->submit_next = 0;
+        submit_ops(b, c);
+        break;
+
+      default:
+        hang_up(c);
+        return;
+    }
+  }
+}
+
+/**
+ * @brief Send the connection details
+ */
+static bool send_hello(int fd, accel_tenant_t tenant) {
+  struct accel_msg msg = {.type = ACCEL_MSG_HELLO,
+                          .status = ACCEL_STATUS_OK};
+  msg.u.hello.version = ACCEL_BROKER_PROTO_VERSION;
+  msg.u.hello.tenant = tenant;
+  return send_msg(fd, &msg, sizeof(msg));
+}
+
+/**
+ * @brief Accept a pending connection and give it a tenant
+ */
+static void accept_client(struct accel_broker* b) {
+  int fd = accept(b->listen_fd, NULL, NULL);
+  if (fd < 0) {
+    return;
+  }
+
+  struct broker_client* c = NULL;
+  for (int i = 0; i < ACCEL_BROKER_MAX_CLIENTS; i++) {
+    if (!b->clients[i].active) {
+      c = &b->clients[i];
+      break;
+    }
+  }
+
+  accel_tenant_t tenant;
+  if (!c ||
+      accel_tenant_create(&b->config.tenant, &tenant) != ACCEL_STATUS_OK) {
+    pthread_mutex_lock(&b->lock);
+    b->stats.rejected++;
+    pthread_mutex_unlock(&b->lock);
+    close(fd);
+    return;
+  }
+  if (!send_hello(fd, tenant)) {
+    close(fd);
+    accel_tenant_destroy(tenant);
+    return;
+  }
+
+  memset(c, 0, sizeof(*c));
+  c->active = true;
+  c->fd = fd;
+  c->tenant = tenant;
+  c->done.type = ACCEL_MSG_COMPLETE;
+  c->done.status = ACCEL_STATUS_OK;
+
+  pthread_mutex_lock(&b->lock);
+  b->stats.clients++;
+  b->stats.connections++;
+  pthread_mutex_unlock(&b->lock);
+}
+
+/**
+ * @brief Send pending completions and reap closed clients
+ *
+ * Runs before stalled clients are retried, since unsent completions count
+ * against their limit, and once more per wakeup so each client gets at
+ * most one completion message per pass.
+ */
+static void flush_clients(struct accel_broker* b) {
+  for (int i = 0; i < ACCEL_BROKER_MAX_CLIENTS; i++) {
+    struct broker_client* c = &b->clients[i];
+    if (c->active) {
+      flush_done(b, c);
+      if (c->closing && c->inflight == 0) {
+        reap_client(b, c);
+      }
+    }
+  }
+}
+
+/**
+ * @brief Broker thread: one poll loop over the listener and all clients
+ */
+static void* broker_main(void* arg) {
+  struct accel_broker* b = arg;
+  struct pollfd fds[2 + ACCEL_BROKER_MAX_CLIENTS];
+  struct broker_client* polled[ACCEL_BROKER_MAX_CLIENTS];
+
+  for (;;) {
+    pthread_mutex_lock(&b->lock);
+    bool stop = b->stop;
+    pthread_mutex_unlock(&b->lock);
+    if (stop) {
+      break;
+    }
+
+    // Stalled clients are not read, which pushes back on their sockets
+    // A client stalled without ops of its own waits for queue space taken
+    // by someone else, which need not wake the broker; poll for it
+    int timeout = -1;
+    nfds_t nfds = 2;
+    fds[0] = (struct pollfd){.fd = b->wake_fd, .events = POLLIN};
+    fds[1] = (struct pollfd){.fd = b->listen_fd, .events = POLLIN};
+    for (int i = 0; i < ACCEL_BROKER_MAX_CLIENTS; i++) {
+      struct broker_client* c = &b->clients[i];
+      if (c->active && !c->closing && !client_stalled(c)) {
+        polled[nfds - 2] = c;
+        fds[nfds++] = (struct pollfd){.fd = c->fd, .events = POLLIN};
+      } else if (client_stalled(c) && c->inflight == 0) {
+        timeout = 1;
+      }
+    }
+
+    if (poll(fds, nfds, timeout) < 0 && errno != EINTR) {
+      break;
+    }
+
+    if (fds[0].revents & POLLIN) {
+      uint64_t count;
+      if (read(b->wake_fd, &count, sizeof(count)) < 0) {
+        // Spurious wakeup, nothing to consume
+      }
+    }
+    collect_done(b);
+    flush_clients(b);
+
+    for (int i = 0; i < ACCEL_BROKER_MAX_CLIENTS; i++) {
+      if (client_stalled(&b->clients[i])) {
+        submit_ops(b, &b->clients[i]);
+      }
+    }
+    for (nfds_t i = 2; i < nfds; i++) {
+      if (fds[i].revents) {
+        read_client(b, polled[i - 2]);
+      }
+    }
+    if (fds[1].revents & POLLIN) {
+      accept_client(b);
+    }
+    flush_clients(b);
+  }
+  return NULL;
+}
+
+accel_broker_t* accel_broker_start(const char* socket_path,
+                                   const accel_broker_config_t* config) {
+  if (!g_ctx.initialized) {
+    return NULL;
+  }
+
+  struct accel_broker* b = calloc(1, sizeof(*b));
+  if (!b || !socket_path || strlen(socket_path) >= sizeof(b->path)) {
+    free(b);
+    snprintf(g_ctx.last_error, sizeof(g_ctx.last_error),
+             "Invalid broker socket path");
+    return NULL;
+  }
+  strcpy(b->path, socket_path);
+  b->config.tenant.weight = 1;
+  if (config) {
+    b->config = *config;
+  }
+  if (b->config.tenant.weight < 1 ||
+      b->config.tenant.weight > ACCEL_TENANT_MAX_WEIGHT) {
+    free(b);
+    snprintf(g_ctx.last_error, sizeof(g_ctx.last_error),
+             "Invalid client tenant weight");
+    return NULL;
+  }
+
+  for (int i = 0; i < ACCEL_BROKER_MAX_CLIENTS; i++) {
+    b->clients[i].fd = -1;
+  }
+  for (int i = 0; i < ACCEL_QUEUE_DEPTH; i++) {
+    b->ops[i].broker = b;
+    b->ops[i].next = i + 1 < ACCEL_QUEUE_DEPTH ? &b->ops[i + 1] : NULL;
+  }
+  b->free_ops = &b->ops[0];
+
+  struct sockaddr_un addr = {.sun_family = AF_UNIX};
+  strcpy(addr.sun_path, b->path);
+  unlink(b->path);
+
+  b->wake_fd = eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK);
+  b->listen_fd = socket(AF_UNIX, SOCK_SEQPACKET | SOCK_CLOEXEC, 0);
+  if (b->wake_fd < 0 || b->listen_fd < 0 ||
+      bind(b->listen_fd, (struct sockaddr*)&addr, sizeof(addr)) < 0 ||
+      listen(b->listen_fd, ACCEL_BROKER_MAX_CLIENTS) < 0) {
+    snprintf(g_ctx.last_error, sizeof(g_ctx.last_error),
+             "Failed to listen on %s: %s", b->path, strerror(errno));
+    goto fail;
+  }
+
+  pthread_mutex_init(&b->lock, NULL);
+  pthread_cond_init(&b->idle_cond, NULL);
+  if (pthread_create(&b->thread, NULL, broker_main, b) != 0) {
+    pthread_cond_destroy(&b->idle_cond);
+    pthread_mutex_destroy(&b->lock);
+    unlink(b->path);
+    snprintf(g_ctx.last_error, sizeof(g_ctx.last_error),
+             "Failed to start broker thread");
+    goto fail;
+  }
+  return b;
+
+fail:
+  if (b->listen_fd >= 0) {
+    close(b->listen_fd);
+  }
+  if (b->wake_fd >= 0) {
+    close(b->wake_fd);
+  }
+  free(b);
+  return NULL;
+}
+
+void accel_broker_stop(accel_broker_t* broker) {
+  if (!broker) {
+    return;
+  }
+  struct accel_broker* b = broker;
+  uint64_t one = 1;
+
+  pthread_mutex_lock(&b->lock);
+  b->stop = true;
+  if (write(b->wake_fd, &one, sizeof(one)) < 0) {
+    // Already signalled
+  }
+  pthread_mutex_unlock(&b->lock);
+  pthread_join(b->thread, NULL);
+
+  // Completion callbacks reference the op pool
+  pthread_mutex_lock(&b->lock);
+  while (b->outstanding > 0) {
+    pthread_cond_wait(&b->idle_cond, &b->lock);
+  }
+  pthread_mutex_unlock(&b->lock);
+  collect_done(b);
+
+  for (int i = 0; i < ACCEL_BROKER_MAX_CLIENTS; i++) {
+    struct broker_client* c = &b->clients[i];
+    if (c->active) {
+      hang_up(c);
+      c->done.u.complete.count = 0;
+      reap_client(b, c);
+    }
+  }
+
+  close(b->listen_fd);
+  close(b->wake_fd);
+  unlink(b->path);
+  pthread_cond_destroy(&b->idle_cond);
+  pthread_mutex_destroy(&b->lock);
+  free(b);
+}
+
+accel_status_t accel_get_broker_stats(accel_broker_t* broker,
+                                      accel_broker_stats_t* stats) {
+  if (!broker || !stats) {
+    return ACCEL_STATUS_INVALID_PARAM;
+  }
+
+  pthread_mutex_lock(&broker->lock);
+  *stats = broker->stats;
+  pthread_mutex_unlock(&broker->lock);
+  return ACCEL_STATUS_OK;
+}
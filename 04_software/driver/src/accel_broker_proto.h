@@ -0,0 +1,109 @@
+/**
+ * @file accel_broker_proto.h
+ * @author Leo (zhsleo@outlook.com)
+ *
+ * @brief Wire protocol between the accelerator broker and its clients
+ * @version 1.0.0
+ * @date 2026-10-18
+ */
+
+#ifndef ACCEL_BROKER_PROTO_H
+#define ACCEL_BROKER_PROTO_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+// Protocol revision, checked by the client on connect
+#define ACCEL_BROKER_PROTO_VERSION 3
+
+// Submissions or completions carried by one message
+#define ACCEL_BROKER_BATCH 32
+
+/**
+ * @brief Message types
+ *
+ * Messages travel over a SOCK_SEQPACKET socket, so boundaries are kept and
+ * batches are sent with only as many entries as they use. A successful
+ * ALLOC reply carries a memfd holding the client's view of the buffer as
+ * SCM_RIGHTS ancillary data; clients never get the device file.
+ */
+typedef enum {
+  ACCEL_MSG_HELLO = 1, /**< Broker -> client once accepted */
+  ACCEL_MSG_ALLOC,     /**< Request and reply */
+  ACCEL_MSG_FREE,      /**< Request and reply */
+  ACCEL_MSG_SUBMIT,    /**< Client -> broker, answered by completions */
+  ACCEL_MSG_COMPLETE,  /**< Broker -> client */
+} accel_msg_type_t;
+
+/**
+ * @brief Operation as submitted by a client; buffers are broker handles
+ *
+ * An op uses the first input_size, output_size and weights_size bytes of
+ * its buffers, the sizes of the client's descriptors, and only those bytes
+ * are copied.
+ */
+struct accel_msg_op {
+  uint64_t id;       /**< Client-chosen op handle */
+  uint32_t op_type;  /**< accel_op_type_t */
+  uint32_t flags;    /**< Operation flags */
+  uint32_t priority; /**< accel_priority_t */
+  uint32_t input;    /**< Input buffer handle */
+  uint32_t output;   /**< Output buffer handle */
+  uint32_t weights;  /**< Weights buffer handle (0 = none) */
+  uint32_t input_size;   /**< Bytes of the input used */
+  uint32_t output_size;  /**< Bytes of the output used */
+  uint32_t weights_size; /**< Bytes of the weights used */
+  uint32_t reserved;
+};
+
+/**
+ * @brief Completion of one op
+ */
+struct accel_msg_done {
+  uint64_t id;     /**< Client-chosen op handle */
+  uint32_t status; /**< accel_status_t */
+  uint32_t reserved;
+};
+
+/**
+ * @brief Protocol message
+ */
+struct accel_msg {
+  uint32_t type;   /**< accel_msg_type_t */
+  uint32_t status; /**< accel_status_t of replies */
+  union {
+    struct {
+      uint32_t version;  /**< ACCEL_BROKER_PROTO_VERSION */
+      uint32_t tenant;   /**< Tenant of the connection */
+    } hello;
+    struct {
+      uint32_t size;     /**< Requested size in bytes */
+      uint32_t handle;   /**< Buffer handle */
+      uint64_t dev_addr; /**< Device address */
+    } alloc;
+    struct {
+      uint32_t handle;   /**< Buffer handle */
+    } free;
+    struct {
+      uint32_t count;    /**< Entries used in ops */
+      uint32_t reserved;
+      struct accel_msg_op ops[ACCEL_BROKER_BATCH];
+    } submit;
+    struct {
+      uint32_t count;    /**< Entries used in done */
+      uint32_t reserved;
+      struct accel_msg_done done[ACCEL_BROKER_BATCH];
+    } complete;
+  } u;
+};
+
+// Length of a SUBMIT message carrying n ops
+#define ACCEL_MSG_SUBMIT_LEN(n) \
+  (offsetof(struct accel_msg, u.submit.ops) + (n) * sizeof(struct accel_msg_op))
+
+// Length of a COMPLETE message carrying n completions
+#define ACCEL_MSG_COMPLETE_LEN(n)                \
+  (offsetof(struct accel_msg, u.complete.done) + \
+   (n) * sizeof(struct accel_msg_done))
+
+#endif /* ACCEL_BROKER_PROTO_H */
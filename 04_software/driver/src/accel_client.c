@@ -0,0 +1,408 @@
+/**
+ * @file accel_client.c
+ * @author Leo (zhsleo@outlook.com)
+ *
+ * @brief Client side of the accelerator broker protocol
+ * @version 1.0.0
+ * @date 2026-10-18
+ */
+
+#include <errno.h>
+#include <poll.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "accel_broker.h"
+#include "accel_broker_proto.h"
+#include "accel_internal.h"
+
+/**
+ * @brief Client buffer: the public descriptor plus its mapping
+ */
+struct client_buffer {
+  accel_buffer_t desc; /**< Must stay first */
+  void* map;           /**< Mapping of the buffer's memfd */
+  size_t map_len;      /**< Mapping length */
+};
+
+struct accel_client {
+  int sock;                     /**< Connection to the broker */
+  accel_tenant_t tenant;        /**< Tenant of the connection */
+  uint64_t next_id;             /**< Next op handle */
+  uint32_t inflight;            /**< Ops without a received completion */
+  struct accel_msg_done* done;  /**< Received, not yet waited for */
+  uint32_t num_done;
+  uint32_t done_capacity;
+};
+
+static uint64_t now_ms(void) {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t)ts.tv_sec * 1000 + ts.tv_nsec / 1000000;
+}
+
+/**
+ * @brief Record a batch of completions
+ * @return false if out of memory
+ */
+static bool store_done(struct accel_client* c, const struct accel_msg* msg) {
+  uint32_t count = msg->u.complete.count;
+  if (c->num_done + count > c->done_capacity) {
+    uint32_t capacity = c->done_capacity ? c->done_capacity : 64;
+    while (capacity < c->num_done + count) {
+      capacity *= 2;
+    }
+    struct accel_msg_done* grown =
+        realloc(c->done, capacity * sizeof(*c->done));
+    if (!grown) {
+      return false;
+    }
+    c->done = grown;
+    c->done_capacity = capacity;
+  }
+  memcpy(&c->done[c->num_done], msg->u.complete.done,
+         count * sizeof(*c->done));
+  c->num_done += count;
+  c->inflight -= count < c->inflight ? count : c->inflight;
+  return true;
+}
+
+/**
+ * @brief Receive one message, storing completions
+ * @param c Connection
+ * @param msg Receives the message
+ * @param deadline Absolute CLOCK_MONOTONIC time in ms (0 for none)
+ * @param fd Receives a file descriptor sent along, -1 if none; others are
+ *           closed (may be NULL)
+ * @return Status code, ACCEL_STATUS_TIMEOUT if the deadline passed
+ */
+static accel_status_t recv_msg(struct accel_client* c, struct accel_msg* msg,
+                               uint64_t deadline, int* fd) {
+  for (;;) {
+    int timeout = -1;
+    if (deadline) {
+      uint64_t now = now_ms();
+      timeout = now >= deadline ? 0 : (int)(deadline - now);
+    }
+    struct pollfd pfd = {.fd = c->sock, .events = POLLIN};
+    int ready = poll(&pfd, 1, timeout);
+    if (ready < 0 && errno == EINTR) {
+      continue;
+    }
+    if (ready == 0) {
+      return ACCEL_STATUS_TIMEOUT;
+    }
+
+    union {
+      char buf[CMSG_SPACE(sizeof(int))];
+      struct cmsghdr align;
+    } control;
+    struct iovec iov = {.iov_base = msg, .iov_len = sizeof(*msg)};
+    struct msghdr hdr = {.msg_iov = &iov,
+                         .msg_iovlen = 1,
+                         .msg_control = control.buf,
+                         .msg_controllen = sizeof(control.buf)};
+    ssize_t n = ready > 0 ? recvmsg(c->sock, &hdr, MSG_CMSG_CLOEXEC) : -1;
+    if (n < 0 && errno == EINTR) {
+      continue;
+    }
+    struct cmsghdr* cmsg = n > 0 ? CMSG_FIRSTHDR(&hdr) : NULL;
+    int passed = -1;
+    if (cmsg && cmsg->cmsg_level == SOL_SOCKET &&
+        cmsg->cmsg_type == SCM_RIGHTS) {
+      memcpy(&passed, CMSG_DATA(cmsg), sizeof(int));
+    }
+    if (fd) {
+      *fd = passed;
+    } else if (passed >= 0) {
+      close(passed);
+    }
+    if (n < (ssize_t)offsetof(struct accel_msg, u)) {
+      snprintf(g_ctx.last_error, sizeof(g_ctx.last_error),
+               "Lost connection to the broker");
+      return ACCEL_STATUS_ERROR;
+    }
+    if (msg->type == ACCEL_MSG_COMPLETE && !store_done(c, msg)) {
+      snprintf(g_ctx.last_error, sizeof(g_ctx.last_error),
+               "Failed to record completions");
+      return ACCEL_STATUS_NO_MEMORY;
+    }
+    return ACCEL_STATUS_OK;
+  }
+}
+
+/**
+ * @brief Send a request and wait for its reply
+ * @param c Connection
+ * @param msg Request on entry, reply on return
+ * @param fd Receives a file descriptor sent with the reply, -1 if none
+ *           (may be NULL)
+ * @return Status of the exchange (the reply carries its own status)
+ */
+static accel_status_t call(struct accel_client* c, struct accel_msg* msg,
+                           int* fd) {
+  uint32_t type = msg->type;
+  if (send(c->sock, msg, sizeof(*msg), MSG_NOSIGNAL) != sizeof(*msg)) {
+    snprintf(g_ctx.last_error, sizeof(g_ctx.last_error),
+             "Failed to send request to the broker");
+    return ACCEL_STATUS_ERROR;
+  }
+
+  // Completions may arrive ahead of the reply
+  do {
+    accel_status_t status = recv_msg(c, msg, 0, fd);
+    if (status != ACCEL_STATUS_OK) {
+      return status;
+    }
+  } while (msg->type != type);
+  return ACCEL_STATUS_OK;
+}
+
+/**
+ * @brief Receive the HELLO message
+ */
+static bool recv_hello(struct accel_client* c) {
+  struct accel_msg msg;
+  ssize_t n = recv(c->sock, &msg, sizeof(msg), 0);
+  if (n != sizeof(msg) || msg.type != ACCEL_MSG_HELLO) {
+    snprintf(g_ctx.last_error, sizeof(g_ctx.last_error),
+             "Broker refused the connection");
+    return false;
+  }
+  if (msg.u.hello.version != ACCEL_BROKER_PROTO_VERSION) {
+    snprintf(g_ctx.last_error, sizeof(g_ctx.last_error),
+             "Broker speaks protocol %u, expected %u", msg.u.hello.version,
+             ACCEL_BROKER_PROTO_VERSION);
+    return false;
+  }
+  c->tenant = msg.u.hello.tenant;
+  return true;
+}
+
+accel_client_t* accel_client_connect(const char* socket_path) {
+  struct sockaddr_un addr = {.sun_family = AF_UNIX};
+  if (!socket_path || strlen(socket_path) >= sizeof(addr.sun_path)) {
+    snprintf(g_ctx.last_error, sizeof(g_ctx.last_error),
+             "Invalid broker socket path");
+    return NULL;
+  }
+  strcpy(addr.sun_path, socket_path);
+
+  struct accel_client* c = calloc(1, sizeof(*c));
+  if (!c) {
+    snprintf(g_ctx.last_error, sizeof(g_ctx.last_error),
+             "Failed to allocate client");
+    return NULL;
+  }
+  c->next_id = 1;
+
+  c->sock = socket(AF_UNIX, SOCK_SEQPACKET | SOCK_CLOEXEC, 0);
+  if (c->sock < 0 ||
+      connect(c->sock, (struct sockaddr*)&addr, sizeof(addr)) < 0) {
+    snprintf(g_ctx.last_error, sizeof(g_ctx.last_error),
+             "Failed to connect to %s: %s", socket_path, strerror(errno));
+    accel_client_disconnect(c);
+    return NULL;
+  }
+  if (!recv_hello(c)) {
+    accel_client_disconnect(c);
+    return NULL;
+  }
+  return c;
+}
+
+void accel_client_disconnect(accel_client_t* client) {
+  if (!client) {
+    return;
+  }
+  if (client->sock >= 0) {
+    close(client->sock);
+  }
+  free(client->done);
+  free(client);
+}
+
+accel_tenant_t accel_client_tenant(const accel_client_t* client) {
+  return client ? client->tenant : ACCEL_TENANT_DEFAULT;
+}
+
+accel_buffer_t* accel_client_alloc_buffer(accel_client_t* client,
+                                          uint32_t size) {
+  if (!client || size == 0) {
+    return NULL;
+  }
+
+  struct client_buffer* buffer = malloc(sizeof(*buffer));
+  if (!buffer) {
+    snprintf(g_ctx.last_error, sizeof(g_ctx.last_error),
+             "Failed to allocate buffer descriptor");
+    return NULL;
+  }
+
+  struct accel_msg msg = {.type = ACCEL_MSG_ALLOC};
+  msg.u.alloc.size = size;
+  int memfd = -1;
+  if (call(client, &msg, &memfd) != ACCEL_STATUS_OK) {
+    free(buffer);
+    return NULL;
+  }
+  if (msg.status != ACCEL_STATUS_OK || memfd < 0) {
+    if (memfd >= 0) {
+      close(memfd);
+    }
+    free(buffer);
+    snprintf(g_ctx.last_error, sizeof(g_ctx.last_error),
+             "Broker failed to allocate %u bytes", size);
+    return NULL;
+  }
+
+  buffer->map_len = msg.u.alloc.size;
+  buffer->map = mmap(NULL, buffer->map_len, PROT_READ | PROT_WRITE,
+                     MAP_SHARED, memfd, 0);
+  close(memfd);
+  if (buffer->map == MAP_FAILED) {
+    struct accel_msg req = {.type = ACCEL_MSG_FREE};
+    req.u.free.handle = msg.u.alloc.handle;
+    call(client, &req, NULL);
+    free(buffer);
+    snprintf(g_ctx.last_error, sizeof(g_ctx.last_error),
+             "Failed to map buffer: %s", strerror(errno));
+    return NULL;
+  }
+
+  buffer->desc.host_addr = buffer->map;
+  buffer->desc.dev_addr = msg.u.alloc.dev_addr;
+  buffer->desc.size = size;
+  buffer->desc.handle = msg.u.alloc.handle;
+  return &buffer->desc;
+}
+
+void accel_client_free_buffer(accel_client_t* client, accel_buffer_t* buffer) {
+  if (!client || !buffer) {
+    return;
+  }
+  struct client_buffer* cb = (struct client_buffer*)buffer;
+
+  struct accel_msg msg = {.type = ACCEL_MSG_FREE};
+  msg.u.free.handle = buffer->handle;
+  call(client, &msg, NULL);
+  munmap(cb->map, cb->map_len);
+  free(cb);
+}
+
+accel_status_t accel_client_submit_batch(accel_client_t* client,
+                                         const accel_op_params_t* params,
+                                         uint32_t count,
+                                         accel_op_handle_t* handles) {
+  if (!client || (!params && count > 0)) {
+    return ACCEL_STATUS_INVALID_PARAM;
+  }
+
+  struct accel_msg msg = {.type = ACCEL_MSG_SUBMIT};
+  for (uint32_t first = 0; first < count; first += ACCEL_BROKER_BATCH) {
+    uint32_t n = count - first;
+    if (n > ACCEL_BROKER_BATCH) {
+      n = ACCEL_BROKER_BATCH;
+    }
+
+    msg.u.submit.count = n;
+    for (uint32_t i = 0; i < n; i++) {
+      const accel_op_params_t* p = &params[first + i];
+      struct accel_msg_op* op = &msg.u.submit.ops[i];
+      op->id = client->next_id + i;
+      op->op_type = p->op_type;
+      op->flags = p->flags;
+      op->priority = p->priority;
+      op->input = p->input.handle;
+      op->output = p->output.handle;
+      op->weights = p->weights.handle;
+      op->input_size = p->input.size;
+      op->output_size = p->output.size;
+      op->weights_size = p->weights.size;
+    }
+
+    size_t len = ACCEL_MSG_SUBMIT_LEN(n);
+    if (send(client->sock, &msg, len, MSG_NOSIGNAL) != (ssize_t)len) {
+      snprintf(g_ctx.last_error, sizeof(g_ctx.last_error),
+               "Failed to submit to the broker");
+      return ACCEL_STATUS_ERROR;
+    }
+    for (uint32_t i = 0; handles && i < n; i++) {
+      handles[first + i] = client->next_id + i;
+    }
+    client->next_id += n;
+    client->inflight += n;
+  }
+  return ACCEL_STATUS_OK;
+}
+
+accel_status_t accel_client_submit_op_async(accel_client_t* client,
+                                            const accel_op_params_t* params,
+                                            accel_op_handle_t* handle) {
+  if (!params) {
+    return ACCEL_STATUS_INVALID_PARAM;
+  }
+  return accel_client_submit_batch(client, params, 1, handle);
+}
+
+accel_status_t accel_client_wait_op(accel_client_t* client,
+                                    accel_op_handle_t handle,
+                                    uint32_t timeout_ms) {
+  if (!client || handle == 0 || handle >= client->next_id) {
+    return ACCEL_STATUS_INVALID_PARAM;
+  }
+
+  uint64_t deadline = timeout_ms ? now_ms() + timeout_ms : 0;
+  for (;;) {
+    for (uint32_t i = 0; i < client->num_done; i++) {
+      if (client->done[i].id == handle) {
+        accel_status_t status = client->done[i].status;
+        client->done[i] = client->done[--client->num_done];
+        return status;
+      }
+    }
+
+    // Already waited for, or collected by accel_client_wait_complete()
+    if (client->inflight == 0) {
+      return ACCEL_STATUS_INVALID_PARAM;
+    }
+
+    struct accel_msg msg;
+    accel_status_t status = recv_msg(client, &msg, deadline, NULL);
+    if (status != ACCEL_STATUS_OK) {
+      return status;
+    }
+  }
+}
+
+accel_status_t accel_client_wait_complete(accel_client_t* client,
+                                          uint32_t timeout_ms) {
+  if (!client) {
+    return ACCEL_STATUS_INVALID_PARAM;
+  }
+
+  uint64_t deadline = timeout_ms ? now_ms() + timeout_ms : 0;
+  while (client->inflight > 0) {
+    struct accel_msg msg;
+    accel_status_t status = recv_msg(client, &msg, deadline, NULL);
+    if (status != ACCEL_STATUS_OK) {
+      return status;
+    }
+  }
+
+  accel_status_t result = ACCEL_STATUS_OK;
+  for (uint32_t i = 0; i < client->num_done; i++) {
+    if (client->done[i].status != ACCEL_STATUS_OK) {
+      result = client->done[i].status;
+      break;
+    }
+  }
+  client->num_done = 0;
+  return result;
+}
@@ -12,16 +12,9 @@
 #include <stdbool.h>
 #include <string.h>
 
+#include "accel_internal.h"
 #include "hal.h"
 
-// Reference to global context from accel.c
-extern struct {
-  hal_context_t* hal;
-  accel_config_t config;
-  char last_error[256];
-  bool initialized;
-} g_ctx;
-
 accel_status_t accel_configure(const accel_config_t* config) {
   if (!g_ctx.initialized) {
     return ACCEL_STATUS_NOT_INITIALIZED;
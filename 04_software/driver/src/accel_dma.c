@@ -0,0 +1,107 @@
+/**
+ * @file accel_dma.c
+ * @author Leo (zhsleo@outlook.com)
+ *
+ * @brief DMA statistics and timing of the HAL controller model
+ * @version 1.0.0
+ * @date 2026-10-18
+ */
+
+#include "accel_dma.h"
+
+#include "accel_internal.h"
+#include "hal_dma.h"
+
+accel_status_t accel_get_dma_stats(accel_dma_channel_t channel,
+                                   accel_dma_stats_t* stats) {
+  if (!g_ctx.initialized) {
+    return ACCEL_STATUS_NOT_INITIALIZED;
+  }
+  if (!stats || channel >= ACCEL_DMA_CHANNELS) {
+    return ACCEL_STATUS_INVALID_PARAM;
+  }
+
+  hal_dma_stats_t hal_stats;
+  hal_dma_channel_t hal_channel =
+      channel == ACCEL_DMA_READ ? HAL_DMA_MM2S : HAL_DMA_S2MM;
+  pthread_mutex_lock(&g_ctx.dma_lock);
+  bool ok = hal_dma_get_stats(g_ctx.hal, hal_channel, &hal_stats);
+  if (ok) {
+    stats->setup_ns = hal_dma_cycles_to_ns(g_ctx.hal, hal_stats.setup_cycles);
+    stats->data_ns = hal_dma_cycles_to_ns(g_ctx.hal, hal_stats.data_cycles);
+  }
+  pthread_mutex_unlock(&g_ctx.dma_lock);
+  if (!ok) {
+    return ACCEL_STATUS_ERROR;
+  }
+
+  stats->requests = hal_stats.requests;
+  stats->transfers = hal_stats.transfers;
+  stats->bytes = hal_stats.bytes;
+  stats->lite_accesses = hal_stats.lite_reads + hal_stats.lite_writes;
+  stats->setup_cycles = hal_stats.setup_cycles;
+  stats->data_cycles = hal_stats.data_cycles;
+  uint64_t total = hal_stats.setup_cycles + hal_stats.data_cycles;
+  stats->efficiency_pct =
+      total ? (uint32_t)(hal_stats.data_cycles * 100 / total) : 0;
+  return ACCEL_STATUS_OK;
+}
+
+accel_status_t accel_reset_dma_stats(void) {
+  if (!g_ctx.initialized) {
+    return ACCEL_STATUS_NOT_INITIALIZED;
+  }
+
+  pthread_mutex_lock(&g_ctx.dma_lock);
+  hal_dma_reset_stats(g_ctx.hal);
+  pthread_mutex_unlock(&g_ctx.dma_lock);
+  return ACCEL_STATUS_OK;
+}
+
+accel_status_t accel_set_dma_timing(const accel_dma_timing_t* timing) {
+  if (!g_ctx.initialized) {
+    return ACCEL_STATUS_NOT_INITIALIZED;
+  }
+  if (!timing) {
+    return ACCEL_STATUS_INVALID_PARAM;
+  }
+
+  hal_dma_timing_t hal_timing = {
+      .clock_mhz = timing->clock_mhz,
+      .lite_read_cycles = timing->lite_read_cycles,
+      .lite_write_cycles = timing->lite_write_cycles,
+      .slave_latency = timing->slave_latency,
+      .state_cycles = timing->state_cycles,
+      .startup_cycles = timing->startup_cycles,
+      .irq_cycles = timing->irq_cycles,
+      .bytes_per_cycle = timing->bytes_per_cycle,
+  };
+  pthread_mutex_lock(&g_ctx.dma_lock);
+  bool ok = hal_dma_set_timing(g_ctx.hal, &hal_timing);
+  pthread_mutex_unlock(&g_ctx.dma_lock);
+  return ok ? ACCEL_STATUS_OK : ACCEL_STATUS_INVALID_PARAM;
+}
+
+accel_status_t accel_get_dma_timing(accel_dma_timing_t* timing) {
+  if (!g_ctx.initialized) {
+    return ACCEL_STATUS_NOT_INITIALIZED;
+  }
+  if (!timing) {
+    return ACCEL_STATUS_INVALID_PARAM;
+  }
+
+  hal_dma_timing_t hal_timing;
+  pthread_mutex_lock(&g_ctx.dma_lock);
+  hal_dma_get_timing(g_ctx.hal, &hal_timing);
+  pthread_mutex_unlock(&g_ctx.dma_lock);
+
+  timing->clock_mhz = hal_timing.clock_mhz;
+  timing->lite_read_cycles = hal_timing.lite_read_cycles;
+  timing->lite_write_cycles = hal_timing.lite_write_cycles;
+  timing->slave_latency = hal_timing.slave_latency;
+  timing->state_cycles = hal_timing.state_cycles;
+  timing->startup_cycles = hal_timing.startup_cycles;
+  timing->irq_cycles = hal_timing.irq_cycles;
+  timing->bytes_per_cycle = hal_timing.bytes_per_cycle;
+  return ACCEL_STATUS_OK;
+}
@@ -0,0 +1,279 @@
+/**
+ * @file accel_internal.h
+ * @author Leo (zhsleo@outlook.com)
+ *
+ * @brief Driver-private context shared between driver translation units
+ * @version 1.0.0
+ * @date 2026-10-18
+ */
+
+#ifndef ACCEL_INTERNAL_H
+#define ACCEL_INTERNAL_H
+
+#include <pthread.h>
+#include <stdbool.h>
+
+#include "accel_config.h"
+#include "accel_queue.h"
+#include "accel_tenant.h"
+#include "accel_types.h"
+#include "hal.h"
+#include "hal_mem.h"
+
+// Maximum number of in-flight operations across all priority levels
+#define ACCEL_QUEUE_DEPTH 64
+
+// Completed operations whose status accel_wait_op() can still report
+#define ACCEL_STATUS_RING_DEPTH (4 * ACCEL_QUEUE_DEPTH)
+
+/**
+ * @brief Lifecycle state of a queue slot
+ */
+typedef enum {
+  ACCEL_SLOT_FREE = 0,
+  ACCEL_SLOT_QUEUED,
+  ACCEL_SLOT_DONE,
+} accel_slot_state_t;
+
+/**
+ * @brief Queued operation, executed tile by tile by the dispatcher
+ */
+struct accel_queue_entry {
+  accel_op_handle_t handle;      /**< Sequence number of the op in the slot */
+  accel_slot_state_t state;      /**< Slot lifecycle state */
+  accel_op_params_t params;      /**< Copy of submitted parameters */
+  accel_priority_t priority;     /**< Effective priority level */
+  accel_status_t status;         /**< Completion status */
+  uint32_t tile_bytes;           /**< Bytes per tile (0 = single tile) */
+  uint32_t next_offset;          /**< Input offset of the next tile */
+  uint64_t submit_ns;            /**< Enqueue timestamp */
+  uint64_t start_ns;             /**< First dispatch timestamp (0 = pending) */
+  accel_completion_fn callback;  /**< Completion callback (may be NULL) */
+  void* user_data;               /**< Callback argument */
+  int next;                      /**< Next slot in the level FIFO (-1 = end) */
+};
+
+/**
+ * @brief Completion status of a finished op, kept after its slot is reused
+ */
+struct accel_op_result {
+  accel_op_handle_t handle; /**< Op the status belongs to (0 = none) */
+  accel_status_t status;    /**< Completion status */
+};
+
+/**
+ * @brief Multi-level submission queue state
+ *
+ * Handles are sequence numbers: an op lives in slot handle % depth while
+ * queued and its status in results[handle % ring depth] once done, so a
+ * stale handle is told apart from the op now occupying either.
+ */
+struct accel_queue {
+  pthread_t dispatcher;      /**< Dispatcher thread */
+  pthread_mutex_t lock;      /**< Protects everything below */
+  pthread_cond_t work_cond;  /**< Signalled on submit and shutdown */
+  pthread_cond_t done_cond;  /**< Signalled on every op completion */
+  bool running;              /**< Dispatcher thread is alive */
+  bool stop;                 /**< Dispatcher shutdown request */
+  uint64_t next_handle;      /**< Next handle to hand out */
+  uint32_t pending;          /**< Ops queued but not yet completed */
+  uint32_t gate_tiles;       /**< Tiles to run before holding (-1 = open) */
+  bool gated;                /**< Dispatcher is held at the gate */
+  int head[ACCEL_PRIORITY_LEVELS];  /**< FIFO head per level (-1 = empty) */
+  int tail[ACCEL_PRIORITY_LEVELS];  /**< FIFO tail per level (-1 = empty) */
+  struct accel_queue_entry slots[ACCEL_QUEUE_DEPTH];
+  struct accel_op_result results[ACCEL_STATUS_RING_DEPTH];
+  accel_queue_stats_t stats[ACCEL_PRIORITY_LEVELS];
+};
+
+/**
+ * @brief Registry slot of a buffer descriptor, indexed by handle - 1
+ */
+struct accel_mem_entry {
+  accel_buffer_t* buffer; /**< Live descriptor (NULL = free slot) */
+  bool imported;          /**< Descriptor from accel_import_buffer() */
+  uint32_t owner;         /**< Aliased allocation of an import (0 = none) */
+  uint32_t imports;       /**< First import aliasing an allocation */
+  uint32_t next_import;   /**< Next import of the same owner (0 = none) */
+  uint32_t pins;          /**< Pin count */
+};
+
+/**
+ * @brief Device memory manager state
+ *
+ * move_lock is held shared while the device or the driver accesses buffer
+ * memory and exclusively while compaction moves it. lock protects the HAL
+ * allocator and the registry.
+ */
+struct accel_mem {
+  pthread_mutex_t lock;
+  pthread_rwlock_t move_lock;
+  struct accel_mem_entry* entries; /**< Registry, grows on demand */
+  uint32_t capacity;               /**< Registry slots */
+  uint64_t compactions;            /**< Compaction passes run */
+  uint64_t bytes_moved;            /**< Bytes relocated by all passes */
+
+  pthread_t compactor;         /**< Background compaction thread */
+  pthread_cond_t compactor_cond;
+  bool compactor_running;      /**< Compaction thread is alive */
+  bool compactor_stop;         /**< Compaction thread shutdown request */
+  uint32_t threshold_pct;      /**< Fragmentation that triggers a pass */
+  uint32_t interval_ms;        /**< Fragmentation check interval */
+};
+
+/**
+ * @brief Tenant partition state
+ *
+ * quota is protected by the memory manager lock, everything else by the
+ * queue lock. active is written holding both, so either lock suffices to
+ * read it. Fair share is enforced by always dispatching the tenant with
+ * the smallest vtime, which advances by processed bytes divided by weight.
+ */
+struct accel_tenant {
+  bool active;                /**< Slot in use */
+  uint32_t weight;            /**< Fair-share weight */
+  uint32_t max_queued;        /**< Queued op limit (0 = none) */
+  uint32_t queued;            /**< Ops queued or running */
+  uint64_t vtime;             /**< Weighted bytes processed */
+  uint64_t device_ns;         /**< Unweighted device time in ns */
+  hal_mem_quota_t quota;      /**< Device memory quota */
+  accel_tenant_stats_t stats; /**< Queue counters */
+};
+
+/**
+ * @brief Driver context
+ */
+struct accel_driver_context {
+  hal_context_t* hal;
+  accel_config_t config;
+  char last_error[256];
+  bool initialized;
+  struct accel_queue queue;
+  struct accel_mem mem;
+  struct accel_tenant tenants[ACCEL_MAX_TENANTS];
+  pthread_mutex_t dma_lock; /**< Serializes the HAL DMA model */
+};
+
+extern struct accel_driver_context g_ctx;
+
+/**
+ * @brief Translate ACCEL_INIT_* flags to HAL_INIT_* flags
+ * @param flags Driver initialization flags
+ * @return HAL initialization flags
+ */
+uint32_t accel_hal_init_flags(uint32_t flags);
+
+/**
+ * @brief Reset the tenant table to the unlimited default tenant
+ */
+void accel_tenant_init(void);
+
+/**
+ * @brief Look up an active tenant
+ * @param tenant Tenant identifier
+ * @return Tenant state, NULL if the identifier is not in use
+ */
+struct accel_tenant* accel_tenant_get(accel_tenant_t tenant);
+
+/**
+ * @brief Start the dispatcher thread and reset queue state
+ * @return Status code
+ */
+accel_status_t accel_queue_start(void);
+
+/**
+ * @brief Stop the dispatcher thread; ops still queued fail with
+ *        ACCEL_STATUS_ERROR
+ */
+void accel_queue_stop(void);
+
+/**
+ * @brief Wait until every submitted op has completed
+ * @param timeout_ms Timeout in milliseconds (0 for infinite)
+ * @return Status code
+ */
+accel_status_t accel_queue_drain(uint32_t timeout_ms);
+
+/**
+ * @brief Let the dispatcher run a number of tiles, then hold it
+ *
+ * The dispatcher checks the gate at every tile boundary, so tests can place
+ * ops at an exact point of another op's execution.
+ *
+ * @param tiles Tiles to run before holding, UINT32_MAX to open the gate
+ */
+void accel_queue_gate(uint32_t tiles);
+
+/**
+ * @brief Wait until the dispatcher is held at the gate
+ */
+void accel_queue_wait_gated(void);
+
+/**
+ * @brief Initialize the device memory manager
+ * @return Status code
+ */
+accel_status_t accel_mem_start(void);
+
+/**
+ * @brief Stop background compaction and free the registry
+ */
+void accel_mem_stop(void);
+
+/**
+ * @brief Allocate device memory for a tenant and register the descriptor
+ *
+ * The tenant is looked up and its quota charged under the memory manager
+ * lock, so a concurrent destroy either sees the allocation or wins.
+ *
+ * @param buffer Descriptor to fill in
+ * @param size Size in bytes
+ * @param tenant Tenant whose quota is charged
+ * @return Status code, ACCEL_STATUS_INVALID_PARAM for an unknown tenant
+ */
+accel_status_t accel_mem_alloc(accel_buffer_t* buffer, uint32_t size,
+                               accel_tenant_t tenant);
+
+/**
+ * @brief Register an imported descriptor, tracking the buffer it aliases
+ * @param buffer Descriptor with host_addr/dev_addr/size filled in
+ * @return Status code
+ */
+accel_status_t accel_mem_import(accel_buffer_t* buffer);
+
+/**
+ * @brief Unregister a descriptor, freeing device memory if it owns it
+ * @param buffer Descriptor
+ */
+void accel_mem_release(accel_buffer_t* buffer);
+
+/**
+ * @brief Refresh a descriptor copy with the current buffer addresses
+ * @param buffer Descriptor copy, unchanged if its handle is 0
+ */
+void accel_mem_resolve(accel_buffer_t* buffer);
+
+/**
+ * @brief Keep buffers in place while their memory is accessed
+ *
+ * Descriptor copies must be refreshed with accel_mem_resolve() after this
+ * call. Must be paired with accel_mem_end_access().
+ */
+void accel_mem_begin_access(void);
+
+/**
+ * @brief Allow compaction to move buffers again
+ */
+void accel_mem_end_access(void);
+
+/**
+ * @brief Program the hardware for one tile of an operation
+ * @param params Operation parameters
+ * @param offset Byte offset of the tile within the input buffer
+ * @param length Tile length in bytes
+ * @return Status code
+ */
+accel_status_t accel_execute_tile(const accel_op_params_t* params,
+                                  uint32_t offset, uint32_t length);
+
+#endif /* ACCEL_INTERNAL_H */
@@ -0,0 +1,531 @@
+/**
+ * @file accel_mem.c
+ * @author Leo (zhsleo@outlook.com)
+ *
+ * @brief Buffer registry, pinning and compaction of device memory
+ * @version 1.0.0
+ * @date 2026-10-18
+ */
+
+#define _GNU_SOURCE  // pthread_rwlockattr_setkind_np
+
+#include "accel_mem.h"
+
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "accel_internal.h"
+#include "hal_mem.h"
+
+// Initial number of registry slots
+#define ACCEL_MEM_INITIAL_SLOTS 64
+
+/**
+ * @brief Fragmentation of free memory in percent
+ * @param stats HAL free-space statistics
+ * @return 0 when there is no free memory or it is one block
+ */
+static uint32_t fragmentation_pct(const hal_mem_stats_t* stats) {
+  if (stats->total_free == 0) {
+    return 0;
+  }
+  return (uint32_t)(100 - (stats->largest_free * 100) / stats->total_free);
+}
+
+/**
+ * @brief Allocations in address order for one compaction pass
+ *
+ * hal_mem_compact() visits blocks in address order, so the callback finds
+ * each block's allocation by advancing a cursor, one pass over the registry.
+ */
+struct relocation {
+  struct accel_mem* mem;
+  uint32_t* owners; /**< Handles of allocations by address */
+  uint32_t count;
+  uint32_t next;    /**< First allocation not passed yet */
+};
+
+/**
+ * @brief Put a descriptor into a free registry slot (lock held)
+ * @param mem Memory manager
+ * @param buffer Descriptor, receives its handle
+ * @param imported true for a descriptor from accel_import_buffer()
+ * @param owner Handle of the aliased allocation (0 = none)
+ * @return Status code
+ */
+static accel_status_t register_buffer(struct accel_mem* mem,
+                                      accel_buffer_t* buffer, bool imported,
+                                      uint32_t owner) {
+  uint32_t slot = 0;
+  while (slot < mem->capacity && mem->entries[slot].buffer) {
+    slot++;
+  }
+
+  if (slot == mem->capacity) {
+    uint32_t capacity =
+        mem->capacity ? mem->capacity * 2 : ACCEL_MEM_INITIAL_SLOTS;
+    struct accel_mem_entry* entries =
+        realloc(mem->entries, capacity * sizeof(*entries));
+    if (!entries) {
+      return ACCEL_STATUS_NO_MEMORY;
+    }
+    memset(entries + mem->capacity, 0,
+           (capacity - mem->capacity) * sizeof(*entries));
+    mem->entries = entries;
+    mem->capacity = capacity;
+  }
+
+  struct accel_mem_entry* e = &mem->entries[slot];
+  memset(e, 0, sizeof(*e));
+  e->buffer = buffer;
+  e->imported = imported;
+  e->owner = owner;
+  buffer->handle = slot + 1;
+
+  // Imports are listed on their allocation, so it can find them
+  if (owner) {
+    e->next_import = mem->entries[owner - 1].imports;
+    mem->entries[owner - 1].imports = slot + 1;
+  }
+  return ACCEL_STATUS_OK;
+}
+
+/**
+ * @brief Look up the registry slot of a handle (lock held)
+ * @return Slot, or NULL if the handle is not live
+ */
+static struct accel_mem_entry* find_entry(struct accel_mem* mem,
+                                          uint32_t handle) {
+  if (handle == 0 || handle > mem->capacity ||
+      !mem->entries[handle - 1].buffer) {
+    return NULL;
+  }
+  return &mem->entries[handle - 1];
+}
+
+/**
+ * @brief Take an import off its allocation's list (lock held)
+ */
+static void unlink_import(struct accel_mem* mem, uint32_t handle) {
+  struct accel_mem_entry* e = &mem->entries[handle - 1];
+  uint32_t* link = &mem->entries[e->owner - 1].imports;
+  while (*link != handle) {
+    link = &mem->entries[*link - 1].next_import;
+  }
+  *link = e->next_import;
+  e->owner = 0;
+  e->next_import = 0;
+}
+
+/**
+ * @brief Invalidate the imports of an allocation being freed (lock held)
+ *
+ * Their descriptors no longer describe memory: address and size become 0,
+ * so syncs on them fail instead of reaching whatever is allocated there
+ * next.
+ */
+static void orphan_imports(struct accel_mem* mem, struct accel_mem_entry* e) {
+  uint32_t handle = e->imports;
+  while (handle) {
+    struct accel_mem_entry* import = &mem->entries[handle - 1];
+    handle = import->next_import;
+    import->buffer->host_addr = NULL;
+    import->buffer->dev_addr = 0;
+    import->buffer->size = 0;
+    import->owner = 0;
+    import->next_import = 0;
+  }
+  e->imports = 0;
+}
+
+static int compare_host_addr(const void* a, const void* b) {
+  const struct accel_mem_entry* entries = g_ctx.mem.entries;
+  uintptr_t x = (uintptr_t)entries[*(const uint32_t*)a - 1].buffer->host_addr;
+  uintptr_t y = (uintptr_t)entries[*(const uint32_t*)b - 1].buffer->host_addr;
+  return (x > y) - (x < y);
+}
+
+/**
+ * @brief Relocation callback for hal_mem_compact() (both locks held)
+ *
+ * Patches the allocation at old_addr and every import aliasing it, unless
+ * the allocation is pinned.
+ */
+static bool relocate_buffer(void* user_data, void* old_addr, void* new_addr,
+                            size_t size) {
+  (void)size;
+  struct relocation* r = user_data;
+  struct accel_mem* mem = r->mem;
+
+  while (r->next < r->count &&
+         (uintptr_t)mem->entries[r->owners[r->next] - 1].buffer->host_addr <
+             (uintptr_t)old_addr) {
+    r->next++;
+  }
+
+  // Never move memory the driver cannot patch references to
+  if (r->next == r->count ||
+      mem->entries[r->owners[r->next] - 1].buffer->host_addr != old_addr) {
+    return false;
+  }
+  struct accel_mem_entry* owner = &mem->entries[r->owners[r->next++] - 1];
+  if (owner->pins > 0) {
+    return false;
+  }
+
+  int64_t delta = (uint8_t*)new_addr - (uint8_t*)old_addr;
+  owner->buffer->host_addr = new_addr;
+  owner->buffer->dev_addr += (uint64_t)delta;
+  for (uint32_t h = owner->imports; h; h = mem->entries[h - 1].next_import) {
+    accel_buffer_t* import = mem->entries[h - 1].buffer;
+    import->host_addr = (uint8_t*)import->host_addr + delta;
+    import->dev_addr += (uint64_t)delta;
+  }
+  return true;
+}
+
+/**
+ * @brief Background compaction thread
+ */
+static void* compactor_main(void* arg) {
+  struct accel_mem* mem = arg;
+
+  pthread_mutex_lock(&mem->lock);
+  while (!mem->compactor_stop) {
+    struct timespec deadline;
+    clock_gettime(CLOCK_MONOTONIC, &deadline);
+    deadline.tv_sec += mem->interval_ms / 1000;
+    deadline.tv_nsec += (long)(mem->interval_ms % 1000) * 1000000L;
+    if (deadline.tv_nsec >= 1000000000L) {
+      deadline.tv_sec++;
+      deadline.tv_nsec -= 1000000000L;
+    }
+    pthread_cond_timedwait(&mem->compactor_cond, &mem->lock, &deadline);
+    if (mem->compactor_stop) {
+      break;
+    }
+
+    hal_mem_stats_t stats;
+    if (hal_mem_get_stats(g_ctx.hal, &stats) &&
+        fragmentation_pct(&stats) >= mem->threshold_pct) {
+      // Compaction takes move_lock first, so drop the registry lock
+      pthread_mutex_unlock(&mem->lock);
+      accel_compact_memory(NULL);
+      pthread_mutex_lock(&mem->lock);
+    }
+  }
+  pthread_mutex_unlock(&mem->lock);
+  return NULL;
+}
+
+/**
+ * @brief Stop the background compaction thread if it runs
+ */
+static void stop_compactor(struct accel_mem* mem) {
+  pthread_mutex_lock(&mem->lock);
+  bool running = mem->compactor_running;
+  mem->compactor_stop = true;
+  pthread_cond_signal(&mem->compactor_cond);
+  pthread_mutex_unlock(&mem->lock);
+
+  if (running) {
+    pthread_join(mem->compactor, NULL);
+  }
+
+  pthread_mutex_lock(&mem->lock);
+  mem->compactor_running = false;
+  mem->compactor_stop = false;
+  pthread_mutex_unlock(&mem->lock);
+}
+
+accel_status_t accel_mem_start(void) {
+  struct accel_mem* mem = &g_ctx.mem;
+  memset(mem, 0, sizeof(*mem));
+
+  pthread_rwlockattr_t rw_attr;
+  pthread_rwlockattr_init(&rw_attr);
+#ifdef __GLIBC__
+  // The dispatcher takes the lock for every tile; let compaction in
+  pthread_rwlockattr_setkind_np(&rw_attr,
+                                PTHREAD_RWLOCK_PREFER_WRITER_NONRECURSIVE_NP);
+#endif
+  pthread_rwlock_init(&mem->move_lock, &rw_attr);
+  pthread_rwlockattr_destroy(&rw_attr);
+
+  pthread_condattr_t attr;
+  pthread_condattr_init(&attr);
+  pthread_condattr_setclock(&attr, CLOCK_MONOTONIC);
+  pthread_cond_init(&mem->compactor_cond, &attr);
+  pthread_condattr_destroy(&attr);
+  pthread_mutex_init(&mem->lock, NULL);
+  return ACCEL_STATUS_OK;
+}
+
+void accel_mem_stop(void) {
+  struct accel_mem* mem = &g_ctx.mem;
+  stop_compactor(mem);
+
+  free(mem->entries);
+  mem->entries = NULL;
+  mem->capacity = 0;
+
+  pthread_mutex_destroy(&mem->lock);
+  pthread_cond_destroy(&mem->compactor_cond);
+  pthread_rwlock_destroy(&mem->move_lock);
+}
+
+accel_status_t accel_mem_alloc(accel_buffer_t* buffer, uint32_t size,
+                               accel_tenant_t tenant) {
+  struct accel_mem* mem = &g_ctx.mem;
+
+  pthread_mutex_lock(&mem->lock);
+  struct accel_tenant* t =
+      tenant < ACCEL_MAX_TENANTS ? &g_ctx.tenants[tenant] : NULL;
+  if (!t || !t->active) {
+    pthread_mutex_unlock(&mem->lock);
+    snprintf(g_ctx.last_error, sizeof(g_ctx.last_error), "Unknown tenant %u",
+             tenant);
+    return ACCEL_STATUS_INVALID_PARAM;
+  }
+
+  uint64_t denied = t->quota.denied;
+  buffer->host_addr = hal_mem_alloc_quota(g_ctx.hal, size, &t->quota);
+  if (!buffer->host_addr) {
+    bool over_quota = t->quota.denied != denied;
+    pthread_mutex_unlock(&mem->lock);
+    if (over_quota) {
+      snprintf(g_ctx.last_error, sizeof(g_ctx.last_error),
+               "Tenant %u memory quota exceeded", tenant);
+    } else {
+      snprintf(g_ctx.last_error, sizeof(g_ctx.last_error),
+               "Failed to allocate device memory");
+    }
+    return ACCEL_STATUS_NO_MEMORY;
+  }
+  buffer->dev_addr = hal_virt_to_phys(g_ctx.hal, buffer->host_addr);
+  buffer->size = size;
+
+  accel_status_t status = register_buffer(mem, buffer, false, 0);
+  if (status != ACCEL_STATUS_OK) {
+    hal_mem_free(g_ctx.hal, buffer->host_addr);
+  }
+  pthread_mutex_unlock(&mem->lock);
+  return status;
+}
+
+accel_status_t accel_mem_import(accel_buffer_t* buffer) {
+  struct accel_mem* mem = &g_ctx.mem;
+  uint8_t* start = buffer->host_addr;
+
+  pthread_mutex_lock(&mem->lock);
+
+  // Find the allocation the range lies in, so the import moves with it
+  uint32_t owner = 0;
+  for (uint32_t i = 0; i < mem->capacity; i++) {
+    struct accel_mem_entry* e = &mem->entries[i];
+    uint8_t* base = e->buffer ? e->buffer->host_addr : NULL;
+    if (e->buffer && !e->imported && start >= base &&
+        start + buffer->size <= base + e->buffer->size) {
+      owner = i + 1;
+      break;
+    }
+  }
+
+  accel_status_t status = register_buffer(mem, buffer, true, owner);
+  pthread_mutex_unlock(&mem->lock);
+  return status;
+}
+
+void accel_mem_release(accel_buffer_t* buffer) {
+  struct accel_mem* mem = &g_ctx.mem;
+
+  pthread_mutex_lock(&mem->lock);
+  struct accel_mem_entry* e = find_entry(mem, buffer->handle);
+  if (e && e->buffer == buffer) {
+    if (e->owner) {
+      unlink_import(mem, buffer->handle);
+    } else if (!e->imported) {
+      orphan_imports(mem, e);
+      if (buffer->host_addr) {
+        hal_mem_free(g_ctx.hal, buffer->host_addr);
+      }
+    }
+    e->buffer = NULL;
+  }
+  pthread_mutex_unlock(&mem->lock);
+}
+
+void accel_mem_resolve(accel_buffer_t* buffer) {
+  struct accel_mem* mem = &g_ctx.mem;
+  if (buffer->handle == 0) {
+    return;
+  }
+
+  pthread_mutex_lock(&mem->lock);
+  struct accel_mem_entry* e = find_entry(mem, buffer->handle);
+  if (e) {
+    buffer->host_addr = e->buffer->host_addr;
+    buffer->dev_addr = e->buffer->dev_addr;
+  }
+  pthread_mutex_unlock(&mem->lock);
+}
+
+void accel_mem_begin_access(void) {
+  pthread_rwlock_rdlock(&g_ctx.mem.move_lock);
+}
+
+void accel_mem_end_access(void) { pthread_rwlock_unlock(&g_ctx.mem.move_lock); }
+
+accel_status_t accel_get_mem_stats(accel_mem_stats_t* stats) {
+  if (!g_ctx.initialized) {
+    return ACCEL_STATUS_NOT_INITIALIZED;
+  }
+  if (!stats) {
+    return ACCEL_STATUS_INVALID_PARAM;
+  }
+
+  struct accel_mem* mem = &g_ctx.mem;
+  hal_mem_stats_t hal_stats;
+
+  pthread_mutex_lock(&mem->lock);
+  hal_mem_get_stats(g_ctx.hal, &hal_stats);
+  memset(stats, 0, sizeof(*stats));
+  stats->total_size = g_ctx.hal->accel_memory_size;
+  stats->total_free = hal_stats.total_free;
+  stats->largest_free = hal_stats.largest_free;
+  stats->free_blocks = (uint32_t)hal_stats.free_blocks;
+  stats->fragmentation_pct = fragmentation_pct(&hal_stats);
+  stats->compactions = mem->compactions;
+  stats->bytes_moved = mem->bytes_moved;
+  stats->page_size = g_ctx.hal->page_size;
+  for (uint32_t i = 0; i < mem->capacity; i++) {
+    struct accel_mem_entry* e = &mem->entries[i];
+    if (e->buffer && !e->imported) {
+      stats->live_buffers++;
+      if (e->pins > 0) {
+        stats->pinned_buffers++;
+      }
+    }
+  }
+  pthread_mutex_unlock(&mem->lock);
+  return ACCEL_STATUS_OK;
+}
+
+accel_status_t accel_compact_memory(uint64_t* bytes_moved) {
+  if (!g_ctx.initialized) {
+    return ACCEL_STATUS_NOT_INITIALIZED;
+  }
+
+  struct accel_mem* mem = &g_ctx.mem;
+
+  // Waits for the tile in flight; later tiles see the patched addresses
+  pthread_rwlock_wrlock(&mem->move_lock);
+  pthread_mutex_lock(&mem->lock);
+  struct relocation r = {.mem = mem};
+  r.owners = malloc((mem->capacity ? mem->capacity : 1) * sizeof(uint32_t));
+  if (!r.owners) {
+    pthread_mutex_unlock(&mem->lock);
+    pthread_rwlock_unlock(&mem->move_lock);
+    snprintf(g_ctx.last_error, sizeof(g_ctx.last_error),
+             "Failed to allocate compaction index");
+    return ACCEL_STATUS_NO_MEMORY;
+  }
+  for (uint32_t i = 0; i < mem->capacity; i++) {
+    if (mem->entries[i].buffer && !mem->entries[i].imported) {
+      r.owners[r.count++] = i + 1;
+    }
+  }
+  qsort(r.owners, r.count, sizeof(uint32_t), compare_host_addr);
+  size_t moved = hal_mem_compact(g_ctx.hal, relocate_buffer, &r);
+  mem->compactions++;
+  mem->bytes_moved += moved;
+  pthread_mutex_unlock(&mem->lock);
+  pthread_rwlock_unlock(&mem->move_lock);
+  free(r.owners);
+
+  if (bytes_moved) {
+    *bytes_moved = moved;
+  }
+  return ACCEL_STATUS_OK;
+}
+
+/**
+ * @brief Adjust the pin count of a buffer, or of the buffer it aliases
+ * @param buffer Buffer descriptor
+ * @param pin true to pin, false to unpin
+ * @return Status code
+ */
+static accel_status_t adjust_pin(accel_buffer_t* buffer, bool pin) {
+  if (!g_ctx.initialized) {
+    return ACCEL_STATUS_NOT_INITIALIZED;
+  }
+  if (!buffer) {
+    return ACCEL_STATUS_INVALID_PARAM;
+  }
+
+  struct accel_mem* mem = &g_ctx.mem;
+  accel_status_t status = ACCEL_STATUS_OK;
+
+  pthread_mutex_lock(&mem->lock);
+  struct accel_mem_entry* e = find_entry(mem, buffer->handle);
+  if (e && e->imported) {
+    e = find_entry(mem, e->owner);
+  }
+  if (!e) {
+    // Unmanaged descriptors and imports of no allocation never move
+  } else if (pin) {
+    e->pins++;
+  } else if (e->pins > 0) {
+    e->pins--;
+  } else {
+    snprintf(g_ctx.last_error, sizeof(g_ctx.last_error),
+             "Buffer is not pinned");
+    status = ACCEL_STATUS_INVALID_PARAM;
+  }
+  pthread_mutex_unlock(&mem->lock);
+  return status;
+}
+
+accel_status_t accel_buffer_pin(accel_buffer_t* buffer) {
+  return adjust_pin(buffer, true);
+}
+
+accel_status_t accel_buffer_unpin(accel_buffer_t* buffer) {
+  return adjust_pin(buffer, false);
+}
+
+accel_status_t accel_set_auto_compaction(uint32_t threshold_pct,
+                                         uint32_t interval_ms) {
+  if (!g_ctx.initialized) {
+    return ACCEL_STATUS_NOT_INITIALIZED;
+  }
+
+  struct accel_mem* mem = &g_ctx.mem;
+  if (threshold_pct == 0) {
+    stop_compactor(mem);
+    return ACCEL_STATUS_OK;
+  }
+  if (threshold_pct > 100 || interval_ms == 0) {
+    return ACCEL_STATUS_INVALID_PARAM;
+  }
+
+  accel_status_t status = ACCEL_STATUS_OK;
+  pthread_mutex_lock(&mem->lock);
+  mem->threshold_pct = threshold_pct;
+  mem->interval_ms = interval_ms;
+  if (!mem->compactor_running) {
+    if (pthread_create(&mem->compactor, NULL, compactor_main, mem) == 0) {
+      mem->compactor_running = true;
+    } else {
+      snprintf(g_ctx.last_error, sizeof(g_ctx.last_error),
+               "Failed to start compaction thread");
+      status = ACCEL_STATUS_ERROR;
+    }
+  }
+  pthread_cond_signal(&mem->compactor_cond);
+  pthread_mutex_unlock(&mem->lock);
+  return status;
+}
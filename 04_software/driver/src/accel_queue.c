@@ -0,0 +1,658 @@
+/**
+ * @file accel_queue.c
+ * @author Leo (zhsleo@outlook.com)
+ *
+ * @brief Implementation of the multi-level submission queue
+ * @version 1.0.0
+ * @date 2026-10-18
+ */
+
+#include "accel_queue.h"
+
+#include <errno.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+
+#include "accel_internal.h"
+
+/**
+ * @brief Read the monotonic clock
+ * @return Current time in nanoseconds
+ */
+static uint64_t now_ns(void) {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+}
+
+/**
+ * @brief Build an absolute CLOCK_MONOTONIC deadline
+ * @param timeout_ms Relative timeout in milliseconds
+ * @param deadline Pointer to store the deadline
+ */
+static void make_deadline(uint32_t timeout_ms, struct timespec* deadline) {
+  clock_gettime(CLOCK_MONOTONIC, deadline);
+  deadline->tv_sec += timeout_ms / 1000;
+  deadline->tv_nsec += (long)(timeout_ms % 1000) * 1000000L;
+  if (deadline->tv_nsec >= 1000000000L) {
+    deadline->tv_sec++;
+    deadline->tv_nsec -= 1000000000L;
+  }
+}
+
+/**
+ * @brief Wait on a condition, optionally bounded by a deadline
+ * @return false if the deadline expired
+ */
+static bool cond_wait(pthread_cond_t* cond, pthread_mutex_t* lock,
+                      const struct timespec* deadline) {
+  if (!deadline) {
+    pthread_cond_wait(cond, lock);
+    return true;
+  }
+  return pthread_cond_timedwait(cond, lock, deadline) != ETIMEDOUT;
+}
+
+/**
+ * @brief Pick the next op of the highest non-empty priority level
+ *
+ * Within a level, the oldest op of the tenant with the smallest virtual
+ * time wins, so tenants share the device in proportion to their weights.
+ * With a single tenant this is the level's head.
+ *
+ * @param q Queue (lock held)
+ * @return Slot index, or -1 if every level is empty
+ */
+static int pick_next(struct accel_queue* q) {
+  for (int level = ACCEL_PRIORITY_LEVELS - 1; level >= 0; level--) {
+    int best = -1;
+    uint64_t best_vtime = 0;
+    for (int idx = q->head[level]; idx >= 0; idx = q->slots[idx].next) {
+      uint64_t vtime = g_ctx.tenants[q->slots[idx].params.tenant].vtime;
+      if (best < 0 || vtime < best_vtime) {
+        best = idx;
+        best_vtime = vtime;
+      }
+    }
+    if (best >= 0) {
+      return best;
+    }
+  }
+  return -1;
+}
+
+/**
+ * @brief Count a throttled tile for every other tenant waiting at a level
+ * @param q Queue (lock held)
+ * @param idx Slot index that won the pick
+ */
+static void count_throttled(struct accel_queue* q, int idx) {
+  uint32_t winner = q->slots[idx].params.tenant;
+  uint32_t seen = 1u << winner;
+  for (int i = q->head[q->slots[idx].priority]; i >= 0; i = q->slots[i].next) {
+    uint32_t tenant = q->slots[i].params.tenant;
+    if (!(seen & (1u << tenant))) {
+      seen |= 1u << tenant;
+      g_ctx.tenants[tenant].stats.throttled_tiles++;
+    }
+  }
+}
+
+/**
+ * @brief Charge a finished tile to the tenant of its op
+ *
+ * Virtual time advances by the tile's input bytes rather than its measured
+ * duration, so host-side jitter of the dispatcher thread is not billed to
+ * whoever happened to be running.
+ *
+ * @param e Queue entry (lock held)
+ * @param bytes Input bytes of the tile
+ * @param elapsed_ns Device time of the tile
+ */
+static void charge_tenant(struct accel_queue_entry* e, uint32_t bytes,
+                          uint64_t elapsed_ns) {
+  struct accel_tenant* t = &g_ctx.tenants[e->params.tenant];
+  t->device_ns += elapsed_ns;
+  t->stats.bytes_processed += bytes;
+  t->vtime += (uint64_t)bytes * ACCEL_TENANT_MAX_WEIGHT / t->weight;
+}
+
+/**
+ * @brief Bring a tenant that was idle up to the busy tenants' virtual time
+ *
+ * Otherwise a tenant could bank its idle time and then monopolize the
+ * device until it caught up.
+ *
+ * @param t Tenant about to queue its first op (queue lock held)
+ */
+static void activate_tenant(struct accel_tenant* t) {
+  bool found = false;
+  uint64_t floor = 0;
+  for (int i = 0; i < ACCEL_MAX_TENANTS; i++) {
+    struct accel_tenant* other = &g_ctx.tenants[i];
+    if (other != t && other->active && other->queued > 0 &&
+        (!found || other->vtime < floor)) {
+      floor = other->vtime;
+      found = true;
+    }
+  }
+  if (found && t->vtime < floor) {
+    t->vtime = floor;
+  }
+}
+
+/**
+ * @brief Completion notification to deliver once the lock is released
+ */
+struct completion_note {
+  accel_completion_fn callback;
+  void* user_data;
+  accel_op_handle_t handle;
+  accel_status_t status;
+};
+
+/**
+ * @brief Deliver a completion notification (lock not held)
+ * @param note Notification captured by complete_entry
+ */
+static void notify(const struct completion_note* note) {
+  if (note->callback) {
+    note->callback(note->handle, note->status, note->user_data);
+  }
+}
+
+/**
+ * @brief Complete a queued op, unlink it and update statistics
+ * @param q Queue (lock held)
+ * @param idx Slot index
+ * @param status Completion status
+ * @return Notification to deliver after unlocking
+ */
+static struct completion_note complete_entry(struct accel_queue* q, int idx,
+                                             accel_status_t status) {
+  struct accel_queue_entry* e = &q->slots[idx];
+  accel_queue_stats_t* st = &q->stats[e->priority];
+
+  int prev = -1;
+  for (int i = q->head[e->priority]; i != idx; i = q->slots[i].next) {
+    prev = i;
+  }
+  if (prev < 0) {
+    q->head[e->priority] = e->next;
+  } else {
+    q->slots[prev].next = e->next;
+  }
+  if (q->tail[e->priority] == idx) {
+    q->tail[e->priority] = prev;
+  }
+
+  uint64_t done_ns = now_ns();
+  if (e->start_ns == 0) {
+    e->start_ns = done_ns;
+  }
+  uint64_t latency_us = (done_ns - e->submit_ns) / 1000;
+
+  st->completed++;
+  st->total_latency_us += latency_us;
+  if (latency_us > st->max_latency_us) {
+    st->max_latency_us = latency_us;
+  }
+
+  struct accel_tenant* t = &g_ctx.tenants[e->params.tenant];
+  t->queued--;
+  t->stats.completed++;
+  t->stats.total_latency_us += latency_us;
+  if (latency_us > t->stats.max_latency_us) {
+    t->stats.max_latency_us = latency_us;
+  }
+
+  e->status = status;
+  e->state = ACCEL_SLOT_DONE;
+  struct accel_op_result* result =
+      &q->results[e->handle % ACCEL_STATUS_RING_DEPTH];
+  result->handle = e->handle;
+  result->status = status;
+  e->next = -1;
+  q->pending--;
+  pthread_cond_broadcast(&q->done_cond);
+
+  struct completion_note note = {e->callback, e->user_data, e->handle, status};
+  return note;
+}
+
+/**
+ * @brief Dispatcher thread: runs one tile at a time, highest priority first
+ */
+static void* dispatcher_main(void* arg) {
+  struct accel_queue* q = arg;
+  int last = -1;
+
+  pthread_mutex_lock(&q->lock);
+  while (!q->stop) {
+    if (q->gate_tiles == 0) {
+      q->gated = true;
+      pthread_cond_broadcast(&q->done_cond);
+      pthread_cond_wait(&q->work_cond, &q->lock);
+      continue;
+    }
+
+    int idx = pick_next(q);
+    if (idx < 0) {
+      last = -1;
+      pthread_cond_wait(&q->work_cond, &q->lock);
+      continue;
+    }
+
+    // The previous op was not finished but a higher level won the pick;
+    // switching between tenants of one level is fair share, not preemption
+    struct accel_queue_entry* e = &q->slots[idx];
+    if (last >= 0 && last != idx &&
+        q->slots[last].state == ACCEL_SLOT_QUEUED &&
+        q->slots[last].priority < e->priority) {
+      q->stats[q->slots[last].priority].preempted++;
+    }
+    last = idx;
+    count_throttled(q, idx);
+
+    if (e->start_ns == 0) {
+      e->start_ns = now_ns();
+      uint64_t wait_us = (e->start_ns - e->submit_ns) / 1000;
+      accel_queue_stats_t* st = &q->stats[e->priority];
+      st->total_queue_us += wait_us;
+      if (wait_us > st->max_queue_us) {
+        st->max_queue_us = wait_us;
+      }
+    }
+
+    uint32_t offset = e->next_offset;
+    uint32_t remaining = e->params.input.size - offset;
+    uint32_t length = (e->tile_bytes && e->tile_bytes < remaining)
+                          ? e->tile_bytes
+                          : remaining;
+    accel_op_params_t params = e->params;
+    pthread_mutex_unlock(&q->lock);
+
+    // Buffers may have been relocated since submission
+    accel_mem_begin_access();
+    accel_mem_resolve(&params.input);
+    accel_mem_resolve(&params.weights);
+    accel_mem_resolve(&params.output);
+    uint64_t tile_start = now_ns();
+    accel_status_t status = accel_execute_tile(&params, offset, length);
+    uint64_t tile_ns = now_ns() - tile_start;
+    accel_mem_end_access();
+
+    // Tile boundary: if a higher level filled up meanwhile, the next pick
+    // preempts this op, which stays at the head of its own level
+    pthread_mutex_lock(&q->lock);
+    charge_tenant(e, length, tile_ns);
+    e->next_offset = offset + length;
+    if (q->gate_tiles != UINT32_MAX) {
+      q->gate_tiles--;
+    }
+    if (status != ACCEL_STATUS_OK || e->next_offset >= e->params.input.size) {
+      struct completion_note note = complete_entry(q, idx, status);
+      last = -1;
+      pthread_mutex_unlock(&q->lock);
+      notify(&note);
+      pthread_mutex_lock(&q->lock);
+    }
+  }
+  pthread_mutex_unlock(&q->lock);
+  return NULL;
+}
+
+accel_status_t accel_queue_start(void) {
+  struct accel_queue* q = &g_ctx.queue;
+
+  memset(q, 0, sizeof(*q));
+  for (int level = 0; level < ACCEL_PRIORITY_LEVELS; level++) {
+    q->head[level] = -1;
+    q->tail[level] = -1;
+  }
+  q->next_handle = 1;
+  q->gate_tiles = UINT32_MAX;
+
+  pthread_condattr_t attr;
+  pthread_condattr_init(&attr);
+  pthread_condattr_setclock(&attr, CLOCK_MONOTONIC);
+  pthread_mutex_init(&q->lock, NULL);
+  pthread_cond_init(&q->work_cond, &attr);
+  pthread_cond_init(&q->done_cond, &attr);
+  pthread_condattr_destroy(&attr);
+
+  if (pthread_create(&q->dispatcher, NULL, dispatcher_main, q) != 0) {
+    pthread_cond_destroy(&q->done_cond);
+    pthread_cond_destroy(&q->work_cond);
+    pthread_mutex_destroy(&q->lock);
+    return ACCEL_STATUS_ERROR;
+  }
+  q->running = true;
+  return ACCEL_STATUS_OK;
+}
+
+void accel_queue_stop(void) {
+  struct accel_queue* q = &g_ctx.queue;
+  if (!q->running) {
+    return;
+  }
+
+  pthread_mutex_lock(&q->lock);
+  q->stop = true;
+  pthread_cond_broadcast(&q->work_cond);
+  pthread_mutex_unlock(&q->lock);
+  pthread_join(q->dispatcher, NULL);
+
+  // Fail anything the dispatcher did not get to
+  pthread_mutex_lock(&q->lock);
+  int idx;
+  while ((idx = pick_next(q)) >= 0) {
+    struct completion_note note = complete_entry(q, idx, ACCEL_STATUS_ERROR);
+    pthread_mutex_unlock(&q->lock);
+    notify(&note);
+    pthread_mutex_lock(&q->lock);
+  }
+  pthread_mutex_unlock(&q->lock);
+
+  pthread_cond_destroy(&q->done_cond);
+  pthread_cond_destroy(&q->work_cond);
+  pthread_mutex_destroy(&q->lock);
+  q->running = false;
+}
+
+accel_status_t accel_submit_op_async(const accel_op_params_t* params,
+                                     accel_op_handle_t* handle) {
+  return accel_submit_op_notify(params, NULL, NULL, handle);
+}
+
+/**
+ * @brief Check the parameters of an op before queueing it
+ * @return Status code
+ */
+static accel_status_t validate_op(const accel_op_params_t* params) {
+  if (!params || params->priority >= ACCEL_PRIORITY_LEVELS ||
+      params->tenant >= ACCEL_MAX_TENANTS) {
+    return ACCEL_STATUS_INVALID_PARAM;
+  }
+
+  if (params->op_type != ACCEL_OP_MATMUL &&
+      params->op_type != ACCEL_OP_CONV2D) {
+    return ACCEL_STATUS_INVALID_PARAM;
+  }
+  return ACCEL_STATUS_OK;
+}
+
+/**
+ * @brief Place one validated op on its level
+ * @param q Queue (lock held)
+ * @return Status code, ACCEL_STATUS_BUSY if the queue or the tenant's share
+ *         of it is full
+ */
+static accel_status_t enqueue_op(struct accel_queue* q,
+                                 const accel_op_params_t* params,
+                                 accel_completion_fn callback,
+                                 void* user_data, accel_op_handle_t* handle) {
+  accel_priority_t priority = params->priority;
+  if (g_ctx.config.flags & ACCEL_CONFIG_HIGH_PRIORITY) {
+    priority = ACCEL_PRIORITY_HIGH;
+  }
+
+  struct accel_tenant* tenant = accel_tenant_get(params->tenant);
+  if (!tenant) {
+    snprintf(g_ctx.last_error, sizeof(g_ctx.last_error), "Unknown tenant %u",
+             params->tenant);
+    return ACCEL_STATUS_INVALID_PARAM;
+  }
+  if (tenant->max_queued && tenant->queued >= tenant->max_queued) {
+    tenant->stats.submit_rejected++;
+    snprintf(g_ctx.last_error, sizeof(g_ctx.last_error),
+             "Tenant %u has %u ops queued, its limit", params->tenant,
+             tenant->queued);
+    return ACCEL_STATUS_BUSY;
+  }
+
+  // Find a free slot; handles are chosen so that handle % depth == slot
+  accel_op_handle_t new_handle = 0;
+  for (int i = 0; i < ACCEL_QUEUE_DEPTH; i++) {
+    accel_op_handle_t candidate = q->next_handle + i;
+    if (q->slots[candidate % ACCEL_QUEUE_DEPTH].state != ACCEL_SLOT_QUEUED) {
+      new_handle = candidate;
+      break;
+    }
+  }
+  if (new_handle == 0) {
+    snprintf(g_ctx.last_error, sizeof(g_ctx.last_error),
+             "Submission queue full");
+    return ACCEL_STATUS_BUSY;
+  }
+
+  int idx = (int)(new_handle % ACCEL_QUEUE_DEPTH);
+  struct accel_queue_entry* e = &q->slots[idx];
+  memset(e, 0, sizeof(*e));
+  e->handle = new_handle;
+  q->next_handle = new_handle + 1;
+  e->state = ACCEL_SLOT_QUEUED;
+  e->params = *params;
+  e->priority = priority;
+  e->status = ACCEL_STATUS_OK;
+  e->tile_bytes = g_ctx.config.max_transfer;
+  e->submit_ns = now_ns();
+  e->callback = callback;
+  e->user_data = user_data;
+  e->next = -1;
+
+  if (q->tail[priority] >= 0) {
+    q->slots[q->tail[priority]].next = idx;
+  } else {
+    q->head[priority] = idx;
+  }
+  q->tail[priority] = idx;
+  q->pending++;
+  q->stats[priority].submitted++;
+  if (tenant->queued++ == 0) {
+    activate_tenant(tenant);
+  }
+  tenant->stats.submitted++;
+
+  if (handle) {
+    *handle = e->handle;
+  }
+  return ACCEL_STATUS_OK;
+}
+
+accel_status_t accel_submit_op_notify(const accel_op_params_t* params,
+                                      accel_completion_fn callback,
+                                      void* user_data,
+                                      accel_op_handle_t* handle) {
+  return accel_submit_ops_notify(params, 1, callback,
+                                 params ? &user_data : NULL, handle, NULL);
+}
+
+accel_status_t accel_submit_ops_notify(const accel_op_params_t* params,
+                                       uint32_t count,
+                                       accel_completion_fn callback,
+                                       void* const* user_data,
+                                       accel_op_handle_t* handles,
+                                       uint32_t* queued) {
+  if (queued) {
+    *queued = 0;
+  }
+  if (!g_ctx.initialized) {
+    return ACCEL_STATUS_NOT_INITIALIZED;
+  }
+  if (!params || !user_data) {
+    return ACCEL_STATUS_INVALID_PARAM;
+  }
+
+  struct accel_queue* q = &g_ctx.queue;
+  accel_status_t status = ACCEL_STATUS_OK;
+  uint32_t n = 0;
+  pthread_mutex_lock(&q->lock);
+  for (; n < count; n++) {
+    status = validate_op(&params[n]);
+    if (status == ACCEL_STATUS_OK) {
+      status = enqueue_op(q, &params[n], callback, user_data[n],
+                          handles ? &handles[n] : NULL);
+    }
+    if (status != ACCEL_STATUS_OK) {
+      break;
+    }
+  }
+  if (n > 0) {
+    pthread_cond_signal(&q->work_cond);
+  }
+  pthread_mutex_unlock(&q->lock);
+
+  if (queued) {
+    *queued = n;
+  }
+  return status;
+}
+
+accel_status_t accel_submit_op_wait(const accel_op_params_t* params,
+                                    accel_op_handle_t* handle,
+                                    uint32_t timeout_ms) {
+  if (!g_ctx.initialized) {
+    return ACCEL_STATUS_NOT_INITIALIZED;
+  }
+  accel_status_t status = validate_op(params);
+  if (status != ACCEL_STATUS_OK) {
+    return status;
+  }
+
+  struct accel_queue* q = &g_ctx.queue;
+  struct timespec deadline;
+  if (timeout_ms) {
+    make_deadline(timeout_ms, &deadline);
+  }
+
+  // Every completion broadcasts done_cond, and the check and the wait are
+  // under the same lock, so no freed slot goes unnoticed
+  pthread_mutex_lock(&q->lock);
+  while ((status = enqueue_op(q, params, NULL, NULL, handle)) ==
+         ACCEL_STATUS_BUSY) {
+    if (!cond_wait(&q->done_cond, &q->lock, timeout_ms ? &deadline : NULL)) {
+      status = ACCEL_STATUS_TIMEOUT;
+      snprintf(g_ctx.last_error, sizeof(g_ctx.last_error),
+               "No room in the submission queue");
+      break;
+    }
+  }
+  if (status == ACCEL_STATUS_OK) {
+    pthread_cond_signal(&q->work_cond);
+  }
+  pthread_mutex_unlock(&q->lock);
+  return status;
+}
+
+accel_status_t accel_wait_op(accel_op_handle_t handle, uint32_t timeout_ms) {
+  if (!g_ctx.initialized) {
+    return ACCEL_STATUS_NOT_INITIALIZED;
+  }
+
+  struct accel_queue* q = &g_ctx.queue;
+  struct timespec deadline;
+  if (timeout_ms) {
+    make_deadline(timeout_ms, &deadline);
+  }
+
+  pthread_mutex_lock(&q->lock);
+  if (handle == 0 || handle >= q->next_handle) {
+    pthread_mutex_unlock(&q->lock);
+    return ACCEL_STATUS_INVALID_PARAM;
+  }
+
+  struct accel_queue_entry* e = &q->slots[handle % ACCEL_QUEUE_DEPTH];
+  accel_status_t status;
+  for (;;) {
+    // Once done, or its slot reused, the op's status is in the ring
+    if (e->handle != handle || e->state == ACCEL_SLOT_DONE) {
+      const struct accel_op_result* result =
+          &q->results[handle % ACCEL_STATUS_RING_DEPTH];
+      if (result->handle == handle) {
+        status = result->status;
+      } else {
+        status = ACCEL_STATUS_EXPIRED;
+        snprintf(g_ctx.last_error, sizeof(g_ctx.last_error),
+                 "Status of operation %llu expired",
+                 (unsigned long long)handle);
+      }
+      break;
+    }
+    if (!cond_wait(&q->done_cond, &q->lock, timeout_ms ? &deadline : NULL)) {
+      status = ACCEL_STATUS_TIMEOUT;
+      snprintf(g_ctx.last_error, sizeof(g_ctx.last_error),
+               "Operation timed out");
+      break;
+    }
+  }
+  pthread_mutex_unlock(&q->lock);
+  return status;
+}
+
+accel_status_t accel_queue_drain(uint32_t timeout_ms) {
+  struct accel_queue* q = &g_ctx.queue;
+  struct timespec deadline;
+  if (timeout_ms) {
+    make_deadline(timeout_ms, &deadline);
+  }
+
+  accel_status_t status = ACCEL_STATUS_OK;
+  pthread_mutex_lock(&q->lock);
+  while (q->pending > 0) {
+    if (!cond_wait(&q->done_cond, &q->lock, timeout_ms ? &deadline : NULL)) {
+      status = ACCEL_STATUS_TIMEOUT;
+      break;
+    }
+  }
+  pthread_mutex_unlock(&q->lock);
+  return status;
+}
+
+void accel_queue_gate(uint32_t tiles) {
+  struct accel_queue* q = &g_ctx.queue;
+  pthread_mutex_lock(&q->lock);
+  q->gate_tiles = tiles;
+  if (tiles > 0) {
+    q->gated = false;
+  }
+  pthread_cond_signal(&q->work_cond);
+  pthread_mutex_unlock(&q->lock);
+}
+
+void accel_queue_wait_gated(void) {
+  struct accel_queue* q = &g_ctx.queue;
+  pthread_mutex_lock(&q->lock);
+  while (!q->gated) {
+    pthread_cond_wait(&q->done_cond, &q->lock);
+  }
+  pthread_mutex_unlock(&q->lock);
+}
+
+accel_status_t accel_get_queue_stats(accel_priority_t priority,
+                                     accel_queue_stats_t* stats) {
+  if (!g_ctx.initialized) {
+    return ACCEL_STATUS_NOT_INITIALIZED;
+  }
+
+  if (!stats || priority >= ACCEL_PRIORITY_LEVELS) {
+    return ACCEL_STATUS_INVALID_PARAM;
+  }
+
+  pthread_mutex_lock(&g_ctx.queue.lock);
+  *stats = g_ctx.queue.stats[priority];
+  pthread_mutex_unlock(&g_ctx.queue.lock);
+  return ACCEL_STATUS_OK;
+}
+
+accel_status_t accel_reset_queue_stats(void) {
+  if (!g_ctx.initialized) {
+    return ACCEL_STATUS_NOT_INITIALIZED;
+  }
+
+  pthread_mutex_lock(&g_ctx.queue.lock);
+  memset(g_ctx.queue.stats, 0, sizeof(g_ctx.queue.stats));
+  pthread_mutex_unlock(&g_ctx.queue.lock);
+  return ACCEL_STATUS_OK;
+}
@@ -0,0 +1,185 @@
+/**
+ * @file accel_tenant.c
+ * @author Leo (zhsleo@outlook.com)
+ *
+ * @brief Tenant table, memory quotas and per-tenant statistics
+ * @version 1.0.0
+ * @date 2026-10-18
+ */
+
+#include "accel_tenant.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "accel_internal.h"
+
+/**
+ * @brief Check tenant settings
+ * @param config Settings to check
+ * @return true if the weight is in range
+ */
+static bool config_valid(const accel_tenant_config_t* config) {
+  return config && config->weight >= 1 &&
+         config->weight <= ACCEL_TENANT_MAX_WEIGHT;
+}
+
+void accel_tenant_init(void) {
+  memset(g_ctx.tenants, 0, sizeof(g_ctx.tenants));
+  g_ctx.tenants[ACCEL_TENANT_DEFAULT].active = true;
+  g_ctx.tenants[ACCEL_TENANT_DEFAULT].weight = 1;
+}
+
+struct accel_tenant* accel_tenant_get(accel_tenant_t tenant) {
+  if (tenant >= ACCEL_MAX_TENANTS || !g_ctx.tenants[tenant].active) {
+    return NULL;
+  }
+  return &g_ctx.tenants[tenant];
+}
+
+accel_status_t accel_tenant_create(const accel_tenant_config_t* config,
+                                   accel_tenant_t* tenant) {
+  if (!g_ctx.initialized) {
+    return ACCEL_STATUS_NOT_INITIALIZED;
+  }
+  if (!config_valid(config) || !tenant) {
+    return ACCEL_STATUS_INVALID_PARAM;
+  }
+
+  pthread_mutex_lock(&g_ctx.queue.lock);
+  accel_tenant_t id = 0;
+  for (accel_tenant_t i = 1; i < ACCEL_MAX_TENANTS; i++) {
+    if (!g_ctx.tenants[i].active) {
+      id = i;
+      break;
+    }
+  }
+  if (id == 0) {
+    pthread_mutex_unlock(&g_ctx.queue.lock);
+    snprintf(g_ctx.last_error, sizeof(g_ctx.last_error),
+             "All %d tenant slots are in use", ACCEL_MAX_TENANTS);
+    return ACCEL_STATUS_BUSY;
+  }
+
+  struct accel_tenant* t = &g_ctx.tenants[id];
+  pthread_mutex_lock(&g_ctx.mem.lock);
+  memset(t, 0, sizeof(*t));
+  t->active = true;
+  t->weight = config->weight;
+  t->max_queued = config->max_queued;
+  t->quota.limit = config->mem_quota;
+  pthread_mutex_unlock(&g_ctx.mem.lock);
+  pthread_mutex_unlock(&g_ctx.queue.lock);
+
+  *tenant = id;
+  return ACCEL_STATUS_OK;
+}
+
+accel_status_t accel_tenant_configure(accel_tenant_t tenant,
+                                      const accel_tenant_config_t* config) {
+  if (!g_ctx.initialized) {
+    return ACCEL_STATUS_NOT_INITIALIZED;
+  }
+  if (!config_valid(config)) {
+    return ACCEL_STATUS_INVALID_PARAM;
+  }
+
+  pthread_mutex_lock(&g_ctx.queue.lock);
+  struct accel_tenant* t = accel_tenant_get(tenant);
+  if (t) {
+    t->weight = config->weight;
+    t->max_queued = config->max_queued;
+    pthread_mutex_lock(&g_ctx.mem.lock);
+    t->quota.limit = config->mem_quota;
+    pthread_mutex_unlock(&g_ctx.mem.lock);
+  }
+  pthread_mutex_unlock(&g_ctx.queue.lock);
+  return t ? ACCEL_STATUS_OK : ACCEL_STATUS_INVALID_PARAM;
+}
+
+accel_status_t accel_tenant_destroy(accel_tenant_t tenant) {
+  if (!g_ctx.initialized) {
+    return ACCEL_STATUS_NOT_INITIALIZED;
+  }
+  if (tenant == ACCEL_TENANT_DEFAULT) {
+    return ACCEL_STATUS_INVALID_PARAM;
+  }
+
+  pthread_mutex_lock(&g_ctx.queue.lock);
+  struct accel_tenant* t = accel_tenant_get(tenant);
+  if (!t) {
+    pthread_mutex_unlock(&g_ctx.queue.lock);
+    return ACCEL_STATUS_INVALID_PARAM;
+  }
+  if (t->queued > 0) {
+    pthread_mutex_unlock(&g_ctx.queue.lock);
+    snprintf(g_ctx.last_error, sizeof(g_ctx.last_error),
+             "Tenant %u still has %u queued ops", tenant, t->queued);
+    return ACCEL_STATUS_BUSY;
+  }
+
+  // Blocks remember their quota, so it must outlive them. Deactivating
+  // under the memory lock keeps allocations from charging it afterwards
+  pthread_mutex_lock(&g_ctx.mem.lock);
+  size_t used = t->quota.used;
+  if (used == 0) {
+    t->active = false;
+  }
+  pthread_mutex_unlock(&g_ctx.mem.lock);
+  pthread_mutex_unlock(&g_ctx.queue.lock);
+  if (used > 0) {
+    snprintf(g_ctx.last_error, sizeof(g_ctx.last_error),
+             "Tenant %u still owns %zu bytes of device memory", tenant, used);
+    return ACCEL_STATUS_BUSY;
+  }
+  return ACCEL_STATUS_OK;
+}
+
+accel_buffer_t* accel_tenant_alloc_buffer(accel_tenant_t tenant,
+                                          uint32_t size) {
+  if (!g_ctx.initialized) {
+    return NULL;
+  }
+
+  accel_buffer_t* buffer = malloc(sizeof(accel_buffer_t));
+  if (!buffer) {
+    snprintf(g_ctx.last_error, sizeof(g_ctx.last_error),
+             "Failed to allocate buffer descriptor");
+    return NULL;
+  }
+
+  if (accel_mem_alloc(buffer, size, tenant) != ACCEL_STATUS_OK) {
+    free(buffer);
+    return NULL;
+  }
+
+  return buffer;
+}
+
+accel_status_t accel_get_tenant_stats(accel_tenant_t tenant,
+                                      accel_tenant_stats_t* stats) {
+  if (!g_ctx.initialized) {
+    return ACCEL_STATUS_NOT_INITIALIZED;
+  }
+  if (!stats) {
+    return ACCEL_STATUS_INVALID_PARAM;
+  }
+
+  pthread_mutex_lock(&g_ctx.queue.lock);
+  struct accel_tenant* t = accel_tenant_get(tenant);
+  if (t) {
+    *stats = t->stats;
+    stats->weight = t->weight;
+    stats->queued = t->queued;
+    stats->device_time_us = t->device_ns / 1000;
+    pthread_mutex_lock(&g_ctx.mem.lock);
+    stats->mem_quota = t->quota.limit;
+    stats->mem_used = t->quota.used;
+    stats->mem_peak = t->quota.peak;
+    stats->alloc_denied = t->quota.denied;
+    pthread_mutex_unlock(&g_ctx.mem.lock);
+  }
+  pthread_mutex_unlock(&g_ctx.queue.lock);
+  return t ? ACCEL_STATUS_OK : ACCEL_STATUS_INVALID_PARAM;
+}
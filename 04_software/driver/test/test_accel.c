@@ -7,6 +7,8 @@
  * @date 2020-03-30
  */
 
+#include <string.h>
+
 #include "accel.h"
 #include "accel_test.h"
 
@@ -52,6 +54,63 @@ static void test_buffer_management(void) {
   accel_cleanup();
 }
 
+static void test_buffer_import(void) {
+  accel_status_t status = accel_init("/dev/accelerator0");
+  ACCEL_TEST_ASSERT(status == ACCEL_STATUS_OK);
+
+  accel_buffer_t* buffer = accel_alloc_buffer(4096);
+  ACCEL_TEST_ASSERT_NOT_NULL(buffer);
+
+  // A sub-range of device memory can be aliased
+  accel_buffer_t* alias =
+      accel_import_buffer((char*)buffer->host_addr + 1024, 1024);
+  ACCEL_TEST_ASSERT_NOT_NULL(alias);
+  ACCEL_TEST_ASSERT(alias->dev_addr == buffer->dev_addr + 1024);
+  ACCEL_TEST_ASSERT_EQUAL(1024, alias->size);
+  accel_release_buffer(alias);
+
+  // Host memory outside the device region cannot
+  static char host_memory[64];
+  ACCEL_TEST_ASSERT_NULL(accel_import_buffer(host_memory, 64));
+  ACCEL_TEST_ASSERT_NULL(accel_import_buffer(buffer->host_addr, 0));
+
+  accel_free_buffer(buffer);
+  accel_cleanup();
+}
+
+static void test_buffer_sync(void) {
+  // Test before initialization
+  accel_buffer_t stale = {0};
+  ACCEL_TEST_ASSERT(accel_buffer_sync_for_cpu(&stale, 0, 0) ==
+                    ACCEL_STATUS_NOT_INITIALIZED);
+
+  accel_status_t status =
+      accel_init_flags("/dev/accelerator0", ACCEL_INIT_CACHED);
+  ACCEL_TEST_ASSERT(status == ACCEL_STATUS_OK);
+
+  accel_buffer_t* buffer = accel_alloc_buffer(4096);
+  ACCEL_TEST_ASSERT_NOT_NULL(buffer);
+  memset(buffer->host_addr, 0x5a, 4096);
+
+  // Whole buffer and sub-ranges
+  ACCEL_TEST_ASSERT(accel_buffer_sync_for_device(buffer, 0, 0) ==
+                    ACCEL_STATUS_OK);
+  ACCEL_TEST_ASSERT(accel_buffer_sync_for_cpu(buffer, 100, 200) ==
+                    ACCEL_STATUS_OK);
+  ACCEL_TEST_ASSERT_EQUAL(0x5a, ((uint8_t*)buffer->host_addr)[150]);
+
+  // Ranges past the end of the buffer are rejected
+  ACCEL_TEST_ASSERT(accel_buffer_sync_for_device(buffer, 4096, 0) ==
+                    ACCEL_STATUS_INVALID_PARAM);
+  ACCEL_TEST_ASSERT(accel_buffer_sync_for_cpu(buffer, 4000, 100) ==
+                    ACCEL_STATUS_INVALID_PARAM);
+  ACCEL_TEST_ASSERT(accel_buffer_sync_for_cpu(NULL, 0, 0) ==
+                    ACCEL_STATUS_INVALID_PARAM);
+
+  accel_free_buffer(buffer);
+  accel_cleanup();
+}
+
 static void test_operation_submission(void) {
   // Initialize
   accel_status_t status = accel_init("/dev/accelerator0");
@@ -116,6 +175,8 @@ int main(void) {
 
   ACCEL_TEST_RUN(test_init_cleanup);
   ACCEL_TEST_RUN(test_buffer_management);
+  ACCEL_TEST_RUN(test_buffer_import);
+  ACCEL_TEST_RUN(test_buffer_sync);
   ACCEL_TEST_RUN(test_operation_submission);
   ACCEL_TEST_RUN(test_error_handling);
 
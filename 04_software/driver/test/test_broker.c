@@ -0,0 +1,344 @@
+/**
+ * @file test_broker.c
+ * @author Leo (zhsleo@outlook.com)
+ *
+ * @brief Unit tests for the multi-process accelerator broker
+ * @version 1.0.0
+ * @date 2026-10-18
+ */
+
+#include <fcntl.h>
+#include <stdbool.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include "accel.h"
+#include "accel_test.h"
+
+#define DEVICE_PATH "/dev/accelerator0"
+#define SOCKET_PATH "/tmp/accel_test_broker.sock"
+
+#define NUM_PROCESSES 4
+#define OPS_PER_PROCESS 200
+
+/**
+ * @brief Compare device memory at a device address with expected bytes
+ */
+static bool device_matches(uint64_t dev_addr, const void* expected,
+                           size_t size) {
+  int fd = open(DEVICE_PATH, O_RDONLY);
+  if (fd < 0) {
+    return false;
+  }
+  size_t page = getpagesize();
+  uint64_t start = dev_addr & ~(uint64_t)(page - 1);
+  size_t len = dev_addr + size - start;
+  char* map = mmap(NULL, len, PROT_READ, MAP_SHARED, fd, (off_t)start);
+  close(fd);
+  if (map == MAP_FAILED) {
+    return false;
+  }
+  bool match = memcmp(map + (dev_addr - start), expected, size) == 0;
+  munmap(map, len);
+  return match;
+}
+
+/**
+ * @brief Wait until every client has been reaped by the broker
+ */
+static accel_broker_stats_t wait_clients_gone(accel_broker_t* broker) {
+  accel_broker_stats_t stats = {0};
+  for (int i = 0; i < 1000; i++) {
+    accel_get_broker_stats(broker, &stats);
+    if (stats.clients == 0) {
+      break;
+    }
+    usleep(1000);
+  }
+  return stats;
+}
+
+static void test_broker_basic(void) {
+  // A broker needs a device
+  ACCEL_TEST_ASSERT_NULL(accel_broker_start(SOCKET_PATH, NULL));
+
+  accel_status_t status = accel_init(DEVICE_PATH);
+  ACCEL_TEST_ASSERT(status == ACCEL_STATUS_OK);
+  accel_broker_t* broker = accel_broker_start(SOCKET_PATH, NULL);
+  ACCEL_TEST_ASSERT_NOT_NULL(broker);
+
+  accel_client_t* client = accel_client_connect(SOCKET_PATH);
+  ACCEL_TEST_ASSERT_NOT_NULL(client);
+  ACCEL_TEST_ASSERT(accel_client_tenant(client) != ACCEL_TENANT_DEFAULT);
+
+  accel_buffer_t* input = accel_client_alloc_buffer(client, 4096);
+  accel_buffer_t* output = accel_client_alloc_buffer(client, 4096);
+  ACCEL_TEST_ASSERT_NOT_NULL(input);
+  ACCEL_TEST_ASSERT_NOT_NULL(output);
+
+  // Clients do not see device memory; the broker copies inputs in when an
+  // op is queued
+  char pattern[4096];
+  for (size_t i = 0; i < sizeof(pattern); i++) {
+    pattern[i] = (char)(i * 7);
+  }
+  memcpy(input->host_addr, pattern, sizeof(pattern));
+  ACCEL_TEST_ASSERT(
+      !device_matches(input->dev_addr, pattern, sizeof(pattern)));
+
+  // Buffers are charged to the client's tenant
+  accel_tenant_stats_t tenant_stats;
+  ACCEL_TEST_ASSERT(accel_get_tenant_stats(accel_client_tenant(client),
+                                           &tenant_stats) == ACCEL_STATUS_OK);
+  ACCEL_TEST_ASSERT(tenant_stats.mem_used >= 8192);
+
+  accel_op_params_t params = {.op_type = ACCEL_OP_MATMUL,
+                              .input = *input,
+                              .output = *output};
+  accel_op_handle_t handle = 0;
+  status = accel_client_submit_op_async(client, &params, &handle);
+  ACCEL_TEST_ASSERT(status == ACCEL_STATUS_OK);
+  ACCEL_TEST_ASSERT(handle != 0);
+  ACCEL_TEST_ASSERT(accel_client_wait_op(client, handle, 1000) ==
+                    ACCEL_STATUS_OK);
+  ACCEL_TEST_ASSERT(accel_client_wait_op(client, handle, 1000) ==
+                    ACCEL_STATUS_INVALID_PARAM);
+  ACCEL_TEST_ASSERT(device_matches(input->dev_addr, pattern, sizeof(pattern)));
+
+  // The output comes back once the op completed
+  ACCEL_TEST_ASSERT(
+      device_matches(output->dev_addr, output->host_addr, output->size));
+
+  // Buffers of other owners are refused by the broker
+  accel_buffer_t* foreign = accel_alloc_buffer(4096);
+  ACCEL_TEST_ASSERT_NOT_NULL(foreign);
+  params.output = *foreign;
+  status = accel_client_submit_op_async(client, &params, &handle);
+  ACCEL_TEST_ASSERT(status == ACCEL_STATUS_OK);
+  ACCEL_TEST_ASSERT(accel_client_wait_op(client, handle, 1000) ==
+                    ACCEL_STATUS_INVALID_PARAM);
+  accel_free_buffer(foreign);
+
+  accel_client_free_buffer(client, input);
+  accel_client_free_buffer(client, output);
+  ACCEL_TEST_ASSERT(accel_get_tenant_stats(accel_client_tenant(client),
+                                           &tenant_stats) == ACCEL_STATUS_OK);
+  ACCEL_TEST_ASSERT_EQUAL(0, tenant_stats.mem_used);
+  accel_client_disconnect(client);
+
+  accel_broker_stats_t stats = wait_clients_gone(broker);
+  ACCEL_TEST_ASSERT_EQUAL(0, stats.clients);
+  ACCEL_TEST_ASSERT_EQUAL(1, stats.connections);
+  ACCEL_TEST_ASSERT_EQUAL(1, stats.ops_submitted);
+  ACCEL_TEST_ASSERT_EQUAL(2, stats.ops_completed);
+  ACCEL_TEST_ASSERT_EQUAL(2 * 4096, stats.bytes_copied);
+
+  accel_broker_stop(broker);
+  ACCEL_TEST_ASSERT(access(SOCKET_PATH, F_OK) != 0);
+  accel_cleanup();
+}
+
+static void test_broker_ranges(void) {
+  accel_status_t status = accel_init(DEVICE_PATH);
+  ACCEL_TEST_ASSERT(status == ACCEL_STATUS_OK);
+  accel_broker_t* broker = accel_broker_start(SOCKET_PATH, NULL);
+  ACCEL_TEST_ASSERT_NOT_NULL(broker);
+  accel_client_t* client = accel_client_connect(SOCKET_PATH);
+  ACCEL_TEST_ASSERT_NOT_NULL(client);
+
+  accel_buffer_t* input = accel_client_alloc_buffer(client, 8192);
+  accel_buffer_t* weights = accel_client_alloc_buffer(client, 4096);
+  accel_buffer_t* output = accel_client_alloc_buffer(client, 8192);
+  ACCEL_TEST_ASSERT_NOT_NULL(input);
+  ACCEL_TEST_ASSERT_NOT_NULL(weights);
+  ACCEL_TEST_ASSERT_NOT_NULL(output);
+  char* in = input->host_addr;
+  char* w = weights->host_addr;
+  for (size_t i = 0; i < input->size; i++) {
+    in[i] = (char)(i * 5 + 1);
+  }
+  for (size_t i = 0; i < weights->size; i++) {
+    w[i] = (char)(i * 3 + 2);
+  }
+
+  // Ops use the first 1 KiB of the input and 2 KiB of the output; the
+  // input and weights are staged once for all the ops reading them
+  accel_op_params_t params[4];
+  for (int i = 0; i < 4; i++) {
+    params[i] = (accel_op_params_t){.op_type = ACCEL_OP_MATMUL,
+                                    .input = *input,
+                                    .output = *output,
+                                    .weights = *weights};
+    params[i].input.size = 1024;
+    params[i].output.size = 2048;
+  }
+  ACCEL_TEST_ASSERT(accel_client_submit_batch(client, params, 4, NULL) ==
+                    ACCEL_STATUS_OK);
+  ACCEL_TEST_ASSERT(accel_client_wait_complete(client, 1000) ==
+                    ACCEL_STATUS_OK);
+  accel_broker_stats_t stats;
+  accel_get_broker_stats(broker, &stats);
+  ACCEL_TEST_ASSERT_EQUAL(1024 + 4096 + 4 * 2048, stats.bytes_copied);
+  ACCEL_TEST_ASSERT(device_matches(input->dev_addr, in, 1024));
+  ACCEL_TEST_ASSERT(!device_matches(input->dev_addr + 1024, in + 1024,
+                                    input->size - 1024));
+  ACCEL_TEST_ASSERT(device_matches(weights->dev_addr, w, weights->size));
+
+  // Once the ops completed the client may change the input, so the next
+  // op stages it again
+  for (size_t i = 0; i < 1024; i++) {
+    in[i] = (char)~in[i];
+  }
+  params[0].weights = (accel_buffer_t){0};
+  accel_op_handle_t handle = 0;
+  ACCEL_TEST_ASSERT(accel_client_submit_op_async(client, &params[0],
+                                                 &handle) == ACCEL_STATUS_OK);
+  ACCEL_TEST_ASSERT(accel_client_wait_op(client, handle, 1000) ==
+                    ACCEL_STATUS_OK);
+  ACCEL_TEST_ASSERT(device_matches(input->dev_addr, in, 1024));
+  accel_get_broker_stats(broker, &stats);
+  ACCEL_TEST_ASSERT_EQUAL(2 * 1024 + 4096 + 5 * 2048, stats.bytes_copied);
+
+  // A descriptor may not reach past its buffer
+  params[0].input.size = input->size + 1;
+  ACCEL_TEST_ASSERT(accel_client_submit_op_async(client, &params[0],
+                                                 &handle) == ACCEL_STATUS_OK);
+  ACCEL_TEST_ASSERT(accel_client_wait_op(client, handle, 1000) ==
+                    ACCEL_STATUS_INVALID_PARAM);
+
+  accel_client_free_buffer(client, input);
+  accel_client_free_buffer(client, weights);
+  accel_client_free_buffer(client, output);
+  accel_client_disconnect(client);
+  wait_clients_gone(broker);
+  accel_broker_stop(broker);
+  accel_cleanup();
+}
+
+/**
+ * @brief Client process: submit in batches and wait for all ops
+ * @return Process exit code
+ */
+static int run_client(void) {
+  accel_client_t* client = accel_client_connect(SOCKET_PATH);
+  if (!client) {
+    return 1;
+  }
+  accel_buffer_t* input = accel_client_alloc_buffer(client, 8192);
+  accel_buffer_t* output = accel_client_alloc_buffer(client, 8192);
+  if (!input || !output) {
+    return 2;
+  }
+
+  accel_op_params_t params[16];
+  for (int i = 0; i < 16; i++) {
+    params[i] = (accel_op_params_t){.op_type = ACCEL_OP_MATMUL,
+                                    .input = *input,
+                                    .output = *output};
+  }
+  for (int sent = 0; sent < OPS_PER_PROCESS; sent += 16) {
+    uint32_t n = OPS_PER_PROCESS - sent < 16 ? OPS_PER_PROCESS - sent : 16;
+    if (accel_client_submit_batch(client, params, n, NULL) !=
+        ACCEL_STATUS_OK) {
+      return 3;
+    }
+  }
+  if (accel_client_wait_complete(client, 10000) != ACCEL_STATUS_OK) {
+    return 4;
+  }
+
+  accel_client_free_buffer(client, input);
+  accel_client_free_buffer(client, output);
+  accel_client_disconnect(client);
+  return 0;
+}
+
+static void test_broker_processes(void) {
+  accel_status_t status = accel_init(DEVICE_PATH);
+  ACCEL_TEST_ASSERT(status == ACCEL_STATUS_OK);
+  accel_broker_t* broker = accel_broker_start(SOCKET_PATH, NULL);
+  ACCEL_TEST_ASSERT_NOT_NULL(broker);
+
+  pid_t pids[NUM_PROCESSES];
+  for (int i = 0; i < NUM_PROCESSES; i++) {
+    pids[i] = fork();
+    if (pids[i] == 0) {
+      _exit(run_client());
+    }
+    ACCEL_TEST_ASSERT(pids[i] > 0);
+  }
+  for (int i = 0; i < NUM_PROCESSES; i++) {
+    int wstatus = -1;
+    waitpid(pids[i], &wstatus, 0);
+    ACCEL_TEST_ASSERT(WIFEXITED(wstatus) && WEXITSTATUS(wstatus) == 0);
+  }
+
+  accel_broker_stats_t stats = wait_clients_gone(broker);
+  ACCEL_TEST_ASSERT_EQUAL(NUM_PROCESSES, stats.connections);
+  ACCEL_TEST_ASSERT_EQUAL(NUM_PROCESSES * OPS_PER_PROCESS,
+                          stats.ops_submitted);
+  ACCEL_TEST_ASSERT_EQUAL(NUM_PROCESSES * OPS_PER_PROCESS,
+                          stats.ops_completed);
+
+  // Submissions and completions travel in batches, and the ops of a
+  // message reach the driver queue together
+  ACCEL_TEST_ASSERT(stats.messages_received < stats.ops_submitted);
+  ACCEL_TEST_ASSERT(stats.queue_submissions < stats.ops_submitted);
+  ACCEL_TEST_ASSERT(stats.completion_messages < stats.ops_completed);
+
+  // Client tenants and their memory are gone
+  accel_mem_stats_t mem;
+  ACCEL_TEST_ASSERT(accel_get_mem_stats(&mem) == ACCEL_STATUS_OK);
+  ACCEL_TEST_ASSERT_EQUAL(0, mem.live_buffers);
+
+  accel_broker_stop(broker);
+  accel_cleanup();
+}
+
+static void test_broker_client_limit(void) {
+  accel_status_t status = accel_init(DEVICE_PATH);
+  ACCEL_TEST_ASSERT(status == ACCEL_STATUS_OK);
+  accel_broker_t* broker = accel_broker_start(SOCKET_PATH, NULL);
+  ACCEL_TEST_ASSERT_NOT_NULL(broker);
+
+  accel_client_t* clients[ACCEL_BROKER_MAX_CLIENTS];
+  for (int i = 0; i < ACCEL_BROKER_MAX_CLIENTS; i++) {
+    clients[i] = accel_client_connect(SOCKET_PATH);
+    ACCEL_TEST_ASSERT_NOT_NULL(clients[i]);
+  }
+  ACCEL_TEST_ASSERT_NULL(accel_client_connect(SOCKET_PATH));
+
+  accel_broker_stats_t stats;
+  ACCEL_TEST_ASSERT(accel_get_broker_stats(broker, &stats) ==
+                    ACCEL_STATUS_OK);
+  ACCEL_TEST_ASSERT_EQUAL(ACCEL_BROKER_MAX_CLIENTS, stats.clients);
+  ACCEL_TEST_ASSERT_EQUAL(1, stats.rejected);
+
+  // Buffers left behind by a client are freed when it goes away
+  ACCEL_TEST_ASSERT_NOT_NULL(accel_client_alloc_buffer(clients[0], 4096));
+  for (int i = 0; i < ACCEL_BROKER_MAX_CLIENTS; i++) {
+    accel_client_disconnect(clients[i]);
+  }
+  stats = wait_clients_gone(broker);
+  ACCEL_TEST_ASSERT_EQUAL(0, stats.clients);
+
+  accel_mem_stats_t mem;
+  ACCEL_TEST_ASSERT(accel_get_mem_stats(&mem) == ACCEL_STATUS_OK);
+  ACCEL_TEST_ASSERT_EQUAL(0, mem.live_buffers);
+
+  accel_broker_stop(broker);
+  accel_cleanup();
+}
+
+int main(void) {
+  ACCEL_TEST_BEGIN();
+
+  ACCEL_TEST_RUN(test_broker_basic);
+  ACCEL_TEST_RUN(test_broker_ranges);
+  ACCEL_TEST_RUN(test_broker_processes);
+  ACCEL_TEST_RUN(test_broker_client_limit);
+
+  ACCEL_TEST_END();
+}
@@ -0,0 +1,120 @@
+/**
+ * @file test_dma.c
+ * @author Leo (zhsleo@outlook.com)
+ *
+ * @brief Unit tests for DMA cost accounting and transfer sizing
+ * @version 1.0.0
+ * @date 2026-10-18
+ */
+
+#include "accel.h"
+#include "accel_test.h"
+
+#define BUFFER_SIZE (64 * 1024)
+
+/**
+ * @brief Run one op over BUFFER_SIZE bytes with the given tile size
+ * @return DMA read statistics of the op
+ */
+static accel_dma_stats_t run_tiled(accel_buffer_t* input,
+                                   accel_buffer_t* output,
+                                   uint32_t max_transfer) {
+  accel_config_t config;
+  accel_get_config(&config);
+  config.max_transfer = max_transfer;
+  accel_configure(&config);
+  accel_reset_dma_stats();
+
+  accel_op_params_t params = {.op_type = ACCEL_OP_MATMUL,
+                              .input = *input,
+                              .output = *output};
+  accel_submit_op(&params);
+  accel_wait_complete(1000);
+
+  accel_dma_stats_t stats = {0};
+  accel_get_dma_stats(ACCEL_DMA_READ, &stats);
+  return stats;
+}
+
+static void test_dma_stats(void) {
+  accel_dma_stats_t stats;
+  ACCEL_TEST_ASSERT(accel_get_dma_stats(ACCEL_DMA_READ, &stats) ==
+                    ACCEL_STATUS_NOT_INITIALIZED);
+
+  accel_status_t status = accel_init("/dev/accelerator0");
+  ACCEL_TEST_ASSERT(status == ACCEL_STATUS_OK);
+  ACCEL_TEST_ASSERT(accel_reset_config() == ACCEL_STATUS_OK);
+
+  accel_buffer_t* input = accel_alloc_buffer(BUFFER_SIZE);
+  accel_buffer_t* output = accel_alloc_buffer(BUFFER_SIZE);
+  ACCEL_TEST_ASSERT_NOT_NULL(input);
+  ACCEL_TEST_ASSERT_NOT_NULL(output);
+
+  // Every tile is one transfer on each channel
+  stats = run_tiled(input, output, 4096);
+  ACCEL_TEST_ASSERT_EQUAL(16, stats.requests);
+  ACCEL_TEST_ASSERT_EQUAL(16, stats.transfers);
+  ACCEL_TEST_ASSERT_EQUAL(BUFFER_SIZE, stats.bytes);
+  ACCEL_TEST_ASSERT_EQUAL(16 * 5, stats.lite_accesses);
+
+  accel_dma_stats_t write_stats;
+  ACCEL_TEST_ASSERT(accel_get_dma_stats(ACCEL_DMA_WRITE, &write_stats) ==
+                    ACCEL_STATUS_OK);
+  ACCEL_TEST_ASSERT_EQUAL(BUFFER_SIZE, write_stats.bytes);
+
+  // Coalescing into one tile pays the setup once for the same data time
+  accel_dma_stats_t coalesced = run_tiled(input, output, BUFFER_SIZE);
+  ACCEL_TEST_ASSERT_EQUAL(1, coalesced.transfers);
+  ACCEL_TEST_ASSERT_EQUAL(stats.data_cycles, coalesced.data_cycles);
+  ACCEL_TEST_ASSERT_EQUAL(stats.setup_cycles, 16 * coalesced.setup_cycles);
+  ACCEL_TEST_ASSERT(coalesced.efficiency_pct > stats.efficiency_pct);
+
+  // Small tiles are dominated by setup
+  accel_dma_stats_t tiny = run_tiled(input, output, 64);
+  ACCEL_TEST_ASSERT(tiny.setup_cycles > tiny.data_cycles);
+  ACCEL_TEST_ASSERT(tiny.efficiency_pct < 50);
+
+  ACCEL_TEST_ASSERT(accel_get_dma_stats(ACCEL_DMA_CHANNELS, &stats) ==
+                    ACCEL_STATUS_INVALID_PARAM);
+
+  accel_free_buffer(input);
+  accel_free_buffer(output);
+  accel_cleanup();
+}
+
+static void test_dma_timing(void) {
+  accel_status_t status = accel_init("/dev/accelerator0");
+  ACCEL_TEST_ASSERT(status == ACCEL_STATUS_OK);
+
+  accel_dma_timing_t timing;
+  ACCEL_TEST_ASSERT(accel_get_dma_timing(&timing) == ACCEL_STATUS_OK);
+  ACCEL_TEST_ASSERT(timing.clock_mhz > 0);
+  ACCEL_TEST_ASSERT(timing.bytes_per_cycle > 0);
+
+  // A wider stream halves the data time
+  accel_buffer_t* input = accel_alloc_buffer(BUFFER_SIZE);
+  accel_buffer_t* output = accel_alloc_buffer(BUFFER_SIZE);
+  accel_dma_stats_t narrow = run_tiled(input, output, BUFFER_SIZE);
+  timing.bytes_per_cycle *= 2;
+  ACCEL_TEST_ASSERT(accel_set_dma_timing(&timing) == ACCEL_STATUS_OK);
+  accel_dma_stats_t wide = run_tiled(input, output, BUFFER_SIZE);
+  ACCEL_TEST_ASSERT_EQUAL(narrow.data_cycles, 2 * wide.data_cycles);
+  ACCEL_TEST_ASSERT_EQUAL(narrow.setup_cycles, wide.setup_cycles);
+
+  timing.clock_mhz = 0;
+  ACCEL_TEST_ASSERT(accel_set_dma_timing(&timing) ==
+                    ACCEL_STATUS_INVALID_PARAM);
+
+  accel_free_buffer(input);
+  accel_free_buffer(output);
+  accel_cleanup();
+}
+
+int main(void) {
+  ACCEL_TEST_BEGIN();
+
+  ACCEL_TEST_RUN(test_dma_stats);
+  ACCEL_TEST_RUN(test_dma_timing);
+
+  ACCEL_TEST_END();
+}
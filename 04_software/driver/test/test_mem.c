@@ -0,0 +1,341 @@
+/**
+ * @file test_mem.c
+ * @author Leo (zhsleo@outlook.com)
+ *
+ * @brief Unit tests for device memory management and host arenas
+ * @version 1.0.0
+ * @date 2026-10-18
+ */
+
+#include <stdbool.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "accel.h"
+#include "accel_test.h"
+
+#define BLOCK_SIZE 4096
+
+static void test_mem_stats(void) {
+  accel_status_t status = accel_init("/dev/accelerator0");
+  ACCEL_TEST_ASSERT(status == ACCEL_STATUS_OK);
+
+  accel_mem_stats_t stats;
+  ACCEL_TEST_ASSERT(accel_get_mem_stats(&stats) == ACCEL_STATUS_OK);
+  ACCEL_TEST_ASSERT_EQUAL(0, stats.live_buffers);
+  ACCEL_TEST_ASSERT_EQUAL(0, stats.fragmentation_pct);
+  ACCEL_TEST_ASSERT(stats.total_free == stats.total_size);
+
+  accel_buffer_t* buffers[4];
+  for (int i = 0; i < 4; i++) {
+    buffers[i] = accel_alloc_buffer(BLOCK_SIZE);
+    ACCEL_TEST_ASSERT_NOT_NULL(buffers[i]);
+    ACCEL_TEST_ASSERT(buffers[i]->handle != 0);
+  }
+  ACCEL_TEST_ASSERT(accel_get_mem_stats(&stats) == ACCEL_STATUS_OK);
+  ACCEL_TEST_ASSERT_EQUAL(4, stats.live_buffers);
+
+  // Holes in front of live buffers: free space is no longer one block
+  accel_free_buffer(buffers[0]);
+  accel_free_buffer(buffers[2]);
+  ACCEL_TEST_ASSERT(accel_get_mem_stats(&stats) == ACCEL_STATUS_OK);
+  ACCEL_TEST_ASSERT_EQUAL(3, stats.free_blocks);
+  ACCEL_TEST_ASSERT(stats.largest_free < stats.total_free);
+
+  accel_free_buffer(buffers[1]);
+  accel_free_buffer(buffers[3]);
+  accel_cleanup();
+}
+
+static void test_mem_compaction(void) {
+  accel_status_t status = accel_init("/dev/accelerator0");
+  ACCEL_TEST_ASSERT(status == ACCEL_STATUS_OK);
+
+  accel_buffer_t* buffers[4];
+  for (int i = 0; i < 4; i++) {
+    buffers[i] = accel_alloc_buffer(BLOCK_SIZE);
+    memset(buffers[i]->host_addr, 'a' + i, BLOCK_SIZE);
+  }
+  void* base = buffers[0]->host_addr;
+  uint64_t dev_base = buffers[0]->dev_addr;
+
+  accel_buffer_t* alias =
+      accel_import_buffer((char*)buffers[3]->host_addr + 64, 64);
+  ACCEL_TEST_ASSERT_NOT_NULL(alias);
+
+  accel_free_buffer(buffers[0]);
+  accel_free_buffer(buffers[2]);
+
+  // Live buffers slide down; descriptors and aliases follow
+  uint64_t moved = 0;
+  ACCEL_TEST_ASSERT(accel_compact_memory(&moved) == ACCEL_STATUS_OK);
+  ACCEL_TEST_ASSERT_EQUAL(2 * BLOCK_SIZE, moved);
+  ACCEL_TEST_ASSERT(buffers[1]->host_addr == base);
+  ACCEL_TEST_ASSERT(buffers[1]->dev_addr == dev_base);
+  ACCEL_TEST_ASSERT(buffers[3]->dev_addr == dev_base + BLOCK_SIZE);
+  ACCEL_TEST_ASSERT_EQUAL('b', ((char*)buffers[1]->host_addr)[0]);
+  ACCEL_TEST_ASSERT_EQUAL('d', ((char*)buffers[3]->host_addr)[0]);
+  ACCEL_TEST_ASSERT(alias->host_addr == (char*)buffers[3]->host_addr + 64);
+  ACCEL_TEST_ASSERT(alias->dev_addr == buffers[3]->dev_addr + 64);
+
+  accel_mem_stats_t stats;
+  ACCEL_TEST_ASSERT(accel_get_mem_stats(&stats) == ACCEL_STATUS_OK);
+  ACCEL_TEST_ASSERT_EQUAL(1, stats.free_blocks);
+  ACCEL_TEST_ASSERT_EQUAL(0, stats.fragmentation_pct);
+  ACCEL_TEST_ASSERT_EQUAL(1, stats.compactions);
+
+  // Pinning the alias pins the buffer behind it
+  accel_free_buffer(buffers[1]);
+  void* pinned_addr = buffers[3]->host_addr;
+  ACCEL_TEST_ASSERT(accel_buffer_pin(alias) == ACCEL_STATUS_OK);
+  ACCEL_TEST_ASSERT(accel_get_mem_stats(&stats) == ACCEL_STATUS_OK);
+  ACCEL_TEST_ASSERT_EQUAL(1, stats.pinned_buffers);
+  ACCEL_TEST_ASSERT(accel_compact_memory(&moved) == ACCEL_STATUS_OK);
+  ACCEL_TEST_ASSERT_EQUAL(0, moved);
+  ACCEL_TEST_ASSERT(buffers[3]->host_addr == pinned_addr);
+
+  ACCEL_TEST_ASSERT(accel_buffer_unpin(alias) == ACCEL_STATUS_OK);
+  ACCEL_TEST_ASSERT(accel_buffer_unpin(alias) == ACCEL_STATUS_INVALID_PARAM);
+  ACCEL_TEST_ASSERT(accel_compact_memory(&moved) == ACCEL_STATUS_OK);
+  ACCEL_TEST_ASSERT(buffers[3]->host_addr == base);
+
+  accel_release_buffer(alias);
+  accel_free_buffer(buffers[3]);
+  accel_cleanup();
+}
+
+static void test_mem_import_outlived(void) {
+  accel_status_t status = accel_init("/dev/accelerator0");
+  ACCEL_TEST_ASSERT(status == ACCEL_STATUS_OK);
+
+  accel_buffer_t* hole = accel_alloc_buffer(BLOCK_SIZE);
+  accel_buffer_t* owner = accel_alloc_buffer(BLOCK_SIZE);
+  accel_buffer_t* alias =
+      accel_import_buffer((char*)owner->host_addr + 128, 256);
+  accel_buffer_t* other =
+      accel_import_buffer((char*)owner->host_addr + 1024, 64);
+  ACCEL_TEST_ASSERT_NOT_NULL(alias);
+  ACCEL_TEST_ASSERT_NOT_NULL(other);
+  accel_buffer_t copy = *alias;
+
+  // Freeing the buffer invalidates its imports, stale copies included
+  accel_release_buffer(other);
+  accel_free_buffer(owner);
+  ACCEL_TEST_ASSERT_NULL(alias->host_addr);
+  ACCEL_TEST_ASSERT_EQUAL(0, alias->dev_addr);
+  ACCEL_TEST_ASSERT_EQUAL(0, alias->size);
+  ACCEL_TEST_ASSERT(accel_buffer_sync_for_cpu(alias, 0, 0) ==
+                    ACCEL_STATUS_INVALID_PARAM);
+  ACCEL_TEST_ASSERT(accel_buffer_sync_for_device(&copy, 0, 0) ==
+                    ACCEL_STATUS_INVALID_PARAM);
+  ACCEL_TEST_ASSERT(accel_buffer_pin(alias) == ACCEL_STATUS_OK);
+  ACCEL_TEST_ASSERT(accel_buffer_unpin(alias) == ACCEL_STATUS_OK);
+
+  // The next allocation takes the freed slot without inheriting the alias
+  accel_buffer_t* reused = accel_alloc_buffer(BLOCK_SIZE);
+  memset(reused->host_addr, 'r', BLOCK_SIZE);
+  accel_free_buffer(hole);
+  uint64_t moved = 0;
+  ACCEL_TEST_ASSERT(accel_compact_memory(&moved) == ACCEL_STATUS_OK);
+  ACCEL_TEST_ASSERT_EQUAL(BLOCK_SIZE, moved);
+  ACCEL_TEST_ASSERT_EQUAL('r', ((char*)reused->host_addr)[0]);
+  ACCEL_TEST_ASSERT_NULL(alias->host_addr);
+
+  accel_mem_stats_t stats;
+  ACCEL_TEST_ASSERT(accel_get_mem_stats(&stats) == ACCEL_STATUS_OK);
+  ACCEL_TEST_ASSERT_EQUAL(1, stats.live_buffers);
+
+  accel_release_buffer(alias);
+  accel_free_buffer(reused);
+  accel_cleanup();
+}
+
+static void test_mem_compaction_many(void) {
+  accel_status_t status = accel_init("/dev/accelerator0");
+  ACCEL_TEST_ASSERT(status == ACCEL_STATUS_OK);
+
+  // Every other buffer freed, each survivor aliased twice
+  enum { COUNT = 64 };
+  accel_buffer_t* buffers[COUNT];
+  accel_buffer_t* aliases[COUNT][2] = {{NULL}};
+  for (int i = 0; i < COUNT; i++) {
+    buffers[i] = accel_alloc_buffer(BLOCK_SIZE);
+    memset(buffers[i]->host_addr, i, BLOCK_SIZE);
+  }
+  void* base = buffers[0]->host_addr;
+  for (int i = 1; i < COUNT; i += 2) {
+    aliases[i][0] = accel_import_buffer(buffers[i]->host_addr, 16);
+    aliases[i][1] =
+        accel_import_buffer((char*)buffers[i]->host_addr + 512, 32);
+  }
+  for (int i = 0; i < COUNT; i += 2) {
+    accel_free_buffer(buffers[i]);
+  }
+
+  uint64_t moved = 0;
+  ACCEL_TEST_ASSERT(accel_compact_memory(&moved) == ACCEL_STATUS_OK);
+  ACCEL_TEST_ASSERT_EQUAL(COUNT / 2 * BLOCK_SIZE, moved);
+  bool placed = true;
+  for (int i = 1; i < COUNT; i += 2) {
+    char* host = buffers[i]->host_addr;
+    placed = placed && host == (char*)base + i / 2 * BLOCK_SIZE &&
+             host[0] == i && aliases[i][0]->host_addr == host &&
+             aliases[i][1]->host_addr == host + 512 &&
+             aliases[i][1]->dev_addr == buffers[i]->dev_addr + 512;
+  }
+  ACCEL_TEST_ASSERT(placed);
+
+  for (int i = 1; i < COUNT; i += 2) {
+    accel_release_buffer(aliases[i][0]);
+    accel_release_buffer(aliases[i][1]);
+    accel_free_buffer(buffers[i]);
+  }
+  accel_cleanup();
+}
+
+static void test_mem_compaction_with_queued_ops(void) {
+  accel_status_t status = accel_init("/dev/accelerator0");
+  ACCEL_TEST_ASSERT(status == ACCEL_STATUS_OK);
+
+  accel_config_t config = {.flags = ACCEL_CONFIG_ENABLE_DMA,
+                           .num_channels = 1,
+                           .max_transfer = 64,
+                           .timeout_ms = 1000};
+  ACCEL_TEST_ASSERT(accel_configure(&config) == ACCEL_STATUS_OK);
+
+  accel_buffer_t* hole = accel_alloc_buffer(BLOCK_SIZE);
+  accel_buffer_t* input = accel_alloc_buffer(1024 * 1024);
+  accel_buffer_t* output = accel_alloc_buffer(1024 * 1024);
+  accel_free_buffer(hole);
+
+  // The op holds descriptor copies; later tiles use the new addresses
+  accel_op_params_t params = {.op_type = ACCEL_OP_MATMUL,
+                              .input = *input,
+                              .output = *output};
+  accel_op_handle_t handle = 0;
+  ACCEL_TEST_ASSERT(accel_submit_op_async(&params, &handle) ==
+                    ACCEL_STATUS_OK);
+  uint64_t moved = 0;
+  ACCEL_TEST_ASSERT(accel_compact_memory(&moved) == ACCEL_STATUS_OK);
+  ACCEL_TEST_ASSERT(moved > 0);
+  ACCEL_TEST_ASSERT(accel_wait_op(handle, 0) == ACCEL_STATUS_OK);
+
+  // Stale copies are refreshed for cache maintenance too
+  ACCEL_TEST_ASSERT(accel_buffer_sync_for_cpu(&params.output, 0, 0) ==
+                    ACCEL_STATUS_OK);
+
+  accel_free_buffer(input);
+  accel_free_buffer(output);
+  accel_cleanup();
+}
+
+static void test_mem_auto_compaction(void) {
+  accel_status_t status = accel_init("/dev/accelerator0");
+  ACCEL_TEST_ASSERT(status == ACCEL_STATUS_OK);
+
+  accel_buffer_t* first = accel_alloc_buffer(BLOCK_SIZE);
+  accel_buffer_t* second = accel_alloc_buffer(BLOCK_SIZE);
+  accel_free_buffer(first);
+
+  ACCEL_TEST_ASSERT(accel_set_auto_compaction(1, 5) == ACCEL_STATUS_OK);
+
+  accel_mem_stats_t stats = {0};
+  for (int i = 0; i < 200 && stats.compactions == 0; i++) {
+    usleep(5000);
+    accel_get_mem_stats(&stats);
+  }
+  ACCEL_TEST_ASSERT(stats.compactions >= 1);
+  ACCEL_TEST_ASSERT_EQUAL(0, stats.fragmentation_pct);
+
+  ACCEL_TEST_ASSERT(accel_set_auto_compaction(0, 0) == ACCEL_STATUS_OK);
+  ACCEL_TEST_ASSERT(accel_set_auto_compaction(101, 5) ==
+                    ACCEL_STATUS_INVALID_PARAM);
+  ACCEL_TEST_ASSERT(accel_set_auto_compaction(50, 0) ==
+                    ACCEL_STATUS_INVALID_PARAM);
+
+  accel_free_buffer(second);
+  accel_cleanup();
+}
+
+static void test_mem_page_flags(void) {
+  accel_status_t status = accel_init_flags(
+      "/dev/accelerator0", ACCEL_INIT_PREFAULT | ACCEL_INIT_HUGE_2M);
+  ACCEL_TEST_ASSERT(status == ACCEL_STATUS_OK);
+
+  // Huge pages only if the system reserved them; base pages otherwise
+  accel_mem_stats_t stats;
+  ACCEL_TEST_ASSERT(accel_get_mem_stats(&stats) == ACCEL_STATUS_OK);
+  ACCEL_TEST_ASSERT(stats.page_size == (2u << 20) ||
+                    stats.page_size == (uint64_t)getpagesize());
+
+  accel_buffer_t* buffer = accel_alloc_buffer(BLOCK_SIZE);
+  ACCEL_TEST_ASSERT_NOT_NULL(buffer);
+  memset(buffer->host_addr, 0x5A, BLOCK_SIZE);
+  ACCEL_TEST_ASSERT_EQUAL(0x5A, ((unsigned char*)buffer->host_addr)[100]);
+  accel_free_buffer(buffer);
+  accel_cleanup();
+}
+
+static void test_arena(void) {
+  // Arenas work without an initialized driver
+  accel_arena_t* arena =
+      accel_arena_create(1 << 20, ACCEL_INIT_PREFAULT | ACCEL_INIT_HUGE_2M);
+  ACCEL_TEST_ASSERT_NOT_NULL(arena);
+  ACCEL_TEST_ASSERT_EQUAL(1 << 20, accel_arena_capacity(arena));
+  ACCEL_TEST_ASSERT(accel_arena_page_size(arena) > 0);
+
+  char* first = accel_arena_alloc(arena, 100, 0);
+  char* second = accel_arena_alloc(arena, 100, 4096);
+  ACCEL_TEST_ASSERT_NOT_NULL(first);
+  ACCEL_TEST_ASSERT_NOT_NULL(second);
+  ACCEL_TEST_ASSERT_EQUAL(0, (uintptr_t)first % 64);
+  ACCEL_TEST_ASSERT_EQUAL(0, (uintptr_t)second % 4096);
+  ACCEL_TEST_ASSERT(second >= first + 100);
+  ACCEL_TEST_ASSERT_EQUAL(4096 + 100, accel_arena_used(arena));
+  memset(second, 1, 100);
+
+  ACCEL_TEST_ASSERT_NULL(accel_arena_alloc(arena, 1 << 20, 0));
+  ACCEL_TEST_ASSERT_NULL(accel_arena_alloc(arena, 8, 3));
+
+  // Reset hands out the same memory again
+  accel_arena_reset(arena);
+  ACCEL_TEST_ASSERT_EQUAL(0, accel_arena_used(arena));
+  ACCEL_TEST_ASSERT(accel_arena_alloc(arena, 100, 0) == first);
+
+  accel_arena_destroy(arena);
+  accel_arena_destroy(NULL);
+  ACCEL_TEST_ASSERT_NULL(accel_arena_create(0, 0));
+}
+
+static void test_mem_invalid_params(void) {
+  // Test before initialization
+  accel_mem_stats_t stats;
+  ACCEL_TEST_ASSERT(accel_get_mem_stats(&stats) ==
+                    ACCEL_STATUS_NOT_INITIALIZED);
+  ACCEL_TEST_ASSERT(accel_compact_memory(NULL) ==
+                    ACCEL_STATUS_NOT_INITIALIZED);
+  ACCEL_TEST_ASSERT(accel_set_auto_compaction(50, 10) ==
+                    ACCEL_STATUS_NOT_INITIALIZED);
+
+  accel_status_t status = accel_init("/dev/accelerator0");
+  ACCEL_TEST_ASSERT(status == ACCEL_STATUS_OK);
+  ACCEL_TEST_ASSERT(accel_get_mem_stats(NULL) == ACCEL_STATUS_INVALID_PARAM);
+  ACCEL_TEST_ASSERT(accel_buffer_pin(NULL) == ACCEL_STATUS_INVALID_PARAM);
+  accel_cleanup();
+}
+
+int main(void) {
+  ACCEL_TEST_BEGIN();
+
+  ACCEL_TEST_RUN(test_mem_stats);
+  ACCEL_TEST_RUN(test_mem_compaction);
+  ACCEL_TEST_RUN(test_mem_import_outlived);
+  ACCEL_TEST_RUN(test_mem_compaction_many);
+  ACCEL_TEST_RUN(test_mem_compaction_with_queued_ops);
+  ACCEL_TEST_RUN(test_mem_auto_compaction);
+  ACCEL_TEST_RUN(test_mem_page_flags);
+  ACCEL_TEST_RUN(test_arena);
+  ACCEL_TEST_RUN(test_mem_invalid_params);
+
+  ACCEL_TEST_END();
+}
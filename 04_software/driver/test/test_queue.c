@@ -0,0 +1,325 @@
+/**
+ * @file test_queue.c
+ * @author Leo (zhsleo@outlook.com)
+ *
+ * @brief Unit tests for the priority submission queue
+ * @version 1.0.0
+ * @date 2026-10-18
+ */
+
+#include <pthread.h>
+#include <stdint.h>
+#include <unistd.h>
+
+#include "../src/accel_internal.h"
+#include "accel.h"
+#include "accel_test.h"
+
+static void test_async_submit_wait(void) {
+  accel_status_t status = accel_init("/dev/accelerator0");
+  ACCEL_TEST_ASSERT(status == ACCEL_STATUS_OK);
+  ACCEL_TEST_ASSERT(accel_reset_config() == ACCEL_STATUS_OK);
+
+  accel_buffer_t* input = accel_alloc_buffer(4096);
+  accel_buffer_t* output = accel_alloc_buffer(4096);
+  ACCEL_TEST_ASSERT_NOT_NULL(input);
+  ACCEL_TEST_ASSERT_NOT_NULL(output);
+
+  accel_op_params_t params = {.op_type = ACCEL_OP_MATMUL,
+                              .input = *input,
+                              .output = *output,
+                              .priority = ACCEL_PRIORITY_NORMAL};
+
+  accel_op_handle_t handle = 0;
+  status = accel_submit_op_async(&params, &handle);
+  ACCEL_TEST_ASSERT(status == ACCEL_STATUS_OK);
+  ACCEL_TEST_ASSERT(handle != 0);
+
+  status = accel_wait_op(handle, 1000);
+  ACCEL_TEST_ASSERT(status == ACCEL_STATUS_OK);
+
+  // Waiting again on a finished op is fine
+  status = accel_wait_op(handle, 1000);
+  ACCEL_TEST_ASSERT(status == ACCEL_STATUS_OK);
+
+  // Unknown handles are rejected
+  status = accel_wait_op(handle + 100, 1000);
+  ACCEL_TEST_ASSERT(status == ACCEL_STATUS_INVALID_PARAM);
+
+  accel_queue_stats_t stats = {0};
+  status = accel_get_queue_stats(ACCEL_PRIORITY_NORMAL, &stats);
+  ACCEL_TEST_ASSERT(status == ACCEL_STATUS_OK);
+  ACCEL_TEST_ASSERT_EQUAL(1, stats.submitted);
+  ACCEL_TEST_ASSERT_EQUAL(1, stats.completed);
+
+  accel_free_buffer(input);
+  accel_free_buffer(output);
+  accel_cleanup();
+}
+
+static void test_status_expiry(void) {
+  accel_status_t status = accel_init("/dev/accelerator0");
+  ACCEL_TEST_ASSERT(status == ACCEL_STATUS_OK);
+  ACCEL_TEST_ASSERT(accel_reset_config() == ACCEL_STATUS_OK);
+
+  accel_buffer_t* input = accel_alloc_buffer(64);
+  accel_buffer_t* output = accel_alloc_buffer(64);
+  accel_op_params_t params = {.op_type = ACCEL_OP_MATMUL,
+                              .input = *input,
+                              .output = *output};
+
+  accel_op_handle_t first = 0;
+  ACCEL_TEST_ASSERT(accel_submit_op_async(&params, &first) ==
+                    ACCEL_STATUS_OK);
+
+  // Reuse the first op's slot several times over without waiting on it
+  int reused = 1;
+  for (int i = 0; i < 2 * 64; i++) {
+    reused &= accel_submit_op(&params) == ACCEL_STATUS_OK;
+    reused &= accel_wait_complete(1000) == ACCEL_STATUS_OK;
+  }
+  ACCEL_TEST_ASSERT(reused);
+  ACCEL_TEST_ASSERT(accel_wait_op(first, 1000) == ACCEL_STATUS_OK);
+
+  // Once enough later ops finished, the status is reported as gone
+  for (int i = 0; i < 4 * 64; i++) {
+    reused &= accel_submit_op(&params) == ACCEL_STATUS_OK;
+    reused &= accel_wait_complete(1000) == ACCEL_STATUS_OK;
+  }
+  ACCEL_TEST_ASSERT(reused);
+  ACCEL_TEST_ASSERT(accel_wait_op(first, 1000) == ACCEL_STATUS_EXPIRED);
+
+  accel_free_buffer(input);
+  accel_free_buffer(output);
+  accel_cleanup();
+}
+
+static void test_config_high_priority(void) {
+  accel_status_t status = accel_init("/dev/accelerator0");
+  ACCEL_TEST_ASSERT(status == ACCEL_STATUS_OK);
+
+  accel_config_t config = {.flags = ACCEL_CONFIG_HIGH_PRIORITY,
+                           .num_channels = 1,
+                           .max_transfer = 0x1000000,
+                           .timeout_ms = 1000};
+  ACCEL_TEST_ASSERT(accel_configure(&config) == ACCEL_STATUS_OK);
+
+  accel_buffer_t* input = accel_alloc_buffer(1024);
+  accel_buffer_t* output = accel_alloc_buffer(1024);
+
+  // A normal-priority op is promoted by the device configuration
+  accel_op_params_t params = {.op_type = ACCEL_OP_CONV2D,
+                              .input = *input,
+                              .output = *output,
+                              .priority = ACCEL_PRIORITY_NORMAL};
+  ACCEL_TEST_ASSERT(accel_submit_op(&params) == ACCEL_STATUS_OK);
+  ACCEL_TEST_ASSERT(accel_wait_complete(1000) == ACCEL_STATUS_OK);
+
+  accel_queue_stats_t high = {0};
+  accel_queue_stats_t normal = {0};
+  accel_get_queue_stats(ACCEL_PRIORITY_HIGH, &high);
+  accel_get_queue_stats(ACCEL_PRIORITY_NORMAL, &normal);
+  ACCEL_TEST_ASSERT_EQUAL(1, high.completed);
+  ACCEL_TEST_ASSERT_EQUAL(0, normal.submitted);
+
+  ACCEL_TEST_ASSERT(accel_reset_queue_stats() == ACCEL_STATUS_OK);
+  accel_get_queue_stats(ACCEL_PRIORITY_HIGH, &high);
+  ACCEL_TEST_ASSERT_EQUAL(0, high.completed);
+
+  accel_free_buffer(input);
+  accel_free_buffer(output);
+  accel_cleanup();
+}
+
+static void test_preemption(void) {
+  accel_status_t status = accel_init("/dev/accelerator0");
+  ACCEL_TEST_ASSERT(status == ACCEL_STATUS_OK);
+
+  // Small tiles so that the bulk op spans many tile boundaries
+  accel_config_t config = {.flags = ACCEL_CONFIG_ENABLE_DMA,
+                           .num_channels = 1,
+                           .max_transfer = 64,
+                           .timeout_ms = 1000};
+  ACCEL_TEST_ASSERT(accel_configure(&config) == ACCEL_STATUS_OK);
+
+  accel_buffer_t* bulk_in = accel_alloc_buffer(4096);
+  accel_buffer_t* bulk_out = accel_alloc_buffer(4096);
+  accel_buffer_t* small_in = accel_alloc_buffer(256);
+  accel_buffer_t* small_out = accel_alloc_buffer(256);
+  ACCEL_TEST_ASSERT_NOT_NULL(bulk_in);
+  ACCEL_TEST_ASSERT_NOT_NULL(small_in);
+
+  accel_op_params_t bulk = {.op_type = ACCEL_OP_MATMUL,
+                            .input = *bulk_in,
+                            .output = *bulk_out,
+                            .priority = ACCEL_PRIORITY_NORMAL};
+  accel_op_params_t urgent = {.op_type = ACCEL_OP_MATMUL,
+                              .input = *small_in,
+                              .output = *small_out,
+                              .priority = ACCEL_PRIORITY_HIGH};
+
+  // Hold the dispatcher, let the bulk op run one tile, then queue the
+  // urgent op while the bulk op is between tiles
+  accel_queue_gate(0);
+  accel_queue_wait_gated();
+  accel_op_handle_t bulk_handle = 0;
+  accel_op_handle_t urgent_handle = 0;
+  ACCEL_TEST_ASSERT(accel_submit_op_async(&bulk, &bulk_handle) ==
+                    ACCEL_STATUS_OK);
+  accel_queue_gate(1);
+  accel_queue_wait_gated();
+  ACCEL_TEST_ASSERT(accel_submit_op_async(&urgent, &urgent_handle) ==
+                    ACCEL_STATUS_OK);
+
+  // The next four tiles are the whole urgent op
+  accel_queue_gate(256 / 64);
+  ACCEL_TEST_ASSERT(accel_wait_op(urgent_handle, 0) == ACCEL_STATUS_OK);
+  accel_queue_wait_gated();
+
+  accel_queue_stats_t normal = {0};
+  accel_get_queue_stats(ACCEL_PRIORITY_NORMAL, &normal);
+  ACCEL_TEST_ASSERT_EQUAL(1, normal.preempted);
+  ACCEL_TEST_ASSERT_EQUAL(0, normal.completed);
+
+  accel_queue_gate(UINT32_MAX);
+  ACCEL_TEST_ASSERT(accel_wait_op(bulk_handle, 0) == ACCEL_STATUS_OK);
+  accel_get_queue_stats(ACCEL_PRIORITY_NORMAL, &normal);
+  ACCEL_TEST_ASSERT_EQUAL(1, normal.completed);
+
+  accel_free_buffer(bulk_in);
+  accel_free_buffer(bulk_out);
+  accel_free_buffer(small_in);
+  accel_free_buffer(small_out);
+  accel_cleanup();
+}
+
+static volatile int callback_count = 0;
+static volatile accel_status_t callback_status = ACCEL_STATUS_ERROR;
+
+static void on_complete(accel_op_handle_t handle, accel_status_t status,
+                        void* user_data) {
+  (void)handle;
+  callback_count += *(int*)user_data;
+  callback_status = status;
+}
+
+static void test_completion_callback(void) {
+  accel_status_t status = accel_init("/dev/accelerator0");
+  ACCEL_TEST_ASSERT(status == ACCEL_STATUS_OK);
+
+  accel_buffer_t* input = accel_alloc_buffer(1024);
+  accel_buffer_t* output = accel_alloc_buffer(1024);
+  accel_op_params_t params = {.op_type = ACCEL_OP_MATMUL,
+                              .input = *input,
+                              .output = *output};
+
+  int increment = 1;
+  accel_op_handle_t handle = 0;
+  status = accel_submit_op_notify(&params, on_complete, &increment, &handle);
+  ACCEL_TEST_ASSERT(status == ACCEL_STATUS_OK);
+  ACCEL_TEST_ASSERT(accel_wait_op(handle, 1000) == ACCEL_STATUS_OK);
+
+  // The callback runs right after the waiter is released
+  for (int i = 0; i < 1000 && callback_count == 0; i++) {
+    usleep(100);
+  }
+  ACCEL_TEST_ASSERT_EQUAL(1, callback_count);
+  ACCEL_TEST_ASSERT(callback_status == ACCEL_STATUS_OK);
+
+  accel_free_buffer(input);
+  accel_free_buffer(output);
+  accel_cleanup();
+}
+
+struct blocked_submit {
+  accel_op_params_t params;
+  accel_op_handle_t handle;
+  accel_status_t status;
+  volatile int done;
+};
+
+static void* submit_waiting(void* arg) {
+  struct blocked_submit* submit = arg;
+  submit->status = accel_submit_op_wait(&submit->params, &submit->handle, 0);
+  submit->done = 1;
+  return NULL;
+}
+
+static void test_submit_wait_for_room(void) {
+  accel_status_t status = accel_init("/dev/accelerator0");
+  ACCEL_TEST_ASSERT(status == ACCEL_STATUS_OK);
+
+  accel_buffer_t* input = accel_alloc_buffer(256);
+  accel_buffer_t* output = accel_alloc_buffer(256);
+  accel_op_params_t params = {.op_type = ACCEL_OP_MATMUL,
+                              .input = *input,
+                              .output = *output};
+
+  // Hold the dispatcher and fill the queue
+  accel_queue_gate(0);
+  accel_queue_wait_gated();
+  for (int i = 0; i < ACCEL_QUEUE_DEPTH; i++) {
+    ACCEL_TEST_ASSERT(accel_submit_op_async(&params, NULL) ==
+                      ACCEL_STATUS_OK);
+  }
+  ACCEL_TEST_ASSERT(accel_submit_op_async(&params, NULL) ==
+                    ACCEL_STATUS_BUSY);
+  ACCEL_TEST_ASSERT(accel_submit_op_wait(&params, NULL, 20) ==
+                    ACCEL_STATUS_TIMEOUT);
+
+  // A waiting submitter gets in once the dispatcher frees a slot
+  struct blocked_submit submit = {.params = params};
+  pthread_t thread;
+  pthread_create(&thread, NULL, submit_waiting, &submit);
+  usleep(20000);
+  ACCEL_TEST_ASSERT_EQUAL(0, submit.done);
+  accel_queue_gate(UINT32_MAX);
+  pthread_join(thread, NULL);
+  ACCEL_TEST_ASSERT(submit.status == ACCEL_STATUS_OK);
+  ACCEL_TEST_ASSERT(accel_wait_op(submit.handle, 1000) == ACCEL_STATUS_OK);
+
+  accel_free_buffer(input);
+  accel_free_buffer(output);
+  accel_cleanup();
+}
+
+static void test_queue_invalid_params(void) {
+  // Test before initialization
+  accel_op_params_t params = {.op_type = ACCEL_OP_MATMUL};
+  ACCEL_TEST_ASSERT(accel_submit_op_async(&params, NULL) ==
+                    ACCEL_STATUS_NOT_INITIALIZED);
+
+  accel_status_t status = accel_init("/dev/accelerator0");
+  ACCEL_TEST_ASSERT(status == ACCEL_STATUS_OK);
+
+  ACCEL_TEST_ASSERT(accel_submit_op_async(NULL, NULL) ==
+                    ACCEL_STATUS_INVALID_PARAM);
+
+  params.op_type = ACCEL_OP_NONE;
+  ACCEL_TEST_ASSERT(accel_submit_op_async(&params, NULL) ==
+                    ACCEL_STATUS_INVALID_PARAM);
+
+  params.op_type = ACCEL_OP_MATMUL;
+  params.priority = ACCEL_PRIORITY_LEVELS;
+  ACCEL_TEST_ASSERT(accel_submit_op_async(&params, NULL) ==
+                    ACCEL_STATUS_INVALID_PARAM);
+
+  ACCEL_TEST_ASSERT(accel_get_queue_stats(ACCEL_PRIORITY_HIGH, NULL) ==
+                    ACCEL_STATUS_INVALID_PARAM);
+
+  accel_cleanup();
+}
+
+int main(void) {
+  ACCEL_TEST_BEGIN();
+
+  ACCEL_TEST_RUN(test_async_submit_wait);
+  ACCEL_TEST_RUN(test_status_expiry);
+  ACCEL_TEST_RUN(test_config_high_priority);
+  ACCEL_TEST_RUN(test_preemption);
+  ACCEL_TEST_RUN(test_completion_callback);
+  ACCEL_TEST_RUN(test_submit_wait_for_room);
+  ACCEL_TEST_RUN(test_queue_invalid_params);
+
+  ACCEL_TEST_END();
+}
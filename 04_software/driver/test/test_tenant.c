@@ -0,0 +1,336 @@
+/**
+ * @file test_tenant.c
+ * @author Leo (zhsleo@outlook.com)
+ *
+ * @brief Unit tests for tenant quotas and fair-share scheduling
+ * @version 1.0.0
+ * @date 2026-10-18
+ */
+
+#include <pthread.h>
+#include <string.h>
+
+#include "accel.h"
+#include "accel_test.h"
+
+static void test_tenant_lifecycle(void) {
+  accel_status_t status = accel_init("/dev/accelerator0");
+  ACCEL_TEST_ASSERT(status == ACCEL_STATUS_OK);
+
+  accel_tenant_config_t config = {.weight = 1};
+  accel_tenant_t tenants[ACCEL_MAX_TENANTS];
+  for (int i = 1; i < ACCEL_MAX_TENANTS; i++) {
+    ACCEL_TEST_ASSERT(accel_tenant_create(&config, &tenants[i]) ==
+                      ACCEL_STATUS_OK);
+    ACCEL_TEST_ASSERT(tenants[i] != ACCEL_TENANT_DEFAULT);
+  }
+
+  // The default tenant takes one slot
+  accel_tenant_t extra;
+  ACCEL_TEST_ASSERT(accel_tenant_create(&config, &extra) == ACCEL_STATUS_BUSY);
+  ACCEL_TEST_ASSERT(accel_tenant_destroy(tenants[3]) == ACCEL_STATUS_OK);
+  ACCEL_TEST_ASSERT(accel_tenant_create(&config, &extra) == ACCEL_STATUS_OK);
+  ACCEL_TEST_ASSERT_EQUAL(tenants[3], extra);
+
+  ACCEL_TEST_ASSERT(accel_tenant_destroy(ACCEL_TENANT_DEFAULT) ==
+                    ACCEL_STATUS_INVALID_PARAM);
+  ACCEL_TEST_ASSERT(accel_tenant_destroy(ACCEL_MAX_TENANTS) ==
+                    ACCEL_STATUS_INVALID_PARAM);
+
+  config.weight = 0;
+  ACCEL_TEST_ASSERT(accel_tenant_configure(tenants[1], &config) ==
+                    ACCEL_STATUS_INVALID_PARAM);
+  config.weight = ACCEL_TENANT_MAX_WEIGHT + 1;
+  ACCEL_TEST_ASSERT(accel_tenant_configure(tenants[1], &config) ==
+                    ACCEL_STATUS_INVALID_PARAM);
+
+  accel_cleanup();
+}
+
+static void test_tenant_quota(void) {
+  accel_status_t status = accel_init("/dev/accelerator0");
+  ACCEL_TEST_ASSERT(status == ACCEL_STATUS_OK);
+
+  accel_tenant_config_t config = {.mem_quota = 8192, .weight = 1};
+  accel_tenant_t tenant;
+  ACCEL_TEST_ASSERT(accel_tenant_create(&config, &tenant) == ACCEL_STATUS_OK);
+
+  accel_buffer_t* first = accel_tenant_alloc_buffer(tenant, 4096);
+  accel_buffer_t* second = accel_tenant_alloc_buffer(tenant, 4096);
+  ACCEL_TEST_ASSERT_NOT_NULL(first);
+  ACCEL_TEST_ASSERT_NOT_NULL(second);
+  ACCEL_TEST_ASSERT_NULL(accel_tenant_alloc_buffer(tenant, 64));
+  ACCEL_TEST_ASSERT(strstr(accel_get_error(), "quota") != NULL);
+
+  // Other tenants are unaffected
+  accel_buffer_t* shared = accel_alloc_buffer(1024 * 1024);
+  ACCEL_TEST_ASSERT_NOT_NULL(shared);
+
+  accel_tenant_stats_t stats;
+  ACCEL_TEST_ASSERT(accel_get_tenant_stats(tenant, &stats) ==
+                    ACCEL_STATUS_OK);
+  ACCEL_TEST_ASSERT_EQUAL(8192, stats.mem_quota);
+  ACCEL_TEST_ASSERT_EQUAL(8192, stats.mem_used);
+  ACCEL_TEST_ASSERT_EQUAL(1, stats.alloc_denied);
+
+  // A tenant cannot go away while it owns memory
+  ACCEL_TEST_ASSERT(accel_tenant_destroy(tenant) == ACCEL_STATUS_BUSY);
+  accel_free_buffer(first);
+
+  // Raising the quota takes effect immediately
+  config.mem_quota = 16384;
+  ACCEL_TEST_ASSERT(accel_tenant_configure(tenant, &config) ==
+                    ACCEL_STATUS_OK);
+  first = accel_tenant_alloc_buffer(tenant, 12288);
+  ACCEL_TEST_ASSERT_NOT_NULL(first);
+  accel_get_tenant_stats(tenant, &stats);
+  ACCEL_TEST_ASSERT_EQUAL(16384, stats.mem_used);
+  ACCEL_TEST_ASSERT_EQUAL(16384, stats.mem_peak);
+
+  accel_free_buffer(first);
+  accel_free_buffer(second);
+  accel_get_tenant_stats(tenant, &stats);
+  ACCEL_TEST_ASSERT_EQUAL(0, stats.mem_used);
+  ACCEL_TEST_ASSERT(accel_tenant_destroy(tenant) == ACCEL_STATUS_OK);
+  ACCEL_TEST_ASSERT_NULL(accel_tenant_alloc_buffer(tenant, 64));
+
+  accel_free_buffer(shared);
+  accel_cleanup();
+}
+
+static accel_tenant_t light_tenant;
+static accel_tenant_stats_t light_at_heavy_done;
+
+// Runs on the dispatcher, before the light op can advance any further
+static void on_heavy_done(accel_op_handle_t handle, accel_status_t status,
+                          void* user_data) {
+  (void)handle;
+  (void)status;
+  (void)user_data;
+  accel_get_tenant_stats(light_tenant, &light_at_heavy_done);
+}
+
+struct churn_args {
+  accel_tenant_t tenant;
+  int allocated;
+};
+
+static void* churn_buffers(void* arg) {
+  struct churn_args* args = arg;
+  for (int i = 0; i < 20000; i++) {
+    accel_buffer_t* buffer = accel_tenant_alloc_buffer(args->tenant, 4096);
+    if (buffer) {
+      args->allocated++;
+      accel_free_buffer(buffer);
+    }
+  }
+  return NULL;
+}
+
+static void test_tenant_destroy_during_alloc(void) {
+  accel_status_t status = accel_init("/dev/accelerator0");
+  ACCEL_TEST_ASSERT(status == ACCEL_STATUS_OK);
+
+  accel_tenant_config_t config = {.mem_quota = 65536, .weight = 1};
+  accel_tenant_t tenant;
+  ACCEL_TEST_ASSERT(accel_tenant_create(&config, &tenant) == ACCEL_STATUS_OK);
+
+  // Destroy and re-create the tenant while another thread allocates on
+  // its id; the slot is reused, so allocations race both
+  struct churn_args args = {.tenant = tenant};
+  pthread_t thread;
+  pthread_create(&thread, NULL, churn_buffers, &args);
+  int recreated = 0;
+  int same_id = 1;
+  for (int i = 0; i < 20000; i++) {
+    if (accel_tenant_destroy(tenant) == ACCEL_STATUS_OK) {
+      accel_tenant_t again;
+      same_id &= accel_tenant_create(&config, &again) == ACCEL_STATUS_OK &&
+                 again == tenant;
+      recreated++;
+    }
+  }
+  pthread_join(thread, NULL);
+  ACCEL_TEST_ASSERT(same_id);
+  ACCEL_TEST_ASSERT(recreated > 0);
+
+  accel_tenant_stats_t stats;
+  ACCEL_TEST_ASSERT(accel_get_tenant_stats(tenant, &stats) ==
+                    ACCEL_STATUS_OK);
+  ACCEL_TEST_ASSERT_EQUAL(0, stats.mem_used);
+  ACCEL_TEST_ASSERT(accel_tenant_destroy(tenant) == ACCEL_STATUS_OK);
+
+  accel_cleanup();
+}
+
+static void test_tenant_fair_share(void) {
+  accel_status_t status = accel_init("/dev/accelerator0");
+  ACCEL_TEST_ASSERT(status == ACCEL_STATUS_OK);
+
+  // Small tiles so that the ops interleave at many tile boundaries
+  accel_config_t config = {.flags = ACCEL_CONFIG_ENABLE_DMA,
+                           .num_channels = 1,
+                           .max_transfer = 64,
+                           .timeout_ms = 1000};
+  ACCEL_TEST_ASSERT(accel_configure(&config) == ACCEL_STATUS_OK);
+
+  accel_tenant_config_t heavy_config = {.weight = 3};
+  accel_tenant_config_t light_config = {.weight = 1};
+  accel_tenant_t heavy, light;
+  accel_tenant_create(&heavy_config, &heavy);
+  accel_tenant_create(&light_config, &light);
+
+  const uint32_t size = 1024 * 1024;
+  accel_buffer_t* heavy_in = accel_tenant_alloc_buffer(heavy, size);
+  accel_buffer_t* heavy_out = accel_tenant_alloc_buffer(heavy, size);
+  accel_buffer_t* light_in = accel_tenant_alloc_buffer(light, size);
+  accel_buffer_t* light_out = accel_tenant_alloc_buffer(light, size);
+
+  accel_op_params_t light_op = {.op_type = ACCEL_OP_MATMUL,
+                                .input = *light_in,
+                                .output = *light_out,
+                                .tenant = light};
+  accel_op_params_t heavy_op = {.op_type = ACCEL_OP_MATMUL,
+                                .input = *heavy_in,
+                                .output = *heavy_out,
+                                .tenant = heavy};
+  // A high-priority op holds the device until both tenants have queued
+  accel_buffer_t* block_in = accel_alloc_buffer(4 * size);
+  accel_buffer_t* block_out = accel_alloc_buffer(4 * size);
+  accel_op_params_t block_op = {.op_type = ACCEL_OP_MATMUL,
+                                .input = *block_in,
+                                .output = *block_out,
+                                .priority = ACCEL_PRIORITY_HIGH};
+  ACCEL_TEST_ASSERT(accel_submit_op_async(&block_op, NULL) == ACCEL_STATUS_OK);
+
+  light_tenant = light;
+  accel_op_handle_t light_handle = 0;
+  accel_op_handle_t heavy_handle = 0;
+  ACCEL_TEST_ASSERT(accel_submit_op_async(&light_op, &light_handle) ==
+                    ACCEL_STATUS_OK);
+  ACCEL_TEST_ASSERT(accel_submit_op_notify(&heavy_op, on_heavy_done, NULL,
+                                           &heavy_handle) == ACCEL_STATUS_OK);
+
+  // The tenant with three times the weight processes about three times the
+  // bytes while both are busy, although it submitted second
+  ACCEL_TEST_ASSERT(accel_wait_op(light_handle, 0) == ACCEL_STATUS_OK);
+  ACCEL_TEST_ASSERT(accel_wait_op(heavy_handle, 0) == ACCEL_STATUS_OK);
+  ACCEL_TEST_ASSERT(light_at_heavy_done.bytes_processed > size / 4);
+  ACCEL_TEST_ASSERT(light_at_heavy_done.bytes_processed < size / 2);
+  ACCEL_TEST_ASSERT(light_at_heavy_done.throttled_tiles > 0);
+
+  accel_tenant_stats_t light_stats;
+  accel_get_tenant_stats(light, &light_stats);
+  ACCEL_TEST_ASSERT_EQUAL(size, light_stats.bytes_processed);
+  ACCEL_TEST_ASSERT_EQUAL(1, light_stats.submitted);
+  ACCEL_TEST_ASSERT_EQUAL(1, light_stats.completed);
+  ACCEL_TEST_ASSERT_EQUAL(0, light_stats.queued);
+  ACCEL_TEST_ASSERT(light_stats.max_latency_us > 0);
+
+  // Interleaving tenants of one level is not preemption
+  accel_queue_stats_t normal = {0};
+  accel_get_queue_stats(ACCEL_PRIORITY_NORMAL, &normal);
+  ACCEL_TEST_ASSERT_EQUAL(0, normal.preempted);
+
+  accel_free_buffer(block_in);
+  accel_free_buffer(block_out);
+  accel_free_buffer(heavy_in);
+  accel_free_buffer(heavy_out);
+  accel_free_buffer(light_in);
+  accel_free_buffer(light_out);
+  accel_cleanup();
+}
+
+static void test_tenant_queue_limit(void) {
+  accel_status_t status = accel_init("/dev/accelerator0");
+  ACCEL_TEST_ASSERT(status == ACCEL_STATUS_OK);
+
+  accel_config_t config = {.flags = ACCEL_CONFIG_ENABLE_DMA,
+                           .num_channels = 1,
+                           .max_transfer = 64,
+                           .timeout_ms = 1000};
+  ACCEL_TEST_ASSERT(accel_configure(&config) == ACCEL_STATUS_OK);
+
+  accel_tenant_config_t tenant_config = {.weight = 1, .max_queued = 1};
+  accel_tenant_t tenant;
+  accel_tenant_create(&tenant_config, &tenant);
+  accel_buffer_t* input = accel_tenant_alloc_buffer(tenant, 1024 * 1024);
+  accel_buffer_t* output = accel_tenant_alloc_buffer(tenant, 1024 * 1024);
+
+  accel_op_params_t params = {.op_type = ACCEL_OP_MATMUL,
+                              .input = *input,
+                              .output = *output,
+                              .tenant = tenant};
+  accel_op_handle_t handle = 0;
+  ACCEL_TEST_ASSERT(accel_submit_op_async(&params, &handle) ==
+                    ACCEL_STATUS_OK);
+  ACCEL_TEST_ASSERT(accel_submit_op_async(&params, NULL) == ACCEL_STATUS_BUSY);
+  ACCEL_TEST_ASSERT(accel_tenant_destroy(tenant) == ACCEL_STATUS_BUSY);
+
+  // The default tenant can still submit
+  accel_op_params_t other = params;
+  other.tenant = ACCEL_TENANT_DEFAULT;
+  other.input.size = 256;
+  ACCEL_TEST_ASSERT(accel_submit_op(&other) == ACCEL_STATUS_OK);
+  ACCEL_TEST_ASSERT(accel_wait_op(handle, 0) == ACCEL_STATUS_OK);
+
+  accel_tenant_stats_t stats;
+  accel_get_tenant_stats(tenant, &stats);
+  ACCEL_TEST_ASSERT_EQUAL(1, stats.submit_rejected);
+  ACCEL_TEST_ASSERT_EQUAL(1, stats.completed);
+
+  // Unknown tenants are rejected
+  params.tenant = tenant + 1;
+  ACCEL_TEST_ASSERT(accel_submit_op_async(&params, NULL) ==
+                    ACCEL_STATUS_INVALID_PARAM);
+  params.tenant = ACCEL_MAX_TENANTS;
+  ACCEL_TEST_ASSERT(accel_submit_op_async(&params, NULL) ==
+                    ACCEL_STATUS_INVALID_PARAM);
+
+  accel_free_buffer(input);
+  accel_free_buffer(output);
+  accel_cleanup();
+}
+
+static void test_tenant_invalid_params(void) {
+  // Test before initialization
+  accel_tenant_config_t config = {.weight = 1};
+  accel_tenant_t tenant;
+  accel_tenant_stats_t stats;
+  ACCEL_TEST_ASSERT(accel_tenant_create(&config, &tenant) ==
+                    ACCEL_STATUS_NOT_INITIALIZED);
+  ACCEL_TEST_ASSERT(accel_get_tenant_stats(0, &stats) ==
+                    ACCEL_STATUS_NOT_INITIALIZED);
+  ACCEL_TEST_ASSERT_NULL(accel_tenant_alloc_buffer(0, 64));
+
+  accel_status_t status = accel_init("/dev/accelerator0");
+  ACCEL_TEST_ASSERT(status == ACCEL_STATUS_OK);
+  ACCEL_TEST_ASSERT(accel_tenant_create(NULL, &tenant) ==
+                    ACCEL_STATUS_INVALID_PARAM);
+  ACCEL_TEST_ASSERT(accel_tenant_create(&config, NULL) ==
+                    ACCEL_STATUS_INVALID_PARAM);
+  ACCEL_TEST_ASSERT(accel_get_tenant_stats(0, NULL) ==
+                    ACCEL_STATUS_INVALID_PARAM);
+  ACCEL_TEST_ASSERT(accel_get_tenant_stats(5, &stats) ==
+                    ACCEL_STATUS_INVALID_PARAM);
+
+  // The default tenant exists and is unlimited
+  ACCEL_TEST_ASSERT(accel_get_tenant_stats(ACCEL_TENANT_DEFAULT, &stats) ==
+                    ACCEL_STATUS_OK);
+  ACCEL_TEST_ASSERT_EQUAL(0, stats.mem_quota);
+  ACCEL_TEST_ASSERT_EQUAL(1, stats.weight);
+  accel_cleanup();
+}
+
+int main(void) {
+  ACCEL_TEST_BEGIN();
+
+  ACCEL_TEST_RUN(test_tenant_lifecycle);
+  ACCEL_TEST_RUN(test_tenant_quota);
+  ACCEL_TEST_RUN(test_tenant_destroy_during_alloc);
+  ACCEL_TEST_RUN(test_tenant_fair_share);
+  ACCEL_TEST_RUN(test_tenant_queue_limit);
+  ACCEL_TEST_RUN(test_tenant_invalid_params);
+
+  ACCEL_TEST_END();
+}
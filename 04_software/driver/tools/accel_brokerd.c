@@ -0,0 +1,101 @@
+/**
+ * @file accel_brokerd.c
+ * @author Leo (zhsleo@outlook.com)
+ *
+ * @brief Broker daemon: owns the device and serves it to local processes
+ * @version 1.0.0
+ * @date 2026-10-18
+ */
+
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+#include "accel.h"
+#include "accel_broker.h"
+
+static void usage(const char* prog) {
+  fprintf(stderr,
+          "Usage: %s [-d device] [-s socket] [-w weight] [-q quota_bytes]\n"
+          "          [-n max_queued] [-p]\n"
+          "  -d  Device to own (default /dev/accelerator0)\n"
+          "  -s  Socket to listen on (default /tmp/accel_broker.sock)\n"
+          "  -w  Fair-share weight of every client (default 1)\n"
+          "  -q  Device memory quota of every client (default unlimited)\n"
+          "  -n  Queued op limit of every client (default unlimited)\n"
+          "  -p  Prefault device memory at startup\n",
+          prog);
+}
+
+int main(int argc, char** argv) {
+  const char* device = "/dev/accelerator0";
+  const char* socket_path = "/tmp/accel_broker.sock";
+  accel_broker_config_t config = {.tenant = {.weight = 1}};
+  uint32_t flags = 0;
+
+  int opt;
+  while ((opt = getopt(argc, argv, "d:s:w:q:n:ph")) != -1) {
+    switch (opt) {
+      case 'd':
+        device = optarg;
+        break;
+      case 's':
+        socket_path = optarg;
+        break;
+      case 'w':
+        config.tenant.weight = (uint32_t)strtoul(optarg, NULL, 0);
+        break;
+      case 'q':
+        config.tenant.mem_quota = strtoull(optarg, NULL, 0);
+        break;
+      case 'n':
+        config.tenant.max_queued = (uint32_t)strtoul(optarg, NULL, 0);
+        break;
+      case 'p':
+        flags |= ACCEL_INIT_PREFAULT;
+        break;
+      default:
+        usage(argv[0]);
+        return opt == 'h' ? 0 : 1;
+    }
+  }
+
+  // Signals are taken synchronously by sigwait() below
+  sigset_t signals;
+  sigemptyset(&signals);
+  sigaddset(&signals, SIGINT);
+  sigaddset(&signals, SIGTERM);
+  pthread_sigmask(SIG_BLOCK, &signals, NULL);
+
+  if (accel_init_flags(device, flags) != ACCEL_STATUS_OK) {
+    fprintf(stderr, "%s: %s\n", device, accel_get_error());
+    return 1;
+  }
+  accel_broker_t* broker = accel_broker_start(socket_path, &config);
+  if (!broker) {
+    fprintf(stderr, "%s\n", accel_get_error());
+    accel_cleanup();
+    return 1;
+  }
+  printf("Serving %s on %s\n", device, socket_path);
+
+  int sig;
+  sigwait(&signals, &sig);
+
+  accel_broker_stats_t stats;
+  accel_get_broker_stats(broker, &stats);
+  accel_broker_stop(broker);
+  accel_cleanup();
+
+  printf("Served %llu clients, %llu ops in %llu messages, "
+         "%llu queue submissions, %llu completion batches, "
+         "%llu bytes copied\n",
+         (unsigned long long)stats.connections,
+         (unsigned long long)stats.ops_submitted,
+         (unsigned long long)stats.messages_received,
+         (unsigned long long)stats.queue_submissions,
+         (unsigned long long)stats.completion_messages,
+         (unsigned long long)stats.bytes_copied);
+  return 0;
+}
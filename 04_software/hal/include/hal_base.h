@@ -24,6 +24,12 @@
 #define HAL_ACCEL_MEM_BASE 0x30000000
 #define HAL_ACCEL_MEM_SIZE (256 * 1024 * 1024)  // 256MB
 
+// Initialization flags
+#define HAL_INIT_CACHED (1 << 0)    // Cached mapping, needs explicit sync
+#define HAL_INIT_PREFAULT (1 << 1)  // Populate page tables at init
+#define HAL_INIT_HUGE_2M (1 << 2)   // Back mappings with 2MB pages
+#define HAL_INIT_HUGE_1G (1 << 3)   // Back mappings with 1GB pages
+
 /**
  * @brief HAL context structure
  */
@@ -34,12 +40,16 @@ struct hal_context {
   void* accel_memory_base;  /**< Base of mapped accelerator memory */
   size_t accel_memory_size; /**< Size of mapped accelerator memory */
   void* mem_ctx;            /**< Memory management context */
+  void* dma_ctx;            /**< AXI DMA controller model */
+  uint32_t flags;           /**< Initialization flags (HAL_INIT_*) */
+  size_t page_size;         /**< Page size backing accelerator memory */
 };
 
 typedef struct hal_context hal_context_t;
 
 // Base HAL operations
 hal_context_t* hal_init(const char* device_path);
+hal_context_t* hal_init_flags(const char* device_path, uint32_t flags);
 void hal_cleanup(hal_context_t* ctx);
 
 #endif /* HAL_BASE_H */
\ No newline at end of file
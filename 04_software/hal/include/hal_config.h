@@ -80,6 +80,10 @@ typedef struct __attribute__((packed)) {
 
 /**
  * @brief Configure the LSU unit
+ *
+ * The transfer is also run through the DMA controller model (hal_dma.h),
+ * which fails addresses beyond the 32-bit DMA address registers.
+ *
  * @param ctx HAL context
  * @param config LSU configuration
  * @return true if successful, false on error
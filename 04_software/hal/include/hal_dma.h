@@ -0,0 +1,203 @@
+/**
+ * @file hal_dma.h
+ * @author Leo (zhsleo@outlook.com)
+ *
+ * @brief Transaction-level model of the AXI DMA read/write controllers
+ * @version 1.0.0
+ * @date 2026-10-18
+ */
+
+#ifndef HAL_DMA_H
+#define HAL_DMA_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "hal_base.h"
+
+// DMA_LENGTH_CONFIG is 26 bits wide
+#define HAL_DMA_LENGTH_BITS 26
+#define HAL_DMA_MAX_LENGTH ((1u << HAL_DMA_LENGTH_BITS) - 1)
+
+// MM2S (axi_dma_read_ctrl) register map
+#define HAL_DMA_MM2S_IRQ_REG 0x00
+#define HAL_DMA_MM2S_IDLE_REG 0x04
+#define HAL_DMA_MM2S_CLEAR_REG 0x04
+#define HAL_DMA_MM2S_ADDR_REG 0x18
+#define HAL_DMA_MM2S_LENGTH_REG 0x28
+
+// S2MM (axi_dma_write_ctrl) register map
+#define HAL_DMA_S2MM_IRQ_REG 0x30
+#define HAL_DMA_S2MM_IDLE_REG 0x34
+#define HAL_DMA_S2MM_CLEAR_REG 0x34
+#define HAL_DMA_S2MM_ADDR_REG 0x48
+#define HAL_DMA_S2MM_LENGTH_REG 0x58
+
+// Register values written by both controllers
+#define HAL_DMA_IRQ_DATA 0x00011003
+#define HAL_DMA_CLEAR_DATA 0x00011001
+
+/**
+ * @brief DMA channels, one controller each
+ */
+typedef enum {
+  HAL_DMA_MM2S = 0, /**< Memory to stream, axi_dma_read_ctrl */
+  HAL_DMA_S2MM,     /**< Stream to memory, axi_dma_write_ctrl */
+  HAL_DMA_CHANNELS
+} hal_dma_channel_t;
+
+/**
+ * @brief Controller FSM states, as in the RTL
+ */
+typedef enum {
+  HAL_DMA_ST_IDLE = 0,
+  HAL_DMA_ST_CHECK_IDLE,  /**< AXI-Lite read of the idle register */
+  HAL_DMA_ST_CONTROL_DMA, /**< IRQ, address and length writes */
+  HAL_DMA_ST_WAITING_IRQ, /**< Data moves until the completion IRQ */
+  HAL_DMA_ST_CLEAR_IRQ,   /**< AXI-Lite write clearing the IRQ */
+} hal_dma_state_t;
+
+/**
+ * @brief Cycle costs of the model, in AXI clock cycles
+ *
+ * The defaults follow the controller RTL: an AXI-Lite access takes a start
+ * pulse, the address/data handshake, the response and the ready pulse, and
+ * each FSM transition costs a cycle. Slave latency, DMA start-up and IRQ
+ * latency depend on the interconnect and DMA IP and should be calibrated
+ * against the board.
+ */
+typedef struct {
+  uint32_t clock_mhz;           /**< AXI clock frequency */
+  uint32_t lite_read_cycles;    /**< AXI-Lite read, excluding slave latency */
+  uint32_t lite_write_cycles;   /**< AXI-Lite write, excluding slave latency */
+  uint32_t slave_latency;       /**< Added to every AXI-Lite access */
+  uint32_t state_cycles;        /**< Per FSM state transition */
+  uint32_t startup_cycles;      /**< Length write to first data beat */
+  uint32_t irq_cycles;          /**< Last data beat to IRQ seen by the FSM */
+  uint32_t bytes_per_cycle;     /**< Stream data width in bytes */
+} hal_dma_timing_t;
+
+/**
+ * @brief Per-channel model statistics
+ *
+ * Setup cycles are spent in CHECK_IDLE, CONTROL_DMA and CLEAR_IRQ, plus
+ * DMA start-up and IRQ latency; data cycles move the payload. Their ratio
+ * is the per-transfer overhead that coalescing amortizes.
+ */
+typedef struct {
+  uint64_t requests;      /**< hal_dma_transfer() calls */
+  uint64_t transfers;     /**< Register sequences, after 26-bit splitting */
+  uint64_t split;         /**< Requests longer than HAL_DMA_MAX_LENGTH */
+  uint64_t bytes;         /**< Payload bytes */
+  uint64_t lite_reads;    /**< AXI-Lite read transactions */
+  uint64_t lite_writes;   /**< AXI-Lite write transactions */
+  uint64_t setup_cycles;  /**< Control overhead cycles */
+  uint64_t data_cycles;   /**< Payload cycles */
+} hal_dma_stats_t;
+
+/**
+ * @brief AXI-Lite transaction observer
+ * @param channel Issuing controller
+ * @param write true for a register write, false for a read
+ * @param reg Register offset
+ * @param data Written or returned value
+ * @param user_data Pointer passed to hal_dma_set_trace()
+ */
+typedef void (*hal_dma_trace_fn)(hal_dma_channel_t channel, bool write,
+                                 uint32_t reg, uint32_t data,
+                                 void* user_data);
+
+/**
+ * @brief Initialize the DMA model of a context with default timing
+ * @param ctx HAL context
+ * @return true if successful
+ */
+bool hal_dma_init(hal_context_t* ctx);
+
+/**
+ * @brief Free the DMA model of a context
+ * @param ctx HAL context
+ */
+void hal_dma_cleanup(hal_context_t* ctx);
+
+/**
+ * @brief Get the default timing
+ * @param timing Pointer to store the timing
+ */
+void hal_dma_default_timing(hal_dma_timing_t* timing);
+
+/**
+ * @brief Replace the timing of the model
+ * @param ctx HAL context
+ * @param timing New timing; clock_mhz and bytes_per_cycle must be non-zero
+ * @return true if successful
+ */
+bool hal_dma_set_timing(hal_context_t* ctx, const hal_dma_timing_t* timing);
+
+/**
+ * @brief Get the timing of the model
+ * @param ctx HAL context
+ * @param timing Pointer to store the timing
+ * @return true if successful
+ */
+bool hal_dma_get_timing(hal_context_t* ctx, hal_dma_timing_t* timing);
+
+/**
+ * @brief Install an AXI-Lite transaction observer
+ * @param ctx HAL context
+ * @param fn Observer, NULL to remove
+ * @param user_data Pointer handed back to the observer
+ */
+void hal_dma_set_trace(hal_context_t* ctx, hal_dma_trace_fn fn,
+                       void* user_data);
+
+/**
+ * @brief Run one DMA request through a controller
+ *
+ * Requests longer than HAL_DMA_MAX_LENGTH are issued as several transfers,
+ * each running the full CHECK_IDLE -> CONTROL_DMA -> WAITING_IRQ ->
+ * CLEAR_IRQ sequence.
+ *
+ * @param ctx HAL context
+ * @param channel Controller
+ * @param addr Source (MM2S) or destination (S2MM) address
+ * @param length Length in bytes
+ * @return Cycles consumed, 0 on error
+ */
+uint64_t hal_dma_transfer(hal_context_t* ctx, hal_dma_channel_t channel,
+                          uint64_t addr, uint64_t length);
+
+/**
+ * @brief Get the current FSM state of a controller
+ * @param ctx HAL context
+ * @param channel Controller
+ * @return State, HAL_DMA_ST_IDLE between requests
+ */
+hal_dma_state_t hal_dma_get_state(hal_context_t* ctx,
+                                  hal_dma_channel_t channel);
+
+/**
+ * @brief Get the statistics of a channel
+ * @param ctx HAL context
+ * @param channel Controller
+ * @param stats Pointer to store statistics
+ * @return true if successful
+ */
+bool hal_dma_get_stats(hal_context_t* ctx, hal_dma_channel_t channel,
+                       hal_dma_stats_t* stats);
+
+/**
+ * @brief Reset the statistics of both channels
+ * @param ctx HAL context
+ */
+void hal_dma_reset_stats(hal_context_t* ctx);
+
+/**
+ * @brief Convert cycles to nanoseconds at the model clock
+ * @param ctx HAL context
+ * @param cycles Cycle count
+ * @return Nanoseconds
+ */
+uint64_t hal_dma_cycles_to_ns(hal_context_t* ctx, uint64_t cycles);
+
+#endif /* HAL_DMA_H */
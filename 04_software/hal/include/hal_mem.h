@@ -18,6 +18,9 @@
 // Memory alignment requirement
 #define HAL_MEM_ALIGN 64  // 64-byte alignment
 
+// Cache line size used for cache maintenance
+#define HAL_CACHE_LINE 64
+
 /**
  * @brief Initialize memory management subsystem
  * @param ctx HAL context
@@ -41,6 +44,33 @@ void hal_mem_cleanup(hal_context_t* ctx);
  */
 void* hal_mem_alloc(hal_context_t* ctx, size_t size);
 
+/**
+ * @brief Usage limit shared by a group of allocations
+ *
+ * Every block allocated against a quota remembers it, so hal_mem_free()
+ * credits the quota again.
+ */
+typedef struct {
+  size_t limit;    /**< Maximum allocated bytes, 0 for unlimited */
+  size_t used;     /**< Bytes currently allocated */
+  size_t peak;     /**< Highest value of used */
+  uint64_t denied; /**< Allocations refused because of the limit */
+} hal_mem_quota_t;
+
+/**
+ * @brief Allocate memory charged to a quota
+ *
+ * Fails without touching the free list if the aligned size would exceed
+ * the quota's limit.
+ *
+ * @param ctx HAL context
+ * @param size Size of memory to allocate
+ * @param quota Quota to charge (NULL for none)
+ * @return Virtual address of allocated memory, or NULL on failure
+ */
+void* hal_mem_alloc_quota(hal_context_t* ctx, size_t size,
+                          hal_mem_quota_t* quota);
+
 /**
  * @brief Free previously allocated accelerator memory
  * @param ctx HAL context
@@ -63,4 +93,80 @@ uint64_t hal_virt_to_phys(hal_context_t* ctx, void* vaddr);
  */
 size_t hal_mem_available(hal_context_t* ctx);
 
+/**
+ * @brief Free-space statistics of the accelerator memory region
+ */
+typedef struct {
+  size_t total_free;   /**< Sum of all free blocks */
+  size_t largest_free; /**< Largest single free block */
+  size_t free_blocks;  /**< Number of free blocks */
+  size_t used_blocks;  /**< Number of allocated blocks */
+} hal_mem_stats_t;
+
+/**
+ * @brief Relocation callback used by hal_mem_compact()
+ *
+ * Called before an allocated block is moved. The owner patches its
+ * references to the block and returns true, or returns false to keep the
+ * block in place (e.g. because it is pinned).
+ *
+ * @param user_data Pointer passed to hal_mem_compact()
+ * @param old_addr Current address of the block
+ * @param new_addr Address the block will be moved to
+ * @param size Size of the block
+ * @return true to move the block
+ */
+typedef bool (*hal_mem_relocate_fn)(void* user_data, void* old_addr,
+                                    void* new_addr, size_t size);
+
+/**
+ * @brief Get free-space statistics
+ * @param ctx HAL context
+ * @param stats Pointer to store statistics
+ * @return true if successful, false on error
+ */
+bool hal_mem_get_stats(hal_context_t* ctx, hal_mem_stats_t* stats);
+
+/**
+ * @brief Compact allocated blocks towards the start of the region
+ *
+ * Blocks are moved with a device-to-device copy in address order, so the
+ * free space of every gap between movable blocks ends up in one block.
+ * Blocks the relocation callback refuses stay where they are. The caller
+ * must ensure nothing accesses a block while it is moved.
+ *
+ * @param ctx HAL context
+ * @param relocate Relocation callback
+ * @param user_data Pointer handed to the callback
+ * @return Number of bytes moved
+ */
+size_t hal_mem_compact(hal_context_t* ctx, hal_mem_relocate_fn relocate,
+                       void* user_data);
+
+/**
+ * @brief Make host writes to a range visible to the device
+ *
+ * With a cached mapping (HAL_INIT_CACHED) the covered cache lines are
+ * written back; otherwise only a memory barrier is issued.
+ *
+ * @param ctx HAL context
+ * @param vaddr Start of range inside accelerator memory
+ * @param size Size of range in bytes
+ * @return true if successful, false if the range is invalid
+ */
+bool hal_mem_sync_for_device(hal_context_t* ctx, void* vaddr, size_t size);
+
+/**
+ * @brief Make device writes to a range visible to the host
+ *
+ * With a cached mapping (HAL_INIT_CACHED) the covered cache lines are
+ * invalidated; otherwise only a memory barrier is issued.
+ *
+ * @param ctx HAL context
+ * @param vaddr Start of range inside accelerator memory
+ * @param size Size of range in bytes
+ * @return true if successful, false if the range is invalid
+ */
+bool hal_mem_sync_for_cpu(hal_context_t* ctx, void* vaddr, size_t size);
+
 #endif /* HAL_MEM_H */
\ No newline at end of file
@@ -0,0 +1,57 @@
+/**
+ * @file hal_page.h
+ * @author Leo (zhsleo@outlook.com)
+ *
+ * @brief Page size and prefault policy for HAL memory mappings
+ * @version 1.0.0
+ * @date 2026-10-18
+ */
+
+#ifndef HAL_PAGE_H
+#define HAL_PAGE_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <sys/types.h>
+
+#define HAL_PAGE_2M (2UL << 20)
+#define HAL_PAGE_1G (1UL << 30)
+
+/**
+ * @brief Map memory with the page policy of HAL_INIT_* flags
+ *
+ * HAL_INIT_HUGE_1G and HAL_INIT_HUGE_2M first try explicit huge pages
+ * (MAP_HUGETLB). 1GB pages are only tried when size and offset are 1GB
+ * multiples and otherwise fall back to 2MB. If no huge pages are reserved,
+ * or the file does not support them, the region is mapped with base pages
+ * aligned to the huge page size and marked for transparent huge pages.
+ *
+ * HAL_INIT_PREFAULT populates the page tables before returning, so the
+ * first access to each page does not fault.
+ *
+ * @param fd File to map shared, or -1 for private anonymous memory
+ * @param offset Offset into the file
+ * @param size Mapping size in bytes
+ * @param flags HAL_INIT_* flags
+ * @param page_size Receives the page size backing the mapping (may be NULL)
+ * @return Mapped address, NULL on error
+ */
+void* hal_page_map(int fd, off_t offset, size_t size, uint32_t flags,
+                   size_t* page_size);
+
+/**
+ * @brief Unmap memory mapped with hal_page_map()
+ * @param addr Mapped address
+ * @param size Size passed to hal_page_map()
+ * @param page_size Page size reported by hal_page_map()
+ */
+void hal_page_unmap(void* addr, size_t size, size_t page_size);
+
+/**
+ * @brief Populate page tables of a mapped range
+ * @param addr Start of range
+ * @param size Size of range in bytes
+ */
+void hal_page_prefault(void* addr, size_t size);
+
+#endif /* HAL_PAGE_H */
@@ -14,16 +14,33 @@
 #include <sys/mman.h>
 #include <unistd.h>
 
+#include "hal_dma.h"
 #include "hal_mem.h"
+#include "hal_page.h"
 
 hal_context_t* hal_init(const char* device_path) {
+  return hal_init_flags(device_path, 0);
+}
+
+hal_context_t* hal_init_flags(const char* device_path, uint32_t flags) {
+  if (!device_path) {
+    return NULL;
+  }
+
   hal_context_t* ctx = (hal_context_t*)malloc(sizeof(hal_context_t));
   if (!ctx) {
     return NULL;
   }
+  ctx->flags = flags;
+  ctx->dma_ctx = NULL;
 
-  // Open device file
-  ctx->fd = open(device_path, O_RDWR);
+  // Open device file; O_SYNC requests an uncached mapping unless the
+  // caller takes over cache maintenance
+  int open_flags = O_RDWR;
+  if (!(flags & HAL_INIT_CACHED)) {
+    open_flags |= O_SYNC;
+  }
+  ctx->fd = open(device_path, open_flags);
   if (ctx->fd < 0) {
     free(ctx);
     return NULL;
@@ -38,11 +55,12 @@ hal_context_t* hal_init(const char* device_path) {
     return NULL;
   }
 
-  // Map accelerator memory region
-  ctx->accel_memory_base =
-      mmap(NULL, HAL_ACCEL_MEM_SIZE, PROT_READ | PROT_WRITE, MAP_SHARED,
-           ctx->fd, HAL_ACCEL_MEM_BASE);
-  if (ctx->accel_memory_base == MAP_FAILED) {
+  // Map accelerator memory region, with huge pages and prefaulting if
+  // requested
+  ctx->accel_memory_base = hal_page_map(ctx->fd, HAL_ACCEL_MEM_BASE,
+                                        HAL_ACCEL_MEM_SIZE, flags,
+                                        &ctx->page_size);
+  if (!ctx->accel_memory_base) {
     munmap(ctx->mapped_memory, getpagesize());
     close(ctx->fd);
     free(ctx);
@@ -54,7 +72,19 @@ hal_context_t* hal_init(const char* device_path) {
 
   // Initialize memory management
   if (!hal_mem_init(ctx, ctx->accel_memory_base, ctx->accel_memory_size)) {
-    munmap(ctx->accel_memory_base, ctx->accel_memory_size);
+    hal_page_unmap(ctx->accel_memory_base, ctx->accel_memory_size,
+                   ctx->page_size);
+    munmap(ctx->mapped_memory, getpagesize());
+    close(ctx->fd);
+    free(ctx);
+    return NULL;
+  }
+
+  // Model of the DMA controllers behind LSU transfers
+  if (!hal_dma_init(ctx)) {
+    hal_mem_cleanup(ctx);
+    hal_page_unmap(ctx->accel_memory_base, ctx->accel_memory_size,
+                   ctx->page_size);
     munmap(ctx->mapped_memory, getpagesize());
     close(ctx->fd);
     free(ctx);
@@ -66,12 +96,14 @@ hal_context_t* hal_init(const char* device_path) {
 
 void hal_cleanup(hal_context_t* ctx) {
   if (ctx) {
+    hal_dma_cleanup(ctx);
     hal_mem_cleanup(ctx);
     if (ctx->mapped_memory) {
       munmap(ctx->mapped_memory, getpagesize());
     }
     if (ctx->accel_memory_base) {
-      munmap(ctx->accel_memory_base, ctx->accel_memory_size);
+      hal_page_unmap(ctx->accel_memory_base, ctx->accel_memory_size,
+                     ctx->page_size);
     }
     if (ctx->fd >= 0) {
       close(ctx->fd);
@@ -13,6 +13,7 @@
 #include <sys/mman.h>
 
 #include "hal_base.h"
+#include "hal_dma.h"
 #include "hal_io.h"  // For hal_wait_for_ready
 
 /**
@@ -52,7 +53,19 @@ static bool write_config(hal_context_t* ctx, const void* config) {
 bool hal_configure_lsu(hal_context_t* ctx, const hal_lsu_config_t* config) {
   hal_controller_ir_t ir = {0};
   memcpy(&ir.ir_data.lsu, config, sizeof(hal_lsu_config_t));
-  return write_config(ctx, &ir);
+  if (!write_config(ctx, &ir)) {
+    return false;
+  }
+
+  /* The LSU streams the source in over MM2S and the result out over S2MM */
+  if (config->length > 0 &&
+      (!hal_dma_transfer(ctx, HAL_DMA_MM2S, config->src_addr,
+                         config->length) ||
+       !hal_dma_transfer(ctx, HAL_DMA_S2MM, config->dst_addr,
+                         config->length))) {
+    return false;
+  }
+  return true;
 }
 
 /**
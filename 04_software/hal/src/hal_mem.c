@@ -19,6 +19,7 @@ struct mem_block {
   void* addr;             /**< Virtual address of block */
   size_t size;            /**< Size of block */
   bool used;              /**< Whether block is in use */
+  hal_mem_quota_t* quota; /**< Quota charged for the block (may be NULL) */
   struct mem_block* next; /**< Next block in list */
 };
 
@@ -55,6 +56,7 @@ bool hal_mem_init(hal_context_t* ctx, void* base, size_t size) {
   block->addr = base;
   block->size = size;
   block->used = false;
+  block->quota = NULL;
   block->next = NULL;
 
   mem_ctx->base_addr = base;
@@ -84,6 +86,11 @@ void hal_mem_cleanup(hal_context_t* ctx) {
 }
 
 void* hal_mem_alloc(hal_context_t* ctx, size_t size) {
+  return hal_mem_alloc_quota(ctx, size, NULL);
+}
+
+void* hal_mem_alloc_quota(hal_context_t* ctx, size_t size,
+                          hal_mem_quota_t* quota) {
   if (!ctx || !ctx->mem_ctx || size == 0) {
     return NULL;
   }
@@ -110,8 +117,17 @@ void* hal_mem_alloc(hal_context_t* ctx, size_t size) {
     return NULL;
   }
 
+  // Charge what the block will actually hold
+  bool split = best_fit->size > size + sizeof(struct mem_block) + HAL_MEM_ALIGN;
+  size_t charge = split ? size : best_fit->size;
+  if (quota && quota->limit &&
+      (quota->used > quota->limit || charge > quota->limit - quota->used)) {
+    quota->denied++;
+    return NULL;
+  }
+
   // Split block if it's significantly larger
-  if (best_fit->size > size + sizeof(struct mem_block) + HAL_MEM_ALIGN) {
+  if (split) {
     struct mem_block* new_block = malloc(sizeof(struct mem_block));
     if (!new_block) {
       return NULL;
@@ -120,6 +136,7 @@ void* hal_mem_alloc(hal_context_t* ctx, size_t size) {
     new_block->addr = (char*)best_fit->addr + size;
     new_block->size = best_fit->size - size;
     new_block->used = false;
+    new_block->quota = NULL;
     new_block->next = best_fit->next;
 
     best_fit->size = size;
@@ -127,6 +144,13 @@ void* hal_mem_alloc(hal_context_t* ctx, size_t size) {
   }
 
   best_fit->used = true;
+  best_fit->quota = quota;
+  if (quota) {
+    quota->used += best_fit->size;
+    if (quota->used > quota->peak) {
+      quota->peak = quota->used;
+    }
+  }
   return best_fit->addr;
 }
 
@@ -150,6 +174,10 @@ void hal_mem_free(hal_context_t* ctx, void* ptr) {
   }
 
   block->used = false;
+  if (block->quota) {
+    block->quota->used -= block->size;
+    block->quota = NULL;
+  }
 
   // Merge with next block if it's free
   while (block->next && !block->next->used) {
@@ -198,4 +226,176 @@ size_t hal_mem_available(hal_context_t* ctx) {
   }
 
   return available;
-}
\ No newline at end of file
+}
+
+bool hal_mem_get_stats(hal_context_t* ctx, hal_mem_stats_t* stats) {
+  if (!ctx || !ctx->mem_ctx || !stats) {
+    return false;
+  }
+
+  struct hal_mem_context* mem_ctx = ctx->mem_ctx;
+  memset(stats, 0, sizeof(*stats));
+  for (struct mem_block* block = mem_ctx->blocks; block; block = block->next) {
+    if (block->used) {
+      stats->used_blocks++;
+      continue;
+    }
+    stats->free_blocks++;
+    stats->total_free += block->size;
+    if (block->size > stats->largest_free) {
+      stats->largest_free = block->size;
+    }
+  }
+  return true;
+}
+
+size_t hal_mem_compact(hal_context_t* ctx, hal_mem_relocate_fn relocate,
+                       void* user_data) {
+  if (!ctx || !ctx->mem_ctx || !relocate) {
+    return 0;
+  }
+
+  struct hal_mem_context* mem_ctx = ctx->mem_ctx;
+  struct mem_block* spare = NULL;  // Free block nodes for reuse
+  struct mem_block* head = NULL;
+  struct mem_block** link = &head;
+  uint8_t* cursor = mem_ctx->base_addr;
+  size_t moved = 0;
+
+  struct mem_block* block = mem_ctx->blocks;
+  while (block) {
+    struct mem_block* next = block->next;
+    if (!block->used) {
+      block->next = spare;
+      spare = block;
+      block = next;
+      continue;
+    }
+
+    // Everything between the cursor and this block is free
+    if ((uint8_t*)block->addr > cursor &&
+        relocate(user_data, block->addr, cursor, block->size)) {
+      memmove(cursor, block->addr, block->size);
+      block->addr = cursor;
+      moved += block->size;
+      if (ctx->flags & HAL_INIT_CACHED) {
+        hal_mem_sync_for_device(ctx, cursor, block->size);
+      }
+    }
+
+    // A block that stayed put leaves a gap behind it. Every gap covers at
+    // least one former free block, so a spare node is available
+    if ((uint8_t*)block->addr > cursor) {
+      struct mem_block* gap = spare;
+      spare = spare->next;
+      gap->addr = cursor;
+      gap->size = (uint8_t*)block->addr - cursor;
+      *link = gap;
+      link = &gap->next;
+    }
+
+    *link = block;
+    link = &block->next;
+    cursor = (uint8_t*)block->addr + block->size;
+    block = next;
+  }
+
+  uint8_t* end = (uint8_t*)mem_ctx->base_addr + mem_ctx->total_size;
+  if (cursor < end) {
+    struct mem_block* tail = spare;
+    spare = spare->next;
+    tail->addr = cursor;
+    tail->size = end - cursor;
+    *link = tail;
+    link = &tail->next;
+  }
+  *link = NULL;
+
+  while (spare) {
+    struct mem_block* next = spare->next;
+    free(spare);
+    spare = next;
+  }
+
+  mem_ctx->blocks = head;
+  return moved;
+}
+
+/**
+ * @brief Check that a range lies inside accelerator memory
+ * @param ctx HAL context
+ * @param vaddr Start of range
+ * @param size Size of range
+ * @return true if the whole range is mapped
+ */
+static bool range_valid(hal_context_t* ctx, void* vaddr, size_t size) {
+  if (!ctx || !ctx->mem_ctx || !vaddr || size == 0) {
+    return false;
+  }
+
+  struct hal_mem_context* mem_ctx = ctx->mem_ctx;
+  uint8_t* start = vaddr;
+  uint8_t* base = mem_ctx->base_addr;
+  return start >= base && size <= mem_ctx->total_size &&
+         (size_t)(start - base) <= mem_ctx->total_size - size;
+}
+
+/**
+ * @brief Apply cache maintenance to every line of a range
+ * @param vaddr Start of range
+ * @param size Size of range
+ * @param invalidate Whether lines are also invalidated
+ */
+static void cache_maintain(void* vaddr, size_t size, bool invalidate) {
+  uintptr_t line = (uintptr_t)vaddr & ~(uintptr_t)(HAL_CACHE_LINE - 1);
+  uintptr_t end = (uintptr_t)vaddr + size;
+
+#if defined(__x86_64__) || defined(__i386__)
+  // clflush both writes back and invalidates
+  (void)invalidate;
+  for (; line < end; line += HAL_CACHE_LINE) {
+    __builtin_ia32_clflush((const void*)line);
+  }
+  __builtin_ia32_mfence();
+#elif defined(__aarch64__)
+  for (; line < end; line += HAL_CACHE_LINE) {
+    if (invalidate) {
+      __asm__ volatile("dc civac, %0" : : "r"(line) : "memory");
+    } else {
+      __asm__ volatile("dc cvac, %0" : : "r"(line) : "memory");
+    }
+  }
+  __asm__ volatile("dsb sy" : : : "memory");
+#else
+  (void)line;
+  (void)end;
+  (void)invalidate;
+  __atomic_thread_fence(__ATOMIC_SEQ_CST);
+#endif
+}
+
+bool hal_mem_sync_for_device(hal_context_t* ctx, void* vaddr, size_t size) {
+  if (!range_valid(ctx, vaddr, size)) {
+    return false;
+  }
+
+  if (ctx->flags & HAL_INIT_CACHED) {
+    cache_maintain(vaddr, size, false);
+  } else {
+    __atomic_thread_fence(__ATOMIC_SEQ_CST);
+  }
+  return true;
+}
+
+bool hal_mem_sync_for_cpu(hal_context_t* ctx, void* vaddr, size_t size) {
+  if (!range_valid(ctx, vaddr, size)) {
+    return false;
+  }
+
+  if (ctx->flags & HAL_INIT_CACHED) {
+    cache_maintain(vaddr, size, true);
+  } else {
+    __atomic_thread_fence(__ATOMIC_SEQ_CST);
+  }
+  return true;
+}
@@ -0,0 +1,148 @@
+/**
+ * @file hal_page.c
+ * @author Leo (zhsleo@outlook.com)
+ *
+ * @brief Huge page and prefault support for HAL memory mappings
+ * @version 1.0.0
+ * @date 2026-10-18
+ */
+
+#include "hal_page.h"
+
+#include <stdbool.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+#include "hal_base.h"
+
+#ifndef MAP_HUGE_SHIFT
+#define MAP_HUGE_SHIFT 26
+#endif
+
+static size_t round_up(size_t value, size_t align) {
+  return (value + align - 1) / align * align;
+}
+
+static int share_flags(int fd) {
+  return fd < 0 ? MAP_PRIVATE | MAP_ANONYMOUS : MAP_SHARED;
+}
+
+// Explicit huge pages from the hugetlb pool
+static void* map_hugetlb(int fd, off_t offset, size_t size, size_t page,
+                         bool prefault) {
+  int shift = page == HAL_PAGE_1G ? 30 : 21;
+  int map_flags = share_flags(fd) | MAP_HUGETLB | (shift << MAP_HUGE_SHIFT);
+  if (prefault) {
+    map_flags |= MAP_POPULATE;
+  }
+  void* addr =
+      mmap(NULL, size, PROT_READ | PROT_WRITE, map_flags, fd, offset);
+  return addr == MAP_FAILED ? NULL : addr;
+}
+
+// Base pages at an address aligned for transparent huge pages
+static void* map_aligned(int fd, off_t offset, size_t size, size_t align) {
+  size_t span = size + align;
+  char* reserve = mmap(NULL, span, PROT_NONE,
+                       MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+  if (reserve == MAP_FAILED) {
+    return NULL;
+  }
+
+  char* addr = (char*)round_up((uintptr_t)reserve, align);
+  if (mmap(addr, size, PROT_READ | PROT_WRITE, share_flags(fd) | MAP_FIXED,
+           fd, offset) == MAP_FAILED) {
+    munmap(reserve, span);
+    return NULL;
+  }
+
+  // Return the unused ends of the reservation
+  if (addr > reserve) {
+    munmap(reserve, addr - reserve);
+  }
+  if (reserve + span > addr + size) {
+    munmap(addr + size, reserve + span - (addr + size));
+  }
+
+  madvise(addr, size, MADV_HUGEPAGE);  // Best effort, THP may be disabled
+  return addr;
+}
+
+void* hal_page_map(int fd, off_t offset, size_t size, uint32_t flags,
+                   size_t* page_size) {
+  if (size == 0) {
+    return NULL;
+  }
+
+  size_t base = getpagesize();
+  size = round_up(size, base);
+  bool prefault = flags & HAL_INIT_PREFAULT;
+
+  // Largest requested huge page the range can use: it must hold at least
+  // one page, and file ranges must be aligned to it (anonymous memory is
+  // rounded up)
+  size_t huge = 0;
+  if (flags & HAL_INIT_HUGE_1G) {
+    huge = HAL_PAGE_1G;
+  } else if (flags & HAL_INIT_HUGE_2M) {
+    huge = HAL_PAGE_2M;
+  }
+  while (huge && (size < huge ||
+                  (fd >= 0 && (size % huge || offset % (off_t)huge)))) {
+    huge = huge == HAL_PAGE_1G ? HAL_PAGE_2M : 0;
+  }
+
+  void* addr = NULL;
+  size_t actual = base;
+  if (huge) {
+    addr = map_hugetlb(fd, offset, round_up(size, huge), huge, prefault);
+    if (addr) {
+      actual = huge;
+    } else {
+      addr = map_aligned(fd, offset, size, huge);
+      if (addr && prefault) {
+        hal_page_prefault(addr, size);
+      }
+    }
+  } else {
+    // MAP_POPULATE read-faults shared file pages, leaving them write
+    // protected, so those are prefaulted for writing after mapping
+    bool populate = prefault && fd < 0;
+    int map_flags = share_flags(fd) | (populate ? MAP_POPULATE : 0);
+    addr = mmap(NULL, size, PROT_READ | PROT_WRITE, map_flags, fd, offset);
+    if (addr == MAP_FAILED) {
+      addr = NULL;
+    } else if (prefault && !populate) {
+      hal_page_prefault(addr, size);
+    }
+  }
+
+  if (addr && page_size) {
+    *page_size = actual;
+  }
+  return addr;
+}
+
+void hal_page_unmap(void* addr, size_t size, size_t page_size) {
+  if (!addr) {
+    return;
+  }
+  if (page_size == 0) {
+    page_size = getpagesize();
+  }
+  munmap(addr, round_up(size, page_size));
+}
+
+void hal_page_prefault(void* addr, size_t size) {
+#ifdef MADV_POPULATE_WRITE
+  if (madvise(addr, size, MADV_POPULATE_WRITE) == 0) {
+    return;
+  }
+#endif
+  // Write-fault every page without changing its contents
+  size_t page = getpagesize();
+  volatile char* bytes = addr;
+  for (size_t i = 0; i < size; i += page) {
+    bytes[i] = bytes[i];
+  }
+}
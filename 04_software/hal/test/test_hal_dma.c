@@ -0,0 +1,211 @@
+/**
+ * @file test_hal_dma.c
+ * @author Leo (zhsleo@outlook.com)
+ *
+ * @brief Unit tests for the AXI DMA controller model
+ * @version 1.0.0
+ * @date 2026-10-18
+ */
+
+#include "hal_base.h"
+#include "hal_config.h"
+#include "hal_dma.h"
+#include "hal_test.h"
+
+#define MAX_TRACE 32
+
+/**
+ * @brief Recorded AXI-Lite transaction
+ */
+struct trace_entry {
+  hal_dma_channel_t channel;
+  bool write;
+  uint32_t reg;
+  uint32_t data;
+  hal_dma_state_t state;
+};
+
+struct trace_log {
+  hal_context_t* ctx;
+  struct trace_entry entries[MAX_TRACE];
+  int count;
+};
+
+static void record(hal_dma_channel_t channel, bool write, uint32_t reg,
+                   uint32_t data, void* user_data) {
+  struct trace_log* log = user_data;
+  if (log->count < MAX_TRACE) {
+    struct trace_entry* e = &log->entries[log->count++];
+    e->channel = channel;
+    e->write = write;
+    e->reg = reg;
+    e->data = data;
+    e->state = hal_dma_get_state(log->ctx, channel);
+  }
+}
+
+/**
+ * @brief Test the register sequence of both controllers
+ */
+static void test_hal_dma_sequence(void) {
+  hal_context_t* ctx = hal_init("/dev/accelerator0");
+  HAL_TEST_ASSERT_NOT_NULL(ctx);
+
+  struct trace_log log = {.ctx = ctx};
+  hal_dma_set_trace(ctx, record, &log);
+
+  // CHECK_IDLE read, IRQ/SA/LENGTH writes, CLEAR_IRQ write
+  HAL_TEST_ASSERT(hal_dma_transfer(ctx, HAL_DMA_MM2S, 0x30001000, 256) > 0);
+  HAL_TEST_ASSERT_EQUAL(5, log.count);
+  HAL_TEST_ASSERT(!log.entries[0].write);
+  HAL_TEST_ASSERT_EQUAL(HAL_DMA_MM2S_IDLE_REG, log.entries[0].reg);
+  HAL_TEST_ASSERT_EQUAL(HAL_DMA_ST_CHECK_IDLE, log.entries[0].state);
+  HAL_TEST_ASSERT_EQUAL(HAL_DMA_MM2S_IRQ_REG, log.entries[1].reg);
+  HAL_TEST_ASSERT_EQUAL(HAL_DMA_IRQ_DATA, log.entries[1].data);
+  HAL_TEST_ASSERT_EQUAL(HAL_DMA_ST_CONTROL_DMA, log.entries[1].state);
+  HAL_TEST_ASSERT_EQUAL(HAL_DMA_MM2S_ADDR_REG, log.entries[2].reg);
+  HAL_TEST_ASSERT_EQUAL(0x30001000, log.entries[2].data);
+  HAL_TEST_ASSERT_EQUAL(HAL_DMA_MM2S_LENGTH_REG, log.entries[3].reg);
+  HAL_TEST_ASSERT_EQUAL(256, log.entries[3].data);
+  HAL_TEST_ASSERT(log.entries[4].write);
+  HAL_TEST_ASSERT_EQUAL(HAL_DMA_MM2S_CLEAR_REG, log.entries[4].reg);
+  HAL_TEST_ASSERT_EQUAL(HAL_DMA_CLEAR_DATA, log.entries[4].data);
+  HAL_TEST_ASSERT_EQUAL(HAL_DMA_ST_CLEAR_IRQ, log.entries[4].state);
+  HAL_TEST_ASSERT_EQUAL(HAL_DMA_ST_IDLE, hal_dma_get_state(ctx, HAL_DMA_MM2S));
+
+  // The write controller uses the S2MM registers
+  log.count = 0;
+  HAL_TEST_ASSERT(hal_dma_transfer(ctx, HAL_DMA_S2MM, 0x30002000, 256) > 0);
+  HAL_TEST_ASSERT_EQUAL(5, log.count);
+  HAL_TEST_ASSERT_EQUAL(HAL_DMA_S2MM_IDLE_REG, log.entries[0].reg);
+  HAL_TEST_ASSERT_EQUAL(HAL_DMA_S2MM_IRQ_REG, log.entries[1].reg);
+  HAL_TEST_ASSERT_EQUAL(HAL_DMA_S2MM_ADDR_REG, log.entries[2].reg);
+  HAL_TEST_ASSERT_EQUAL(HAL_DMA_S2MM_LENGTH_REG, log.entries[3].reg);
+  HAL_TEST_ASSERT_EQUAL(HAL_DMA_S2MM_CLEAR_REG, log.entries[4].reg);
+
+  // Invalid requests
+  HAL_TEST_ASSERT_EQUAL(0, hal_dma_transfer(ctx, HAL_DMA_MM2S, 0x1000, 0));
+  HAL_TEST_ASSERT_EQUAL(
+      0, hal_dma_transfer(ctx, HAL_DMA_MM2S, 0x100000000ULL, 64));
+  HAL_TEST_ASSERT_EQUAL(0, hal_dma_transfer(ctx, HAL_DMA_CHANNELS, 0, 64));
+
+  hal_cleanup(ctx);
+}
+
+/**
+ * @brief Test cycle accounting against the configured timing
+ */
+static void test_hal_dma_timing(void) {
+  hal_context_t* ctx = hal_init("/dev/accelerator0");
+  HAL_TEST_ASSERT_NOT_NULL(ctx);
+
+  hal_dma_timing_t t = {.clock_mhz = 200,
+                        .lite_read_cycles = 4,
+                        .lite_write_cycles = 5,
+                        .slave_latency = 1,
+                        .state_cycles = 1,
+                        .startup_cycles = 10,
+                        .irq_cycles = 3,
+                        .bytes_per_cycle = 8};
+  HAL_TEST_ASSERT(hal_dma_set_timing(ctx, &t));
+
+  // 5 transitions, 1 read, 4 writes, start-up and IRQ latency
+  uint64_t setup = 5 * 1 + (4 + 1) + 4 * (5 + 1) + 10 + 3;
+  uint64_t cycles = hal_dma_transfer(ctx, HAL_DMA_MM2S, 0x30000000, 1000);
+  HAL_TEST_ASSERT_EQUAL(setup + 125, cycles);
+  HAL_TEST_ASSERT_EQUAL(cycles * 5, hal_dma_cycles_to_ns(ctx, cycles));
+
+  hal_dma_stats_t stats;
+  HAL_TEST_ASSERT(hal_dma_get_stats(ctx, HAL_DMA_MM2S, &stats));
+  HAL_TEST_ASSERT_EQUAL(1, stats.transfers);
+  HAL_TEST_ASSERT_EQUAL(1000, stats.bytes);
+  HAL_TEST_ASSERT_EQUAL(1, stats.lite_reads);
+  HAL_TEST_ASSERT_EQUAL(4, stats.lite_writes);
+  HAL_TEST_ASSERT_EQUAL(setup, stats.setup_cycles);
+  HAL_TEST_ASSERT_EQUAL(125, stats.data_cycles);
+
+  // Same bytes in 10 transfers pay the setup 10 times
+  hal_dma_reset_stats(ctx);
+  for (int i = 0; i < 10; i++) {
+    hal_dma_transfer(ctx, HAL_DMA_MM2S, 0x30000000 + i * 100, 100);
+  }
+  HAL_TEST_ASSERT(hal_dma_get_stats(ctx, HAL_DMA_MM2S, &stats));
+  HAL_TEST_ASSERT_EQUAL(10 * setup, stats.setup_cycles);
+  HAL_TEST_ASSERT_EQUAL(10 * 13, stats.data_cycles);
+
+  t.clock_mhz = 0;
+  HAL_TEST_ASSERT(!hal_dma_set_timing(ctx, &t));
+
+  hal_cleanup(ctx);
+}
+
+/**
+ * @brief Test splitting at the 26-bit length limit
+ */
+static void test_hal_dma_length_limit(void) {
+  hal_context_t* ctx = hal_init("/dev/accelerator0");
+  HAL_TEST_ASSERT_NOT_NULL(ctx);
+
+  struct trace_log log = {.ctx = ctx};
+  hal_dma_set_trace(ctx, record, &log);
+
+  // Exactly at the limit: one transfer
+  HAL_TEST_ASSERT(hal_dma_transfer(ctx, HAL_DMA_MM2S, 0, HAL_DMA_MAX_LENGTH));
+  HAL_TEST_ASSERT_EQUAL(HAL_DMA_MAX_LENGTH, log.entries[3].data);
+
+  // 100MB: two full-length transfers and the remainder
+  hal_dma_reset_stats(ctx);
+  log.count = 0;
+  uint64_t length = 100ULL << 20;
+  HAL_TEST_ASSERT(hal_dma_transfer(ctx, HAL_DMA_MM2S, 0x10000000, length));
+
+  hal_dma_stats_t stats;
+  HAL_TEST_ASSERT(hal_dma_get_stats(ctx, HAL_DMA_MM2S, &stats));
+  HAL_TEST_ASSERT_EQUAL(1, stats.requests);
+  HAL_TEST_ASSERT_EQUAL(1, stats.split);
+  HAL_TEST_ASSERT_EQUAL(2, stats.transfers);
+  HAL_TEST_ASSERT_EQUAL(length, stats.bytes);
+  HAL_TEST_ASSERT_EQUAL(10, log.count);
+  HAL_TEST_ASSERT_EQUAL(0x10000000, log.entries[2].data);
+  HAL_TEST_ASSERT_EQUAL(HAL_DMA_MAX_LENGTH, log.entries[3].data);
+  HAL_TEST_ASSERT_EQUAL(0x10000000 + HAL_DMA_MAX_LENGTH, log.entries[7].data);
+  HAL_TEST_ASSERT_EQUAL(length - HAL_DMA_MAX_LENGTH, log.entries[8].data);
+
+  hal_cleanup(ctx);
+}
+
+/**
+ * @brief Test that LSU transfers drive both controllers
+ */
+static void test_hal_dma_lsu(void) {
+  hal_context_t* ctx = hal_init("/dev/accelerator0");
+  HAL_TEST_ASSERT_NOT_NULL(ctx);
+
+  hal_lsu_config_t lsu = {.src_addr = 0x30000000,
+                          .dst_addr = 0x30100000,
+                          .length = 4096};
+  HAL_TEST_ASSERT(hal_configure_lsu(ctx, &lsu));
+
+  hal_dma_stats_t read_stats, write_stats;
+  HAL_TEST_ASSERT(hal_dma_get_stats(ctx, HAL_DMA_MM2S, &read_stats));
+  HAL_TEST_ASSERT(hal_dma_get_stats(ctx, HAL_DMA_S2MM, &write_stats));
+  HAL_TEST_ASSERT_EQUAL(4096, read_stats.bytes);
+  HAL_TEST_ASSERT_EQUAL(4096, write_stats.bytes);
+
+  // Addresses must fit the 32-bit address registers
+  lsu.dst_addr = 0x100000000ULL;
+  HAL_TEST_ASSERT(!hal_configure_lsu(ctx, &lsu));
+
+  hal_cleanup(ctx);
+}
+
+int main(void) {
+  HAL_TEST_BEGIN();
+
+  HAL_TEST_RUN(test_hal_dma_sequence);
+  HAL_TEST_RUN(test_hal_dma_timing);
+  HAL_TEST_RUN(test_hal_dma_length_limit);
+  HAL_TEST_RUN(test_hal_dma_lsu);
+
+  HAL_TEST_END();
+}
@@ -8,7 +8,12 @@
  * @date 2020-03-28
  */
 
+#include <stdint.h>
+#include <string.h>
+#include <unistd.h>
+
 #include "hal_base.h"
+#include "hal_page.h"
 #include "hal_test.h"
 
 /**
@@ -61,6 +66,55 @@ static void test_hal_init_multiple(void) {
   hal_cleanup(ctx2);
 }
 
+/**
+ * @brief Test huge page and prefault mapping options
+ */
+static void test_hal_init_page_flags(void) {
+  hal_context_t* ctx = hal_init_flags("/dev/accelerator0",
+                                      HAL_INIT_PREFAULT | HAL_INIT_HUGE_1G);
+  HAL_TEST_ASSERT_NOT_NULL(ctx);
+  if (!ctx) {
+    return;
+  }
+
+  // 256MB cannot use 1GB pages; either 2MB pages or aligned base pages
+  HAL_TEST_ASSERT(ctx->page_size != HAL_PAGE_1G);
+  HAL_TEST_ASSERT_EQUAL(0, (uintptr_t)ctx->accel_memory_base % HAL_PAGE_2M);
+  volatile uint32_t* mem = ctx->accel_memory_base;
+  mem[0] = 0xA5A5A5A5;
+  HAL_TEST_ASSERT_EQUAL(0xA5A5A5A5, mem[0]);
+  hal_cleanup(ctx);
+
+  ctx = hal_init_flags("/dev/accelerator0", HAL_INIT_PREFAULT);
+  HAL_TEST_ASSERT_NOT_NULL(ctx);
+  HAL_TEST_ASSERT_EQUAL((size_t)getpagesize(), ctx->page_size);
+  hal_cleanup(ctx);
+}
+
+/**
+ * @brief Test anonymous mappings used for host arenas
+ */
+static void test_hal_page_map_anonymous(void) {
+  size_t page_size = 0;
+  char* arena = hal_page_map(-1, 0, 3 * HAL_PAGE_2M,
+                             HAL_INIT_HUGE_2M | HAL_INIT_PREFAULT, &page_size);
+  HAL_TEST_ASSERT_NOT_NULL(arena);
+  HAL_TEST_ASSERT(page_size == HAL_PAGE_2M ||
+                  page_size == (size_t)getpagesize());
+  HAL_TEST_ASSERT_EQUAL(0, (uintptr_t)arena % HAL_PAGE_2M);
+  HAL_TEST_ASSERT_EQUAL(0, arena[0]);
+  memset(arena, 1, 3 * HAL_PAGE_2M);
+  hal_page_unmap(arena, 3 * HAL_PAGE_2M, page_size);
+
+  // Too small for huge pages
+  char* small = hal_page_map(-1, 0, 100, HAL_INIT_HUGE_2M, &page_size);
+  HAL_TEST_ASSERT_NOT_NULL(small);
+  HAL_TEST_ASSERT_EQUAL((size_t)getpagesize(), page_size);
+  hal_page_unmap(small, 100, page_size);
+
+  HAL_TEST_ASSERT_NULL(hal_page_map(-1, 0, 0, 0, NULL));
+}
+
 int main(void) {
   HAL_TEST_BEGIN();
 
@@ -68,6 +122,8 @@ int main(void) {
   HAL_TEST_RUN(test_hal_init_invalid_params);
   HAL_TEST_RUN(test_hal_init_cleanup_null);
   HAL_TEST_RUN(test_hal_init_multiple);
+  HAL_TEST_RUN(test_hal_init_page_flags);
+  HAL_TEST_RUN(test_hal_page_map_anonymous);
 
   HAL_TEST_END();
 }
\ No newline at end of file
@@ -7,6 +7,8 @@
  * @date 2020-03-28
  */
 
+#include <string.h>
+
 #include "hal_base.h"
 #include "hal_mem.h"
 #include "hal_test.h"
@@ -175,6 +177,166 @@ static void test_hal_mem_available(void) {
   tear_down();
 }
 
+/**
+ * @brief Relocation callback for compaction tests
+ *
+ * Records moves into the array passed as user data and refuses to move the
+ * block at pinned_addr.
+ */
+static void* pinned_addr = NULL;
+
+static bool record_relocate(void* user_data, void* old_addr, void* new_addr,
+                            size_t size) {
+  (void)size;
+  void** slots = user_data;
+  if (old_addr == pinned_addr) {
+    return false;
+  }
+  for (int i = 0; i < 4; i++) {
+    if (slots[i] == old_addr) {
+      slots[i] = new_addr;
+    }
+  }
+  return true;
+}
+
+/**
+ * @brief Test fragmentation statistics and compaction
+ */
+static void test_hal_mem_compact(void) {
+  set_up();
+
+  void* blocks[4];
+  for (int i = 0; i < 4; i++) {
+    blocks[i] = hal_mem_alloc(ctx, TEST_SIZE);
+    HAL_TEST_ASSERT_NOT_NULL(blocks[i]);
+    memset(blocks[i], 'a' + i, TEST_SIZE);
+  }
+
+  // Free every other block: two holes plus the tail
+  hal_mem_free(ctx, blocks[0]);
+  hal_mem_free(ctx, blocks[2]);
+  blocks[0] = blocks[2] = NULL;
+
+  hal_mem_stats_t stats;
+  HAL_TEST_ASSERT(hal_mem_get_stats(ctx, &stats));
+  HAL_TEST_ASSERT_EQUAL(3, stats.free_blocks);
+  HAL_TEST_ASSERT_EQUAL(2, stats.used_blocks);
+  HAL_TEST_ASSERT_EQUAL_UINT64(hal_mem_available(ctx), stats.total_free);
+  HAL_TEST_ASSERT(stats.largest_free < stats.total_free);
+
+  // Everything movable: one free block remains, data follows the blocks
+  pinned_addr = NULL;
+  size_t moved = hal_mem_compact(ctx, record_relocate, blocks);
+  HAL_TEST_ASSERT_EQUAL_UINT64(2 * TEST_SIZE, moved);
+  HAL_TEST_ASSERT(blocks[1] == ctx->accel_memory_base);
+  HAL_TEST_ASSERT_EQUAL('b', ((char*)blocks[1])[TEST_SIZE - 1]);
+  HAL_TEST_ASSERT_EQUAL('d', ((char*)blocks[3])[0]);
+
+  HAL_TEST_ASSERT(hal_mem_get_stats(ctx, &stats));
+  HAL_TEST_ASSERT_EQUAL(1, stats.free_blocks);
+  HAL_TEST_ASSERT_EQUAL_UINT64(stats.total_free, stats.largest_free);
+
+  // A pinned block stays put and keeps the hole in front of it
+  hal_mem_free(ctx, blocks[1]);
+  blocks[1] = NULL;
+  pinned_addr = blocks[3];
+  void* pinned = blocks[3];
+  HAL_TEST_ASSERT_EQUAL_UINT64(0, hal_mem_compact(ctx, record_relocate,
+                                                  blocks));
+  HAL_TEST_ASSERT(blocks[3] == pinned);
+  HAL_TEST_ASSERT(hal_mem_get_stats(ctx, &stats));
+  HAL_TEST_ASSERT_EQUAL(2, stats.free_blocks);
+
+  // The allocator still works on the rebuilt block list
+  void* ptr = hal_mem_alloc(ctx, TEST_SIZE);
+  HAL_TEST_ASSERT(ptr == ctx->accel_memory_base);
+  hal_mem_free(ctx, ptr);
+  hal_mem_free(ctx, blocks[3]);
+  HAL_TEST_ASSERT_EQUAL_UINT64(HAL_ACCEL_MEM_SIZE, hal_mem_available(ctx));
+
+  HAL_TEST_ASSERT(!hal_mem_get_stats(ctx, NULL));
+  HAL_TEST_ASSERT_EQUAL_UINT64(0, hal_mem_compact(ctx, NULL, NULL));
+
+  tear_down();
+}
+
+/**
+ * @brief Test cache maintenance on cached and uncached mappings
+ */
+static void test_hal_mem_sync(void) {
+  hal_context_t* cached = hal_init_flags("/dev/accelerator0", HAL_INIT_CACHED);
+  HAL_TEST_ASSERT_NOT_NULL(cached);
+  HAL_TEST_ASSERT(cached->flags & HAL_INIT_CACHED);
+
+  uint8_t* ptr = hal_mem_alloc(cached, TEST_SIZE);
+  HAL_TEST_ASSERT_NOT_NULL(ptr);
+
+  // Data survives write-back and invalidation
+  for (size_t i = 0; i < TEST_SIZE; i++) {
+    ptr[i] = (uint8_t)i;
+  }
+  HAL_TEST_ASSERT(hal_mem_sync_for_device(cached, ptr, TEST_SIZE));
+  HAL_TEST_ASSERT(hal_mem_sync_for_cpu(cached, ptr + 3, 100));
+  HAL_TEST_ASSERT_EQUAL(100, ptr[100]);
+
+  // Ranges must lie inside accelerator memory
+  uint8_t* base = cached->accel_memory_base;
+  HAL_TEST_ASSERT(!hal_mem_sync_for_device(cached, ptr, 0));
+  HAL_TEST_ASSERT(!hal_mem_sync_for_cpu(cached, base - 1, 2));
+  HAL_TEST_ASSERT(!hal_mem_sync_for_cpu(
+      cached, base + HAL_ACCEL_MEM_SIZE - 1, 2));
+  HAL_TEST_ASSERT(!hal_mem_sync_for_device(NULL, ptr, TEST_SIZE));
+
+  hal_mem_free(cached, ptr);
+  hal_cleanup(cached);
+
+  // Uncached mappings only need a barrier, but accept the same calls
+  set_up();
+  HAL_TEST_ASSERT(!(ctx->flags & HAL_INIT_CACHED));
+  ptr = hal_mem_alloc(ctx, TEST_SIZE);
+  HAL_TEST_ASSERT(hal_mem_sync_for_device(ctx, ptr, TEST_SIZE));
+  HAL_TEST_ASSERT(hal_mem_sync_for_cpu(ctx, ptr, TEST_SIZE));
+  hal_mem_free(ctx, ptr);
+  tear_down();
+}
+
+/**
+ * @brief Test quota accounting and enforcement
+ */
+static void test_hal_mem_quota(void) {
+  set_up();
+
+  hal_mem_quota_t quota = {.limit = 4 * TEST_SIZE};
+  void* ptr1 = hal_mem_alloc_quota(ctx, 3 * TEST_SIZE, &quota);
+  HAL_TEST_ASSERT_NOT_NULL(ptr1);
+  HAL_TEST_ASSERT_EQUAL(3 * TEST_SIZE, quota.used);
+
+  // Over the limit although the region has plenty of space
+  HAL_TEST_ASSERT_NULL(hal_mem_alloc_quota(ctx, 2 * TEST_SIZE, &quota));
+  HAL_TEST_ASSERT_EQUAL_UINT64(1, quota.denied);
+  HAL_TEST_ASSERT_EQUAL(3 * TEST_SIZE, quota.used);
+
+  // Unquoted allocations are not charged
+  void* other = hal_mem_alloc(ctx, 8 * TEST_SIZE);
+  HAL_TEST_ASSERT_NOT_NULL(other);
+  HAL_TEST_ASSERT_EQUAL(3 * TEST_SIZE, quota.used);
+
+  void* ptr2 = hal_mem_alloc_quota(ctx, TEST_SIZE, &quota);
+  HAL_TEST_ASSERT_NOT_NULL(ptr2);
+  HAL_TEST_ASSERT_EQUAL(4 * TEST_SIZE, quota.peak);
+
+  // Freeing credits the quota the block was charged to
+  hal_mem_free(ctx, ptr1);
+  HAL_TEST_ASSERT_EQUAL(TEST_SIZE, quota.used);
+  HAL_TEST_ASSERT_EQUAL(4 * TEST_SIZE, quota.peak);
+  hal_mem_free(ctx, ptr2);
+  hal_mem_free(ctx, other);
+  HAL_TEST_ASSERT_EQUAL(0, quota.used);
+
+  tear_down();
+}
+
 int main(void) {
   HAL_TEST_BEGIN();
 
@@ -184,6 +346,9 @@ int main(void) {
   HAL_TEST_RUN(test_hal_mem_invalid_params);
   HAL_TEST_RUN(test_hal_mem_fragmentation);
   HAL_TEST_RUN(test_hal_mem_available);
+  HAL_TEST_RUN(test_hal_mem_sync);
+  HAL_TEST_RUN(test_hal_mem_compact);
+  HAL_TEST_RUN(test_hal_mem_quota);
 
   HAL_TEST_END();
 }
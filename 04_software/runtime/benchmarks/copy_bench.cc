@@ -0,0 +1,93 @@
+/**
+ * @file copy_bench.cc
+ * @author Leo (zhsleo@outlook.com)
+ *
+ * @brief Host <-> device copy bandwidth on the mapped device region
+ * @version 1.0.0
+ * @date 2026-10-18
+ */
+
+#include <accel.hpp>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <vector>
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+/**
+ * @brief Best-of-N bandwidth of a copy
+ * @param bytes Bytes moved per run
+ * @param copy Copy to time
+ * @return Bandwidth in GB/s
+ */
+double MeasureGBps(size_t bytes, const std::function<void()>& copy) {
+  const int runs = bytes >= (16u << 20) ? 5 : 20;
+  double best = 1e30;
+  for (int i = 0; i < runs; i++) {
+    auto start = Clock::now();
+    copy();
+    best = std::min(
+        best, std::chrono::duration<double>(Clock::now() - start).count());
+  }
+  return bytes / best / 1e9;
+}
+
+}  // namespace
+
+int main(int argc, char* argv[]) {
+  const size_t max_mb = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 64;
+
+  accel::Runtime runtime("/dev/accelerator");
+
+  using accel::detail::CopyIsa;
+  const CopyIsa best = accel::detail::ActiveCopyIsa();
+  const unsigned threads = accel::detail::DefaultCopyThreads();
+  std::printf("copy ISA: %s, threads: %u\n\n",
+              accel::detail::CopyIsaName(best), threads);
+  std::printf("%-10s %-28s %12s %12s\n", "size", "kernel", "upload GB/s",
+              "download GB/s");
+
+  for (size_t size = 64 << 10; size <= (max_mb << 20); size *= 4) {
+    accel::Buffer buffer(size);
+    std::vector<char> host(size, 1);
+    char* device = static_cast<char*>(buffer.data());
+
+    auto report = [&](const char* name, const std::function<void()>& up,
+                      const std::function<void()>& down) {
+      std::printf("%-10zu %-28s %12.2f", size >> 10, name,
+                  MeasureGBps(size, up));
+      if (down) {
+        std::printf(" %12.2f", MeasureGBps(size, down));
+      }
+      std::printf("\n");
+    };
+
+    report(
+        "memcpy", [&] { std::memcpy(device, host.data(), size); },
+        [&] { std::memcpy(host.data(), device, size); });
+
+    // Each non-temporal kernel single-threaded, then the runtime default
+    for (CopyIsa isa : {CopyIsa::kSse, CopyIsa::kAvx2, CopyIsa::kAvx512}) {
+      if (isa > best) {
+        break;
+      }
+      char name[32];
+      std::snprintf(name, sizeof(name), "non-temporal %s x1",
+                    accel::detail::CopyIsaName(isa));
+      report(
+          name,
+          [&] { accel::detail::StreamCopy(device, host.data(), size, isa, 1); },
+          nullptr);
+    }
+
+    report(
+        "Buffer::Upload/Download", [&] { buffer.Upload(host.data(), size); },
+        [&] { buffer.Download(host.data(), size); });
+  }
+  return 0;
+}
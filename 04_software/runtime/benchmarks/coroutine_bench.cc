@@ -0,0 +1,110 @@
+/**
+ * @file coroutine_bench.cc
+ * @author Leo (zhsleo@outlook.com)
+ *
+ * @brief Thread-per-request vs. coroutine concurrency benchmark
+ * @version 1.0.0
+ * @date 2026-10-18
+ */
+
+#include <accel.hpp>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <thread>
+#include <vector>
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+/** @brief Buffers owned by one simulated request */
+struct Request {
+  accel::Buffer input{4096};
+  accel::Buffer weights{4096};
+  accel::Buffer output{4096};
+};
+
+/**
+ * @brief Each request blocks its own thread in Runtime::MatrixMultiply
+ * @return Wall time in seconds
+ */
+double RunThreadPerRequest(accel::Runtime& runtime,
+                           std::vector<std::unique_ptr<Request>>& requests,
+                           int ops_per_request) {
+  auto start = Clock::now();
+  std::vector<std::thread> threads;
+  threads.reserve(requests.size());
+  for (auto& request : requests) {
+    threads.emplace_back([&runtime, &request, ops_per_request] {
+      for (int i = 0; i < ops_per_request; i++) {
+        runtime.MatrixMultiply(request->input, request->weights,
+                               request->output);
+      }
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  return std::chrono::duration<double>(Clock::now() - start).count();
+}
+
+/** @brief One request as a coroutine awaiting each op */
+accel::Task ServeRequest(accel::Runtime& runtime, Request& request,
+                         int ops_per_request) {
+  for (int i = 0; i < ops_per_request; i++) {
+    co_await runtime.MatrixMultiplyAsync(request.input, request.weights,
+                                         request.output);
+  }
+}
+
+/**
+ * @brief All requests are coroutines multiplexed on the reactor thread
+ * @return Wall time in seconds
+ */
+double RunCoroutines(accel::Runtime& runtime,
+                     std::vector<std::unique_ptr<Request>>& requests,
+                     int ops_per_request) {
+  auto start = Clock::now();
+  std::vector<accel::Task> tasks;
+  tasks.reserve(requests.size());
+  for (auto& request : requests) {
+    tasks.push_back(ServeRequest(runtime, *request, ops_per_request));
+  }
+  for (auto& task : tasks) {
+    task.Wait();
+  }
+  return std::chrono::duration<double>(Clock::now() - start).count();
+}
+
+}  // namespace
+
+int main(int argc, char* argv[]) {
+  const int max_concurrency = argc > 1 ? std::atoi(argv[1]) : 128;
+  const int ops_per_request = argc > 2 ? std::atoi(argv[2]) : 64;
+
+  accel::Runtime runtime("/dev/accelerator");
+  runtime.Configure(accel::kEnableDma);
+
+  std::printf("%-12s %-16s %14s %14s %10s\n", "concurrency", "mode",
+              "ops/s", "wall (ms)", "threads");
+  for (int concurrency = 1; concurrency <= max_concurrency;
+       concurrency *= 2) {
+    std::vector<std::unique_ptr<Request>> requests;
+    for (int i = 0; i < concurrency; i++) {
+      requests.push_back(std::make_unique<Request>());
+    }
+
+    const double total_ops = double(concurrency) * ops_per_request;
+    double threaded = RunThreadPerRequest(runtime, requests, ops_per_request);
+    double coroutine = RunCoroutines(runtime, requests, ops_per_request);
+
+    std::printf("%-12d %-16s %14.0f %14.2f %10d\n", concurrency,
+                "thread/request", total_ops / threaded, threaded * 1e3,
+                concurrency);
+    std::printf("%-12d %-16s %14.0f %14.2f %10d\n", concurrency, "coroutine",
+                total_ops / coroutine, coroutine * 1e3, 1);
+  }
+  return 0;
+}
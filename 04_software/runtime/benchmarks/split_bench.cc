@@ -0,0 +1,200 @@
+/**
+ * @file split_bench.cc
+ * @author Leo (zhsleo@outlook.com)
+ *
+ * @brief Conv2d and Linear layers split between the CPU kernels and the
+ *        accelerator, idle and loaded
+ * @version 1.0.0
+ * @date 2026-10-18
+ */
+
+#include <accel.hpp>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <model.hpp>
+#include <thread>
+#include <vector>
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+/**
+ * @brief Mean time of a function
+ * @param runs Timed runs
+ * @param fn Function to time
+ * @return Microseconds per run
+ */
+double MeasureUs(int runs, const std::function<void()>& fn) {
+  auto start = Clock::now();
+  for (int i = 0; i < runs; i++) {
+    fn();
+  }
+  return std::chrono::duration<double, std::micro>(Clock::now() - start)
+             .count() /
+         runs;
+}
+
+/** @brief Deterministic int8 values */
+std::vector<int> Values(size_t count, size_t seed) {
+  std::vector<int> values(count);
+  for (size_t i = 0; i < count; i++) {
+    values[i] = static_cast<int>((i * 7 + seed * 13) % 255) - 127;
+  }
+  return values;
+}
+
+/** @brief JSON of per-channel quantized int8 weights */
+qnn::json WeightJson(const std::vector<size_t>& shape) {
+  size_t count = 1;
+  for (size_t dim : shape) {
+    count *= dim;
+  }
+  qnn::json weight;
+  weight["shape"] = shape;
+  weight["dtype"] = "torch.qint8";
+  weight["quantization"] = "per_channel";
+  weight["scales"] = std::vector<float>(shape[0], 0.005f);
+  weight["axis"] = 0;
+  weight["values"] = Values(count, shape[0]);
+  return weight;
+}
+
+/**
+ * @brief Time one layer on the host, on the accelerator and split
+ *
+ * @param runtime Runtime to split with
+ * @param layer Layer, loaded from weight_json
+ * @param weight_json Weights of the layer
+ * @param host_input Batch-1 input
+ * @param op Accelerator operation of the layer
+ * @param runs Timed runs per mode
+ */
+void Bench(accel::Runtime& runtime, qnn::QuantOperator& layer,
+           const qnn::json& weight_json, const qnn::Tensor<int8_t>& host_input,
+           accel::SplitOp op, int runs) {
+  // The CPU result is what the host rows of a split run must match
+  qnn::Tensor<int8_t> expected;
+  layer.Forward(host_input, expected);
+  const size_t channels = expected.shape()[1];
+  const size_t row_bytes = expected.size() / channels;
+
+  const std::vector<size_t> weight_shape = weight_json["shape"];
+  const std::vector<int> values = weight_json["values"];
+  accel::DeviceTensor weights(weight_shape, accel::DType::kInt8);
+  for (size_t i = 0; i < values.size(); i++) {
+    weights.data<int8_t>()[i] = static_cast<int8_t>(values[i]);
+  }
+  weights.buffer().MarkDirty();
+  accel::DeviceTensor input = accel::DeviceTensor::FromHost(host_input);
+  accel::DeviceTensor output(expected.shape(), accel::DType::kInt8,
+                             accel::Layout::kNCHW, expected.scale());
+
+  std::printf("%s, %zu output channels of %zu bytes, %d runs\n\n",
+              layer.type.c_str(), channels, row_bytes, runs);
+  std::printf("%-22s %10s %12s\n", "mode", "us/run", "host share");
+
+  qnn::Tensor<int8_t> host_output;
+  const double host_us =
+      MeasureUs(runs, [&] { layer.Forward(host_input, host_output); });
+  std::printf("%-22s %10.1f %11.0f%%\n", "host only", host_us, 100.0);
+
+  const double device_us = MeasureUs(runs, [&] {
+    if (op == accel::SplitOp::kMatrixMultiply) {
+      runtime.MatrixMultiply(input.buffer(), weights.buffer(),
+                             output.buffer());
+    } else {
+      runtime.Convolution2D(input.buffer(), weights.buffer(),
+                            output.buffer());
+    }
+  });
+  std::printf("%-22s %10.1f %11.0f%%\n", "accelerator only", device_us, 0.0);
+
+  accel::SplitExecutor split(runtime, op, channels);
+  split.Calibrate(layer, host_input, input.buffer(), weights, output);
+  const size_t host_channels = split.HostChannels();
+  split.Run(layer, host_input, input.buffer(), weights, output);
+  const bool match =
+      std::memcmp(output.data<int8_t>(), expected.data(),
+                  host_channels * row_bytes) == 0;
+
+  const double idle_us = MeasureUs(runs, [&] {
+    split.Run(layer, host_input, input.buffer(), weights, output);
+  });
+  std::printf("%-22s %10.1f %11.1f%%\n", "split, idle device", idle_us,
+              100.0 * split.HostChannels() / channels);
+
+  // Another client keeps the device busy; the split shifts to the host
+  std::atomic<bool> stop{false};
+  std::thread load([&] {
+    accel::Buffer big_input(1 << 20);
+    accel::Buffer big_output(1 << 20);
+    accel::Stream stream = runtime.CreateStream();
+    while (!stop) {
+      stream.MatrixMultiply(big_input, weights.buffer(), big_output);
+      stream.Synchronize();
+    }
+  });
+  const double busy_us = MeasureUs(runs, [&] {
+    split.Run(layer, host_input, input.buffer(), weights, output);
+  });
+  stop = true;
+  load.join();
+  std::printf("%-22s %10.1f %11.1f%%\n", "split, busy device", busy_us,
+              100.0 * split.HostChannels() / channels);
+
+  const accel::SplitStats& stats = split.stats();
+  std::printf("\nrates (channels/us): host %.3f, accelerator %.3f\n",
+              stats.host_rate, stats.device_rate);
+  std::printf("host rows match the CPU layer: %s\n\n", match ? "yes" : "no");
+}
+
+}  // namespace
+
+int main(int argc, char* argv[]) {
+  const size_t rows = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 1024;
+  const size_t cols = argc > 2 ? std::strtoul(argv[2], nullptr, 10) : 1024;
+  const int runs = argc > 3 ? std::atoi(argv[3]) : 50;
+
+  accel::Runtime runtime("/dev/accelerator");
+  runtime.Configure(accel::kEnableDma);
+
+  // Linear [rows, cols]: one byte per output channel
+  qnn::json linear_json;
+  linear_json["name"] = "fc";
+  linear_json["weight"] = WeightJson({rows, cols});
+  linear_json["scale"] = 0.5f;
+  auto linear = qnn::Linear<int8_t, int8_t>::LoadFromJson(linear_json);
+  qnn::Tensor<int8_t> vector;
+  vector.resize(std::vector<size_t>{1, cols});
+  vector.set_scale(0.05f);
+  std::memset(vector.data(), 1, cols);
+  Bench(runtime, *linear, linear_json["weight"], vector,
+        accel::SplitOp::kMatrixMultiply, runs);
+
+  // 3x3 Conv2d 32 -> 64 on 28x28 maps: 784 bytes per output channel
+  qnn::json conv_json;
+  conv_json["name"] = "conv";
+  conv_json["in_channels"] = 32;
+  conv_json["out_channels"] = 64;
+  conv_json["kernel_size"] = 3;
+  conv_json["stride"] = 1;
+  conv_json["padding"] = 1;
+  conv_json["weight"] = WeightJson({64, 32, 3, 3});
+  conv_json["scale"] = 0.5f;
+  auto conv = qnn::Conv2d<int8_t, int8_t>::LoadFromJson(conv_json);
+  qnn::Tensor<int8_t> map;
+  map.resize(std::vector<size_t>{1, 32, 28, 28});
+  map.set_scale(0.05f);
+  const std::vector<int> pixels = Values(map.size(), 3);
+  for (size_t i = 0; i < map.size(); i++) {
+    map.data()[i] = static_cast<int8_t>(pixels[i]);
+  }
+  Bench(runtime, *conv, conv_json["weight"], map,
+        accel::SplitOp::kConvolution2D, runs);
+  return 0;
+}
@@ -0,0 +1,148 @@
+/**
+ * @file startup_bench.cc
+ * @author Leo (zhsleo@outlook.com)
+ *
+ * @brief Startup vs. first-inference latency with prefaulted and huge pages
+ * @version 1.0.0
+ * @date 2026-10-18
+ */
+
+#include <sys/resource.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <accel.hpp>
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+/** @brief Latencies of one mode, measured in a fresh process */
+struct Result {
+  double startup_ms;
+  double first_ms;
+  double steady_ms;
+  long first_faults;
+  size_t device_page;
+  size_t host_page;
+};
+
+double ElapsedMs(Clock::time_point start) {
+  return std::chrono::duration<double, std::milli>(Clock::now() - start)
+      .count();
+}
+
+long MinorFaults() {
+  rusage usage;
+  getrusage(RUSAGE_SELF, &usage);
+  return usage.ru_minflt;
+}
+
+/**
+ * @brief Startup, first and steady-state inference of a toy model
+ *
+ * An inference writes the input activation in the host arena, uploads it,
+ * runs a matmul and reads the result back into the arena.
+ */
+Result Run(uint32_t flags, size_t activation_bytes) {
+  Result result{};
+  auto start = Clock::now();
+  accel::Runtime runtime("/dev/accelerator", flags);
+  accel::HostArena arena(4 * activation_bytes, flags);
+  accel::DeviceTensor input({activation_bytes}, accel::DType::kInt8);
+  accel::Buffer weights(activation_bytes);
+  accel::DeviceTensor output({activation_bytes}, accel::DType::kInt8);
+  result.startup_ms = ElapsedMs(start);
+  result.device_page = runtime.GetMemoryStats().page_size;
+  result.host_page = arena.page_size();
+
+  auto infer = [&] {
+    arena.Reset();
+    accel::ArenaTensor<int8_t> activation(arena, {activation_bytes});
+    accel::ArenaTensor<int8_t> logits(arena);
+    std::memset(activation.data(), 1, activation_bytes);
+    input.Upload(activation);
+    runtime.MatrixMultiply(input.buffer(), weights, output.buffer());
+    output.Download(logits);
+  };
+
+  long faults = MinorFaults();
+  start = Clock::now();
+  infer();
+  result.first_ms = ElapsedMs(start);
+  result.first_faults = MinorFaults() - faults;
+
+  const int runs = 10;
+  start = Clock::now();
+  for (int i = 0; i < runs; i++) {
+    infer();
+  }
+  result.steady_ms = ElapsedMs(start) / runs;
+  return result;
+}
+
+/** @brief Run one mode in a child so every mode starts with no mappings */
+bool RunIsolated(uint32_t flags, size_t activation_bytes, Result* result) {
+  int fds[2];
+  if (pipe(fds) != 0) {
+    return false;
+  }
+  pid_t pid = fork();
+  if (pid == 0) {
+    close(fds[0]);
+    Result child = Run(flags, activation_bytes);
+    ssize_t written = write(fds[1], &child, sizeof(child));
+    _exit(written == sizeof(child) ? 0 : 1);
+  }
+  close(fds[1]);
+  ssize_t got = read(fds[0], result, sizeof(*result));
+  close(fds[0]);
+  int status = 0;
+  waitpid(pid, &status, 0);
+  return got == sizeof(*result) && WIFEXITED(status) &&
+         WEXITSTATUS(status) == 0;
+}
+
+}  // namespace
+
+int main(int argc, char* argv[]) {
+  const size_t activation_mb =
+      argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 32;
+  const size_t activation_bytes = activation_mb << 20;
+
+  struct Mode {
+    const char* name;
+    uint32_t flags;
+  };
+  const Mode modes[] = {
+      {"default", 0},
+      {"prefault", accel::kPrefault},
+      {"huge 2M", accel::kHugePages2M},
+      {"prefault + huge 2M", accel::kPrefault | accel::kHugePages2M},
+  };
+
+  // Warm the device file's page cache so the first mode is not penalized
+  Result warmup;
+  RunIsolated(0, activation_bytes, &warmup);
+
+  std::printf("activations: %zu MB\n\n", activation_mb);
+  std::printf("%-20s %8s %8s %12s %12s %11s %13s\n", "mode", "dev pg",
+              "host pg", "startup ms", "first ms", "steady ms",
+              "first faults");
+  for (const Mode& mode : modes) {
+    Result r;
+    if (!RunIsolated(mode.flags, activation_bytes, &r)) {
+      std::printf("%-20s failed\n", mode.name);
+      continue;
+    }
+    std::printf("%-20s %7zuK %7zuK %12.2f %12.2f %11.2f %13ld\n", mode.name,
+                r.device_page >> 10, r.host_page >> 10, r.startup_ms,
+                r.first_ms, r.steady_ms, r.first_faults);
+  }
+  return 0;
+}
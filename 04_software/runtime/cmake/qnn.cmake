@@ -0,0 +1,21 @@
+# Headers of the CPU inference library, whose kernels run the host share of
+# split layers
+set(QNN_ROOT ${PROJECT_SOURCE_DIR}/../../02_inference)
+set(QNN_INCLUDE_DIR ${QNN_ROOT}/include)
+
+find_package(fmt QUIET)
+find_package(spdlog QUIET)
+find_path(NLOHMANN_JSON_INCLUDE_DIR nlohmann/json.hpp)
+
+# Targets using the CPU kernels are skipped when a dependency is missing
+if(EXISTS ${QNN_INCLUDE_DIR}/model.hpp AND fmt_FOUND AND spdlog_FOUND
+   AND NLOHMANN_JSON_INCLUDE_DIR)
+    add_library(qnn INTERFACE IMPORTED)
+    set_target_properties(qnn PROPERTIES
+        INTERFACE_INCLUDE_DIRECTORIES
+            "${QNN_INCLUDE_DIR};${NLOHMANN_JSON_INCLUDE_DIR}"
+        INTERFACE_LINK_LIBRARIES "spdlog::spdlog;fmt::fmt"
+    )
+else()
+    message(STATUS "qnn headers or their dependencies not found; split_bench is not built")
+endif()
@@ -1,5 +1,12 @@
 #pragma once
 
 #include "accel/buffer.hpp"
+#include "accel/copy.hpp"
+#include "accel/coro.hpp"
+#include "accel/device_tensor.hpp"
+#include "accel/host_arena.hpp"
 #include "accel/runtime.hpp"
+#include "accel/split.hpp"
+#include "accel/stream.hpp"
+#include "accel/tenant.hpp"
 #include "accel/types.hpp"
\ No newline at end of file
@@ -9,16 +9,27 @@
 
 #pragma once
 
+#include <algorithm>
+#include <cstring>
 #include <memory>
 #include <stdexcept>
 #include <string>
 
 #include "accel.h"
+#include "copy.hpp"
 
 namespace accel {
 
 /**
  * @brief RAII wrapper for accelerator buffer
+ *
+ * Tracks the byte range written by the host since the last flush, so that
+ * with a cached mapping only dirty cache lines are written back before the
+ * device reads the buffer.
+ *
+ * Device memory compaction may move the buffer. The object stays valid and
+ * its copy methods pin it for their duration; a pointer from data() is only
+ * stable while the buffer is pinned (see PinGuard).
  */
 class Buffer {
  public:
@@ -35,35 +46,83 @@ class Buffer {
     }
   }
 
-  ~Buffer() {
-    if (buffer_) {
-      accel_free_buffer(buffer_);
+  /**
+   * @brief Wraps memory that already lives in device memory without owning it
+   * @param host_addr Host address inside the mapped device region
+   * @param size Range size in bytes
+   * @return Non-owning buffer; the memory must outlive it
+   * @throws std::runtime_error if the range is not in device memory
+   */
+  static Buffer Import(void* host_addr, size_t size) {
+    accel_buffer_t* buffer = accel_import_buffer(host_addr, size);
+    if (!buffer) {
+      throw std::runtime_error("Failed to import buffer: " +
+                               std::string(accel_get_error()));
     }
+    return Buffer(buffer, false);
   }
 
+  ~Buffer() { Release(); }
+
   // Disable copying
   Buffer(const Buffer&) = delete;
   Buffer& operator=(const Buffer&) = delete;
 
   // Enable moving
-  Buffer(Buffer&& other) noexcept : buffer_(other.buffer_) {
+  Buffer(Buffer&& other) noexcept
+      : buffer_(other.buffer_),
+        owned_(other.owned_),
+        dirty_begin_(other.dirty_begin_),
+        dirty_end_(other.dirty_end_) {
     other.buffer_ = nullptr;
   }
 
   Buffer& operator=(Buffer&& other) noexcept {
     if (this != &other) {
-      if (buffer_) {
-        accel_free_buffer(buffer_);
-      }
+      Release();
       buffer_ = other.buffer_;
+      owned_ = other.owned_;
+      dirty_begin_ = other.dirty_begin_;
+      dirty_end_ = other.dirty_end_;
       other.buffer_ = nullptr;
     }
     return *this;
   }
 
+  /**
+   * @brief Scope guard keeping a buffer at its current address
+   */
+  class PinGuard {
+   public:
+    explicit PinGuard(const Buffer& buffer) : buffer_(buffer) { buffer_.Pin(); }
+    ~PinGuard() { buffer_.Unpin(); }
+    PinGuard(const PinGuard&) = delete;
+    PinGuard& operator=(const PinGuard&) = delete;
+
+   private:
+    const Buffer& buffer_;
+  };
+
+  /**
+   * @brief Exclude the buffer from memory compaction
+   *
+   * Pins nest; each Pin() needs one Unpin().
+   *
+   * @throws std::runtime_error if the driver rejects the pin
+   */
+  void Pin() const {
+    if (accel_buffer_pin(buffer_) != ACCEL_STATUS_OK) {
+      throw std::runtime_error("Failed to pin buffer: " +
+                               std::string(accel_get_error()));
+    }
+  }
+
+  /** @brief Release one pin taken with Pin() */
+  void Unpin() const noexcept { accel_buffer_unpin(buffer_); }
+
   /**
    * @brief Get raw pointer to host memory
-   * @return Pointer to host memory
+   * @return Pointer to host memory, stable while the buffer is pinned
    */
   void* data() const { return buffer_->host_addr; }
 
@@ -73,9 +132,162 @@ class Buffer {
    */
   size_t size() const { return buffer_->size; }
 
+  /**
+   * @brief Check whether the buffer owns its device memory
+   * @return false for buffers created with Import()
+   */
+  bool owned() const { return owned_; }
+
+  /**
+   * @brief Copy host data into the buffer and mark the range dirty
+   * @param src Source data
+   * @param size Number of bytes
+   * @param offset Destination offset in bytes
+   * @throws std::out_of_range if the range exceeds the buffer
+   */
+  void Write(const void* src, size_t size, size_t offset = 0) {
+    CheckRange(offset, size);
+    PinGuard pin(*this);
+    std::memcpy(static_cast<char*>(data()) + offset, src, size);
+    MarkDirty(offset, size);
+  }
+
+  /**
+   * @brief Stream host data into the buffer
+   *
+   * Large transfers use non-temporal stores, so the data does not displace
+   * the host's working set from the cache, and are split across threads.
+   * ISA selection happens at run time.
+   *
+   * @param src Source data
+   * @param size Number of bytes
+   * @param offset Destination offset in bytes
+   * @throws std::out_of_range if the range exceeds the buffer
+   */
+  void Upload(const void* src, size_t size, size_t offset = 0) {
+    CheckRange(offset, size);
+    PinGuard pin(*this);
+    if (!detail::CopyToDevice(static_cast<char*>(data()) + offset, src,
+                              size)) {
+      MarkDirty(offset, size);  // Went through the cache
+    }
+  }
+
+  /**
+   * @brief Stream buffer contents to host memory
+   *
+   * Syncs the range for the CPU, then copies it, split across threads for
+   * large transfers.
+   *
+   * @param dst Destination
+   * @param size Number of bytes
+   * @param offset Source offset in bytes
+   * @throws std::out_of_range if the range exceeds the buffer
+   */
+  void Download(void* dst, size_t size, size_t offset = 0) const {
+    CheckRange(offset, size);
+    if (size == 0) {
+      return;
+    }
+    PinGuard pin(*this);
+    SyncForCpu(offset, size);
+    detail::CopyFromDevice(dst, static_cast<const char*>(data()) + offset,
+                           size);
+  }
+
+  /**
+   * @brief Record a host write made through data()
+   * @param offset Start of written range in bytes
+   * @param size Size of written range in bytes (0 for the rest)
+   */
+  void MarkDirty(size_t offset = 0, size_t size = 0) {
+    size_t end = size ? std::min(offset + size, this->size()) : this->size();
+    if (offset >= end) {
+      return;
+    }
+    if (dirty_begin_ >= dirty_end_) {
+      dirty_begin_ = offset;
+      dirty_end_ = end;
+    } else {
+      dirty_begin_ = std::min(dirty_begin_, offset);
+      dirty_end_ = std::max(dirty_end_, end);
+    }
+  }
+
+  /** @return true if host writes have not been flushed to the device */
+  bool dirty() const { return dirty_begin_ < dirty_end_; }
+
+  /**
+   * @brief Publish the dirty range to the device
+   *
+   * Called by Runtime and Stream before an op reads the buffer.
+   *
+   * @throws std::runtime_error if the driver rejects the sync
+   */
+  void Flush() const {
+    if (!dirty()) {
+      return;
+    }
+    SyncForDevice(dirty_begin_, dirty_end_ - dirty_begin_);
+    dirty_begin_ = dirty_end_ = 0;
+  }
+
+  /**
+   * @brief Make host writes to a range visible to the device
+   * @param offset Start of range in bytes
+   * @param size Size of range in bytes (0 for the rest)
+   * @throws std::runtime_error if the driver rejects the sync
+   */
+  void SyncForDevice(size_t offset = 0, size_t size = 0) const {
+    if (accel_buffer_sync_for_device(buffer_, offset, size) !=
+        ACCEL_STATUS_OK) {
+      throw std::runtime_error("Failed to sync buffer for device: " +
+                               std::string(accel_get_error()));
+    }
+  }
+
+  /**
+   * @brief Make device writes to a range visible to the host
+   * @param offset Start of range in bytes
+   * @param size Size of range in bytes (0 for the rest)
+   * @throws std::runtime_error if the driver rejects the sync
+   */
+  void SyncForCpu(size_t offset = 0, size_t size = 0) const {
+    if (accel_buffer_sync_for_cpu(buffer_, offset, size) != ACCEL_STATUS_OK) {
+      throw std::runtime_error("Failed to sync buffer for CPU: " +
+                               std::string(accel_get_error()));
+    }
+  }
+
  private:
+  Buffer(accel_buffer_t* buffer, bool owned)
+      : buffer_(buffer), owned_(owned) {}
+
+  void CheckRange(size_t offset, size_t size) const {
+    if (offset > this->size() || size > this->size() - offset) {
+      throw std::out_of_range("Buffer range out of bounds");
+    }
+  }
+
+  void Release() {
+    if (!buffer_) {
+      return;
+    }
+    if (owned_) {
+      accel_free_buffer(buffer_);
+    } else {
+      accel_release_buffer(buffer_);
+    }
+  }
+
   accel_buffer_t* buffer_;
+  bool owned_ = true;
+  mutable size_t dirty_begin_ = 0;  // Host-written range not yet flushed
+  mutable size_t dirty_end_ = 0;
+  friend class DeviceTensor;
   friend class Runtime;
+  friend class Stream;
+  friend class Tenant;
 };
 
 }  // namespace accel
\ No newline at end of file
@@ -0,0 +1,247 @@
+/**
+ * @file copy.hpp
+ * @author Leo (zhsleo@outlook.com)
+ *
+ * @brief Non-temporal, multi-threaded copies between host and device memory
+ * @version 1.0.0
+ * @date 2026-10-18
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <thread>
+#include <vector>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define ACCEL_COPY_X86 1
+#endif
+
+namespace accel {
+
+namespace detail {
+
+/**
+ * @brief Instruction set used by the non-temporal store kernels
+ */
+enum class CopyIsa { kScalar, kSse, kAvx2, kAvx512 };
+
+/** @brief Transfers below twice this size are copied by a single thread */
+constexpr size_t kCopyChunkBytes = 1 << 20;
+
+/** @brief Uploads from this size on use non-temporal stores */
+constexpr size_t kNonTemporalBytes = 4 << 20;
+
+/** @brief Upper bound on copy threads; a few cores saturate memory */
+constexpr unsigned kMaxCopyThreads = 8;
+
+/**
+ * @brief Detect the best copy ISA of the running CPU
+ * @return Widest supported instruction set
+ */
+inline CopyIsa DetectCopyIsa() {
+#ifdef ACCEL_COPY_X86
+  __builtin_cpu_init();
+  if (__builtin_cpu_supports("avx512f")) {
+    return CopyIsa::kAvx512;
+  }
+  if (__builtin_cpu_supports("avx2")) {
+    return CopyIsa::kAvx2;
+  }
+  if (__builtin_cpu_supports("sse4.1")) {
+    return CopyIsa::kSse;
+  }
+#endif
+  return CopyIsa::kScalar;
+}
+
+/** @return Copy ISA selected once per process */
+inline CopyIsa ActiveCopyIsa() {
+  static const CopyIsa isa = DetectCopyIsa();
+  return isa;
+}
+
+/** @return Printable name of a copy ISA */
+inline const char* CopyIsaName(CopyIsa isa) {
+  switch (isa) {
+    case CopyIsa::kSse:
+      return "sse4.1";
+    case CopyIsa::kAvx2:
+      return "avx2";
+    case CopyIsa::kAvx512:
+      return "avx512";
+    case CopyIsa::kScalar:
+      break;
+  }
+  return "scalar";
+}
+
+#ifdef ACCEL_COPY_X86
+// Kernels copy whole 64-byte lines to a line-aligned destination
+
+__attribute__((target("sse4.1"))) inline void StoreLinesSse(
+    char* dst, const char* src, size_t size) {
+  for (size_t i = 0; i < size; i += 64) {
+    auto* s = reinterpret_cast<const __m128i*>(src + i);
+    auto* d = reinterpret_cast<__m128i*>(dst + i);
+    __m128i a = _mm_loadu_si128(s);
+    __m128i b = _mm_loadu_si128(s + 1);
+    __m128i c = _mm_loadu_si128(s + 2);
+    __m128i e = _mm_loadu_si128(s + 3);
+    _mm_stream_si128(d, a);
+    _mm_stream_si128(d + 1, b);
+    _mm_stream_si128(d + 2, c);
+    _mm_stream_si128(d + 3, e);
+  }
+}
+
+__attribute__((target("avx2"))) inline void StoreLinesAvx2(char* dst,
+                                                           const char* src,
+                                                           size_t size) {
+  for (size_t i = 0; i < size; i += 64) {
+    __m256i a = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + i));
+    __m256i b =
+        _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + i + 32));
+    _mm256_stream_si256(reinterpret_cast<__m256i*>(dst + i), a);
+    _mm256_stream_si256(reinterpret_cast<__m256i*>(dst + i + 32), b);
+  }
+}
+
+__attribute__((target("avx512f"))) inline void StoreLinesAvx512(
+    char* dst, const char* src, size_t size) {
+  for (size_t i = 0; i < size; i += 64) {
+    __m512i a = _mm512_loadu_si512(src + i);
+    _mm512_stream_si512(reinterpret_cast<__m512i*>(dst + i), a);
+  }
+}
+
+#endif
+
+/**
+ * @brief Copy one chunk with non-temporal stores
+ *
+ * Unaligned head and tail bytes are copied with memcpy and their lines
+ * flushed, so none of the destination is left in the cache.
+ *
+ * @param dst Destination
+ * @param src Source
+ * @param size Number of bytes
+ * @param isa Kernel instruction set, kScalar for a plain memcpy
+ */
+inline void StreamChunk(char* dst, const char* src, size_t size, CopyIsa isa) {
+#ifdef ACCEL_COPY_X86
+  if (isa != CopyIsa::kScalar) {
+    size_t head = (64 - reinterpret_cast<uintptr_t>(dst) % 64) % 64;
+    head = std::min(head, size);
+    std::memcpy(dst, src, head);
+    if (head > 0) {
+      _mm_clflush(dst);
+    }
+    dst += head;
+    src += head;
+    size -= head;
+
+    size_t body = size & ~size_t(63);
+    switch (isa) {
+      case CopyIsa::kSse:
+        StoreLinesSse(dst, src, body);
+        break;
+      case CopyIsa::kAvx2:
+        StoreLinesAvx2(dst, src, body);
+        break;
+      default:
+        StoreLinesAvx512(dst, src, body);
+        break;
+    }
+    if (size > body) {
+      std::memcpy(dst + body, src + body, size - body);
+      _mm_clflush(dst + body);
+    }
+    // Order streaming stores and flushes before later plain stores
+    _mm_mfence();
+    return;
+  }
+#endif
+  (void)isa;
+  std::memcpy(dst, src, size);
+}
+
+/**
+ * @brief Copy split across threads for large transfers
+ * @param dst Destination
+ * @param src Source
+ * @param size Number of bytes
+ * @param isa Kernel instruction set, see StreamChunk()
+ * @param max_threads Thread limit, including the caller
+ */
+inline void StreamCopy(void* dst, const void* src, size_t size, CopyIsa isa,
+                       unsigned max_threads) {
+  auto* d = static_cast<char*>(dst);
+  auto* s = static_cast<const char*>(src);
+  size_t threads = std::min<size_t>(max_threads, size / kCopyChunkBytes);
+  if (threads <= 1) {
+    StreamChunk(d, s, size, isa);
+    return;
+  }
+
+  // Chunk boundaries on cache lines so only the ends need head/tail copies
+  size_t chunk = (size / threads + 63) & ~size_t(63);
+  std::vector<std::thread> workers;
+  workers.reserve(threads - 1);
+  for (size_t begin = chunk; begin < size; begin += chunk) {
+    size_t length = std::min(chunk, size - begin);
+    workers.emplace_back(StreamChunk, d + begin, s + begin, length, isa);
+  }
+  StreamChunk(d, s, std::min(chunk, size), isa);
+  for (auto& worker : workers) {
+    worker.join();
+  }
+}
+
+/** @return Default number of copy threads */
+inline unsigned DefaultCopyThreads() {
+  unsigned hw = std::thread::hardware_concurrency();
+  return std::max(1u, std::min(hw, kMaxCopyThreads));
+}
+
+/**
+ * @brief Copy host data into device memory bypassing the CPU cache
+ *
+ * Transfers smaller than kNonTemporalBytes stay cache resident and are
+ * faster with plain stores, so they are copied with memcpy.
+ *
+ * @param dst Destination in device memory
+ * @param src Host source
+ * @param size Number of bytes
+ * @return true if the data bypassed the cache, false if it went through
+ *         cached stores and still needs a write-back
+ */
+inline bool CopyToDevice(void* dst, const void* src, size_t size) {
+  CopyIsa isa =
+      size >= kNonTemporalBytes ? ActiveCopyIsa() : CopyIsa::kScalar;
+  StreamCopy(dst, src, size, isa, DefaultCopyThreads());
+  return isa != CopyIsa::kScalar;
+}
+
+/**
+ * @brief Copy device memory to the host
+ *
+ * The host reads the result next, so the destination is written through
+ * the cache; only the chunking across threads applies. Streaming loads
+ * (movntdqa) help on write-combining memory only and measured slower than
+ * memcpy on cacheable mappings.
+ *
+ * @param dst Host destination
+ * @param src Source in device memory
+ * @param size Number of bytes
+ */
+inline void CopyFromDevice(void* dst, const void* src, size_t size) {
+  StreamCopy(dst, src, size, CopyIsa::kScalar, DefaultCopyThreads());
+}
+
+}  // namespace detail
+
+}  // namespace accel
@@ -0,0 +1,347 @@
+/**
+ * @file coro.hpp
+ * @author Leo (zhsleo@outlook.com)
+ *
+ * @brief C++20 coroutine support for asynchronous accelerator operations
+ * @version 1.0.0
+ * @date 2026-10-18
+ */
+
+#pragma once
+
+#if defined(__cpp_impl_coroutine) && __has_include(<coroutine>)
+#define ACCEL_HAS_COROUTINES 1
+
+#include <chrono>
+#include <condition_variable>
+#include <coroutine>
+#include <deque>
+#include <exception>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <utility>
+
+#include "types.hpp"
+
+namespace accel {
+
+namespace detail {
+
+/**
+ * @brief Thread that resumes coroutines whose accelerator op completed
+ *
+ * Driver completion callbacks run on the dispatcher thread and must not
+ * block, so they only post the coroutine handle here; the reactor thread
+ * then resumes it. Everything a coroutine does up to its next suspension
+ * point therefore runs on the reactor thread.
+ *
+ * Ops that found the driver queue full are parked here and resubmitted in
+ * arrival order whenever a completion comes in. A slot can also be freed by
+ * an op that was not submitted through the reactor, so while anything is
+ * parked the reactor retries every millisecond as well.
+ */
+class CompletionReactor {
+ public:
+  /**
+   * @brief Resubmits a parked op
+   *
+   * Returns false if the queue is still full, true once the op is queued or
+   * its coroutine has been posted with the error.
+   */
+  using Resubmit = bool (*)(void* op);
+
+  CompletionReactor() : thread_([this] { Run(); }) {}
+
+  /** @brief Resumes everything already posted or parked, then stops */
+  ~CompletionReactor() {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      stop_ = true;
+    }
+    cv_.notify_one();
+    thread_.join();
+  }
+
+  CompletionReactor(const CompletionReactor&) = delete;
+  CompletionReactor& operator=(const CompletionReactor&) = delete;
+
+  /**
+   * @brief Queue a coroutine for resumption on the reactor thread
+   * @param handle Suspended coroutine
+   */
+  void Post(std::coroutine_handle<> handle) {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      ready_.push_back(handle);
+    }
+    cv_.notify_one();
+  }
+
+  /**
+   * @brief Queue an op the driver had no room for
+   * @param resubmit Called on the reactor thread to submit it again
+   * @param op Argument of resubmit
+   */
+  void Park(Resubmit resubmit, void* op) {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      parked_.push_back({resubmit, op});
+    }
+    cv_.notify_one();
+  }
+
+ private:
+  struct Parked {
+    Resubmit resubmit;
+    void* op;
+  };
+
+  static constexpr std::chrono::milliseconds kRetry{1};
+
+  void Run() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    auto runnable = [this] {
+      return !ready_.empty() || (stop_ && parked_.empty());
+    };
+    for (;;) {
+      if (parked_.empty()) {
+        cv_.wait(lock, runnable);
+      } else {
+        cv_.wait_for(lock, kRetry, runnable);
+      }
+      if (ready_.empty() && parked_.empty()) {
+        return;  // Stop requested and nothing left to resume
+      }
+      if (!ready_.empty()) {
+        std::coroutine_handle<> handle = ready_.front();
+        ready_.pop_front();
+        lock.unlock();
+        handle.resume();
+        lock.lock();
+      }
+      ResubmitParked(lock);
+    }
+  }
+
+  /** @brief Resubmit parked ops in order until the queue is full again */
+  void ResubmitParked(std::unique_lock<std::mutex>& lock) {
+    // Only this thread removes entries, so the front stays put meanwhile
+    while (!parked_.empty()) {
+      const Parked parked = parked_.front();
+      lock.unlock();
+      const bool queued = parked.resubmit(parked.op);
+      lock.lock();
+      if (!queued) {
+        return;
+      }
+      parked_.pop_front();
+    }
+  }
+
+  std::mutex mutex_;
+  std::condition_variable cv_;
+  std::deque<std::coroutine_handle<>> ready_;
+  std::deque<Parked> parked_;
+  bool stop_ = false;
+  std::thread thread_;
+};
+
+}  // namespace detail
+
+/**
+ * @brief Awaitable accelerator operation
+ *
+ * The op is submitted when the awaiting coroutine suspends; the coroutine is
+ * resumed on the runtime's completion reactor thread once the op completes,
+ * with the output already synced for the CPU. If the driver queue is full
+ * the op waits on the reactor for a free slot, so any number of coroutines
+ * may await at once. Buffers must stay alive until the co_await expression
+ * returns.
+ */
+class OpAwaitable {
+ public:
+  OpAwaitable(detail::CompletionReactor& reactor,
+              const accel_op_params_t& params)
+      : reactor_(&reactor), params_(params) {}
+
+  bool await_ready() const noexcept { return false; }
+
+  /**
+   * @brief Submit the op, or park it until the queue has room; resume
+   *        immediately if submission fails
+   * @param handle Awaiting coroutine
+   * @return false to continue without suspending
+   */
+  bool await_suspend(std::coroutine_handle<> handle) {
+    handle_ = handle;
+    submitted_ = true;
+    accel_status_t status =
+        accel_submit_op_notify(&params_, &OnComplete, this, nullptr);
+    if (status == ACCEL_STATUS_BUSY) {
+      reactor_->Park(&Resubmit, this);
+      return true;
+    }
+    if (status != ACCEL_STATUS_OK) {
+      submitted_ = false;
+      status_ = status;
+      return false;
+    }
+    // The op may already have completed and resumed the coroutine on the
+    // reactor thread, so this object must not be touched from here on
+    return true;
+  }
+
+  /**
+   * @brief Report the op result to the coroutine
+   * @throws std::runtime_error if submission or execution failed
+   */
+  void await_resume() const {
+    if (status_ != ACCEL_STATUS_OK) {
+      throw std::runtime_error(
+          std::string(submitted_ ? "Operation failed: "
+                                 : "Failed to submit operation: ") +
+          accel_get_error());
+    }
+  }
+
+ private:
+  /** @brief Submit a parked op again, on the reactor thread */
+  static bool Resubmit(void* op) {
+    auto* self = static_cast<OpAwaitable*>(op);
+    accel_status_t status =
+        accel_submit_op_notify(&self->params_, &OnComplete, self, nullptr);
+    if (status == ACCEL_STATUS_BUSY) {
+      return false;
+    }
+    if (status != ACCEL_STATUS_OK) {
+      self->submitted_ = false;
+      self->status_ = status;
+      self->reactor_->Post(self->handle_);
+    }
+    return true;
+  }
+
+  static void OnComplete(accel_op_handle_t /*handle*/, accel_status_t status,
+                         void* user_data) {
+    auto* self = static_cast<OpAwaitable*>(user_data);
+    if (status == ACCEL_STATUS_OK) {
+      status = accel_buffer_sync_for_cpu(&self->params_.output, 0, 0);
+    }
+    self->status_ = status;
+    self->reactor_->Post(self->handle_);
+  }
+
+  detail::CompletionReactor* reactor_;
+  accel_op_params_t params_;
+  std::coroutine_handle<> handle_;
+  accel_status_t status_ = ACCEL_STATUS_OK;
+  bool submitted_ = false;
+};
+
+/**
+ * @brief Minimal eagerly started coroutine task
+ *
+ * Starts running on construction, can be awaited by another coroutine or
+ * waited for from a plain thread with Wait(). Exceptions propagate to the
+ * awaiter.
+ */
+class Task {
+ public:
+  struct promise_type {
+    std::mutex mutex;
+    std::condition_variable cv;
+    bool done = false;
+    std::exception_ptr error;
+    std::coroutine_handle<> continuation;
+
+    Task get_return_object() {
+      return Task(std::coroutine_handle<promise_type>::from_promise(*this));
+    }
+    std::suspend_never initial_suspend() noexcept { return {}; }
+
+    /** @brief Hand control to the awaiter, if any, when finished */
+    struct FinalAwaiter {
+      bool await_ready() noexcept { return false; }
+      std::coroutine_handle<> await_suspend(
+          std::coroutine_handle<promise_type> handle) noexcept {
+        promise_type& promise = handle.promise();
+        std::coroutine_handle<> next = std::noop_coroutine();
+        // Notify under the lock: a waiter may destroy the frame as soon as
+        // it can observe done
+        std::lock_guard<std::mutex> lock(promise.mutex);
+        promise.done = true;
+        if (promise.continuation) {
+          next = promise.continuation;
+        }
+        promise.cv.notify_all();
+        return next;
+      }
+      void await_resume() noexcept {}
+    };
+
+    FinalAwaiter final_suspend() noexcept { return {}; }
+    void return_void() {}
+    void unhandled_exception() { error = std::current_exception(); }
+  };
+
+  Task(Task&& other) noexcept : handle_(std::exchange(other.handle_, {})) {}
+  Task(const Task&) = delete;
+  Task& operator=(const Task&) = delete;
+  Task& operator=(Task&&) = delete;
+
+  /** @brief Destroying an unfinished task waits for it */
+  ~Task() {
+    if (handle_) {
+      WaitDone();
+      handle_.destroy();
+    }
+  }
+
+  /**
+   * @brief Block the calling thread until the task has finished
+   * @throws Any exception escaping the coroutine body
+   */
+  void Wait() {
+    WaitDone();
+    if (handle_.promise().error) {
+      std::rethrow_exception(handle_.promise().error);
+    }
+  }
+
+  bool await_ready() noexcept {
+    std::lock_guard<std::mutex> lock(handle_.promise().mutex);
+    return handle_.promise().done;
+  }
+
+  bool await_suspend(std::coroutine_handle<> awaiter) noexcept {
+    std::lock_guard<std::mutex> lock(handle_.promise().mutex);
+    if (handle_.promise().done) {
+      return false;
+    }
+    handle_.promise().continuation = awaiter;
+    return true;
+  }
+
+  void await_resume() {
+    if (handle_.promise().error) {
+      std::rethrow_exception(handle_.promise().error);
+    }
+  }
+
+ private:
+  explicit Task(std::coroutine_handle<promise_type> handle) : handle_(handle) {}
+
+  void WaitDone() {
+    promise_type& promise = handle_.promise();
+    std::unique_lock<std::mutex> lock(promise.mutex);
+    promise.cv.wait(lock, [&] { return promise.done; });
+  }
+
+  std::coroutine_handle<promise_type> handle_;
+};
+
+}  // namespace accel
+
+#endif  // __cpp_impl_coroutine
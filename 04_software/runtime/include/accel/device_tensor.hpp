@@ -0,0 +1,400 @@
+/**
+ * @file device_tensor.hpp
+ * @author Leo (zhsleo@outlook.com)
+ *
+ * @brief Typed tensor living in accelerator memory
+ * @version 1.0.0
+ * @date 2026-10-18
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <numeric>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "buffer.hpp"
+#include "copy.hpp"
+#include "stream.hpp"
+
+namespace accel {
+
+/**
+ * @brief Element type of a device tensor
+ */
+enum class DType { kInt8, kInt32, kFloat32 };
+
+/**
+ * @brief Memory layout of a device tensor
+ */
+enum class Layout { kRowMajor, kNCHW, kNHWC };
+
+/**
+ * @brief Get element size of a data type
+ * @param dtype Data type
+ * @return Size in bytes
+ */
+inline size_t DTypeSize(DType dtype) {
+  switch (dtype) {
+    case DType::kInt8:
+      return 1;
+    case DType::kInt32:
+    case DType::kFloat32:
+      return 4;
+  }
+  return 0;
+}
+
+/** @brief Maps a C++ element type to its DType */
+template <typename T>
+struct DTypeOf;
+
+template <>
+struct DTypeOf<int8_t> {
+  static constexpr DType value = DType::kInt8;
+};
+
+template <>
+struct DTypeOf<int32_t> {
+  static constexpr DType value = DType::kInt32;
+};
+
+template <>
+struct DTypeOf<float> {
+  static constexpr DType value = DType::kFloat32;
+};
+
+/**
+ * @brief Tensor whose storage is an accelerator buffer
+ *
+ * Carries the shape, layout, element type and quantization scale alongside
+ * the device buffer so that operator code does not have to track them
+ * separately. Host tensors are any type exposing data(), shape() returning
+ * dimension sizes, scale(), set_scale() and resize() — qnn::Tensor fits.
+ *
+ * Copies queued on a stream share ownership of the device buffer, so the
+ * tensor may be destroyed before they run.
+ */
+class DeviceTensor {
+ public:
+  /**
+   * @brief Allocates an uninitialized device tensor
+   * @param shape Dimension sizes
+   * @param dtype Element type
+   * @param layout Memory layout
+   * @param scale Quantization scale
+   * @throws std::runtime_error if allocation fails
+   */
+  DeviceTensor(std::vector<size_t> shape, DType dtype,
+               Layout layout = Layout::kRowMajor, float scale = 1.0f)
+      : buffer_(std::make_shared<Buffer>(ByteSize(shape, dtype))),
+        shape_(std::move(shape)),
+        dtype_(dtype),
+        layout_(layout),
+        scale_(scale) {}
+
+  DeviceTensor(const DeviceTensor&) = delete;
+  DeviceTensor& operator=(const DeviceTensor&) = delete;
+  DeviceTensor(DeviceTensor&&) = default;
+  DeviceTensor& operator=(DeviceTensor&&) = default;
+
+  /**
+   * @brief Allocates a device tensor matching a host tensor and uploads it
+   * @param host Host tensor
+   * @param layout Memory layout of the host data
+   * @return Device tensor holding a copy of the host data
+   */
+  template <typename HostTensor>
+  static DeviceTensor FromHost(const HostTensor& host,
+                               Layout layout = Layout::kRowMajor) {
+    using T = HostElement<HostTensor>;
+    DeviceTensor tensor(ToSizes(host.shape()), DTypeOf<T>::value, layout,
+                        host.scale());
+    tensor.Upload(host);
+    return tensor;
+  }
+
+  /**
+   * @brief Views host memory as a device tensor without copying
+   *
+   * Only memory inside the mapped device region can be aliased, e.g. a
+   * slice of another Buffer. The memory must outlive the tensor.
+   *
+   * @param host_ptr Start of the tensor data
+   * @param shape Dimension sizes
+   * @param dtype Element type
+   * @param layout Memory layout
+   * @param scale Quantization scale
+   * @return Non-owning device tensor
+   * @throws std::runtime_error if host_ptr is not in device memory
+   */
+  static DeviceTensor Alias(void* host_ptr, std::vector<size_t> shape,
+                            DType dtype, Layout layout = Layout::kRowMajor,
+                            float scale = 1.0f) {
+    Buffer buffer = Buffer::Import(host_ptr, ByteSize(shape, dtype));
+    return DeviceTensor(std::move(buffer), std::move(shape), dtype, layout,
+                        scale);
+  }
+
+  /**
+   * @brief Copy host data into the device tensor
+   * @param host Host tensor with matching shape and element type
+   * @throws std::invalid_argument on shape or type mismatch
+   */
+  template <typename HostTensor>
+  void Upload(const HostTensor& host) {
+    CheckCompatible(host);
+    scale_ = host.scale();
+    if (host.data() != buffer_->data()) {
+      buffer_->Upload(host.data(), nbytes());
+    } else {
+      buffer_->MarkDirty(0, nbytes());
+    }
+  }
+
+  /**
+   * @brief Copy the device tensor into a host tensor
+   *
+   * The host tensor is resized to this tensor's shape and takes its scale.
+   *
+   * @param host Host tensor with matching element type
+   * @throws std::invalid_argument on type mismatch
+   */
+  template <typename HostTensor>
+  void Download(HostTensor& host) const {
+    using T = HostElement<HostTensor>;
+    CheckDType(DTypeOf<T>::value);
+    host.resize(shape_);
+    host.set_scale(scale_);
+    if (host.data() != buffer_->data()) {
+      buffer_->Download(host.data(), nbytes());
+    } else {
+      buffer_->SyncForCpu(0, nbytes());
+    }
+  }
+
+  /**
+   * @brief Copy host data into the device tensor in stream order
+   *
+   * The copy runs once all work previously enqueued on @p stream has
+   * retired. The host tensor must stay alive and unmodified until then;
+   * pass a shared_ptr to have the stream keep it alive instead.
+   *
+   * @param host Host tensor with matching shape and element type
+   * @param stream Stream to order the copy on
+   */
+  template <typename HostTensor>
+  void UploadAsync(const HostTensor& host, Stream& stream) {
+    CheckCompatible(host);
+    scale_ = host.scale();
+    EnqueueUpload(host.data(), nullptr, stream);
+  }
+
+  /**
+   * @brief Copy host data into the device tensor in stream order, keeping
+   * the host tensor alive until the copy has run
+   *
+   * @param host Host tensor with matching shape and element type; must not
+   * be modified until the copy has run
+   * @param stream Stream to order the copy on
+   */
+  template <typename HostTensor>
+  void UploadAsync(std::shared_ptr<HostTensor> host, Stream& stream) {
+    CheckCompatible(*host);
+    scale_ = host->scale();
+    const void* src = host->data();
+    EnqueueUpload(src, std::move(host), stream);
+  }
+
+  /**
+   * @brief Copy the device tensor into a host tensor in stream order
+   *
+   * The host tensor is resized immediately; its contents are valid once
+   * the stream has been synchronized past this call. It must stay alive
+   * until then; pass a shared_ptr to have the stream keep it alive instead.
+   *
+   * @param host Host tensor with matching element type
+   * @param stream Stream to order the copy on
+   */
+  template <typename HostTensor>
+  void DownloadAsync(HostTensor& host, Stream& stream) const {
+    using T = HostElement<HostTensor>;
+    CheckDType(DTypeOf<T>::value);
+    host.resize(shape_);
+    host.set_scale(scale_);
+    EnqueueDownload(host.data(), nullptr, stream);
+  }
+
+  /**
+   * @brief Copy the device tensor into a host tensor in stream order,
+   * keeping the host tensor alive until the copy has run
+   *
+   * @param host Host tensor with matching element type
+   * @param stream Stream to order the copy on
+   */
+  template <typename HostTensor>
+  void DownloadAsync(std::shared_ptr<HostTensor> host, Stream& stream) const {
+    using T = HostElement<HostTensor>;
+    CheckDType(DTypeOf<T>::value);
+    host->resize(shape_);
+    host->set_scale(scale_);
+    void* dst = host->data();
+    EnqueueDownload(dst, std::move(host), stream);
+  }
+
+  /**
+   * @brief Typed pointer to the tensor data
+   * @tparam T Element type, must match dtype()
+   * @return Pointer to host mapping of the device memory
+   */
+  template <typename T>
+  T* data() const {
+    CheckDType(DTypeOf<T>::value);
+    return static_cast<T*>(buffer_->data());
+  }
+
+  /** @return Dimension sizes */
+  const std::vector<size_t>& shape() const { return shape_; }
+
+  /** @return Element type */
+  DType dtype() const { return dtype_; }
+
+  /** @return Memory layout */
+  Layout layout() const { return layout_; }
+
+  /** @return Quantization scale */
+  float scale() const { return scale_; }
+
+  /** @param scale Quantization scale */
+  void set_scale(float scale) { scale_ = scale; }
+
+  /** @return Number of elements */
+  size_t numel() const { return NumElements(shape_); }
+
+  /** @return Size of the tensor data in bytes */
+  size_t nbytes() const { return numel() * DTypeSize(dtype_); }
+
+  /** @return true if the tensor aliases memory it does not own */
+  bool is_alias() const { return !buffer_->owned(); }
+
+  /** @return Underlying device buffer, for passing to Runtime or Stream */
+  const Buffer& buffer() const { return *buffer_; }
+
+  /** @return Underlying device buffer, e.g. to MarkDirty() host writes */
+  Buffer& buffer() { return *buffer_; }
+
+ private:
+  template <typename HostTensor>
+  using HostElement = std::remove_const_t<std::remove_pointer_t<
+      decltype(std::declval<const HostTensor&>().data())>>;
+
+  DeviceTensor(Buffer buffer, std::vector<size_t> shape, DType dtype,
+               Layout layout, float scale)
+      : buffer_(std::make_shared<Buffer>(std::move(buffer))),
+        shape_(std::move(shape)),
+        dtype_(dtype),
+        layout_(layout),
+        scale_(scale) {}
+
+  /**
+   * @brief Queue a copy from host memory into the buffer
+   *
+   * The callback holds a reference to the buffer, which stays pinned until
+   * the copy has run, and to @p keep.
+   */
+  void EnqueueUpload(const void* src, std::shared_ptr<const void> keep,
+                     Stream& stream) {
+    std::shared_ptr<Buffer> buffer = buffer_;
+    const size_t bytes = nbytes();
+    // Compaction must not move the buffer before the copy has run
+    buffer->Pin();
+    try {
+      stream.AddCallback([buffer, src, bytes,
+                          keep = std::move(keep)](accel_status_t status) {
+        // Later ops on the stream were flushed at enqueue time, before
+        // this copy ran, so publish it here
+        accel_buffer_t* device = buffer->buffer_;
+        if (status == ACCEL_STATUS_OK &&
+            (device->host_addr == src ||
+             !detail::CopyToDevice(device->host_addr, src, bytes))) {
+          accel_buffer_sync_for_device(device, 0, bytes);
+        }
+        buffer->Unpin();
+      });
+    } catch (...) {
+      buffer->Unpin();
+      throw;
+    }
+  }
+
+  /** @brief Queue a copy from the buffer into host memory */
+  void EnqueueDownload(void* dst, std::shared_ptr<void> keep,
+                       Stream& stream) const {
+    std::shared_ptr<Buffer> buffer = buffer_;
+    const size_t bytes = nbytes();
+    buffer->Pin();
+    try {
+      stream.AddCallback([buffer, dst, bytes,
+                          keep = std::move(keep)](accel_status_t status) {
+        accel_buffer_t* device = buffer->buffer_;
+        if (status == ACCEL_STATUS_OK) {
+          accel_buffer_sync_for_cpu(device, 0, bytes);
+          if (device->host_addr != dst) {
+            detail::CopyFromDevice(dst, device->host_addr, bytes);
+          }
+        }
+        buffer->Unpin();
+      });
+    } catch (...) {
+      buffer->Unpin();
+      throw;
+    }
+  }
+
+  template <typename Dims>
+  static std::vector<size_t> ToSizes(const Dims& dims) {
+    return std::vector<size_t>(dims.begin(), dims.end());
+  }
+
+  static size_t NumElements(const std::vector<size_t>& shape) {
+    return std::accumulate(shape.begin(), shape.end(), size_t{1},
+                           std::multiplies<size_t>());
+  }
+
+  static size_t ByteSize(const std::vector<size_t>& shape, DType dtype) {
+    size_t bytes = NumElements(shape) * DTypeSize(dtype);
+    if (bytes == 0) {
+      throw std::invalid_argument("Empty device tensor");
+    }
+    return bytes;
+  }
+
+  void CheckDType(DType dtype) const {
+    if (dtype != dtype_) {
+      throw std::invalid_argument("Device tensor element type mismatch");
+    }
+  }
+
+  template <typename HostTensor>
+  void CheckCompatible(const HostTensor& host) const {
+    CheckDType(DTypeOf<HostElement<HostTensor>>::value);
+    if (ToSizes(host.shape()) != shape_) {
+      throw std::invalid_argument("Device tensor shape mismatch");
+    }
+  }
+
+  /** @brief Shared with copies still queued on streams */
+  std::shared_ptr<Buffer> buffer_;
+  std::vector<size_t> shape_;
+  DType dtype_;
+  Layout layout_;
+  float scale_;
+};
+
+}  // namespace accel
@@ -0,0 +1,202 @@
+/**
+ * @file host_arena.hpp
+ * @author Leo (zhsleo@outlook.com)
+ *
+ * @brief RAII wrapper for host activation arenas
+ * @version 1.0.0
+ * @date 2026-10-18
+ */
+
+#pragma once
+
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "accel.h"
+#include "types.hpp"
+
+namespace accel {
+
+/**
+ * @brief Host memory arena for activations and scratch buffers
+ *
+ * Allocations are bump-allocated and released together by Reset(), usually
+ * once per inference. With kPrefault and kHugePages2M/kHugePages1G the
+ * arena is faulted in and TLB-friendly before the first inference runs.
+ */
+class HostArena {
+ public:
+  /**
+   * @brief Map an arena
+   * @param size Capacity in bytes
+   * @param flags Page flags (kPrefault, kHugePages2M, kHugePages1G)
+   * @throws std::runtime_error if the mapping fails
+   */
+  explicit HostArena(size_t size, uint32_t flags = 0) {
+    arena_ = accel_arena_create(size, flags);
+    if (!arena_) {
+      throw std::runtime_error("Failed to create host arena: " +
+                               std::string(accel_get_error()));
+    }
+  }
+
+  ~HostArena() { accel_arena_destroy(arena_); }
+
+  // Disable copying
+  HostArena(const HostArena&) = delete;
+  HostArena& operator=(const HostArena&) = delete;
+
+  // Enable moving
+  HostArena(HostArena&& other) noexcept
+      : arena_(other.arena_), epoch_(other.epoch_) {
+    other.arena_ = nullptr;
+  }
+
+  HostArena& operator=(HostArena&& other) noexcept {
+    if (this != &other) {
+      accel_arena_destroy(arena_);
+      arena_ = other.arena_;
+      epoch_ = other.epoch_;
+      other.arena_ = nullptr;
+    }
+    return *this;
+  }
+
+  /**
+   * @brief Allocate raw bytes
+   * @param size Number of bytes
+   * @param align Alignment, a power of two (0 for a cache line)
+   * @return Pointer valid until Reset()
+   * @throws std::runtime_error if the arena is exhausted
+   */
+  void* Allocate(size_t size, size_t align = 0) {
+    void* ptr = accel_arena_alloc(arena_, size, align);
+    if (!ptr) {
+      throw std::runtime_error("Failed to allocate from host arena: " +
+                               std::string(accel_get_error()));
+    }
+    return ptr;
+  }
+
+  /**
+   * @brief Allocate an uninitialized array
+   * @param count Number of elements
+   * @return Pointer valid until Reset()
+   * @throws std::runtime_error if the arena is exhausted
+   */
+  template <typename T>
+  T* Allocate(size_t count) {
+    size_t align = alignof(T) > 64 ? alignof(T) : 0;
+    return static_cast<T*>(Allocate(count * sizeof(T), align));
+  }
+
+  /** @brief Release all allocations */
+  void Reset() {
+    accel_arena_reset(arena_);
+    epoch_++;
+  }
+
+  /** @return Number of Reset() calls, to tell whether a pointer is stale */
+  uint64_t epoch() const { return epoch_; }
+
+  /** @return Capacity in bytes */
+  size_t capacity() const { return accel_arena_capacity(arena_); }
+
+  /** @return Bytes allocated since the last Reset() */
+  size_t used() const { return accel_arena_used(arena_); }
+
+  /** @return Page size backing the arena */
+  size_t page_size() const { return accel_arena_page_size(arena_); }
+
+ private:
+  accel_arena_t* arena_;
+  uint64_t epoch_ = 0;
+};
+
+/**
+ * @brief Host activation tensor stored in a HostArena
+ *
+ * Fits the host tensor interface of DeviceTensor, so activations can be
+ * uploaded from and downloaded into the arena. resize() takes new storage
+ * from the arena when the tensor grows or the arena was reset since the
+ * storage was taken; the data is valid until the arena is reset, after which
+ * the tensor must be resized before use.
+ *
+ * @tparam T Element type
+ */
+template <typename T>
+class ArenaTensor {
+ public:
+  /**
+   * @param arena Arena providing the storage; must outlive the tensor
+   * @param shape Dimension sizes, empty for no storage yet
+   * @param scale Quantization scale
+   * @throws std::runtime_error if the arena is exhausted
+   */
+  explicit ArenaTensor(HostArena& arena, const std::vector<size_t>& shape = {},
+                       float scale = 1.0f)
+      : arena_(&arena), scale_(scale) {
+    if (!shape.empty()) {
+      resize(shape);
+    }
+  }
+
+  /**
+   * @brief Set the shape, allocating from the arena if it grows or its
+   *        storage was released by a Reset()
+   * @param shape Dimension sizes
+   * @throws std::runtime_error if the arena is exhausted
+   */
+  void resize(const std::vector<size_t>& shape) {
+    size_t count = 1;
+    for (size_t dim : shape) {
+      count *= dim;
+    }
+    if (count > capacity_ || epoch_ != arena_->epoch()) {
+      data_ = arena_->Allocate<T>(count);
+      capacity_ = count;
+      epoch_ = arena_->epoch();
+    }
+    shape_ = shape;
+  }
+
+  /** @brief Forget the storage, e.g. after the arena was reset */
+  void Release() {
+    data_ = nullptr;
+    capacity_ = 0;
+    shape_.clear();
+  }
+
+  /** @return Number of elements */
+  size_t size() const {
+    size_t count = 1;
+    for (size_t dim : shape_) {
+      count *= dim;
+    }
+    return shape_.empty() ? 0 : count;
+  }
+
+  /** @return Dimension sizes */
+  const std::vector<size_t>& shape() const { return shape_; }
+
+  T* data() { return data_; }
+  const T* data() const { return data_; }
+
+  /** @return Quantization scale */
+  float scale() const { return scale_; }
+
+  /** @param scale Quantization scale */
+  void set_scale(float scale) { scale_ = scale; }
+
+ private:
+  HostArena* arena_;
+  T* data_ = nullptr;
+  size_t capacity_ = 0;
+  /** @brief Arena epoch data_ was allocated in */
+  uint64_t epoch_ = 0;
+  std::vector<size_t> shape_;
+  float scale_;
+};
+
+}  // namespace accel
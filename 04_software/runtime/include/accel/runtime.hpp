@@ -9,9 +9,14 @@
 
 #pragma once
 
+#include <memory>
+#include <mutex>
 #include <string>
 
 #include "buffer.hpp"
+#include "coro.hpp"
+#include "stream.hpp"
+#include "tenant.hpp"
 #include "types.hpp"
 
 namespace accel {
@@ -23,11 +28,18 @@ class Runtime {
  public:
   /**
    * @brief Initialize runtime with device path
+   *
+   * With kCachedMapping, buffers written through data() must be marked with
+   * Buffer::MarkDirty() and results read after Buffer::SyncForCpu() unless
+   * they were produced by a Runtime or Stream op, which flush and
+   * invalidate automatically.
+   *
    * @param device_path Path to accelerator device
+   * @param init_flags Initialization flags (InitFlags)
    * @throws std::runtime_error if initialization fails
    */
-  explicit Runtime(const std::string& device_path) {
-    if (accel_init(device_path.c_str()) != ACCEL_STATUS_OK) {
+  explicit Runtime(const std::string& device_path, uint32_t init_flags = 0) {
+    if (accel_init_flags(device_path.c_str(), init_flags) != ACCEL_STATUS_OK) {
       throw std::runtime_error("Failed to initialize runtime: " +
                                std::string(accel_get_error()));
     }
@@ -39,7 +51,16 @@ class Runtime {
     }
   }
 
-  ~Runtime() { accel_cleanup(); }
+  ~Runtime() {
+    scheduler_.reset();  // Drains all streams before the driver goes away
+#ifdef ACCEL_HAS_COROUTINES
+    if (reactor_) {
+      accel_wait_complete(0);  // Let awaited ops resume their coroutines
+      reactor_.reset();
+    }
+#endif
+    accel_cleanup();
+  }
 
   // Disable copying
   Runtime(const Runtime&) = delete;
@@ -73,17 +94,14 @@ class Runtime {
    * @param input Input buffer
    * @param weights Weight buffer
    * @param output Output buffer
+   * @param priority Submission priority
    * @throws std::runtime_error if operation fails
    */
   void MatrixMultiply(const Buffer& input, const Buffer& weights,
-                      Buffer& output) {
-    accel_op_params_t params{};
-    params.op_type = ACCEL_OP_MATMUL;
-    params.input = *input.buffer_;
-    params.weights = *weights.buffer_;
-    params.output = *output.buffer_;
-
-    SubmitAndWait(params);
+                      Buffer& output, Priority priority = kPriorityNormal) {
+    SubmitAndWait(
+        MakeParams(ACCEL_OP_MATMUL, input, weights, output, priority));
+    output.SyncForCpu();
   }
 
   /**
@@ -91,38 +109,256 @@ class Runtime {
    * @param input Input buffer
    * @param weights Weight buffer
    * @param output Output buffer
+   * @param priority Submission priority
    * @throws std::runtime_error if operation fails
    */
   void Convolution2D(const Buffer& input, const Buffer& weights,
-                     Buffer& output) {
+                     Buffer& output, Priority priority = kPriorityNormal) {
+    SubmitAndWait(
+        MakeParams(ACCEL_OP_CONV2D, input, weights, output, priority));
+    output.SyncForCpu();
+  }
+
+#ifdef ACCEL_HAS_COROUTINES
+  /**
+   * @brief Awaitable matrix multiplication
+   *
+   * `co_await runtime.MatrixMultiplyAsync(...)` suspends the coroutine
+   * instead of blocking its thread; it resumes on the runtime's completion
+   * reactor thread.
+   *
+   * @param input Input buffer
+   * @param weights Weight buffer
+   * @param output Output buffer
+   * @param priority Submission priority
+   * @return Awaitable that throws std::runtime_error if the op fails
+   */
+  OpAwaitable MatrixMultiplyAsync(const Buffer& input, const Buffer& weights,
+                                  Buffer& output,
+                                  Priority priority = kPriorityNormal) {
+    return OpAwaitable(Reactor(), MakeParams(ACCEL_OP_MATMUL, input, weights,
+                                             output, priority));
+  }
+
+  /**
+   * @brief Awaitable 2D convolution
+   * @param input Input buffer
+   * @param weights Weight buffer
+   * @param output Output buffer
+   * @param priority Submission priority
+   * @return Awaitable that throws std::runtime_error if the op fails
+   */
+  OpAwaitable Convolution2DAsync(const Buffer& input, const Buffer& weights,
+                                 Buffer& output,
+                                 Priority priority = kPriorityNormal) {
+    return OpAwaitable(Reactor(), MakeParams(ACCEL_OP_CONV2D, input, weights,
+                                             output, priority));
+  }
+#endif
+
+  /**
+   * @brief Create a stream for asynchronous execution
+   *
+   * Ops enqueued on the stream are submitted to the driver queue with the
+   * given priority.
+   *
+   * @param priority Submission priority of the stream's ops
+   * @return New stream
+   */
+  Stream CreateStream(Priority priority = kPriorityNormal) {
+    return MakeStream(priority, ACCEL_TENANT_DEFAULT);
+  }
+
+  /**
+   * @brief Create a stream whose ops are scheduled as a tenant's work
+   *
+   * The tenant's ops share the device with other tenants in proportion to
+   * their fair-share weights.
+   *
+   * @param tenant Tenant the ops are charged to; must outlive the stream's
+   *        pending work
+   * @param priority Submission priority of the stream's ops
+   * @return New stream
+   */
+  Stream CreateStream(const Tenant& tenant,
+                      Priority priority = kPriorityNormal) {
+    return MakeStream(priority, tenant.id());
+  }
+
+  /**
+   * @brief Get queueing statistics of one priority level
+   * @param priority Priority level
+   * @return Submitted/completed counts, preemptions, queueing delay and
+   *         latency totals and maxima
+   * @throws std::runtime_error if the driver rejects the query
+   */
+  QueueStats GetQueueStats(Priority priority) const {
+    QueueStats stats{};
+    if (accel_get_queue_stats(static_cast<accel_priority_t>(priority),
+                              &stats) != ACCEL_STATUS_OK) {
+      throw std::runtime_error("Failed to query queue statistics: " +
+                               std::string(accel_get_error()));
+    }
+    return stats;
+  }
+
+  /**
+   * @brief Get device memory statistics
+   * @return Free space, largest free block, fragmentation and compaction
+   *         totals
+   * @throws std::runtime_error if the driver rejects the query
+   */
+  MemoryStats GetMemoryStats() const {
+    MemoryStats stats{};
+    if (accel_get_mem_stats(&stats) != ACCEL_STATUS_OK) {
+      throw std::runtime_error("Failed to query memory statistics: " +
+                               std::string(accel_get_error()));
+    }
+    return stats;
+  }
+
+  /**
+   * @brief Get modelled DMA statistics of one channel
+   *
+   * Each tile costs one DMA transfer per channel; the setup share shows
+   * how much larger tiles (accel_config_t::max_transfer) would save.
+   *
+   * @param channel DMA channel
+   * @return Transfer counts, setup and data time, efficiency
+   * @throws std::runtime_error if the driver rejects the query
+   */
+  DmaStats GetDmaStats(DmaChannel channel) const {
+    DmaStats stats{};
+    if (accel_get_dma_stats(static_cast<accel_dma_channel_t>(channel),
+                            &stats) != ACCEL_STATUS_OK) {
+      throw std::runtime_error("Failed to query DMA statistics: " +
+                               std::string(accel_get_error()));
+    }
+    return stats;
+  }
+
+  /**
+   * @brief Reset DMA statistics of both channels
+   * @throws std::runtime_error if the driver rejects the request
+   */
+  void ResetDmaStats() {
+    if (accel_reset_dma_stats() != ACCEL_STATUS_OK) {
+      throw std::runtime_error("Failed to reset DMA statistics: " +
+                               std::string(accel_get_error()));
+    }
+  }
+
+  /**
+   * @brief Move unpinned buffers together to merge free device memory
+   *
+   * Buffer objects stay valid; pointers from Buffer::data() do not, unless
+   * the buffer is pinned.
+   *
+   * @return Number of bytes relocated
+   * @throws std::runtime_error if compaction fails
+   */
+  uint64_t CompactMemory() {
+    uint64_t moved = 0;
+    if (accel_compact_memory(&moved) != ACCEL_STATUS_OK) {
+      throw std::runtime_error("Failed to compact memory: " +
+                               std::string(accel_get_error()));
+    }
+    return moved;
+  }
+
+  /**
+   * @brief Compact in the background when fragmentation gets high
+   * @param threshold_pct Fragmentation threshold in percent (0 disables)
+   * @param interval_ms Check interval in milliseconds
+   * @throws std::runtime_error if the parameters are rejected
+   */
+  void SetAutoCompaction(uint32_t threshold_pct, uint32_t interval_ms = 100) {
+    if (accel_set_auto_compaction(threshold_pct, interval_ms) !=
+        ACCEL_STATUS_OK) {
+      throw std::runtime_error("Failed to set auto compaction: " +
+                               std::string(accel_get_error()));
+    }
+  }
+
+ private:
+  /** @brief Create a stream, starting the scheduler on first use */
+  Stream MakeStream(Priority priority, accel_tenant_t tenant) {
+    std::call_once(scheduler_once_, [this] {
+      scheduler_ = std::make_unique<detail::StreamScheduler>();
+    });
+    return Stream(scheduler_->CreateStream(
+        static_cast<accel_priority_t>(priority), tenant));
+  }
+
+  /**
+   * @brief Build driver parameters for an operation
+   *
+   * Flushes pending host writes of all three buffers first.
+   *
+   * @param op_type Operation type
+   * @param input Input buffer
+   * @param weights Weight buffer
+   * @param output Output buffer
+   * @param priority Submission priority
+   * @return Operation parameters
+   */
+  static accel_op_params_t MakeParams(accel_op_type_t op_type,
+                                      const Buffer& input,
+                                      const Buffer& weights, Buffer& output,
+                                      Priority priority) {
+    input.Flush();
+    weights.Flush();
+    output.Flush();
+
     accel_op_params_t params{};
-    params.op_type = ACCEL_OP_CONV2D;
+    params.op_type = op_type;
     params.input = *input.buffer_;
     params.weights = *weights.buffer_;
     params.output = *output.buffer_;
-
-    SubmitAndWait(params);
+    params.priority = static_cast<accel_priority_t>(priority);
+    return params;
   }
 
- private:
   /**
    * @brief Submit operation and wait for completion
+   *
+   * Only this op is waited for, so concurrent callers on other threads are
+   * not serialized behind each other's work. While the driver queue is
+   * full the caller sleeps until a completion frees a slot.
+   *
    * @param params Operation parameters
    * @throws std::runtime_error if operation fails
    */
   void SubmitAndWait(const accel_op_params_t& params) {
-    accel_status_t status = accel_submit_op(&params);
+    accel_op_handle_t handle = 0;
+    accel_status_t status = accel_submit_op_wait(&params, &handle, 0);
     if (status != ACCEL_STATUS_OK) {
       throw std::runtime_error("Failed to submit operation: " +
                                std::string(accel_get_error()));
     }
 
-    status = accel_wait_complete(0);  // Wait indefinitely
+    status = accel_wait_op(handle, 0);  // Wait indefinitely
     if (status != ACCEL_STATUS_OK) {
       throw std::runtime_error("Operation failed: " +
                                std::string(accel_get_error()));
     }
   }
+
+#ifdef ACCEL_HAS_COROUTINES
+  /** @brief Completion reactor, started on first use */
+  detail::CompletionReactor& Reactor() {
+    std::call_once(reactor_once_, [this] {
+      reactor_ = std::make_unique<detail::CompletionReactor>();
+    });
+    return *reactor_;
+  }
+
+  std::once_flag reactor_once_;
+  std::unique_ptr<detail::CompletionReactor> reactor_;
+#endif
+
+  std::once_flag scheduler_once_;
+  std::unique_ptr<detail::StreamScheduler> scheduler_;
 };
 
 }  // namespace accel
\ No newline at end of file
@@ -0,0 +1,337 @@
+/**
+ * @file split.hpp
+ * @author Leo (zhsleo@outlook.com)
+ *
+ * @brief Co-execution of one layer on the host and the accelerator
+ * @version 1.0.0
+ * @date 2026-10-18
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <numeric>
+#include <stdexcept>
+#include <vector>
+
+#include "buffer.hpp"
+#include "device_tensor.hpp"
+#include "runtime.hpp"
+#include "stream.hpp"
+#include "types.hpp"
+
+namespace accel {
+
+/**
+ * @brief Operation run on the accelerator's share of a split layer
+ */
+enum class SplitOp { kMatrixMultiply, kConvolution2D };
+
+/**
+ * @brief Throughput estimates and share of a split layer
+ */
+struct SplitStats {
+  uint64_t runs = 0;
+  /** @brief Output channels per microsecond on each side */
+  double host_rate = 0.0;
+  double device_rate = 0.0;
+  /** @brief Fraction of the channels given to the host */
+  double host_share = 0.0;
+  /** @brief Duration of each side in the last run */
+  double last_host_us = 0.0;
+  double last_device_us = 0.0;
+};
+
+/**
+ * @brief Splits a Conv2d or Linear layer by output channels between the
+ *        host kernels and the accelerator
+ *
+ * Weights and output are channel-major device tensors: OIHW or [out, in]
+ * weights and a batch-1 [C, ...] output. The accelerator's channels run on
+ * aliases of the trailing weight and output rows, and the host kernel
+ * writes the leading rows of the same output buffer, so both halves land in
+ * one tensor without a merge copy. The host kernel is usually the layer's
+ * own CPU kernel: Run() and Calibrate() take any layer with
+ * ForwardChannels(input, output, begin, end), which qnn::Conv2d and
+ * qnn::Linear provide.
+ *
+ * Split points fall on whole granules whose output rows end on a cache
+ * line, so the host's writes and the device's never share a line that one
+ * side's flush would write back over the other's.
+ *
+ * Each run times both sides and folds their throughput into running
+ * estimates; the next split gives each side channels in proportion to its
+ * rate. The device time runs from enqueue to retirement, so a busy
+ * accelerator shows up as a low rate and the host takes more channels.
+ */
+class SplitExecutor {
+ public:
+  /**
+   * @brief Host kernel computing output channels [begin, end)
+   *
+   * It writes straight into the output tensor's buffer.
+   */
+  using HostKernel = std::function<void(size_t begin, size_t end)>;
+
+  /**
+   * @brief Create an executor for one layer
+   * @param runtime Runtime whose device runs the accelerator share
+   * @param op Operation of the layer
+   * @param channels Output channels of the layer
+   * @param granule Channels per split step, e.g. the array width
+   * @param smoothing Weight of the newest measurement in the estimates
+   * @param priority Submission priority of the accelerator share
+   * @throws std::invalid_argument if channels or granule is 0
+   */
+  SplitExecutor(Runtime& runtime, SplitOp op, size_t channels,
+                size_t granule = 8, double smoothing = 0.25,
+                Priority priority = kPriorityNormal)
+      : stream_(runtime.CreateStream(priority)),
+        op_(op),
+        channels_(channels),
+        granule_(granule),
+        step_(granule),
+        smoothing_(smoothing) {
+    if (channels == 0 || granule == 0) {
+      throw std::invalid_argument("Split layer needs channels and a granule");
+    }
+    stats_.host_share = 0.5;
+  }
+
+  /**
+   * @brief Measure each side alone and set the share from the result
+   * @param input Input buffer
+   * @param weights Weights, channel-major
+   * @param output Output, channel-major
+   * @param host Host kernel
+   * @param runs Runs per side; the fastest one counts
+   */
+  void Calibrate(const Buffer& input, const DeviceTensor& weights,
+                 DeviceTensor& output, const HostKernel& host,
+                 size_t runs = 3) {
+    AlignSplit(RowBytes(output));
+    double host_us = 1e30;
+    double device_us = 1e30;
+    for (size_t r = 0; r < runs; ++r) {
+      host_us = std::min(
+          host_us, Execute(input, weights, output, host, channels_).host_us);
+      device_us = std::min(
+          device_us, Execute(input, weights, output, host, 0).device_us);
+    }
+    stats_.host_rate = channels_ / std::max(host_us, 1e-3);
+    stats_.device_rate = channels_ / std::max(device_us, 1e-3);
+    UpdateShare();
+  }
+
+  /**
+   * @brief Run the layer split between host and accelerator
+   *
+   * Blocks until both shares are done; the output then holds the whole
+   * layer and is synchronized for the CPU.
+   *
+   * @param input Input buffer
+   * @param weights Weights, channel-major
+   * @param output Output, channel-major
+   * @param host Host kernel
+   * @throws std::invalid_argument if a tensor is not channel-major
+   * @throws std::runtime_error if the accelerator op fails
+   */
+  void Run(const Buffer& input, const DeviceTensor& weights,
+           DeviceTensor& output, const HostKernel& host) {
+    AlignSplit(RowBytes(output));
+    const size_t split = HostChannels();
+    const Timing timing = Execute(input, weights, output, host, split);
+    const double host_us = timing.host_us;
+    const double device_us = timing.device_us;
+    stats_.runs++;
+    stats_.last_host_us = host_us;
+    stats_.last_device_us = device_us;
+
+    // A side that got no channels keeps its previous estimate
+    auto fold = [this](double& rate, double sample) {
+      rate = rate > 0 ? (1 - smoothing_) * rate + smoothing_ * sample
+                      : sample;
+    };
+    if (split > 0) {
+      fold(stats_.host_rate, split / std::max(host_us, 1e-3));
+    }
+    if (split < channels_) {
+      fold(stats_.device_rate, (channels_ - split) / std::max(device_us, 1e-3));
+    }
+    UpdateShare();
+  }
+
+  /**
+   * @brief Measure a layer's host kernel and the accelerator alone
+   *
+   * @param layer Layer whose ForwardChannels() runs the host share
+   * @param host_input The layer's input in host memory
+   * @param input The same input in a device buffer
+   * @param weights Weights, channel-major
+   * @param output Output, channel-major int8
+   * @param runs Runs per side; the fastest one counts
+   */
+  template <typename Layer, typename HostTensor>
+  void Calibrate(Layer& layer, const HostTensor& host_input,
+                 const Buffer& input, const DeviceTensor& weights,
+                 DeviceTensor& output, size_t runs = 3) {
+    Calibrate(input, weights, output, LayerKernel(layer, host_input, output),
+              runs);
+  }
+
+  /**
+   * @brief Run a layer split between its host kernel and the accelerator
+   *
+   * @param layer Layer whose ForwardChannels() runs the host share
+   * @param host_input The layer's input in host memory
+   * @param input The same input in a device buffer
+   * @param weights Weights, channel-major
+   * @param output Output, channel-major int8
+   * @throws std::invalid_argument if a tensor is not channel-major
+   * @throws std::runtime_error if the accelerator op fails
+   */
+  template <typename Layer, typename HostTensor>
+  void Run(Layer& layer, const HostTensor& host_input, const Buffer& input,
+           const DeviceTensor& weights, DeviceTensor& output) {
+    Run(input, weights, output, LayerKernel(layer, host_input, output));
+  }
+
+  /** @return Channels the next run gives the host */
+  size_t HostChannels() const {
+    const double raw = stats_.host_share * channels_;
+    size_t split = static_cast<size_t>(raw / step_ + 0.5) * step_;
+    split = std::min(split, channels_);
+    // Keep one step on each side so both estimates stay current
+    if (channels_ >= 2 * step_) {
+      split = std::clamp(split, step_, channels_ - step_);
+    }
+    return split;
+  }
+
+  /** @return Current estimates and share */
+  const SplitStats& stats() const { return stats_; }
+
+ private:
+  struct Timing {
+    double host_us;
+    double device_us;
+  };
+
+  /** @brief Run channels [0, split) on the host and the rest on the device */
+  Timing Execute(const Buffer& input, const DeviceTensor& weights,
+                 DeviceTensor& output, const HostKernel& host, size_t split) {
+    const size_t weight_row = RowBytes(weights);
+    const size_t output_row = RowBytes(output);
+    const size_t device_channels = channels_ - split;
+    const auto start = std::chrono::steady_clock::now();
+    auto since = [&start] {
+      return std::chrono::duration<double, std::micro>(
+                 std::chrono::steady_clock::now() - start)
+          .count();
+    };
+
+    // Aliases point into the tensors, so neither may move meanwhile
+    Buffer::PinGuard pin_weights(weights.buffer());
+    Buffer::PinGuard pin_output(output.buffer());
+    std::vector<DeviceTensor> views;
+    double device_end = 0.0;
+    if (device_channels > 0) {
+      views.push_back(Rows(weights, split, weight_row));
+      views.push_back(Rows(output, split, output_row));
+      if (op_ == SplitOp::kMatrixMultiply) {
+        stream_.MatrixMultiply(input, views[0].buffer(), views[1].buffer());
+      } else {
+        stream_.Convolution2D(input, views[0].buffer(), views[1].buffer());
+      }
+      stream_.AddCallback(
+          [&device_end, &since](accel_status_t) { device_end = since(); });
+    }
+
+    double host_us = 0.0;
+    if (split > 0) {
+      try {
+        host(0, split);
+      } catch (...) {
+        // The device share still uses the views and device_end
+        if (device_channels > 0) {
+          try {
+            stream_.Synchronize();
+          } catch (...) {
+          }
+        }
+        throw;
+      }
+      host_us = since();
+      output.buffer().MarkDirty(0, split * output_row);
+    }
+    if (device_channels > 0) {
+      stream_.Synchronize();
+    }
+    return {host_us, device_end};
+  }
+
+  /** @brief Host kernel writing a layer's channels into the output */
+  template <typename Layer, typename HostTensor>
+  static HostKernel LayerKernel(Layer& layer, const HostTensor& host_input,
+                                DeviceTensor& output) {
+    int8_t* data = output.data<int8_t>();
+    return [&layer, &host_input, data](size_t begin, size_t end) {
+      layer.ForwardChannels(host_input, data, begin, end);
+    };
+  }
+
+  /**
+   * @brief Step split points by whole granules that also end on a line
+   * @param row_bytes Bytes of one output channel
+   */
+  void AlignSplit(size_t row_bytes) {
+    constexpr size_t kCacheLine = 64;
+    step_ = std::lcm(granule_, kCacheLine / std::gcd(row_bytes, kCacheLine));
+  }
+
+  /** @brief Bytes of one output channel, checking the tensor layout */
+  size_t RowBytes(const DeviceTensor& tensor) const {
+    const auto& shape = tensor.shape();
+    size_t dim = 0;
+    while (dim + 1 < shape.size() && shape[dim] == 1 && channels_ != 1) {
+      dim++;
+    }
+    if (tensor.layout() == Layout::kNHWC || shape.empty() ||
+        shape[dim] != channels_) {
+      throw std::invalid_argument(
+          "Split layer tensors must be channel-major with batch 1");
+    }
+    return tensor.nbytes() / channels_;
+  }
+
+  /** @brief Alias of the rows from channel first to the end */
+  DeviceTensor Rows(const DeviceTensor& tensor, size_t first,
+                    size_t row_bytes) const {
+    auto* base = static_cast<char*>(tensor.buffer().data());
+    return DeviceTensor::Alias(base + first * row_bytes,
+                               {(channels_ - first) * row_bytes},
+                               DType::kInt8, Layout::kRowMajor,
+                               tensor.scale());
+  }
+
+  void UpdateShare() {
+    const double total = stats_.host_rate + stats_.device_rate;
+    if (total > 0) {
+      stats_.host_share = stats_.host_rate / total;
+    }
+  }
+
+  Stream stream_;
+  SplitOp op_;
+  size_t channels_;
+  size_t granule_;
+  /** @brief Channels between split points */
+  size_t step_;
+  double smoothing_;
+  SplitStats stats_;
+};
+
+}  // namespace accel
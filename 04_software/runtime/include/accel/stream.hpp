@@ -0,0 +1,472 @@
+/**
+ * @file stream.hpp
+ * @author Leo (zhsleo@outlook.com)
+ *
+ * @brief Streams and events for asynchronous accelerator execution
+ * @version 1.0.0
+ * @date 2026-10-18
+ */
+
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "buffer.hpp"
+#include "types.hpp"
+
+namespace accel {
+
+/** @brief Host callback invoked with the stream status at that point */
+using HostCallback = std::function<void(accel_status_t)>;
+
+namespace detail {
+
+/**
+ * @brief Shared state of an event
+ *
+ * Each Record() enqueues a new generation; waiters target the latest
+ * generation enqueued at the time they were issued.
+ */
+struct EventState {
+  std::mutex mutex;
+  std::condition_variable cv;
+  uint64_t recorded = 0;   /**< Generations enqueued on some stream */
+  uint64_t completed = 0;  /**< Generations reached by their stream */
+  accel_status_t status = ACCEL_STATUS_OK;
+};
+
+/**
+ * @brief One entry of a stream's in-order work queue
+ */
+struct StreamItem {
+  enum class Kind { kOp, kRecord, kWait, kCallback };
+
+  Kind kind = Kind::kOp;
+  accel_op_params_t params{};
+  std::shared_ptr<EventState> event{};
+  uint64_t generation = 0;
+  HostCallback callback{};
+};
+
+class StreamScheduler;
+
+/**
+ * @brief Shared state of a stream, guarded by the scheduler mutex
+ */
+struct StreamState {
+  StreamScheduler* scheduler = nullptr;
+  accel_priority_t priority = ACCEL_PRIORITY_NORMAL;
+  uint32_t tenant = ACCEL_TENANT_DEFAULT;  /**< Tenant of the stream's ops */
+  std::deque<StreamItem> items;
+  bool in_flight = false;                   /**< Head op is on the device */
+  accel_status_t status = ACCEL_STATUS_OK;  /**< Sticky error status */
+  uint64_t enqueued = 0;                    /**< Items ever enqueued */
+  uint64_t retired = 0;                     /**< Items ever retired */
+};
+
+/**
+ * @brief Maps the in-order stream queues onto the driver submission queue
+ *
+ * A single scheduler thread walks every stream and advances its head item:
+ * ops are submitted asynchronously to the driver (at most one in flight per
+ * stream, so ordering within a stream is preserved), event records and
+ * waits are resolved in place and host callbacks run on the scheduler
+ * thread. Driver completion callbacks only mark the head op as retired and
+ * wake the scheduler.
+ */
+class StreamScheduler {
+ public:
+  StreamScheduler() : thread_([this] { Run(); }) {}
+
+  /** @brief Drains every stream, then stops the scheduler thread */
+  ~StreamScheduler() {
+    {
+      std::unique_lock<std::mutex> lock(mutex_);
+      idle_cv_.wait(lock, [this] { return AllIdle(); });
+      stop_ = true;
+    }
+    work_cv_.notify_all();
+    thread_.join();
+  }
+
+  StreamScheduler(const StreamScheduler&) = delete;
+  StreamScheduler& operator=(const StreamScheduler&) = delete;
+
+  /**
+   * @brief Create a new stream bound to this scheduler
+   * @param priority Driver priority of the stream's ops
+   * @param tenant Driver tenant of the stream's ops
+   * @return Shared stream state
+   */
+  std::shared_ptr<StreamState> CreateStream(
+      accel_priority_t priority, uint32_t tenant = ACCEL_TENANT_DEFAULT) {
+    auto state = std::make_shared<StreamState>();
+    state->scheduler = this;
+    state->priority = priority;
+    state->tenant = tenant;
+    std::lock_guard<std::mutex> lock(mutex_);
+    streams_.push_back(state);
+    return state;
+  }
+
+  /**
+   * @brief Append an item to a stream and wake the scheduler
+   * @param stream Stream state
+   * @param item Work item
+   */
+  void Enqueue(const std::shared_ptr<StreamState>& stream, StreamItem item) {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      if (item.kind == StreamItem::Kind::kOp) {
+        item.params.priority = stream->priority;
+        item.params.tenant = stream->tenant;
+      }
+      stream->items.push_back(std::move(item));
+      stream->enqueued++;
+      dirty_ = true;
+    }
+    work_cv_.notify_one();
+  }
+
+  /**
+   * @brief Block until every item enqueued so far on a stream has retired
+   * @param stream Stream state
+   * @return Sticky status of the stream
+   */
+  accel_status_t Synchronize(const std::shared_ptr<StreamState>& stream) {
+    std::unique_lock<std::mutex> lock(mutex_);
+    const uint64_t target = stream->enqueued;
+    idle_cv_.wait(lock, [&] { return stream->retired >= target; });
+    return stream->status;
+  }
+
+  /**
+   * @brief Check whether a stream has no outstanding work
+   * @param stream Stream state
+   * @return true if every enqueued item has retired
+   */
+  bool Query(const std::shared_ptr<StreamState>& stream) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return stream->retired >= stream->enqueued;
+  }
+
+ private:
+  /** @brief Driver completion callback, runs on the dispatcher thread */
+  static void OnComplete(accel_op_handle_t /*handle*/, accel_status_t status,
+                         void* user_data) {
+    auto* stream = static_cast<StreamState*>(user_data);
+    StreamScheduler* self = stream->scheduler;
+    {
+      std::lock_guard<std::mutex> lock(self->mutex_);
+      stream->in_flight = false;
+      if (status == ACCEL_STATUS_OK) {
+        // Results are visible to later host callbacks and to Synchronize()
+        status = accel_buffer_sync_for_cpu(
+            &stream->items.front().params.output, 0, 0);
+      }
+      if (status != ACCEL_STATUS_OK) {
+        stream->status = status;
+      }
+      self->Retire(*stream);
+    }
+    self->work_cv_.notify_one();
+  }
+
+  /** @brief Pop the head item of a stream (lock held) */
+  void Retire(StreamState& stream) {
+    stream.items.pop_front();
+    stream.retired++;
+    dirty_ = true;
+    idle_cv_.notify_all();
+  }
+
+  /** @brief Every stream is drained (lock held) */
+  bool AllIdle() const {
+    for (const auto& stream : streams_) {
+      if (stream->retired < stream->enqueued) {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  /**
+   * @brief Advance one stream as far as possible (lock held)
+   * @param lock Scheduler lock, released around host callbacks
+   * @param stream Stream to advance
+   */
+  void Advance(std::unique_lock<std::mutex>& lock, StreamState& stream) {
+    while (!stream.in_flight && !stream.items.empty()) {
+      StreamItem& item = stream.items.front();
+      switch (item.kind) {
+        case StreamItem::Kind::kOp: {
+          if (stream.status != ACCEL_STATUS_OK) {
+            Retire(stream);  // Skip work after an error
+            break;
+          }
+          accel_status_t status =
+              accel_submit_op_notify(&item.params, &OnComplete, &stream,
+                                     nullptr);
+          if (status == ACCEL_STATUS_BUSY) {
+            backoff_ = true;  // Driver queue full, retry shortly
+            return;
+          }
+          if (status != ACCEL_STATUS_OK) {
+            stream.status = status;
+            Retire(stream);
+            break;
+          }
+          stream.in_flight = true;
+          return;
+        }
+
+        case StreamItem::Kind::kRecord: {
+          {
+            std::lock_guard<std::mutex> event_lock(item.event->mutex);
+            if (item.generation > item.event->completed) {
+              item.event->completed = item.generation;
+              item.event->status = stream.status;
+            }
+          }
+          item.event->cv.notify_all();
+          Retire(stream);
+          break;
+        }
+
+        case StreamItem::Kind::kWait: {
+          bool reached;
+          {
+            std::lock_guard<std::mutex> event_lock(item.event->mutex);
+            reached = item.event->completed >= item.generation;
+          }
+          if (!reached) {
+            return;  // Re-checked whenever any stream makes progress
+          }
+          Retire(stream);
+          break;
+        }
+
+        case StreamItem::Kind::kCallback: {
+          HostCallback callback = std::move(item.callback);
+          accel_status_t status = stream.status;
+          lock.unlock();
+          callback(status);
+          // Drop what the callback captured, e.g. the last reference to a
+          // buffer, before relocking
+          callback = nullptr;
+          lock.lock();
+          Retire(stream);
+          break;
+        }
+      }
+    }
+  }
+
+  /** @brief Scheduler thread main loop */
+  void Run() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (!stop_) {
+      if (backoff_) {
+        work_cv_.wait_for(lock, std::chrono::milliseconds(1),
+                          [this] { return stop_ || dirty_; });
+        backoff_ = false;
+        dirty_ = true;
+      } else {
+        work_cv_.wait(lock, [this] { return stop_ || dirty_; });
+      }
+      while (dirty_) {
+        dirty_ = false;
+        // Snapshot: host callbacks may create streams while unlocked
+        std::vector<std::shared_ptr<StreamState>> streams = streams_;
+        for (const auto& stream : streams) {
+          Advance(lock, *stream);
+        }
+      }
+      // Forget streams whose handles are gone and whose work is done
+      for (auto it = streams_.begin(); it != streams_.end();) {
+        if (it->use_count() == 1 && (*it)->items.empty()) {
+          it = streams_.erase(it);
+        } else {
+          ++it;
+        }
+      }
+    }
+  }
+
+  std::mutex mutex_;
+  std::condition_variable work_cv_;
+  std::condition_variable idle_cv_;
+  std::vector<std::shared_ptr<StreamState>> streams_;
+  bool dirty_ = false;
+  bool backoff_ = false;
+  bool stop_ = false;
+  std::thread thread_;
+};
+
+}  // namespace detail
+
+/**
+ * @brief Synchronization marker that can be recorded on a stream
+ *
+ * An event completes once every item enqueued on the recording stream
+ * before the Record() call has retired. Events are cheap handles; copies
+ * share the same state.
+ */
+class Event {
+ public:
+  Event() : state_(std::make_shared<detail::EventState>()) {}
+
+  /**
+   * @brief Block until the most recent record of this event has completed
+   * @throws std::runtime_error if the recording stream had failed
+   */
+  void Synchronize() const {
+    std::unique_lock<std::mutex> lock(state_->mutex);
+    const uint64_t target = state_->recorded;
+    state_->cv.wait(lock, [&] { return state_->completed >= target; });
+    if (state_->status != ACCEL_STATUS_OK) {
+      throw std::runtime_error("Stream failed before event: " +
+                               std::string(accel_get_error()));
+    }
+  }
+
+  /**
+   * @brief Check completion without blocking
+   * @return true if the most recent record has completed
+   */
+  bool Query() const {
+    std::lock_guard<std::mutex> lock(state_->mutex);
+    return state_->completed >= state_->recorded;
+  }
+
+ private:
+  std::shared_ptr<detail::EventState> state_;
+  friend class Stream;
+};
+
+/**
+ * @brief In-order queue of accelerator work
+ *
+ * Work enqueued on one stream executes in order; work on different streams
+ * may overlap on the device. Buffers passed to a stream must stay alive
+ * until the work using them has retired.
+ */
+class Stream {
+ public:
+  /**
+   * @brief Enqueue matrix multiplication
+   * @param input Input buffer
+   * @param weights Weight buffer
+   * @param output Output buffer
+   */
+  void MatrixMultiply(const Buffer& input, const Buffer& weights,
+                      Buffer& output) {
+    EnqueueOp(ACCEL_OP_MATMUL, input, weights, output);
+  }
+
+  /**
+   * @brief Enqueue 2D convolution
+   * @param input Input buffer
+   * @param weights Weight buffer
+   * @param output Output buffer
+   */
+  void Convolution2D(const Buffer& input, const Buffer& weights,
+                     Buffer& output) {
+    EnqueueOp(ACCEL_OP_CONV2D, input, weights, output);
+  }
+
+  /**
+   * @brief Record an event after all work enqueued so far
+   * @param event Event to record
+   */
+  void Record(Event& event) {
+    detail::StreamItem item{detail::StreamItem::Kind::kRecord};
+    item.event = event.state_;
+    {
+      std::lock_guard<std::mutex> lock(event.state_->mutex);
+      item.generation = ++event.state_->recorded;
+    }
+    state_->scheduler->Enqueue(state_, std::move(item));
+  }
+
+  /**
+   * @brief Make later work on this stream wait for an event
+   *
+   * Waits for the most recent Record() of @p event issued before this call;
+   * an event that was never recorded does not block.
+   *
+   * @param event Event to wait for
+   */
+  void Wait(const Event& event) {
+    detail::StreamItem item{detail::StreamItem::Kind::kWait};
+    item.event = event.state_;
+    {
+      std::lock_guard<std::mutex> lock(event.state_->mutex);
+      item.generation = event.state_->recorded;
+    }
+    state_->scheduler->Enqueue(state_, std::move(item));
+  }
+
+  /**
+   * @brief Run a host function after all work enqueued so far
+   *
+   * The callback runs on the runtime's scheduler thread and receives the
+   * stream status; it must not synchronize on this stream.
+   *
+   * @param callback Host function
+   */
+  void AddCallback(HostCallback callback) {
+    detail::StreamItem item{detail::StreamItem::Kind::kCallback};
+    item.callback = std::move(callback);
+    state_->scheduler->Enqueue(state_, std::move(item));
+  }
+
+  /**
+   * @brief Block until all work enqueued so far has retired
+   * @throws std::runtime_error if any op on the stream failed
+   */
+  void Synchronize() {
+    if (state_->scheduler->Synchronize(state_) != ACCEL_STATUS_OK) {
+      throw std::runtime_error("Stream operation failed: " +
+                               std::string(accel_get_error()));
+    }
+  }
+
+  /**
+   * @brief Check for outstanding work without blocking
+   * @return true if all enqueued work has retired
+   */
+  bool Query() const { return state_->scheduler->Query(state_); }
+
+ private:
+  explicit Stream(std::shared_ptr<detail::StreamState> state)
+      : state_(std::move(state)) {}
+
+  void EnqueueOp(accel_op_type_t op_type, const Buffer& input,
+                 const Buffer& weights, Buffer& output) {
+    input.Flush();
+    weights.Flush();
+    output.Flush();
+
+    detail::StreamItem item{detail::StreamItem::Kind::kOp};
+    item.params.op_type = op_type;
+    item.params.input = *input.buffer_;
+    item.params.weights = *weights.buffer_;
+    item.params.output = *output.buffer_;
+    state_->scheduler->Enqueue(state_, std::move(item));
+  }
+
+  std::shared_ptr<detail::StreamState> state_;
+  friend class Runtime;
+};
+
+}  // namespace accel
@@ -0,0 +1,118 @@
+/**
+ * @file tenant.hpp
+ * @author Leo (zhsleo@outlook.com)
+ *
+ * @brief RAII wrapper for a device partition tenant
+ * @version 1.0.0
+ * @date 2026-10-18
+ */
+
+#pragma once
+
+#include <stdexcept>
+#include <string>
+
+#include "accel.h"
+#include "buffer.hpp"
+#include "types.hpp"
+
+namespace accel {
+
+/**
+ * @brief Tenant sharing the accelerator with a memory quota and a
+ *        fair-share weight
+ *
+ * Buffers from AllocateBuffer() count against the quota; ops from streams
+ * created with Runtime::CreateStream(tenant) are scheduled as the tenant's
+ * work. All of them must be released before the tenant is destroyed.
+ */
+class Tenant {
+ public:
+  /**
+   * @brief Create a tenant
+   * @param config Memory quota (0 = unlimited), weight and queue limit
+   * @throws std::runtime_error if no tenant slot is free or the config is
+   *         invalid
+   */
+  explicit Tenant(const TenantConfig& config) {
+    if (accel_tenant_create(&config, &id_) != ACCEL_STATUS_OK) {
+      throw std::runtime_error("Failed to create tenant: " +
+                               std::string(accel_get_error()));
+    }
+  }
+
+  ~Tenant() {
+    if (id_ != ACCEL_TENANT_DEFAULT) {
+      accel_tenant_destroy(id_);
+    }
+  }
+
+  // Disable copying
+  Tenant(const Tenant&) = delete;
+  Tenant& operator=(const Tenant&) = delete;
+
+  // Enable moving
+  Tenant(Tenant&& other) noexcept : id_(other.id_) {
+    other.id_ = ACCEL_TENANT_DEFAULT;
+  }
+
+  Tenant& operator=(Tenant&& other) noexcept {
+    if (this != &other) {
+      if (id_ != ACCEL_TENANT_DEFAULT) {
+        accel_tenant_destroy(id_);
+      }
+      id_ = other.id_;
+      other.id_ = ACCEL_TENANT_DEFAULT;
+    }
+    return *this;
+  }
+
+  /** @return Driver tenant identifier */
+  accel_tenant_t id() const { return id_; }
+
+  /**
+   * @brief Allocate a buffer charged to the tenant's quota
+   * @param size Buffer size in bytes
+   * @return Owning buffer
+   * @throws std::runtime_error if the quota or device memory is exhausted
+   */
+  Buffer AllocateBuffer(size_t size) const {
+    accel_buffer_t* buffer = accel_tenant_alloc_buffer(id_, size);
+    if (!buffer) {
+      throw std::runtime_error("Failed to allocate tenant buffer: " +
+                               std::string(accel_get_error()));
+    }
+    return Buffer(buffer, true);
+  }
+
+  /**
+   * @brief Change quota, weight and queue limit
+   * @param config New settings
+   * @throws std::runtime_error if the config is invalid
+   */
+  void Configure(const TenantConfig& config) {
+    if (accel_tenant_configure(id_, &config) != ACCEL_STATUS_OK) {
+      throw std::runtime_error("Failed to configure tenant: " +
+                               std::string(accel_get_error()));
+    }
+  }
+
+  /**
+   * @brief Get usage and throttling statistics
+   * @return Memory usage, op counts, device time and throttled tiles
+   * @throws std::runtime_error if the driver rejects the query
+   */
+  TenantStats GetStats() const {
+    TenantStats stats{};
+    if (accel_get_tenant_stats(id_, &stats) != ACCEL_STATUS_OK) {
+      throw std::runtime_error("Failed to query tenant statistics: " +
+                               std::string(accel_get_error()));
+    }
+    return stats;
+  }
+
+ private:
+  accel_tenant_t id_ = ACCEL_TENANT_DEFAULT;
+};
+
+}  // namespace accel
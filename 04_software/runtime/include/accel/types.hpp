@@ -11,6 +11,8 @@
 
 #include <cstdint>
 
+#include "accel.h"
+
 namespace accel {
 
 /**
@@ -22,4 +24,45 @@ enum ConfigFlags : uint32_t {
   kHighPriority = ACCEL_CONFIG_HIGH_PRIORITY
 };
 
+/**
+ * @brief Runtime initialization flags
+ */
+enum InitFlags : uint32_t {
+  kCachedMapping = ACCEL_INIT_CACHED,
+  kPrefault = ACCEL_INIT_PREFAULT,
+  kHugePages2M = ACCEL_INIT_HUGE_2M,
+  kHugePages1G = ACCEL_INIT_HUGE_1G
+};
+
+/**
+ * @brief Per-operation submission priority
+ */
+enum Priority : uint32_t {
+  kPriorityNormal = ACCEL_PRIORITY_NORMAL,
+  kPriorityHigh = ACCEL_PRIORITY_HIGH
+};
+
+/**
+ * @brief DMA channel of the transfer cost model
+ */
+enum DmaChannel : uint32_t {
+  kDmaRead = ACCEL_DMA_READ,
+  kDmaWrite = ACCEL_DMA_WRITE
+};
+
+/** @brief Per-priority queueing statistics reported by the driver */
+using QueueStats = accel_queue_stats_t;
+
+/** @brief Device memory usage, fragmentation and compaction statistics */
+using MemoryStats = accel_mem_stats_t;
+
+/** @brief Modelled DMA transfer counts, setup and data time */
+using DmaStats = accel_dma_stats_t;
+
+/** @brief Memory quota, fair-share weight and queue limit of a tenant */
+using TenantConfig = accel_tenant_config_t;
+
+/** @brief Per-tenant usage and throttling statistics */
+using TenantStats = accel_tenant_stats_t;
+
 }  // namespace accel
\ No newline at end of file
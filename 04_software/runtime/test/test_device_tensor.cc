@@ -0,0 +1,225 @@
+/**
+ * @file test_device_tensor.cc
+ * @author Leo (zhsleo@outlook.com)
+ *
+ * @brief Unit tests for device tensors: copies, aliases and stream copies
+ * @version 1.0.0
+ * @date 2026-10-18
+ */
+
+#include <accel.hpp>
+#include <cstdint>
+#include <future>
+#include <memory>
+#include <stdexcept>
+
+#include "accel_test.h"
+
+namespace {
+
+using Host = accel::ArenaTensor<int32_t>;
+
+/** @brief Fill a host tensor with values derived from seed */
+void Fill(Host& host, int32_t seed) {
+  for (size_t i = 0; i < host.size(); ++i) {
+    host.data()[i] = static_cast<int32_t>(i) * 3 - seed;
+  }
+}
+
+/** @return true if the device tensor holds the host tensor's values */
+bool Holds(const accel::DeviceTensor& device, const Host& host) {
+  accel::Buffer::PinGuard pin(device.buffer());
+  device.buffer().SyncForCpu();
+  const int32_t* data = device.data<int32_t>();
+  for (size_t i = 0; i < host.size(); ++i) {
+    if (data[i] != host.data()[i]) {
+      return false;
+    }
+  }
+  return device.numel() == host.size();
+}
+
+/** @return Buffers allocated through the driver */
+uint32_t LiveBuffers() {
+  accel_mem_stats_t stats;
+  accel_get_mem_stats(&stats);
+  return stats.live_buffers;
+}
+
+/** @brief Hold a stream's later work until the returned promise is set */
+std::shared_ptr<std::promise<void>> Block(accel::Stream& stream) {
+  auto gate = std::make_shared<std::promise<void>>();
+  std::shared_future<void> open = gate->get_future().share();
+  stream.AddCallback([open](accel_status_t) { open.wait(); });
+  return gate;
+}
+
+}  // namespace
+
+static void test_upload_download(void) {
+  accel::Runtime runtime("/dev/accelerator");
+  accel::HostArena arena(1 << 20);
+  Host host(arena, {2, 3, 4}, 0.25f);
+  Fill(host, 7);
+
+  accel::DeviceTensor device = accel::DeviceTensor::FromHost(host);
+  ACCEL_TEST_ASSERT(device.dtype() == accel::DType::kInt32);
+  ACCEL_TEST_ASSERT_EQUAL(24u, device.numel());
+  ACCEL_TEST_ASSERT_EQUAL(96u, device.nbytes());
+  ACCEL_TEST_ASSERT(device.scale() == 0.25f);
+  ACCEL_TEST_ASSERT(!device.is_alias());
+  ACCEL_TEST_ASSERT(Holds(device, host));
+
+  // Download resizes the host tensor and passes the scale back
+  Host back(arena, {1});
+  device.Download(back);
+  ACCEL_TEST_ASSERT(back.shape() == device.shape());
+  ACCEL_TEST_ASSERT(back.scale() == 0.25f);
+  bool equal = true;
+  for (size_t i = 0; i < host.size(); ++i) {
+    equal = equal && back.data()[i] == host.data()[i];
+  }
+  ACCEL_TEST_ASSERT(equal);
+
+  // Shape and element type must match
+  Host other(arena, {4, 6});
+  bool threw = false;
+  try {
+    device.Upload(other);
+  } catch (const std::invalid_argument&) {
+    threw = true;
+  }
+  ACCEL_TEST_ASSERT(threw);
+  accel::ArenaTensor<int8_t> bytes(arena, {2, 3, 4});
+  threw = false;
+  try {
+    device.Download(bytes);
+  } catch (const std::invalid_argument&) {
+    threw = true;
+  }
+  ACCEL_TEST_ASSERT(threw);
+}
+
+static void test_alias_bounds(void) {
+  accel::Runtime runtime("/dev/accelerator");
+  accel::Buffer base(4096);
+  uint8_t* start = static_cast<uint8_t*>(base.data());
+
+  accel::DeviceTensor alias = accel::DeviceTensor::Alias(
+      start + 1024, {16, 16}, accel::DType::kFloat32, accel::Layout::kRowMajor,
+      0.5f);
+  ACCEL_TEST_ASSERT(alias.is_alias());
+  ACCEL_TEST_ASSERT(alias.data<float>() ==
+                    reinterpret_cast<float*>(start + 1024));
+  ACCEL_TEST_ASSERT_EQUAL(1024u, alias.nbytes());
+  ACCEL_TEST_ASSERT(alias.scale() == 0.5f);
+
+  // Writes through the alias land in the base buffer
+  alias.data<float>()[3] = 1.5f;
+  ACCEL_TEST_ASSERT(reinterpret_cast<float*>(start + 1024)[3] == 1.5f);
+
+  // Host memory outside the device region cannot be aliased
+  int32_t local[16] = {};
+  bool threw = false;
+  try {
+    accel::DeviceTensor::Alias(local, {16}, accel::DType::kInt32);
+  } catch (const std::runtime_error&) {
+    threw = true;
+  }
+  ACCEL_TEST_ASSERT(threw);
+
+  // Nor a range that runs past the end of device memory
+  threw = false;
+  try {
+    accel::DeviceTensor::Alias(start, {512u << 20}, accel::DType::kInt8);
+  } catch (const std::runtime_error&) {
+    threw = true;
+  }
+  ACCEL_TEST_ASSERT(threw);
+
+  threw = false;
+  try {
+    accel::DeviceTensor::Alias(start, {0}, accel::DType::kInt8);
+  } catch (const std::invalid_argument&) {
+    threw = true;
+  }
+  ACCEL_TEST_ASSERT(threw);
+}
+
+static void test_async_round_trip(void) {
+  accel::Runtime runtime("/dev/accelerator");
+  accel::Stream stream = runtime.CreateStream();
+  accel::HostArena arena(1 << 20);
+  Host host(arena, {8, 32}, 0.125f);
+  Fill(host, 3);
+  accel::DeviceTensor device({8, 32}, accel::DType::kInt32);
+
+  // Nothing is copied until the stream reaches the copy
+  auto gate = Block(stream);
+  device.UploadAsync(host, stream);
+  Host back(arena, {1});
+  device.DownloadAsync(back, stream);
+  ACCEL_TEST_ASSERT(back.shape() == device.shape());
+  ACCEL_TEST_ASSERT(back.scale() == 0.125f);
+  ACCEL_TEST_ASSERT(!stream.Query());
+
+  gate->set_value();
+  stream.Synchronize();
+  ACCEL_TEST_ASSERT(Holds(device, host));
+  bool equal = true;
+  for (size_t i = 0; i < host.size(); ++i) {
+    equal = equal && back.data()[i] == host.data()[i];
+  }
+  ACCEL_TEST_ASSERT(equal);
+
+  accel_mem_stats_t stats;
+  accel_get_mem_stats(&stats);
+  ACCEL_TEST_ASSERT_EQUAL(0u, stats.pinned_buffers);
+}
+
+static void test_async_outlives_tensors(void) {
+  accel::Runtime runtime("/dev/accelerator");
+  accel::Stream stream = runtime.CreateStream();
+  accel::HostArena arena(1 << 20);
+  const uint32_t live = LiveBuffers();
+
+  auto source = std::make_shared<Host>(arena, std::vector<size_t>{64}, 2.0f);
+  Fill(*source, 11);
+  Host expected(arena, {64});
+  Fill(expected, 11);
+  std::weak_ptr<Host> watch = source;
+  auto result = std::make_shared<Host>(arena, std::vector<size_t>{1});
+
+  // Both the device tensor and the source are gone before the copies run
+  auto gate = Block(stream);
+  {
+    accel::DeviceTensor device({64}, accel::DType::kInt32);
+    device.UploadAsync(source, stream);
+    device.DownloadAsync(result, stream);
+  }
+  source.reset();
+  ACCEL_TEST_ASSERT(!watch.expired());
+  ACCEL_TEST_ASSERT_EQUAL(live + 1, LiveBuffers());
+
+  gate->set_value();
+  stream.Synchronize();
+  ACCEL_TEST_ASSERT(watch.expired());
+  ACCEL_TEST_ASSERT_EQUAL(live, LiveBuffers());
+  ACCEL_TEST_ASSERT(result->scale() == 2.0f);
+  bool equal = result->size() == expected.size();
+  for (size_t i = 0; equal && i < expected.size(); ++i) {
+    equal = result->data()[i] == expected.data()[i];
+  }
+  ACCEL_TEST_ASSERT(equal);
+}
+
+int main() {
+  ACCEL_TEST_BEGIN();
+
+  ACCEL_TEST_RUN(test_upload_download);
+  ACCEL_TEST_RUN(test_alias_bounds);
+  ACCEL_TEST_RUN(test_async_round_trip);
+  ACCEL_TEST_RUN(test_async_outlives_tensors);
+
+  ACCEL_TEST_END();
+}
@@ -0,0 +1,106 @@
+/**
+ * @file test_host_arena.cc
+ * @author Leo (zhsleo@outlook.com)
+ *
+ * @brief Unit tests for host arenas and arena tensors
+ * @version 1.0.0
+ * @date 2026-10-18
+ */
+
+#include <accel.hpp>
+#include <cstdint>
+
+#include "accel_test.h"
+
+namespace {
+
+/** @return true if [a, a + a_count) and [b, b + b_count) share an element */
+template <typename T>
+bool Overlap(const T* a, size_t a_count, const T* b, size_t b_count) {
+  return a < b + b_count && b < a + a_count;
+}
+
+}  // namespace
+
+static void test_arena_allocate_reset(void) {
+  accel::HostArena arena(1 << 20);
+  ACCEL_TEST_ASSERT_EQUAL(0u, arena.used());
+  ACCEL_TEST_ASSERT_EQUAL(0u, arena.epoch());
+
+  float* first = arena.Allocate<float>(100);
+  float* second = arena.Allocate<float>(100);
+  ACCEL_TEST_ASSERT(!Overlap(first, 100, second, 100));
+  ACCEL_TEST_ASSERT(arena.used() >= 200 * sizeof(float));
+
+  // Reset hands the same memory out again
+  arena.Reset();
+  ACCEL_TEST_ASSERT_EQUAL(0u, arena.used());
+  ACCEL_TEST_ASSERT_EQUAL(1u, arena.epoch());
+  ACCEL_TEST_ASSERT(arena.Allocate<float>(100) == first);
+
+  bool threw = false;
+  try {
+    arena.Allocate(2 << 20);
+  } catch (const std::runtime_error&) {
+    threw = true;
+  }
+  ACCEL_TEST_ASSERT(threw);
+}
+
+static void test_arena_tensor_resize(void) {
+  accel::HostArena arena(1 << 20);
+  accel::ArenaTensor<int8_t> tensor(arena, {4, 16}, 0.5f);
+  ACCEL_TEST_ASSERT_EQUAL(64u, tensor.size());
+  ACCEL_TEST_ASSERT(tensor.scale() == 0.5f);
+  int8_t* data = tensor.data();
+  ACCEL_TEST_ASSERT_NOT_NULL(data);
+
+  // Shrinking and regrowing within the storage keeps it
+  tensor.resize({2, 16});
+  ACCEL_TEST_ASSERT(tensor.data() == data);
+  tensor.resize({4, 16});
+  ACCEL_TEST_ASSERT(tensor.data() == data);
+  const size_t used = arena.used();
+
+  // Growing takes new storage
+  tensor.resize({8, 16});
+  ACCEL_TEST_ASSERT(tensor.data() != data);
+  ACCEL_TEST_ASSERT(arena.used() > used);
+
+  tensor.Release();
+  ACCEL_TEST_ASSERT_NULL(tensor.data());
+  ACCEL_TEST_ASSERT_EQUAL(0u, tensor.size());
+}
+
+static void test_arena_tensor_after_reset(void) {
+  accel::HostArena arena(1 << 20);
+  accel::ArenaTensor<float> activation(arena, {1, 256});
+  accel::ArenaTensor<float> logits(arena, {1, 10});
+
+  // The next inference resizes to the same and to smaller shapes; both
+  // must take fresh storage rather than keep pointers the arena reuses
+  for (int run = 0; run < 3; ++run) {
+    arena.Reset();
+    activation.resize({1, 256});
+    logits.resize({1, 8});
+    accel::ArenaTensor<float> scratch(arena, {1, 256});
+    ACCEL_TEST_ASSERT(arena.used() >= (256 + 8 + 256) * sizeof(float));
+    ACCEL_TEST_ASSERT(!Overlap(activation.data(), 256, logits.data(), 8));
+    ACCEL_TEST_ASSERT(!Overlap(activation.data(), 256, scratch.data(), 256));
+    ACCEL_TEST_ASSERT(!Overlap(logits.data(), 8, scratch.data(), 256));
+  }
+
+  // Moving the arena keeps its epoch, so tensors stay consistent with it
+  accel::HostArena moved(std::move(arena));
+  ACCEL_TEST_ASSERT_EQUAL(3u, moved.epoch());
+}
+
+int main() {
+  ACCEL_TEST_BEGIN();
+
+  ACCEL_TEST_RUN(test_arena_allocate_reset);
+  ACCEL_TEST_RUN(test_arena_tensor_resize);
+  ACCEL_TEST_RUN(test_arena_tensor_after_reset);
+
+  ACCEL_TEST_END();
+}
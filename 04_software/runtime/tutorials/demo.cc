@@ -8,6 +8,7 @@
  */
 
 #include <accel.hpp>
+#include <cstdio>
 
 int main() {
   accel::Runtime runtime("/dev/accelerator");
@@ -18,5 +19,14 @@ int main() {
   accel::Buffer output(1024);
 
   runtime.MatrixMultiply(input, weights, output);
+  runtime.MatrixMultiply(input, weights, output, accel::kPriorityHigh);
+
+  for (auto priority : {accel::kPriorityNormal, accel::kPriorityHigh}) {
+    accel::QueueStats stats = runtime.GetQueueStats(priority);
+    std::printf("priority %u: %llu ops, max queueing delay %llu us\n",
+                static_cast<unsigned>(priority),
+                static_cast<unsigned long long>(stats.completed),
+                static_cast<unsigned long long>(stats.max_queue_us));
+  }
   return 0;
 }
\ No newline at end of file
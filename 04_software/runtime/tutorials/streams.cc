@@ -0,0 +1,48 @@
+/**
+ * @file streams.cc
+ * @author Leo (zhsleo@outlook.com)
+ *
+ * @brief Demo for streams, events and host callbacks
+ * @version 1.0.0
+ * @date 2026-10-18
+ */
+
+#include <accel.hpp>
+#include <atomic>
+#include <cstdio>
+
+int main() {
+  accel::Runtime runtime("/dev/accelerator");
+  runtime.Configure(accel::kEnableDma);
+
+  accel::Buffer input(1024);
+  accel::Buffer weights(1024);
+  accel::Buffer hidden(1024);
+  accel::Buffer output_a(1024);
+  accel::Buffer output_b(1024);
+
+  // Two independent requests overlap on the device
+  accel::Stream producer = runtime.CreateStream();
+  accel::Stream consumer = runtime.CreateStream(accel::kPriorityHigh);
+
+  accel::Event hidden_ready;
+  producer.MatrixMultiply(input, weights, hidden);
+  producer.Record(hidden_ready);
+  producer.MatrixMultiply(input, weights, output_a);
+
+  // The consumer only depends on the first op of the producer
+  std::atomic<int> callbacks{0};
+  consumer.Wait(hidden_ready);
+  consumer.Convolution2D(hidden, weights, output_b);
+  consumer.AddCallback([&callbacks](accel_status_t status) {
+    std::printf("consumer done: status %d\n", static_cast<int>(status));
+    callbacks++;
+  });
+
+  // Host work here overlaps with the device
+  producer.Synchronize();
+  consumer.Synchronize();
+
+  std::printf("callbacks run: %d\n", callbacks.load());
+  return 0;
+}